@@ -19,6 +19,12 @@ build_drivers() {
     make -C ./drivers -f Makefile
 }
 
+build_host_bench() {
+    make -C ./tests/host check
+    make -C ./tests/host clean
+    make -C ./tests/host SANITIZE=y check
+}
+
 build_doxygen() {
     sudo apt-get install -y graphviz
     # Install a recent version of doxygen
@@ -41,6 +41,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdlib.h>
+#include "error.h"
 #include "adxl362.h"
 
 /******************************************************************************/
@@ -65,10 +66,17 @@ int32_t adxl362_init(struct adxl362_dev **device,
 	uint8_t reg_value = 0;
 	int32_t status = -1;
 
-	dev = (struct adxl362_dev *)malloc(sizeof(*dev));
+	dev = (struct adxl362_dev *)calloc(1, sizeof(*dev));
 	if (!dev)
 		return -1;
 
+	dev->fifo_buf = (uint16_t *)calloc(ADXL362_FIFO_SIZE + 1,
+					   sizeof(*dev->fifo_buf));
+	if (!dev->fifo_buf) {
+		free(dev);
+		return -1;
+	}
+
 	/* SPI */
 	status = spi_init(&dev->spi_desc, &init_param.spi_init);
 
@@ -94,8 +102,12 @@ int32_t adxl362_remove(struct adxl362_dev *dev)
 {
 	int32_t ret;
 
+	if (dev->stream_cb)
+		adxl362_fifo_stream_stop(dev);
+
 	ret = spi_remove(dev->spi_desc);
 
+	free(dev->fifo_buf);
 	free(dev);
 
 	return ret;
@@ -403,6 +415,170 @@ void adxl362_fifo_setup(struct adxl362_dev *dev,
 				   water_mark_lvl,
 				   ADXL362_REG_FIFO_SAMPLES,
 				   2);
+	dev->fifo_temp = en_temp_read;
+}
+
+/***************************************************************************//**
+ * @brief Reads FIFO sample sets with a single burst and decodes them in place.
+ *        The SPI command byte is placed right before the data, so the entries
+ *        land 16-bit aligned and are sign extended without a copy. Entries
+ *        preceding the first X axis entry are dropped to keep the sets
+ *        aligned.
+ *
+ * @param dev     - The device structure.
+ * @param entries - Number of FIFO entries to be read.
+ * @param data    - Points to the decoded samples, valid until the next read.
+ * @param nb_read - Number of decoded samples, a multiple of the set size.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t adxl362_fifo_read(struct adxl362_dev *dev,
+			  uint16_t entries,
+			  int16_t **data,
+			  uint16_t *nb_read)
+{
+	uint8_t *raw = (uint8_t *)dev->fifo_buf;
+	uint8_t set_size = dev->fifo_temp ? 4 : 3;
+	uint16_t entry;
+	uint16_t i, n;
+	int32_t ret;
+
+	if (entries > ADXL362_FIFO_SIZE)
+		return -1;
+
+	raw[1] = ADXL362_WRITE_FIFO;
+	ret = spi_write_and_read(dev->spi_desc, &raw[1], entries * 2 + 1);
+	if (ret < 0)
+		return ret;
+
+	/* Entry n is written no further than entry i, which was already read */
+	raw += 2;
+	for (i = 0, n = 0; i < entries; i++) {
+		entry = raw[2 * i] | (raw[2 * i + 1] << 8);
+		if (!n && ADXL362_FIFO_AXIS(entry) != ADXL362_FIFO_AXIS_X) {
+			dev->fifo_skipped++;
+			continue;
+		}
+		dev->fifo_buf[n + 1] = ADXL362_FIFO_DATA(entry);
+		n++;
+	}
+
+	*data = (int16_t *)&dev->fifo_buf[1];
+	*nb_read = n - n % set_size;
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief FIFO watermark interrupt handler. Drains the FIFO with a single burst
+ *        read and appends the decoded samples to the ring buffer.
+ *
+ * @param ctx   - The device structure.
+ * @param event - Unused.
+ * @param extra - Unused.
+ *
+ * @return None.
+*******************************************************************************/
+static void adxl362_fifo_irq_handler(void *ctx, uint32_t event, void *extra)
+{
+	struct adxl362_dev *dev = ctx;
+	uint8_t status[3] = {0, 0, 0};
+	uint8_t set_size = dev->fifo_temp ? 4 : 3;
+	uint16_t entries;
+	uint16_t nb_read;
+	int16_t *data;
+	uint32_t size;
+
+	irq_disable(dev->irq_ctrl, dev->irq_id);
+
+	/* STATUS is followed by FIFO_ENTRIES_L and FIFO_ENTRIES_H */
+	adxl362_get_register_value(dev, status, ADXL362_REG_STATUS, 3);
+	if (status[0] & ADXL362_STATUS_FIFO_OVERRUN)
+		dev->fifo_overruns++;
+
+	entries = ((status[2] & 0x3) << 8) | status[1];
+	entries -= entries % set_size;
+	if (!entries)
+		goto out;
+
+	if (adxl362_fifo_read(dev, entries, &data, &nb_read) < 0 || !nb_read)
+		goto out;
+
+	cb_write(dev->stream_cb, data, nb_read * sizeof(*data));
+	if (cb_size(dev->stream_cb, &size) == -EOVERRUN)
+		dev->stream_overruns++;
+out:
+	irq_enable(dev->irq_ctrl, dev->irq_id);
+}
+
+/***************************************************************************//**
+ * @brief Starts streaming the FIFO to a ring buffer on the watermark
+ *        interrupt. The FIFO must be configured with adxl362_fifo_setup()
+ *        beforehand.
+ *
+ * @param dev   - The device structure.
+ * @param param - The streaming parameters.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t adxl362_fifo_stream_start(struct adxl362_dev *dev,
+				  const struct adxl362_fifo_stream_param *param)
+{
+	struct callback_desc cb;
+	uint8_t reg;
+	uint8_t map = 0;
+	int32_t ret;
+
+	if (!dev || !param || !param->irq_ctrl || !param->cb)
+		return -1;
+
+	reg = param->use_int2 ? ADXL362_REG_INTMAP2 : ADXL362_REG_INTMAP1;
+	adxl362_get_register_value(dev, &map, reg, 1);
+	map |= ADXL362_INTMAP1_FIFO_WATERMARK | ADXL362_INTMAP1_FIFO_OVERRUN;
+	adxl362_set_register_value(dev, map, reg, 1);
+
+	dev->irq_ctrl = param->irq_ctrl;
+	dev->irq_id = param->irq_id;
+	dev->stream_cb = param->cb;
+	dev->fifo_overruns = 0;
+	dev->stream_overruns = 0;
+	dev->fifo_skipped = 0;
+
+	cb.callback = adxl362_fifo_irq_handler;
+	cb.ctx = dev;
+	cb.config = param->irq_config;
+	ret = irq_register_callback(dev->irq_ctrl, dev->irq_id, &cb);
+	if (ret < 0)
+		return ret;
+
+	return irq_enable(dev->irq_ctrl, dev->irq_id);
+}
+
+/***************************************************************************//**
+ * @brief Stops streaming the FIFO.
+ *
+ * @param dev - The device structure.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t adxl362_fifo_stream_stop(struct adxl362_dev *dev)
+{
+	int32_t ret;
+
+	if (!dev || !dev->stream_cb)
+		return -1;
+
+	ret = irq_disable(dev->irq_ctrl, dev->irq_id);
+	if (ret < 0)
+		return ret;
+
+	ret = irq_unregister(dev->irq_ctrl, dev->irq_id);
+	if (ret < 0)
+		return ret;
+
+	dev->stream_cb = NULL;
+
+	return ret;
 }
 
 /***************************************************************************//**
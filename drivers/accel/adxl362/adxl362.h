@@ -44,7 +44,10 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 #include "spi.h"
+#include "irq.h"
+#include "circular_buffer.h"
 
 /******************************************************************************/
 /********************************* ADXL362 ************************************/
@@ -124,6 +127,17 @@
 #define ADXL362_FIFO_STREAM             2
 #define ADXL362_FIFO_TRIGGERED          3
 
+/* FIFO entries */
+#define ADXL362_FIFO_SIZE               512
+#define ADXL362_FIFO_AXIS(x)            (((x) >> 14) & 0x3)
+#define ADXL362_FIFO_DATA(x)            ((int16_t)((x) << 2) >> 2)
+
+/* ADXL362_FIFO_AXIS(x) options */
+#define ADXL362_FIFO_AXIS_X             0
+#define ADXL362_FIFO_AXIS_Y             1
+#define ADXL362_FIFO_AXIS_Z             2
+#define ADXL362_FIFO_AXIS_TEMP          3
+
 /* ADXL362_REG_INTMAP1 */
 #define ADXL362_INTMAP1_INT_LOW         (1 << 7)
 #define ADXL362_INTMAP1_AWAKE           (1 << 6)
@@ -205,6 +219,42 @@ struct adxl362_dev {
 	spi_desc	*spi_desc;
 	/** Measurement Range: */
 	uint8_t		selected_range;
+	/** Temperature is stored in the FIFO */
+	uint8_t		fifo_temp;
+	/** FIFO burst buffer, preceded by one word holding the SPI command */
+	uint16_t	*fifo_buf;
+	/** Ring buffer receiving the streamed samples */
+	struct circular_buffer	*stream_cb;
+	/** Interrupt controller used for streaming */
+	struct irq_ctrl_desc	*irq_ctrl;
+	/** Watermark interrupt ID */
+	uint32_t	irq_id;
+	/** Watermark events where the device FIFO had overflowed */
+	uint32_t	fifo_overruns;
+	/** Watermark events where the ring buffer was overrun */
+	uint32_t	stream_overruns;
+	/** FIFO entries dropped to realign on the X axis */
+	uint32_t	fifo_skipped;
+};
+
+/**
+ * @struct adxl362_fifo_stream_param
+ * @brief Parameters of the FIFO streaming mode.
+ */
+struct adxl362_fifo_stream_param {
+	/** Controller of the interrupt connected to the INT pin */
+	struct irq_ctrl_desc	*irq_ctrl;
+	/** Interrupt ID */
+	uint32_t		irq_id;
+	/** Platform specific interrupt configuration */
+	void			*irq_config;
+	/** Map the watermark and overrun interrupts on INT2 instead of INT1 */
+	bool			use_int2;
+	/**
+	 * Ring buffer receiving the samples as sign extended 16-bit words,
+	 * in sets of X, Y, Z and, if enabled, temperature.
+	 */
+	struct circular_buffer	*cb;
 };
 
 /**
@@ -280,6 +330,19 @@ void adxl362_fifo_setup(struct adxl362_dev *dev,
 			uint16_t water_mark_lvl,
 			uint8_t  en_temp_read);
 
+/*! Reads FIFO sample sets with a single burst and decodes them in place. */
+int32_t adxl362_fifo_read(struct adxl362_dev *dev,
+			  uint16_t entries,
+			  int16_t **data,
+			  uint16_t *nb_read);
+
+/*! Starts streaming the FIFO to a ring buffer on the watermark interrupt. */
+int32_t adxl362_fifo_stream_start(struct adxl362_dev *dev,
+				  const struct adxl362_fifo_stream_param *param);
+
+/*! Stops streaming the FIFO. */
+int32_t adxl362_fifo_stream_stop(struct adxl362_dev *dev);
+
 /*! Configures activity detection. */
 void adxl362_setup_activity_detection(struct adxl362_dev *dev,
 				      uint8_t  ref_or_abs,
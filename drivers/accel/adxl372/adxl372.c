@@ -44,8 +44,25 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include "error.h"
 #include "adxl372.h"
 
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+/* Axes stored in the FIFO for each format, bit 0 is X, bit 1 Y, bit 2 Z */
+static const uint8_t adxl372_fifo_axes_mask[] = {
+	[ADXL372_XYZ_FIFO] = 0x7,
+	[ADXL372_X_FIFO] = 0x1,
+	[ADXL372_Y_FIFO] = 0x2,
+	[ADXL372_XY_FIFO] = 0x3,
+	[ADXL372_Z_FIFO] = 0x4,
+	[ADXL372_XZ_FIFO] = 0x5,
+	[ADXL372_YZ_FIFO] = 0x6,
+	[ADXL372_XYZ_PEAK_FIFO] = 0x7,
+};
+
 /******************************************************************************/
 /************************** Functions Implementation **************************/
 /******************************************************************************/
@@ -533,6 +550,58 @@ int32_t adxl372_configure_fifo(struct adxl372_dev *dev,
 	return ret;
 }
 
+/**
+ * Get the number of FIFO entries making up one sample set.
+ * @param format - FIFO Format.
+ * @return The number of axes stored for each sample.
+ */
+uint8_t adxl372_fifo_axes(enum adxl372_fifo_format format)
+{
+	uint8_t mask = adxl372_fifo_axes_mask[format & 0x7];
+
+	return (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1);
+}
+
+/**
+ * Burst read FIFO entries and decode them in place.
+ * The SPI command byte is placed right before the data, so the received bytes
+ * land 16-bit aligned in the FIFO buffer and are converted to 12-bit samples
+ * without an intermediate copy.
+ * @param dev - The device structure.
+ * @param cnt - Number of entries to be read.
+ * @param data - Pointer to the decoded samples, valid until the next read.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t adxl372_fifo_burst(struct adxl372_dev *dev, uint16_t cnt,
+				  uint16_t **data)
+{
+	uint8_t *raw = (uint8_t *)dev->fifo_buf;
+	uint16_t i;
+	int32_t ret;
+
+	if (cnt > ADXL372_FIFO_SIZE)
+		return -1;
+
+	if (dev->comm_type == SPI) {
+		raw[1] = ADXL372_REG_READ(ADXL372_FIFO_DATA);
+		ret = spi_write_and_read(dev->spi_desc, &raw[1], cnt * 2 + 1);
+	} else {
+		ret = adxl372_read_reg_multiple(dev, ADXL372_FIFO_DATA, &raw[2],
+						cnt * 2);
+	}
+	if (ret < 0)
+		return ret;
+
+	/* Entry i occupies the same two bytes before and after decoding. */
+	raw += 2;
+	for (i = 0; i < cnt; i++)
+		dev->fifo_buf[i + 1] = (raw[2 * i] << 4) | (raw[2 * i + 1] >> 4);
+
+	*data = &dev->fifo_buf[1];
+
+	return ret;
+}
+
 /**
  * Retrieve data stored in FIFO. Can be used in polling mode,
  * but works best when interrupts are used
@@ -549,6 +618,7 @@ int32_t adxl372_service_fifo_ev(struct adxl372_dev *dev,
 				uint16_t *fifo_entries)
 {
 	uint8_t status1, status2;
+	uint8_t axes;
 	int32_t ret;
 
 	ret = adxl372_get_status(dev, &status1, &status2, fifo_entries);
@@ -557,6 +627,7 @@ int32_t adxl372_service_fifo_ev(struct adxl372_dev *dev,
 
 	if (ADXL372_STATUS_1_FIFO_OVR(status1)) {
 		printf("FIFO overrun\n");
+		dev->fifo_overruns++;
 		return -1;
 	}
 
@@ -569,7 +640,10 @@ int32_t adxl372_service_fifo_ev(struct adxl372_dev *dev,
 			 * of order, at least one sample set must be left in the
 			 * FIFO after every read.
 			 */
-			*fifo_entries -= 3;
+			axes = adxl372_fifo_axes(dev->fifo_config.fifo_format);
+			if (*fifo_entries < axes)
+				return ret;
+			*fifo_entries -= axes;
 			ret = adxl372_get_fifo_xyz_data(dev, fifo_data,
 							*fifo_entries);
 			if (ret < 0)
@@ -582,6 +656,8 @@ int32_t adxl372_service_fifo_ev(struct adxl372_dev *dev,
 
 /**
  * Get the data stored in FIFO.
+ * The axes missing from the configured FIFO format are set to 0. In peak
+ * mode each sample holds the peak (x, y, z) values.
  * @param dev - The device structure.
  * @param samples - pointer to the raw data stored in the ADXL372_FIFO_DATA
  * @param cnt - How many samples should be retrieved from the FIFO DATA reg
@@ -591,34 +667,144 @@ int32_t adxl372_get_fifo_xyz_data(struct adxl372_dev *dev,
 				  struct adxl372_xyz_accel_data *samples,
 				  uint16_t cnt)
 {
-	uint8_t buf[1024];
+	uint16_t *data;
+	uint8_t mask;
+	uint8_t axes;
 	uint16_t i;
 	int32_t ret;
 
-
-	if (cnt > 512)
+	if (cnt > ADXL372_FIFO_SIZE)
 		return -1;
-	/*
-	 * The FIFO can hold up to 512 samples.
-	 * Each sample is 2 bytes, that's why we read (cnt * 2) bytes
-	 */
-	ret = adxl372_read_reg_multiple(dev,
-					ADXL372_FIFO_DATA,
-					buf,
-					cnt * 2);
+
+	mask = adxl372_fifo_axes_mask[dev->fifo_config.fifo_format & 0x7];
+	axes = adxl372_fifo_axes(dev->fifo_config.fifo_format);
+
+	ret = adxl372_fifo_burst(dev, cnt, &data);
 	if (ret < 0)
 		return ret;
 
-	for (i = 0; i < cnt * 2; i += 6) {
-		samples->x = ((buf[i] << 4) | (buf[i+1] >> 4));
-		samples->y = ((buf[i+2] << 4) | (buf[i+3] >> 4));
-		samples->z = ((buf[i+4] << 4) | (buf[i+5] >> 4));
+	for (i = 0; i + axes <= cnt; i += axes) {
+		samples->x = (mask & 0x1) ? *data++ : 0;
+		samples->y = (mask & 0x2) ? *data++ : 0;
+		samples->z = (mask & 0x4) ? *data++ : 0;
 		samples++;
 	}
 
 	return ret;
 }
 
+/**
+ * FIFO watermark interrupt handler. Drains the FIFO with a single burst read
+ * and appends the decoded samples to the caller ring buffer.
+ * @param ctx - The device structure.
+ * @param event - Unused.
+ * @param extra - Unused.
+ */
+static void adxl372_fifo_irq_handler(void *ctx, uint32_t event, void *extra)
+{
+	struct adxl372_dev *dev = ctx;
+	uint8_t status1, status2;
+	uint16_t entries;
+	uint16_t *data;
+	uint32_t size;
+	uint8_t axes;
+	int32_t ret;
+
+	irq_disable(dev->irq_ctrl, dev->irq_id);
+
+	ret = adxl372_get_status(dev, &status1, &status2, &entries);
+	if (ret < 0)
+		goto out;
+
+	if (ADXL372_STATUS_1_FIFO_OVR(status1))
+		dev->fifo_overruns++;
+
+	/* Read whole sets only, leaving one set in the FIFO. */
+	axes = adxl372_fifo_axes(dev->fifo_config.fifo_format);
+	if (entries <= axes)
+		goto out;
+	entries = ((entries - axes) / axes) * axes;
+
+	ret = adxl372_fifo_burst(dev, entries, &data);
+	if (ret < 0)
+		goto out;
+
+	cb_write(dev->stream_cb, data, entries * sizeof(*data));
+	if (cb_size(dev->stream_cb, &size) == -EOVERRUN)
+		dev->stream_overruns++;
+out:
+	irq_enable(dev->irq_ctrl, dev->irq_id);
+}
+
+/**
+ * Start streaming the FIFO to a caller ring buffer.
+ * The FIFO watermark and overrun interrupts are mapped on the selected pin,
+ * and every watermark event drains the FIFO from interrupt context. The FIFO
+ * must be configured in a mode other than ADXL372_FIFO_BYPASSED.
+ * @param dev - The device structure.
+ * @param param - The streaming parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adxl372_fifo_stream_start(struct adxl372_dev *dev,
+				  const struct adxl372_fifo_stream_param *param)
+{
+	struct callback_desc cb;
+	uint8_t map;
+	int32_t ret;
+
+	if (!dev || !param || !param->irq_ctrl || !param->cb)
+		return -1;
+
+	if (dev->fifo_config.fifo_mode == ADXL372_FIFO_BYPASSED)
+		return -1;
+
+	map = ADXL372_INT1_MAP_FIFO_FULL_MSK | ADXL372_INT1_MAP_FIFO_OVR_MSK;
+	ret = adxl372_write_mask(dev, param->use_int2 ? ADXL372_INT2_MAP :
+				 ADXL372_INT1_MAP, map, map);
+	if (ret < 0)
+		return ret;
+
+	dev->irq_ctrl = param->irq_ctrl;
+	dev->irq_id = param->irq_id;
+	dev->stream_cb = param->cb;
+	dev->fifo_overruns = 0;
+	dev->stream_overruns = 0;
+
+	cb.callback = adxl372_fifo_irq_handler;
+	cb.ctx = dev;
+	cb.config = param->irq_config;
+	ret = irq_register_callback(dev->irq_ctrl, dev->irq_id, &cb);
+	if (ret < 0)
+		return ret;
+
+	return irq_enable(dev->irq_ctrl, dev->irq_id);
+}
+
+/**
+ * Stop streaming the FIFO.
+ * @param dev - The device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adxl372_fifo_stream_stop(struct adxl372_dev *dev)
+{
+	int32_t ret;
+
+	if (!dev || !dev->stream_cb)
+		return -1;
+
+	ret = irq_disable(dev->irq_ctrl, dev->irq_id);
+	if (ret < 0)
+		return ret;
+
+	ret = irq_unregister(dev->irq_ctrl, dev->irq_id);
+	if (ret < 0)
+		return ret;
+
+	dev->stream_cb = NULL;
+
+	return ret;
+}
+
 /**
  * Retrieve the highest magnitude (x, y, z) sample recorded since the last
  * read of the MAXPEAK registers
@@ -703,9 +889,17 @@ int32_t adxl372_init(struct adxl372_dev **device,
 	uint8_t dev_id, part_id, rev_id;
 	int32_t ret;
 
-	dev = (struct adxl372_dev *)malloc(sizeof(*dev));
+	dev = (struct adxl372_dev *)calloc(1, sizeof(*dev));
 	if (!dev)
+		return -1;
+
+	/* Decoded samples, preceded by one word holding the SPI command. */
+	dev->fifo_buf = (uint16_t *)calloc(ADXL372_FIFO_SIZE + 1,
+					   sizeof(*dev->fifo_buf));
+	if (!dev->fifo_buf) {
+		ret = -1;
 		goto error;
+	}
 
 	dev->comm_type = init_param.comm_type;
 	if (dev->comm_type == SPI) {
@@ -812,7 +1006,37 @@ int32_t adxl372_init(struct adxl372_dev **device,
 	}
 error:
 	printf("adxl372 initialization error (%d)\n", ret);
+	free(dev->fifo_buf);
 	free(dev);
 	mdelay(1000);
 	return ret;
 }
+
+/**
+ * Free the resources allocated by adxl372_init().
+ * @param dev - The device structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adxl372_remove(struct adxl372_dev *dev)
+{
+	int32_t ret;
+
+	if (!dev)
+		return -1;
+
+	if (dev->stream_cb)
+		adxl372_fifo_stream_stop(dev);
+
+	if (dev->comm_type == SPI)
+		ret = spi_remove(dev->spi_desc);
+	else
+		ret = i2c_remove(dev->i2c_desc);
+
+	ret |= gpio_remove(dev->gpio_int1);
+	ret |= gpio_remove(dev->gpio_int2);
+
+	free(dev->fifo_buf);
+	free(dev);
+
+	return ret;
+}
@@ -49,6 +49,8 @@
 #include "gpio.h"
 #include "i2c.h"
 #include "spi.h"
+#include "irq.h"
+#include "circular_buffer.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -118,6 +120,9 @@
 #define ADXL372_REVID_VAL       0x02u   /* product revision ID*/
 #define ADXL372_RESET_CODE	0x52u	/* Writing code 0x52 resets the device */
 
+/* Number of 16-bit entries of the FIFO */
+#define ADXL372_FIFO_SIZE	512
+
 #define ADXL372_REG_READ(x)	(((x & 0xFF) << 1) | 0x01)
 #define ADXL372_REG_WRITE(x)	((x & 0xFF) << 1)
 
@@ -341,6 +346,21 @@ struct adxl372_xyz_accel_data {
 	uint16_t z;
 } ;
 
+struct adxl372_fifo_stream_param {
+	/* Controller of the interrupt connected to the INT pin */
+	struct irq_ctrl_desc	*irq_ctrl;
+	uint32_t		irq_id;
+	/* Platform specific interrupt configuration */
+	void			*irq_config;
+	/* Map the watermark and overrun interrupts on INT2 instead of INT1 */
+	bool			use_int2;
+	/*
+	 * Caller ring buffer receiving the decoded 12-bit samples, as 16-bit
+	 * words, in FIFO order. Each set holds adxl372_fifo_axes() words.
+	 */
+	struct circular_buffer	*cb;
+};
+
 struct adxl372_irq_config {
 	bool data_rdy;
 	bool fifo_rdy;
@@ -384,6 +404,15 @@ struct adxl372_dev {
 	enum adxl372_instant_on_th_mode	th_mode;
 	struct adxl372_fifo_config	fifo_config;
 	enum adxl372_comm_type		comm_type;
+	/* FIFO streaming */
+	uint16_t			*fifo_buf;
+	struct circular_buffer		*stream_cb;
+	struct irq_ctrl_desc		*irq_ctrl;
+	uint32_t			irq_id;
+	/* Watermark events where the device FIFO had overflowed */
+	uint32_t			fifo_overruns;
+	/* Watermark events where the caller ring buffer was overrun */
+	uint32_t			stream_overruns;
 };
 
 struct adxl372_init_param {
@@ -474,6 +503,7 @@ int32_t adxl372_configure_fifo(struct adxl372_dev *dev,
 			       enum adxl372_fifo_mode mode,
 			       enum adxl372_fifo_format format,
 			       uint16_t fifo_samples);
+uint8_t adxl372_fifo_axes(enum adxl372_fifo_format format);
 int32_t adxl372_get_fifo_xyz_data(struct adxl372_dev *dev,
 				  struct adxl372_xyz_accel_data *fifo_data,
 				  uint16_t cnt);
@@ -484,7 +514,11 @@ int32_t adxl372_get_highest_peak_data(struct adxl372_dev *dev,
 				      struct adxl372_xyz_accel_data *max_peak);
 int32_t adxl372_get_accel_data(struct adxl372_dev *dev,
 			       struct adxl372_xyz_accel_data *accel_data);
+int32_t adxl372_fifo_stream_start(struct adxl372_dev *dev,
+				  const struct adxl372_fifo_stream_param *param);
+int32_t adxl372_fifo_stream_stop(struct adxl372_dev *dev);
 int32_t adxl372_init(struct adxl372_dev **device,
 		     struct adxl372_init_param init_param);
+int32_t adxl372_remove(struct adxl372_dev *dev);
 
 #endif // ADXL372_H_
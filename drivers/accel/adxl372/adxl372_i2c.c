@@ -105,24 +105,12 @@ int32_t adxl372_i2c_reg_read_multiple(struct adxl372_dev *dev,
 				      uint8_t *reg_data,
 				      uint16_t count)
 {
-	uint8_t buf[512];
 	int32_t ret;
 
-	if (count > 512)
-		return FAILURE;
-
-	buf[0] = reg_addr;
-	memset(&buf[1], 0x00, count - 1);
-
-	ret = i2c_write(dev->i2c_desc, buf, 1, 0);
-	if (ret < 0)
-		return ret;
-
-	ret = i2c_read(dev->i2c_desc, buf, count, 0);
+	ret = i2c_write(dev->i2c_desc, &reg_addr, 1, 0);
 	if (ret < 0)
 		return ret;
 
-	memcpy(reg_data, buf, count);
-
-	return ret;
+	/* Read straight into the caller buffer, FIFO reads can be 1 KB long */
+	return i2c_read(dev->i2c_desc, reg_data, count, 0);
 }
@@ -113,11 +113,7 @@ int32_t ad5593r_read_adc(struct ad5592r_dev *dev, uint8_t chan,
 		return ret;
 
 	data[0] = AD5593R_MODE_ADC_READBACK;
-	ret = i2c_write(dev->i2c, data, 1, STOP_BIT);
-	if (ret < 0)
-		return ret;
-
-	ret = i2c_read(dev->i2c, data, 2, STOP_BIT);
+	ret = i2c_write_read(dev->i2c, data, 1, data, 2);
 	if (ret < 0)
 		return ret;
 
@@ -219,11 +215,7 @@ int32_t ad5593r_reg_read(struct ad5592r_dev *dev, uint8_t reg,
 
 	data[0] = AD5593R_MODE_REG_READBACK | reg;
 
-	ret = i2c_write(dev->i2c, data, 1, STOP_BIT);
-	if (ret < 0)
-		return ret;
-
-	ret = i2c_read(dev->i2c, data, sizeof(data), STOP_BIT);
+	ret = i2c_write_read(dev->i2c, data, 1, data, sizeof(data));
 	if (ret < 0)
 		return ret;
 
@@ -45,6 +45,7 @@
 #include <stdbool.h>
 #include "ad7124.h"
 #include "delay.h"
+#include "error.h"
 
 /* Error codes */
 #define INVALID_VAL -1 /* Invalid argument */
@@ -59,6 +60,40 @@
 #define AD7124_POST_RESET_DELAY      4
 
 
+/***************************************************************************//**
+ * @brief Enables or disables the continuous read mode, used by the common
+ *        sigma-delta layer.
+ *
+ * @param priv   - The handler of the instance of the driver.
+ * @param enable - Whether to enter or to leave the continuous read mode.
+ *
+ * @return Returns 0 for success or negative error code.
+*******************************************************************************/
+static int32_t ad7124_set_cont_read(void *priv, bool enable)
+{
+	struct ad7124_dev *dev = priv;
+	struct ad7124_st_reg *reg = &dev->regs[AD7124_ADC_Control];
+
+	if (enable)
+		reg->value |= AD7124_ADC_CTRL_REG_CONT_READ;
+	else
+		reg->value &= ~AD7124_ADC_CTRL_REG_CONT_READ;
+
+	return ad7124_write_register(dev, *reg);
+}
+
+static const struct ad_sd_info ad7124_sd_info = {
+	.comm_read = AD7124_COMM_REG_RD,
+	.addr_shift = 0,
+	.addr_mask = 0x3F,
+	.status_reg = AD7124_STATUS_REG,
+	.data_reg = AD7124_DATA_REG,
+	.status_rdy = AD7124_STATUS_REG_RDY,
+	.status_ch_mask = AD7124_STATUS_REG_CH_ACTIVE(0xF),
+	.reset_len = 8,
+	.set_cont_read = ad7124_set_cont_read,
+};
+
 /***************************************************************************//**
  * @brief Reads the value of the specified register without checking if the
  *        device is ready to accept user requests.
@@ -76,16 +111,11 @@ int32_t ad7124_no_check_read_register(struct ad7124_dev *dev,
 	int32_t ret = 0;
 	uint8_t buffer[8] = {0, 0, 0, 0, 0, 0, 0, 0};
 	uint8_t i = 0;
-	uint8_t check8 = 0, add_status_length = 0;
-	uint8_t msg_buf[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+	uint8_t add_status_length = 0;
 
 	if(!dev || !p_reg)
 		return INVALID_VAL;
 
-	/* Build the Command word */
-	buffer[0] = AD7124_COMM_REG_WEN | AD7124_COMM_REG_RD |
-		    AD7124_COMM_REG_RA(p_reg->addr);
-
 	/*
 	 * If this is an AD7124_DATA register read, and the DATA_STATUS bit is set
 	 * in ADC_CONTROL, need to read 4, not 3 bytes for DATA with STATUS
@@ -95,40 +125,27 @@ int32_t ad7124_no_check_read_register(struct ad7124_dev *dev,
 		add_status_length = 1;
 	}
 
-	/* Read data from the device */
-	ret = spi_write_and_read(dev->spi_desc,
-				 buffer,
-				 ((dev->use_crc != AD7124_DISABLE_CRC) ? p_reg->size + 1
-				  : p_reg->size) + 1 + add_status_length);
-	if(ret < 0)
-		return ret;
-
-	/* Check the CRC */
-	if(dev->use_crc == AD7124_USE_CRC) {
-		msg_buf[0] = AD7124_COMM_REG_WEN | AD7124_COMM_REG_RD |
-			     AD7124_COMM_REG_RA(p_reg->addr);
-		for(i = 1; i < p_reg->size + 2 + add_status_length; ++i) {
-			msg_buf[i] = buffer[i];
-		}
-		check8 = ad7124_compute_crc8(msg_buf, p_reg->size + 2 + add_status_length);
-	}
-
-	if(check8 != 0) {
+	/* Read data from the device, the CRC is checked by the common layer */
+	ret = ad_sd_read(dev->sd, p_reg->addr, buffer,
+			 p_reg->size + add_status_length);
+	if (ret == -EIO) {
 		/* ReadRegister checksum failed. */
 		return COMM_ERR;
 	}
+	if(ret < 0)
+		return ret;
 
 	/*
 	 * if reading Data with 4 bytes, need to copy the status byte to the STATUS
 	 * register struct value member
 	 */
 	if (add_status_length) {
-		dev->regs[AD7124_Status].value = buffer[p_reg->size + 1];
+		dev->regs[AD7124_Status].value = buffer[p_reg->size];
 	}
 
 	/* Build the result */
 	p_reg->value = 0;
-	for(i = 1; i < p_reg->size + 1; i++) {
+	for(i = 0; i < p_reg->size; i++) {
 		p_reg->value <<= 8;
 		p_reg->value += buffer[i];
 	}
@@ -148,39 +165,10 @@ int32_t ad7124_no_check_read_register(struct ad7124_dev *dev,
 int32_t ad7124_no_check_write_register(struct ad7124_dev *dev,
 				       struct ad7124_st_reg reg)
 {
-	int32_t ret = 0;
-	int32_t reg_value = 0;
-	uint8_t wr_buf[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-	uint8_t i = 0;
-	uint8_t crc8 = 0;
-
 	if(!dev)
 		return INVALID_VAL;
 
-	/* Build the Command word */
-	wr_buf[0] = AD7124_COMM_REG_WEN | AD7124_COMM_REG_WR |
-		    AD7124_COMM_REG_RA(reg.addr);
-
-	/* Fill the write buffer */
-	reg_value = reg.value;
-	for(i = 0; i < reg.size; i++) {
-		wr_buf[reg.size - i] = reg_value & 0xFF;
-		reg_value >>= 8;
-	}
-
-	/* Compute the CRC */
-	if(dev->use_crc != AD7124_DISABLE_CRC) {
-		crc8 = ad7124_compute_crc8(wr_buf, reg.size + 1);
-		wr_buf[reg.size + 1] = crc8;
-	}
-
-	/* Write data to the device */
-	ret = spi_write_and_read(dev->spi_desc,
-				 wr_buf,
-				 (dev->use_crc != AD7124_DISABLE_CRC) ? reg.size + 2
-				 : reg.size + 1);
-
-	return ret;
+	return ad_sd_write_reg(dev->sd, reg.addr, reg.size, reg.value);
 }
 
 /***************************************************************************//**
@@ -249,17 +237,15 @@ int32_t ad7124_write_register(struct ad7124_dev *dev,
 int32_t ad7124_reset(struct ad7124_dev *dev)
 {
 	int32_t ret = 0;
-	uint8_t wr_buf[8] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
 
 	if(!dev)
 		return INVALID_VAL;
 
-	ret = spi_write_and_read(dev->spi_desc,
-				 wr_buf,
-				 8);
+	ret = ad_sd_reset(dev->sd);
 
 	/* CRC is disabled after reset */
 	dev->use_crc = AD7124_DISABLE_CRC;
+	ad_sd_set_check(dev->sd, AD_SD_CHECK_NONE);
 
 	/* Read POR bit to clear */
 	ret = ad7124_wait_to_power_on(dev,
@@ -359,6 +345,12 @@ int32_t ad7124_wait_for_conv_ready(struct ad7124_dev *dev,
 	if(!dev)
 		return INVALID_VAL;
 
+	/* Poll the DOUT/RDY line instead of the Status Register, if available */
+	if (dev->sd->gpio_rdy) {
+		ret = ad_sd_wait_for_rdy(dev->sd, timeout);
+		return (ret == -ETIMEDOUT) ? TIMEOUT : ret;
+	}
+
 	regs = dev->regs;
 
 	while(!ready && --timeout) {
@@ -403,6 +395,64 @@ int32_t ad7124_read_data(struct ad7124_dev *dev,
 	return ret;
 }
 
+/***************************************************************************//**
+ * @brief Enters the continuous read mode. Every conversion result, followed
+ *        by the status byte if DATA_STATUS is set, is then read on the
+ *        DOUT/RDY interrupt and buffered until ad7124_read_samples() is called.
+ *
+ * @param dev - The handler of the instance of the driver.
+ *
+ * @return Returns 0 for success or negative error code.
+*******************************************************************************/
+int32_t ad7124_continuous_read_start(struct ad7124_dev *dev)
+{
+	if(!dev)
+		return INVALID_VAL;
+
+	ad_sd_set_data_format(dev->sd, dev->regs[AD7124_Data].size,
+			      dev->regs[AD7124_ADC_Control].value &
+			      AD7124_ADC_CTRL_REG_DATA_STATUS);
+
+	return ad_sd_cont_read_start(dev->sd);
+}
+
+/***************************************************************************//**
+ * @brief Leaves the continuous read mode.
+ *
+ * @param dev - The handler of the instance of the driver.
+ *
+ * @return Returns 0 for success or negative error code.
+*******************************************************************************/
+int32_t ad7124_continuous_read_stop(struct ad7124_dev *dev)
+{
+	if(!dev)
+		return INVALID_VAL;
+
+	return ad_sd_cont_read_stop(dev->sd, dev->spi_rdy_poll_cnt);
+}
+
+/***************************************************************************//**
+ * @brief Reads the samples buffered in continuous read mode. The channel of
+ *        each sample is decoded from the status byte, when enabled.
+ *
+ * @param dev        - The handler of the instance of the driver.
+ * @param samples    - Buffer for the samples.
+ * @param nb_samples - Maximum number of samples to be read.
+ * @param nb_read    - Number of samples read.
+ *
+ * @return Returns 0 for success or negative error code.
+*******************************************************************************/
+int32_t ad7124_read_samples(struct ad7124_dev *dev,
+			    struct ad_sd_sample *samples,
+			    uint32_t nb_samples,
+			    uint32_t *nb_read)
+{
+	if(!dev)
+		return INVALID_VAL;
+
+	return ad_sd_cont_read_samples(dev->sd, samples, nb_samples, nb_read);
+}
+
 /***************************************************************************//**
  * @brief Computes the CRC checksum for a data buffer.
  *
@@ -452,8 +502,10 @@ void ad7124_update_crcsetting(struct ad7124_dev *dev)
 	/* Get CRC State. */
 	if (regs[AD7124_Error_En].value & AD7124_ERREN_REG_SPI_CRC_ERR_EN) {
 		dev->use_crc = AD7124_USE_CRC;
+		ad_sd_set_check(dev->sd, AD_SD_CHECK_CRC8);
 	} else {
 		dev->use_crc = AD7124_DISABLE_CRC;
+		ad_sd_set_check(dev->sd, AD_SD_CHECK_NONE);
 	}
 }
 
@@ -495,6 +547,7 @@ int32_t ad7124_setup(struct ad7124_dev **device,
 	int32_t ret;
 	enum ad7124_registers reg_nr;
 	struct ad7124_dev *dev;
+	struct ad_sd_init_param sd_init = init_param->sd_init;
 
 	dev = (struct ad7124_dev *)malloc(sizeof(*dev));
 	if (!dev)
@@ -508,6 +561,14 @@ int32_t ad7124_setup(struct ad7124_dev **device,
 	if (ret < 0)
 		return ret;
 
+	/* Initialize the common sigma-delta layer. */
+	sd_init.spi_desc = dev->spi_desc;
+	sd_init.info = &ad7124_sd_info;
+	sd_init.priv = dev;
+	ret = ad_sd_init(&dev->sd, &sd_init);
+	if (ret < 0)
+		return ret;
+
 	/*  Reset the device interface.*/
 	ret = ad7124_reset(dev);
 	if (ret < 0)
@@ -548,6 +609,10 @@ int32_t ad7124_remove(struct ad7124_dev *dev)
 {
 	int32_t ret;
 
+	ret = ad_sd_remove(dev->sd);
+	if (ret < 0)
+		return ret;
+
 	ret = spi_remove(dev->spi_desc);
 
 	free(dev);
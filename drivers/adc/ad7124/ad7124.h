@@ -47,6 +47,7 @@
 #include <stdint.h>
 #include "spi.h"
 #include "delay.h"
+#include "ad_sigma_delta.h"
 
 /******************************************************************************/
 /******************* Register map and register definitions ********************/
@@ -342,10 +343,12 @@ enum ad7124_registers {
  * @spi_rdy_poll_cnt: Number of times the driver should read the Error register
  *                    to check if the device is ready to accept user requests,
  *                    before a timeout error will be issued.
+ * @sd: Common sigma-delta layer handling the serial interface.
  */
 struct ad7124_dev {
 	/* SPI */
 	spi_desc		*spi_desc;
+	struct ad_sd_dev	*sd;
 	/* Device Settings */
 	struct ad7124_st_reg	*regs;
 	int16_t use_crc;
@@ -359,6 +362,9 @@ struct ad7124_init_param {
 	/* Device Settings */
 	struct ad7124_st_reg	*regs;
 	int16_t spi_rdy_poll_cnt;
+	/* DOUT/RDY GPIO and interrupt, needed for continuous read. SPI and device
+	 * are set by setup */
+	struct ad_sd_init_param	sd_init;
 };
 
 /******************************************************************************/
@@ -407,6 +413,18 @@ int32_t ad7124_wait_for_conv_ready(struct ad7124_dev *dev,
 int32_t ad7124_read_data(struct ad7124_dev *dev,
 			 int32_t* p_data);
 
+/*! Enters the continuous read mode. */
+int32_t ad7124_continuous_read_start(struct ad7124_dev *dev);
+
+/*! Leaves the continuous read mode. */
+int32_t ad7124_continuous_read_stop(struct ad7124_dev *dev);
+
+/*! Reads the samples buffered in continuous read mode. */
+int32_t ad7124_read_samples(struct ad7124_dev *dev,
+			    struct ad_sd_sample *samples,
+			    uint32_t nb_samples,
+			    uint32_t *nb_read);
+
 /*! Computes the CRC checksum for a data buffer. */
 uint8_t ad7124_compute_crc8(uint8_t* p_buf,
 			    uint8_t buf_size);
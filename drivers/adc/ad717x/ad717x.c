@@ -45,13 +45,29 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdlib.h>
+#include <stdbool.h>
 #include "ad717x.h"
+#include "error.h"
 
 /* Error codes */
 #define INVALID_VAL -1 /* Invalid argument */
 #define COMM_ERR    -2 /* Communication error on receive */
 #define TIMEOUT     -3 /* A timeout has occured */
 
+static int32_t AD717X_SetContRead(void *priv, bool enable);
+
+static const struct ad_sd_info ad717x_sd_info = {
+	.comm_read = AD717X_COMM_REG_RD,
+	.addr_shift = 0,
+	.addr_mask = 0x3F,
+	.status_reg = AD717X_STATUS_REG,
+	.data_reg = AD717X_DATA_REG,
+	.status_rdy = AD717X_STATUS_REG_RDY,
+	.status_ch_mask = AD717X_STATUS_REG_CH(0x0F),
+	.reset_len = 8,
+	.set_cont_read = AD717X_SetContRead,
+};
+
 /***************************************************************************//**
 * @brief  Searches through the list of registers of the driver instance and
 *         retrieves a pointer to the register that matches the given address.
@@ -95,8 +111,6 @@ int32_t AD717X_ReadRegister(ad717x_dev *device,
 	int32_t ret       = 0;
 	uint8_t buffer[8] = {0, 0, 0, 0, 0, 0, 0, 0};
 	uint8_t i         = 0;
-	uint8_t check8    = 0;
-	uint8_t msgBuf[8] = {0, 0, 0, 0, 0, 0, 0, 0};
 	ad717x_st_reg *pReg;
 
 	if(!device)
@@ -106,44 +120,18 @@ int32_t AD717X_ReadRegister(ad717x_dev *device,
 	if (!pReg)
 		return INVALID_VAL;
 
-	/* Build the Command word */
-	buffer[0] = AD717X_COMM_REG_WEN | AD717X_COMM_REG_RD |
-		    AD717X_COMM_REG_RA(pReg->addr);
-
-	/* Read data from the device */
-	ret = spi_write_and_read(device->spi_desc,
-				 buffer,
-				 ((device->useCRC != AD717X_DISABLE) ? pReg->size + 1
-				  : pReg->size) + 1);
-	if(ret < 0)
-		return ret;
-
-	/* Check the CRC */
-	if(device->useCRC == AD717X_USE_CRC) {
-		msgBuf[0] = AD717X_COMM_REG_WEN | AD717X_COMM_REG_RD |
-			    AD717X_COMM_REG_RA(pReg->addr);
-		for(i = 1; i < pReg->size + 2; ++i) {
-			msgBuf[i] = buffer[i];
-		}
-		check8 = AD717X_ComputeCRC8(msgBuf, pReg->size + 2);
-	}
-	if(device->useCRC == AD717X_USE_XOR) {
-		msgBuf[0] = AD717X_COMM_REG_WEN | AD717X_COMM_REG_RD |
-			    AD717X_COMM_REG_RA(pReg->addr);
-		for(i = 1; i < pReg->size + 2; ++i) {
-			msgBuf[i] = buffer[i];
-		}
-		check8 = AD717X_ComputeXOR8(msgBuf, pReg->size + 2);
-	}
-
-	if(check8 != 0) {
+	/* Read data from the device, the CRC/XOR is checked by the common layer */
+	ret = ad_sd_read(device->sd, pReg->addr, buffer, pReg->size);
+	if (ret == -EIO) {
 		/* ReadRegister checksum failed. */
 		return COMM_ERR;
 	}
+	if(ret < 0)
+		return ret;
 
 	/* Build the result */
 	pReg->value = 0;
-	for(i = 1; i < pReg->size + 1; i++) {
+	for(i = 0; i < pReg->size; i++) {
 		pReg->value <<= 8;
 		pReg->value += buffer[i];
 	}
@@ -164,11 +152,6 @@ int32_t AD717X_ReadRegister(ad717x_dev *device,
 int32_t AD717X_WriteRegister(ad717x_dev *device,
 			     uint8_t addr)
 {
-	int32_t ret      = 0;
-	int32_t regValue = 0;
-	uint8_t wrBuf[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-	uint8_t i        = 0;
-	uint8_t crc8     = 0;
 	ad717x_st_reg *preg;
 
 	if(!device)
@@ -178,30 +161,7 @@ int32_t AD717X_WriteRegister(ad717x_dev *device,
 	if (!preg)
 		return INVALID_VAL;
 
-	/* Build the Command word */
-	wrBuf[0] = AD717X_COMM_REG_WEN | AD717X_COMM_REG_WR |
-		   AD717X_COMM_REG_RA(preg->addr);
-
-	/* Fill the write buffer */
-	regValue = preg->value;
-	for(i = 0; i < preg->size; i++) {
-		wrBuf[preg->size - i] = regValue & 0xFF;
-		regValue >>= 8;
-	}
-
-	/* Compute the CRC */
-	if(device->useCRC != AD717X_DISABLE) {
-		crc8 = AD717X_ComputeCRC8(wrBuf, preg->size + 1);
-		wrBuf[preg->size + 1] = crc8;
-	}
-
-	/* Write data to the device */
-	ret = spi_write_and_read(device->spi_desc,
-				 wrBuf,
-				 (device->useCRC != AD717X_DISABLE) ?
-				 preg->size + 2 : preg->size + 1);
-
-	return ret;
+	return ad_sd_write_reg(device->sd, preg->addr, preg->size, preg->value);
 }
 
 /***************************************************************************//**
@@ -213,17 +173,10 @@ int32_t AD717X_WriteRegister(ad717x_dev *device,
 *******************************************************************************/
 int32_t AD717X_Reset(ad717x_dev *device)
 {
-	int32_t ret = 0;
-	uint8_t wrBuf[8] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
-
 	if(!device)
 		return INVALID_VAL;
 
-	ret = spi_write_and_read(device->spi_desc,
-				 wrBuf,
-				 8);
-
-	return ret;
+	return ad_sd_reset(device->sd);
 }
 
 /***************************************************************************//**
@@ -249,6 +202,12 @@ int32_t AD717X_WaitForReady(ad717x_dev *device,
 	if (!statusReg)
 		return INVALID_VAL;
 
+	/* Poll the DOUT/RDY line instead of the Status Register, if available */
+	if (device->sd->gpio_rdy) {
+		ret = ad_sd_wait_for_rdy(device->sd, timeout);
+		return (ret == -ETIMEDOUT) ? TIMEOUT : ret;
+	}
+
 	while(!ready && --timeout) {
 		/* Read the value of the Status Register */
 		ret = AD717X_ReadRegister(device, AD717X_STATUS_REG);
@@ -295,6 +254,107 @@ int32_t AD717X_ReadData(ad717x_dev *device,
 	return ret;
 }
 
+/***************************************************************************//**
+* @brief Enables or disables the continuous read mode, used by the common
+*        sigma-delta layer.
+*
+* @param priv   - The handler of the instance of the driver.
+* @param enable - Whether to enter or to leave the continuous read mode.
+*
+* @return Returns 0 for success or negative error code.
+*******************************************************************************/
+static int32_t AD717X_SetContRead(void *priv, bool enable)
+{
+	ad717x_dev *device = priv;
+	ad717x_st_reg *interfaceReg;
+
+	interfaceReg = AD717X_GetReg(device, AD717X_IFMODE_REG);
+	if (!interfaceReg)
+		return INVALID_VAL;
+
+	if (enable)
+		interfaceReg->value |= AD717X_IFMODE_REG_CONT_READ;
+	else
+		interfaceReg->value &= ~AD717X_IFMODE_REG_CONT_READ;
+
+	return AD717X_WriteRegister(device, AD717X_IFMODE_REG);
+}
+
+/***************************************************************************//**
+* @brief Enters the continuous read mode. Every conversion result, followed
+*        by the status byte if DATA_STAT is set, is then read on the DOUT/RDY
+*        interrupt and buffered until AD717X_ReadSamples() is called.
+*
+* @param device - The handler of the instance of the driver.
+*
+* @return Returns 0 for success or negative error code.
+*******************************************************************************/
+int32_t AD717X_ContReadStart(ad717x_dev *device)
+{
+	ad717x_st_reg *interfaceReg;
+	ad717x_st_reg *dataReg;
+	bool status;
+	int32_t ret;
+
+	if(!device || !device->regs)
+		return INVALID_VAL;
+
+	interfaceReg = AD717X_GetReg(device, AD717X_IFMODE_REG);
+	dataReg = AD717X_GetReg(device, AD717X_DATA_REG);
+	if (!interfaceReg || !dataReg)
+		return INVALID_VAL;
+
+	ret = AD717X_ComputeDataregSize(device);
+	if (ret < 0)
+		return ret;
+
+	/* The data register size accounts for the appended status byte */
+	status = interfaceReg->value & AD717X_IFMODE_REG_DATA_STAT;
+	ad_sd_set_data_format(device->sd, dataReg->size - status, status);
+
+	return ad_sd_cont_read_start(device->sd);
+}
+
+/***************************************************************************//**
+* @brief Leaves the continuous read mode.
+*
+* @param device  - The handler of the instance of the driver.
+* @param timeout - Count representing the number of polls to be done while
+*                  waiting for the last conversion.
+*
+* @return Returns 0 for success or negative error code.
+*******************************************************************************/
+int32_t AD717X_ContReadStop(ad717x_dev *device,
+			    uint32_t timeout)
+{
+	if(!device)
+		return INVALID_VAL;
+
+	return ad_sd_cont_read_stop(device->sd, timeout);
+}
+
+/***************************************************************************//**
+* @brief Reads the samples buffered in continuous read mode. The channel of
+*        each sample is decoded from the status byte, when enabled.
+*
+* @param device    - The handler of the instance of the driver.
+* @param samples   - Buffer for the samples.
+* @param nbSamples - Maximum number of samples to be read.
+* @param nbRead    - Number of samples read.
+*
+* @return Returns 0 for success or negative error code.
+*******************************************************************************/
+int32_t AD717X_ReadSamples(ad717x_dev *device,
+			   struct ad_sd_sample *samples,
+			   uint32_t nbSamples,
+			   uint32_t *nbRead)
+{
+	if(!device)
+		return INVALID_VAL;
+
+	return ad_sd_cont_read_samples(device->sd, samples, nbSamples, nbRead);
+}
+
 /***************************************************************************//**
 * @brief Computes data register read size to account for bit number and status
 * 		 read.
@@ -405,10 +465,13 @@ int32_t AD717X_UpdateCRCSetting(ad717x_dev *device)
 	/* Get CRC State. */
 	if(AD717X_IFMODE_REG_CRC_STAT(interfaceReg->value)) {
 		device->useCRC = AD717X_USE_CRC;
+		ad_sd_set_check(device->sd, AD_SD_CHECK_CRC8);
 	} else if(AD717X_IFMODE_REG_XOR_STAT(interfaceReg->value)) {
 		device->useCRC = AD717X_USE_XOR;
+		ad_sd_set_check(device->sd, AD_SD_CHECK_XOR8);
 	} else {
 		device->useCRC = AD717X_DISABLE;
+		ad_sd_set_check(device->sd, AD_SD_CHECK_NONE);
 	}
 
 	return 0;
@@ -429,6 +492,7 @@ int32_t AD717X_Init(ad717x_dev **device,
 	ad717x_dev *dev;
 	int32_t ret;
 	ad717x_st_reg *preg;
+	struct ad_sd_init_param sd_init = init_param.sd_init;
 
 	dev = (ad717x_dev *)malloc(sizeof(*dev));
 	if (!dev)
@@ -436,12 +500,21 @@ int32_t AD717X_Init(ad717x_dev **device,
 
 	dev->regs = init_param.regs;
 	dev->num_regs = init_param.num_regs;
+	dev->useCRC = AD717X_DISABLE;
 
 	/* Initialize the SPI communication. */
 	ret = spi_init(&dev->spi_desc, &init_param.spi_init);
 	if (ret < 0)
 		return ret;
 
+	/* Initialize the common sigma-delta layer. */
+	sd_init.spi_desc = dev->spi_desc;
+	sd_init.info = &ad717x_sd_info;
+	sd_init.priv = dev;
+	ret = ad_sd_init(&dev->sd, &sd_init);
+	if (ret < 0)
+		return ret;
+
 	/*  Reset the device interface.*/
 	ret = AD717X_Reset(dev);
 	if (ret < 0)
@@ -498,6 +571,10 @@ int32_t AD717X_remove(ad717x_dev *dev)
 {
 	int32_t ret;
 
+	ret = ad_sd_remove(dev->sd);
+	if (ret < 0)
+		return ret;
+
 	ret = spi_remove(dev->spi_desc);
 
 	free(dev);
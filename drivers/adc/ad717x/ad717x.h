@@ -48,6 +48,7 @@
 /******************************************************************************/
 #include <stdint.h>
 #include "spi.h"
+#include "ad_sigma_delta.h"
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -73,10 +74,12 @@ typedef struct {
  *       provide when calling the Setup() function.
  * @num_regs: The length of the register list.
  * @userCRC: Error check type to use on SPI transfers.
+ * @sd: Common sigma-delta layer handling the serial interface.
  */
 typedef struct {
 	/* SPI */
 	spi_desc		*spi_desc;
+	struct ad_sd_dev	*sd;
 	/* Device Settings */
 	ad717x_st_reg		*regs;
 	uint8_t			num_regs;
@@ -89,6 +92,9 @@ typedef struct {
 	/* Device Settings */
 	ad717x_st_reg		*regs;
 	uint8_t			num_regs;
+	/* DOUT/RDY GPIO and interrupt, needed for continuous read. SPI and device
+	 * are set by init */
+	struct ad_sd_init_param	sd_init;
 } ad717x_init_param;
 
 /*****************************************************************************/
@@ -309,6 +315,19 @@ int32_t AD717X_WaitForReady(ad717x_dev *device,
 int32_t AD717X_ReadData(ad717x_dev *device,
 			int32_t* pData);
 
+/*! Enters the continuous read mode. */
+int32_t AD717X_ContReadStart(ad717x_dev *device);
+
+/*! Leaves the continuous read mode. */
+int32_t AD717X_ContReadStop(ad717x_dev *device,
+			    uint32_t timeout);
+
+/*! Reads the samples buffered in continuous read mode. */
+int32_t AD717X_ReadSamples(ad717x_dev *device,
+			   struct ad_sd_sample *samples,
+			   uint32_t nbSamples,
+			   uint32_t *nbRead);
+
 /*! Computes data register read size to account for bit number and status
  *  read. */
 int32_t AD717X_ComputeDataregSize(ad717x_dev *device);
@@ -43,6 +43,21 @@
 #include <stdlib.h>
 #include "ad7193.h"    // AD7193 definitions.
 
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+static const struct ad_sd_info ad7193_sd_info = {
+	.comm_read = AD7193_COMM_READ,
+	.comm_cont_read = AD7193_COMM_CREAD,
+	.addr_shift = 3,
+	.addr_mask = 0x7,
+	.status_reg = AD7193_REG_STAT,
+	.data_reg = AD7193_REG_DATA,
+	.status_rdy = AD7193_STAT_RDY,
+	.status_ch_mask = 0xF,
+	.reset_len = 6,
+};
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
@@ -65,6 +80,7 @@ int8_t ad7193_init(struct ad7193_dev **device,
 		   struct ad7193_init_param init_param)
 {
 	struct ad7193_dev *dev;
+	struct ad_sd_init_param sd_init = init_param.sd_init;
 	int8_t status = 0;
 	uint8_t reg_val = 0;
 
@@ -76,17 +92,23 @@ int8_t ad7193_init(struct ad7193_dev **device,
 	dev->current_gain = init_param.current_gain;
 
 	/* SPI */
-	status = spi_init(&dev->spi_desc, &init_param.spi_init);
+	if (spi_init(&dev->spi_desc, &init_param.spi_init))
+		goto error_dev;
 
 	/* GPIO */
-	status |= gpio_get(&dev->gpio_cs, &init_param.gpio_cs);
-	status |= gpio_get(&dev->gpio_miso, &init_param.gpio_miso);
+	if (gpio_get(&dev->gpio_cs, &init_param.gpio_cs))
+		goto error_spi;
 
-	if (dev->gpio_cs)
-		status |= gpio_direction_output(dev->gpio_cs,
-						GPIO_HIGH);
-	if (dev->gpio_miso)
-		status |= gpio_direction_input(dev->gpio_miso);
+	if (dev->gpio_cs && gpio_direction_output(dev->gpio_cs, GPIO_HIGH))
+		goto error_cs;
+
+	/* The DOUT/RDY GPIO is handled by the sigma-delta layer. */
+	sd_init.spi_desc = dev->spi_desc;
+	sd_init.info = &ad7193_sd_info;
+	sd_init.priv = dev;
+	sd_init.gpio_rdy = &init_param.gpio_miso;
+	if (ad_sd_init(&dev->sd, &sd_init))
+		goto error_cs;
 
 	reg_val = ad7193_get_register_value(dev,
 					    AD7193_REG_ID,
@@ -99,6 +121,15 @@ int8_t ad7193_init(struct ad7193_dev **device,
 	*device = dev;
 
 	return status;
+
+error_cs:
+	gpio_remove(dev->gpio_cs);
+error_spi:
+	spi_remove(dev->spi_desc);
+error_dev:
+	free(dev);
+
+	return -1;
 }
 
 /***************************************************************************//**
@@ -112,10 +143,10 @@ int32_t ad7193_remove(struct ad7193_dev *dev)
 {
 	int32_t status;
 
-	status = spi_remove(dev->spi_desc);
+	status = ad_sd_remove(dev->sd);
+	status |= spi_remove(dev->spi_desc);
 
 	status |= gpio_remove(dev->gpio_cs);
-	status |= gpio_remove(dev->gpio_miso);
 
 	free(dev);
 
@@ -139,20 +170,10 @@ void ad7193_set_register_value(struct ad7193_dev *dev,
 			       uint8_t bytes_number,
 			       uint8_t modify_cs)
 {
-	uint8_t write_command[5] = {0, 0, 0, 0, 0};
-	uint8_t* data_pointer    = (uint8_t*)&register_value;
-	uint8_t bytes_nr         = bytes_number;
-
-	write_command[0] = AD7193_COMM_WRITE |
-			   AD7193_COMM_ADDR(register_address);
-	while(bytes_nr > 0) {
-		write_command[bytes_nr] = *data_pointer;
-		data_pointer ++;
-		bytes_nr --;
-	}
 	if (modify_cs)
 		AD7193_CS_LOW;
-	spi_write_and_read(dev->spi_desc, write_command, bytes_number + 1);
+	ad_sd_write_reg(dev->sd, register_address, bytes_number,
+			register_value);
 	if (modify_cs)
 		AD7193_CS_HIGH;
 }
@@ -172,20 +193,13 @@ uint32_t ad7193_get_register_value(struct ad7193_dev *dev,
 				   uint8_t bytes_number,
 				   uint8_t modify_cs)
 {
-	uint8_t register_word[5] = {0, 0, 0, 0, 0};
 	uint32_t buffer = 0x0;
-	uint8_t i = 0;
 
-	register_word[0] = AD7193_COMM_READ |
-			   AD7193_COMM_ADDR(register_address);
 	if (modify_cs)
 		AD7193_CS_LOW;
-	spi_write_and_read(dev->spi_desc, register_word, bytes_number + 1);
+	ad_sd_read_reg(dev->sd, register_address, bytes_number, &buffer);
 	if (modify_cs)
 		AD7193_CS_HIGH;
-	for(i = 1; i < bytes_number + 1; i++) {
-		buffer = (buffer << 8) + register_word[i];
-	}
 
 	return buffer;
 }
@@ -199,15 +213,7 @@ uint32_t ad7193_get_register_value(struct ad7193_dev *dev,
 *******************************************************************************/
 void ad7193_reset(struct ad7193_dev *dev)
 {
-	uint8_t register_word[6] = {0, 0, 0, 0, 0, 0};
-
-	register_word[0] = 0xFF;
-	register_word[1] = 0xFF;
-	register_word[2] = 0xFF;
-	register_word[3] = 0xFF;
-	register_word[4] = 0xFF;
-	register_word[5] = 0xFF;
-	spi_write_and_read(dev->spi_desc, register_word, 6);
+	ad_sd_reset(dev->sd);
 }
 
 /***************************************************************************//**
@@ -242,16 +248,15 @@ void ad7193_set_power(struct ad7193_dev *dev,
 }
 
 /***************************************************************************//**
- * @brief Waits for RDY pin to go low.
+ * @brief Waits for RDY pin to go low, for at most AD7193_TIMEOUT polls.
+ *
+ * @param dev - The device structure.
  *
  * @return none.
 *******************************************************************************/
 void ad7193_wait_rdy_go_low(struct ad7193_dev *dev)
 {
-	uint8_t wait = 1;
-
-	while (wait)
-		AD7193_RDY_STATE(wait);
+	ad_sd_wait_for_rdy(dev->sd, AD7193_TIMEOUT);
 }
 
 /***************************************************************************//**
@@ -425,6 +430,73 @@ uint32_t ad7193_continuous_read_avg(struct ad7193_dev *dev,
 	return samples_average;
 }
 
+/***************************************************************************//**
+ * @brief Enters the continuous read mode. The device must be in continuous
+ *        conversion mode. Every conversion result, followed by the status
+ *        byte if DAT_STA is set, is then read on the DOUT/RDY interrupt and
+ *        buffered until ad7193_read_samples() is called. The chip select is
+ *        kept low until ad7193_cont_read_stop().
+ *
+ * @param dev - The device structure.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t ad7193_cont_read_start(struct ad7193_dev *dev)
+{
+	uint32_t mode;
+	int32_t ret;
+
+	mode = ad7193_get_register_value(dev,
+					 AD7193_REG_MODE,
+					 3,
+					 1);
+	ad_sd_set_data_format(dev->sd, 3, mode & AD7193_MODE_DAT_STA);
+
+	/* DOUT/RDY is only driven while the device is selected. */
+	AD7193_CS_LOW;
+	ret = ad_sd_cont_read_start(dev->sd);
+	if (ret)
+		AD7193_CS_HIGH;
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Leaves the continuous read mode.
+ *
+ * @param dev - The device structure.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t ad7193_cont_read_stop(struct ad7193_dev *dev)
+{
+	int32_t ret;
+
+	ret = ad_sd_cont_read_stop(dev->sd, AD7193_TIMEOUT);
+	AD7193_CS_HIGH;
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Reads the samples buffered in continuous read mode. The channel of
+ *        each sample is decoded from the status byte when DAT_STA is set.
+ *
+ * @param dev        - The device structure.
+ * @param samples    - The buffer for the samples.
+ * @param nb_samples - The maximum number of samples to be read.
+ * @param nb_read    - The number of samples read.
+ *
+ * @return 0 in case of success, -EOVERRUN if samples were lost, negative
+ *         error code otherwise.
+*******************************************************************************/
+int32_t ad7193_read_samples(struct ad7193_dev *dev,
+			    struct ad_sd_sample *samples,
+			    uint32_t nb_samples, uint32_t *nb_read)
+{
+	return ad_sd_cont_read_samples(dev->sd, samples, nb_samples, nb_read);
+}
+
 /***************************************************************************//**
  * @brief Read data from temperature sensor and converts it to Celsius degrees.
  *
@@ -46,6 +46,7 @@
 #include <stdint.h>
 #include "gpio.h"
 #include "spi.h"
+#include "ad_sigma_delta.h"
 
 /******************************************************************************/
 /******************************** AD7193 **************************************/
@@ -60,9 +61,8 @@
 #define AD7193_CS_HIGH          gpio_set_value(dev->gpio_cs,  \
 			        GPIO_HIGH)
 
-/* AD7193 GPIO */
-#define AD7193_RDY_STATE(value) gpio_get_value(dev->gpio_miso,  \
-                                &value)
+/* Number of DOUT/RDY polls before giving up on a conversion */
+#define AD7193_TIMEOUT          0xFFFFFF
 
 /* AD7193 Register Map */
 #define AD7193_REG_COMM         0 // Communications Register (WO, 8-bit)
@@ -184,7 +184,8 @@ struct ad7193_dev {
 	spi_desc	*spi_desc;
 	/* GPIO */
 	struct gpio_desc	*gpio_cs;
-	struct gpio_desc	*gpio_miso;
+	/* Common sigma-delta layer, owns the DOUT/RDY GPIO */
+	struct ad_sd_dev	*sd;
 	/* Device Settings */
 	uint8_t		current_polarity;
 	uint8_t		current_gain;
@@ -196,6 +197,9 @@ struct ad7193_init_param {
 	/* GPIO */
 	struct gpio_init_param	gpio_cs;
 	struct gpio_init_param	gpio_miso;
+	/* DOUT/RDY interrupt, needed for continuous read. SPI, device and
+	 * DOUT/RDY GPIO (gpio_miso) are set by init */
+	struct ad_sd_init_param	sd_init;
 	/* Device Settings */
 	uint8_t		current_polarity;
 	uint8_t		current_gain;
@@ -259,6 +263,17 @@ uint32_t ad7193_continuous_read_avg(struct ad7193_dev *dev,
 /*! Read data from temperature sensor and converts it to Celsius degrees. */
 float ad7193_temperature_read(struct ad7193_dev *dev);
 
+/*! Enters the continuous read mode. */
+int32_t ad7193_cont_read_start(struct ad7193_dev *dev);
+
+/*! Leaves the continuous read mode. */
+int32_t ad7193_cont_read_stop(struct ad7193_dev *dev);
+
+/*! Reads the samples buffered in continuous read mode. */
+int32_t ad7193_read_samples(struct ad7193_dev *dev,
+			    struct ad_sd_sample *samples,
+			    uint32_t nb_samples, uint32_t *nb_read);
+
 /*! Converts 24-bit raw data to volts. */
 float ad7193_convert_to_volts(struct ad7193_dev *dev,
 			      uint32_t raw_data,
@@ -376,49 +376,58 @@ int32_t ad7616_set_oversampling_ratio(struct ad7616_dev *dev,
 }
 
 /**
- * @brief Read from device in serial mode.
- *        Enter register mode to read/write registers
+ * @brief Capture samples with the DMAC set up by ad7616_setup().
  * @param dev - ad7616_dev device handler.
  * @param buf - data buffer.
  * @param samples - sample number.
  * @return \ref SUCCESS in case of success, \ref FAILURE otherwise.
  */
-int32_t ad7616_read_data_serial(struct ad7616_dev *dev,
-				uint32_t *buf,
-				uint32_t samples)
+static int32_t ad7616_capture(struct ad7616_dev *dev,
+			      uint32_t *buf,
+			      uint32_t samples)
 {
 	int32_t ret;
-	uint32_t commands_data[1] = {0x00};
-	struct spi_engine_offload_message msg;
-	uint32_t spi_eng_msg_cmds[3] = {
-		CS_LOW,
-		READ(2),
-		CS_HIGH,
-	};
 
-	dev->spi_desc->mode = SPI_MODE_3;
-	spi_engine_set_speed(dev->spi_desc, dev->spi_desc->max_speed_hz);
+	axi_io_write(dev->core_baseaddr, AD7616_REG_UP_CTRL,
+		     AD7616_CTRL_RESETN | AD7616_CTRL_CNVST_EN);
+
+	ret = axi_dmac_transfer(dev->dmac, (uint32_t)buf,
+				samples * AD7616_SAMPLE_BYTES);
+
+	axi_io_write(dev->core_baseaddr, AD7616_REG_UP_CTRL, AD7616_CTRL_RESETN);
 
-	ret = spi_engine_offload_init(dev->spi_desc, dev->offload_init_param);
 	if (ret != SUCCESS)
 		return ret;
 
-	msg.commands_data = commands_data;
-	msg.commands = spi_eng_msg_cmds;
-	msg.no_commands = ARRAY_SIZE(spi_eng_msg_cmds);
-	msg.rx_addr = (uint32_t)buf;
+	if (dev->dcache_invalidate_range)
+		dev->dcache_invalidate_range((uint32_t)buf,
+					     samples * AD7616_SAMPLE_BYTES);
 
-	axi_io_write(dev->core_baseaddr, AD7616_REG_UP_CTRL,
-		     AD7616_CTRL_RESETN | AD7616_CTRL_CNVST_EN);
+	return SUCCESS;
+}
 
-	ret = spi_engine_offload_transfer(dev->spi_desc, msg, samples);
+/**
+ * @brief Read from device in serial mode.
+ *        Enter register mode to read/write registers
+ * @param dev - ad7616_dev device handler.
+ * @param buf - data buffer.
+ * @param samples - sample number.
+ * @return \ref SUCCESS in case of success, \ref FAILURE otherwise.
+ */
+int32_t ad7616_read_data_serial(struct ad7616_dev *dev,
+				uint32_t *buf,
+				uint32_t samples)
+{
+	int32_t ret;
+
+	/* The offload program was loaded by ad7616_setup() */
+	ret = spi_engine_offload_enable(dev->spi_desc, true);
 	if (ret != SUCCESS)
 		return ret;
 
-	axi_io_write(dev->core_baseaddr, AD7616_REG_UP_CTRL, AD7616_CTRL_RESETN);
+	ret = ad7616_capture(dev, buf, samples);
 
-	if (dev->dcache_invalidate_range)
-		dev->dcache_invalidate_range(msg.rx_addr, samples * 2);
+	spi_engine_offload_enable(dev->spi_desc, false);
 
 	return ret;
 }
@@ -435,27 +444,206 @@ int32_t ad7616_read_data_parallel(struct ad7616_dev *dev,
 				  uint32_t *buf,
 				  uint32_t samples)
 {
-	int32_t ret;
-	struct axi_dmac			*dmac;
-	struct axi_dmac_init	dmac_init;
+	return ad7616_capture(dev, buf, samples);
+}
 
-	dmac_init.name = "ADC DMAC";
-	dmac_init.base = dev->offload_init_param->rx_dma_baseaddr;
-	dmac_init.flags = 0;
-	dmac_init.direction = DMA_DEV_TO_MEM;
+/**
+ * @brief Start double buffered streaming.
+ *        Both buffers are queued on the DMAC, and each one is requeued by
+ *        ad7616_stream_poll() as soon as its block was handed to the
+ *        callback, so the conversions are not stopped between blocks.
+ *        The registers must not be accessed while streaming.
+ * @param dev - ad7616_dev device handler.
+ * @param param - The streaming parameters.
+ * @return \ref SUCCESS in case of success, \ref FAILURE otherwise.
+ */
+int32_t ad7616_stream_start(struct ad7616_dev *dev,
+			    const struct ad7616_stream_param *param)
+{
+	uint32_t bytes;
+	int32_t ret;
+	uint8_t i;
 
-	axi_dmac_init(&dmac, &dmac_init);
-	if(!dmac)
+	if (!dev || !param || dev->streaming || !param->buf[0] ||
+	    !param->buf[1] || !param->block_samples || !param->block_ready)
 		return FAILURE;
 
+	dev->stream_buf[0] = param->buf[0];
+	dev->stream_buf[1] = param->buf[1];
+	dev->stream_samples = param->block_samples;
+	dev->stream_cb = param->block_ready;
+	dev->stream_ctx = param->ctx;
+	dev->stream_next = 0;
+	dev->stream_overruns = 0;
+
+	/* One shot per block, the buffers are requeued by ad7616_stream_poll() */
+	dev->stream_dma_flags = dev->dmac->flags;
+	dev->dmac->flags = 0;
+	axi_dmac_reset(dev->dmac);
+
+	bytes = dev->stream_samples * AD7616_SAMPLE_BYTES;
+	for (i = 0; i < 2; i++) {
+		ret = axi_dmac_transfer_start(dev->dmac,
+					      (uint32_t)dev->stream_buf[i],
+					      bytes, &dev->stream_id[i]);
+		if (ret != SUCCESS)
+			goto error;
+	}
+
+	if (dev->interface == AD7616_SERIAL) {
+		ret = spi_engine_offload_enable(dev->spi_desc, true);
+		if (ret != SUCCESS)
+			goto error;
+	}
+
 	axi_io_write(dev->core_baseaddr, AD7616_REG_UP_CTRL,
 		     AD7616_CTRL_RESETN | AD7616_CTRL_CNVST_EN);
 
-	ret = axi_dmac_transfer(dmac, (uint32_t)&buf, samples);
+	dev->streaming = true;
+
+	return SUCCESS;
+
+error:
+	axi_dmac_reset(dev->dmac);
+	dev->dmac->flags = dev->stream_dma_flags;
+
+	return ret;
+}
+
+/**
+ * @brief Hand the completed blocks to the callback and requeue their buffers.
+ *        A block that completes while the other one is already waiting
+ *        means the DMAC ran out of buffers and is counted as an overrun.
+ * @param dev - ad7616_dev device handler.
+ * @return The number of blocks handed to the callback, negative error code
+ *         otherwise.
+ */
+int32_t ad7616_stream_poll(struct ad7616_dev *dev)
+{
+	uint32_t *buf;
+	uint32_t bytes;
+	int32_t ret;
+	int32_t blocks = 0;
+	bool done;
+	uint8_t cur;
+
+	if (!dev || !dev->streaming)
+		return FAILURE;
+
+	bytes = dev->stream_samples * AD7616_SAMPLE_BYTES;
+
+	/* At most one pass over both buffers per call */
+	while (blocks < 2) {
+		cur = dev->stream_next;
+		ret = axi_dmac_transfer_done(dev->dmac, dev->stream_id[cur], &done);
+		if (ret != SUCCESS)
+			return ret;
+		if (!done)
+			break;
+
+		ret = axi_dmac_transfer_done(dev->dmac, dev->stream_id[cur ^ 1],
+					     &done);
+		if (ret != SUCCESS)
+			return ret;
+		if (done)
+			dev->stream_overruns++;
+
+		buf = dev->stream_buf[cur];
+		if (dev->dcache_invalidate_range)
+			dev->dcache_invalidate_range((uint32_t)buf, bytes);
+
+		dev->stream_cb(dev->stream_ctx, buf, dev->stream_samples);
+
+		ret = axi_dmac_transfer_start(dev->dmac, (uint32_t)buf, bytes,
+					      &dev->stream_id[cur]);
+		if (ret != SUCCESS)
+			return ret;
+
+		dev->stream_next = cur ^ 1;
+		blocks++;
+	}
+
+	return blocks;
+}
+
+/**
+ * @brief Stop streaming. The block being captured is dropped.
+ * @param dev - ad7616_dev device handler.
+ * @return \ref SUCCESS in case of success, \ref FAILURE otherwise.
+ */
+int32_t ad7616_stream_stop(struct ad7616_dev *dev)
+{
+	if (!dev || !dev->streaming)
+		return FAILURE;
+
+	axi_io_write(dev->core_baseaddr, AD7616_REG_UP_CTRL, AD7616_CTRL_RESETN);
+
+	if (dev->interface == AD7616_SERIAL)
+		spi_engine_offload_enable(dev->spi_desc, false);
+
+	axi_dmac_reset(dev->dmac);
+	dev->dmac->flags = dev->stream_dma_flags;
+	dev->streaming = false;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set up the capture path once for the lifetime of the device.
+ *        In serial mode the offload program is loaded and the SPI Engine's
+ *        RX DMAC is used, in parallel mode a DMAC is allocated.
+ * @param dev - ad7616_dev device handler.
+ * @return \ref SUCCESS in case of success, \ref FAILURE otherwise.
+ */
+static int32_t ad7616_capture_setup(struct ad7616_dev *dev)
+{
+	struct axi_dmac_init dmac_init;
+	struct spi_engine_desc *eng_desc;
+	uint8_t mode;
+	int32_t ret;
+
+	if (dev->interface == AD7616_PARALLEL) {
+		dmac_init.name = "ADC DMAC";
+		dmac_init.base = dev->offload_init_param->rx_dma_baseaddr;
+		dmac_init.flags = 0;
+		dmac_init.direction = DMA_DEV_TO_MEM;
+
+		return axi_dmac_init(&dev->dmac, &dmac_init);
+	}
+
+	ret = spi_engine_offload_init(dev->spi_desc, dev->offload_init_param);
 	if (ret != SUCCESS)
 		return ret;
 
-	axi_io_write(dev->core_baseaddr, AD7616_REG_UP_CTRL, AD7616_CTRL_RESETN);
+	dev->offload_cmds[0] = CS_LOW;
+	dev->offload_cmds[1] = READ(2);
+	dev->offload_cmds[2] = CS_HIGH;
+	dev->offload_data[0] = 0x00;
+	dev->offload_msg.commands = dev->offload_cmds;
+	dev->offload_msg.no_commands = ARRAY_SIZE(dev->offload_cmds);
+	dev->offload_msg.commands_data = dev->offload_data;
+	dev->offload_msg.tx_addr = 0;
+	dev->offload_msg.rx_addr = 0;
+
+	/* The conversions are read at full speed in mode 3, the register
+	 * accesses keep their own speed and mode */
+	mode = dev->spi_desc->mode;
+	dev->spi_desc->mode = SPI_MODE_3;
+	spi_engine_set_speed(dev->spi_desc, dev->spi_desc->max_speed_hz);
+
+	ret = spi_engine_offload_load(dev->spi_desc, dev->offload_msg);
+
+	dev->spi_desc->mode = mode;
+	spi_engine_set_speed(dev->spi_desc, dev->reg_access_speed);
+
+	if (ret != SUCCESS)
+		return ret;
+
+	eng_desc = dev->spi_desc->extra;
+	dev->dmac = eng_desc->offload_rx_dma;
+	/* The captures wait for their samples, unless cyclic DMA was asked for */
+	if (!dev->offload_init_param->dma_flags)
+		dev->dmac->flags = 0;
 
 	return SUCCESS;
 }
@@ -503,7 +691,7 @@ int32_t ad7616_setup(struct ad7616_dev **device,
 	uint8_t i;
 	int32_t ret = 0;
 
-	dev = (struct ad7616_dev *)malloc(sizeof(*dev));
+	dev = (struct ad7616_dev *)calloc(1, sizeof(*dev));
 	if (!dev) {
 		return FAILURE;
 	}
@@ -523,42 +711,43 @@ int32_t ad7616_setup(struct ad7616_dev **device,
 		return ret;
 	}
 
-	spi_engine_set_speed(dev->spi_desc, dev->reg_access_speed);
+	if (dev->interface == AD7616_SERIAL)
+		spi_engine_set_speed(dev->spi_desc, dev->reg_access_speed);
 
 	ret = gpio_get_optional(&dev->gpio_hw_rngsel0,
 				init_param->gpio_hw_rngsel0_param);
 	if (ret != SUCCESS)
-		return ret;
+		goto error;
 
 	ret = gpio_get_optional(&dev->gpio_hw_rngsel1,
 				init_param->gpio_hw_rngsel1_param);
 	if (ret != SUCCESS)
-		return ret;
+		goto error;
 
 	ret = gpio_get_optional(&dev->gpio_reset, init_param->gpio_reset_param);
 	if (ret != SUCCESS)
-		return ret;
+		goto error;
 
 	ret = gpio_get_optional(&dev->gpio_os0, init_param->gpio_os0_param);
 	if (ret != SUCCESS)
-		return ret;
+		goto error;
 
 	ret = gpio_get_optional(&dev->gpio_os1, init_param->gpio_os1_param);
 	if (ret != SUCCESS)
-		return ret;
+		goto error;
 
 	ret = gpio_get_optional(&dev->gpio_os2, init_param->gpio_os2_param);
 	if (ret != SUCCESS)
-		return ret;
+		goto error;
 
 	if (dev->gpio_reset) {
 		ret = gpio_direction_output(dev->gpio_reset, GPIO_HIGH);
 		if (ret != SUCCESS)
-			return ret;
+			goto error;
 
 		ret = ad7616_reset(dev);
 		if (ret != SUCCESS)
-			return ret;
+			goto error;
 	}
 
 	dev->mode = init_param->mode;
@@ -568,12 +757,16 @@ int32_t ad7616_setup(struct ad7616_dev **device,
 	}
 	ret = ad7616_set_mode(dev, dev->mode);
 	if (ret != SUCCESS)
-		return ret;
+		goto error;
 
 	dev->osr = init_param->osr;
 	ret = ad7616_set_oversampling_ratio(dev, dev->osr);
 	if (ret != SUCCESS)
-		return ret;
+		goto error;
+
+	ret = ad7616_capture_setup(dev);
+	if (ret != SUCCESS)
+		goto error;
 
 	*device = dev;
 
@@ -581,4 +774,38 @@ int32_t ad7616_setup(struct ad7616_dev **device,
 		printf("AD7616 successfully initialized\n");
 
 	return ret;
+
+error:
+	ad7616_remove(dev);
+
+	return ret;
+}
+
+/**
+ * Free the resources allocated by ad7616_setup().
+ * @param dev - The device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad7616_remove(struct ad7616_dev *dev)
+{
+	if (!dev)
+		return FAILURE;
+
+	if (dev->streaming)
+		ad7616_stream_stop(dev);
+
+	/* In serial mode the DMAC belongs to the SPI Engine */
+	if (dev->interface == AD7616_PARALLEL)
+		axi_dmac_remove(dev->dmac);
+	if (dev->spi_desc)
+		spi_remove(dev->spi_desc);
+	gpio_remove(dev->gpio_hw_rngsel0);
+	gpio_remove(dev->gpio_hw_rngsel1);
+	gpio_remove(dev->gpio_reset);
+	gpio_remove(dev->gpio_os0);
+	gpio_remove(dev->gpio_os1);
+	gpio_remove(dev->gpio_os2);
+	free(dev);
+
+	return SUCCESS;
 }
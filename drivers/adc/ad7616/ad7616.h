@@ -40,7 +40,10 @@
 #ifndef AD7616_H_
 #define AD7616_H_
 
+#include <stdbool.h>
 #include "gpio.h"
+#include "axi_dmac.h"
+#include "spi_engine.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -56,6 +59,9 @@
 #define AD7616_REG_UP_READ_DATA			0x44C
 #define AD7616_REG_UP_WRITE_DATA		0x450
 
+/* Bytes written to memory by the DMA for each sample */
+#define AD7616_SAMPLE_BYTES				2
+
 /* AD7616_REG_UP_CTRL */
 #define AD7616_CTRL_RESETN				(1 << 0)
 #define AD7616_CTRL_CNVST_EN			(1 << 1)
@@ -160,6 +166,32 @@ struct ad7616_dev {
 	enum ad7616_range		vb[8];
 	enum ad7616_osr			osr;
 	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
+	/* Capture, set up once in ad7616_setup() */
+	struct axi_dmac			*dmac;
+	struct spi_engine_offload_message	offload_msg;
+	uint32_t			offload_cmds[3];
+	/* One SDO word per word read, see spi_engine_transfer_message() */
+	uint32_t			offload_data[2];
+	/* Double buffered streaming */
+	bool				streaming;
+	uint32_t			*stream_buf[2];
+	uint32_t			stream_id[2];
+	uint8_t				stream_next;
+	uint32_t			stream_samples;
+	uint32_t			stream_dma_flags;
+	void (*stream_cb)(void *ctx, uint32_t *buf, uint32_t samples);
+	void				*stream_ctx;
+	uint32_t			stream_overruns;
+};
+
+/* Double buffered streaming parameters */
+struct ad7616_stream_param {
+	/* Two capture buffers of block_samples samples each */
+	uint32_t	*buf[2];
+	uint32_t	block_samples;
+	/* Called from ad7616_stream_poll() with each full block */
+	void (*block_ready)(void *ctx, uint32_t *buf, uint32_t samples);
+	void		*ctx;
 };
 
 struct ad7616_init_param {
@@ -246,4 +278,13 @@ int32_t ad7616_core_setup(struct ad7616_dev *dev);
 /* Initialize the device. */
 int32_t ad7616_setup(struct ad7616_dev **device,
 		     struct ad7616_init_param *init_param);
+/* Free the resources allocated by ad7616_setup(). */
+int32_t ad7616_remove(struct ad7616_dev *dev);
+/* Start double buffered streaming. */
+int32_t ad7616_stream_start(struct ad7616_dev *dev,
+			    const struct ad7616_stream_param *param);
+/* Hand the completed blocks to the callback and requeue their buffers. */
+int32_t ad7616_stream_poll(struct ad7616_dev *dev);
+/* Stop streaming. */
+int32_t ad7616_stream_stop(struct ad7616_dev *dev);
 #endif
@@ -47,6 +47,7 @@
 #include "ad77681.h"
 #include "error.h"
 #include "delay.h"
+#include "util.h"
 
 /******************************************************************************/
 /************************** Functions Implementation **************************/
@@ -91,12 +92,10 @@ uint8_t ad77681_compute_xor(uint8_t *data,
 			    uint8_t init_val)
 {
 	uint8_t crc = init_val;
-	uint8_t buf[3];
 	uint8_t i;
 
 	for (i = 0; i < data_size; i++) {
-		buf[i] = *data;
-		crc ^= buf[i];
+		crc ^= *data;
 		data++;
 	}
 	return crc;
@@ -231,7 +230,7 @@ uint8_t ad77681_get_rx_buf_len(struct ad77681_dev *dev)
 	uint8_t crc = 0;
 	uint8_t status_bit = 0;
 
-	data_len = 3;
+	data_len = (dev->conv_len == AD77681_CONV_24BIT) ? 3 : 2;
 	crc = (dev->crc_sel == AD77681_NO_CRC) ? 0 : 1; // 1 byte for crc
 	status_bit = dev->status_bit; // one byte for status
 
@@ -1756,7 +1755,7 @@ int32_t ad77681_setup(struct ad77681_dev **device,
 	int32_t ret;
 	uint8_t scratchpad_check = 0xAD;
 
-	dev = (struct ad77681_dev *)malloc(sizeof(*dev));
+	dev = (struct ad77681_dev *)calloc(1, sizeof(*dev));
 	if (!dev) {
 		return -1;
 	}
@@ -1840,3 +1839,354 @@ int32_t ad77681_setup(struct ad77681_dev **device,
 
 	return ret;
 }
+
+/**
+ * DRDY interrupt handler. Clocks one conversion frame out of the device,
+ * which is in continuous read mode, and appends it to the ring buffer.
+ * @param ctx - The device structure.
+ * @param event - Unused.
+ * @param extra - Unused.
+ */
+static void ad77681_drdy_irq_handler(void *ctx, uint32_t event, void *extra)
+{
+	struct ad77681_dev *dev = ctx;
+	uint8_t frame[AD77681_MAX_FRAME_BYTES] = { 0 };
+	uint32_t size;
+
+	if (spi_write_and_read(dev->spi_desc, frame, dev->frame_bytes) < 0)
+		return;
+
+	cb_write(dev->stream_cb, frame, dev->frame_bytes);
+	if (cb_size(dev->stream_cb, &size) == -EOVERRUN)
+		dev->stream_overruns++;
+}
+
+/**
+ * Start streaming conversions in continuous read mode.
+ * When an offload is given, the SPI Engine reads one frame per DRDY pulse
+ * and the DMA stores it at param->rx_addr, one 32-bit word per frame, so the
+ * frame must fit in 32 bits. Otherwise the DRDY interrupt reads every frame
+ * into a ring buffer of param->buf_frames frames.
+ * @param dev - The device structure.
+ * @param param - The streaming parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_stream_start(struct ad77681_dev *dev,
+			     const struct ad77681_stream_param *param)
+{
+	struct callback_desc cb;
+	int32_t ret;
+
+	if (!dev || !param || dev->streaming)
+		return -EINVAL;
+
+	dev->frame_bytes = ad77681_get_rx_buf_len(dev);
+	dev->stream_overruns = 0;
+	dev->crc_errors = 0;
+
+	if (param->offload_init) {
+		if (dev->frame_bytes > sizeof(uint32_t))
+			return -EINVAL;
+
+		ret = spi_engine_offload_init(dev->spi_desc, param->offload_init);
+		if (ret < 0)
+			return ret;
+
+		ret = spi_engine_set_transfer_width(dev->spi_desc,
+						    dev->frame_bytes * 8);
+		if (ret < 0)
+			return ret;
+
+		/* No address phase in continuous read, clock out the frame */
+		dev->offload_cmds[0] = CS_LOW;
+		dev->offload_cmds[1] = WRITE_READ(1);
+		dev->offload_cmds[2] = CS_HIGH;
+		dev->offload_data[0] = 0;
+		dev->offload_msg.commands = dev->offload_cmds;
+		dev->offload_msg.no_commands = ARRAY_SIZE(dev->offload_cmds);
+		dev->offload_msg.commands_data = dev->offload_data;
+		dev->offload_msg.rx_addr = param->rx_addr;
+		dev->offload_msg.tx_addr = 0;
+		dev->dcache_invalidate_range = param->dcache_invalidate_range;
+	} else {
+		if (!param->irq_ctrl || !param->buf_frames)
+			return -EINVAL;
+
+		ret = cb_init(&dev->stream_cb,
+			      param->buf_frames * dev->frame_bytes);
+		if (ret < 0)
+			return ret;
+
+		dev->irq_ctrl = param->irq_ctrl;
+		dev->irq_id = param->irq_id;
+	}
+
+	ret = ad77681_set_continuos_read(dev, AD77681_CONTINUOUS_READ_ENABLE);
+	if (ret < 0)
+		goto error_cb;
+
+	if (dev->stream_cb) {
+		cb.callback = ad77681_drdy_irq_handler;
+		cb.ctx = dev;
+		cb.config = param->irq_config;
+		ret = irq_register_callback(dev->irq_ctrl, dev->irq_id, &cb);
+		if (ret < 0)
+			goto error_cont_read;
+
+		ret = irq_enable(dev->irq_ctrl, dev->irq_id);
+		if (ret < 0) {
+			irq_unregister(dev->irq_ctrl, dev->irq_id);
+			goto error_cont_read;
+		}
+	}
+
+	dev->streaming = true;
+
+	return 0;
+
+error_cont_read:
+	ad77681_set_continuos_read(dev, AD77681_CONTINUOUS_READ_DISABLE);
+error_cb:
+	if (dev->stream_cb) {
+		cb_remove(dev->stream_cb);
+		dev->stream_cb = NULL;
+	}
+
+	return ret;
+}
+
+/**
+ * Stop streaming and leave continuous read mode.
+ * @param dev - The device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_stream_stop(struct ad77681_dev *dev)
+{
+	int32_t ret;
+
+	if (!dev || !dev->streaming)
+		return -EINVAL;
+
+	if (dev->stream_cb) {
+		ret = irq_disable(dev->irq_ctrl, dev->irq_id);
+		if (ret < 0)
+			return ret;
+
+		ret = irq_unregister(dev->irq_ctrl, dev->irq_id);
+		if (ret < 0)
+			return ret;
+
+		cb_remove(dev->stream_cb);
+		dev->stream_cb = NULL;
+	}
+
+	dev->streaming = false;
+
+	return ad77681_set_continuos_read(dev, AD77681_CONTINUOUS_READ_DISABLE);
+}
+
+/**
+ * Capture a block of frames with the offload, in a single DMA transfer.
+ * @param dev - The device structure.
+ * @param nb_frames - Number of frames to capture.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad77681_offload_capture(struct ad77681_dev *dev,
+				       uint32_t nb_frames)
+{
+	int32_t ret;
+
+	ret = spi_engine_offload_transfer(dev->spi_desc, dev->offload_msg,
+					  nb_frames);
+	if (ret < 0)
+		return ret;
+
+	if (dev->dcache_invalidate_range)
+		dev->dcache_invalidate_range(dev->offload_msg.rx_addr,
+					     nb_frames * sizeof(uint32_t));
+
+	return 0;
+}
+
+/**
+ * Unpack captured offload words into raw frames, MSB first.
+ * @param dev - The device structure.
+ * @param first - Index of the first frame in the DMA buffer.
+ * @param nb_frames - Number of frames to unpack.
+ * @param frames - Destination, nb_frames * dev->frame_bytes bytes.
+ */
+static void ad77681_offload_unpack(struct ad77681_dev *dev,
+				   uint32_t first,
+				   uint32_t nb_frames,
+				   uint8_t *frames)
+{
+	uint32_t *words = (uint32_t *)(uintptr_t)dev->offload_msg.rx_addr + first;
+	uint32_t i;
+	uint8_t j, shift;
+
+	for (i = 0; i < nb_frames; i++) {
+		shift = dev->frame_bytes * 8;
+		for (j = 0; j < dev->frame_bytes; j++) {
+			shift -= 8;
+			*frames++ = words[i] >> shift;
+		}
+	}
+}
+
+/**
+ * Read a block of raw conversion frames, ad77681_get_rx_buf_len() bytes each,
+ * as they were clocked out of the device.
+ * With the offload, a single DMA transfer captures the whole block.
+ * Otherwise the frames are taken from the interrupt ring buffer, waiting for
+ * at most twice the time the device needs to convert them.
+ * @param dev - The device structure.
+ * @param frames - Destination, nb_frames * ad77681_get_rx_buf_len() bytes.
+ * @param nb_frames - Number of frames to read.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_stream_read(struct ad77681_dev *dev,
+			    uint8_t *frames,
+			    uint32_t nb_frames)
+{
+	uint32_t size, timeout_ms;
+	int32_t ret;
+
+	if (!dev || !frames || !dev->streaming)
+		return -EINVAL;
+
+	if (!dev->stream_cb) {
+		ret = ad77681_offload_capture(dev, nb_frames);
+		if (ret < 0)
+			return ret;
+
+		ad77681_offload_unpack(dev, 0, nb_frames, frames);
+
+		return 0;
+	}
+
+	timeout_ms = 2 * (uint32_t)(((uint64_t)nb_frames * 1000) /
+				    (dev->sample_rate ? dev->sample_rate : 1)) + 1;
+	do {
+		ret = cb_size(dev->stream_cb, &size);
+		if (ret < 0 && ret != -EOVERRUN)
+			return ret;
+		if (size >= nb_frames * dev->frame_bytes)
+			return cb_read(dev->stream_cb, frames,
+				       nb_frames * dev->frame_bytes);
+		mdelay(1);
+	} while (timeout_ms--);
+
+	return -ETIMEDOUT;
+}
+
+/**
+ * Verify the checksum of a block of raw frames in one pass.
+ * In continuous read mode the CRC8 and the XOR checksum are seeded with
+ * INITIAL_CRC_CRC8 and INITIAL_CRC_XOR and cover the data and status bytes.
+ * @param dev - The device structure.
+ * @param frames - Raw frames returned by ad77681_stream_read().
+ * @param nb_frames - Number of frames.
+ * @param errors - Number of frames with a bad checksum, may be NULL.
+ * @return 0 if every checksum matches, FAILURE otherwise.
+ */
+int32_t ad77681_block_crc_check(struct ad77681_dev *dev,
+				uint8_t *frames,
+				uint32_t nb_frames,
+				uint32_t *errors)
+{
+	uint8_t len, checksum;
+	uint32_t i, bad = 0;
+
+	if (errors)
+		*errors = 0;
+
+	if (dev->crc_sel == AD77681_NO_CRC)
+		return 0;
+
+	len = dev->frame_bytes - 1;
+	for (i = 0; i < nb_frames; i++, frames += dev->frame_bytes) {
+		if (dev->crc_sel == AD77681_CRC)
+			checksum = ad77681_compute_crc8(frames, len,
+							INITIAL_CRC_CRC8);
+		else
+			checksum = ad77681_compute_xor(frames, len,
+						       INITIAL_CRC_XOR);
+		if (checksum != frames[len])
+			bad++;
+	}
+
+	dev->crc_errors += bad;
+	if (errors)
+		*errors = bad;
+
+	return bad ? FAILURE : 0;
+}
+
+/**
+ * Extract the sign extended conversion results from a block of raw frames.
+ * @param dev - The device structure.
+ * @param frames - Raw frames returned by ad77681_stream_read().
+ * @param samples - Destination of nb_frames conversion results.
+ * @param nb_frames - Number of frames.
+ */
+void ad77681_frames_to_samples(struct ad77681_dev *dev,
+			       uint8_t *frames,
+			       int32_t *samples,
+			       uint32_t nb_frames)
+{
+	uint32_t i;
+
+	for (i = 0; i < nb_frames; i++, frames += dev->frame_bytes) {
+		if (dev->conv_len == AD77681_CONV_24BIT)
+			samples[i] = (int32_t)(((uint32_t)frames[0] << 24) |
+					       ((uint32_t)frames[1] << 16) |
+					       ((uint32_t)frames[2] << 8)) >> 8;
+		else
+			samples[i] = (int16_t)((frames[0] << 8) | frames[1]);
+	}
+}
+
+/**
+ * Read a block of conversion results, checking the checksums on the way.
+ * Frames with a bad checksum are still returned and are counted in
+ * dev->crc_errors.
+ * @param dev - The device structure.
+ * @param samples - Destination of nb_samples conversion results.
+ * @param nb_samples - Number of samples to read.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_stream_read_samples(struct ad77681_dev *dev,
+				    int32_t *samples,
+				    uint32_t nb_samples)
+{
+	uint8_t frames[AD77681_STREAM_CHUNK * AD77681_MAX_FRAME_BYTES];
+	uint32_t n, done = 0;
+	int32_t ret;
+
+	if (!dev || !samples || !dev->streaming)
+		return -EINVAL;
+
+	/* The offload captures the whole block in one DMA transfer */
+	if (!dev->stream_cb) {
+		ret = ad77681_offload_capture(dev, nb_samples);
+		if (ret < 0)
+			return ret;
+	}
+
+	while (done < nb_samples) {
+		n = min(nb_samples - done, (uint32_t)AD77681_STREAM_CHUNK);
+		if (dev->stream_cb) {
+			ret = ad77681_stream_read(dev, frames, n);
+			if (ret < 0)
+				return ret;
+		} else {
+			ad77681_offload_unpack(dev, done, n, frames);
+		}
+
+		ad77681_block_crc_check(dev, frames, n, NULL);
+		ad77681_frames_to_samples(dev, frames, samples + done, n);
+		done += n;
+	}
+
+	return 0;
+}
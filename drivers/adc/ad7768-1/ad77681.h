@@ -41,6 +41,8 @@
 #define SRC_AD77681_H_
 
 #include "spi_engine.h"
+#include "irq.h"
+#include "circular_buffer.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -329,6 +331,10 @@
 #define INITIAL_CRC_CRC8						0x03
 #define INITIAL_CRC_XOR							0x6C
 #define INITIAL_CRC								0x00
+/* 24-bit data + status byte + CRC byte */
+#define AD77681_MAX_FRAME_BYTES					5
+/* Frames handled per pass by ad77681_stream_read_samples() */
+#define AD77681_STREAM_CHUNK					64
 
 #define CRC_DEBUG
 
@@ -521,6 +527,23 @@ struct ad77681_status_registers {
 	bool							fuse_crc_error;
 };
 
+/* Continuous read streaming parameters */
+struct ad77681_stream_param {
+	/* SPI Engine offload, DRDY triggered. Set to NULL to stream from the
+	 * DRDY interrupt instead */
+	struct spi_engine_offload_init_param	*offload_init;
+	/* DMA destination of the offload, one 32-bit word per frame */
+	uint32_t				rx_addr;
+	/* Invalidate the data cache for the given address range */
+	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
+	/* DRDY interrupt, used when no offload is available */
+	struct irq_ctrl_desc			*irq_ctrl;
+	uint32_t				irq_id;
+	void					*irq_config;
+	/* Capacity of the interrupt ring buffer, in frames */
+	uint32_t				buf_frames;
+};
+
 struct ad77681_dev {
 	/* SPI */
 	spi_desc			*spi_desc;
@@ -545,6 +568,18 @@ struct ad77681_dev {
 	uint16_t                        mclk;               /* Mater clock*/
 	uint32_t                        sample_rate;        /* Sample rate*/
 	uint8_t                         data_frame_16bit;   /* SPI 16bit frames*/
+	/* Continuous read streaming */
+	bool				streaming;
+	uint8_t				frame_bytes;
+	struct spi_engine_offload_message	offload_msg;
+	uint32_t			offload_cmds[3];
+	uint32_t			offload_data[1];
+	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
+	struct irq_ctrl_desc		*irq_ctrl;
+	uint32_t			irq_id;
+	struct circular_buffer		*stream_cb;
+	uint32_t			stream_overruns;
+	uint32_t			crc_errors;
 };
 
 struct ad77681_init_param {
@@ -673,4 +708,22 @@ int32_t ad77681_SINC3_ODR(struct ad77681_dev *dev,
 			  float sinc3_odr);
 int32_t ad77681_status(struct ad77681_dev *dev,
 		       struct ad77681_status_registers *status);
+uint8_t ad77681_get_rx_buf_len(struct ad77681_dev *dev);
+int32_t ad77681_stream_start(struct ad77681_dev *dev,
+			     const struct ad77681_stream_param *param);
+int32_t ad77681_stream_stop(struct ad77681_dev *dev);
+int32_t ad77681_stream_read(struct ad77681_dev *dev,
+			    uint8_t *frames,
+			    uint32_t nb_frames);
+int32_t ad77681_block_crc_check(struct ad77681_dev *dev,
+				uint8_t *frames,
+				uint32_t nb_frames,
+				uint32_t *errors);
+void ad77681_frames_to_samples(struct ad77681_dev *dev,
+			       uint8_t *frames,
+			       int32_t *samples,
+			       uint32_t nb_frames);
+int32_t ad77681_stream_read_samples(struct ad77681_dev *dev,
+				    int32_t *samples,
+				    uint32_t nb_samples);
 #endif /* SRC_AD77681_H_ */
@@ -43,6 +43,15 @@
 #include <stdlib.h>
 #include "ad7780.h"
 
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+/* The AD7780 has no serial input, it only shifts out the results. */
+static const struct ad_sd_info ad7780_sd_info = {
+	.status_rdy = AD7780_STAT_RDY,
+	.read_only = true,
+};
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
@@ -65,6 +74,7 @@ int8_t ad7780_init(struct ad7780_dev **device,
 		   struct ad7780_init_param init_param)
 {
 	struct ad7780_dev *dev;
+	struct ad_sd_init_param sd_init = init_param.sd_init;
 	uint8_t ad7780status;
 	int8_t init_status;
 
@@ -73,13 +83,9 @@ int8_t ad7780_init(struct ad7780_dev **device,
 		return -1;
 
 	init_status = gpio_get(&dev->gpio_pdrst, &init_param.gpio_pdrst);
-	init_status = gpio_get(&dev->gpio_miso, &init_param.gpio_miso);
 	init_status = gpio_get(&dev->gpio_filter, &init_param.gpio_filter);
 	init_status = gpio_get(&dev->gpio_gain, &init_param.gpio_gain);
 
-	if (dev->gpio_miso)
-		init_status = gpio_direction_input(dev->gpio_miso);
-
 	/* Set PDRST, FILTER and GAIN pins as output. */
 	AD7780_PDRST_PIN_OUT;
 	AD7780_FILTER_PIN_OUT;
@@ -95,6 +101,17 @@ int8_t ad7780_init(struct ad7780_dev **device,
 	if(init_status != 0) {
 		return -1;
 	}
+	/* The DOUT/RDY GPIO is handled by the sigma-delta layer. */
+	sd_init.spi_desc = dev->spi_desc;
+	sd_init.info = &ad7780_sd_info;
+	sd_init.priv = dev;
+	sd_init.gpio_rdy = &init_param.gpio_miso;
+	init_status = ad_sd_init(&dev->sd, &sd_init);
+	if(init_status != 0) {
+		return -1;
+	}
+	/* 24-bit result followed by the status byte */
+	ad_sd_set_data_format(dev->sd, 3, true);
 	AD7780_PDRST_HIGH;
 	init_status = ad7780_wait_rdy_go_low(dev);
 	if(init_status != 0) {
@@ -120,10 +137,10 @@ int32_t ad7780_remove(struct ad7780_dev *dev)
 {
 	int32_t ret;
 
-	ret = spi_remove(dev->spi_desc);
+	ret = ad_sd_remove(dev->sd);
+	ret |= spi_remove(dev->spi_desc);
 
 	ret |= gpio_remove(dev->gpio_pdrst);
-	ret |= gpio_remove(dev->gpio_miso);
 	ret |= gpio_remove(dev->gpio_filter);
 	ret |= gpio_remove(dev->gpio_gain);
 
@@ -133,7 +150,7 @@ int32_t ad7780_remove(struct ad7780_dev *dev)
 }
 
 /***************************************************************************//**
- * @brief Waits for DOUT/RDY pin to go low.
+ * @brief Waits for DOUT/RDY pin to go low, for at most AD7780_TIMEOUT polls.
  *
  * @param dev - The device structure.
  *
@@ -143,14 +160,7 @@ int32_t ad7780_remove(struct ad7780_dev *dev)
 *******************************************************************************/
 int8_t ad7780_wait_rdy_go_low(struct ad7780_dev *dev)
 {
-	uint32_t timeout = 0xFFFFF;
-	uint8_t wait = 1;
-
-	while(wait && timeout) {
-		AD7780_RDY_STATE(wait);
-		timeout--;
-	}
-	if(timeout == 0) {
+	if(ad_sd_wait_for_rdy(dev->sd, AD7780_TIMEOUT) != 0) {
 		return -1;
 	} else {
 		return 0;
@@ -168,18 +178,56 @@ int8_t ad7780_wait_rdy_go_low(struct ad7780_dev *dev)
 int32_t ad7780_read_sample(struct ad7780_dev *dev,
 			   uint8_t* p_status)
 {
-	uint8_t rx_buff[4]  = {0, 0, 0, 0};
-	int32_t conv_sample = 0;
-
-	spi_write_and_read(dev->spi_desc,
-			   rx_buff,
-			   4);
-	conv_sample = ((int32_t)rx_buff[0] << 16) +
-		      ((int16_t)rx_buff[1] << 8) +
-		      rx_buff[2];
-	*p_status = rx_buff[3];
-
-	return conv_sample;
+	struct ad_sd_sample sample = {0};
+
+	ad_sd_read_data(dev->sd, &sample);
+	*p_status = sample.status;
+
+	return sample.value;
+}
+
+/***************************************************************************//**
+ * @brief Starts buffering the conversion results. Every result and its status
+ *        byte are read on the DOUT/RDY interrupt and buffered until
+ *        ad7780_read_samples() is called.
+ *
+ * @param dev - The device structure.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t ad7780_cont_read_start(struct ad7780_dev *dev)
+{
+	return ad_sd_cont_read_start(dev->sd);
+}
+
+/***************************************************************************//**
+ * @brief Stops buffering the conversion results.
+ *
+ * @param dev - The device structure.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t ad7780_cont_read_stop(struct ad7780_dev *dev)
+{
+	return ad_sd_cont_read_stop(dev->sd, AD7780_TIMEOUT);
+}
+
+/***************************************************************************//**
+ * @brief Reads the buffered conversion results.
+ *
+ * @param dev        - The device structure.
+ * @param samples    - The buffer for the samples.
+ * @param nb_samples - The maximum number of samples to be read.
+ * @param nb_read    - The number of samples read.
+ *
+ * @return 0 in case of success, -EOVERRUN if samples were lost, negative
+ *         error code otherwise.
+*******************************************************************************/
+int32_t ad7780_read_samples(struct ad7780_dev *dev,
+			    struct ad_sd_sample *samples,
+			    uint32_t nb_samples, uint32_t *nb_read)
+{
+	return ad_sd_cont_read_samples(dev->sd, samples, nb_samples, nb_read);
 }
 
 /***************************************************************************//**
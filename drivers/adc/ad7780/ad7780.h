@@ -45,14 +45,14 @@
 #include <stdint.h>
 #include "gpio.h"
 #include "spi.h"
+#include "ad_sigma_delta.h"
 
 /******************************************************************************/
 /************************** AD7780 Definitions ********************************/
 /******************************************************************************/
 
-/* DOUT/RDY pin */
-#define AD7780_RDY_STATE(value) gpio_get_value(dev->gpio_miso,             \
-		                &value)
+/* Number of DOUT/RDY polls before giving up on a conversion */
+#define AD7780_TIMEOUT          0xFFFFF
 
 /* PDRST pin */
 #define AD7780_PDRST_PIN_OUT    gpio_direction_output(dev->gpio_pdrst,     \
@@ -99,9 +99,10 @@ struct ad7780_dev {
 	spi_desc	*spi_desc;
 	/* GPIO */
 	struct gpio_desc	*gpio_pdrst;
-	struct gpio_desc	*gpio_miso;
 	struct gpio_desc	*gpio_filter;
 	struct gpio_desc	*gpio_gain;
+	/* Common sigma-delta layer, owns the DOUT/RDY GPIO */
+	struct ad_sd_dev	*sd;
 };
 
 struct ad7780_init_param {
@@ -112,6 +113,9 @@ struct ad7780_init_param {
 	struct gpio_init_param	gpio_miso;
 	struct gpio_init_param	gpio_filter;
 	struct gpio_init_param	gpio_gain;
+	/* DOUT/RDY interrupt, needed for continuous read. SPI, device and
+	 * DOUT/RDY GPIO (gpio_miso) are set by init */
+	struct ad_sd_init_param	sd_init;
 };
 
 /******************************************************************************/
@@ -133,6 +137,17 @@ int8_t ad7780_wait_rdy_go_low(struct ad7780_dev *dev);
 int32_t ad7780_read_sample(struct ad7780_dev *dev,
 			   uint8_t* p_status);
 
+/*! Starts buffering the conversion results. */
+int32_t ad7780_cont_read_start(struct ad7780_dev *dev);
+
+/*! Stops buffering the conversion results. */
+int32_t ad7780_cont_read_stop(struct ad7780_dev *dev);
+
+/*! Reads the buffered conversion results. */
+int32_t ad7780_read_samples(struct ad7780_dev *dev,
+			    struct ad_sd_sample *samples,
+			    uint32_t nb_samples, uint32_t *nb_read);
+
 /*! Converts the 24-bit raw value to volts. */
 float ad7780_convert_to_voltage(uint32_t raw_sample,
 				float v_ref,
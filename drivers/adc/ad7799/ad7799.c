@@ -71,6 +71,18 @@ static const uint8_t ad7799_reg_size[] = {
 	[AD7799_REG_FULLSCALE] = AD7799_REG_SIZE_3B
 };
 
+static const struct ad_sd_info ad7799_sd_info = {
+	.comm_read = AD7799_COMM_READ,
+	.comm_cont_read = AD7799_COMM_CREAD,
+	.addr_shift = 3,
+	.addr_mask = 0x7,
+	.status_reg = AD7799_REG_STAT,
+	.data_reg = AD7799_REG_DATA,
+	.status_rdy = AD7799_STAT_RDY,
+	.status_ch_mask = 0x7,
+	.reset_len = 4,
+};
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -86,25 +98,12 @@ int32_t ad7799_read(struct ad7799_dev *device, uint8_t reg_addr,
 		    uint32_t *reg_data)
 {
 	int32_t ret;
-	uint8_t i;
-	uint8_t buff[4];
-	uint8_t buff_size;
-
-	*reg_data = 0;
-
-	buff_size = device->reg_size[reg_addr];
-
-	buff[0] = AD7799_COMM_READ | AD7799_COMM_ADDR(reg_addr);
 
-	memset((buff + 1), 0, buff_size + 1);
-
-	ret = spi_write_and_read(device->spi_desc, buff, buff_size + 1);
+	ret = ad_sd_read_reg(device->sd, reg_addr, device->reg_size[reg_addr],
+			     reg_data);
 	if(ret)
 		return FAILURE;
 
-	for(i = 1; i < buff_size + 1 ; i++)
-		*reg_data = (*reg_data << 8) | buff[i];
-
 	return ret;
 }
 
@@ -119,17 +118,9 @@ int32_t ad7799_write(struct ad7799_dev *device, uint8_t reg_addr,
 		     uint32_t reg_data)
 {
 	int32_t ret;
-	uint8_t i;
-	uint8_t buff[4];
-	uint8_t buff_size;
-
-	buff_size = device->reg_size[reg_addr];
-	buff[0] = AD7799_COMM_WRITE | AD7799_COMM_ADDR(reg_addr);
 
-	for (i = 1; i < buff_size + 1 ; i++)
-		buff[i] = reg_data >> ((buff_size - i) * 8);
-
-	ret = spi_write_and_read(device->spi_desc, buff, buff_size + 1);
+	ret = ad_sd_write_reg(device->sd, reg_addr, device->reg_size[reg_addr],
+			      reg_data);
 	if(ret)
 		return FAILURE;
 
@@ -143,14 +134,7 @@ int32_t ad7799_write(struct ad7799_dev *device, uint8_t reg_addr,
  */
 int32_t ad7799_reset(struct ad7799_dev *device)
 {
-	uint8_t reset_data[4] = {
-		AD7799_RESET_DATA,
-		AD7799_RESET_DATA,
-		AD7799_RESET_DATA,
-		AD7799_RESET_DATA
-	};
-
-	return spi_write_and_read(device->spi_desc, reset_data, 4);
+	return ad_sd_reset(device->sd);
 }
 
 /**
@@ -330,21 +314,52 @@ int32_t ad7799_set_polarity(struct ad7799_dev *device, uint8_t polarity)
 int32_t ad7799_dev_ready(struct ad7799_dev *device)
 {
 	int32_t ret;
-	uint32_t data;
-	uint32_t timeout = AD7799_TIMEOUT;
 
-	while (timeout > 0) {
-		ret = ad7799_read(device, AD7799_REG_STAT, &data);
-		if (ret)
-			return FAILURE;
+	ret = ad_sd_wait_for_rdy(device->sd, AD7799_TIMEOUT);
+	if (ret)
+		return FAILURE;
 
-		if (!(data & AD7799_STAT_RDY))
-			return SUCCESS;
+	return SUCCESS;
+}
 
-		timeout--;
-	}
+/**
+ * @brief Enter the continuous read mode. The conversion results are read on
+ * the DOUT/RDY interrupt and buffered until ad7799_read_samples() is called.
+ * @param device - The device structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad7799_cont_read_start(struct ad7799_dev *device)
+{
+	ad_sd_set_data_format(device->sd, device->reg_size[AD7799_REG_DATA],
+			      false);
 
-	return FAILURE;
+	return ad_sd_cont_read_start(device->sd);
+}
+
+/**
+ * @brief Leave the continuous read mode.
+ * @param device - The device structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad7799_cont_read_stop(struct ad7799_dev *device)
+{
+	return ad_sd_cont_read_stop(device->sd, AD7799_TIMEOUT);
+}
+
+/**
+ * @brief Read the samples buffered in continuous read mode.
+ * @param device - The device structure.
+ * @param samples - The buffer for the samples.
+ * @param nb_samples - The maximum number of samples to be read.
+ * @param nb_read - The number of samples read.
+ * @return SUCCESS in case of success, -EOVERRUN if samples were lost,
+ * negative error code otherwise.
+ */
+int32_t ad7799_read_samples(struct ad7799_dev *device,
+			    struct ad_sd_sample *samples,
+			    uint32_t nb_samples, uint32_t *nb_read)
+{
+	return ad_sd_cont_read_samples(device->sd, samples, nb_samples, nb_read);
 }
 
 /**
@@ -358,6 +373,7 @@ int32_t ad7799_init(struct ad7799_dev **device,
 		    const struct ad7799_init_param *init_param)
 {
 	struct ad7799_dev *dev;
+	struct ad_sd_init_param sd_init = init_param->sd_init;
 	int32_t ret;
 	uint32_t chip_id = 0;
 
@@ -386,6 +402,16 @@ int32_t ad7799_init(struct ad7799_dev **device,
 		return FAILURE;
 	}
 
+	sd_init.spi_desc = dev->spi_desc;
+	sd_init.info = &ad7799_sd_info;
+	sd_init.priv = dev;
+	ret = ad_sd_init(&dev->sd, &sd_init);
+	if (ret) {
+		spi_remove(dev->spi_desc);
+		free(dev);
+		return FAILURE;
+	}
+
 	ret = ad7799_reset(dev);
 	if (ret)
 		return FAILURE;
@@ -437,6 +463,10 @@ int32_t ad7799_remove(struct ad7799_dev *device)
 {
 	int32_t ret;
 
+	ret = ad_sd_remove(device->sd);
+	if (ret)
+		return ret;
+
 	ret = spi_remove(device->spi_desc);
 	free(device);
 
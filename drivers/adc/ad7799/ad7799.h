@@ -44,6 +44,7 @@
 /******************************************************************************/
 #include <stdint.h>
 #include "spi.h"
+#include "ad_sigma_delta.h"
 
 /******************************************************************************/
 /********************** Macros and Types Declarations *************************/
@@ -166,6 +167,8 @@ struct ad7799_dev {
 	uint8_t chip_type;
 	/** Register size */
 	const uint8_t *reg_size;
+	/** Common sigma-delta layer */
+	struct ad_sd_dev *sd;
 };
 
 /**
@@ -177,6 +180,9 @@ struct ad7799_init_param {
 	struct spi_init_param spi_init;
 	/** Chip type (AD7798/AD7799) */
 	enum ad7799_type chip_type;
+	/** DOUT/RDY GPIO and interrupt, needed for continuous read. SPI and device
+	 * are set by init */
+	struct ad_sd_init_param sd_init;
 };
 
 /******************************************************************************/
@@ -219,6 +225,17 @@ int32_t ad7799_set_polarity(struct ad7799_dev *device, uint8_t polarity);
 /* Check the status of the device. */
 int32_t ad7799_dev_ready(struct ad7799_dev *device);
 
+/* Enter the continuous read mode. */
+int32_t ad7799_cont_read_start(struct ad7799_dev *device);
+
+/* Leave the continuous read mode. */
+int32_t ad7799_cont_read_stop(struct ad7799_dev *device);
+
+/* Read the samples buffered in continuous read mode. */
+int32_t ad7799_read_samples(struct ad7799_dev *device,
+			    struct ad_sd_sample *samples,
+			    uint32_t nb_samples, uint32_t *nb_read);
+
 /* Initialize the device. */
 int32_t ad7799_init(struct ad7799_dev **device,
 		    const struct ad7799_init_param *init_param);
@@ -0,0 +1,617 @@
+/***************************************************************************//**
+ *   @file   ad_sigma_delta.c
+ *   @brief  Implementation of the common sigma-delta ADC layer.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "ad_sigma_delta.h"
+#include "crc8.h"
+#include "error.h"
+#include "util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define AD_SD_CRC8_POLY		0x07 /* x8 + x2 + x + 1 */
+
+DECLARE_CRC8_TABLE(ad_sd_crc8_table);
+static bool ad_sd_crc8_ready;
+
+/******************************************************************************/
+/************************** Functions Implementation **************************/
+/******************************************************************************/
+
+/**
+ * @brief Build the communications register value for a read.
+ * @param sd - The sigma-delta descriptor.
+ * @param addr - The register address.
+ * @return The command byte.
+ */
+static uint8_t ad_sd_read_cmd(struct ad_sd_dev *sd, uint8_t addr)
+{
+	return sd->info->comm_read |
+	       ((addr & sd->info->addr_mask) << sd->info->addr_shift);
+}
+
+/**
+ * @brief Check the integrity of a read transfer.
+ * @param sd - The sigma-delta descriptor.
+ * @param buf - Command byte followed by the received bytes and the check byte.
+ * @param len - Length of the buffer.
+ * @return SUCCESS if the check passed, -EIO otherwise.
+ */
+static int32_t ad_sd_verify(struct ad_sd_dev *sd, const uint8_t *buf,
+			    uint8_t len)
+{
+	uint8_t check = 0;
+	uint8_t i;
+
+	switch (sd->check) {
+	case AD_SD_CHECK_CRC8:
+		check = crc8(ad_sd_crc8_table, buf, len, 0);
+		break;
+	case AD_SD_CHECK_XOR8:
+		for (i = 0; i < len; i++)
+			check ^= buf[i];
+		break;
+	default:
+		break;
+	}
+
+	return check ? -EIO : SUCCESS;
+}
+
+/**
+ * @brief Read raw bytes from a register and verify the check byte.
+ * @param sd - The sigma-delta descriptor.
+ * @param addr - The register address.
+ * @param data - The bytes read, MSB first, check byte excluded.
+ * @param size - Number of bytes to be read, check byte excluded.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad_sd_read(struct ad_sd_dev *sd, uint8_t addr, uint8_t *data,
+		   uint8_t size)
+{
+	uint8_t buf[AD_SD_MAX_XFER_SIZE] = {0};
+	uint8_t len;
+	int32_t ret;
+
+	if (!sd || !data)
+		return -EINVAL;
+
+	len = size + 1 + (sd->check != AD_SD_CHECK_NONE);
+	if (len > AD_SD_MAX_XFER_SIZE)
+		return -EINVAL;
+
+	buf[0] = ad_sd_read_cmd(sd, addr);
+	ret = spi_write_and_read(sd->spi_desc, buf, len);
+	if (ret != SUCCESS)
+		return ret;
+
+	/* The command byte was replaced by the received one. */
+	buf[0] = ad_sd_read_cmd(sd, addr);
+	ret = ad_sd_verify(sd, buf, len);
+	if (ret != SUCCESS)
+		return ret;
+
+	memcpy(data, &buf[1], size);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read a register.
+ * @param sd - The sigma-delta descriptor.
+ * @param addr - The register address.
+ * @param size - The register size in bytes.
+ * @param val - The register value.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad_sd_read_reg(struct ad_sd_dev *sd, uint8_t addr, uint8_t size,
+		       uint32_t *val)
+{
+	uint8_t buf[AD_SD_MAX_XFER_SIZE];
+	int32_t ret;
+	uint8_t i;
+
+	if (!val || size > sizeof(*val))
+		return -EINVAL;
+
+	ret = ad_sd_read(sd, addr, buf, size);
+	if (ret != SUCCESS)
+		return ret;
+
+	*val = 0;
+	for (i = 0; i < size; i++)
+		*val = (*val << 8) | buf[i];
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Write a register.
+ * @param sd - The sigma-delta descriptor.
+ * @param addr - The register address.
+ * @param size - The register size in bytes.
+ * @param val - The register value.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad_sd_write_reg(struct ad_sd_dev *sd, uint8_t addr, uint8_t size,
+			uint32_t val)
+{
+	uint8_t buf[AD_SD_MAX_XFER_SIZE];
+	uint8_t len;
+	uint8_t i;
+
+	if (!sd || size > sizeof(val))
+		return -EINVAL;
+
+	buf[0] = (addr & sd->info->addr_mask) << sd->info->addr_shift;
+	for (i = size; i > 0; i--) {
+		buf[i] = val & 0xFF;
+		val >>= 8;
+	}
+	len = size + 1;
+
+	/* Writes are protected by CRC8 in both check modes. */
+	if (sd->check != AD_SD_CHECK_NONE) {
+		buf[len] = crc8(ad_sd_crc8_table, buf, len, 0);
+		len++;
+	}
+
+	return spi_write_and_read(sd->spi_desc, buf, len);
+}
+
+/**
+ * @brief Reset the serial interface.
+ * @param sd - The sigma-delta descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad_sd_reset(struct ad_sd_dev *sd)
+{
+	uint8_t buf[AD_SD_MAX_XFER_SIZE];
+
+	if (!sd || sd->info->reset_len > AD_SD_MAX_XFER_SIZE)
+		return -EINVAL;
+
+	memset(buf, 0xFF, sd->info->reset_len);
+
+	return spi_write_and_read(sd->spi_desc, buf, sd->info->reset_len);
+}
+
+/**
+ * @brief Select the integrity check used on the SPI transfers.
+ * @param sd - The sigma-delta descriptor.
+ * @param check - The check, it must match the device configuration.
+ */
+void ad_sd_set_check(struct ad_sd_dev *sd, enum ad_sd_check check)
+{
+	sd->check = check;
+}
+
+/**
+ * @brief Set the format of the conversion results.
+ * @param sd - The sigma-delta descriptor.
+ * @param data_size - Size of the conversion result in bytes.
+ * @param append_status - Whether the status byte follows the result.
+ */
+void ad_sd_set_data_format(struct ad_sd_dev *sd, uint8_t data_size,
+			   bool append_status)
+{
+	sd->data_size = data_size;
+	sd->append_status = append_status;
+}
+
+/**
+ * @brief Wait for the end of a conversion.
+ *
+ * The DOUT/RDY line is polled when available, which costs a GPIO read per
+ * poll instead of a status register read over SPI.
+ * @param sd - The sigma-delta descriptor.
+ * @param timeout - Number of polls before giving up.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad_sd_wait_for_rdy(struct ad_sd_dev *sd, uint32_t timeout)
+{
+	uint8_t status;
+	uint8_t level;
+	int32_t ret;
+
+	if (!sd)
+		return -EINVAL;
+
+	while (timeout--) {
+		if (sd->gpio_rdy) {
+			ret = gpio_get_value(sd->gpio_rdy, &level);
+			if (ret != SUCCESS)
+				return ret;
+			if (level == GPIO_LOW)
+				return SUCCESS;
+		} else {
+			ret = ad_sd_read(sd, sd->info->status_reg, &status, 1);
+			if (ret != SUCCESS)
+				return ret;
+			if (!(status & sd->info->status_rdy))
+				return SUCCESS;
+		}
+	}
+
+	return -ETIMEDOUT;
+}
+
+/**
+ * @brief Decode a conversion result.
+ * @param sd - The sigma-delta descriptor.
+ * @param buf - Result bytes, MSB first, followed by the status byte if any.
+ * @param sample - The decoded sample.
+ */
+static void ad_sd_decode(struct ad_sd_dev *sd, const uint8_t *buf,
+			 struct ad_sd_sample *sample)
+{
+	uint8_t i;
+
+	sample->value = 0;
+	for (i = 0; i < sd->data_size; i++)
+		sample->value = (sample->value << 8) | buf[i];
+
+	if (sd->append_status) {
+		sample->status = buf[sd->data_size];
+		sample->channel = sample->status & sd->info->status_ch_mask;
+	} else {
+		sample->status = 0;
+		sample->channel = sd->channel;
+	}
+}
+
+/**
+ * @brief Read a conversion result.
+ * @param sd - The sigma-delta descriptor.
+ * @param sample - The conversion result.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad_sd_read_data(struct ad_sd_dev *sd, struct ad_sd_sample *sample)
+{
+	uint8_t buf[AD_SD_MAX_XFER_SIZE] = {0};
+	int32_t ret;
+
+	if (!sd || !sample)
+		return -EINVAL;
+
+	if (sd->info->read_only) {
+		/* The result is shifted out on its own, there's no command. */
+		ret = spi_write_and_read(sd->spi_desc, buf,
+					 sd->data_size + sd->append_status);
+	} else {
+		ret = ad_sd_read(sd, sd->info->data_reg, buf,
+				 sd->data_size + sd->append_status);
+	}
+	if (ret != SUCCESS)
+		return ret;
+
+	ad_sd_decode(sd, buf, sample);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief DOUT/RDY falling edge handler, reads one sample in continuous read
+ *        mode and pushes it to the sample buffer.
+ * @param ctx - The sigma-delta descriptor.
+ * @param event - Unused.
+ * @param extra - Unused.
+ */
+static void ad_sd_rdy_callback(void *ctx, uint32_t event, void *extra)
+{
+	struct ad_sd_dev *sd = ctx;
+	struct ad_sd_sample sample;
+	uint8_t buf[AD_SD_MAX_XFER_SIZE] = {0};
+	uint32_t used;
+	uint8_t len;
+
+	/* DOUT/RDY toggles while the result is shifted out. */
+	irq_disable(sd->irq_ctrl, sd->irq_id);
+
+	/*
+	 * No command is sent in continuous read mode, but the check byte is
+	 * computed as if the data register read command was.
+	 */
+	len = sd->data_size + sd->append_status +
+	      (sd->check != AD_SD_CHECK_NONE);
+	if (spi_write_and_read(sd->spi_desc, &buf[1], len) != SUCCESS)
+		goto out;
+
+	buf[0] = ad_sd_read_cmd(sd, sd->info->data_reg);
+	if (ad_sd_verify(sd, buf, len + 1) != SUCCESS) {
+		sd->check_errors++;
+		goto out;
+	}
+
+	ad_sd_decode(sd, &buf[1], &sample);
+
+	if (cb_size(sd->samples, &used) == -EOVERRUN ||
+	    used + sizeof(sample) > sd->buffer_samples * sizeof(sample))
+		sd->overruns++;
+	cb_write(sd->samples, &sample, sizeof(sample));
+
+out:
+	irq_enable(sd->irq_ctrl, sd->irq_id);
+}
+
+/**
+ * @brief Enter continuous read mode and start buffering the samples.
+ *
+ * Each DOUT/RDY falling edge triggers a single SPI read of the result and of
+ * the status byte, if enabled, so multi-channel sequences do not need any
+ * status register polling.
+ * The DOUT/RDY GPIO is required, ad_sd_cont_read_stop() needs it to find the
+ * end of a conversion.
+ * @param sd - The sigma-delta descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad_sd_cont_read_start(struct ad_sd_dev *sd)
+{
+	struct callback_desc cb = {
+		.callback = ad_sd_rdy_callback,
+		.ctx = sd,
+	};
+	uint8_t cmd;
+	int32_t ret;
+
+	if (!sd || !sd->irq_ctrl || !sd->gpio_rdy || !sd->data_size)
+		return -EINVAL;
+
+	if (sd->cont_read)
+		return SUCCESS;
+
+	if (!sd->samples) {
+		ret = cb_init(&sd->samples,
+			      sd->buffer_samples * sizeof(struct ad_sd_sample));
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	sd->overruns = 0;
+	sd->check_errors = 0;
+
+	cb.config = sd->irq_config;
+	ret = irq_register_callback(sd->irq_ctrl, sd->irq_id, &cb);
+	if (ret != SUCCESS)
+		return ret;
+
+	if (sd->info->read_only) {
+		ret = SUCCESS;
+	} else if (sd->info->set_cont_read) {
+		ret = sd->info->set_cont_read(sd->priv, true);
+	} else {
+		cmd = ad_sd_read_cmd(sd, sd->info->data_reg) |
+		      sd->info->comm_cont_read;
+		ret = spi_write_and_read(sd->spi_desc, &cmd, 1);
+	}
+	if (ret != SUCCESS)
+		goto error;
+
+	sd->cont_read = true;
+
+	ret = irq_enable(sd->irq_ctrl, sd->irq_id);
+	if (ret != SUCCESS)
+		goto error;
+
+	return SUCCESS;
+
+error:
+	sd->cont_read = false;
+	irq_unregister(sd->irq_ctrl, sd->irq_id);
+
+	return ret;
+}
+
+/**
+ * @brief Leave continuous read mode.
+ *
+ * The exit command is a data register read issued while DOUT/RDY is low.
+ * @param sd - The sigma-delta descriptor.
+ * @param timeout - Number of DOUT/RDY polls before giving up.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad_sd_cont_read_stop(struct ad_sd_dev *sd, uint32_t timeout)
+{
+	uint8_t buf[AD_SD_MAX_XFER_SIZE] = {0};
+	int32_t ret;
+
+	if (!sd)
+		return -EINVAL;
+
+	if (!sd->cont_read)
+		return SUCCESS;
+
+	irq_disable(sd->irq_ctrl, sd->irq_id);
+	irq_unregister(sd->irq_ctrl, sd->irq_id);
+
+	if (sd->info->read_only) {
+		sd->cont_read = false;
+		return SUCCESS;
+	}
+
+	/*
+	 * The status register cannot be read in continuous read mode, the
+	 * GPIO was checked by ad_sd_cont_read_start().
+	 */
+	ret = ad_sd_wait_for_rdy(sd, timeout);
+	if (ret != SUCCESS)
+		return ret;
+
+	buf[0] = ad_sd_read_cmd(sd, sd->info->data_reg);
+	ret = spi_write_and_read(sd->spi_desc, buf,
+				 1 + sd->data_size + sd->append_status +
+				 (sd->check != AD_SD_CHECK_NONE));
+	if (ret != SUCCESS)
+		return ret;
+
+	sd->cont_read = false;
+
+	if (sd->info->set_cont_read)
+		return sd->info->set_cont_read(sd->priv, false);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read the samples buffered in continuous read mode.
+ * @param sd - The sigma-delta descriptor.
+ * @param samples - Buffer for the samples.
+ * @param nb_samples - Maximum number of samples to be read.
+ * @param nb_read - Number of samples actually read, it does not block.
+ * @return SUCCESS in case of success, -EOVERRUN if samples were lost since
+ *         the last call, negative error code otherwise.
+ */
+int32_t ad_sd_cont_read_samples(struct ad_sd_dev *sd,
+				struct ad_sd_sample *samples, uint32_t nb_samples,
+				uint32_t *nb_read)
+{
+	uint32_t available;
+	int32_t ret;
+
+	if (!sd || !samples || !nb_read || !sd->samples)
+		return -EINVAL;
+
+	*nb_read = 0;
+
+	irq_disable(sd->irq_ctrl, sd->irq_id);
+	ret = cb_size(sd->samples, &available);
+	available /= sizeof(*samples);
+	nb_samples = min(nb_samples, available);
+	if (nb_samples)
+		cb_read(sd->samples, samples, nb_samples * sizeof(*samples));
+	if (sd->overruns) {
+		sd->overruns = 0;
+		ret = -EOVERRUN;
+	}
+	if (sd->cont_read)
+		irq_enable(sd->irq_ctrl, sd->irq_id);
+
+	*nb_read = nb_samples;
+
+	return ret;
+}
+
+/**
+ * @brief Initialize the sigma-delta layer.
+ * @param sd - The sigma-delta descriptor.
+ * @param init_param - The initialization parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad_sd_init(struct ad_sd_dev **sd,
+		   const struct ad_sd_init_param *init_param)
+{
+	struct ad_sd_dev *dev;
+	int32_t ret;
+
+	if (!sd || !init_param || !init_param->spi_desc || !init_param->info)
+		return -EINVAL;
+
+	if (init_param->info->read_only && !init_param->gpio_rdy)
+		return -EINVAL;
+
+	dev = (struct ad_sd_dev *)calloc(1, sizeof(*dev));
+	if (!dev)
+		return -ENOMEM;
+
+	if (!ad_sd_crc8_ready) {
+		crc8_populate_msb(ad_sd_crc8_table, AD_SD_CRC8_POLY);
+		ad_sd_crc8_ready = true;
+	}
+
+	dev->spi_desc = init_param->spi_desc;
+	dev->info = init_param->info;
+	dev->priv = init_param->priv;
+	dev->irq_ctrl = init_param->irq_ctrl;
+	dev->irq_id = init_param->irq_id;
+	dev->irq_config = init_param->irq_config;
+	dev->buffer_samples = init_param->buffer_samples ?
+			      init_param->buffer_samples : 64;
+	dev->channel = AD_SD_CHANNEL_UNKNOWN;
+
+	if (init_param->gpio_rdy) {
+		ret = gpio_get(&dev->gpio_rdy, init_param->gpio_rdy);
+		if (ret != SUCCESS)
+			goto error;
+
+		ret = gpio_direction_input(dev->gpio_rdy);
+		if (ret != SUCCESS)
+			goto error_gpio;
+	}
+
+	*sd = dev;
+
+	return SUCCESS;
+
+error_gpio:
+	gpio_remove(dev->gpio_rdy);
+error:
+	free(dev);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by ad_sd_init().
+ * @param sd - The sigma-delta descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad_sd_remove(struct ad_sd_dev *sd)
+{
+	if (!sd)
+		return -EINVAL;
+
+	if (sd->cont_read) {
+		irq_disable(sd->irq_ctrl, sd->irq_id);
+		irq_unregister(sd->irq_ctrl, sd->irq_id);
+	}
+
+	if (sd->samples)
+		cb_remove(sd->samples);
+
+	if (sd->gpio_rdy)
+		gpio_remove(sd->gpio_rdy);
+
+	free(sd);
+
+	return SUCCESS;
+}
@@ -0,0 +1,225 @@
+/***************************************************************************//**
+ *   @file   ad_sigma_delta.h
+ *   @brief  Header file of the common sigma-delta ADC layer.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef AD_SIGMA_DELTA_H_
+#define AD_SIGMA_DELTA_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "spi.h"
+#include "gpio.h"
+#include "irq.h"
+#include "circular_buffer.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/* Largest register, status byte and check byte included. */
+#define AD_SD_MAX_XFER_SIZE	8
+/* Channel reported for samples read without an appended status byte. */
+#define AD_SD_CHANNEL_UNKNOWN	0xFF
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+/**
+ * @enum ad_sd_check
+ * @brief Integrity check appended by the device to the SPI transfers.
+ */
+enum ad_sd_check {
+	/** No check byte */
+	AD_SD_CHECK_NONE,
+	/** CRC8 (x8 + x2 + x + 1) on reads and writes */
+	AD_SD_CHECK_CRC8,
+	/** XOR on reads, CRC8 on writes */
+	AD_SD_CHECK_XOR8,
+};
+
+/**
+ * @struct ad_sd_info
+ * @brief Description of the serial interface of a sigma-delta part.
+ */
+struct ad_sd_info {
+	/** Read bit of the communications register */
+	uint8_t comm_read;
+	/**
+	 * Continuous read bit of the communications register. Zero for parts
+	 * that enter continuous read through a register bit, set_cont_read is
+	 * used for them instead.
+	 */
+	uint8_t comm_cont_read;
+	/** Position of the register address in the communications register */
+	uint8_t addr_shift;
+	/** Mask of the register address, before shifting */
+	uint8_t addr_mask;
+	/** Address of the status register */
+	uint8_t status_reg;
+	/** Address of the data register */
+	uint8_t data_reg;
+	/** RDY bit of the status register, active low */
+	uint8_t status_rdy;
+	/** Mask of the active channel field of the status register */
+	uint8_t status_ch_mask;
+	/** Number of 0xFF bytes that reset the serial interface */
+	uint8_t reset_len;
+	/**
+	 * The part has no serial input (e.g. AD7780). The conversion results
+	 * are shifted out without a command, the part is always in continuous
+	 * read mode and it has no registers. It needs the DOUT/RDY GPIO.
+	 */
+	bool read_only;
+	/**
+	 * Optional, enable or disable the continuous read mode through the
+	 * device registers.
+	 */
+	int32_t (*set_cont_read)(void *priv, bool enable);
+};
+
+/**
+ * @struct ad_sd_sample
+ * @brief Conversion result.
+ */
+struct ad_sd_sample {
+	/** Raw conversion result */
+	uint32_t value;
+	/** Channel decoded from the status byte, AD_SD_CHANNEL_UNKNOWN if none */
+	uint8_t channel;
+	/** Status byte appended to the result, 0 if none */
+	uint8_t status;
+};
+
+/**
+ * @struct ad_sd_init_param
+ * @brief Sigma-delta layer initialization parameters.
+ */
+struct ad_sd_init_param {
+	/** SPI descriptor of the device, owned by the device driver */
+	struct spi_desc *spi_desc;
+	/** Serial interface description */
+	const struct ad_sd_info *info;
+	/** Device driver handle, passed to the info callbacks */
+	void *priv;
+	/**
+	 * DOUT/RDY line read as a GPIO. The line is only driven while the
+	 * device is selected, so it can be used when the chip select is kept
+	 * asserted (e.g. tied low). Optional for single conversions, but
+	 * required for continuous read: the status register can't be read in
+	 * that mode and the exit command must be sent while DOUT/RDY is low.
+	 */
+	struct gpio_init_param *gpio_rdy;
+	/** Optional, interrupt controller handling the DOUT/RDY falling edge */
+	struct irq_ctrl_desc *irq_ctrl;
+	/** DOUT/RDY interrupt ID */
+	uint32_t irq_id;
+	/** Platform specific DOUT/RDY interrupt configuration */
+	void *irq_config;
+	/** Number of samples buffered in continuous read mode */
+	uint32_t buffer_samples;
+};
+
+/**
+ * @struct ad_sd_dev
+ * @brief Sigma-delta layer descriptor.
+ */
+struct ad_sd_dev {
+	struct spi_desc *spi_desc;
+	const struct ad_sd_info *info;
+	void *priv;
+	struct gpio_desc *gpio_rdy;
+	struct irq_ctrl_desc *irq_ctrl;
+	uint32_t irq_id;
+	void *irq_config;
+	/** Samples read in continuous read mode */
+	struct circular_buffer *samples;
+	uint32_t buffer_samples;
+	/** Integrity check in use */
+	enum ad_sd_check check;
+	/** Size of the conversion result in bytes */
+	uint8_t data_size;
+	/** Whether the status byte is appended to the conversion result */
+	bool append_status;
+	/** Channel reported when the status byte is not appended */
+	uint8_t channel;
+	/** Whether continuous read mode is active */
+	bool cont_read;
+	/** Samples lost because the buffer was full */
+	uint32_t overruns;
+	/** Samples dropped because of a failed integrity check */
+	uint32_t check_errors;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+/* Initialize the sigma-delta layer. */
+int32_t ad_sd_init(struct ad_sd_dev **sd,
+		   const struct ad_sd_init_param *init_param);
+/* Free the resources allocated by ad_sd_init(). */
+int32_t ad_sd_remove(struct ad_sd_dev *sd);
+/* Select the integrity check used on the SPI transfers. */
+void ad_sd_set_check(struct ad_sd_dev *sd, enum ad_sd_check check);
+/* Set the format of the conversion results. */
+void ad_sd_set_data_format(struct ad_sd_dev *sd, uint8_t data_size,
+			   bool append_status);
+/* Read raw bytes from a register and verify the check byte. */
+int32_t ad_sd_read(struct ad_sd_dev *sd, uint8_t addr, uint8_t *data,
+		   uint8_t size);
+/* Read a register. */
+int32_t ad_sd_read_reg(struct ad_sd_dev *sd, uint8_t addr, uint8_t size,
+		       uint32_t *val);
+/* Write a register. */
+int32_t ad_sd_write_reg(struct ad_sd_dev *sd, uint8_t addr, uint8_t size,
+			uint32_t val);
+/* Reset the serial interface. */
+int32_t ad_sd_reset(struct ad_sd_dev *sd);
+/* Wait for the end of a conversion. */
+int32_t ad_sd_wait_for_rdy(struct ad_sd_dev *sd, uint32_t timeout);
+/* Read a conversion result. */
+int32_t ad_sd_read_data(struct ad_sd_dev *sd, struct ad_sd_sample *sample);
+/* Enter continuous read mode and start buffering the samples. */
+int32_t ad_sd_cont_read_start(struct ad_sd_dev *sd);
+/* Leave continuous read mode. */
+int32_t ad_sd_cont_read_stop(struct ad_sd_dev *sd, uint32_t timeout);
+/* Read the samples buffered in continuous read mode. */
+int32_t ad_sd_cont_read_samples(struct ad_sd_dev *sd,
+				struct ad_sd_sample *samples, uint32_t nb_samples,
+				uint32_t *nb_read);
+
+#endif // AD_SIGMA_DELTA_H_
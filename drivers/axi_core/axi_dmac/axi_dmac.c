@@ -46,6 +46,7 @@
 #include "error.h"
 #include "delay.h"
 #include "axi_dmac.h"
+#include "trace.h"
 
 /***************************************************************************//**
  * @brief axi_dmac_read
@@ -72,26 +73,42 @@ int32_t axi_dmac_write(struct axi_dmac *dmac,
 }
 
 /***************************************************************************//**
- * @brief axi_dmac_transfer
+ * @brief axi_dmac_reset
+ * Disable and re-enable the controller, dropping the queued transfers, and
+ * clear the pending interrupts.
  *******************************************************************************/
-int32_t axi_dmac_transfer(struct axi_dmac *dmac,
-			  uint32_t address, uint32_t size)
+int32_t axi_dmac_reset(struct axi_dmac *dmac)
 {
-	uint32_t transfer_id;
 	uint32_t reg_val;
 
-	if (size == 0)
-		return SUCCESS; /* nothing to do */
-
 	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
 	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE);
 
 	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
 
-	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, &transfer_id);
 	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
 	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
 
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_transfer_start
+ * Queue a transfer on an enabled controller and return without waiting for
+ * it to complete. The ID to pass to axi_dmac_transfer_done() is returned in
+ * transfer_id.
+ *******************************************************************************/
+int32_t axi_dmac_transfer_start(struct axi_dmac *dmac,
+				uint32_t address, uint32_t size,
+				uint32_t *transfer_id)
+{
+	uint32_t reg_val;
+
+	if (size == 0)
+		return FAILURE;
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, transfer_id);
+
 	switch (dmac->direction) {
 	case DMA_DEV_TO_MEM:
 		axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS, address);
@@ -119,6 +136,51 @@ int32_t axi_dmac_transfer(struct axi_dmac *dmac,
 		axi_dmac_read(dmac, AXI_DMAC_REG_START_TRANSFER, &reg_val);
 	} while(reg_val == 1);
 
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_transfer_done
+ * Check whether the transfer with the given ID has completed.
+ *******************************************************************************/
+int32_t axi_dmac_transfer_done(struct axi_dmac *dmac,
+			       uint32_t transfer_id, bool *done)
+{
+	uint32_t reg_val;
+	int32_t ret;
+
+	ret = axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_DONE, &reg_val);
+	if (ret != SUCCESS)
+		return ret;
+
+	*done = (reg_val & (1u << transfer_id)) != 0;
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_transfer
+ *******************************************************************************/
+int32_t axi_dmac_transfer(struct axi_dmac *dmac,
+			  uint32_t address, uint32_t size)
+{
+	uint32_t transfer_id;
+	uint32_t reg_val;
+	int32_t ret;
+
+	if (size == 0)
+		return SUCCESS; /* nothing to do */
+
+	TRACE_BEGIN(TRACE_ID_AXI_DMAC_TRANSFER);
+
+	axi_dmac_reset(dmac);
+
+	ret = axi_dmac_transfer_start(dmac, address, size, &transfer_id);
+	if (ret != SUCCESS || (dmac->flags & DMA_CYCLIC)) {
+		TRACE_END(TRACE_ID_AXI_DMAC_TRANSFER);
+		return ret;
+	}
+
 	/* Wait until the current transfer is completed. */
 	do {
 		axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
@@ -130,6 +192,8 @@ int32_t axi_dmac_transfer(struct axi_dmac *dmac,
 		axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_DONE, &reg_val);
 	} while((reg_val & (1u << transfer_id)) != (1u << transfer_id));
 
+	TRACE_END(TRACE_ID_AXI_DMAC_TRANSFER);
+
 	return SUCCESS;
 }
 
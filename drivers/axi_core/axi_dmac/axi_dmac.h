@@ -43,6 +43,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 #include "util.h"
 
 /******************************************************************************/
@@ -102,6 +103,12 @@ int32_t axi_dmac_read(struct axi_dmac *dmac, uint32_t reg_addr,
 		      uint32_t *reg_data);
 int32_t axi_dmac_write(struct axi_dmac *dmac, uint32_t reg_addr,
 		       uint32_t reg_data);
+int32_t axi_dmac_reset(struct axi_dmac *dmac);
+int32_t axi_dmac_transfer_start(struct axi_dmac *dmac,
+				uint32_t address, uint32_t size,
+				uint32_t *transfer_id);
+int32_t axi_dmac_transfer_done(struct axi_dmac *dmac,
+			       uint32_t transfer_id, bool *done);
 int32_t axi_dmac_transfer(struct axi_dmac *dmac,
 			  uint32_t address, uint32_t size);
 int32_t axi_dmac_init(struct axi_dmac **adc_core,
@@ -179,6 +179,23 @@ int32_t axi_jesd204_rx_lane_clk_disable(struct axi_jesd204_rx *jesd)
 	return axi_jesd204_rx_write(jesd, JESD204_RX_REG_LINK_DISABLE, 0x1);
 }
 
+/**
+ * @brief axi_jesd204_rx_link_status_get
+ */
+int32_t axi_jesd204_rx_link_status_get(struct axi_jesd204_rx *jesd,
+				       bool *enabled, uint32_t *link_status)
+{
+	uint32_t link_disabled;
+
+	axi_jesd204_rx_read(jesd, JESD204_RX_REG_LINK_STATE, &link_disabled);
+	axi_jesd204_rx_read(jesd, JESD204_RX_REG_LINK_STATUS, link_status);
+
+	*enabled = !(link_disabled & 0x1);
+	*link_status &= 0x3;
+
+	return SUCCESS;
+}
+
 /**
  * @brief axi_jesd204_rx_status_read
  */
@@ -89,6 +89,8 @@ struct jesd204_rx_init {
 /******************************************************************************/
 int32_t axi_jesd204_rx_lane_clk_enable(struct axi_jesd204_rx *jesd);
 int32_t axi_jesd204_rx_lane_clk_disable(struct axi_jesd204_rx *jesd);
+int32_t axi_jesd204_rx_link_status_get(struct axi_jesd204_rx *jesd,
+				       bool *enabled, uint32_t *link_status);
 uint32_t axi_jesd204_rx_status_read(struct axi_jesd204_rx *jesd);
 int32_t axi_jesd204_rx_laneinfo_read(struct axi_jesd204_rx *jesd,
 				     uint32_t lane);
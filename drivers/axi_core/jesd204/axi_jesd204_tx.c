@@ -136,6 +136,23 @@ int32_t axi_jesd204_tx_lane_clk_disable(struct axi_jesd204_tx *jesd)
 	return axi_jesd204_tx_write(jesd, JESD204_TX_REG_LINK_DISABLE, 0x1);
 }
 
+/**
+ * @brief axi_jesd204_tx_link_status_get
+ */
+int32_t axi_jesd204_tx_link_status_get(struct axi_jesd204_tx *jesd,
+				       bool *enabled, uint32_t *link_status)
+{
+	uint32_t link_disabled;
+
+	axi_jesd204_tx_read(jesd, JESD204_TX_REG_LINK_STATE, &link_disabled);
+	axi_jesd204_tx_read(jesd, JESD204_TX_REG_LINK_STATUS, link_status);
+
+	*enabled = !(link_disabled & 0x1);
+	*link_status &= 0x3;
+
+	return SUCCESS;
+}
+
 /**
  * @brief axi_jesd204_tx_status_read
  */
@@ -105,6 +105,8 @@ struct jesd204_tx_init {
 /******************************************************************************/
 int32_t axi_jesd204_tx_lane_clk_enable(struct axi_jesd204_tx *jesd);
 int32_t axi_jesd204_tx_lane_clk_disable(struct axi_jesd204_tx *jesd);
+int32_t axi_jesd204_tx_link_status_get(struct axi_jesd204_tx *jesd,
+				       bool *enabled, uint32_t *link_status);
 uint32_t axi_jesd204_tx_status_read(struct axi_jesd204_tx *jesd);
 int32_t axi_jesd204_tx_init(struct axi_jesd204_tx **jesd204,
 			    const struct jesd204_tx_init *init);
@@ -0,0 +1,366 @@
+/***************************************************************************//**
+ *   @file   jesd204_topology.c
+ *   @brief  Staged bring-up scheduler for multi-device JESD204 topologies.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include "error.h"
+#include "delay.h"
+#include "util.h"
+#include "jesd204_topology.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define JESD204_TOPO_DEFAULT_POLL_US	100
+#define JESD204_TOPO_DEFAULT_TIMEOUT_US	100000
+
+static const char *jesd204_topo_stage_names[JESD204_TOPO_STAGE_NUM] = {
+	"clocks",
+	"link setup",
+	"sysref",
+	"link enable",
+	"status",
+};
+
+/******************************************************************************/
+/************************** Functions Implementation **************************/
+/******************************************************************************/
+
+/**
+ * @brief Get the name of a stage.
+ * @param stage - The stage.
+ * @return The name of the stage.
+ */
+const char *jesd204_topo_stage_name(enum jesd204_topo_stage stage)
+{
+	if (stage >= JESD204_TOPO_STAGE_NUM)
+		return "unknown";
+
+	return jesd204_topo_stage_names[stage];
+}
+
+/**
+ * @brief Read the time source of the topology, if any.
+ * @param topo - The topology.
+ * @return The current time in microseconds, 0 without a time source.
+ */
+static uint32_t jesd204_topo_time_us(struct jesd204_topo *topo)
+{
+	if (!topo->get_time_us)
+		return 0;
+
+	return topo->get_time_us();
+}
+
+/**
+ * @brief Call the stage callback of a device and update the stage masks.
+ * @param topo - The topology.
+ * @param stage - The stage.
+ * @param idx - Index of the device.
+ * @param pending - Mask of the devices that are still in progress.
+ * @param failed - Mask of the devices that failed.
+ */
+static void jesd204_topo_dev_call(struct jesd204_topo *topo,
+				  enum jesd204_topo_stage stage, uint32_t idx,
+				  uint32_t *pending, uint32_t *failed)
+{
+	struct jesd204_topo_dev *dev = &topo->devs[idx];
+	int32_t ret;
+
+	ret = dev->stage[stage](dev->dev);
+	if (ret == JESD204_TOPO_PENDING) {
+		*pending |= BIT(idx);
+		return;
+	}
+
+	*pending &= ~BIT(idx);
+	if (ret < 0) {
+		printf("error: %s: %s stage failed (%"PRIi32")\n", dev->name,
+		       jesd204_topo_stage_name(stage), ret);
+		*failed |= BIT(idx);
+	}
+}
+
+/**
+ * @brief Run a stage on a set of devices.
+ *
+ * The callbacks are started in device order. The pending ones are then polled
+ * together, so the waits of independent devices overlap.
+ * @param topo - The topology.
+ * @param stage - The stage.
+ * @param mask - Mask of the devices to run the stage on.
+ * @param failed - Mask of the devices that failed or timed out.
+ */
+static void jesd204_topo_stage_run(struct jesd204_topo *topo,
+				   enum jesd204_topo_stage stage,
+				   uint32_t mask, uint32_t *failed)
+{
+	uint32_t pending = 0;
+	uint32_t waited_us = 0;
+	uint32_t start;
+	uint32_t i;
+
+	*failed = 0;
+	start = jesd204_topo_time_us(topo);
+
+	for (i = 0; i < topo->num_devs; i++) {
+		if (!(mask & BIT(i)) || !topo->devs[i].stage[stage])
+			continue;
+		jesd204_topo_dev_call(topo, stage, i, &pending, failed);
+	}
+
+	while (pending) {
+		if (waited_us >= topo->timeout_us) {
+			for (i = 0; i < topo->num_devs; i++)
+				if (pending & BIT(i))
+					printf("error: %s: %s stage timed out\n",
+					       topo->devs[i].name,
+					       jesd204_topo_stage_name(stage));
+			*failed |= pending;
+			break;
+		}
+
+		udelay(topo->poll_us);
+		waited_us += topo->poll_us;
+
+		for (i = 0; i < topo->num_devs; i++)
+			if (pending & BIT(i))
+				jesd204_topo_dev_call(topo, stage, i, &pending,
+						      failed);
+	}
+
+	topo->stage_wait_us[stage] += waited_us;
+	/* Unsigned difference, correct across a wrap of the time source */
+	topo->stage_time_us[stage] += (uint32_t)(jesd204_topo_time_us(topo) -
+					       start);
+}
+
+/**
+ * @brief Extend a mask of failed devices to all the devices of their links.
+ * @param topo - The topology.
+ * @param failed - Mask of the failed devices.
+ * @param links - Mask of the devices to be retried.
+ * @return SUCCESS if all the failed devices belong to a link, FAILURE
+ *         otherwise.
+ */
+static int32_t jesd204_topo_link_mask(struct jesd204_topo *topo,
+				      uint32_t failed, uint32_t *links)
+{
+	uint32_t i, j;
+
+	*links = 0;
+	for (i = 0; i < topo->num_devs; i++) {
+		if (!(failed & BIT(i)))
+			continue;
+		if (topo->devs[i].link_id == JESD204_TOPO_NO_LINK)
+			return FAILURE;
+		for (j = 0; j < topo->num_devs; j++)
+			if (topo->devs[j].link_id == topo->devs[i].link_id)
+				*links |= BIT(j);
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Disable, enable and check again the links of a set of devices.
+ * @param topo - The topology.
+ * @param mask - Mask of the devices to be retried.
+ * @param failed - Mask of the devices that failed again.
+ */
+static void jesd204_topo_link_retry(struct jesd204_topo *topo, uint32_t mask,
+				    uint32_t *failed)
+{
+	uint32_t enable_failed;
+	uint32_t status_failed;
+	uint32_t i;
+
+	for (i = 0; i < topo->num_devs; i++)
+		if ((mask & BIT(i)) && topo->devs[i].link_disable)
+			topo->devs[i].link_disable(topo->devs[i].dev);
+
+	jesd204_topo_stage_run(topo, JESD204_TOPO_STAGE_LINK_ENABLE, mask,
+			       &enable_failed);
+	jesd204_topo_stage_run(topo, JESD204_TOPO_STAGE_STATUS,
+			       mask & ~enable_failed, &status_failed);
+
+	*failed = enable_failed | status_failed;
+}
+
+/**
+ * @brief Print the time spent in each stage.
+ * @param topo - The topology.
+ */
+static void jesd204_topo_print_timing(struct jesd204_topo *topo)
+{
+	uint32_t i;
+
+	printf("jesd204 topology bring-up:\n");
+	for (i = 0; i < JESD204_TOPO_STAGE_NUM; i++) {
+		printf("\t%-12s waited %"PRIu32" us", jesd204_topo_stage_name(i),
+		       (uint32_t)topo->stage_wait_us[i]);
+		if (topo->get_time_us)
+			printf(", took %"PRIu32" us",
+			       (uint32_t)topo->stage_time_us[i]);
+		printf("\n");
+	}
+	if (topo->get_time_us)
+		printf("\ttotal %"PRIu32" us, %"PRIu32" link retries\n",
+		       (uint32_t)topo->total_time_us, topo->retries);
+	else
+		printf("\t%"PRIu32" link retries\n", topo->retries);
+}
+
+/**
+ * @brief Run all the stages on all the devices.
+ *
+ * A failure in the CLOCKS, LINK_SETUP or SYSREF stage, or of a device that
+ * does not belong to a link, aborts the bring-up. A failure in the LINK_ENABLE
+ * or STATUS stage only causes the affected link to be retried, up to
+ * max_retries times.
+ * @param topo - The topology.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t jesd204_topo_run(struct jesd204_topo *topo)
+{
+	enum jesd204_topo_stage stage;
+	uint32_t retry = 0;
+	uint32_t failed;
+	uint32_t mask;
+	uint32_t start;
+	int32_t ret = SUCCESS;
+
+	if (!topo)
+		return -EINVAL;
+
+	for (stage = 0; stage < JESD204_TOPO_STAGE_NUM; stage++) {
+		topo->stage_time_us[stage] = 0;
+		topo->stage_wait_us[stage] = 0;
+	}
+	topo->retries = 0;
+
+	start = jesd204_topo_time_us(topo);
+	mask = BIT(topo->num_devs) - 1;
+
+	for (stage = 0; stage < JESD204_TOPO_STAGE_NUM; stage++) {
+		jesd204_topo_stage_run(topo, stage, mask & ~retry, &failed);
+		if (!failed)
+			continue;
+
+		if (stage < JESD204_TOPO_STAGE_LINK_ENABLE) {
+			ret = FAILURE;
+			goto out;
+		}
+
+		ret = jesd204_topo_link_mask(topo, failed, &failed);
+		if (ret != SUCCESS)
+			goto out;
+		retry |= failed;
+	}
+
+	while (retry) {
+		if (topo->retries == topo->max_retries) {
+			ret = FAILURE;
+			goto out;
+		}
+		topo->retries++;
+
+		jesd204_topo_link_retry(topo, retry, &failed);
+		ret = jesd204_topo_link_mask(topo, failed, &retry);
+		if (ret != SUCCESS)
+			goto out;
+	}
+
+out:
+	topo->total_time_us = (uint32_t)(jesd204_topo_time_us(topo) - start);
+	jesd204_topo_print_timing(topo);
+
+	return ret;
+}
+
+/**
+ * @brief Initialize the topology.
+ * @param topo - The topology descriptor.
+ * @param init - The initialization parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t jesd204_topo_init(struct jesd204_topo **topo,
+			  const struct jesd204_topo_init *init)
+{
+	struct jesd204_topo *t;
+
+	if (!topo || !init || !init->devs || !init->num_devs ||
+	    init->num_devs > JESD204_TOPO_MAX_DEVS)
+		return -EINVAL;
+
+	t = (struct jesd204_topo *)calloc(1, sizeof(*t));
+	if (!t)
+		return -ENOMEM;
+
+	t->devs = init->devs;
+	t->num_devs = init->num_devs;
+	t->poll_us = init->poll_us ? init->poll_us :
+		     JESD204_TOPO_DEFAULT_POLL_US;
+	t->timeout_us = init->timeout_us ? init->timeout_us :
+			JESD204_TOPO_DEFAULT_TIMEOUT_US;
+	t->max_retries = init->max_retries;
+	t->get_time_us = init->get_time_us;
+
+	*topo = t;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by jesd204_topo_init().
+ * @param topo - The topology descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t jesd204_topo_remove(struct jesd204_topo *topo)
+{
+	if (!topo)
+		return -EINVAL;
+
+	free(topo);
+
+	return SUCCESS;
+}
@@ -0,0 +1,158 @@
+/***************************************************************************//**
+ *   @file   jesd204_topology.h
+ *   @brief  Staged bring-up scheduler for multi-device JESD204 topologies.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef JESD204_TOPOLOGY_H_
+#define JESD204_TOPOLOGY_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/* Maximum number of devices handled by one topology. */
+#define JESD204_TOPO_MAX_DEVS		16
+/* Returned by a stage callback that started an operation still in progress. */
+#define JESD204_TOPO_PENDING		1
+/* Link ID of devices that do not belong to a retryable link. */
+#define JESD204_TOPO_NO_LINK		0
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+/**
+ * @enum jesd204_topo_stage
+ * @brief Bring-up stages, executed in order for all the devices.
+ */
+enum jesd204_topo_stage {
+	/** Clock chips and device clocks */
+	JESD204_TOPO_STAGE_CLOCKS,
+	/** Converter, transceiver and link layer configuration */
+	JESD204_TOPO_STAGE_LINK_SETUP,
+	/** SYSREF generation and capture */
+	JESD204_TOPO_STAGE_SYSREF,
+	/** Link enable */
+	JESD204_TOPO_STAGE_LINK_ENABLE,
+	/** Link status check */
+	JESD204_TOPO_STAGE_STATUS,
+	JESD204_TOPO_STAGE_NUM,
+};
+
+/**
+ * @struct jesd204_topo_dev
+ * @brief Device taking part in the bring-up.
+ */
+struct jesd204_topo_dev {
+	/** Device name, used for logging */
+	const char *name;
+	/** Parameter passed to the callbacks */
+	void *dev;
+	/**
+	 * Stage callbacks, NULL if the device has nothing to do in a stage.
+	 * A callback returns SUCCESS when done, a negative error code on
+	 * failure, or JESD204_TOPO_PENDING if it has to be polled again. A
+	 * pending callback is called periodically until it completes, while
+	 * the callbacks of the other devices are polled as well.
+	 */
+	int32_t (*stage[JESD204_TOPO_STAGE_NUM])(void *dev);
+	/** Optional, called before the link is enabled again on a retry */
+	int32_t (*link_disable)(void *dev);
+	/**
+	 * Link the device belongs to. When the LINK_ENABLE or STATUS stage of
+	 * a device fails, only the devices of the same link go through
+	 * link_disable, LINK_ENABLE and STATUS again.
+	 */
+	uint8_t link_id;
+};
+
+/**
+ * @struct jesd204_topo_init
+ * @brief Topology initialization parameters.
+ */
+struct jesd204_topo_init {
+	/** Devices, in the order the callbacks of a stage must be called */
+	struct jesd204_topo_dev *devs;
+	/** Number of devices */
+	uint32_t num_devs;
+	/** Interval between two polls of the pending callbacks */
+	uint32_t poll_us;
+	/** Maximum time a stage may stay pending */
+	uint32_t timeout_us;
+	/** Number of times a failing link is retried */
+	uint32_t max_retries;
+	/** Optional time source used to measure the stages, e.g. get_time_us() */
+	uint32_t (*get_time_us)(void);
+};
+
+/**
+ * @struct jesd204_topo
+ * @brief Topology descriptor.
+ */
+struct jesd204_topo {
+	struct jesd204_topo_dev *devs;
+	uint32_t num_devs;
+	uint32_t poll_us;
+	uint32_t timeout_us;
+	uint32_t max_retries;
+	uint32_t (*get_time_us)(void);
+	/** Measured duration of each stage, retries included */
+	uint64_t stage_time_us[JESD204_TOPO_STAGE_NUM];
+	/** Time spent waiting on pending callbacks in each stage */
+	uint64_t stage_wait_us[JESD204_TOPO_STAGE_NUM];
+	/** Measured duration of the whole bring-up */
+	uint64_t total_time_us;
+	/** Number of link retries performed during the last run */
+	uint32_t retries;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+/* Initialize the topology. */
+int32_t jesd204_topo_init(struct jesd204_topo **topo,
+			  const struct jesd204_topo_init *init);
+/* Run all the stages on all the devices. */
+int32_t jesd204_topo_run(struct jesd204_topo *topo);
+/* Free the resources allocated by jesd204_topo_init(). */
+int32_t jesd204_topo_remove(struct jesd204_topo *topo);
+/* Get the name of a stage. */
+const char *jesd204_topo_stage_name(enum jesd204_topo_stage stage);
+
+#endif
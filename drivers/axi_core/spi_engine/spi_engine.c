@@ -651,6 +651,8 @@ int32_t spi_engine_init(struct spi_desc **desc,
 	(*desc)->extra = eng_desc;
 
 	eng_desc->offload_config = OFFLOAD_DISABLED;
+	eng_desc->offload_tx_dma = NULL;
+	eng_desc->offload_rx_dma = NULL;
 	eng_desc->spi_engine_baseaddr = spi_engine_init->spi_engine_baseaddr;
 	eng_desc->type = spi_engine_init->type;
 	eng_desc->cs_delay = spi_engine_init->cs_delay;
@@ -696,6 +698,7 @@ int32_t spi_engine_write_and_read(struct spi_desc *desc,
 	uint8_t 		i;
 	uint8_t 		word_len;
 	uint8_t 		words_number;
+	uint8_t			offload_config;
 	int32_t 		ret;
 	struct spi_engine_msg	msg;
 	struct spi_engine_desc	*desc_extra;
@@ -703,10 +706,13 @@ int32_t spi_engine_write_and_read(struct spi_desc *desc,
 	desc_extra = desc->extra;
 
 	/* If we want to access SPI interface and SPI engine offload module was
-	 * activated, we need to disable it
+	 * activated, we need to disable it. The offload configuration and its
+	 * program memory are kept, so spi_engine_offload_enable() can resume
+	 * it after the transfer.
 	 * This is set in spi_engine_offload_init() */
+	offload_config = desc_extra->offload_config;
 	desc_extra->offload_config = OFFLOAD_DISABLED;
-	/* This is set in spi_engine_offload_transfer() */
+	/* This is set in spi_engine_offload_enable() */
 	spi_engine_write(desc_extra, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0);
 
 	words_number = spi_get_words_number(desc_extra, bytes_number);
@@ -745,6 +751,8 @@ int32_t spi_engine_write_and_read(struct spi_desc *desc,
 	free(msg.tx_buf);
 	free(msg.rx_buf);
 
+	desc_extra->offload_config = offload_config;
+
 	return ret;
 }
 
@@ -771,44 +779,58 @@ int32_t spi_engine_offload_init(struct spi_desc *desc,
 	else
 		dma_flags = *(param->dma_flags);
 
+	/* The DMACs are kept until spi_engine_remove(), calling this again
+	 * only updates their configuration */
 	if(param->offload_config & OFFLOAD_TX_EN) {
 		dmac_init.name = "DAC DMAC";
 		dmac_init.base = param->tx_dma_baseaddr;
 		dmac_init.direction = DMA_MEM_TO_DEV;
 		dmac_init.flags = dma_flags;
-		axi_dmac_init(&eng_desc->offload_tx_dma, &dmac_init);
-		if(!eng_desc->offload_tx_dma)
-			return FAILURE;
+		if(eng_desc->offload_tx_dma) {
+			eng_desc->offload_tx_dma->base = dmac_init.base;
+			eng_desc->offload_tx_dma->flags = dmac_init.flags;
+		} else {
+			axi_dmac_init(&eng_desc->offload_tx_dma, &dmac_init);
+			if(!eng_desc->offload_tx_dma)
+				return FAILURE;
+		}
 	}
 	if(param->offload_config & OFFLOAD_RX_EN) {
 		dmac_init.name = "ADC DMAC";
 		dmac_init.base = param->rx_dma_baseaddr;
 		dmac_init.direction = DMA_DEV_TO_MEM;
 		dmac_init.flags = dma_flags;
-		axi_dmac_init(&eng_desc->offload_rx_dma, &dmac_init);
-		if(!eng_desc->offload_rx_dma)
-			return FAILURE;
+		if(eng_desc->offload_rx_dma) {
+			eng_desc->offload_rx_dma->base = dmac_init.base;
+			eng_desc->offload_rx_dma->flags = dmac_init.flags;
+		} else {
+			axi_dmac_init(&eng_desc->offload_rx_dma, &dmac_init);
+			if(!eng_desc->offload_rx_dma)
+				return FAILURE;
+		}
 	}
 
 	return SUCCESS;
 }
 
 /**
- * @brief Initiate a SPI transfer in offload mode
+ * @brief Load a message into the offload module's program memory
+ *
+ * The program is kept until the next load, so it can be triggered any number
+ * of times with spi_engine_offload_enable() without being written again.
+ * The current transfer speed, width and mode are part of the program.
  *
  * @param desc Decriptor containing SPI interface parameters
- * @param msg Offload message that get's to be transferred
- * @param no_samples Number of time the messages will be transferred
- * @return int32_t This function allways returns SUCCESS
+ * @param msg Offload message that will be executed on each trigger
+ * @return int32_t - SUCCESS if the program was loaded
+ *		   - FAILURE if the offload is disabled or the allocation failed
  */
-int32_t spi_engine_offload_transfer(struct spi_desc *desc,
-				    struct spi_engine_offload_message msg,
-				    uint32_t no_samples)
+int32_t spi_engine_offload_load(struct spi_desc *desc,
+				struct spi_engine_offload_message msg)
 {
 	struct spi_engine_msg	transfer;
 	struct spi_engine_desc	*eng_desc;
 	uint32_t 		i;
-	uint8_t 		word_length;
 
 	eng_desc = desc->extra;
 
@@ -817,6 +839,7 @@ int32_t spi_engine_offload_transfer(struct spi_desc *desc,
 	     (eng_desc->offload_config & OFFLOAD_RX_EN)))
 		return FAILURE;
 
+	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0);
 	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_RESET(0), 1);
 	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_RESET(0), 0);
 
@@ -841,8 +864,59 @@ int32_t spi_engine_offload_transfer(struct spi_desc *desc,
 
 	spi_engine_transfer_message(desc, &transfer);
 
+	spi_engine_queue_free(&transfer.cmds);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Start or stop the execution of the loaded offload program
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param enable true to run the program on each trigger, false to stop it
+ * @return int32_t - SUCCESS if the offload state was changed
+ *		   - FAILURE if the offload is disabled
+ */
+int32_t spi_engine_offload_enable(struct spi_desc *desc,
+				  bool enable)
+{
+	struct spi_engine_desc	*eng_desc;
+
+	eng_desc = desc->extra;
+
+	if(!((eng_desc->offload_config & OFFLOAD_TX_EN) |
+	     (eng_desc->offload_config & OFFLOAD_RX_EN)))
+		return FAILURE;
+
+	return spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0),
+				enable ? 0x0001 : 0x0000);
+}
+
+/**
+ * @brief Initiate a SPI transfer in offload mode
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param msg Offload message that get's to be transferred
+ * @param no_samples Number of time the messages will be transferred
+ * @return int32_t - SUCCESS if the transfer was started
+ *		   - FAILURE if the offload is disabled or the allocation failed
+ */
+int32_t spi_engine_offload_transfer(struct spi_desc *desc,
+				    struct spi_engine_offload_message msg,
+				    uint32_t no_samples)
+{
+	struct spi_engine_desc	*eng_desc;
+	uint8_t 		word_length;
+	int32_t			ret;
+
+	eng_desc = desc->extra;
+
+	ret = spi_engine_offload_load(desc, msg);
+	if (ret != SUCCESS)
+		return ret;
+
 	/* Start transfer */
-	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0x0001);
+	spi_engine_offload_enable(desc, true);
 
 	word_length = spi_get_word_lenght(eng_desc);
 	if(eng_desc->offload_config & OFFLOAD_TX_EN) {
@@ -861,8 +935,6 @@ int32_t spi_engine_offload_transfer(struct spi_desc *desc,
 
 	usleep(1000);
 
-	spi_engine_queue_free(&transfer.cmds);
-
 	return SUCCESS;
 }
 
@@ -878,9 +950,10 @@ int32_t spi_engine_remove(struct spi_desc *desc)
 
 	eng_desc = desc->extra;
 
-	if(eng_desc->offload_config & OFFLOAD_TX_EN)
+	/* The offload may have been disabled since the DMACs were allocated */
+	if(eng_desc->offload_tx_dma)
 		axi_dmac_remove(eng_desc->offload_tx_dma);
-	if(eng_desc->offload_config & OFFLOAD_RX_EN)
+	if(eng_desc->offload_rx_dma)
 		axi_dmac_remove(eng_desc->offload_rx_dma);
 	free(desc->extra);
 	free(desc);
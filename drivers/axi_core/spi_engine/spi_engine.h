@@ -204,6 +204,14 @@ int32_t spi_engine_remove(struct spi_desc *desc);
 int32_t spi_engine_offload_init(struct spi_desc *desc,
 				const struct spi_engine_offload_init_param *param);
 
+/* Load a message into the offload module's program memory */
+int32_t spi_engine_offload_load(struct spi_desc *desc,
+				struct spi_engine_offload_message msg);
+
+/* Start or stop the execution of the loaded offload program */
+int32_t spi_engine_offload_enable(struct spi_desc *desc,
+				  bool enable);
+
 /* Write and read data over SPI using the offload module */
 int32_t spi_engine_offload_transfer(struct spi_desc *desc,
 				    struct spi_engine_offload_message msg,
@@ -44,8 +44,18 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include "ad9144.h"
+#include "deadline.h"
 #include "error.h"
 
+/* Register status polling limit, same as the former 100 x 1 ms loop */
+#define AD9144_CHECK_STATUS_TIMEOUT_US	100000u
+#define AD9144_CHECK_STATUS_MAX_SLEEP_US	1000u
+/* DAC calibration limit for all converters, table 86 AD9144 datasheet Rev C */
+#define AD9144_CAL_TIMEOUT_US		110000u
+#define AD9144_CAL_MAX_SLEEP_US		500u
+/* Longest register run written in a single streaming SPI transaction */
+#define AD9144_SPI_STREAM_MAX		16
+
 struct ad9144_jesd204_link_mode {
 	uint8_t id;
 	uint8_t M;
@@ -113,29 +123,60 @@ int32_t ad9144_spi_write(struct ad9144_dev *dev,
 	return ret;
 }
 
+/**
+ * Register status polled by ad9144_spi_check_status().
+ */
+struct ad9144_status_poll {
+	struct ad9144_dev *dev;
+	uint16_t reg_addr;
+	uint8_t reg_mask;
+	uint8_t exp_reg_data;
+};
+
+/**
+ * Check if the masked register value reached the expected value.
+ * @param ctx The struct ad9144_status_poll to check.
+ * @return 1 if it did, 0 if it did not, negative error code on SPI failure.
+ */
+static int32_t ad9144_status_reached(void *ctx)
+{
+	struct ad9144_status_poll *poll = ctx;
+	uint8_t status;
+	int32_t ret;
+
+	ret = ad9144_spi_read(poll->dev, poll->reg_addr, &status);
+	if (ret != SUCCESS)
+		return ret;
+
+	return (status & poll->reg_mask) == poll->exp_reg_data;
+}
+
 /***************************************************************************//**
- * @brief ad9144_spi_check_status
- *******************************************************************************/
+ * @brief Poll a register until the masked value is the expected one.
+ *
+ * @param dev          - The device structure.
+ * @param reg_addr     - The register address.
+ * @param reg_mask     - The bits to compare.
+ * @param exp_reg_data - The expected value of the masked bits.
+ *
+ * @return SUCCESS in case of success, -ETIMEDOUT if the value is not reached
+ *         within 100 ms, negative error code on SPI failure.
+*******************************************************************************/
 int32_t ad9144_spi_check_status(struct ad9144_dev *dev,
 				uint16_t reg_addr,
 				uint8_t reg_mask,
 				uint8_t exp_reg_data)
 {
-	uint16_t timeout = 0;
-	uint8_t status = 0;
-	do {
-		ad9144_spi_read(dev,
-				reg_addr,
-				&status);
-		if ((status & reg_mask) == exp_reg_data) {
-			return 0;
-		} else {
-			timeout++;
-			mdelay(1);
-		}
-	} while(timeout < 100);
-
-	return -1;
+	struct ad9144_status_poll poll = {
+		.dev = dev,
+		.reg_addr = reg_addr,
+		.reg_mask = reg_mask,
+		.exp_reg_data = exp_reg_data,
+	};
+
+	return poll_until(ad9144_status_reached, &poll,
+			  AD9144_CHECK_STATUS_TIMEOUT_US,
+			  AD9144_CHECK_STATUS_MAX_SLEEP_US);
 }
 
 struct ad9144_reg_seq {
@@ -143,18 +184,67 @@ struct ad9144_reg_seq {
 	uint16_t val;
 };
 
+/***************************************************************************//**
+ * @brief Write a run of consecutive registers in one streaming transaction.
+ *
+ * The interface is left in its default descending address mode, so the
+ * instruction carries the last address of the run and the data follows from
+ * the last register down to the first.
+ *
+ * @param dev - The device structure.
+ * @param seq - The first entry of the run, addresses ascending by one.
+ * @param num - The number of entries, at most AD9144_SPI_STREAM_MAX.
+ *
+ * @return SUCCESS in case of success, negative error code otherwise.
+*******************************************************************************/
+static int32_t ad9144_spi_write_stream(struct ad9144_dev *dev,
+				       const struct ad9144_reg_seq *seq,
+				       uint32_t num)
+{
+	uint8_t buf[2 + AD9144_SPI_STREAM_MAX];
+	uint16_t reg_addr = seq[num - 1].reg;
+	uint32_t i;
+
+	buf[0] = reg_addr >> 8;
+	buf[1] = reg_addr & 0xFF;
+	for (i = 0; i < num; i++)
+		buf[2 + i] = seq[num - 1 - i].val;
+
+	return spi_write_and_read(dev->spi_desc, buf, 2 + num);
+}
+
+/***************************************************************************//**
+ * @brief Write a register sequence table.
+ *
+ * Entries with consecutive addresses are streamed in a single SPI transaction.
+ *
+ * @param dev - The device structure.
+ * @param seq - The register sequence.
+ * @param num - The number of entries.
+ *
+ * @return SUCCESS in case of success, negative error code otherwise.
+*******************************************************************************/
 int32_t ad9144_spi_write_seq(struct ad9144_dev *dev,
 			     const struct ad9144_reg_seq *seq, uint32_t num)
 {
-	int32_t ret = 0;
+	uint32_t run;
+	int32_t ret;
 
 	while (num) {
-		ret |= ad9144_spi_write(dev, seq->reg, seq->val);
-		num--;
-		seq++;
+		run = 1;
+		while (run < num && run < AD9144_SPI_STREAM_MAX &&
+		       seq[run].reg == seq[run - 1].reg + 1)
+			run++;
+
+		ret = ad9144_spi_write_stream(dev, seq, run);
+		if (ret != SUCCESS)
+			return ret;
+
+		num -= run;
+		seq += run;
 	}
 
-	return 0;
+	return SUCCESS;
 }
 
 /*
@@ -194,9 +284,11 @@ int32_t ad9144_setup_jesd204_link(struct ad9144_dev *dev,
 				  const struct ad9144_init_param *init_param)
 {
 	const struct ad9144_jesd204_link_mode *link_mode = NULL;
+	struct ad9144_reg_seq ils[11];
 	unsigned int lane_mask;
 	unsigned int val;
 	unsigned int i;
+	int32_t ret;
 
 	for (i = 0; i < ARRAY_SIZE(ad9144_jesd204_link_modes); i++) {
 		if (ad9144_jesd204_link_modes[i].id == init_param->jesd204_mode) {
@@ -210,34 +302,38 @@ int32_t ad9144_setup_jesd204_link(struct ad9144_dev *dev,
 
 	lane_mask = (1 << link_mode->L) - 1;
 
-	ad9144_spi_write(dev, REG_ILS_DID, 0x00);
-	ad9144_spi_write(dev, REG_ILS_BID, 0x00);
-	ad9144_spi_write(dev, REG_ILS_LID0, 0x00);
+	ils[0] = (struct ad9144_reg_seq) {REG_ILS_DID, 0x00};
+	ils[1] = (struct ad9144_reg_seq) {REG_ILS_BID, 0x00};
+	ils[2] = (struct ad9144_reg_seq) {REG_ILS_LID0, 0x00};
 
 	val = link_mode->L - 1;
 	if (init_param->jesd204_scrambling)
 		val |= 0x80;
-	ad9144_spi_write(dev, REG_ILS_SCR_L, val);
+	ils[3] = (struct ad9144_reg_seq) {REG_ILS_SCR_L, val};
 
 	val = link_mode->F - 1;
-	ad9144_spi_write(dev, REG_ILS_F, val);
-	ad9144_spi_write(dev, REG_ILS_K, 0x1f);
+	ils[4] = (struct ad9144_reg_seq) {REG_ILS_F, val};
+	ils[5] = (struct ad9144_reg_seq) {REG_ILS_K, 0x1f};
 
 	val = link_mode->M - 1;
-	ad9144_spi_write(dev, REG_ILS_M, val);
-	ad9144_spi_write(dev, REG_ILS_CS_N, 0x0f); // 16 bits per sample
+	ils[6] = (struct ad9144_reg_seq) {REG_ILS_M, val};
+	ils[7] = (struct ad9144_reg_seq) {REG_ILS_CS_N, 0x0f}; // 16 bits per sample
 
 	val = 0x0f; // 16 bits per sample
 	if (init_param->jesd204_subclass == 1)
 		val |= 0x20;
-	ad9144_spi_write(dev, REG_ILS_NP, val);
+	ils[8] = (struct ad9144_reg_seq) {REG_ILS_NP, val};
 
 	val = link_mode->S - 1;
 	val |= 0x20; /* JESD204 version B */
-	ad9144_spi_write(dev, REG_ILS_S, val);
+	ils[9] = (struct ad9144_reg_seq) {REG_ILS_S, val};
 
 	val = link_mode->F == 1 ? 0x80 : 0x00;
-	ad9144_spi_write(dev, REG_ILS_HD_CF, val);
+	ils[10] = (struct ad9144_reg_seq) {REG_ILS_HD_CF, val};
+
+	ret = ad9144_spi_write_seq(dev, ils, ARRAY_SIZE(ils));
+	if (ret != SUCCESS)
+		return ret;
 
 	ad9144_spi_write(dev, REG_LANEDESKEW, lane_mask);
 	ad9144_spi_write(dev, REG_CTRLREG1, link_mode->F);
@@ -345,8 +441,10 @@ static int32_t ad9144_pll_setup(struct ad9144_dev *dev,
 		vco_param[2] = 0x06;
 	}
 
-	ad9144_spi_write_seq(dev, ad9144_pll_fixed_writes,
-			     ARRAY_SIZE(ad9144_pll_fixed_writes));
+	ret = ad9144_spi_write_seq(dev, ad9144_pll_fixed_writes,
+				   ARRAY_SIZE(ad9144_pll_fixed_writes));
+	if (ret != SUCCESS)
+		return ret;
 
 	ad9144_spi_write(dev, REG_DACLOGENCNTRL, lo_div_mode);
 	ad9144_spi_write(dev, REG_DACLDOCNTRL1, ref_div_mode);
@@ -359,7 +457,7 @@ static int32_t ad9144_pll_setup(struct ad9144_dev *dev,
 	ad9144_spi_write(dev, REG_DACPLLCNTRL, 0x10);
 
 	ret = ad9144_spi_check_status(dev, REG_DACPLLSTATUS, 0x22, 0x22);
-	if (ret == -1)
+	if (ret < 0)
 		printf("%s : DAC PLL NOT locked!.\n", __func__);
 
 	return ret;
@@ -453,8 +551,10 @@ int32_t ad9144_setup(struct ad9144_dev **device,
 
 	/* SPI */
 	ret = spi_init(&dev->spi_desc, &init_param->spi_init);
-	if (ret == -1)
+	if (ret != SUCCESS) {
 		printf("%s : Device descriptor failed!\n", __func__);
+		goto error_dev;
+	}
 
 	// reset
 	ad9144_spi_write(dev, REG_SPI_INTFCONFA, SOFTRESET_M | SOFTRESET);
@@ -464,7 +564,8 @@ int32_t ad9144_setup(struct ad9144_dev **device,
 	ad9144_spi_read(dev, REG_SPI_PRODIDL, &chip_id);
 	if(chip_id != AD9144_CHIP_ID) {
 		printf("%s : Invalid CHIP ID (0x%x).\n", __func__, chip_id);
-		return -1;
+		ret = -1;
+		goto error_spi;
 	}
 
 	ad9144_spi_write(dev, REG_SPI_SCRATCHPAD, 0xAD);
@@ -472,7 +573,8 @@ int32_t ad9144_setup(struct ad9144_dev **device,
 	if(scratchpad != 0xAD) {
 		printf("%s : scratchpad read-write failed (0x%x)!\n", __func__,
 		       scratchpad);
-		return -1;
+		ret = -1;
+		goto error_spi;
 	}
 
 	// power-up and dac initialization
@@ -482,13 +584,20 @@ int32_t ad9144_setup(struct ad9144_dev **device,
 			 0x00);	// sysref - power up/falling edge
 
 	// required device configurations
-	ad9144_spi_write_seq(dev, ad9144_required_device_config,
-			     ARRAY_SIZE(ad9144_required_device_config));
-	ad9144_spi_write_seq(dev, ad9144_optimal_serdes_settings,
-			     ARRAY_SIZE(ad9144_optimal_serdes_settings));
+	ret = ad9144_spi_write_seq(dev, ad9144_required_device_config,
+				   ARRAY_SIZE(ad9144_required_device_config));
+	if (ret != SUCCESS)
+		goto error_spi;
+	ret = ad9144_spi_write_seq(dev, ad9144_optimal_serdes_settings,
+				   ARRAY_SIZE(ad9144_optimal_serdes_settings));
+	if (ret != SUCCESS)
+		goto error_spi;
 
-	if (init_param->pll_enable)
-		ad9144_pll_setup(dev, init_param);
+	if (init_param->pll_enable) {
+		ret = ad9144_pll_setup(dev, init_param);
+		if (ret != SUCCESS)
+			goto error_spi;
+	}
 
 	// digital data path
 
@@ -515,7 +624,9 @@ int32_t ad9144_setup(struct ad9144_dev **device,
 	ad9144_spi_write(dev, REG_MASTER_PD, 0x00);	// phy - power up
 	ad9144_spi_write(dev, REG_PHY_PD, 0x00);	// phy - power up
 	ad9144_spi_write(dev, REG_GENERAL_JRX_CTRL_0, 0x00);	// single link - link 0
-	ad9144_setup_jesd204_link(dev, init_param);
+	ret = ad9144_setup_jesd204_link(dev, init_param);
+	if (ret != SUCCESS)
+		goto error_spi;
 
 	// physical layer
 
@@ -553,7 +664,7 @@ int32_t ad9144_setup(struct ad9144_dev **device,
 	mdelay(20);
 
 	ret = ad9144_spi_check_status(dev, REG_PLL_STATUS, 0x01, 0x01);
-	if (ret == -1)
+	if (ret < 0)
 		printf("%s : PLL NOT locked!.\n", __func__);
 
 	ad9144_spi_write(dev, REG_EQ_BIAS_REG, 0x62);	// equalizer
@@ -587,14 +698,29 @@ int32_t ad9144_setup(struct ad9144_dev **device,
 
 	*device = dev;
 
+	return ret;
+
+error_spi:
+	spi_remove(dev->spi_desc);
+error_dev:
+	free(dev);
+
 	return ret;
 }
 
 int32_t ad9144_dac_calibrate(struct ad9144_dev *dev)
 {
+	struct ad9144_status_poll poll = {
+		.dev = dev,
+		.reg_addr = REG_CAL_CTRL,
+		.reg_mask = CAL_FIN | CAL_ACTIVE,
+		.exp_reg_data = CAL_FIN,
+	};
+	struct deadline dl;
 	uint32_t dac_mask;
 	unsigned int i;
-	int ret;
+	int32_t status = SUCCESS;
+	int32_t ret;
 
 	dac_mask = (1 << dev->num_converters) - 1;
 
@@ -606,19 +732,24 @@ int32_t ad9144_dac_calibrate(struct ad9144_dev *dev)
 	ad9144_spi_write(dev, REG_CAL_INDX, dac_mask);	// select all active DACs
 	ad9144_spi_write(dev, REG_CAL_CTRL, 0x01);	// single cal enable
 	ad9144_spi_write(dev, REG_CAL_CTRL, 0x03);	// single cal start
-	mdelay(10);
 
+	/* All DACs calibrate in parallel, so they share one deadline */
+	deadline_set(&dl, AD9144_CAL_TIMEOUT_US);
 	for (i = 0; i < dev->num_converters; i++) {
 		ad9144_spi_write(dev, REG_CAL_INDX, BIT(i));	// read dac-i
 
-		ret = ad9144_spi_check_status(dev, REG_CAL_CTRL, 0xc0, 0x80);
-		if (ret == -1)
+		ret = poll_until(ad9144_status_reached, &poll,
+				 deadline_remaining_us(&dl),
+				 AD9144_CAL_MAX_SLEEP_US);
+		if (ret < 0) {
 			printf("%s: dac-%d calibration failed!\n", __func__, i);
+			status = ret;
+		}
 	}
 
 	ad9144_spi_write(dev, REG_CAL_CLKDIV, 0x30);	// turn off cal clock
 
-	return 0;
+	return status;
 }
 
 /***************************************************************************//**
@@ -708,7 +839,7 @@ int32_t ad9144_short_pattern_test(struct ad9144_dev *dev,
 			ret = ad9144_spi_check_status(dev,
 						      REG_SHORT_TPL_TEST_3,
 						      0x01, 0x00);
-			if (ret == -1)
+			if (ret < 0)
 				printf("%s : short-pattern-test mismatch (0x%x, 0x%x 0x%x, 0x%x)!.\n",
 				       __func__, dac, sample,
 				       init_param->stpl_samples[dac][sample],
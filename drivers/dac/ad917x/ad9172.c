@@ -48,6 +48,9 @@
 #include "ad9172.h"
 #include <inttypes.h>
 
+/* Longest transfer issued by the ad917x API: address and one data byte */
+#define AD9172_SPI_XFER_MAX	3
+
 /**
  * Setup the device.
  * @param st - The device structure.
@@ -274,16 +277,18 @@ static int32_t ad9172_spi_xfer(void *user_data, uint8_t *wbuf,
 {
 	int32_t ret;
 	struct spi_desc *spi = user_data;
-	uint8_t * buffer = (uint8_t *) malloc(len);
+	uint8_t buffer[AD9172_SPI_XFER_MAX];
+
+	if (len > AD9172_SPI_XFER_MAX)
+		return -EINVAL;
 
-	memcpy(buffer, wbuf, 3);
+	memcpy(buffer, wbuf, len);
 	ret = spi_write_and_read(spi, buffer, len);
 	if (ret < 0) {
 		printf("Read Error %"PRId32, ret);
 	} else {
 		memcpy(rbuf, buffer, len);
 	}
-	free(buffer);
 
 	return ret;
 }
@@ -262,10 +262,14 @@ static int32_t adf4371_write_bulk(struct adf4371_dev *dev,
 				  uint8_t *val,
 				  uint8_t size)
 {
-	uint8_t buf[10];
+	/* Command word and up to 10 registers */
+	uint8_t buf[12];
 	uint16_t cmd;
 	uint8_t i;
 
+	if (size > ARRAY_SIZE(buf) - 2)
+		return -EINVAL;
+
 	cmd = ADF4371_WRITE | ADF4371_ADDR(reg);
 	buf[0] = cmd >> 8;
 	buf[1] = cmd & 0xFF;
@@ -381,7 +385,6 @@ static void adf4371_pll_fract_n_compute(uint64_t vco,
 					uint32_t *mod2)
 {
 	uint64_t tmp;
-	uint32_t gcd_div;
 
 	tmp = do_div(&vco, pfd);
 	tmp = tmp * ADF4371_MODULUS1;
@@ -390,16 +393,21 @@ static void adf4371_pll_fract_n_compute(uint64_t vco,
 	*integer = vco;
 	*fract1 = tmp;
 
-	*mod2 = pfd;
-
-	while (*mod2 > ADF4371_MAX_MODULUS2) {
-		*mod2 >>= 1;
-		*fract2 >>= 1;
+	/* Closest FRAC2 / MOD2 to the remainder that fits the 14-bit fields */
+	rational_best_approximation(*fract2, pfd,
+				    ADF4371_MAX_MODULUS2 - 1,
+				    ADF4371_MAX_MODULUS2 - 1,
+				    fract2, mod2);
+
+	/* A remainder close to one PFD period rounds to 1/1: carry it */
+	if (*fract2 >= *mod2) {
+		*fract2 = 0;
+		*mod2 = 1;
+		if (++(*fract1) == ADF4371_MODULUS1) {
+			*fract1 = 0;
+			(*integer)++;
+		}
 	}
-
-	gcd_div = greatest_common_divisor(*fract2, *mod2);
-	*mod2 /= gcd_div;
-	*fract2 /= gcd_div;
 }
 
 /**
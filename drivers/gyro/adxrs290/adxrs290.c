@@ -249,6 +249,58 @@ int32_t adxrs290_get_temp_data(struct adxrs290_dev *dev, int16_t *temp)
 	return ret;
 }
 
+/**
+ * @brief Read the data channels in one SPI transaction.
+ *
+ * The register address auto increments, so the channels are read in the
+ * order X, Y, temperature, starting from ADXRS290_REG_DATAX0. Reading the
+ * data also clears the data ready output.
+ * @param dev - Device handler.
+ * @param burst_data - Channel values, ch_cnt elements. The temperature is
+ * sign extended from 12 bits.
+ * @param ch_cnt - Number of channels to read, 1 to ADXRS290_CHANNEL_COUNT.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adxrs290_get_burst_data(struct adxrs290_dev *dev, int16_t *burst_data,
+				uint8_t ch_cnt)
+{
+	uint8_t data[1 + ADXRS290_CHANNEL_COUNT * 2] = { 0 };
+	int32_t ret;
+	uint8_t i;
+
+	if (!ch_cnt || ch_cnt > ADXRS290_CHANNEL_COUNT)
+		return -EINVAL;
+
+	data[0] = ADXRS290_READ_REG(ADXRS290_REG_DATAX0);
+	ret = spi_write_and_read(dev->spi_desc, data, 1 + ch_cnt * 2);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	for (i = 0; i < ch_cnt; i++)
+		burst_data[i] = ((int16_t)data[2 + i * 2] << 8) | data[1 + i * 2];
+
+	if (ch_cnt > ADXRS290_CHANNEL_TEMP)
+		burst_data[ADXRS290_CHANNEL_TEMP] =
+			(int16_t)(burst_data[ADXRS290_CHANNEL_TEMP] << 4) >> 4;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Enable or disable the data ready output.
+ *
+ * When enabled, the SYNC pin goes high when new data is available and low
+ * after it is read.
+ * @param dev - Device handler.
+ * @param enable - true to route data ready to the SYNC pin, false to disable.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adxrs290_set_data_ready(struct adxrs290_dev *dev, bool enable)
+{
+	return adxrs290_reg_write(dev, ADXRS290_REG_DATA_READY,
+				  enable ? ADXRS290_SYNC(ADXRS290_DATA_RDY_OUT) : 0);
+}
+
 /**
  * Initialize the device.
  * @param device - The device structure.
@@ -91,6 +91,9 @@
 #define ADXRS290_READ_REG(reg)	(ADXRS290_READ | (reg))
 
 #define ADXRS290_MAX_TRANSITION_TIME_MS 100
+
+/* Number of data channels, X, Y and temperature */
+#define ADXRS290_CHANNEL_COUNT			3
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -211,6 +214,13 @@ int32_t adxrs290_get_rate_data(struct adxrs290_dev *dev,
 /* Read Temperature data */
 int32_t adxrs290_get_temp_data(struct adxrs290_dev *dev, int16_t *temp);
 
+/* Read the data channels, starting with X, in one SPI transaction */
+int32_t adxrs290_get_burst_data(struct adxrs290_dev *dev, int16_t *burst_data,
+				uint8_t ch_cnt);
+
+/* Enable or disable the data ready output on the SYNC pin */
+int32_t adxrs290_set_data_ready(struct adxrs290_dev *dev, bool enable);
+
 /* Init. the comm. peripheral and checks if the ADXRS290 part is present. */
 int32_t adxrs290_init(struct adxrs290_dev **device,
 		      const struct adxrs290_init_param *init_param);
@@ -109,3 +109,70 @@ int32_t i2c_read(struct i2c_desc *desc,
 	return desc->platform_ops->i2c_ops_read(desc, data, bytes_number,
 						stop_bit);
 }
+
+/**
+ * @brief Write data to a slave device, then read from it after a repeated
+ *        start. Platforms without a combined operation do an I2C write with
+ *        no stop condition followed by an I2C read.
+ * @param desc - The I2C descriptor.
+ * @param tx_data - The buffer with the transmitted data.
+ * @param tx_bytes - Number of bytes to write.
+ * @param rx_data - The buffer with the received data.
+ * @param rx_bytes - Number of bytes to read.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t i2c_write_read(struct i2c_desc *desc,
+		       uint8_t *tx_data,
+		       uint8_t tx_bytes,
+		       uint8_t *rx_data,
+		       uint8_t rx_bytes)
+{
+	int32_t ret;
+
+	if (desc->platform_ops->i2c_ops_write_read)
+		return desc->platform_ops->i2c_ops_write_read(desc, tx_data,
+				tx_bytes, rx_data, rx_bytes);
+
+	ret = desc->platform_ops->i2c_ops_write(desc, tx_data, tx_bytes, 0);
+	if (ret != SUCCESS)
+		return ret;
+
+	return desc->platform_ops->i2c_ops_read(desc, rx_data, rx_bytes, 1);
+}
+
+/**
+ * @brief Execute a combined transaction made of several messages, separated
+ *        by repeated starts. Platforms without a combined operation execute
+ *        the messages one by one, with a stop condition after the last one.
+ * @param desc - The I2C descriptor.
+ * @param msgs - The messages.
+ * @param msgs_no - Number of messages.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t i2c_transfer(struct i2c_desc *desc,
+		     struct i2c_xfer_msg *msgs,
+		     uint32_t msgs_no)
+{
+	uint8_t stop_bit;
+	uint32_t i;
+	int32_t ret;
+
+	if (desc->platform_ops->i2c_ops_transfer)
+		return desc->platform_ops->i2c_ops_transfer(desc, msgs, msgs_no);
+
+	for (i = 0; i < msgs_no; i++) {
+		stop_bit = (i == msgs_no - 1);
+		if (msgs[i].flags & I2C_XFER_READ)
+			ret = desc->platform_ops->i2c_ops_read(desc, msgs[i].buf,
+							       msgs[i].len,
+							       stop_bit);
+		else
+			ret = desc->platform_ops->i2c_ops_write(desc, msgs[i].buf,
+								msgs[i].len,
+								stop_bit);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	return SUCCESS;
+}
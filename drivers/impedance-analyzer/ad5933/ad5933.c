@@ -42,6 +42,8 @@
 /*****************************************************************************/
 #include <stdlib.h>
 #include "ad5933.h"
+#include "delay.h"
+#include "error.h"
 #include <math.h>
 
 /******************************************************************************/
@@ -73,7 +75,7 @@ int32_t ad5933_init(struct ad5933_dev **device,
 	struct ad5933_dev *dev;
 	int32_t status;
 
-	dev = (struct ad5933_dev *)malloc(sizeof(*dev));
+	dev = (struct ad5933_dev *)calloc(1, sizeof(*dev));
 	if (!dev)
 		return -1;
 
@@ -107,6 +109,53 @@ int32_t ad5933_remove(struct ad5933_dev *dev)
 	return status;
 }
 
+/***************************************************************************//**
+ * @brief Sets the address pointer.
+ *
+ * @param dev              - The device structure.
+ * @param register_address - Address of the register.
+ *
+ * @return ret - The result of the I2C transfer.
+*******************************************************************************/
+static int32_t ad5933_set_pointer(struct ad5933_dev *dev,
+				  uint8_t register_address)
+{
+	uint8_t write_data[2] = {AD5933_ADDR_POINTER, register_address};
+	int32_t ret;
+
+	ret = i2c_write(dev->i2c_desc, write_data, 2, 1);
+	dev->reg_pointer = (ret == SUCCESS) ? register_address : 0;
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Reads consecutive registers with a single block read.
+ *
+ * @param dev              - The device structure.
+ * @param register_address - Address of the first register.
+ * @param data             - Buffer receiving the register values.
+ * @param bytes_number     - Number of bytes.
+ *
+ * @return ret - The result of the I2C transfers.
+*******************************************************************************/
+static int32_t ad5933_block_read(struct ad5933_dev *dev,
+				 uint8_t register_address,
+				 uint8_t *data,
+				 uint8_t bytes_number)
+{
+	uint8_t write_data[2] = {AD5933_BLOCK_READ, bytes_number};
+	int32_t ret;
+
+	ret = ad5933_set_pointer(dev, register_address);
+	if (ret != SUCCESS)
+		return ret;
+	/* The block read moves the address pointer. */
+	dev->reg_pointer = 0;
+
+	return i2c_write_read(dev->i2c_desc, write_data, 2, data, bytes_number);
+}
+
 /***************************************************************************//**
  * @brief Writes data into a register.
  *
@@ -123,13 +172,26 @@ void ad5933_set_register_value(struct ad5933_dev *dev,
 			       uint8_t bytes_number)
 {
 	uint8_t byte = 0;
-	uint8_t write_data[2] = {0, 0};
+	uint8_t write_data[6] = {0, 0, 0, 0, 0, 0};
 
-	for(byte = 0; byte < bytes_number; byte++) {
-		write_data[0] = register_address + bytes_number - byte - 1;
-		write_data[1] = (uint8_t)((register_value >> (byte * 8)) & 0xFF);
+	if(bytes_number == 1) {
+		write_data[0] = register_address;
+		write_data[1] = (uint8_t)(register_value & 0xFF);
+		dev->reg_pointer = 0;
 		i2c_write(dev->i2c_desc, write_data, 2, 1);
+		return;
 	}
+
+	/* Multi-byte registers are written MSB first with one block write. */
+	if(ad5933_set_pointer(dev, register_address) != SUCCESS)
+		return;
+	write_data[0] = AD5933_BLOCK_WRITE;
+	write_data[1] = bytes_number;
+	for(byte = 0; byte < bytes_number; byte++)
+		write_data[2 + byte] = (uint8_t)((register_value >>
+						  ((bytes_number - byte - 1) * 8)) & 0xFF);
+	dev->reg_pointer = 0;
+	i2c_write(dev->i2c_desc, write_data, bytes_number + 2, 1);
 }
 
 /***************************************************************************//**
@@ -147,24 +209,79 @@ uint32_t ad5933_get_register_value(struct ad5933_dev *dev,
 {
 	uint32_t register_value = 0;
 	uint8_t byte = 0;
-	uint8_t write_data[2]   = {0, 0};
-	uint8_t read_data[2]    = {0, 0};
+	uint8_t read_data[4]    = {0, 0, 0, 0};
 
-	for(byte = 0; byte < bytes_number; byte ++) {
+	if(bytes_number == 1) {
 		/* Set the register pointer. */
-		write_data[0] = AD5933_ADDR_POINTER;
-		write_data[1] = register_address + byte;
-		i2c_write(dev->i2c_desc, write_data, 2, 1);
+		if(dev->reg_pointer != register_address)
+			ad5933_set_pointer(dev, register_address);
 		/* Read Register Data. */
 		read_data[0] = 0xFF;
 		i2c_read(dev->i2c_desc, read_data, 1, 1);
+
+		return read_data[0];
+	}
+
+	ad5933_block_read(dev, register_address, read_data, bytes_number);
+	for(byte = 0; byte < bytes_number; byte ++) {
 		register_value = register_value << 8;
-		register_value += read_data[0];
+		register_value += read_data[byte];
 	}
 
 	return register_value;
 }
 
+/***************************************************************************//**
+ * @brief Waits for a status flag to be set.
+ *
+ * @param dev  - The device structure.
+ * @param mask - Status flags to wait for.
+ *               Example: AD5933_STAT_TEMP_VALID
+ *                        AD5933_STAT_DATA_VALID
+ *
+ * @return ret - SUCCESS when a flag is set, -ETIMEDOUT if none was set within
+ *               AD5933_STATUS_TIMEOUT_US.
+*******************************************************************************/
+static int32_t ad5933_wait_status(struct ad5933_dev *dev,
+				  uint8_t mask)
+{
+	uint32_t timeout = AD5933_STATUS_TIMEOUT_US / AD5933_POLL_DELAY_US;
+	uint8_t status;
+
+	do {
+		status = ad5933_get_register_value(dev, AD5933_REG_STATUS, 1);
+		if(status & mask)
+			return SUCCESS;
+		udelay(AD5933_POLL_DELAY_US);
+	} while(--timeout);
+
+	return -ETIMEDOUT;
+}
+
+/***************************************************************************//**
+ * @brief Reads the real and the imaginary data with a single block read.
+ *
+ * @param dev    - The device structure.
+ * @param result - The result structure.
+ *
+ * @return ret - The result of the I2C transfers.
+*******************************************************************************/
+static int32_t ad5933_read_result(struct ad5933_dev *dev,
+				  struct ad5933_result *result)
+{
+	uint8_t read_data[4];
+	int32_t ret;
+
+	ret = ad5933_block_read(dev, AD5933_REG_REAL_DATA, read_data, 4);
+	if(ret != SUCCESS)
+		return ret;
+
+	result->real = (int16_t)((read_data[0] << 8) | read_data[1]);
+	result->imag = (int16_t)((read_data[2] << 8) | read_data[3]);
+
+	return SUCCESS;
+}
+
 /***************************************************************************//**
  * @brief Resets the device.
  *
@@ -245,12 +362,12 @@ void ad5933_set_range_and_gain(struct ad5933_dev *dev,
  *
  * @param dev             - The device structure.
  *
- * @return temperature - Temperature.
+ * @return temperature - Temperature, NAN if the conversion did not complete
+ *                       within AD5933_STATUS_TIMEOUT_US.
 *******************************************************************************/
 float ad5933_get_temperature(struct ad5933_dev *dev)
 {
 	float temperature = 0;
-	uint8_t status = 0;
 
 	ad5933_set_register_value(dev,
 				  AD5933_REG_CONTROL_HB,
@@ -258,11 +375,8 @@ float ad5933_get_temperature(struct ad5933_dev *dev)
 				  AD5933_CONTROL_RANGE(dev->current_range) |
 				  AD5933_CONTROL_PGA_GAIN(dev->current_gain),
 				  1);
-	while((status & AD5933_STAT_TEMP_VALID) == 0) {
-		status = ad5933_get_register_value(dev,
-						   AD5933_REG_STATUS,
-						   1);
-	}
+	if(ad5933_wait_status(dev, AD5933_STAT_TEMP_VALID) != SUCCESS)
+		return NAN;
 
 	temperature = ad5933_get_register_value(dev,
 						AD5933_REG_TEMP_DATA,
@@ -332,12 +446,11 @@ void ad5933_config_sweep(struct ad5933_dev *dev,
  *
  * @param dev             - The device structure.
  *
- * @return None.
+ * @return ret - SUCCESS when the first point is valid, -ETIMEDOUT if it was
+ *               not within AD5933_STATUS_TIMEOUT_US.
 *******************************************************************************/
-void ad5933_start_sweep(struct ad5933_dev *dev)
+int32_t ad5933_start_sweep(struct ad5933_dev *dev)
 {
-	uint8_t status = 0;
-
 	ad5933_set_register_value(dev,
 				  AD5933_REG_CONTROL_HB,
 				  AD5933_CONTROL_FUNCTION(AD5933_FUNCTION_STANDBY) |
@@ -357,12 +470,8 @@ void ad5933_start_sweep(struct ad5933_dev *dev)
 				  AD5933_CONTROL_RANGE(dev->current_range) |
 				  AD5933_CONTROL_PGA_GAIN(dev->current_gain),
 				  1);
-	status = 0;
-	while((status & AD5933_STAT_DATA_VALID) == 0) {
-		status = ad5933_get_register_value(dev,
-						   AD5933_REG_STATUS,
-						   1);
-	};
+
+	return ad5933_wait_status(dev, AD5933_STAT_DATA_VALID);
 }
 
 /***************************************************************************//**
@@ -376,17 +485,17 @@ void ad5933_start_sweep(struct ad5933_dev *dev)
  *                                        AD5933_FUNCTION_REPEAT_FREQ - Repeat
                                           freq..
  *
- * @return gainFactor          - Calculated gain factor.
+ * @return gainFactor          - Calculated gain factor, NAN if the data was
+ *                               not valid within AD5933_STATUS_TIMEOUT_US or
+ *                               could not be read.
 *******************************************************************************/
 double ad5933_calculate_gain_factor(struct ad5933_dev *dev,
 				    uint32_t calibration_impedance,
 				    uint8_t freq_function)
 {
+	struct ad5933_result result = {0, 0};
 	double gain_factor = 0;
 	double magnitude = 0;
-	signed short real_data = 0;
-	signed short imag_data = 0;
-	uint8_t status = 0;
 
 	ad5933_set_register_value(dev,
 				  AD5933_REG_CONTROL_HB,
@@ -394,19 +503,12 @@ double ad5933_calculate_gain_factor(struct ad5933_dev *dev,
 				  AD5933_CONTROL_RANGE(dev->current_range) |
 				  AD5933_CONTROL_PGA_GAIN(dev->current_gain),
 				  1);
-	status = 0;
-	while((status & AD5933_STAT_DATA_VALID) == 0) {
-		status = ad5933_get_register_value(dev,
-						   AD5933_REG_STATUS,
-						   1);
-	}
-	real_data = ad5933_get_register_value(dev,
-					      AD5933_REG_REAL_DATA,
-					      2);
-	imag_data = ad5933_get_register_value(dev,
-					      AD5933_REG_IMAG_DATA,
-					      2);
-	magnitude = sqrt((real_data * real_data) + (imag_data * imag_data));
+	if(ad5933_wait_status(dev, AD5933_STAT_DATA_VALID) != SUCCESS)
+		return NAN;
+	if(ad5933_read_result(dev, &result) != SUCCESS)
+		return NAN;
+	magnitude = sqrt(((double)result.real * result.real) +
+			 ((double)result.imag * result.imag));
 	gain_factor = 1 / (magnitude * calibration_impedance);
 
 	return gain_factor;
@@ -421,17 +523,16 @@ double ad5933_calculate_gain_factor(struct ad5933_dev *dev,
  *                       Example: AD5933_FUNCTION_INC_FREQ - Increment freq.;
  *                                AD5933_FUNCTION_REPEAT_FREQ - Repeat freq..
  *
- * @return impedance   - Calculated impedance.
+ * @return impedance   - Calculated impedance, NAN if the data was not valid
+ *                       within AD5933_STATUS_TIMEOUT_US or could not be read.
 *******************************************************************************/
 double ad5933_calculate_impedance(struct ad5933_dev *dev,
 				  double gain_factor,
 				  uint8_t freq_function)
 {
-	signed short real_data = 0;
-	signed short imag_data = 0;
+	struct ad5933_result result = {0, 0};
 	double magnitude = 0;
 	double impedance = 0;
-	uint8_t status = 0;
 
 	ad5933_set_register_value(dev,
 				  AD5933_REG_CONTROL_HB,
@@ -439,21 +540,236 @@ double ad5933_calculate_impedance(struct ad5933_dev *dev,
 				  AD5933_CONTROL_RANGE(dev->current_range) |
 				  AD5933_CONTROL_PGA_GAIN(dev->current_gain),
 				  1);
-	status = 0;
-	while((status & AD5933_STAT_DATA_VALID) == 0) {
-		status = ad5933_get_register_value(dev,
-						   AD5933_REG_STATUS,
-						   1);
-	}
-	real_data = ad5933_get_register_value(dev,
-					      AD5933_REG_REAL_DATA,
-					      2);
-	imag_data = ad5933_get_register_value(dev,
-					      AD5933_REG_IMAG_DATA,
-					      2);
-	magnitude = sqrt((real_data * real_data) + (imag_data * imag_data));
+	if(ad5933_wait_status(dev, AD5933_STAT_DATA_VALID) != SUCCESS)
+		return NAN;
+	if(ad5933_read_result(dev, &result) != SUCCESS)
+		return NAN;
+	magnitude = sqrt(((double)result.real * result.real) +
+			 ((double)result.imag * result.imag));
 
 	impedance =  1 / (magnitude * gain_factor);
 
 	return impedance;
 }
+
+/***************************************************************************//**
+ * @brief Writes the control function, keeping the range and gain settings.
+ *
+ * @param dev      - The device structure.
+ * @param function - Control function.
+ *
+ * @return None.
+*******************************************************************************/
+static void ad5933_set_function(struct ad5933_dev *dev,
+				uint8_t function)
+{
+	ad5933_set_register_value(dev,
+				  AD5933_REG_CONTROL_HB,
+				  AD5933_CONTROL_FUNCTION(function) |
+				  AD5933_CONTROL_RANGE(dev->current_range) |
+				  AD5933_CONTROL_PGA_GAIN(dev->current_gain),
+				  1);
+}
+
+/***************************************************************************//**
+ * @brief Starts a sweep without waiting for the results. The sweep is advanced
+ *        by ad5933_sweep_poll(), which stores the raw result of each
+ *        frequency point in the results buffer.
+ *
+ * @param dev       - The device structure.
+ * @param results   - Buffer receiving the results. Must stay valid until the
+ *                    sweep is done.
+ * @param points_no - Number of frequency points, at most the number of
+ *                    increments set by ad5933_config_sweep() + 1.
+ *
+ * @return ret - SUCCESS or -EINVAL for invalid parameters.
+*******************************************************************************/
+int32_t ad5933_sweep_start(struct ad5933_dev *dev,
+			   struct ad5933_result *results,
+			   uint16_t points_no)
+{
+	if(!dev || !results || !points_no ||
+	    (points_no > AD5933_MAX_INC_NUM + 1))
+		return -EINVAL;
+
+	dev->sweep_results = results;
+	dev->sweep_points = points_no;
+	dev->sweep_index = 0;
+	dev->sweep_state = AD5933_SWEEP_BUSY;
+
+	ad5933_set_function(dev, AD5933_FUNCTION_STANDBY);
+	ad5933_reset(dev);
+	ad5933_set_function(dev, AD5933_FUNCTION_INIT_START_FREQ);
+	ad5933_set_function(dev, AD5933_FUNCTION_START_SWEEP);
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief Advances the sweep started by ad5933_sweep_start(). Each call reads
+ *        the status once. When the current point is valid, its real and
+ *        imaginary data are read with one block read and the frequency is
+ *        incremented.
+ *
+ * @param dev       - The device structure.
+ * @param points_no - Number of results stored so far. May be NULL.
+ *
+ * @return ret - SUCCESS when the sweep is done, -EAGAIN while it is in
+ *               progress, negative error code otherwise.
+*******************************************************************************/
+int32_t ad5933_sweep_poll(struct ad5933_dev *dev,
+			  uint16_t *points_no)
+{
+	uint8_t status;
+	int32_t ret;
+
+	if(!dev || (dev->sweep_state == AD5933_SWEEP_IDLE))
+		return -EINVAL;
+
+	if(dev->sweep_state == AD5933_SWEEP_BUSY) {
+		status = ad5933_get_register_value(dev, AD5933_REG_STATUS, 1);
+		if(!(status & AD5933_STAT_DATA_VALID)) {
+			ret = -EAGAIN;
+			goto out;
+		}
+
+		ret = ad5933_read_result(dev,
+					 &dev->sweep_results[dev->sweep_index]);
+		if(ret != SUCCESS)
+			goto out;
+		dev->sweep_index++;
+
+		if((dev->sweep_index == dev->sweep_points) ||
+		    (status & AD5933_STAT_SWEEP_DONE)) {
+			dev->sweep_state = AD5933_SWEEP_DONE;
+		} else {
+			ad5933_set_function(dev, AD5933_FUNCTION_INC_FREQ);
+			ret = -EAGAIN;
+			goto out;
+		}
+	}
+	ret = SUCCESS;
+out:
+	if(points_no)
+		*points_no = dev->sweep_index;
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Stops the sweep and puts the device in standby.
+ *
+ * @param dev - The device structure.
+ *
+ * @return ret - SUCCESS or -EINVAL for invalid parameters.
+*******************************************************************************/
+int32_t ad5933_sweep_stop(struct ad5933_dev *dev)
+{
+	if(!dev)
+		return -EINVAL;
+
+	ad5933_set_function(dev, AD5933_FUNCTION_STANDBY);
+	dev->sweep_state = AD5933_SWEEP_IDLE;
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief Calculates the magnitude of the sweep results.
+ *
+ * @param results   - The sweep results.
+ * @param magnitude - Buffer receiving the magnitudes.
+ * @param points_no - Number of results.
+ *
+ * @return None.
+*******************************************************************************/
+void ad5933_calc_magnitude(const struct ad5933_result *results,
+			   float *magnitude,
+			   uint16_t points_no)
+{
+	uint16_t i;
+
+	for(i = 0; i < points_no; i++)
+		magnitude[i] = sqrtf((float)results[i].real * results[i].real +
+				     (float)results[i].imag * results[i].imag);
+}
+
+/***************************************************************************//**
+ * @brief Calculates the gain factor of each sweep result, measured on the
+ *        calibration impedance.
+ *
+ * @param results               - The sweep results.
+ * @param calibration_impedance - The calibration impedance value.
+ * @param gain_factor           - Buffer receiving the gain factors.
+ * @param points_no             - Number of results.
+ *
+ * @return None.
+*******************************************************************************/
+void ad5933_calc_gain_factor(const struct ad5933_result *results,
+			     uint32_t calibration_impedance,
+			     float *gain_factor,
+			     uint16_t points_no)
+{
+	float impedance = calibration_impedance;
+	uint16_t i;
+
+	ad5933_calc_magnitude(results, gain_factor, points_no);
+	for(i = 0; i < points_no; i++)
+		gain_factor[i] = 1 / (gain_factor[i] * impedance);
+}
+
+/***************************************************************************//**
+ * @brief Calculates the impedance of each sweep result.
+ *
+ * @param results     - The sweep results.
+ * @param gain_factor - The gain factors.
+ * @param gain_no     - Number of gain factors: 1 to use the same gain factor
+ *                      for all the results, points_no for one gain factor per
+ *                      result.
+ * @param impedance   - Buffer receiving the impedances.
+ * @param points_no   - Number of results.
+ *
+ * @return None.
+*******************************************************************************/
+void ad5933_calc_impedance(const struct ad5933_result *results,
+			   const float *gain_factor,
+			   uint16_t gain_no,
+			   float *impedance,
+			   uint16_t points_no)
+{
+	uint16_t i;
+
+	ad5933_calc_magnitude(results, impedance, points_no);
+	if(gain_no == 1) {
+		for(i = 0; i < points_no; i++)
+			impedance[i] = 1 / (impedance[i] * gain_factor[0]);
+	} else {
+		for(i = 0; i < points_no; i++)
+			impedance[i] = 1 / (impedance[i] * gain_factor[i]);
+	}
+}
+
+/***************************************************************************//**
+ * @brief Calculates the phase of each sweep result, in radians.
+ *
+ * @param results      - The sweep results.
+ * @param system_phase - The system phase of each result, measured on the
+ *                       calibration impedance. NULL to skip the correction.
+ * @param phase        - Buffer receiving the phases.
+ * @param points_no    - Number of results.
+ *
+ * @return None.
+*******************************************************************************/
+void ad5933_calc_phase(const struct ad5933_result *results,
+		       const float *system_phase,
+		       float *phase,
+		       uint16_t points_no)
+{
+	uint16_t i;
+
+	for(i = 0; i < points_no; i++)
+		phase[i] = atan2f(results[i].imag, results[i].real);
+	if(system_phase)
+		for(i = 0; i < points_no; i++)
+			phase[i] -= system_phase[i];
+}
@@ -108,10 +108,26 @@
 #define AD5933_INTERNAL_SYS_CLK     16000000ul      // 16MHz
 #define AD5933_MAX_INC_NUM          511             // Maximum increment number
 
+/* Status polling */
+#define AD5933_POLL_DELAY_US        100
+#define AD5933_STATUS_TIMEOUT_US    5000000ul
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+enum ad5933_sweep_state {
+	AD5933_SWEEP_IDLE,
+	AD5933_SWEEP_BUSY,
+	AD5933_SWEEP_DONE
+};
+
+/* Raw DFT result of one frequency point. */
+struct ad5933_result {
+	int16_t real;
+	int16_t imag;
+};
+
 struct ad5933_dev {
 	/* I2C */
 	i2c_desc	*i2c_desc;
@@ -120,6 +136,13 @@ struct ad5933_dev {
 	uint8_t current_clock_source;
 	uint8_t current_gain;
 	uint8_t current_range;
+	/* Register selected by the address pointer, 0 if unknown */
+	uint8_t reg_pointer;
+	/* Sweep */
+	enum ad5933_sweep_state sweep_state;
+	struct ad5933_result *sweep_results;
+	uint16_t sweep_points;
+	uint16_t sweep_index;
 };
 
 struct ad5933_init_param {
@@ -177,7 +200,7 @@ void ad5933_config_sweep(struct ad5933_dev *dev,
 			 uint16_t inc_num);
 
 /*! Starts the sweep operation. */
-void ad5933_start_sweep(struct ad5933_dev *dev);
+int32_t ad5933_start_sweep(struct ad5933_dev *dev);
 
 /*! Reads the real and the imaginary data and calculates the Gain Factor. */
 double ad5933_calculate_gain_factor(struct ad5933_dev *dev,
@@ -189,4 +212,40 @@ double ad5933_calculate_impedance(struct ad5933_dev *dev,
 				  double gain_factor,
 				  uint8_t freq_function);
 
+/*! Starts a sweep without waiting for the results. */
+int32_t ad5933_sweep_start(struct ad5933_dev *dev,
+			   struct ad5933_result *results,
+			   uint16_t points_no);
+
+/*! Advances the sweep started by ad5933_sweep_start(). */
+int32_t ad5933_sweep_poll(struct ad5933_dev *dev,
+			  uint16_t *points_no);
+
+/*! Stops the sweep and puts the device in standby. */
+int32_t ad5933_sweep_stop(struct ad5933_dev *dev);
+
+/*! Calculates the magnitude of the sweep results. */
+void ad5933_calc_magnitude(const struct ad5933_result *results,
+			   float *magnitude,
+			   uint16_t points_no);
+
+/*! Calculates the gain factor of each sweep result. */
+void ad5933_calc_gain_factor(const struct ad5933_result *results,
+			     uint32_t calibration_impedance,
+			     float *gain_factor,
+			     uint16_t points_no);
+
+/*! Calculates the impedance of each sweep result. */
+void ad5933_calc_impedance(const struct ad5933_result *results,
+			   const float *gain_factor,
+			   uint16_t gain_no,
+			   float *impedance,
+			   uint16_t points_no);
+
+/*! Calculates the phase of each sweep result. */
+void ad5933_calc_phase(const struct ad5933_result *results,
+		       const float *system_phase,
+		       float *phase,
+		       uint16_t points_no);
+
 #endif /* __AD5933_H__ */
@@ -52,43 +52,72 @@
 /******************************************************************************/
 
 /**
- * @brief Read device register.
+ * @brief Read consecutive bytes starting from a device register.
  * @param dev - Device handler.
  * @param address - Register address.
- * @param data - Pointer to the register value container.
+ * @param buff - Pointer to the data container. The first two bytes are used
+ *               for the register address, the data follows them.
+ * @param bytes_no - Number of data bytes to read.
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
-int32_t adpd410x_reg_read(struct adpd410x_dev *dev, uint16_t address,
-			  uint16_t *data)
+static int32_t adpd410x_read_burst(struct adpd410x_dev *dev, uint16_t address,
+				   uint8_t *buff, uint16_t bytes_no)
 {
 	int32_t ret;
-	uint8_t buff[] = {0, 0, 0, 0};
+	uint16_t offset, reg;
+	uint8_t addr[2], chunk;
 
 	switch (dev->dev_type) {
 	case ADPD4100:
 		buff[0] = field_get(ADPD410X_UPPDER_BYTE_SPI_MASK, address);
 		buff[1] = (address << 1) & ADPD410X_LOWER_BYTE_SPI_MASK;
 
-		ret = spi_write_and_read(dev->dev_ops.spi_phy_dev, buff, 4);
-		if(ret != SUCCESS)
-			return ret;
-		break;
+		return spi_write_and_read(dev->dev_ops.spi_phy_dev, buff,
+					  bytes_no + 2);
 	case ADPD4101:
-		buff[0] = field_get(ADPD410X_UPPDER_BYTE_I2C_MASK, address);
-		buff[0] |= 0x80;
-		buff[1] = address & ADPD410X_LOWER_BYTE_I2C_MASK;
+		/**
+		 * An I2C read is at most 255 bytes long, longer bursts are
+		 * split and every chunk gets its own address phase. The FIFO
+		 * data register pops on every read, other registers continue
+		 * from the next address.
+		 */
+		for(offset = 0; offset < bytes_no; offset += chunk) {
+			chunk = min(bytes_no - offset, ADPD410X_I2C_MAX_READ);
+			reg = address;
+			if(address != ADPD410X_REG_FIFO_DATA)
+				reg += offset / 2;
+			addr[0] = field_get(ADPD410X_UPPDER_BYTE_I2C_MASK, reg);
+			addr[0] |= 0x80;
+			addr[1] = reg & ADPD410X_LOWER_BYTE_I2C_MASK;
+
+			ret = i2c_write_read(dev->dev_ops.i2c_phy_dev, addr, 2,
+					     buff + 2 + offset, chunk);
+			if(ret != SUCCESS)
+				return ret;
+		}
 
-		/* No stop bit */
-		ret = i2c_write(dev->dev_ops.i2c_phy_dev, buff, 2, 0);
-		if(ret != SUCCESS)
-			return ret;
-		ret = i2c_read(dev->dev_ops.i2c_phy_dev, (buff + 2), 2, 1);
-		if(ret != SUCCESS)
-			return ret;
-		break;
+		return SUCCESS;
 	default:
 		return FAILURE;
 	}
+}
+
+/**
+ * @brief Read device register.
+ * @param dev - Device handler.
+ * @param address - Register address.
+ * @param data - Pointer to the register value container.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t adpd410x_reg_read(struct adpd410x_dev *dev, uint16_t address,
+			  uint16_t *data)
+{
+	int32_t ret;
+	uint8_t buff[] = {0, 0, 0, 0};
+
+	ret = adpd410x_read_burst(dev, address, buff, 2);
+	if(ret != SUCCESS)
+		return ret;
 
 	*data = ((uint16_t)buff[2] << 8) & 0xff00;
 	*data |= buff[3] & 0xff;
@@ -96,6 +125,28 @@ int32_t adpd410x_reg_read(struct adpd410x_dev *dev, uint16_t address,
 	return SUCCESS;
 }
 
+/**
+ * @brief Check if a register takes part in the FIFO packet layout.
+ * @param address - Register address.
+ * @return true if writing the register may change the FIFO packet layout.
+ */
+static bool adpd410x_is_layout_reg(uint16_t address)
+{
+	uint16_t offset;
+
+	if(address == ADPD410X_REG_OPMODE)
+		return true;
+	if((address < ADPD410X_REG_TS_CTRL(0)) ||
+	    (address >= ADPD410X_REG_TS_CTRL(ADPD410X_MAX_SLOT_NUMBER)))
+		return false;
+
+	offset = address - ADPD410X_REG_TS_CTRL(0);
+	offset %= ADPD410X_REG_TS_CTRL(1) - ADPD410X_REG_TS_CTRL(0);
+
+	return (offset == 0) ||
+	       (offset == ADPD410X_REG_DATA1(0) - ADPD410X_REG_TS_CTRL(0));
+}
+
 /**
  * @brief Write device register.
  * @param dev - Device handler.
@@ -108,6 +159,9 @@ int32_t adpd410x_reg_write(struct adpd410x_dev *dev, uint16_t address,
 {
 	uint8_t buff[] = {0, 0, 0, 0};
 
+	if(adpd410x_is_layout_reg(address))
+		dev->layout_valid = false;
+
 	switch (dev->dev_type) {
 	case ADPD4100:
 		buff[0] = field_get(ADPD410X_UPPDER_BYTE_SPI_MASK, address);
@@ -186,6 +240,7 @@ int32_t adpd410x_reset(struct adpd410x_dev *dev)
 				      BITM_SYS_CTL_SW_RESET);
 	if(ret != SUCCESS)
 		return ret;
+	dev->layout_valid = false;
 
 	return adpd410x_get_clk_opt(dev);
 }
@@ -374,113 +429,121 @@ int32_t adpd410x_get_fifo_bytecount(struct adpd410x_dev *dev, uint16_t *bytes)
 }
 
 /**
- * @brief Get a data packet containing data from all active time slots and
- *        channels. adpd410x_get_data() helper function.
+ * @brief Read the time slot configuration and update the cached FIFO packet
+ *        layout. adpd410x_get_data() helper function.
  * @param dev - Device handler.
- * @param data - Pointer to the data container.
- * @param no_slots - Number of active time slots.
- * @param dual_chan - Mask showing which of the active time slots are dual
- *                    channeled and which are single channeled.
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
-static int32_t adpd410x_get_data_packet(struct adpd410x_dev *dev,
-					uint32_t *data, uint8_t no_slots,
-					uint16_t dual_chan)
+static int32_t adpd410x_update_layout(struct adpd410x_dev *dev)
 {
 	int32_t ret;
-	uint16_t j, temp_data, expect_byte_count = 0;
-	uint16_t *data_buff, sample_index;
-	int8_t i, got_one = 0;
-	uint8_t *slot_bytecount_tab, *data_byte_buff;
-
-	slot_bytecount_tab = (uint8_t *)calloc(no_slots,
-					       sizeof (*slot_bytecount_tab));
-	if (!slot_bytecount_tab)
-		return -ENOMEM;
-	for(i = 0; i < no_slots; i++) {
+	uint16_t temp_data;
+	uint8_t i, ts_no, slot_bytes;
+
+	ret = adpd410x_reg_read(dev, ADPD410X_REG_OPMODE, &temp_data);
+	if(ret != SUCCESS)
+		return ret;
+	ts_no = ((temp_data & BITM_OPMODE_TIMESLOT_EN) >>
+		 BITP_OPMODE_TIMESLOT_EN) + 1;
+	if(ts_no > ADPD410X_MAX_SLOT_NUMBER)
+		return -EINVAL;
+
+	dev->packet_samples = 0;
+	dev->packet_bytes = 0;
+	for(i = 0; i < ts_no; i++) {
 		ret = adpd410x_reg_read(dev, ADPD410X_REG_DATA1(i), &temp_data);
 		if(ret != SUCCESS)
-			goto error_slot;
-		slot_bytecount_tab[i] = (temp_data & BITM_DATA1_A_SIGNAL_SIZE);
-		expect_byte_count += slot_bytecount_tab[i];
-		if((dual_chan & (1 << i)) != 0)
-			expect_byte_count += slot_bytecount_tab[i];
-	}
-	if((expect_byte_count % 2) != 0)
-		expect_byte_count++;
-	data_buff = (uint16_t *)calloc((expect_byte_count / 2),
-				       sizeof (*data_buff));
-	if (!data_buff) {
-		ret = -ENOMEM;
-		goto error_slot;
-	}
-	data_byte_buff = (uint8_t *)calloc(expect_byte_count,
-					   sizeof (*data_byte_buff));
-	if (!data_byte_buff) {
-		ret = -ENOMEM;
-		goto error_data_buff;
-	}
+			return ret;
+		slot_bytes = (temp_data & BITM_DATA1_A_SIGNAL_SIZE) >>
+			     BITP_DATA1_A_SIGNAL_SIZE;
+		if(slot_bytes > ADPD410X_MAX_SAMPLE_BYTES)
+			return -EINVAL;
+		/* Time slots with no data bytes are not stored in the FIFO. */
+		if(slot_bytes == 0)
+			continue;
 
-	for(i = 0; i < (expect_byte_count / 2); i++) {
-		ret = adpd410x_reg_read(dev, ADPD410X_REG_FIFO_DATA,
-					(data_buff + i));
+		ret = adpd410x_reg_read(dev, ADPD410X_REG_TS_CTRL(i),
+					&temp_data);
 		if(ret != SUCCESS)
-			goto error_data_byte;
-	}
-	for(i = 0; i < (expect_byte_count / 2); i++) {
-		data_byte_buff[(i * 2)] = (data_buff[i] & 0xff00) >> 8;
-		data_byte_buff[(i * 2 + 1)] = data_buff[i] & 0xff;
-	}
+			return ret;
 
-	i = 0;
-	j = 0;
-	sample_index = 0;
-	do {
-		switch(slot_bytecount_tab[i]) {
-		case 0:
-			continue;
-		case 1:
-			data[sample_index] = data_byte_buff[j++];
-			break;
-		case 2:
-			data[sample_index]  = data_byte_buff[j++] << 8;
-			data[sample_index] |= data_byte_buff[j++];
-			break;
-		case 3:
-			data[sample_index]  = data_byte_buff[j++] << 8;
-			data[sample_index] |= data_byte_buff[j++];
-			data[sample_index] |= data_byte_buff[j++] << 16;
-			break;
-		case 4:
-			data[sample_index]  = data_byte_buff[j++] << 8;
-			data[sample_index] |= data_byte_buff[j++];
-			data[sample_index] |= data_byte_buff[j++] << 24;
-			data[sample_index] |= data_byte_buff[j++] << 16;
-			break;
+		dev->sample_bytes[dev->packet_samples++] = slot_bytes;
+		dev->packet_bytes += slot_bytes;
+		if((temp_data & BITM_TS_CTRL_A_CH2_EN) != 0) {
+			dev->sample_bytes[dev->packet_samples++] = slot_bytes;
+			dev->packet_bytes += slot_bytes;
 		}
-		sample_index++;
-		if(((dual_chan & (1 << i)) != 0) && (got_one == 0)) {
-			got_one = 1;
-		} else {
-			i++;
-			got_one = 0;
-		}
-	} while(i < no_slots);
+	}
+	dev->layout_valid = true;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Make sure the cached FIFO packet layout is up to date.
+ * @param dev - Device handler.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t adpd410x_check_layout(struct adpd410x_dev *dev)
+{
+	int32_t ret;
 
-	free(data_byte_buff);
-	free(data_buff);
-	free(slot_bytecount_tab);
+	if(!dev->layout_valid) {
+		ret = adpd410x_update_layout(dev);
+		if(ret != SUCCESS)
+			return ret;
+	}
+	if(dev->packet_bytes == 0)
+		return -EINVAL;
 
 	return SUCCESS;
+}
 
-error_data_byte:
-	free(data_byte_buff);
-error_data_buff:
-	free(data_buff);
-error_slot:
-	free(slot_bytecount_tab);
+/**
+ * @brief Read data packets from the FIFO with a single burst and decode them.
+ *        adpd410x_get_data() helper function.
+ * @param dev - Device handler.
+ * @param data - Pointer to the data container. Must hold packets_no times the
+ *               number of samples in a packet.
+ * @param packets_no - Number of packets to read. The packets must fit in
+ *                     ADPD410X_FIFO_SIZE bytes.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t adpd410x_read_packets(struct adpd410x_dev *dev, uint32_t *data,
+				     uint16_t packets_no)
+{
+	/* Position of each FIFO byte in the sample, by sample size. */
+	static const uint8_t
+	byte_shift[ADPD410X_MAX_SAMPLE_BYTES + 1][ADPD410X_MAX_SAMPLE_BYTES] = {
+		{0},
+		{0},
+		{8, 0},
+		{8, 0, 16},
+		{8, 0, 24, 16}
+	};
+	int32_t ret;
+	const uint8_t *shift, *byte;
+	uint16_t i;
+	uint8_t j, k, size;
 
-	return ret;
+	ret = adpd410x_read_burst(dev, ADPD410X_REG_FIFO_DATA, dev->fifo_buf,
+				  packets_no * dev->packet_bytes);
+	if(ret != SUCCESS)
+		return ret;
+
+	byte = dev->fifo_buf + 2;
+	for(i = 0; i < packets_no; i++) {
+		for(j = 0; j < dev->packet_samples; j++) {
+			size = dev->sample_bytes[j];
+			shift = byte_shift[size];
+			*data = 0;
+			for(k = 0; k < size; k++)
+				*data |= (uint32_t)*byte++ << shift[k];
+			data++;
+		}
+	}
+
+	return SUCCESS;
 }
 
 /**
@@ -493,26 +556,109 @@ error_slot:
 int32_t adpd410x_get_data(struct adpd410x_dev *dev, uint32_t *data)
 {
 	int32_t ret;
-	int8_t i;
-	uint16_t temp_data, dual_chan = 0;
-	uint8_t ts_no;
 
-	ret = adpd410x_reg_read(dev, ADPD410X_REG_OPMODE, &temp_data);
+	ret = adpd410x_check_layout(dev);
 	if(ret != SUCCESS)
 		return ret;
-	ts_no = ((temp_data & BITM_OPMODE_TIMESLOT_EN) >>
-		 BITP_OPMODE_TIMESLOT_EN) + 1;
 
-	for(i = 0; i < ts_no; i++) {
-		ret = adpd410x_reg_read(dev, ADPD410X_REG_TS_CTRL(i),
-					&temp_data);
+	return adpd410x_read_packets(dev, data, 1);
+}
+
+/**
+ * @brief Get the number of samples and bytes in a FIFO data packet.
+ * @param dev - Device handler.
+ * @param samples_no - Pointer to the samples number container. May be NULL.
+ * @param bytes_no - Pointer to the bytes number container. May be NULL.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t adpd410x_get_packet_layout(struct adpd410x_dev *dev,
+				   uint8_t *samples_no, uint16_t *bytes_no)
+{
+	int32_t ret;
+
+	ret = adpd410x_check_layout(dev);
+	if(ret != SUCCESS)
+		return ret;
+
+	if(samples_no)
+		*samples_no = dev->packet_samples;
+	if(bytes_no)
+		*bytes_no = dev->packet_bytes;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read all the complete data packets available in the FIFO. Meant to
+ *        be called on the FIFO threshold interrupt.
+ * @param dev - Device handler.
+ * @param data - Pointer to the data container. Must hold max_packets times
+ *               the number of samples in a packet.
+ * @param max_packets - Maximum number of packets to read.
+ * @param packets_no - Pointer to the number of packets read.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t adpd410x_get_data_packets(struct adpd410x_dev *dev, uint32_t *data,
+				  uint16_t max_packets, uint16_t *packets_no)
+{
+	int32_t ret;
+	uint16_t bytes, count;
+
+	ret = adpd410x_check_layout(dev);
+	if(ret != SUCCESS)
+		return ret;
+
+	ret = adpd410x_get_fifo_bytecount(dev, &bytes);
+	if(ret != SUCCESS)
+		return ret;
+
+	count = min(bytes, ADPD410X_FIFO_SIZE) / dev->packet_bytes;
+	count = min(count, max_packets);
+	if(count) {
+		ret = adpd410x_read_packets(dev, data, count);
 		if(ret != SUCCESS)
 			return ret;
-		if((temp_data & BITM_TS_CTRL_A_CH2_EN) != 0)
-			dual_chan |= (1 << i);
 	}
+	*packets_no = count;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set the FIFO threshold interrupt level in data packets. The
+ *        interrupt is raised on the INTX pin once the FIFO holds the given
+ *        number of packets and is cleared by reading the FIFO.
+ * @param dev - Device handler.
+ * @param packets_no - Number of packets that raise the interrupt.
+ * @param int_en - Enable the FIFO threshold interrupt on INTX.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t adpd410x_set_fifo_threshold(struct adpd410x_dev *dev,
+				    uint16_t packets_no, bool int_en)
+{
+	int32_t ret;
+	uint32_t bytes;
+
+	ret = adpd410x_check_layout(dev);
+	if(ret != SUCCESS)
+		return ret;
+
+	bytes = (uint32_t)packets_no * dev->packet_bytes;
+	if(!bytes || bytes > ADPD410X_FIFO_SIZE)
+		return -EINVAL;
+
+	/* The interrupt is raised when the byte count exceeds the threshold. */
+	ret = adpd410x_reg_write_mask(dev, ADPD410X_REG_FIFO_TH, bytes - 1,
+				      BITM_FIFO_CTL_FIFO_TH);
+	if(ret != SUCCESS)
+		return ret;
+	ret = adpd410x_reg_write_mask(dev, ADPD410X_REG_INT_ACLEAR, 1,
+				      BITM_INT_ACLEAR_INT_ACLEAR_FIFO);
+	if(ret != SUCCESS)
+		return ret;
 
-	return adpd410x_get_data_packet(dev, data, ts_no, dual_chan);
+	return adpd410x_reg_write_mask(dev, ADPD410X_REG_INT_ENABLE_XD, int_en,
+				       BITM_INT_ENABLE_XD_INTX_EN_FIFO_TH);
 }
 
 /**
@@ -867,6 +867,10 @@
 #define ADPD410X_HIGH_FREQ_OSCILLATOR_FREQ		32000000
 
 #define ADPD410X_MAX_SLOT_NUMBER			12
+#define ADPD410X_MAX_SAMPLE_BYTES			4
+#define ADPD410X_FIFO_SIZE				512
+/* Longest I2C read, an even number of bytes to keep registers whole */
+#define ADPD410X_I2C_MAX_READ				254
 #define ADPD410X_LED_CURR_LSB				1.333
 
 #define ADPD410X_UPPDER_BYTE_SPI_MASK			0x7f80
@@ -1189,6 +1193,16 @@ struct adpd410x_dev {
 	struct gpio_desc *gpio3;
 	/** External low frequency oscillator frequency, if applicable */
 	uint32_t ext_lfo_freq;
+	/** The cached FIFO packet layout matches the device configuration */
+	bool layout_valid;
+	/** Number of samples in a FIFO packet */
+	uint8_t packet_samples;
+	/** Number of bytes in a FIFO packet */
+	uint16_t packet_bytes;
+	/** Size in bytes of each sample of a FIFO packet, in FIFO order */
+	uint8_t sample_bytes[ADPD410X_MAX_SLOT_NUMBER * 2];
+	/** FIFO burst buffer, preceded by the two register address bytes */
+	uint8_t fifo_buf[ADPD410X_FIFO_SIZE + 2];
 };
 
 /******************************************************************************/
@@ -1216,7 +1230,7 @@ int32_t adpd410x_set_opmode(struct adpd410x_dev *dev,
 
 /** Set number of active time slots. */
 int32_t adpd410x_set_last_timeslot(struct adpd410x_dev *dev,
-				   uint8_t timeslot_no);
+				   enum adpd410x_timeslots timeslot_no);
 
 /** Set device sampling frequency. */
 int32_t adpd410x_set_sampling_freq(struct adpd410x_dev *dev,
@@ -1234,6 +1248,18 @@ int32_t adpd410x_get_fifo_bytecount(struct adpd410x_dev *dev, uint16_t *bytes);
  *  slots. */
 int32_t adpd410x_get_data(struct adpd410x_dev *dev, uint32_t *data);
 
+/** Get the number of samples and bytes in a FIFO data packet. */
+int32_t adpd410x_get_packet_layout(struct adpd410x_dev *dev,
+				   uint8_t *samples_no, uint16_t *bytes_no);
+
+/** Read all the complete data packets available in the FIFO. */
+int32_t adpd410x_get_data_packets(struct adpd410x_dev *dev, uint32_t *data,
+				  uint16_t max_packets, uint16_t *packets_no);
+
+/** Set the FIFO threshold interrupt level in data packets. */
+int32_t adpd410x_set_fifo_threshold(struct adpd410x_dev *dev,
+				    uint16_t packets_no, bool int_en);
+
 /** Setup the device and the driver. */
 int32_t adpd410x_setup(struct adpd410x_dev **device,
 		       struct adpd410x_init_param *init_param);
@@ -61,6 +61,9 @@ static struct timer_desc *dummy_timer;
 /** Used for counting milliseconds */
 static struct timer_desc *ms_timer;
 
+/** Free running microsecond clock read by get_time_us() */
+static struct timer_desc *clock_timer;
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
@@ -133,3 +136,28 @@ void mdelay(uint32_t msecs)
 			return ;
 	start_and_wait(ms_timer, msecs);
 }
+
+/**
+ * @brief Get the time of a free running microsecond clock.
+ *
+ * The clock is a timer instance that is started on the first call and never
+ * stopped.
+ * @return The clock value, wrapping around every 2^32 us.
+ */
+uint32_t get_time_us(void)
+{
+	struct timer_init_param param;
+	uint32_t count;
+
+	if (!clock_timer) {
+		param.id = 0;
+		param.freq_hz = 1000000u;
+		param.load_value = 0;
+		if (SUCCESS != timer_init(&clock_timer, &param))
+			return 0;
+		timer_start(clock_timer);
+	}
+	timer_counter_get(clock_timer, &count);
+
+	return count;
+}
@@ -246,3 +246,54 @@ int32_t i2c_read(struct i2c_desc *desc,
 
 	return SUCCESS;
 }
+
+/**
+ * @brief Write data to a slave device, then read from it after a repeated
+ *        start.
+ * @param desc - Descriptor of the I2C device
+ * @param tx_data - Buffer that stores the transmission data.
+ * @param tx_bytes - Number of bytes to write.
+ * @param rx_data - Buffer that stores the received data.
+ * @param rx_bytes - Number of bytes to read.
+ * @return \ref SUCCESS in case of success, \ref FAILURE otherwise.
+ */
+int32_t i2c_write_read(struct i2c_desc *desc,
+		       uint8_t *tx_data,
+		       uint8_t tx_bytes,
+		       uint8_t *rx_data,
+		       uint8_t rx_bytes)
+{
+	if (SUCCESS != i2c_write(desc, tx_data, tx_bytes, 0))
+		return FAILURE;
+
+	return i2c_read(desc, rx_data, rx_bytes, 1);
+}
+
+/**
+ * @brief Execute a combined transaction made of several messages, separated
+ *        by repeated starts.
+ * @param desc - Descriptor of the I2C device
+ * @param msgs - The messages.
+ * @param msgs_no - Number of messages.
+ * @return \ref SUCCESS in case of success, \ref FAILURE otherwise.
+ */
+int32_t i2c_transfer(struct i2c_desc *desc,
+		     struct i2c_xfer_msg *msgs,
+		     uint32_t msgs_no)
+{
+	uint8_t stop_bit;
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < msgs_no; i++) {
+		stop_bit = (i == msgs_no - 1);
+		if (msgs[i].flags & I2C_XFER_READ)
+			ret = i2c_read(desc, msgs[i].buf, msgs[i].len, stop_bit);
+		else
+			ret = i2c_write(desc, msgs[i].buf, msgs[i].len, stop_bit);
+		if (ret != SUCCESS)
+			return FAILURE;
+	}
+
+	return SUCCESS;
+}
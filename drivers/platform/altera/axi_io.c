@@ -44,6 +44,7 @@
 #include <io.h>
 #include "error.h"
 #include "axi_io.h"
+#include "trace.h"
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -58,6 +59,7 @@
  */
 int32_t axi_io_read(uint32_t base, uint32_t offset, uint32_t *data)
 {
+	TRACE_EVENT(TRACE_ID_AXI_IO_READ, offset);
 	*data = IORD_32DIRECT(base, offset);
 
 	return SUCCESS;
@@ -72,6 +74,7 @@ int32_t axi_io_read(uint32_t base, uint32_t offset, uint32_t *data)
  */
 int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 {
+	TRACE_EVENT(TRACE_ID_AXI_IO_WRITE, offset);
 	IOWR_32DIRECT(base, offset, data);
 
 	return SUCCESS;
@@ -41,6 +41,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 
+#include <sys/alt_alarm.h>
 #include "delay.h"
 
 /******************************************************************************/
@@ -66,3 +67,15 @@ void mdelay(uint32_t msecs)
 {
 	usleep(msecs * 1000);
 }
+
+/**
+ * @brief Get the time of a free running microsecond clock.
+ *
+ * The clock is the HAL system tick, so it only advances by whole ticks.
+ * @return The clock value, wrapping around every 2^32 us.
+ */
+uint32_t get_time_us(void)
+{
+	return (uint32_t)((uint64_t)alt_nticks() * 1000000u /
+			  alt_ticks_per_second());
+}
@@ -43,6 +43,13 @@
 
 #include "delay.h"
 
+/******************************************************************************/
+/****************************** Global Variables*******************************/
+/******************************************************************************/
+
+/** Time advanced by the delays, there is no hardware clock */
+static uint32_t sw_time_us;
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
@@ -54,9 +61,7 @@
  */
 void udelay(uint32_t usecs)
 {
-	if (usecs) {
-		// Unused variable - fix compiler warning
-	}
+	sw_time_us += usecs;
 }
 
 /**
@@ -66,7 +71,16 @@ void udelay(uint32_t usecs)
  */
 void mdelay(uint32_t msecs)
 {
-	if (msecs) {
-		// Unused variable - fix compiler warning
-	}
+	sw_time_us += msecs * 1000;
+}
+
+/**
+ * @brief Get the time of a free running microsecond clock.
+ *
+ * Only the udelay() and mdelay() calls advance the clock.
+ * @return The clock value, wrapping around every 2^32 us.
+ */
+uint32_t get_time_us(void)
+{
+	return sw_time_us;
 }
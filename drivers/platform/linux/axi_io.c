@@ -48,6 +48,7 @@
 #include <sys/mman.h>
 #include "error.h"
 #include "axi_io.h"
+#include "trace.h"
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -166,6 +167,7 @@ close:
  */
 int32_t axi_io_read(uint32_t base, uint32_t offset, uint32_t *data)
 {
+	TRACE_EVENT(TRACE_ID_AXI_IO_READ, offset);
 #ifdef DEVMEM
 	return devmem_read_write(base, offset, data, NULL);
 #else
@@ -182,6 +184,7 @@ int32_t axi_io_read(uint32_t base, uint32_t offset, uint32_t *data)
  */
 int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 {
+	TRACE_EVENT(TRACE_ID_AXI_IO_WRITE, offset);
 #ifdef DEVMEM
 	return devmem_read_write(base, offset, NULL, &data);
 #else
@@ -42,7 +42,9 @@
 /******************************************************************************/
 
 #include <stdint.h>
+#include <time.h>
 #include <unistd.h>
+#include "delay.h"
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -67,3 +69,19 @@ void mdelay(uint32_t msecs)
 {
 	usleep(msecs * 1000);
 }
+
+/**
+ * @brief Get the time of a free running microsecond clock.
+ *
+ * The value wraps around every 2^32 us, use the deadline helpers to compare
+ * two readings.
+ * @return Microseconds of CLOCK_MONOTONIC, truncated to 32 bits.
+ */
+uint32_t get_time_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000);
+}
@@ -0,0 +1,615 @@
+/***************************************************************************//**
+ *   @file   linux/linux_gpiochip.c
+ *   @brief  Implementation of Linux GPIO character device driver.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "error.h"
+#include "gpio.h"
+#include "linux_gpiochip.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define LINUX_GPIOCHIP_CONSUMER		"no-OS"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_gpiochip_desc
+ * @brief Linux GPIO character device specific descriptor
+ */
+struct linux_gpiochip_desc {
+	/** Line request file descriptor */
+	int fd;
+	/** Edge detection flags, kept when the direction is changed */
+	uint64_t edge_flags;
+	/** Current direction */
+	uint8_t direction;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Convert an edge setting to line request flags.
+ * @param edge - The edge setting.
+ * @return The line flags.
+ */
+static uint64_t linux_gpiochip_edge_flags(enum linux_gpiochip_edge edge)
+{
+	switch (edge) {
+	case LINUX_GPIOCHIP_EDGE_RISING:
+		return GPIO_V2_LINE_FLAG_EDGE_RISING;
+	case LINUX_GPIOCHIP_EDGE_FALLING:
+		return GPIO_V2_LINE_FLAG_EDGE_FALLING;
+	case LINUX_GPIOCHIP_EDGE_BOTH:
+		return GPIO_V2_LINE_FLAG_EDGE_RISING |
+		       GPIO_V2_LINE_FLAG_EDGE_FALLING;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @brief Request lines of a GPIO chip.
+ * @param chip - The GPIO chip device, LINUX_GPIOCHIP_DEFAULT if NULL.
+ * @param req - The line request, filled in with the request file descriptor.
+ * @param info - Filled in with the information of the first line, may be NULL.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_gpiochip_request(const char *chip,
+				      struct gpio_v2_line_request *req,
+				      struct gpio_v2_line_info *info)
+{
+	int fd;
+	int ret;
+
+	if (!chip)
+		chip = LINUX_GPIOCHIP_DEFAULT;
+
+	fd = open(chip, O_RDWR | O_CLOEXEC);
+	if (fd < 0) {
+		printf("%s: Can't open %s\n\r", __func__, chip);
+		return FAILURE;
+	}
+
+	strncpy(req->consumer, LINUX_GPIOCHIP_CONSUMER,
+		sizeof(req->consumer) - 1);
+
+	ret = ioctl(fd, GPIO_V2_GET_LINE_IOCTL, req);
+	if (ret < 0) {
+		printf("%s: Can't request lines of %s (%d)\n\r", __func__, chip,
+		       errno);
+		close(fd);
+		return FAILURE;
+	}
+
+	if (info) {
+		memset(info, 0, sizeof(*info));
+		info->offset = req->offsets[0];
+		ret = ioctl(fd, GPIO_V2_GET_LINEINFO_IOCTL, info);
+		if (ret < 0) {
+			printf("%s: Can't get line info\n\r", __func__);
+			close(req->fd);
+			close(fd);
+			return FAILURE;
+		}
+	}
+
+	close(fd);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Obtain the GPIO decriptor.
+ * @param desc - The GPIO descriptor.
+ * @param param - GPIO initialization parameters
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiochip_get(struct gpio_desc **desc,
+			   const struct gpio_init_param *param)
+{
+	struct linux_gpiochip_init_param *chip_param;
+	struct linux_gpiochip_desc *linux_desc;
+	struct gpio_v2_line_request req;
+	struct gpio_v2_line_info info;
+	struct gpio_desc *descriptor;
+	int32_t ret;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return FAILURE;
+
+	linux_desc = calloc(1, sizeof(*linux_desc));
+	if (!linux_desc)
+		goto free_desc;
+
+	descriptor->extra = linux_desc;
+	descriptor->number = param->number;
+
+	chip_param = param->extra;
+
+	/*
+	 * Lines without edge detection keep their current direction until
+	 * gpio_direction_input()/output() is called.
+	 */
+	memset(&req, 0, sizeof(req));
+	req.offsets[0] = param->number;
+	req.num_lines = 1;
+	if (chip_param && chip_param->edge != LINUX_GPIOCHIP_EDGE_NONE) {
+		linux_desc->edge_flags = linux_gpiochip_edge_flags(chip_param->edge);
+		req.config.flags = GPIO_V2_LINE_FLAG_INPUT | linux_desc->edge_flags;
+	}
+
+	ret = linux_gpiochip_request(chip_param ? chip_param->chip : NULL, &req,
+				     &info);
+	if (ret != SUCCESS)
+		goto free_linux_desc;
+
+	linux_desc->fd = req.fd;
+	linux_desc->direction = (info.flags & GPIO_V2_LINE_FLAG_OUTPUT) ?
+				GPIO_OUT : GPIO_IN;
+
+	*desc = descriptor;
+
+	return SUCCESS;
+
+free_linux_desc:
+	free(linux_desc);
+free_desc:
+	free(descriptor);
+
+	return FAILURE;
+}
+
+/**
+ * @brief Get the value of an optional GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param param - GPIO Initialization parameters.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiochip_get_optional(struct gpio_desc **desc,
+				    const struct gpio_init_param *param)
+{
+	if (!param) {
+		*desc = NULL;
+		return SUCCESS;
+	}
+
+	return linux_gpiochip_get(desc, param);
+}
+
+/**
+ * @brief Free the resources allocated by gpio_get().
+ * @param desc - The GPIO descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiochip_remove(struct gpio_desc *desc)
+{
+	struct linux_gpiochip_desc *linux_desc;
+	int ret;
+
+	if (!desc)
+		return FAILURE;
+
+	linux_desc = desc->extra;
+
+	ret = close(linux_desc->fd);
+	if (ret < 0) {
+		printf("%s: Can't close device\n\r", __func__);
+		return FAILURE;
+	}
+
+	free(desc->extra);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set the value of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ *                Example: GPIO_HIGH
+ *                         GPIO_LOW
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiochip_set_value(struct gpio_desc *desc,
+				 uint8_t value)
+{
+	struct linux_gpiochip_desc *linux_desc;
+	struct gpio_v2_line_values values;
+	int ret;
+
+	linux_desc = desc->extra;
+
+	values.mask = 1;
+	values.bits = value ? 1 : 0;
+
+	ret = ioctl(linux_desc->fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &values);
+	if (ret < 0) {
+		printf("%s: Can't set value\n\r", __func__);
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the value of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ *                Example: GPIO_HIGH
+ *                         GPIO_LOW
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiochip_get_value(struct gpio_desc *desc,
+				 uint8_t *value)
+{
+	struct linux_gpiochip_desc *linux_desc;
+	struct gpio_v2_line_values values;
+	int ret;
+
+	linux_desc = desc->extra;
+
+	values.mask = 1;
+	values.bits = 0;
+
+	ret = ioctl(linux_desc->fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &values);
+	if (ret < 0) {
+		printf("%s: Can't get value\n\r", __func__);
+		return FAILURE;
+	}
+
+	*value = (values.bits & 1) ? GPIO_HIGH : GPIO_LOW;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Enable the input direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiochip_direction_input(struct gpio_desc *desc)
+{
+	struct linux_gpiochip_desc *linux_desc;
+	struct gpio_v2_line_config config;
+	int ret;
+
+	linux_desc = desc->extra;
+
+	memset(&config, 0, sizeof(config));
+	config.flags = GPIO_V2_LINE_FLAG_INPUT | linux_desc->edge_flags;
+
+	ret = ioctl(linux_desc->fd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &config);
+	if (ret < 0) {
+		printf("%s: Can't set direction\n\r", __func__);
+		return FAILURE;
+	}
+
+	linux_desc->direction = GPIO_IN;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Enable the output direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ *                Example: GPIO_HIGH
+ *                         GPIO_LOW
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiochip_direction_output(struct gpio_desc *desc,
+					uint8_t value)
+{
+	struct linux_gpiochip_desc *linux_desc;
+	struct gpio_v2_line_config config;
+	int ret;
+
+	linux_desc = desc->extra;
+
+	/* Edge detection is only available on inputs. */
+	if (linux_desc->edge_flags) {
+		printf("%s: Line is used for edge detection\n\r", __func__);
+		return FAILURE;
+	}
+
+	/* Direction and initial value are set in a single call. */
+	memset(&config, 0, sizeof(config));
+	config.flags = GPIO_V2_LINE_FLAG_OUTPUT;
+	config.num_attrs = 1;
+	config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+	config.attrs[0].attr.values = value ? 1 : 0;
+	config.attrs[0].mask = 1;
+
+	ret = ioctl(linux_desc->fd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &config);
+	if (ret < 0) {
+		printf("%s: Can't set direction\n\r", __func__);
+		return FAILURE;
+	}
+
+	linux_desc->direction = GPIO_OUT;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param direction - The direction.
+ *                    Example: GPIO_OUT
+ *                             GPIO_IN
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiochip_get_direction(struct gpio_desc *desc,
+				     uint8_t *direction)
+{
+	struct linux_gpiochip_desc *linux_desc;
+
+	linux_desc = desc->extra;
+
+	*direction = linux_desc->direction;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Wait for an edge event on a line requested with edge detection.
+ *
+ * The call blocks in the kernel instead of polling the line value, so it can
+ * be used to wait for BUSY/DRDY type signals.
+ * @param desc - The GPIO descriptor.
+ * @param timeout_ms - Timeout in milliseconds, negative to wait forever.
+ * @param event - The event read, may be NULL.
+ * @return SUCCESS in case of success, -ETIMEDOUT if no edge was detected,
+ * FAILURE otherwise.
+ */
+int32_t linux_gpiochip_wait_event(struct gpio_desc *desc, int32_t timeout_ms,
+				  struct linux_gpiochip_event *event)
+{
+	struct linux_gpiochip_desc *linux_desc;
+	struct gpio_v2_line_event line_event;
+	struct pollfd pfd;
+	ssize_t len;
+	int ret;
+
+	if (!desc)
+		return FAILURE;
+
+	linux_desc = desc->extra;
+	if (!linux_desc->edge_flags)
+		return FAILURE;
+
+	pfd.fd = linux_desc->fd;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+
+	ret = poll(&pfd, 1, timeout_ms);
+	if (ret < 0) {
+		printf("%s: Can't poll line\n\r", __func__);
+		return FAILURE;
+	}
+	if (ret == 0)
+		return -ETIMEDOUT;
+
+	len = read(linux_desc->fd, &line_event, sizeof(line_event));
+	if (len != sizeof(line_event)) {
+		printf("%s: Can't read event\n\r", __func__);
+		return FAILURE;
+	}
+
+	if (event) {
+		event->timestamp_ns = line_event.timestamp_ns;
+		event->edge = (line_event.id == GPIO_V2_LINE_EVENT_RISING_EDGE) ?
+			      LINUX_GPIOCHIP_EDGE_RISING :
+			      LINUX_GPIOCHIP_EDGE_FALLING;
+		event->seqno = line_event.line_seqno;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Request several lines of a chip at once.
+ *
+ * The lines share one file descriptor, so their values are read or written
+ * with a single ioctl.
+ * @param desc - The bulk descriptor.
+ * @param param - The bulk initialization parameters.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiochip_bulk_get(struct linux_gpiochip_bulk_desc **desc,
+				const struct linux_gpiochip_bulk_init_param *param)
+{
+	struct linux_gpiochip_bulk_desc *bulk;
+	struct gpio_v2_line_request req;
+	uint8_t i;
+	int32_t ret;
+
+	if (!desc || !param || !param->offsets || !param->num_lines ||
+	    param->num_lines > LINUX_GPIOCHIP_MAX_LINES)
+		return FAILURE;
+
+	bulk = calloc(1, sizeof(*bulk));
+	if (!bulk)
+		return FAILURE;
+
+	memset(&req, 0, sizeof(req));
+	for (i = 0; i < param->num_lines; i++)
+		req.offsets[i] = param->offsets[i];
+	req.num_lines = param->num_lines;
+
+	/* Inputs by default, the outputs are overridden by attributes. */
+	req.config.flags = GPIO_V2_LINE_FLAG_INPUT;
+	if (param->output_mask) {
+		req.config.num_attrs = 2;
+		req.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_FLAGS;
+		req.config.attrs[0].attr.flags = GPIO_V2_LINE_FLAG_OUTPUT;
+		req.config.attrs[0].mask = param->output_mask;
+		req.config.attrs[1].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+		req.config.attrs[1].attr.values = param->output_values;
+		req.config.attrs[1].mask = param->output_mask;
+	}
+
+	ret = linux_gpiochip_request(param->chip, &req, NULL);
+	if (ret != SUCCESS) {
+		free(bulk);
+		return FAILURE;
+	}
+
+	bulk->fd = req.fd;
+	bulk->num_lines = param->num_lines;
+
+	*desc = bulk;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Release the lines requested by linux_gpiochip_bulk_get().
+ * @param desc - The bulk descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiochip_bulk_remove(struct linux_gpiochip_bulk_desc *desc)
+{
+	int ret;
+
+	if (!desc)
+		return FAILURE;
+
+	ret = close(desc->fd);
+	if (ret < 0) {
+		printf("%s: Can't close device\n\r", __func__);
+		return FAILURE;
+	}
+
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set the values of the output lines selected by mask in one call.
+ * @param desc - The bulk descriptor.
+ * @param mask - Lines to be written, bit n refers to the n-th requested line.
+ * @param values - The values of the lines.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiochip_bulk_set_values(struct linux_gpiochip_bulk_desc *desc,
+				       uint64_t mask, uint64_t values)
+{
+	struct gpio_v2_line_values line_values;
+	int ret;
+
+	if (!desc)
+		return FAILURE;
+
+	line_values.mask = mask;
+	line_values.bits = values;
+
+	ret = ioctl(desc->fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &line_values);
+	if (ret < 0) {
+		printf("%s: Can't set values\n\r", __func__);
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the values of the lines selected by mask in one call.
+ * @param desc - The bulk descriptor.
+ * @param mask - Lines to be read, bit n refers to the n-th requested line.
+ * @param values - The values of the lines.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiochip_bulk_get_values(struct linux_gpiochip_bulk_desc *desc,
+				       uint64_t mask, uint64_t *values)
+{
+	struct gpio_v2_line_values line_values;
+	int ret;
+
+	if (!desc || !values)
+		return FAILURE;
+
+	line_values.mask = mask;
+	line_values.bits = 0;
+
+	ret = ioctl(desc->fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &line_values);
+	if (ret < 0) {
+		printf("%s: Can't get values\n\r", __func__);
+		return FAILURE;
+	}
+
+	*values = line_values.bits & mask;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Linux GPIO character device platform ops structure
+ */
+const struct gpio_platform_ops linux_gpiochip_platform_ops = {
+	.gpio_ops_get = &linux_gpiochip_get,
+	.gpio_ops_get_optional = &linux_gpiochip_get_optional,
+	.gpio_ops_remove = &linux_gpiochip_remove,
+	.gpio_ops_direction_input = &linux_gpiochip_direction_input,
+	.gpio_ops_direction_output = &linux_gpiochip_direction_output,
+	.gpio_ops_get_direction = &linux_gpiochip_get_direction,
+	.gpio_ops_set_value = &linux_gpiochip_set_value,
+	.gpio_ops_get_value = &linux_gpiochip_get_value,
+};
@@ -0,0 +1,157 @@
+/*******************************************************************************
+ *   @file   linux/linux_gpiochip.h
+ *   @brief  Header file of the Linux GPIO character device driver.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef LINUX_GPIOCHIP_H_
+#define LINUX_GPIOCHIP_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "gpio.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** GPIO chip used when no linux_gpiochip_init_param is provided */
+#define LINUX_GPIOCHIP_DEFAULT		"/dev/gpiochip0"
+/** Maximum number of lines handled by a bulk request */
+#define LINUX_GPIOCHIP_MAX_LINES	64
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum linux_gpiochip_edge
+ * @brief Edges reported through linux_gpiochip_wait_event().
+ */
+enum linux_gpiochip_edge {
+	/** No edge detection */
+	LINUX_GPIOCHIP_EDGE_NONE,
+	/** Rising edge */
+	LINUX_GPIOCHIP_EDGE_RISING,
+	/** Falling edge */
+	LINUX_GPIOCHIP_EDGE_FALLING,
+	/** Both edges */
+	LINUX_GPIOCHIP_EDGE_BOTH
+};
+
+/**
+ * @struct linux_gpiochip_init_param
+ * @brief Linux GPIO character device specific parameters, passed through
+ * gpio_init_param.extra. The GPIO number is the line offset inside the chip.
+ */
+struct linux_gpiochip_init_param {
+	/** GPIO chip device, LINUX_GPIOCHIP_DEFAULT if NULL */
+	const char *chip;
+	/** Edges to be detected, the line is requested as input if not none */
+	enum linux_gpiochip_edge edge;
+};
+
+/**
+ * @struct linux_gpiochip_event
+ * @brief Edge event read from a line.
+ */
+struct linux_gpiochip_event {
+	/** Monotonic timestamp of the edge, in nanoseconds */
+	uint64_t timestamp_ns;
+	/** Detected edge, LINUX_GPIOCHIP_EDGE_RISING or _FALLING */
+	enum linux_gpiochip_edge edge;
+	/** Sequence number of the event on this line */
+	uint32_t seqno;
+};
+
+/**
+ * @struct linux_gpiochip_bulk_init_param
+ * @brief Parameters of a request holding several lines of the same chip.
+ */
+struct linux_gpiochip_bulk_init_param {
+	/** GPIO chip device, LINUX_GPIOCHIP_DEFAULT if NULL */
+	const char *chip;
+	/** Line offsets, bit n of the masks below refers to offsets[n] */
+	const uint32_t *offsets;
+	/** Number of lines */
+	uint8_t num_lines;
+	/** Lines requested as output, the others are inputs */
+	uint64_t output_mask;
+	/** Initial values of the output lines */
+	uint64_t output_values;
+};
+
+/**
+ * @struct linux_gpiochip_bulk_desc
+ * @brief Descriptor of a request holding several lines.
+ */
+struct linux_gpiochip_bulk_desc {
+	/** Line request file descriptor */
+	int fd;
+	/** Number of lines */
+	uint8_t num_lines;
+};
+
+/**
+ * @brief Linux GPIO character device platform ops structure
+ */
+extern const struct gpio_platform_ops linux_gpiochip_platform_ops;
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Wait for an edge event on a line requested with edge detection. */
+int32_t linux_gpiochip_wait_event(struct gpio_desc *desc, int32_t timeout_ms,
+				  struct linux_gpiochip_event *event);
+
+/* Request several lines of a chip at once. */
+int32_t linux_gpiochip_bulk_get(struct linux_gpiochip_bulk_desc **desc,
+				const struct linux_gpiochip_bulk_init_param *param);
+
+/* Release the lines requested by linux_gpiochip_bulk_get(). */
+int32_t linux_gpiochip_bulk_remove(struct linux_gpiochip_bulk_desc *desc);
+
+/* Set the values of the output lines selected by mask in one call. */
+int32_t linux_gpiochip_bulk_set_values(struct linux_gpiochip_bulk_desc *desc,
+				       uint64_t mask, uint64_t values);
+
+/* Get the values of the lines selected by mask in one call. */
+int32_t linux_gpiochip_bulk_get_values(struct linux_gpiochip_bulk_desc *desc,
+				       uint64_t mask, uint64_t *values);
+
+#endif // LINUX_GPIOCHIP_H_
@@ -50,8 +50,15 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define LINUX_I2C_NO_SLAVE	-1
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -63,12 +70,68 @@
 struct linux_i2c_desc {
 	/** /dev/i2c-"device_id" file descriptor */
 	int fd;
+	/** Slave address selected with I2C_SLAVE, LINUX_I2C_NO_SLAVE if none */
+	int slave_address;
 };
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
+/**
+ * @brief Select the slave device for the read() and write() calls. The
+ *        I2C_SLAVE ioctl is issued only when the slave address changes.
+ * @param desc - The I2C descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_i2c_select(struct i2c_desc *desc)
+{
+	struct linux_i2c_desc *linux_desc;
+	int32_t ret;
+
+	linux_desc = desc->extra;
+
+	if (linux_desc->slave_address == desc->slave_address)
+		return SUCCESS;
+
+	ret = ioctl(linux_desc->fd, I2C_SLAVE, desc->slave_address);
+	if (ret < 0) {
+		printf("%s: Can't select device\n\r", __func__);
+		linux_desc->slave_address = LINUX_I2C_NO_SLAVE;
+		return FAILURE;
+	}
+	linux_desc->slave_address = desc->slave_address;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Execute messages as one combined transaction with I2C_RDWR.
+ * @param desc - The I2C descriptor.
+ * @param msgs - The messages.
+ * @param msgs_no - Number of messages, at most I2C_RDWR_IOCTL_MAX_MSGS.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_i2c_rdwr(struct i2c_desc *desc, struct i2c_msg *msgs,
+			      uint32_t msgs_no)
+{
+	struct linux_i2c_desc *linux_desc;
+	struct i2c_rdwr_ioctl_data rdwr;
+	int32_t ret;
+
+	linux_desc = desc->extra;
+
+	rdwr.msgs = msgs;
+	rdwr.nmsgs = msgs_no;
+	ret = ioctl(linux_desc->fd, I2C_RDWR, &rdwr);
+	if (ret < 0) {
+		printf("%s: Can't transfer data\n\r", __func__);
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
 /**
  * @brief Initialize the I2C communication peripheral.
  * @param desc - The I2C descriptor.
@@ -94,6 +157,8 @@ int32_t linux_i2c_init(struct i2c_desc **desc,
 	descriptor->extra = linux_desc;
 	linux_init = param->extra;
 
+	linux_desc->slave_address = LINUX_I2C_NO_SLAVE;
+
 	snprintf(path, sizeof(path), "/dev/i2c-%d", linux_init->device_id);
 
 	linux_desc->fd = open(path, O_RDWR);
@@ -142,6 +207,9 @@ int32_t linux_i2c_remove(struct i2c_desc *desc)
 
 /**
  * @brief Write data to a slave device.
+ *
+ * The write always ends with a stop condition. Use i2c_write_read() or
+ * i2c_transfer() for a repeated start.
  * @param desc - The I2C descriptor.
  * @param data - Buffer that stores the transmission data.
  * @param bytes_number - Number of bytes to write.
@@ -160,11 +228,9 @@ int32_t linux_i2c_write(struct i2c_desc *desc,
 
 	linux_desc = desc->extra;
 
-	ret = ioctl(linux_desc->fd, I2C_SLAVE, desc->slave_address);
-	if (ret < 0) {
-		printf("%s: Can't select device\n\r", __func__);
-		return FAILURE;
-	}
+	ret = linux_i2c_select(desc);
+	if (ret != SUCCESS)
+		return ret;
 
 	ret = write(linux_desc->fd, data, bytes_number);
 	if (ret < 0) {
@@ -179,6 +245,36 @@ int32_t linux_i2c_write(struct i2c_desc *desc,
 	return SUCCESS;
 }
 
+/**
+ * @brief Write data to a slave device, then read from it after a repeated
+ *        start, with a single I2C_RDWR call.
+ * @param desc - The I2C descriptor.
+ * @param tx_data - Buffer that stores the transmission data.
+ * @param tx_bytes - Number of bytes to write.
+ * @param rx_data - Buffer that will store the received data.
+ * @param rx_bytes - Number of bytes to read.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_i2c_write_read(struct i2c_desc *desc,
+			     uint8_t *tx_data,
+			     uint8_t tx_bytes,
+			     uint8_t *rx_data,
+			     uint8_t rx_bytes)
+{
+	struct i2c_msg msgs[2];
+
+	msgs[0].addr = desc->slave_address;
+	msgs[0].flags = 0;
+	msgs[0].len = tx_bytes;
+	msgs[0].buf = tx_data;
+	msgs[1].addr = desc->slave_address;
+	msgs[1].flags = I2C_M_RD;
+	msgs[1].len = rx_bytes;
+	msgs[1].buf = rx_data;
+
+	return linux_i2c_rdwr(desc, msgs, 2);
+}
+
 /**
  * @brief Read data from a slave device.
  * @param desc - The I2C descriptor.
@@ -199,11 +295,9 @@ int32_t linux_i2c_read(struct i2c_desc *desc,
 
 	linux_desc = desc->extra;
 
-	ret = ioctl(linux_desc->fd, I2C_SLAVE, desc->slave_address);
-	if (ret < 0) {
-		printf("%s: Can't select device\n\r", __func__);
-		return FAILURE;
-	}
+	ret = linux_i2c_select(desc);
+	if (ret != SUCCESS)
+		return ret;
 
 	ret = read(linux_desc->fd, data, bytes_number);
 	if (ret < 0) {
@@ -218,6 +312,35 @@ int32_t linux_i2c_read(struct i2c_desc *desc,
 	return SUCCESS;
 }
 
+/**
+ * @brief Execute a combined transaction made of several messages with a
+ *        single I2C_RDWR call.
+ * @param desc - The I2C descriptor.
+ * @param msgs - The messages.
+ * @param msgs_no - Number of messages, at most I2C_RDWR_IOCTL_MAX_MSGS.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_i2c_transfer(struct i2c_desc *desc,
+			   struct i2c_xfer_msg *msgs,
+			   uint32_t msgs_no)
+{
+	struct i2c_msg linux_msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+	uint32_t i;
+
+	if (!msgs_no || msgs_no > I2C_RDWR_IOCTL_MAX_MSGS)
+		return -EINVAL;
+
+	for (i = 0; i < msgs_no; i++) {
+		linux_msgs[i].addr = desc->slave_address;
+		linux_msgs[i].flags = (msgs[i].flags & I2C_XFER_READ) ?
+				      I2C_M_RD : 0;
+		linux_msgs[i].len = msgs[i].len;
+		linux_msgs[i].buf = msgs[i].buf;
+	}
+
+	return linux_i2c_rdwr(desc, linux_msgs, msgs_no);
+}
+
 /**
  * @brief Linux platform specific I2C platform ops structure
  */
@@ -225,5 +348,7 @@ const struct i2c_platform_ops linux_i2c_platform_ops = {
 	.i2c_ops_init = &linux_i2c_init,
 	.i2c_ops_write = &linux_i2c_write,
 	.i2c_ops_read = &linux_i2c_read,
+	.i2c_ops_write_read = &linux_i2c_write_read,
+	.i2c_ops_transfer = &linux_i2c_transfer,
 	.i2c_ops_remove = &linux_i2c_remove
 };
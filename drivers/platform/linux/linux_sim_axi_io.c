@@ -0,0 +1,482 @@
+/***************************************************************************//**
+ *   @file   linux/linux_sim_axi_io.c
+ *   @brief  Implementation of Linux platform simulated AXI IO.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "util.h"
+#include "axi_io.h"
+#include "linux_sim_axi_io.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* AXI DMAC registers, see axi_dmac.h */
+#define SIM_DMAC_REG_IRQ_PENDING	0x84
+#define SIM_DMAC_IRQ_SOT_EOT		(BIT(0) | BIT(1))
+#define SIM_DMAC_REG_CTRL		0x400
+#define SIM_DMAC_CTRL_ENABLE		BIT(0)
+#define SIM_DMAC_REG_TRANSFER_ID	0x404
+#define SIM_DMAC_REG_START_TRANSFER	0x408
+#define SIM_DMAC_REG_TRANSFER_DONE	0x428
+
+/* AXI SPI Engine registers, see spi_engine_private.h */
+#define SIM_SPI_ENGINE_REG_VERSION	0x00
+#define SIM_SPI_ENGINE_REG_DATA_WIDTH	0x0C
+#define SIM_SPI_ENGINE_REG_RESET	0x40
+#define SIM_SPI_ENGINE_REG_SYNC_ID	0xC0
+#define SIM_SPI_ENGINE_REG_CMD_ROOM	0xD0
+#define SIM_SPI_ENGINE_REG_SDO_ROOM	0xD4
+#define SIM_SPI_ENGINE_REG_SDI_LEVEL	0xD8
+#define SIM_SPI_ENGINE_REG_CMD_FIFO	0xE0
+#define SIM_SPI_ENGINE_REG_SDO_FIFO	0xE4
+#define SIM_SPI_ENGINE_REG_SDI_FIFO	0xE8
+#define SIM_SPI_ENGINE_REG_SDI_PEEK	0xEC
+#define SIM_SPI_ENGINE_VERSION		0x00010071
+#define SIM_SPI_ENGINE_DATA_WIDTH	32
+#define SIM_SPI_ENGINE_INST(cmd)	(((cmd) >> 12) & 0x3)
+#define SIM_SPI_ENGINE_ARG1(cmd)	(((cmd) >> 8) & 0x3)
+#define SIM_SPI_ENGINE_ARG2(cmd)	((cmd) & 0xFF)
+#define SIM_SPI_ENGINE_INST_TRANSFER	0x0
+#define SIM_SPI_ENGINE_INST_MISC	0x3
+#define SIM_SPI_ENGINE_MISC_SYNC	0x0
+#define SIM_SPI_ENGINE_TRANSFER_W	BIT(0)
+#define SIM_SPI_ENGINE_TRANSFER_R	BIT(1)
+
+/* Depth of the simulated SPI Engine FIFOs. Must be a power of 2. */
+#define SIM_FIFO_SIZE			64
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct sim_fifo
+ * @brief Simulated hardware FIFO.
+ */
+struct sim_fifo {
+	uint32_t buff[SIM_FIFO_SIZE];
+	uint32_t head;
+	uint32_t tail;
+};
+
+/**
+ * @struct sim_region
+ * @brief Simulated register region state.
+ */
+struct sim_region {
+	/** Region configuration */
+	struct linux_sim_axi_io_region cfg;
+	/** Register values */
+	uint32_t *regs;
+	/** Access counters */
+	struct linux_sim_axi_io_stats stats;
+	/** SPI Engine command FIFO */
+	struct sim_fifo cmd;
+	/** SPI Engine SDO FIFO */
+	struct sim_fifo sdo;
+	/** SPI Engine SDI FIFO */
+	struct sim_fifo sdi;
+};
+
+/******************************************************************************/
+/************************ Variable Definitions ********************************/
+/******************************************************************************/
+
+static struct sim_region sim_regions[LINUX_SIM_AXI_IO_MAX_REGIONS];
+static uint32_t sim_nb_regions;
+static uint32_t sim_unmapped;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static inline uint32_t sim_fifo_count(struct sim_fifo *fifo)
+{
+	return fifo->head - fifo->tail;
+}
+
+static void sim_fifo_push(struct sim_fifo *fifo, uint32_t val)
+{
+	if (sim_fifo_count(fifo) == SIM_FIFO_SIZE)
+		return;
+
+	fifo->buff[fifo->head++ & (SIM_FIFO_SIZE - 1)] = val;
+}
+
+static uint32_t sim_fifo_pop(struct sim_fifo *fifo)
+{
+	if (!sim_fifo_count(fifo))
+		return 0;
+
+	return fifo->buff[fifo->tail++ & (SIM_FIFO_SIZE - 1)];
+}
+
+static uint32_t sim_fifo_peek(struct sim_fifo *fifo)
+{
+	if (!sim_fifo_count(fifo))
+		return 0;
+
+	return fifo->buff[fifo->tail & (SIM_FIFO_SIZE - 1)];
+}
+
+/**
+ * @brief Find the region holding an address.
+ * @param addr - Register address.
+ * @return The region, NULL if the address is not simulated.
+ */
+static struct sim_region *sim_find(uint32_t addr)
+{
+	uint32_t i;
+
+	for (i = 0; i < sim_nb_regions; i++)
+		if (addr - sim_regions[i].cfg.base < sim_regions[i].cfg.size)
+			return &sim_regions[i];
+
+	return NULL;
+}
+
+/**
+ * @brief AXI DMAC register write. Submitted transfers complete immediately.
+ * @param r - Region.
+ * @param offset - Register offset.
+ * @param val - Written value.
+ */
+static void sim_dmac_write(struct sim_region *r, uint32_t offset, uint32_t val)
+{
+	uint32_t *regs = r->regs;
+	uint32_t id;
+
+	switch (offset) {
+	case SIM_DMAC_REG_IRQ_PENDING:
+		regs[offset / 4] &= ~val;
+		break;
+	case SIM_DMAC_REG_CTRL:
+		regs[offset / 4] = val;
+		if (!(val & SIM_DMAC_CTRL_ENABLE)) {
+			regs[SIM_DMAC_REG_TRANSFER_ID / 4] = 0;
+			regs[SIM_DMAC_REG_TRANSFER_DONE / 4] = 0;
+			regs[SIM_DMAC_REG_IRQ_PENDING / 4] = 0;
+		}
+		break;
+	case SIM_DMAC_REG_START_TRANSFER:
+		if (!(val & 1))
+			break;
+		id = regs[SIM_DMAC_REG_TRANSFER_ID / 4];
+		regs[SIM_DMAC_REG_IRQ_PENDING / 4] |= SIM_DMAC_IRQ_SOT_EOT;
+		regs[SIM_DMAC_REG_TRANSFER_DONE / 4] |= BIT(id);
+		regs[SIM_DMAC_REG_TRANSFER_ID / 4] = (id + 1) & 0x3;
+		break;
+	default:
+		regs[offset / 4] = val;
+		break;
+	}
+}
+
+/**
+ * @brief Execute the queued SPI Engine commands. A write transfer stalls
+ * until enough SDO words were written, like the hardware does.
+ * @param r - Region.
+ */
+static void sim_spi_engine_run(struct sim_region *r)
+{
+	uint32_t cmd;
+	uint32_t n;
+	uint32_t w;
+
+	while (sim_fifo_count(&r->cmd)) {
+		cmd = sim_fifo_peek(&r->cmd);
+
+		switch (SIM_SPI_ENGINE_INST(cmd)) {
+		case SIM_SPI_ENGINE_INST_TRANSFER:
+			n = SIM_SPI_ENGINE_ARG2(cmd) + 1;
+			if ((SIM_SPI_ENGINE_ARG1(cmd) & SIM_SPI_ENGINE_TRANSFER_W) &&
+			    sim_fifo_count(&r->sdo) < n)
+				return;
+			while (n--) {
+				w = 0;
+				if (SIM_SPI_ENGINE_ARG1(cmd) &
+				    SIM_SPI_ENGINE_TRANSFER_W)
+					w = sim_fifo_pop(&r->sdo);
+				if (SIM_SPI_ENGINE_ARG1(cmd) &
+				    SIM_SPI_ENGINE_TRANSFER_R)
+					sim_fifo_push(&r->sdi, w);
+			}
+			break;
+		case SIM_SPI_ENGINE_INST_MISC:
+			if (SIM_SPI_ENGINE_ARG1(cmd) == SIM_SPI_ENGINE_MISC_SYNC)
+				r->regs[SIM_SPI_ENGINE_REG_SYNC_ID / 4] =
+					SIM_SPI_ENGINE_ARG2(cmd);
+			break;
+		default:
+			break;
+		}
+
+		sim_fifo_pop(&r->cmd);
+	}
+}
+
+/**
+ * @brief AXI SPI Engine register write.
+ * @param r - Region.
+ * @param offset - Register offset.
+ * @param val - Written value.
+ */
+static void sim_spi_engine_write(struct sim_region *r, uint32_t offset,
+				 uint32_t val)
+{
+	switch (offset) {
+	case SIM_SPI_ENGINE_REG_RESET:
+		if (val & 1) {
+			memset(&r->cmd, 0, sizeof(r->cmd));
+			memset(&r->sdo, 0, sizeof(r->sdo));
+			memset(&r->sdi, 0, sizeof(r->sdi));
+		}
+		break;
+	case SIM_SPI_ENGINE_REG_CMD_FIFO:
+		sim_fifo_push(&r->cmd, val);
+		sim_spi_engine_run(r);
+		return;
+	case SIM_SPI_ENGINE_REG_SDO_FIFO:
+		sim_fifo_push(&r->sdo, val);
+		sim_spi_engine_run(r);
+		return;
+	case SIM_SPI_ENGINE_REG_VERSION:
+	case SIM_SPI_ENGINE_REG_DATA_WIDTH:
+		return;
+	default:
+		break;
+	}
+
+	r->regs[offset / 4] = val;
+}
+
+/**
+ * @brief AXI SPI Engine register read.
+ * @param r - Region.
+ * @param offset - Register offset.
+ * @return The register value.
+ */
+static uint32_t sim_spi_engine_read(struct sim_region *r, uint32_t offset)
+{
+	switch (offset) {
+	case SIM_SPI_ENGINE_REG_CMD_ROOM:
+		return SIM_FIFO_SIZE - sim_fifo_count(&r->cmd);
+	case SIM_SPI_ENGINE_REG_SDO_ROOM:
+		return SIM_FIFO_SIZE - sim_fifo_count(&r->sdo);
+	case SIM_SPI_ENGINE_REG_SDI_LEVEL:
+		return sim_fifo_count(&r->sdi);
+	case SIM_SPI_ENGINE_REG_SDI_FIFO:
+		return sim_fifo_pop(&r->sdi);
+	case SIM_SPI_ENGINE_REG_SDI_PEEK:
+		return sim_fifo_peek(&r->sdi);
+	default:
+		return r->regs[offset / 4];
+	}
+}
+
+/**
+ * @brief Add a simulated register region.
+ * @param region - Region description. The base and size must be 4 byte
+ * aligned and the region must not overlap the existing ones.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_sim_axi_io_add(const struct linux_sim_axi_io_region *region)
+{
+	struct sim_region *r;
+
+	if (!region || !region->size || (region->base | region->size) & 0x3)
+		return -EINVAL;
+
+	if (sim_find(region->base) ||
+	    sim_find(region->base + region->size - 1))
+		return -EEXIST;
+
+	if (sim_nb_regions == LINUX_SIM_AXI_IO_MAX_REGIONS)
+		return -ENOMEM;
+
+	r = &sim_regions[sim_nb_regions];
+	memset(r, 0, sizeof(*r));
+	r->regs = calloc(region->size / 4, sizeof(*r->regs));
+	if (!r->regs)
+		return -ENOMEM;
+	r->cfg = *region;
+
+	if (region->model == LINUX_SIM_AXI_IO_SPI_ENGINE &&
+	    region->size > SIM_SPI_ENGINE_REG_DATA_WIDTH) {
+		r->regs[SIM_SPI_ENGINE_REG_VERSION / 4] = SIM_SPI_ENGINE_VERSION;
+		r->regs[SIM_SPI_ENGINE_REG_DATA_WIDTH / 4] =
+			SIM_SPI_ENGINE_DATA_WIDTH;
+	}
+
+	sim_nb_regions++;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Remove all the simulated register regions.
+ */
+void linux_sim_axi_io_remove_all(void)
+{
+	while (sim_nb_regions)
+		free(sim_regions[--sim_nb_regions].regs);
+
+	sim_unmapped = 0;
+}
+
+/**
+ * @brief Get the access counters of a simulated region.
+ * @param base - Region base address.
+ * @param stats - Where the counters are copied.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_sim_axi_io_get_stats(uint32_t base,
+				   struct linux_sim_axi_io_stats *stats)
+{
+	struct sim_region *r;
+
+	r = sim_find(base);
+	if (!r || !stats)
+		return -EINVAL;
+
+	*stats = r->stats;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Clear the access counters of a simulated region.
+ * @param base - Region base address.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_sim_axi_io_reset_stats(uint32_t base)
+{
+	struct sim_region *r;
+
+	r = sim_find(base);
+	if (!r)
+		return -EINVAL;
+
+	memset(&r->stats, 0, sizeof(r->stats));
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the number of accesses that hit no simulated region.
+ * @return The number of unmapped accesses.
+ */
+uint32_t linux_sim_axi_io_get_unmapped(void)
+{
+	return sim_unmapped;
+}
+
+/**
+ * @brief AXI IO simulated read function.
+ * @param base - Base address.
+ * @param offset - Address offset.
+ * @param data - Location where read data will be stored.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_read(uint32_t base, uint32_t offset, uint32_t *data)
+{
+	struct sim_region *r;
+
+	r = sim_find(base + offset);
+	if (!r) {
+		sim_unmapped++;
+		return FAILURE;
+	}
+
+	offset = (base + offset - r->cfg.base) & ~0x3;
+	r->stats.reads++;
+
+	if (r->cfg.read_hook)
+		r->cfg.read_hook(r->cfg.hook_ctx, r->regs, offset);
+
+	if (r->cfg.model == LINUX_SIM_AXI_IO_SPI_ENGINE)
+		*data = sim_spi_engine_read(r, offset);
+	else
+		*data = r->regs[offset / 4];
+
+	return SUCCESS;
+}
+
+/**
+ * @brief AXI IO simulated write function.
+ * @param base - Base address.
+ * @param offset - Address offset.
+ * @param data - Data to be written.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
+{
+	struct sim_region *r;
+
+	r = sim_find(base + offset);
+	if (!r) {
+		sim_unmapped++;
+		return FAILURE;
+	}
+
+	offset = (base + offset - r->cfg.base) & ~0x3;
+	r->stats.writes++;
+
+	switch (r->cfg.model) {
+	case LINUX_SIM_AXI_IO_DMAC:
+		sim_dmac_write(r, offset, data);
+		break;
+	case LINUX_SIM_AXI_IO_SPI_ENGINE:
+		sim_spi_engine_write(r, offset, data);
+		break;
+	default:
+		r->regs[offset / 4] = data;
+		break;
+	}
+
+	if (r->cfg.write_hook)
+		r->cfg.write_hook(r->cfg.hook_ctx, r->regs, offset);
+
+	return SUCCESS;
+}
@@ -0,0 +1,126 @@
+/***************************************************************************//**
+ *   @file   linux/linux_sim_axi_io.h
+ *   @brief  Header file of Linux platform simulated AXI IO.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef LINUX_SIM_AXI_IO_H_
+#define LINUX_SIM_AXI_IO_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "axi_io.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define LINUX_SIM_AXI_IO_MAX_REGIONS	8
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum linux_sim_axi_io_model
+ * @brief Behaviour of a simulated register region.
+ */
+enum linux_sim_axi_io_model {
+	/** Plain read/write registers */
+	LINUX_SIM_AXI_IO_RAM,
+	/** AXI DMAC: every submitted transfer completes immediately */
+	LINUX_SIM_AXI_IO_DMAC,
+	/** AXI SPI Engine: FIFO mode with SDO to SDI loopback */
+	LINUX_SIM_AXI_IO_SPI_ENGINE,
+};
+
+/**
+ * @struct linux_sim_axi_io_region
+ * @brief Simulated register region.
+ */
+struct linux_sim_axi_io_region {
+	/** Base address */
+	uint32_t base;
+	/** Size in bytes */
+	uint32_t size;
+	/** Register behaviour */
+	enum linux_sim_axi_io_model model;
+	/** Called before a register is read, may update the registers */
+	void (*read_hook)(void *ctx, uint32_t *regs, uint32_t offset);
+	/** Called after a register was written, may update the registers */
+	void (*write_hook)(void *ctx, uint32_t *regs, uint32_t offset);
+	/** Context passed to the hooks */
+	void *hook_ctx;
+};
+
+/**
+ * @struct linux_sim_axi_io_stats
+ * @brief Access counters of a simulated register region.
+ */
+struct linux_sim_axi_io_stats {
+	/** Number of register reads */
+	uint32_t reads;
+	/** Number of register writes */
+	uint32_t writes;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/*
+ * linux_sim_axi_io.c provides axi_io_read() and axi_io_write() on top of the
+ * simulated regions and is built instead of linux/axi_io.c.
+ */
+
+/* Add a simulated register region. */
+int32_t linux_sim_axi_io_add(const struct linux_sim_axi_io_region *region);
+
+/* Remove all the simulated register regions. */
+void linux_sim_axi_io_remove_all(void);
+
+/* Get the access counters of the region at base. */
+int32_t linux_sim_axi_io_get_stats(uint32_t base,
+				   struct linux_sim_axi_io_stats *stats);
+
+/* Clear the access counters of the region at base. */
+int32_t linux_sim_axi_io_reset_stats(uint32_t base);
+
+/* Get the number of accesses that hit no region. */
+uint32_t linux_sim_axi_io_get_unmapped(void);
+
+#endif // LINUX_SIM_AXI_IO_H_
@@ -0,0 +1,438 @@
+/***************************************************************************//**
+ *   @file   linux/linux_sim_i2c.c
+ *   @brief  Implementation of Linux platform simulated I2C device.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "util.h"
+#include "i2c.h"
+#include "linux_sim_i2c.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_sim_i2c_desc
+ * @brief Linux platform simulated I2C device descriptor
+ */
+struct linux_sim_i2c_desc {
+	/** Register access protocol */
+	const struct linux_sim_i2c_proto *proto;
+	/** Register map */
+	uint8_t *regs;
+	/** Number of registers */
+	uint32_t map_size;
+	/** Register pointer */
+	uint32_t ptr;
+	/** Bytes left in the current block read */
+	uint32_t block_left;
+	/** Read hook */
+	void (*read_hook)(void *ctx, uint8_t *regs, uint32_t addr);
+	/** Write hook */
+	void (*write_hook)(void *ctx, uint8_t *regs, uint32_t addr);
+	/** Hooks context */
+	void *hook_ctx;
+	/** Access counters */
+	struct linux_sim_i2c_stats stats;
+};
+
+/******************************************************************************/
+/************************ Variable Definitions ********************************/
+/******************************************************************************/
+
+/**
+ * @brief Register address byte followed by the data, the pointer advances on
+ * reads.
+ */
+const struct linux_sim_i2c_proto linux_sim_i2c_proto_reg8 = {
+	.addr_bytes = 1,
+	.read_inc = true,
+	.ptr_cmd = 0,
+	.block_read_cmd = 0,
+	.block_write_cmd = 0,
+};
+
+/**
+ * @brief AD5933 protocol: byte writes hold the register address, reads
+ * return the register selected by the pointer command. Block reads and
+ * writes advance the pointer.
+ */
+const struct linux_sim_i2c_proto linux_sim_i2c_proto_ad5933 = {
+	.addr_bytes = 1,
+	.read_inc = false,
+	.ptr_cmd = 0xB0,
+	.block_read_cmd = 0xA1,
+	.block_write_cmd = 0xA0,
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Initialize the simulated I2C device.
+ * @param desc - The I2C descriptor.
+ * @param param - The structure that contains the I2C parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_sim_i2c_init(struct i2c_desc **desc,
+			   const struct i2c_init_param *param)
+{
+	struct linux_sim_i2c_init_param *sim_init;
+	struct linux_sim_i2c_desc *sim_desc;
+	struct i2c_desc *descriptor;
+
+	if (!desc || !param || !param->extra)
+		return -EINVAL;
+
+	sim_init = param->extra;
+	if (!sim_init->proto || !sim_init->map_size ||
+	    sim_init->proto->addr_bytes < 1 || sim_init->proto->addr_bytes > 2)
+		return -EINVAL;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	sim_desc = calloc(1, sizeof(*sim_desc));
+	if (!sim_desc)
+		goto free_desc;
+
+	sim_desc->regs = calloc(sim_init->map_size, sizeof(*sim_desc->regs));
+	if (!sim_desc->regs)
+		goto free_sim;
+
+	if (sim_init->defaults)
+		memcpy(sim_desc->regs, sim_init->defaults, sim_init->map_size);
+
+	sim_desc->proto = sim_init->proto;
+	sim_desc->map_size = sim_init->map_size;
+	sim_desc->read_hook = sim_init->read_hook;
+	sim_desc->write_hook = sim_init->write_hook;
+	sim_desc->hook_ctx = sim_init->hook_ctx;
+
+	descriptor->max_speed_hz = param->max_speed_hz;
+	descriptor->slave_address = param->slave_address;
+	descriptor->extra = sim_desc;
+
+	*desc = descriptor;
+
+	return SUCCESS;
+free_sim:
+	free(sim_desc);
+free_desc:
+	free(descriptor);
+
+	return -ENOMEM;
+}
+
+/**
+ * @brief Write a register of the simulated device. Registers outside the
+ * map ignore writes.
+ * @param sim_desc - The simulated device descriptor.
+ * @param addr - Register address.
+ * @param val - Register value.
+ */
+static void linux_sim_i2c_reg_write(struct linux_sim_i2c_desc *sim_desc,
+				    uint32_t addr, uint8_t val)
+{
+	if (addr < sim_desc->map_size) {
+		sim_desc->regs[addr] = val;
+		if (sim_desc->write_hook)
+			sim_desc->write_hook(sim_desc->hook_ctx, sim_desc->regs,
+					     addr);
+	}
+	sim_desc->stats.reg_writes++;
+}
+
+/**
+ * @brief Read a register of the simulated device. Registers outside the
+ * map read as 0.
+ * @param sim_desc - The simulated device descriptor.
+ * @param addr - Register address.
+ * @return The register value.
+ */
+static uint8_t linux_sim_i2c_reg_read(struct linux_sim_i2c_desc *sim_desc,
+				      uint32_t addr)
+{
+	sim_desc->stats.reg_reads++;
+	if (addr >= sim_desc->map_size)
+		return 0;
+
+	if (sim_desc->read_hook)
+		sim_desc->read_hook(sim_desc->hook_ctx, sim_desc->regs, addr);
+
+	return sim_desc->regs[addr];
+}
+
+/**
+ * @brief Write data to the simulated device.
+ *
+ * The transfer is decoded as a pointer command, a block command or a
+ * register address followed by the data to write.
+ * @param desc - The I2C descriptor.
+ * @param data - Buffer that stores the transmission data.
+ * @param bytes_number - Number of bytes to write.
+ * @param stop_bit - Stop condition control, ignored.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_sim_i2c_write(struct i2c_desc *desc,
+			    uint8_t *data,
+			    uint8_t bytes_number,
+			    uint8_t stop_bit)
+{
+	const struct linux_sim_i2c_proto *proto;
+	struct linux_sim_i2c_desc *sim_desc;
+	uint32_t len;
+	uint32_t i;
+
+	if (!desc || !data)
+		return -EINVAL;
+
+	sim_desc = desc->extra;
+	proto = sim_desc->proto;
+
+	sim_desc->stats.transfers++;
+	sim_desc->stats.bytes += bytes_number;
+
+	if (!bytes_number)
+		return SUCCESS;
+
+	if (proto->ptr_cmd && data[0] == proto->ptr_cmd) {
+		if (bytes_number < 2)
+			return -EINVAL;
+		sim_desc->ptr = data[1];
+		sim_desc->block_left = 0;
+
+		return SUCCESS;
+	}
+
+	if (proto->block_read_cmd && data[0] == proto->block_read_cmd) {
+		if (bytes_number < 2)
+			return -EINVAL;
+		sim_desc->block_left = data[1];
+
+		return SUCCESS;
+	}
+
+	if (proto->block_write_cmd && data[0] == proto->block_write_cmd) {
+		if (bytes_number < 2)
+			return -EINVAL;
+		len = min_t(uint32_t, data[1], bytes_number - 2);
+		for (i = 0; i < len; i++)
+			linux_sim_i2c_reg_write(sim_desc, sim_desc->ptr++,
+						data[2 + i]);
+
+		return SUCCESS;
+	}
+
+	if (bytes_number < proto->addr_bytes)
+		return -EINVAL;
+
+	sim_desc->ptr = 0;
+	for (i = 0; i < proto->addr_bytes; i++)
+		sim_desc->ptr = (sim_desc->ptr << 8) | data[i];
+	sim_desc->block_left = 0;
+
+	for (i = proto->addr_bytes; i < bytes_number; i++)
+		linux_sim_i2c_reg_write(sim_desc, sim_desc->ptr + i -
+					proto->addr_bytes, data[i]);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read data from the simulated device, starting at the register
+ * pointer.
+ * @param desc - The I2C descriptor.
+ * @param data - Buffer that will store the received data.
+ * @param bytes_number - Number of bytes to read.
+ * @param stop_bit - Stop condition control, ignored.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_sim_i2c_read(struct i2c_desc *desc,
+			   uint8_t *data,
+			   uint8_t bytes_number,
+			   uint8_t stop_bit)
+{
+	const struct linux_sim_i2c_proto *proto;
+	struct linux_sim_i2c_desc *sim_desc;
+	uint32_t i;
+
+	if (!desc || !data)
+		return -EINVAL;
+
+	sim_desc = desc->extra;
+	proto = sim_desc->proto;
+
+	sim_desc->stats.transfers++;
+	sim_desc->stats.bytes += bytes_number;
+
+	for (i = 0; i < bytes_number; i++) {
+		data[i] = linux_sim_i2c_reg_read(sim_desc, sim_desc->ptr);
+		if (sim_desc->block_left) {
+			sim_desc->block_left--;
+			sim_desc->ptr++;
+		} else if (proto->read_inc) {
+			sim_desc->ptr++;
+		}
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by linux_sim_i2c_init().
+ * @param desc - The I2C descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_sim_i2c_remove(struct i2c_desc *desc)
+{
+	struct linux_sim_i2c_desc *sim_desc;
+
+	if (!desc)
+		return -EINVAL;
+
+	sim_desc = desc->extra;
+	free(sim_desc->regs);
+	free(sim_desc);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get a register of the simulated device without counting an access.
+ * @param desc - The I2C descriptor.
+ * @param addr - Register address.
+ * @param val - Register value.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_sim_i2c_reg_get(struct i2c_desc *desc, uint32_t addr,
+			      uint8_t *val)
+{
+	struct linux_sim_i2c_desc *sim_desc;
+
+	if (!desc || !val)
+		return -EINVAL;
+
+	sim_desc = desc->extra;
+	if (addr >= sim_desc->map_size)
+		return -EINVAL;
+
+	*val = sim_desc->regs[addr];
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set a register of the simulated device without counting an access.
+ * @param desc - The I2C descriptor.
+ * @param addr - Register address.
+ * @param val - Register value.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_sim_i2c_reg_set(struct i2c_desc *desc, uint32_t addr,
+			      uint8_t val)
+{
+	struct linux_sim_i2c_desc *sim_desc;
+
+	if (!desc)
+		return -EINVAL;
+
+	sim_desc = desc->extra;
+	if (addr >= sim_desc->map_size)
+		return -EINVAL;
+
+	sim_desc->regs[addr] = val;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the access counters of the simulated device.
+ * @param desc - The I2C descriptor.
+ * @param stats - Where the counters are copied.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_sim_i2c_get_stats(struct i2c_desc *desc,
+				struct linux_sim_i2c_stats *stats)
+{
+	struct linux_sim_i2c_desc *sim_desc;
+
+	if (!desc || !stats)
+		return -EINVAL;
+
+	sim_desc = desc->extra;
+	*stats = sim_desc->stats;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Clear the access counters of the simulated device.
+ * @param desc - The I2C descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_sim_i2c_reset_stats(struct i2c_desc *desc)
+{
+	struct linux_sim_i2c_desc *sim_desc;
+
+	if (!desc)
+		return -EINVAL;
+
+	sim_desc = desc->extra;
+	memset(&sim_desc->stats, 0, sizeof(sim_desc->stats));
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Linux platform simulated I2C device platform ops structure
+ */
+const struct i2c_platform_ops linux_sim_i2c_platform_ops = {
+	.i2c_ops_init = &linux_sim_i2c_init,
+	.i2c_ops_write = &linux_sim_i2c_write,
+	.i2c_ops_read = &linux_sim_i2c_read,
+	.i2c_ops_remove = &linux_sim_i2c_remove
+};
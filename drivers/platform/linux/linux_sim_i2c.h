@@ -0,0 +1,137 @@
+/***************************************************************************//**
+ *   @file   linux/linux_sim_i2c.h
+ *   @brief  Header file of Linux platform simulated I2C device.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef LINUX_SIM_I2C_H_
+#define LINUX_SIM_I2C_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "i2c.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_sim_i2c_proto
+ * @brief Register access protocol of the simulated device. A write starts
+ * with a big endian register address followed by the data written from that
+ * address on, and leaves the register pointer at the address. A read returns
+ * the registers starting at the pointer. Devices with command bytes, like the
+ * AD5933, set the pointer and the block transfers with dedicated commands.
+ */
+struct linux_sim_i2c_proto {
+	/** Length of the register address in bytes (1 or 2) */
+	uint8_t addr_bytes;
+	/** Register pointer advances on plain reads */
+	bool read_inc;
+	/** Command setting the register pointer, 0 if not used */
+	uint8_t ptr_cmd;
+	/** Command starting a block read: command, byte count, 0 if not used */
+	uint8_t block_read_cmd;
+	/** Command of a block write: command, byte count, data, 0 if not used */
+	uint8_t block_write_cmd;
+};
+
+/**
+ * @struct linux_sim_i2c_stats
+ * @brief Access counters of a simulated I2C device.
+ */
+struct linux_sim_i2c_stats {
+	/** Number of I2C transactions, reads and writes */
+	uint32_t transfers;
+	/** Number of data bytes transferred */
+	uint32_t bytes;
+	/** Number of registers read */
+	uint32_t reg_reads;
+	/** Number of registers written */
+	uint32_t reg_writes;
+};
+
+/**
+ * @struct linux_sim_i2c_init_param
+ * @brief Structure holding the initialization parameters for the simulated
+ * I2C device.
+ */
+struct linux_sim_i2c_init_param {
+	/** Register access protocol */
+	const struct linux_sim_i2c_proto *proto;
+	/** Number of 8-bit registers */
+	uint32_t map_size;
+	/** Initial register values (map_size bytes), NULL to start cleared */
+	const uint8_t *defaults;
+	/** Called before a register is read, may update the register map */
+	void (*read_hook)(void *ctx, uint8_t *regs, uint32_t addr);
+	/** Called after a register was written, may update the register map */
+	void (*write_hook)(void *ctx, uint8_t *regs, uint32_t addr);
+	/** Context passed to the hooks */
+	void *hook_ctx;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Register address byte followed by auto-incremented data. */
+extern const struct linux_sim_i2c_proto linux_sim_i2c_proto_reg8;
+
+/* AD5933 protocol: pointer set, block read and block write commands. */
+extern const struct linux_sim_i2c_proto linux_sim_i2c_proto_ad5933;
+
+/* Simulated I2C device platform ops. */
+extern const struct i2c_platform_ops linux_sim_i2c_platform_ops;
+
+/* Get a register of the simulated device without counting an access. */
+int32_t linux_sim_i2c_reg_get(struct i2c_desc *desc, uint32_t addr,
+			      uint8_t *val);
+
+/* Set a register of the simulated device without counting an access. */
+int32_t linux_sim_i2c_reg_set(struct i2c_desc *desc, uint32_t addr,
+			      uint8_t val);
+
+/* Get the access counters. */
+int32_t linux_sim_i2c_get_stats(struct i2c_desc *desc,
+				struct linux_sim_i2c_stats *stats);
+
+/* Clear the access counters. */
+int32_t linux_sim_i2c_reset_stats(struct i2c_desc *desc);
+
+#endif // LINUX_SIM_I2C_H_
@@ -0,0 +1,402 @@
+/***************************************************************************//**
+ *   @file   linux/linux_sim_spi.c
+ *   @brief  Implementation of Linux platform simulated SPI device.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "util.h"
+#include "spi.h"
+#include "linux_sim_spi.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_sim_spi_desc
+ * @brief Linux platform simulated SPI device descriptor
+ */
+struct linux_sim_spi_desc {
+	/** Register access protocol */
+	const struct linux_sim_spi_proto *proto;
+	/** Register map */
+	uint8_t *regs;
+	/** Number of registers */
+	uint32_t map_size;
+	/** Read hook */
+	void (*read_hook)(void *ctx, uint8_t *regs, uint32_t addr);
+	/** Write hook */
+	void (*write_hook)(void *ctx, uint8_t *regs, uint32_t addr);
+	/** Hooks context */
+	void *hook_ctx;
+	/** Access counters */
+	struct linux_sim_spi_stats stats;
+};
+
+/******************************************************************************/
+/************************ Variable Definitions ********************************/
+/******************************************************************************/
+
+/**
+ * @brief AD9361 register protocol: write bit, 3-bit byte count, 10-bit
+ * address, descending burst addressing.
+ */
+const struct linux_sim_spi_proto linux_sim_spi_proto_ad9361 = {
+	.cmd_bytes = 2,
+	.rd_mask = 0x8000,
+	.rd_value = 0,
+	.addr_mask = 0x3FF,
+	.len_mask = 0x7000,
+	.len_shift = 12,
+	.addr_dec = true,
+};
+
+/**
+ * @brief ADI 3/4-wire register protocol used by the AD9081 HAL: read bit,
+ * 15-bit address, burst length given by the transfer size.
+ */
+const struct linux_sim_spi_proto linux_sim_spi_proto_ad9081 = {
+	.cmd_bytes = 2,
+	.rd_mask = 0x8000,
+	.rd_value = 0x8000,
+	.addr_mask = 0x7FFF,
+	.len_mask = 0,
+	.len_shift = 0,
+	.addr_dec = false,
+};
+
+/**
+ * @brief ADRV9001 register protocol with SPI streaming off: read bit, 15-bit
+ * address and one data byte per instruction, several instructions in a
+ * transfer.
+ */
+const struct linux_sim_spi_proto linux_sim_spi_proto_adrv9001 = {
+	.cmd_bytes = 2,
+	.rd_mask = 0x8000,
+	.rd_value = 0x8000,
+	.addr_mask = 0x7FFF,
+	.len_mask = 0,
+	.len_shift = 0,
+	.addr_dec = false,
+	.single_instr = true,
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Initialize the simulated SPI device.
+ * @param desc - The SPI descriptor.
+ * @param param - The structure that contains the SPI parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_sim_spi_init(struct spi_desc **desc,
+			   const struct spi_init_param *param)
+{
+	struct linux_sim_spi_init_param *sim_init;
+	struct linux_sim_spi_desc *sim_desc;
+	struct spi_desc *descriptor;
+
+	if (!desc || !param || !param->extra)
+		return -EINVAL;
+
+	sim_init = param->extra;
+	if (!sim_init->proto || !sim_init->map_size ||
+	    sim_init->proto->cmd_bytes < 1 || sim_init->proto->cmd_bytes > 4)
+		return -EINVAL;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	sim_desc = calloc(1, sizeof(*sim_desc));
+	if (!sim_desc)
+		goto free_desc;
+
+	sim_desc->regs = calloc(sim_init->map_size, sizeof(*sim_desc->regs));
+	if (!sim_desc->regs)
+		goto free_sim;
+
+	if (sim_init->defaults)
+		memcpy(sim_desc->regs, sim_init->defaults, sim_init->map_size);
+
+	sim_desc->proto = sim_init->proto;
+	sim_desc->map_size = sim_init->map_size;
+	sim_desc->read_hook = sim_init->read_hook;
+	sim_desc->write_hook = sim_init->write_hook;
+	sim_desc->hook_ctx = sim_init->hook_ctx;
+
+	descriptor->max_speed_hz = param->max_speed_hz;
+	descriptor->chip_select = param->chip_select;
+	descriptor->mode = param->mode;
+	descriptor->bit_order = param->bit_order;
+	descriptor->extra = sim_desc;
+
+	*desc = descriptor;
+
+	return SUCCESS;
+free_sim:
+	free(sim_desc);
+free_desc:
+	free(descriptor);
+
+	return -ENOMEM;
+}
+
+/**
+ * @brief Execute one command on the simulated device.
+ * @param sim_desc - The simulated device.
+ * @param data - The command followed by the register data.
+ * @param bytes_number - Number of bytes of the command and of its data.
+ */
+static void linux_sim_spi_access(struct linux_sim_spi_desc *sim_desc,
+				 uint8_t *data, uint32_t bytes_number)
+{
+	const struct linux_sim_spi_proto *proto = sim_desc->proto;
+	uint32_t cmd = 0;
+	uint32_t addr;
+	uint32_t len;
+	uint32_t i;
+	bool rd;
+
+	for (i = 0; i < proto->cmd_bytes; i++) {
+		cmd = (cmd << 8) | data[i];
+		data[i] = 0;
+	}
+
+	rd = (cmd & proto->rd_mask) == proto->rd_value;
+	addr = cmd & proto->addr_mask;
+	len = bytes_number - proto->cmd_bytes;
+	if (proto->len_mask)
+		len = min_t(uint32_t, len,
+			    ((cmd & proto->len_mask) >> proto->len_shift) + 1);
+
+	for (i = 0; i < len; i++) {
+		if (addr < sim_desc->map_size) {
+			if (rd) {
+				if (sim_desc->read_hook)
+					sim_desc->read_hook(sim_desc->hook_ctx,
+							    sim_desc->regs, addr);
+				data[proto->cmd_bytes + i] = sim_desc->regs[addr];
+			} else {
+				sim_desc->regs[addr] = data[proto->cmd_bytes + i];
+				if (sim_desc->write_hook)
+					sim_desc->write_hook(sim_desc->hook_ctx,
+							     sim_desc->regs, addr);
+			}
+		} else if (rd) {
+			data[proto->cmd_bytes + i] = 0;
+		}
+
+		if (rd)
+			sim_desc->stats.reg_reads++;
+		else
+			sim_desc->stats.reg_writes++;
+
+		addr = (proto->addr_dec ? addr - 1 : addr + 1) & proto->addr_mask;
+	}
+}
+
+/**
+ * @brief Execute a register access on the simulated device.
+ *
+ * The data following the command is replaced with the register values for a
+ * read and stored in the register map for a write. Registers outside the
+ * map read as 0 and ignore writes. With a single instruction protocol the
+ * transfer is split in commands of one register each.
+ * @param desc - The SPI descriptor.
+ * @param data - The buffer with the transmitted/received data.
+ * @param bytes_number - Number of bytes to write/read.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_sim_spi_write_and_read(struct spi_desc *desc,
+				     uint8_t *data,
+				     uint16_t bytes_number)
+{
+	const struct linux_sim_spi_proto *proto;
+	struct linux_sim_spi_desc *sim_desc;
+	uint32_t instr_bytes;
+	uint32_t i;
+
+	if (!desc || !data)
+		return -EINVAL;
+
+	sim_desc = desc->extra;
+	proto = sim_desc->proto;
+
+	sim_desc->stats.transfers++;
+	sim_desc->stats.bytes += bytes_number;
+
+	if (bytes_number < proto->cmd_bytes)
+		return -EINVAL;
+
+	if (!proto->single_instr) {
+		linux_sim_spi_access(sim_desc, data, bytes_number);
+
+		return SUCCESS;
+	}
+
+	instr_bytes = proto->cmd_bytes + 1;
+	if (bytes_number % instr_bytes)
+		return -EINVAL;
+
+	for (i = 0; i < bytes_number; i += instr_bytes)
+		linux_sim_spi_access(sim_desc, data + i, instr_bytes);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by linux_sim_spi_init().
+ * @param desc - The SPI descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_sim_spi_remove(struct spi_desc *desc)
+{
+	struct linux_sim_spi_desc *sim_desc;
+
+	if (!desc)
+		return -EINVAL;
+
+	sim_desc = desc->extra;
+	free(sim_desc->regs);
+	free(sim_desc);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get a register of the simulated device without counting an access.
+ * @param desc - The SPI descriptor.
+ * @param addr - Register address.
+ * @param val - Register value.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_sim_spi_reg_get(struct spi_desc *desc, uint32_t addr,
+			      uint8_t *val)
+{
+	struct linux_sim_spi_desc *sim_desc;
+
+	if (!desc || !val)
+		return -EINVAL;
+
+	sim_desc = desc->extra;
+	if (addr >= sim_desc->map_size)
+		return -EINVAL;
+
+	*val = sim_desc->regs[addr];
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set a register of the simulated device without counting an access.
+ * @param desc - The SPI descriptor.
+ * @param addr - Register address.
+ * @param val - Register value.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_sim_spi_reg_set(struct spi_desc *desc, uint32_t addr,
+			      uint8_t val)
+{
+	struct linux_sim_spi_desc *sim_desc;
+
+	if (!desc)
+		return -EINVAL;
+
+	sim_desc = desc->extra;
+	if (addr >= sim_desc->map_size)
+		return -EINVAL;
+
+	sim_desc->regs[addr] = val;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the access counters of the simulated device.
+ * @param desc - The SPI descriptor.
+ * @param stats - Where the counters are copied.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_sim_spi_get_stats(struct spi_desc *desc,
+				struct linux_sim_spi_stats *stats)
+{
+	struct linux_sim_spi_desc *sim_desc;
+
+	if (!desc || !stats)
+		return -EINVAL;
+
+	sim_desc = desc->extra;
+	*stats = sim_desc->stats;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Clear the access counters of the simulated device.
+ * @param desc - The SPI descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_sim_spi_reset_stats(struct spi_desc *desc)
+{
+	struct linux_sim_spi_desc *sim_desc;
+
+	if (!desc)
+		return -EINVAL;
+
+	sim_desc = desc->extra;
+	memset(&sim_desc->stats, 0, sizeof(sim_desc->stats));
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Linux platform simulated SPI device platform ops structure
+ */
+const struct spi_platform_ops linux_sim_spi_platform_ops = {
+	.spi_ops_init = &linux_sim_spi_init,
+	.spi_ops_write_and_read = &linux_sim_spi_write_and_read,
+	.spi_ops_remove = &linux_sim_spi_remove
+};
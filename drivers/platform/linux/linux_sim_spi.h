@@ -0,0 +1,147 @@
+/***************************************************************************//**
+ *   @file   linux/linux_sim_spi.h
+ *   @brief  Header file of Linux platform simulated SPI device.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef LINUX_SIM_SPI_H_
+#define LINUX_SIM_SPI_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "spi.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_sim_spi_proto
+ * @brief Register access protocol of the simulated device. Every transfer
+ * starts with a big endian command word holding the direction and the
+ * register address, followed by the register data.
+ */
+struct linux_sim_spi_proto {
+	/** Length of the command word in bytes (1 to 4) */
+	uint8_t cmd_bytes;
+	/** Command bits selecting the direction */
+	uint32_t rd_mask;
+	/** Value of the direction bits for a read */
+	uint32_t rd_value;
+	/** Command bits holding the register address */
+	uint32_t addr_mask;
+	/** Command bits holding the data length - 1, 0 if set by transfer size */
+	uint32_t len_mask;
+	/** Position of the data length field */
+	uint8_t len_shift;
+	/** Register address decrements (true) or increments in a burst */
+	bool addr_dec;
+	/**
+	 * Every register has its own command word: a transfer is a sequence
+	 * of command and data pairs instead of a burst
+	 */
+	bool single_instr;
+};
+
+/**
+ * @struct linux_sim_spi_stats
+ * @brief Access counters of a simulated SPI device.
+ */
+struct linux_sim_spi_stats {
+	/** Number of SPI transfers */
+	uint32_t transfers;
+	/** Number of bytes clocked, command included */
+	uint32_t bytes;
+	/** Number of registers read */
+	uint32_t reg_reads;
+	/** Number of registers written */
+	uint32_t reg_writes;
+};
+
+/**
+ * @struct linux_sim_spi_init_param
+ * @brief Structure holding the initialization parameters for the simulated
+ * SPI device.
+ */
+struct linux_sim_spi_init_param {
+	/** Register access protocol */
+	const struct linux_sim_spi_proto *proto;
+	/** Number of 8-bit registers */
+	uint32_t map_size;
+	/** Initial register values (map_size bytes), NULL to start cleared */
+	const uint8_t *defaults;
+	/** Called before a register is read, may update the register map */
+	void (*read_hook)(void *ctx, uint8_t *regs, uint32_t addr);
+	/** Called after a register was written, may update the register map */
+	void (*write_hook)(void *ctx, uint8_t *regs, uint32_t addr);
+	/** Context passed to the hooks */
+	void *hook_ctx;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* AD9361 register protocol: write bit, 3-bit byte count, 10-bit address. */
+extern const struct linux_sim_spi_proto linux_sim_spi_proto_ad9361;
+
+/* ADI 3/4-wire register protocol used by the AD9081 HAL. */
+extern const struct linux_sim_spi_proto linux_sim_spi_proto_ad9081;
+
+/* ADRV9001 register protocol with one register per command. */
+extern const struct linux_sim_spi_proto linux_sim_spi_proto_adrv9001;
+
+/* Simulated SPI device platform ops. */
+extern const struct spi_platform_ops linux_sim_spi_platform_ops;
+
+/* Get a register of the simulated device without counting an access. */
+int32_t linux_sim_spi_reg_get(struct spi_desc *desc, uint32_t addr,
+			      uint8_t *val);
+
+/* Set a register of the simulated device without counting an access. */
+int32_t linux_sim_spi_reg_set(struct spi_desc *desc, uint32_t addr,
+			      uint8_t val);
+
+/* Get the access counters. */
+int32_t linux_sim_spi_get_stats(struct spi_desc *desc,
+				struct linux_sim_spi_stats *stats);
+
+/* Clear the access counters. */
+int32_t linux_sim_spi_reset_stats(struct spi_desc *desc);
+
+#endif // LINUX_SIM_SPI_H_
@@ -39,6 +39,13 @@
 #include "delay.h"
 #include "stm32_hal.h"
 
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+/** Last value read from the 32-bit cycle counter */
+static uint32_t clock_last;
+/** Core clock cycles counted by get_time_us() */
+static uint64_t clock_cycles;
+#endif
+
 /**
  * @brief Generate microseconds delay.
  * @param usecs - Delay in microseconds.
@@ -59,3 +66,37 @@ void mdelay(uint32_t msecs)
 {
 	HAL_Delay(msecs);
 }
+
+/**
+ * @brief Get the time of a free running microsecond clock.
+ *
+ * Cores with a DWT unit use the cycle counter, which has to be read at least
+ * once per wrap period (2^32 core clock cycles). The others (Cortex-M0/M0+)
+ * fall back to the HAL millisecond tick.
+ * @return The clock value, wrapping around every 2^32 us.
+ */
+uint32_t get_time_us(void)
+{
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+	uint32_t primask;
+	uint32_t cnt;
+	uint64_t cycles;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+		clock_last = DWT->CYCCNT;
+	}
+	cnt = DWT->CYCCNT;
+	clock_cycles += cnt - clock_last;
+	clock_last = cnt;
+	cycles = clock_cycles;
+	__set_PRIMASK(primask);
+
+	return (uint32_t)(cycles / (HAL_RCC_GetHCLKFreq() / 1000000u));
+#else
+	return HAL_GetTick() * 1000u;
+#endif
+}
@@ -0,0 +1,123 @@
+/***************************************************************************//**
+ *   @file   stm32/stm32_trace_clock.c
+ *   @brief  Implementation of stm32 platform trace clock.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "stm32_hal.h"
+#include "trace.h"
+#include "error.h"
+
+/******************************************************************************/
+/****************************** Global Variables*******************************/
+/******************************************************************************/
+
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+/** Last value read from the 32-bit cycle counter */
+static uint32_t trace_clock_last;
+/** Number of times the cycle counter wrapped */
+static uint32_t trace_clock_wraps;
+#endif
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Start the trace clock.
+ *
+ * Cores with a DWT unit use the cycle counter, the others (Cortex-M0/M0+)
+ * fall back to the HAL millisecond tick.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t trace_clock_init(void)
+{
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	/* get_time_us() also reads the counter, so it is never reset */
+	trace_clock_last = DWT->CYCCNT;
+	trace_clock_wraps = 0;
+#endif
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read the trace clock.
+ *
+ * The 32-bit cycle counter is extended to 64 bits in software, so it has to
+ * be read at least once per wrap period (2^32 core clock cycles).
+ * @return The current trace clock value.
+ */
+uint64_t trace_clock_get(void)
+{
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+	uint32_t primask;
+	uint32_t wraps;
+	uint32_t cnt;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	cnt = DWT->CYCCNT;
+	if (cnt < trace_clock_last)
+		trace_clock_wraps++;
+	trace_clock_last = cnt;
+	wraps = trace_clock_wraps;
+	__set_PRIMASK(primask);
+
+	return ((uint64_t)wraps << 32) | cnt;
+#else
+	return HAL_GetTick();
+#endif
+}
+
+/**
+ * @brief Get the trace clock frequency.
+ * @return The trace clock frequency in Hz.
+ */
+uint32_t trace_clock_hz(void)
+{
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+	return HAL_RCC_GetHCLKFreq();
+#else
+	return 1000;
+#endif
+}
@@ -43,6 +43,19 @@
 
 #include "delay.h"
 #include <sleep.h>
+#include <xparameters.h>
+#ifdef _XPARAMETERS_PS_H_
+#include <xtime_l.h>
+#endif
+
+/******************************************************************************/
+/****************************** Global Variables*******************************/
+/******************************************************************************/
+
+#ifndef _XPARAMETERS_PS_H_
+/** MicroBlaze has no free running timer, time advances with the delays */
+static uint32_t sw_time_us;
+#endif
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -59,6 +72,7 @@ void udelay(uint32_t usecs)
 	usleep(usecs);
 #else
 	usleep(usecs / 20);	// FIXME
+	sw_time_us += usecs;
 #endif
 }
 
@@ -73,5 +87,26 @@ void mdelay(uint32_t msecs)
 	usleep(msecs * 1000);
 #else
 	usleep(msecs * 50);	// FIXME
+	sw_time_us += msecs * 1000;
+#endif
+}
+
+/**
+ * @brief Get the time of a free running microsecond clock.
+ *
+ * Zynq and ZynqMP read the global timer. MicroBlaze designs have no such
+ * timer, so there the clock only advances by the udelay() and mdelay() calls.
+ * @return The clock value, wrapping around every 2^32 us.
+ */
+uint32_t get_time_us(void)
+{
+#ifdef _XPARAMETERS_PS_H_
+	XTime t;
+
+	XTime_GetTime(&t);
+
+	return (uint32_t)(t / (COUNTS_PER_SECOND / 1000000u));
+#else
+	return sw_time_us;
 #endif
 }
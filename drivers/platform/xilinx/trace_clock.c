@@ -0,0 +1,107 @@
+/***************************************************************************//**
+ *   @file   trace_clock.c
+ *   @brief  Implementation of Xilinx platform trace clock.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <xparameters.h>
+#ifdef _XPARAMETERS_PS_H_
+#include <xtime_l.h>
+#endif
+#include "trace.h"
+#include "error.h"
+
+/******************************************************************************/
+/****************************** Global Variables*******************************/
+/******************************************************************************/
+
+#ifndef _XPARAMETERS_PS_H_
+/** Event counter used as clock when no global timer is available */
+static uint32_t trace_clock_count;
+#endif
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Start the trace clock.
+ *
+ * On Zynq and ZynqMP the free running 64-bit global timer is used. It is
+ * started by the boot code, so nothing needs to be done here.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t trace_clock_init(void)
+{
+	return SUCCESS;
+}
+
+/**
+ * @brief Read the trace clock.
+ *
+ * MicroBlaze designs have no global timer, so the records are only numbered
+ * in the order they were taken.
+ * @return The current trace clock value.
+ */
+uint64_t trace_clock_get(void)
+{
+#ifdef _XPARAMETERS_PS_H_
+	XTime t;
+
+	XTime_GetTime(&t);
+
+	return t;
+#else
+	return __atomic_add_fetch(&trace_clock_count, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+/**
+ * @brief Get the trace clock frequency.
+ * @return The trace clock frequency in Hz, 0 if the clock is an event
+ * counter.
+ */
+uint32_t trace_clock_hz(void)
+{
+#ifdef _XPARAMETERS_PS_H_
+	return COUNTS_PER_SECOND;
+#else
+	return 0;
+#endif
+}
@@ -35,12 +35,13 @@
 #include <xparameters.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "error.h"
+#include "util.h"
+#include "irq.h"
 #include "uart.h"
 #include "uart_extra.h"
 #ifdef XPAR_XUARTPS_NUM_INSTANCES
-#include "irq.h"
-#include "fifo.h"
 #include <xil_exception.h>
 #include <xuartps.h>
 #endif
@@ -53,170 +54,333 @@
 /********************** Macros and Constants Definitions **********************/
 /******************************************************************************/
 
-#define WRITE_SIZE 255
+/** Depth of the AXI UART Lite RX and TX FIFOs */
+#define UART_PL_FIFO_SIZE	16
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
+/**
+ * @brief Get the number of bytes stored in a ring.
+ * @param ring - The ring.
+ * @return Number of bytes available for reading.
+ */
+static inline uint32_t uart_ring_count(struct xil_uart_ring *ring)
+{
+	return ring->head - ring->tail;
+}
+
+/**
+ * @brief Copy up to len bytes into a ring.
+ *
+ * Only the producer side moves head, so the function is safe to be called
+ * concurrently with uart_ring_pop() from the interrupt handler. head is
+ * published with release semantics, after the bytes are copied.
+ * @param ring - The ring.
+ * @param data - Bytes to be stored.
+ * @param len - Number of bytes to be stored.
+ * @return Number of bytes actually stored.
+ */
+static uint32_t uart_ring_push(struct xil_uart_ring *ring, const uint8_t *data,
+			       uint32_t len)
+{
+	uint32_t head = ring->head;
+	uint32_t idx = head & (UART_RING_SIZE - 1);
+	uint32_t chunk;
+
+	len = min(len, UART_RING_SIZE -
+		  (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE)));
+	chunk = min(len, UART_RING_SIZE - idx);
+	memcpy(&ring->buff[idx], data, chunk);
+	memcpy(ring->buff, data + chunk, len - chunk);
+	/* The bytes must be visible to the consumer before the new head */
+	__atomic_store_n(&ring->head, head + len, __ATOMIC_RELEASE);
+
+	return len;
+}
+
+/**
+ * @brief Copy up to len bytes out of a ring.
+ * @param ring - The ring.
+ * @param data - Buffer where the bytes are copied.
+ * @param len - Maximum number of bytes to be copied.
+ * @return Number of bytes actually copied.
+ */
+static uint32_t uart_ring_pop(struct xil_uart_ring *ring, uint8_t *data,
+			      uint32_t len)
+{
+	uint32_t tail = ring->tail;
+	uint32_t idx = tail & (UART_RING_SIZE - 1);
+	uint32_t chunk;
+
+	len = min(len, __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - tail);
+	chunk = min(len, UART_RING_SIZE - idx);
+	memcpy(data, &ring->buff[idx], chunk);
+	memcpy(data + chunk, ring->buff, len - chunk);
+	/* Done with the bytes before the producer may overwrite them */
+	__atomic_store_n(&ring->tail, tail + len, __ATOMIC_RELEASE);
+
+	return len;
+}
+
+/**
+ * @brief Move received bytes into the RX ring.
+ * @param xil_uart_desc - Platform specific UART descriptor.
+ * @param data - Received bytes.
+ * @param len - Number of received bytes.
+ */
+static void uart_rx_store(struct xil_uart_desc *xil_uart_desc,
+			  const uint8_t *data, uint32_t len)
+{
+	/* Bytes not fitting in the ring are lost, account them as errors */
+	if (uart_ring_push(&xil_uart_desc->rx_ring, data, len) != len)
+		xil_uart_desc->total_error_count++;
+}
+
+#ifdef XUARTLITE_H
+/**
+ * @brief Service the UART_PL FIFOs: empty the RX FIFO into the RX ring and
+ * refill the TX FIFO from the TX ring.
+ *
+ * Called from the interrupt handler or, when the UART is polled, from the
+ * read and write functions.
+ * @param xil_uart_desc - Platform specific UART descriptor.
+ */
+static void uart_pl_service(struct xil_uart_desc *xil_uart_desc)
+{
+	XUartLite *instance = xil_uart_desc->instance;
+	uint8_t buff[UART_PL_FIFO_SIZE];
+	uint32_t status;
+	uint32_t len = 0;
+
+	while (true) {
+		status = XUartLite_GetStatusReg(instance->RegBaseAddress);
+		if (status & (XUL_SR_OVERRUN_ERROR | XUL_SR_FRAMING_ERROR |
+			      XUL_SR_PARITY_ERROR))
+			xil_uart_desc->total_error_count++;
+		if (!(status & XUL_SR_RX_FIFO_VALID_DATA) ||
+		    len == UART_PL_FIFO_SIZE) {
+			uart_rx_store(xil_uart_desc, buff, len);
+			if (!(status & XUL_SR_RX_FIFO_VALID_DATA))
+				break;
+			len = 0;
+		}
+		buff[len++] = XUartLite_ReadReg(instance->RegBaseAddress,
+						XUL_RX_FIFO_OFFSET);
+	}
+
+	if (!(status & XUL_SR_TX_FIFO_EMPTY))
+		return;
+
+	len = uart_ring_pop(&xil_uart_desc->tx_ring, buff, UART_PL_FIFO_SIZE);
+	xil_uart_desc->tx_busy = len != 0;
+	for (uint32_t i = 0; i < len; i++)
+		XUartLite_WriteReg(instance->RegBaseAddress, XUL_TX_FIFO_OFFSET,
+				   buff[i]);
+}
+
+/**
+ * @brief Wait until the TX ring and the TX FIFO of a polled UART_PL are
+ * empty, servicing the FIFOs meanwhile.
+ * @param xil_uart_desc - Platform specific UART descriptor.
+ */
+static void uart_pl_tx_drain(struct xil_uart_desc *xil_uart_desc)
+{
+	XUartLite *instance = xil_uart_desc->instance;
+
+	do {
+		uart_pl_service(xil_uart_desc);
+	} while (uart_ring_count(&xil_uart_desc->tx_ring) ||
+		 !(XUartLite_GetStatusReg(instance->RegBaseAddress) &
+		   XUL_SR_TX_FIFO_EMPTY));
+}
+
+/**
+ * @brief UART_PL interrupt handler.
+ * @param ctx - Platform specific UART descriptor.
+ */
+static void uart_pl_irq_handler(void *ctx)
+{
+	uart_pl_service(ctx);
+}
+#endif // XUARTLITE_H
+
 #ifdef XUARTPS_H
 /**
- * @brief Save received data into fifo.
- * @param desc - Instance descriptor containing a fifo element.
- * @return SUCCESS in case of success, FAILURE otherwise.
+ * @brief Hand the next chunk of the TX ring to the Xilinx UART_PS driver.
+ * @param xil_uart_desc - Platform specific UART descriptor.
  */
-static int32_t uart_fifo_insert(struct uart_desc *desc)
+static void uart_ps_tx_start(struct xil_uart_desc *xil_uart_desc)
+{
+	uint32_t len;
+
+	len = uart_ring_pop(&xil_uart_desc->tx_ring, xil_uart_desc->tx_buff,
+			    UART_BUFF_LENGTH);
+	xil_uart_desc->tx_busy = len != 0;
+	if (len)
+		XUartPs_Send(xil_uart_desc->instance, xil_uart_desc->tx_buff, len);
+}
+#endif // XUARTPS_H
+
+/**
+ * @brief Start transmitting the TX ring if the transmitter is idle.
+ * @param xil_uart_desc - Platform specific UART descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t uart_tx_kick(struct xil_uart_desc *xil_uart_desc)
 {
 	int32_t ret;
-	struct xil_uart_desc *xil_uart_desc = desc->extra;
-	struct irq_ctrl_desc *irq_desc = xil_uart_desc->irq_desc;
 
-	if (xil_uart_desc->bytes_received > 0) {
-		ret = irq_disable(irq_desc, xil_uart_desc->irq_id);
-		if (ret < 0)
-			return ret;
-		ret = fifo_insert(&xil_uart_desc->fifo, xil_uart_desc->buff,
-				  xil_uart_desc->bytes_received);
-		if (ret < 0)
-			return ret;
-		xil_uart_desc->bytes_received = 0;
+	if (!xil_uart_desc->irq_enabled) {
+#ifdef XUARTLITE_H
+		uart_pl_service(xil_uart_desc);
+#endif
+		return SUCCESS;
+	}
+
+	/* Nothing to do, the interrupt handler keeps draining the ring */
+	if (xil_uart_desc->tx_busy)
+		return SUCCESS;
+
+	ret = irq_disable(xil_uart_desc->irq_desc, xil_uart_desc->irq_id);
+	if (ret < 0)
+		return ret;
+
+	if (!xil_uart_desc->tx_busy) {
 		switch(xil_uart_desc->type) {
 		case UART_PS:
-			XUartPs_Recv(xil_uart_desc->instance, (u8*)(xil_uart_desc->buff),
-				     UART_BUFF_LENGTH);
+#ifdef XUARTPS_H
+			uart_ps_tx_start(xil_uart_desc);
+#endif
 			break;
 		case UART_PL:
-
+#ifdef XUARTLITE_H
+			uart_pl_service(xil_uart_desc);
+#endif
 			break;
 		default:
-			return FAILURE;
 			break;
 		}
-		ret = irq_enable(irq_desc, xil_uart_desc->irq_id);
-		if (ret < 0)
-			return ret;
 	}
 
-	return SUCCESS;
+	return irq_enable(xil_uart_desc->irq_desc, xil_uart_desc->irq_id);
 }
-#endif // XUARTPS_H
 
 /**
- * @brief Read byte from fifo.
- * @param desc - Instance descriptor containing a fifo element
- * @param data - read value.
- * @return SUCCESS in case of success, FAILURE otherwise.
+ * @brief Read the bytes already received by the UART device.
+ * @param desc - Instance of UART.
+ * @param data - Pointer to buffer where the data is copied.
+ * @param bytes_number - Maximum number of bytes to read.
+ * @return Number of bytes read. It may be 0 if nothing was received.
  */
-static int32_t uart_read_byte(struct uart_desc *desc, uint8_t *data)
+int32_t uart_read_nonblocking(struct uart_desc *desc, uint8_t *data,
+			      uint32_t bytes_number)
 {
-	struct xil_uart_desc *xil_uart_desc = desc->extra;
-#ifdef XUARTLITE_H
-	XUartLite *instance = xil_uart_desc->instance;
-#endif
-#ifdef XUARTPS_H
-	int32_t ret;
-#endif
-
-	switch(xil_uart_desc->type) {
-	case UART_PS:
-#ifdef XUARTPS_H
-		while (xil_uart_desc->fifo == NULL) {
-			/* nothing in fifo, wait until something is received */
-			ret = uart_fifo_insert(desc);
-			if (ret < 0)
-				return ret;
-		}
+	struct xil_uart_desc *xil_uart_desc;
 
-		*data = xil_uart_desc->fifo->data[xil_uart_desc->fifo_read_offset];
-		xil_uart_desc->fifo_read_offset++;
+	if (!desc || !data)
+		return FAILURE;
 
-		if (xil_uart_desc->fifo->len - xil_uart_desc->fifo_read_offset <= 0) {
-			xil_uart_desc->fifo_read_offset = 0;
-			xil_uart_desc->fifo = fifo_remove(xil_uart_desc->fifo);
-		}
-#endif // XUARTPS_H
-		break;
-	case UART_PL:
+	xil_uart_desc = desc->extra;
 #ifdef XUARTLITE_H
-		while (!(Xil_In32(instance->RegBaseAddress + XUL_STATUS_REG_OFFSET) &
-			 XUL_SR_RX_FIFO_VALID_DATA));
-		*data = Xil_In32(instance->RegBaseAddress + XUL_RX_FIFO_OFFSET);
-#endif // XUARTLITE_H
-		break;
-	default:
-		break;
-	}
+	if (!xil_uart_desc->irq_enabled)
+		uart_pl_service(xil_uart_desc);
+#endif
 
-	return SUCCESS;
+	return uart_ring_pop(&xil_uart_desc->rx_ring, data, bytes_number);
 }
 
 /**
  * @brief Read data from UART device.
+ *
+ * Returns as soon as bytes_number bytes are available, copying whole chunks
+ * from the RX ring at a time.
  * @param desc - Instance of UART.
  * @param data - Pointer to buffer containing data.
  * @param bytes_number - Number of bytes to read.
- * @return SUCCESS in case of success, FAILURE otherwise.
+ * @return Number of bytes read in case of success, negative error code
+ * otherwise.
  */
 int32_t uart_read(struct uart_desc *desc, uint8_t *data, uint32_t bytes_number)
 {
-	ssize_t ret;
-	for (uint32_t i = 0; i < bytes_number; i++) {
-		ret = uart_read_byte(desc, &data[i]);
+	uint32_t offset = 0;
+	int32_t ret;
+
+	while (offset < bytes_number) {
+		ret = uart_read_nonblocking(desc, data + offset,
+					    bytes_number - offset);
 		if (ret < 0)
 			return ret;
+		offset += ret;
 	}
 
 	return bytes_number;
 }
 
+/**
+ * @brief Queue data for transmission on the UART device.
+ *
+ * A polled UART_PL only moves the TX ring to the FIFO from the uart_*()
+ * calls, use uart_write() to make sure the data is sent.
+ * @param desc - Instance of UART.
+ * @param data - Pointer to buffer containing data.
+ * @param bytes_number - Maximum number of bytes to queue.
+ * @return Number of bytes queued, it may be less than bytes_number if the TX
+ * ring is full. Negative error code in case of failure.
+ */
+int32_t uart_write_nonblocking(struct uart_desc *desc, const uint8_t *data,
+			       uint32_t bytes_number)
+{
+	struct xil_uart_desc *xil_uart_desc;
+	uint32_t len;
+	int32_t ret;
+
+	if (!desc || !data)
+		return FAILURE;
+
+	xil_uart_desc = desc->extra;
+	len = uart_ring_push(&xil_uart_desc->tx_ring, data, bytes_number);
+	ret = uart_tx_kick(xil_uart_desc);
+	if (ret < 0)
+		return ret;
+
+	return len;
+}
+
 /**
  * @brief Write data to UART device.
+ *
+ * With an interrupt, returns once all the data is queued in the TX ring and
+ * the transmission is completed from the interrupt handler. A polled UART_PL
+ * returns once all the data left the TX FIFO.
  * @param desc - Instance of UART.
  * @param data - Pointer to buffer containing data.
- * @param bytes_number - Number of bytes to read.
- * @return SUCCESS in case of success, FAILURE otherwise.
+ * @param bytes_number - Number of bytes to write.
+ * @return SUCCESS in case of success, negative error code otherwise.
  */
 int32_t uart_write(struct uart_desc *desc, const uint8_t *data,
 		   uint32_t bytes_number)
 {
-	struct xil_uart_desc *xil_uart_desc = desc->extra;
 #ifdef XUARTLITE_H
-	XUartLite *instance = xil_uart_desc->instance;
-#endif
-#ifdef XUARTPS_H
-	size_t bytes_sent, len;
+	struct xil_uart_desc *xil_uart_desc = desc->extra;
 #endif
 	uint32_t offset = 0;
+	int32_t ret;
 
-	switch(xil_uart_desc->type) {
-	case UART_PS:
-#ifdef XUARTPS_H
-		while (offset < bytes_number) {
-			len = ((bytes_number - offset) < WRITE_SIZE) ? (bytes_number - offset) :
-			      WRITE_SIZE;
-			bytes_sent = XUartPs_Send(xil_uart_desc->instance, (u8*)(data + offset),
-						  len);
-			offset += bytes_sent;
-		}
-		break;
-#endif // XUARTPS_H
-	case UART_PL:
-#ifdef XUARTLITE_H
-		while (offset < bytes_number) {
-			while ((Xil_In32(instance->RegBaseAddress + XUL_STATUS_REG_OFFSET) &
-				XUL_SR_TX_FIFO_FULL));
-			Xil_Out32(instance->RegBaseAddress + XUL_TX_FIFO_OFFSET, data[offset]);
-			offset++;
-		}
-		while (!(Xil_In32(instance->RegBaseAddress + XUL_STATUS_REG_OFFSET) &
-			 XUL_SR_TX_FIFO_EMPTY));
-#endif // XUARTLITE_H
-		break;
-	default:
-		return FAILURE;
-		break;
+	while (offset < bytes_number) {
+		ret = uart_write_nonblocking(desc, data + offset,
+					     bytes_number - offset);
+		if (ret < 0)
+			return ret;
+		offset += ret;
 	}
 
+#ifdef XUARTLITE_H
+	if (!xil_uart_desc->irq_enabled)
+		uart_pl_tx_drain(xil_uart_desc);
+#endif
+
 	return SUCCESS;
 }
 
@@ -232,42 +396,39 @@ static void uart_irq_handler(void *call_back_ref, uint32_t event,
 {
 	struct xil_uart_desc *xil_uart_desc = call_back_ref;
 
-	switch(xil_uart_desc->type) {
-	case UART_PS:
-		switch(event) {
-		/* All of the data has been received */
-		case XUARTPS_EVENT_RECV_DATA:
-		/*
-		 * Data was received, but not the expected number of bytes, a
-		 * timeout just indicates the data stopped for configured character time
-		 */
-		case XUARTPS_EVENT_RECV_TOUT:
-			xil_uart_desc->bytes_received = data_len;
-			break;
-		/*
-		 * Data was received with an error, keep the data but determine
-		 * what kind of errors occurred
-		 */
-		case XUARTPS_EVENT_RECV_ERROR:
-		/*
-		 * Data was received with an parity or frame or break error, keep the data
-		 * but determine what kind of errors occurred. Specific to Zynq Ultrascale+
-		 * MP.
-		 */
-		case XUARTPS_EVENT_PARE_FRAME_BRKE:
-		/*
-		 * Data was received with an overrun error, keep the data but determine
-		 * what kind of errors occurred. Specific to Zynq Ultrascale+ MP.
-		 */
-		case XUARTPS_EVENT_RECV_ORERR:
-			xil_uart_desc->total_error_count++;
-			break;
-		default:
-			break;
-		}
+	switch(event) {
+	/* All of the data has been received */
+	case XUARTPS_EVENT_RECV_DATA:
+	/*
+	 * Data was received, but not the expected number of bytes, a
+	 * timeout just indicates the data stopped for configured character time
+	 */
+	case XUARTPS_EVENT_RECV_TOUT:
+		uart_rx_store(xil_uart_desc, xil_uart_desc->buff, data_len);
+		XUartPs_Recv(xil_uart_desc->instance, xil_uart_desc->buff,
+			     UART_BUFF_LENGTH);
 		break;
-	case UART_PL:
-
+	/* The previous chunk was sent, continue with the TX ring */
+	case XUARTPS_EVENT_SENT_DATA:
+		uart_ps_tx_start(xil_uart_desc);
+		break;
+	/*
+	 * Data was received with an error, keep the data but determine
+	 * what kind of errors occurred
+	 */
+	case XUARTPS_EVENT_RECV_ERROR:
+	/*
+	 * Data was received with an parity or frame or break error, keep the data
+	 * but determine what kind of errors occurred. Specific to Zynq Ultrascale+
+	 * MP.
+	 */
+	case XUARTPS_EVENT_PARE_FRAME_BRKE:
+	/*
+	 * Data was received with an overrun error, keep the data but determine
+	 * what kind of errors occurred. Specific to Zynq Ultrascale+ MP.
+	 */
+	case XUARTPS_EVENT_RECV_ORERR:
+		xil_uart_desc->total_error_count++;
 		break;
 	default:
 		break;
@@ -275,7 +436,6 @@ static void uart_irq_handler(void *call_back_ref, uint32_t event,
 }
 #endif // XUARTPS_H
 
-#ifdef XUARTPS_H
 /**
  * @brief UART interrupt init.
  * @param desc - Instance of UART containing a pointer to handler.
@@ -284,12 +444,15 @@ static void uart_irq_handler(void *call_back_ref, uint32_t event,
 static int32_t uart_irq_init(struct uart_desc *descriptor)
 {
 	int32_t status;
-	uint32_t uart_irq_mask;
 	struct xil_uart_desc *xil_uart_desc = descriptor->extra;
 	struct callback_desc callback_desc;
+#ifdef XUARTPS_H
+	uint32_t uart_irq_mask;
+#endif
 
 	switch(xil_uart_desc->type) {
 	case UART_PS:
+#ifdef XUARTPS_H
 		callback_desc.callback = (void (*)())XUartPs_InterruptHandler;
 		callback_desc.ctx = xil_uart_desc->instance;
 		status = irq_register_callback(xil_uart_desc->irq_desc,
@@ -309,9 +472,24 @@ static int32_t uart_irq_init(struct uart_desc *descriptor)
 		XUartPs_SetInterruptMask(xil_uart_desc->instance, uart_irq_mask);
 
 		break;
+#else
+		return FAILURE;
+#endif // XUARTPS_H
 	case UART_PL:
+#ifdef XUARTLITE_H
+		callback_desc.callback = (void (*)())uart_pl_irq_handler;
+		callback_desc.ctx = xil_uart_desc;
+		status = irq_register_callback(xil_uart_desc->irq_desc,
+					       xil_uart_desc->irq_id,
+					       &callback_desc);
+		if (status < 0)
+			return status;
+		XUartLite_EnableInterrupt(xil_uart_desc->instance);
 
 		break;
+#else
+		return FAILURE;
+#endif // XUARTLITE_H
 	default:
 		return FAILURE;
 		break;
@@ -321,9 +499,10 @@ static int32_t uart_irq_init(struct uart_desc *descriptor)
 	if (status < 0)
 		return status;
 
+	xil_uart_desc->irq_enabled = true;
+
 	return SUCCESS;
 }
-#endif // XUARTPS_H
 
 /**
  * @brief Initialize the UART communication peripheral.
@@ -402,7 +581,7 @@ int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
 
 		*desc = descriptor;
 
-		XUartPs_Recv(xil_uart_desc->instance, (u8*)xil_uart_desc->buff,
+		XUartPs_Recv(xil_uart_desc->instance, xil_uart_desc->buff,
 			     UART_BUFF_LENGTH);
 
 		break;
@@ -425,6 +604,13 @@ int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
 		/* Discard old data */
 		while (XUartLite_Recv(xil_uart_desc->instance, (uint8_t *)&status, 1));
 
+		/* Without an interrupt controller the UART is polled */
+		if (xil_uart_desc->irq_desc) {
+			status = uart_irq_init(descriptor);
+			if (status != SUCCESS)
+				goto error_free_instance;
+		}
+
 		*desc = descriptor;
 #endif // XUARTLITE_H
 		break;
@@ -453,6 +639,16 @@ error_free_descriptor:
 int32_t uart_remove(struct uart_desc *desc)
 {
 	struct xil_uart_desc *xil_uart_desc = desc->extra;
+
+	if (xil_uart_desc->irq_enabled) {
+#ifdef XUARTLITE_H
+		if (xil_uart_desc->type == UART_PL)
+			XUartLite_DisableInterrupt(xil_uart_desc->instance);
+#endif
+		irq_disable(xil_uart_desc->irq_desc, xil_uart_desc->irq_id);
+		irq_unregister(xil_uart_desc->irq_desc, xil_uart_desc->irq_id);
+	}
+
 	free(xil_uart_desc->instance);
 	free(xil_uart_desc);
 	free(desc);
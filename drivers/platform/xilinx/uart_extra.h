@@ -44,11 +44,16 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 
+#include <stdint.h>
+#include <stdbool.h>
+
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
 /******************************************************************************/
 
 #define UART_BUFF_LENGTH 256
+/** Size of the RX and TX software rings. Must be a power of 2 */
+#define UART_RING_SIZE	 1024
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -65,6 +70,20 @@ enum xil_uart_type {
 	UART_PS
 };
 
+/**
+ * @struct xil_uart_ring
+ * @brief Single producer, single consumer byte ring shared between the UART
+ * interrupt handler and the application.
+ */
+struct xil_uart_ring {
+	/** Ring storage */
+	uint8_t			buff[UART_RING_SIZE];
+	/** Free running write index */
+	volatile uint32_t	head;
+	/** Free running read index */
+	volatile uint32_t	tail;
+};
+
 /**
  * @struct xil_uart_init_param
  * @brief Structure holding the initialization parameters for Xilinx platform
@@ -75,7 +94,8 @@ struct xil_uart_init_param {
 	enum xil_uart_type	type;
 	/** Interrupt Request ID */
 	uint32_t			irq_id;
-	/** Interrupt Request Descriptor */
+	/** Interrupt Request Descriptor. Optional for UART_PL, if NULL the
+	 *  UART is polled */
 	struct irq_ctrl_desc *irq_desc;
 };
 
@@ -90,14 +110,18 @@ struct xil_uart_desc {
 	uint32_t			irq_id;
 	/** Interrupt Request Descriptor */
 	struct irq_ctrl_desc *irq_desc;
-	/** FIFO */
-	struct fifo_element	*fifo;
-	/** FIFO read offset */
-	uint32_t 			fifo_read_offset;
-	/** UART Buffer */
-	char 				buff[UART_BUFF_LENGTH];
-	/** Number of bytes received */
-	uint32_t 			bytes_received;
+	/** Received bytes, filled from the interrupt handler */
+	struct xil_uart_ring	rx_ring;
+	/** Bytes queued for transmission, drained from the interrupt handler */
+	struct xil_uart_ring	tx_ring;
+	/** UART_PS receive buffer handed to the Xilinx driver */
+	uint8_t				buff[UART_BUFF_LENGTH];
+	/** UART_PS transmit buffer handed to the Xilinx driver */
+	uint8_t				tx_buff[UART_BUFF_LENGTH];
+	/** Set while a transmission is in progress */
+	volatile bool		tx_busy;
+	/** Set if the UART is serviced from its interrupt */
+	bool				irq_enabled;
 	/** Total number of errors */
 	uint32_t 			total_error_count;
 	/** UART Instance */
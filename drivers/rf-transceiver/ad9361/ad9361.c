@@ -49,6 +49,7 @@
 #include "spi.h"
 #include "gpio.h"
 #include "delay.h"
+#include "deadline.h"
 #include "ad9361_util.h"
 #include "util.h"
 #include "app_config.h"
@@ -56,6 +57,8 @@
 #define diff_abs(x, y) ((x) > (y) ? (x - y) : (y - x))
 
 #define NO_GAIN_TABLE		((uint32_t)-1)
+#define GT_ROW_XFERS		7	/* SPI writes per gain table row */
+#define GT_LOAD_XFERS		13	/* SPI transfers around the row writes */
 
 /* Used for static code size optimization: please see app_config.h */
 const bool has_split_gt = HAVE_SPLIT_GAIN_TABLE;
@@ -679,6 +682,10 @@ static const uint32_t gain_step_calib_reg_val[4][5] = {
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
 /******************************************************************************/
+/* Calibration done bit timeouts, REG_CALIBRATION_CTRL covers RFDC_CAL */
+#define AD9361_CAL_CTRL_TIMEOUT_US	24000000u
+#define AD9361_CAL_TIMEOUT_US		2400000u
+
 const char *ad9361_ensm_states[] = {
 	"sleep", "", "", "", "", "alert", "tx", "tx flush",
 	"rx", "rx_flush", "fdd", "fdd_flush"
@@ -1263,6 +1270,29 @@ void ad9361_get_bist_tone(struct ad9361_rf_phy *phy,
 	*mask = phy->bist_tone_mask;
 }
 
+/**
+ * Calibration done bit polled by ad9361_check_cal_done().
+ */
+struct ad9361_cal_poll {
+	struct spi_desc *spi;
+	uint32_t reg;
+	uint32_t mask;
+	uint32_t done_state;
+};
+
+/**
+ * Check if a calibration done bit reached its done state.
+ * @param ctx The struct ad9361_cal_poll to check.
+ * @return 1 if the calibration is done, 0 otherwise.
+ */
+static int32_t ad9361_cal_done(void *ctx)
+{
+	struct ad9361_cal_poll *poll = ctx;
+
+	return (uint32_t)ad9361_spi_readf(poll->spi, poll->reg, poll->mask) ==
+	       poll->done_state;
+}
+
 /**
  * Check the calibration done bit.
  * @param phy The AD9361 state structure.
@@ -1274,19 +1304,23 @@ void ad9361_get_bist_tone(struct ad9361_rf_phy *phy,
 static int32_t ad9361_check_cal_done(struct ad9361_rf_phy *phy, uint32_t reg,
 				     uint32_t mask, uint32_t done_state)
 {
-	uint32_t timeout = 20000; /* RFDC_CAL can take long */
-	uint32_t state;
+	struct ad9361_cal_poll poll = {
+		.spi = phy->spi,
+		.reg = reg,
+		.mask = mask,
+		.done_state = done_state,
+	};
 
-	do {
-		state = ad9361_spi_readf(phy->spi, reg, mask);
-		if (state == done_state)
+	/* RFDC_CAL can take long */
+	if (reg == REG_CALIBRATION_CTRL) {
+		if (!poll_until(ad9361_cal_done, &poll,
+				AD9361_CAL_CTRL_TIMEOUT_US, 1200))
 			return 0;
-
-		if (reg == REG_CALIBRATION_CTRL)
-			udelay(1200);
-		else
-			udelay(120);
-	} while (timeout--);
+	} else {
+		if (!poll_until(ad9361_cal_done, &poll,
+				AD9361_CAL_TIMEOUT_US, 120))
+			return 0;
+	}
 
 	dev_err(&phy->spi->dev, "Calibration TIMEOUT (0x%"PRIX32", 0x%"PRIX32")", reg,
 		mask);
@@ -1351,6 +1385,74 @@ uint32_t ad9361_gt(struct ad9361_rf_phy *phy)
 	return phy->current_table;
 }
 
+/**
+ * Precompute, for every pair of gain tables, the rows that differ.
+ * A band switch then only rewrites these rows instead of the whole table.
+ * @param phy The AD9361 state structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_gt_delta_init(struct ad9361_rf_phy *phy)
+{
+	struct gain_table_info *from, *to;
+	struct gain_table_delta *delta, *d;
+	uint32_t num, max_rows, i, j, k;
+	uint8_t *rows;
+
+	for (num = 0, max_rows = 0; phy->gt_info[num].tab != NULL; num++)
+		max_rows = max_t(uint32_t, max_rows, phy->gt_info[num].max_index);
+
+	if (!num)
+		return 0;
+
+	delta = (struct gain_table_delta *)calloc(num * num, sizeof(*delta));
+	rows = (uint8_t *)calloc(num * num, max_rows);
+	if (!delta || !rows) {
+		free(delta);
+		free(rows);
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < num; i++) {
+		from = &phy->gt_info[i];
+		for (j = 0; j < num; j++) {
+			to = &phy->gt_info[j];
+			d = &delta[i * num + j];
+			d->rows = rows + (i * num + j) * max_rows;
+			for (k = 0; k < to->max_index; k++) {
+				if ((k < from->max_index) &&
+				    !memcmp(from->tab[k], to->tab[k], 3))
+					continue;
+				d->rows[d->num_rows++] = k;
+			}
+
+			dev_dbg(&phy->spi->dev,
+				"%s: table %"PRIu32" -> %"PRIu32": %d rows",
+				__func__, i, j, d->num_rows);
+		}
+	}
+
+	phy->gt_delta = delta;
+	phy->gt_num = num;
+
+	return 0;
+}
+
+/**
+ * Free the gain table delta cache.
+ * @param phy The AD9361 state structure.
+ * @return None.
+ */
+void ad9361_gt_delta_remove(struct ad9361_rf_phy *phy)
+{
+	if (!phy->gt_delta)
+		return;
+
+	free(phy->gt_delta[0].rows);
+	free(phy->gt_delta);
+	phy->gt_delta = NULL;
+	phy->gt_num = 0;
+}
+
 /**
  * Shift the real frequency value, so it fits type unsigned long
  * Note: PLL operates between 47 .. 6000 MHz which is > 2^32.
@@ -1399,8 +1501,39 @@ static int find_table_index(struct ad9361_rf_phy *phy, int gain)
 	return -EINVAL;
 }
 
+/**
+ * Write one row of the RX gain table.
+ * @param spi The SPI descriptor.
+ * @param index The gain table index.
+ * @param row The gain table row.
+ * @param lna The external LNA control bit.
+ * @param dest The destination [GT_RX1, GT_RX2].
+ * @return None.
+ */
+static void ad9361_write_gt_row(struct spi_desc *spi, uint32_t index,
+				const uint8_t *row, uint32_t lna, uint32_t dest)
+{
+	ad9361_spi_write(spi, REG_GAIN_TABLE_ADDRESS, index); /* Gain Table Index */
+	ad9361_spi_write(spi, REG_GAIN_TABLE_WRITE_DATA1,
+			 row[0] | lna); /* Ext LNA, Int LNA, & Mixer Gain Word */
+	ad9361_spi_write(spi, REG_GAIN_TABLE_WRITE_DATA2,
+			 row[1]); /* TIA & LPF Word */
+	ad9361_spi_write(spi, REG_GAIN_TABLE_WRITE_DATA3,
+			 row[2]); /* DC Cal bit & Dig Gain Word */
+	ad9361_spi_write(spi, REG_GAIN_TABLE_CONFIG,
+			 START_GAIN_TABLE_CLOCK |
+			 WRITE_GAIN_TABLE |
+			 RECEIVER_SELECT(dest)); /* Gain Table Index */
+	ad9361_spi_write(spi, REG_GAIN_TABLE_READ_DATA1,
+			 0); /* Dummy Write to delay 3 ADCCLK/16 cycles */
+	ad9361_spi_write(spi, REG_GAIN_TABLE_READ_DATA1,
+			 0); /* Dummy Write to delay ~1u */
+}
+
 /**
  * Load the gain table for the selected frequency range and receiver.
+ * If a table is already loaded for the receivers, only the rows that
+ * differ from it are written.
  * @param phy The AD9361 state structure.
  * @param freq The frequency value [Hz].
  * @param dest The destination [GT_RX1, GT_RX2].
@@ -1411,7 +1544,8 @@ static int32_t ad9361_load_gt(struct ad9361_rf_phy *phy, uint64_t freq,
 {
 	struct spi_desc *spi = phy->spi;
 	uint8_t (*tab)[3];
-	uint32_t band, index_max, i, lna, lpf_tia_mask, set_gain;
+	struct gain_table_delta *delta = NULL;
+	uint32_t band, index_max, i, row, lna, lpf_tia_mask, set_gain, num_rows;
 	int32_t ret, rx1_gain, rx2_gain;
 
 	dev_dbg(&phy->spi->dev, "%s: frequency %"PRIu64, __func__, freq);
@@ -1472,26 +1606,19 @@ static int32_t ad9361_load_gt(struct ad9361_rf_phy *phy, uint64_t freq,
 
 	phy->tx_quad_lpf_tia_match = -EINVAL;
 
-	for (i = 0; i < index_max; i++) {
-		ad9361_spi_write(spi, REG_GAIN_TABLE_ADDRESS, i); /* Gain Table Index */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_WRITE_DATA1,
-				 tab[i][0] | lna); /* Ext LNA, Int LNA, & Mixer Gain Word */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_WRITE_DATA2,
-				 tab[i][1]); /* TIA & LPF Word */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_WRITE_DATA3,
-				 tab[i][2]); /* DC Cal bit & Dig Gain Word */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_CONFIG,
-				 START_GAIN_TABLE_CLOCK |
-				 WRITE_GAIN_TABLE |
-				 RECEIVER_SELECT(dest)); /* Gain Table Index */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_READ_DATA1,
-				 0); /* Dummy Write to delay 3 ADCCLK/16 cycles */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_READ_DATA1,
-				 0); /* Dummy Write to delay ~1u */
-
+	for (i = 0; i < index_max; i++)
 		if ((tab[i][1] & lpf_tia_mask) == 0x20)
 			phy->tx_quad_lpf_tia_match = i;
 
+	/* Rows are shared with the loaded table: write only the delta */
+	if (phy->gt_delta && (phy->current_table != NO_GAIN_TABLE) &&
+	    ((phy->current_table_dest & dest) == dest))
+		delta = &phy->gt_delta[phy->current_table * phy->gt_num + band];
+
+	num_rows = delta ? delta->num_rows : index_max;
+	for (i = 0; i < num_rows; i++) {
+		row = delta ? delta->rows[i] : i;
+		ad9361_write_gt_row(spi, row, tab[row], lna, dest);
 	}
 
 	ad9361_spi_write(spi, REG_GAIN_TABLE_CONFIG, START_GAIN_TABLE_CLOCK |
@@ -1502,7 +1629,13 @@ static int32_t ad9361_load_gt(struct ad9361_rf_phy *phy, uint64_t freq,
 			 0); /* Dummy Write to delay ~1u */
 	ad9361_spi_write(spi, REG_GAIN_TABLE_CONFIG, 0); /* Stop Gain Table Clock */
 
+	phy->gt_load_xfers = GT_LOAD_XFERS + num_rows * GT_ROW_XFERS;
+	dev_dbg(&phy->spi->dev, "%s: table %"PRIu32" -> %"PRIu32": %"PRIu32
+		" rows, %"PRIu32" SPI transfers", __func__, phy->current_table,
+		band, num_rows, phy->gt_load_xfers);
+
 	phy->current_table = band;
+	phy->current_table_dest = dest;
 
 	ret = find_table_index(phy, rx1_gain);
 	if (ret < 0)
@@ -2889,6 +2889,11 @@ struct gain_table_info {
 	uint8_t (*tab)[3];
 };
 
+struct gain_table_delta {
+	uint8_t num_rows;
+	uint8_t *rows;
+};
+
 enum fir_dest {
 	FIR_TX1 = 0x01,
 	FIR_TX2 = 0x02,
@@ -3319,6 +3324,22 @@ enum dig_tune_flags {
 	RESTORE_DEFAULT = 32,
 };
 
+/* Number of digital interface tuning results kept by the driver */
+#define AD9361_DIG_TUNE_CACHE_SIZE	4
+/* A cached result is only reused within this temperature span (mdegC) */
+#define AD9361_DIG_TUNE_CACHE_TEMP_SPAN	10000
+
+struct ad9361_dig_tune_cache_entry {
+	/* RX sampling clock of the tuning, 0 for an empty entry */
+	uint32_t sampl_clk;
+	/* Die temperature at tuning time, in milli degrees Celsius */
+	int32_t temp;
+	/* Tuned REG_RX_CLOCK_DATA_DELAY value */
+	uint8_t rx_clk_data_delay;
+	/* Tuned REG_TX_CLOCK_DATA_DELAY value */
+	uint8_t tx_clk_data_delay;
+};
+
 enum ad9361_bist_mode {
 	BIST_DISABLE,
 	BIST_INJ_TX,
@@ -3365,7 +3386,11 @@ struct ad9361_rf_phy {
 	uint8_t			cached_synth_pd[2];
 	int32_t			tx_quad_lpf_tia_match;
 	uint32_t		current_table;
+	uint32_t		current_table_dest;
 	struct gain_table_info  *gt_info;
+	struct gain_table_delta	*gt_delta;
+	uint32_t		gt_num;
+	uint32_t		gt_load_xfers;
 	bool 			ensm_pin_ctl_en;
 
 	bool			auto_cal_en;
@@ -3410,6 +3435,10 @@ struct ad9361_rf_phy {
 	struct axiadc_state		*adc_state;
 	int32_t					bist_loopback_mode;
 	int32_t					bist_config;
+	struct ad9361_dig_tune_cache_entry	dig_tune_cache[AD9361_DIG_TUNE_CACHE_SIZE];
+	uint32_t				dig_tune_cache_next;
+	uint32_t				dig_tune_pn_checks;
+	uint32_t				dig_tune_pn_ms;
 	enum ad9361_bist_mode	bist_prbs_mode;
 	enum ad9361_bist_mode	bist_tone_mode;
 	uint32_t				bist_tone_freq_Hz;
@@ -3450,6 +3479,8 @@ int32_t ad9361_reset(struct ad9361_rf_phy *phy);
 int32_t ad9361_register_clocks(struct ad9361_rf_phy *phy);
 int32_t ad9361_unregister_clocks(struct ad9361_rf_phy *phy);
 uint32_t ad9361_gt(struct ad9361_rf_phy *phy);
+int32_t ad9361_gt_delta_init(struct ad9361_rf_phy *phy);
+void ad9361_gt_delta_remove(struct ad9361_rf_phy *phy);
 int32_t ad9361_init_gain_tables(struct ad9361_rf_phy *phy);
 int32_t ad9361_setup(struct ad9361_rf_phy *phy);
 int32_t ad9361_post_setup(struct ad9361_rf_phy *phy);
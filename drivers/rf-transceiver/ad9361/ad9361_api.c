@@ -520,6 +520,9 @@ int32_t ad9361_init (struct ad9361_rf_phy **ad9361_phy,
 	phy->quad_track_en = true;
 
 	phy->gt_info = ad9361_adi_gt_info;
+	ret = ad9361_gt_delta_init(phy);
+	if (ret < 0)
+		goto out;
 
 	phy->bist_loopback_mode = 0;
 	phy->bist_config = 0;
@@ -554,6 +557,9 @@ int32_t ad9361_init (struct ad9361_rf_phy **ad9361_phy,
 #ifndef AXI_ADC_NOT_PRESENT
 	axi_adc_init(&phy->rx_adc, init_param->rx_adc_init);
 	axi_adc_read(phy->rx_adc, ADI_REG_VERSION, &phy->adc_state->pcore_version);
+	if (init_param->dig_tune_cache)
+		memcpy(phy->dig_tune_cache, init_param->dig_tune_cache,
+		       sizeof(phy->dig_tune_cache));
 	/* platform specific wrapper to call ad9361_post_setup() */
 	ret = ad9361_post_setup(phy);
 	if (ret < 0)
@@ -569,6 +575,7 @@ int32_t ad9361_init (struct ad9361_rf_phy **ad9361_phy,
 out_clk:
 	ad9361_unregister_clocks(phy);
 out:
+	ad9361_gt_delta_remove(phy);
 #ifndef AXI_ADC_NOT_PRESENT
 	free(phy->adc_conv);
 	free(phy->adc_state);
@@ -594,6 +601,7 @@ int32_t ad9361_remove(struct ad9361_rf_phy *phy)
 	gpio_remove(phy->gpio_desc_sync);
 	gpio_remove(phy->gpio_desc_cal_sw1);
 	gpio_remove(phy->gpio_desc_cal_sw2);
+	ad9361_gt_delta_remove(phy);
 #ifndef AXI_ADC_NOT_PRESENT
 	free(phy->adc_conv);
 	free(phy->adc_state);
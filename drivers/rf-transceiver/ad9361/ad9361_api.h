@@ -296,6 +296,9 @@ typedef struct {
 #ifndef AXI_ADC_NOT_PRESENT
 	struct axi_adc_init	*rx_adc_init;
 	struct axi_dac_init	*tx_dac_init;
+	/* Digital interface tuning results saved from phy->dig_tune_cache by a
+	 * previous run. Optional, AD9361_DIG_TUNE_CACHE_SIZE entries. */
+	struct ad9361_dig_tune_cache_entry	*dig_tune_cache;
 #endif
 } AD9361_InitParam;
 
@@ -60,6 +60,27 @@
 #define PCORE_VERSION_MINOR(version)	((version >> 8) & 0xff)
 #define PCORE_VERSION_LETTER(version)	(version & 0xff)
 
+/* Not yet probed entry of a tuning field */
+#define TUNE_UNKNOWN		0xFF
+/* Distance between the first probes of a tuning search */
+#define TUNE_COARSE_STEP	4
+
+/**
+ * Tuning probe: sets one point of a delay sweep and checks the PN status.
+ */
+struct ad9361_tune_probe {
+	struct ad9361_rf_phy *phy;
+	bool tx;
+	/* Clock/data delay grid row */
+	uint32_t row;
+	/* IODELAY lane, -1 for all the lanes */
+	int32_t lane;
+	/* Clock delay currently set, -1 if unknown */
+	int32_t clk_delay;
+	/* Return 0 if the PN check passes at idx */
+	int32_t (*check)(struct ad9361_tune_probe *probe, uint32_t idx);
+};
+
 /**
  * Get the number of PHY channels.
  * @return The number of PHY channels.
@@ -89,6 +110,8 @@ static int32_t ad9361_check_pn(struct ad9361_rf_phy *phy, bool tx,
 		axi_adc_write(axi_adc, AXI_ADC_REG_CHAN_STATUS(chan),
 				AXI_ADC_PN_ERR | AXI_ADC_PN_OOS);
 	mdelay(delay);
+	phy->dig_tune_pn_checks++;
+	phy->dig_tune_pn_ms += delay;
 
 	axi_adc_read(axi_adc, AXI_ADC_REG_STATUS, &adi_reg_status);
 	if (!tx && !(adi_reg_status & AXI_ADC_STATUS))
@@ -191,8 +214,141 @@ static int32_t ad9361_midscale_iodelay(struct ad9361_rf_phy *phy, bool tx)
 	return 0;
 }
 
+/**
+ * Probe a point of a tuning field, unless already done.
+ * @param probe The tuning probe.
+ * @param field The tuning field, 0 = pass, 1 = fail.
+ * @param idx Index in the field.
+ * @return The field value at idx.
+ */
+static uint8_t ad9361_tune_probe_at(struct ad9361_tune_probe *probe,
+				    uint8_t *field, uint32_t idx)
+{
+	if (field[idx] == TUNE_UNKNOWN)
+		field[idx] = probe->check(probe, idx) ? 1 : 0;
+
+	return field[idx];
+}
+
+/**
+ * Binary search the edge of a passing window.
+ * @param probe The tuning probe.
+ * @param field The tuning field.
+ * @param pass Index known to pass.
+ * @param fail Index known or assumed to fail. May be -1 or the field size.
+ * @return The passing index next to the edge.
+ */
+static int32_t ad9361_tune_edge(struct ad9361_tune_probe *probe,
+				uint8_t *field, int32_t pass, int32_t fail)
+{
+	int32_t mid;
+
+	while (abs(pass - fail) > 1) {
+		mid = (pass + fail) / 2;
+		if (ad9361_tune_probe_at(probe, field, mid))
+			fail = mid;
+		else
+			pass = mid;
+	}
+
+	return pass;
+}
+
+/**
+ * Find the widest passing window of a delay sweep.
+ * A coarse pass locates the window, its edges are then found with binary
+ * searches instead of probing every delay. If no coarse probe passes, the
+ * remaining delays are probed one by one.
+ * @param probe The tuning probe.
+ * @param field The tuning field, filled in with the results.
+ * @param size The field size.
+ * @param ret_start The window start.
+ * @return The window size, 0 if no delay passes.
+ */
+static uint32_t ad9361_tune_search(struct ad9361_tune_probe *probe,
+				   uint8_t *field, uint32_t size,
+				   uint32_t *ret_start)
+{
+	int32_t i, run_start, best_start, best_end, left, right;
+
+	memset(field, TUNE_UNKNOWN, size);
+	for (i = 0; i < (int32_t)size; i += TUNE_COARSE_STEP)
+		ad9361_tune_probe_at(probe, field, i);
+	ad9361_tune_probe_at(probe, field, size - 1);
+
+	/* Widest run of passing coarse probes */
+	best_start = -1;
+	best_end = -1;
+	run_start = -1;
+	for (i = 0; i < (int32_t)size; i++) {
+		if (field[i] == TUNE_UNKNOWN)
+			continue;
+		if (field[i]) {
+			run_start = -1;
+			continue;
+		}
+		if (run_start < 0)
+			run_start = i;
+		if (best_start < 0 || i - run_start > best_end - best_start) {
+			best_start = run_start;
+			best_end = i;
+		}
+	}
+
+	if (best_start < 0) {
+		for (i = 0; i < (int32_t)size; i++)
+			ad9361_tune_probe_at(probe, field, i);
+
+		return ad9361_find_opt(field, size, ret_start);
+	}
+
+	/* Closest failing coarse probes around the run */
+	for (left = best_start - 1; left >= 0; left--)
+		if (field[left] != TUNE_UNKNOWN)
+			break;
+	for (right = best_end + 1; right < (int32_t)size; right++)
+		if (field[right] != TUNE_UNKNOWN)
+			break;
+
+	left = ad9361_tune_edge(probe, field, best_start, left);
+	right = ad9361_tune_edge(probe, field, best_end, right);
+
+	for (i = 0; i < (int32_t)size; i++)
+		if (field[i] == TUNE_UNKNOWN)
+			field[i] = (i < left || i > right);
+
+	*ret_start = left;
+
+	return right - left + 1;
+}
+
+/**
+ * IO delay tuning probe.
+ * @param probe The tuning probe.
+ * @param idx The IO delay.
+ * @return 0 if the PN check passes.
+ */
+static int32_t ad9361_iodelay_check(struct ad9361_tune_probe *probe,
+				    uint32_t idx)
+{
+	struct axiadc_state *st = probe->phy->adc_state;
+	int32_t i;
+
+	if (probe->lane >= 0) {
+		ad9361_iodelay_set(st, probe->lane, idx, probe->tx);
+	} else {
+		for (i = 0; i < 7; i++)
+			ad9361_iodelay_set(st, i, idx, probe->tx);
+	}
+
+	return ad9361_check_pn(probe->phy, probe->tx, 10);
+}
+
 /**
  * Digital tune IO delay.
+ * The PN checker can't tell which lane fails, so all the lanes are first
+ * swept together to find their common window. Then the edges of each lane
+ * are searched with the other lanes in the middle of the common window.
  * @param phy The AD9361 state structure.
  * @param tx The Synthesizer TX = 1, RX = 0.
  * @return 0 in case of success, negative error code otherwise.
@@ -200,23 +356,40 @@ static int32_t ad9361_midscale_iodelay(struct ad9361_rf_phy *phy, bool tx)
 static int32_t ad9361_dig_tune_iodelay(struct ad9361_rf_phy *phy, bool tx)
 {
 	struct axiadc_state *st = phy->adc_state;
-	int32_t i, j;
+	struct ad9361_tune_probe probe = {
+		.phy = phy,
+		.tx = tx,
+		.lane = -1,
+		.check = ad9361_iodelay_check,
+	};
+	int32_t i, left, right, mid;
 	uint32_t s0, c0;
 	uint8_t field[32];
 
-	for (i = 0; i < 7; i++) {
-		for (j = 0; j < 32; j++) {
-			ad9361_iodelay_set(st, i, j, tx);
-			mdelay(1);
-			field[j] = ad9361_check_pn(phy, tx, 10);
-		}
+	c0 = ad9361_tune_search(&probe, field, 32, &s0);
+	if (!c0) {
+		dev_err(&phy->spi->dev, "%s: %s IODELAY tuning failed\n",
+			__func__, tx ? "TX" : "RX");
+		ad9361_midscale_iodelay(phy, tx);
+		return -EIO;
+	}
 
-		c0 = ad9361_find_opt(&field[0], 32, &s0);
-		ad9361_iodelay_set(st, i, s0 + c0 / 2, tx);
+	mid = s0 + c0 / 2;
+	for (i = 0; i < 7; i++)
+		ad9361_iodelay_set(st, i, mid, tx);
+
+	for (i = 0; i < 7; i++) {
+		probe.lane = i;
+		memset(field, TUNE_UNKNOWN, sizeof(field));
+		field[mid] = 0;
+		left = ad9361_tune_edge(&probe, field, mid, -1);
+		right = ad9361_tune_edge(&probe, field, mid, 32);
+		ad9361_iodelay_set(st, i, (left + right) / 2, tx);
 
 		dev_dbg(&phy->spi->dev,
-			 "%s Lane %"PRId32", window cnt %"PRIu32" , start %"PRIu32", IODELAY set to %"PRIu32"\n",
-			 tx ? "TX" :"RX",  i , c0, s0, s0 + c0 / 2);
+			"%s Lane %"PRId32", window cnt %"PRId32" , start %"PRId32", IODELAY set to %"PRId32"\n",
+			tx ? "TX" :"RX", i, right - left + 1, left,
+			(left + right) / 2);
 	}
 
 	return 0;
@@ -347,54 +520,156 @@ int32_t ad9361_dig_interface_timing_analysis(struct ad9361_rf_phy *phy,
 	return len;
 }
 
+/**
+ * Clock/data delay tuning probe.
+ * Row 0: clock delay = 0, data delay from 0 to 15.
+ * Row 1: clock delay = 15, data delay from 15 to 0.
+ * @param probe The tuning probe.
+ * @param idx Index in the row.
+ * @return 0 if the PN check passes.
+ */
+static int32_t ad9361_intf_delay_check(struct ad9361_tune_probe *probe,
+				       uint32_t idx)
+{
+	int32_t clk_delay = probe->row ? 15 : 0;
+
+	ad9361_set_intf_delay(probe->phy, probe->tx, clk_delay,
+			      probe->row ? 15 - idx : idx,
+			      clk_delay != probe->clk_delay);
+	probe->clk_delay = clk_delay;
+
+	return ad9361_check_pn(probe->phy, probe->tx, 4);
+}
+
+/**
+ * Look up a tuning result for the current sampling clock and temperature.
+ * @param phy The AD9361 state structure.
+ * @return The cache entry, NULL if there is none.
+ */
+static struct ad9361_dig_tune_cache_entry *ad9361_dig_tune_cache_find(
+	struct ad9361_rf_phy *phy)
+{
+	struct ad9361_dig_tune_cache_entry *entry;
+	uint32_t sampl_clk;
+	int32_t temp;
+	uint32_t i;
+
+	sampl_clk = clk_get_rate(phy, phy->ref_clk_scale[RX_SAMPL_CLK]);
+	temp = ad9361_get_temp(phy);
+	for (i = 0; i < AD9361_DIG_TUNE_CACHE_SIZE; i++) {
+		entry = &phy->dig_tune_cache[i];
+		if (entry->sampl_clk == sampl_clk &&
+		    abs(entry->temp - temp) <= AD9361_DIG_TUNE_CACHE_TEMP_SPAN)
+			return entry;
+	}
+
+	return NULL;
+}
+
+/**
+ * Store the current tuning result, replacing the entry for the same
+ * sampling clock or the oldest one.
+ * @param phy The AD9361 state structure.
+ * @return None.
+ */
+static void ad9361_dig_tune_cache_store(struct ad9361_rf_phy *phy)
+{
+	struct ad9361_dig_tune_cache_entry *entry = NULL;
+	uint32_t sampl_clk;
+	uint32_t i;
+
+	sampl_clk = clk_get_rate(phy, phy->ref_clk_scale[RX_SAMPL_CLK]);
+	for (i = 0; i < AD9361_DIG_TUNE_CACHE_SIZE; i++)
+		if (phy->dig_tune_cache[i].sampl_clk == sampl_clk)
+			entry = &phy->dig_tune_cache[i];
+	if (!entry) {
+		entry = &phy->dig_tune_cache[phy->dig_tune_cache_next];
+		phy->dig_tune_cache_next = (phy->dig_tune_cache_next + 1) %
+					   AD9361_DIG_TUNE_CACHE_SIZE;
+	}
+
+	entry->sampl_clk = sampl_clk;
+	entry->temp = ad9361_get_temp(phy);
+	entry->rx_clk_data_delay = ad9361_spi_read(phy->spi,
+				   REG_RX_CLOCK_DATA_DELAY);
+	entry->tx_clk_data_delay = ad9361_spi_read(phy->spi,
+				   REG_TX_CLOCK_DATA_DELAY);
+}
+
 /**
  * Digital tune delay.
  * @param phy The AD9361 state structure.
  * @param max_freq Maximum frequency.
  * @param flags Flags: BE_VERBOSE, BE_MOREVERBOSE, DO_IDELAY, DO_ODELAY.
  * @param tx Set if TX.
+ * @param cached Cached clock/data delay to verify first, NULL if none.
+ * @param verified Set if the resulting delay passed a final PN check.
  * @return 0 in case of success, negative error code otherwise.
  */
 static int32_t ad9361_dig_tune_delay(struct ad9361_rf_phy *phy,
-		uint32_t max_freq, enum dig_tune_flags flags, bool tx)
+		uint32_t max_freq, enum dig_tune_flags flags, bool tx,
+		struct ad9361_dig_tune_cache_entry *cached, bool *verified)
 {
 	static const uint32_t rates[3] = {25000000U, 40000000U, 61440000U};
+	struct ad9361_tune_probe probe = {
+		.phy = phy,
+		.tx = tx,
+		.lane = -1,
+		.clk_delay = -1,
+		.check = ad9361_intf_delay_check,
+	};
 	uint32_t s0, s1, c0, c1;
 	uint32_t i, j, r;
 	bool half_data_rate;
 	uint8_t field[2][16];
 
+	if (cached) {
+		ad9361_ensm_force_state(phy, ENSM_STATE_ALERT);
+		ad9361_spi_write(phy->spi, REG_RX_CLOCK_DATA_DELAY + (tx ? 1 : 0),
+				 tx ? cached->tx_clk_data_delay :
+				 cached->rx_clk_data_delay);
+		ad9361_ensm_force_state(phy, ENSM_STATE_FDD);
+		if (!ad9361_check_pn(phy, tx, 10)) {
+			*verified = true;
+			return 0;
+		}
+		dev_dbg(&phy->spi->dev, "%s: cached %s delay failed, retuning\n",
+			__func__, tx ? "TX" : "RX");
+	}
+
 	if (((phy->pdata->port_ctrl.pp_conf[2] & LVDS_MODE) ||
 	    !phy->pdata->rx2tx2))
 	    half_data_rate = false;
 	else
 	    half_data_rate = true;
 
-	memset(field, 0, 32);
-	for (r = 0; r < (max_freq ? ARRAY_SIZE(rates) : 1); r++) {
-		if (max_freq)
+	if (max_freq) {
+		/* The windows must pass at all the rates, probe every point */
+		memset(field, 0, 32);
+		for (r = 0; r < ARRAY_SIZE(rates); r++) {
 			ad9361_set_trx_clock_chain_freq(phy,
 				half_data_rate ? rates[r] / 2 : rates[r]);
 
-		for (i = 0; i < 2; i++) {
-			for (j = 0; j < 16; j++) {
-				/*
-				 * i == 0: clock delay = 0, data delay from 0 to 15
-				 * i == 1: clock delay = 15, data delay from 15 to 0
-				 */
-				ad9361_set_intf_delay(phy, tx, i ? 15 : 0,
-						      i ? 15 - j : j, j == 0);
-				field[i][j] |= ad9361_check_pn(phy, tx, 4);
+			for (i = 0; i < 2; i++) {
+				probe.row = i;
+				probe.clk_delay = -1;
+				for (j = 0; j < 16; j++)
+					field[i][j] |= ad9361_intf_delay_check(
+							       &probe, j) ? 1 : 0;
 			}
-		}
 
-		if ((flags & BE_MOREVERBOSE) && max_freq) {
-			ad9361_dig_tune_verbose_print(phy, field, tx, -1, -1);
+			if (flags & BE_MOREVERBOSE)
+				ad9361_dig_tune_verbose_print(phy, field, tx, -1, -1);
 		}
-	}
 
-	c0 = ad9361_find_opt(&field[0][0], 16, &s0);
-	c1 = ad9361_find_opt(&field[1][0], 16, &s1);
+		c0 = ad9361_find_opt(&field[0][0], 16, &s0);
+		c1 = ad9361_find_opt(&field[1][0], 16, &s1);
+	} else {
+		probe.row = 0;
+		c0 = ad9361_tune_search(&probe, &field[0][0], 16, &s0);
+		probe.row = 1;
+		c1 = ad9361_tune_search(&probe, &field[1][0], 16, &s1);
+	}
 
 	if (!c0 && !c1) {
 		ad9361_dig_tune_verbose_print(phy, field, tx, -1, -1);
@@ -409,10 +684,16 @@ static int32_t ad9361_dig_tune_delay(struct ad9361_rf_phy *phy,
 	}
 
 	if (c1 > c0)
-		ad9361_set_intf_delay(phy, tx, s1 + c1 / 2, 0, true);
+		ad9361_set_intf_delay(phy, tx, 15, 15 - (s1 + c1 / 2), true);
 	else
 		ad9361_set_intf_delay(phy, tx, 0, s0 + c0 / 2, true);
 
+	/* Only a delay that passes once more is worth caching */
+	*verified = !ad9361_check_pn(phy, tx, 10);
+	if (!*verified)
+		dev_dbg(&phy->spi->dev, "%s: %s delay failed the final check\n",
+			__func__, tx ? "TX" : "RX");
+
 	return 0;
 }
 
@@ -421,10 +702,14 @@ static int32_t ad9361_dig_tune_delay(struct ad9361_rf_phy *phy,
  * @param phy The AD9361 state structure.
  * @param max_freq Maximum frequency.
  * @param flags Flags: BE_VERBOSE, BE_MOREVERBOSE, DO_IDELAY, DO_ODELAY.
+ * @param cached Cached result to verify first, NULL if none.
+ * @param verified Set if the resulting delay passed a final PN check.
  * @return 0 in case of success, negative error code otherwise.
  */
 static int32_t ad9361_dig_tune_rx(struct ad9361_rf_phy *phy, uint32_t max_freq,
-			      enum dig_tune_flags flags)
+			      enum dig_tune_flags flags,
+			      struct ad9361_dig_tune_cache_entry *cached,
+			      bool *verified)
 {
 	struct axi_adc *rx_adc = phy->rx_adc;
 	int32_t ret;
@@ -432,7 +717,8 @@ static int32_t ad9361_dig_tune_rx(struct ad9361_rf_phy *phy, uint32_t max_freq,
 	ad9361_bist_loopback(phy, 0);
 	ad9361_bist_prbs(phy, BIST_INJ_RX);
 
-	ret = ad9361_dig_tune_delay(phy, max_freq, flags, false);
+	ret = ad9361_dig_tune_delay(phy, max_freq, flags, false, cached,
+				    verified);
 	if (flags & DO_IDELAY)
 		ad9361_dig_tune_iodelay(phy, false);
 
@@ -447,10 +733,14 @@ static int32_t ad9361_dig_tune_rx(struct ad9361_rf_phy *phy, uint32_t max_freq,
  * @param phy The AD9361 state structure.
  * @param max_freq Maximum frequency.
  * @param flags Flags: BE_VERBOSE, BE_MOREVERBOSE, DO_IDELAY, DO_ODELAY.
+ * @param cached Cached result to verify first, NULL if none.
+ * @param verified Set if the resulting delay passed a final PN check.
  * @return 0 in case of success, negative error code otherwise.
  */
 static int32_t ad9361_dig_tune_tx(struct ad9361_rf_phy *phy, uint32_t max_freq,
-			      enum dig_tune_flags flags)
+			      enum dig_tune_flags flags,
+			      struct ad9361_dig_tune_cache_entry *cached,
+			      bool *verified)
 {
 	struct axiadc_converter *conv = phy->adc_conv;
 	struct axi_adc *rx_adc = phy->rx_adc;
@@ -491,7 +781,8 @@ static int32_t ad9361_dig_tune_tx(struct ad9361_rf_phy *phy, uint32_t max_freq,
 		axi_adc_write(rx_adc, 0x4048, tmp);
 	}
 
-	ret = ad9361_dig_tune_delay(phy, max_freq, flags, true);
+	ret = ad9361_dig_tune_delay(phy, max_freq, flags, true, cached,
+				    verified);
 	if (flags & DO_ODELAY)
 		ad9361_dig_tune_iodelay(phy, true);
 
@@ -526,13 +817,19 @@ int32_t ad9361_dig_tune(struct ad9361_rf_phy *phy, uint32_t max_freq,
 {
 	struct axiadc_converter *conv = phy->adc_conv;
 	struct axi_adc *rx_adc = phy->rx_adc;
+	struct ad9361_dig_tune_cache_entry *cached = NULL;
 	uint32_t loopback, bist, ensm_state;
+	bool rx_verified = false;
+	bool tx_verified = true;
 	bool restore = false;
 	int32_t ret = 0;
 
 	if (!conv)
 		return -ENODEV;
 
+	phy->dig_tune_pn_checks = 0;
+	phy->dig_tune_pn_ms = 0;
+
 	dev_dbg(&phy->spi->dev, "%s: freq %"PRIu32" flags 0x%X\n", __func__,
 		max_freq, flags);
 
@@ -558,9 +855,18 @@ int32_t ad9361_dig_tune(struct ad9361_rf_phy *phy, uint32_t max_freq,
 		if (flags & DO_ODELAY)
 			ad9361_midscale_iodelay(phy, true);
 
-		ret = ad9361_dig_tune_rx(phy, max_freq, flags);
+		/* IODELAYs are not cached, only reuse plain delay tunings */
+		if (!(flags & (DO_IDELAY | DO_ODELAY)))
+			cached = ad9361_dig_tune_cache_find(phy);
+
+		ret = ad9361_dig_tune_rx(phy, max_freq, flags, cached,
+					 &rx_verified);
 		if (ret == 0 && !phy->pdata->dig_interface_tune_skipmode)
-			ret = ad9361_dig_tune_tx(phy, max_freq, flags);
+			ret = ad9361_dig_tune_tx(phy, max_freq, flags, cached,
+						 &tx_verified);
+		if (ret == 0 && rx_verified && tx_verified &&
+		    !(flags & (DO_IDELAY | DO_ODELAY)))
+			ad9361_dig_tune_cache_store(phy);
 
 		ad9361_bist_loopback(phy, loopback);
 		ad9361_spi_write(phy->spi, REG_BIST_CONFIG, bist);
@@ -593,6 +899,10 @@ int32_t ad9361_dig_tune(struct ad9361_rf_phy *phy, uint32_t max_freq,
 
 	ad9361_tx_mute(phy, 0);
 
+	dev_dbg(&phy->spi->dev, "%s: %s%"PRIu32" PN checks, %"PRIu32" ms\n",
+		__func__, cached ? "cached, " : "", phy->dig_tune_pn_checks,
+		phy->dig_tune_pn_ms);
+
 	return ret;
 }
 
@@ -39,6 +39,7 @@
 #include <stdint.h>
 #include "error.h"
 #include "util.h"
+#include "trace.h"
 #include "adrv9002.h"
 #include "adi_adrv9001.h"
 #include "adi_adrv9001_arm.h"
@@ -447,8 +448,11 @@ int adrv9002_setup(struct adrv9002_rf_phy *phy,
 	if (ret)
 		return ret;
 
+	/* The firmware load time is the span of this trace point */
+	TRACE_BEGIN(TRACE_ID_FW_LOAD);
 	ret = adi_adrv9001_Utilities_Resources_Load(adrv9001_device,
 			&adrv9001_resource_cfg);
+	TRACE_END(TRACE_ID_FW_LOAD);
 	if (ret)
 		return adrv9002_dev_err(phy);
 
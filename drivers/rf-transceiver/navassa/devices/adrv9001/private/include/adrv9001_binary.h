@@ -0,0 +1,64 @@
+/**
+* \file
+* \brief Contains private helpers for the precompiled profile and table binaries
+*
+* ADRV9001 API Version: $ADI_ADRV9001_API_VERSION$
+*/
+
+/**
+* Copyright 2020 Analog Devices Inc.
+* Released under the ADRV9001 API license, for more information
+* see the "LICENSE.txt" file in this zip file.
+*/
+
+#ifndef _ADRV9001_BINARY_H_
+#define _ADRV9001_BINARY_H_
+
+#include "adi_adrv9001_utilities_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+* \brief Checks that a buffer holds a valid binary of the expected type and record layout
+*
+* \param[in]  binary      Buffer holding the header followed by the records, 4 byte aligned
+* \param[in]  length      Length of the buffer in bytes
+* \param[in]  type        Expected adi_adrv9001_BinaryType_e
+* \param[in]  recordSize  Expected size of one record
+* \param[in]  maxRecords  Maximum number of records accepted
+* \param[out] errMsg      Reason of the failure; may be NULL
+*
+* \retval ADI_COMMON_ERR_OK       The binary can be used
+* \retval ADI_COMMON_ERR_INV_PARAM The binary is malformed, corrupted or built for another layout
+*/
+int32_t adrv9001_Binary_Check(const uint8_t binary[],
+                              uint32_t length,
+                              adi_adrv9001_BinaryType_e type,
+                              uint32_t recordSize,
+                              uint32_t maxRecords,
+                              const char **errMsg);
+
+/**
+* \brief Fills in the header of a binary for the given records
+*
+* \param[out] header       Header to fill in
+* \param[in]  type         adi_adrv9001_BinaryType_e of the records
+* \param[in]  firstIndex   Gain or atten index of the first table row, 0 for a profile
+* \param[in]  records      Records that follow the header
+* \param[in]  recordSize   Size of one record
+* \param[in]  recordCount  Number of records
+*/
+void adrv9001_Binary_HeaderFill(adi_adrv9001_BinaryHeader_t *header,
+                                adi_adrv9001_BinaryType_e type,
+                                uint32_t firstIndex,
+                                const uint8_t records[],
+                                uint32_t recordSize,
+                                uint32_t recordCount);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ADRV9001_BINARY_H_ */
@@ -1764,7 +1764,7 @@ static int32_t adrv9001_mag21CompPfir_Write(adi_adrv9001_Device_t *device,
     for (i = 0; i < totalFilters; i++)
     {
         pfirBufferAddr = pfirMag21BufferStructAddr[i];
-        cfgData[offset++] = pfirBufferAddr[i].numCoeff;
+        cfgData[offset++] = pfirBufferAddr->numCoeff;
 
         /* 3 bytes padding is needed for alignment */
         offset += 3;
@@ -1798,7 +1798,7 @@ static int32_t adrv9001_mag13CompPfir_Write(adi_adrv9001_Device_t *device,
     for (i = 0; i < totalFilters; i++)
     {
         pfirBufferAddr = pfirMag13BufferStructAddr[i];
-        cfgData[offset++] = pfirBufferAddr[i].numCoeff;
+        cfgData[offset++] = pfirBufferAddr->numCoeff;
 
         /* 3 bytes padding is needed for alignment */
         offset += 3;
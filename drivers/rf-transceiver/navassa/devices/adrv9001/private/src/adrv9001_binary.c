@@ -0,0 +1,93 @@
+/**
+* \file
+* \brief Contains the private helpers for the precompiled profile and table binaries
+*        defined in adrv9001_binary.h
+*
+* ADRV9001 API Version: $ADI_ADRV9001_API_VERSION$
+*/
+
+/**
+* Copyright 2020 Analog Devices Inc.
+* Released under the ADRV9001 API license, for more information
+* see the "LICENSE.txt" file in this zip file.
+*/
+
+#include "adi_adrv9001_user.h"
+#include "adi_common_error_types.h"
+#include "adrv9001_binary.h"
+#include "adrv9001_crc32.h"
+
+#ifdef __KERNEL__
+#include <linux/kernel.h>
+#else
+#include <stddef.h>
+#endif
+
+int32_t adrv9001_Binary_Check(const uint8_t binary[],
+                              uint32_t length,
+                              adi_adrv9001_BinaryType_e type,
+                              uint32_t recordSize,
+                              uint32_t maxRecords,
+                              const char **errMsg)
+{
+    const adi_adrv9001_BinaryHeader_t *header = (const adi_adrv9001_BinaryHeader_t *)binary;
+    const char *msg = NULL;
+
+    if (binary == NULL)
+    {
+        msg = "Binary buffer is NULL";
+    }
+    /* The records are used in place, so they must be aligned like the API structures */
+    else if ((length < sizeof(*header)) || (((uintptr_t)binary % sizeof(uint32_t)) != 0))
+    {
+        msg = "Binary is too short or not 4 byte aligned";
+    }
+    else if ((header->magic != ADI_ADRV9001_BINARY_MAGIC) || (header->version != ADI_ADRV9001_BINARY_VERSION))
+    {
+        msg = "Not an ADRV9001 binary of a supported version";
+    }
+    else if (header->type != type)
+    {
+        msg = "Unexpected binary content type";
+    }
+    else if (header->recordSize != recordSize)
+    {
+        msg = "Binary was created for a different structure layout";
+    }
+    else if ((header->recordCount == 0) ||
+             (header->recordCount > maxRecords) ||
+             (((uint64_t)header->recordSize * header->recordCount) > (length - sizeof(*header))))
+    {
+        msg = "Invalid number of records in binary";
+    }
+    else if (adrv9001_Crc32ForChunk(&binary[sizeof(*header)],
+                                    header->recordSize * header->recordCount,
+                                    0,
+                                    1) != header->crc32)
+    {
+        msg = "Binary CRC mismatch";
+    }
+
+    if (errMsg != NULL)
+    {
+        *errMsg = msg;
+    }
+
+    return (msg == NULL) ? ADI_COMMON_ERR_OK : ADI_COMMON_ERR_INV_PARAM;
+}
+
+void adrv9001_Binary_HeaderFill(adi_adrv9001_BinaryHeader_t *header,
+                                adi_adrv9001_BinaryType_e type,
+                                uint32_t firstIndex,
+                                const uint8_t records[],
+                                uint32_t recordSize,
+                                uint32_t recordCount)
+{
+    header->magic = ADI_ADRV9001_BINARY_MAGIC;
+    header->version = ADI_ADRV9001_BINARY_VERSION;
+    header->type = (uint16_t)type;
+    header->recordSize = recordSize;
+    header->recordCount = recordCount;
+    header->firstIndex = firstIndex;
+    header->crc32 = adrv9001_Crc32ForChunk(records, recordSize * recordCount, 0, 1);
+}
@@ -165,6 +165,41 @@ int32_t adi_adrv9001_spi_Cache_Write(adi_adrv9001_Device_t *adrv9001, const uint
 */
 int32_t adi_adrv9001_spi_Cache_Read(adi_adrv9001_Device_t *adrv9001, const uint32_t rdCache[], uint8_t readData[], uint32_t count);
 
+/**
+* \brief Opens an SPI write batch.
+*
+* Until the matching adi_adrv9001_spi_Batch_End(), byte and field writes are held back and sent
+* as few SPI transfers as possible. Field writes use the write only hardware RMW instead of a
+* read followed by a write. Writes keep their order, and any read or non batched write first
+* sends the pending writes. A batch must not span delays that the held back writes are expected to precede.
+* Batches can be nested; the writes are sent when the outermost batch is closed.
+*
+* \param[in] adrv9001       Context variable - Pointer to the ADRV9001 device data structure
+*
+* \returns A code indicating success (ADI_COMMON_ACT_NO_ACTION) or the required action to recover
+*/
+int32_t adi_adrv9001_spi_Batch_Begin(adi_adrv9001_Device_t *adrv9001);
+
+/**
+* \brief Closes an SPI write batch, sending the pending writes when it is the outermost one.
+*
+* Must be called for every adi_adrv9001_spi_Batch_Begin(), also on error paths.
+*
+* \param[in] adrv9001       Context variable - Pointer to the ADRV9001 device data structure
+*
+* \returns A code indicating success (ADI_COMMON_ACT_NO_ACTION) or the required action to recover
+*/
+int32_t adi_adrv9001_spi_Batch_End(adi_adrv9001_Device_t *adrv9001);
+
+/**
+* \brief Sends the writes held back by the open SPI write batch.
+*
+* \param[in] adrv9001       Context variable - Pointer to the ADRV9001 device data structure
+*
+* \returns A code indicating success (ADI_COMMON_ACT_NO_ACTION) or the required action to recover
+*/
+int32_t adi_adrv9001_spi_Batch_Flush(adi_adrv9001_Device_t *adrv9001);
+
 #ifdef __cplusplus
 }
 #endif
@@ -36,6 +36,9 @@
 /* TODO: Determine a reasonable value */
 #define ADI_ADRV9001_READY_FOR_MCS_DELAY_US 100U
 
+/* Number of register writes held back while an SPI write batch is open */
+#define ADI_ADRV9001_SPI_BATCH_SIZE 64U
+
 /* TODO: Evaluate if this can be removed */
 /**
  * \brief Enum of all ADRV9001 channels
@@ -221,6 +224,16 @@ typedef struct adi_adrv9001_Info
     uint8_t frequencyHoppingEnabled;                                    /*!< Frequency hopping enabled flag from currently loaded profile */
 } adi_adrv9001_Info_t;
 
+/**
+* \brief Data structure holding the register writes of an open SPI write batch
+*/
+typedef struct adi_adrv9001_SpiBatch
+{
+    uint32_t wrCache[ADI_ADRV9001_SPI_BATCH_SIZE];  /*!< Pending writes, (addr << 16) | (mask << 8) | data as for adi_adrv9001_spi_Cache_Write() */
+    uint16_t count;                                 /*!< Number of pending writes */
+    uint8_t depth;                                  /*!< Nesting level of adi_adrv9001_spi_Batch_Begin() calls */
+} adi_adrv9001_SpiBatch_t;
+
 /**
 * \brief Data structure to hold ADRV9001 device instance settings
 */
@@ -229,6 +242,7 @@ typedef struct adi_adrv9001_Device
     adi_common_Device_t			common;        /*!< Common layer structure */
     adi_adrv9001_Info_t			devStateInfo;  /*!< ADRV9001 run time state information container */
     adi_adrv9001_SpiSettings_t	spiSettings;   /*!< Pointer to ADRV9001 SPI Settings */
+    adi_adrv9001_SpiBatch_t	spiBatch;      /*!< Register writes held back by adi_adrv9001_spi_Batch_Begin() */
 } adi_adrv9001_Device_t;
 #endif /* CLIENT_IGNORE */
 
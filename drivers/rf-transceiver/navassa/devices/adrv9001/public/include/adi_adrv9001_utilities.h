@@ -221,6 +221,71 @@ int32_t adi_adrv9001_Utilities_TxAttenTable_Load(adi_adrv9001_Device_t *adrv9001
                                                  const char *txAttenTablePath,
                                                  uint32_t txChannelMask);
 
+/**
+ * \brief This utility function loads an init struct from a precompiled profile binary
+ *
+ * The binary holds the adi_adrv9001_Init_t that adi_adrv9001_Utilities_DeviceProfile_Parse() produces
+ * for the same JSON profile, so no parsing is done at run time. The binary is checked for version,
+ * structure layout and CRC before it is used.
+ *
+ * \note Message type: \ref timing_direct "Direct register acccess"
+ *
+ * \pre The parameter init must have memory fully allocated.
+ *
+ * \param[in]  adrv9001              Context variable - Pointer to the ADRV9001 device data structure
+ * \param[out] init                  is an init struct where the contents of the profile will be written
+ * \param[in]  binary                Profile binary, 4 byte aligned
+ * \param[in]  length                Length of the binary in bytes
+ *
+ * \returns A code indicating success (ADI_COMMON_ACT_NO_ACTION) or the required action to recover
+ */
+int32_t adi_adrv9001_Utilities_DeviceProfileBinary_Parse(adi_adrv9001_Device_t *adrv9001,
+                                                         adi_adrv9001_Init_t *init,
+                                                         const uint8_t binary[],
+                                                         uint32_t length);
+
+/**
+ * \brief This utility function loads a precompiled Rx gain table binary to ADRV9001 Rx gain table SRAM
+ *
+ * Programs the same table and min/max gain indices as adi_adrv9001_Utilities_RxGainTable_Load() does
+ * for the csv file the binary was created from. The rows are written straight from the binary.
+ *
+ * \note Message type: \ref timing_direct "Direct register acccess"
+ *
+ * \param[in] adrv9001           Context variable - Pointer to the ADRV9001 device data structure
+ * \param[in] binary             Rx gain table binary, 4 byte aligned
+ * \param[in] length             Length of the binary in bytes
+ * \param[in] rxChannelMask      An OR'd combination of adi_common_ChannelNumber_e specifying which
+ *                               Rx gain tables to load
+ *
+ * \returns A code indicating success (ADI_COMMON_ACT_NO_ACTION) or the required action to recover
+ */
+int32_t adi_adrv9001_Utilities_RxGainTableBinary_Load(adi_adrv9001_Device_t *adrv9001,
+                                                      const uint8_t binary[],
+                                                      uint32_t length,
+                                                      uint32_t rxChannelMask);
+
+/**
+ * \brief This utility function loads a precompiled Tx atten table binary to ADRV9001 Tx atten table SRAM
+ *
+ * Programs the same table as adi_adrv9001_Utilities_TxAttenTable_Load() does for the csv file the
+ * binary was created from. The rows are written straight from the binary.
+ *
+ * \note Message type: \ref timing_direct "Direct register acccess"
+ *
+ * \param[in] adrv9001           Context variable - Pointer to the ADRV9001 device data structure
+ * \param[in] binary             Tx atten table binary, 4 byte aligned
+ * \param[in] length             Length of the binary in bytes
+ * \param[in] txChannelMask      An OR'd combination of adi_common_ChannelNumber_e specifying which
+ *                               Tx attenuation tables to load
+ *
+ * \returns A code indicating success (ADI_COMMON_ACT_NO_ACTION) or the required action to recover
+ */
+int32_t adi_adrv9001_Utilities_TxAttenTableBinary_Load(adi_adrv9001_Device_t *adrv9001,
+                                                       const uint8_t binary[],
+                                                       uint32_t length,
+                                                       uint32_t txChannelMask);
+
 /**
  * \brief This utility function dumps the ADRV9001 ARM program and data memory through ArmMemRead() API
  *
@@ -42,6 +42,36 @@
 #define ADI_ADRV9001_LINE_BUFFER_SIZE 128
 #define ADI_ADRV9001_HEADER_BUFFER_SIZE 16
 
+#define ADI_ADRV9001_BINARY_MAGIC 0x4E423941u   /* "A9BN" in little endian */
+#define ADI_ADRV9001_BINARY_VERSION 1
+
+/**
+* \brief Enum of the contents of a precompiled profile or table binary
+*/
+typedef enum adi_adrv9001_BinaryType
+{
+    ADI_ADRV9001_BINARY_TYPE_PROFILE = 1,       /*!< One adi_adrv9001_Init_t */
+    ADI_ADRV9001_BINARY_TYPE_RX_GAIN_TABLE = 2, /*!< adi_adrv9001_RxGainTableRow_t rows */
+    ADI_ADRV9001_BINARY_TYPE_TX_ATTEN_TABLE = 3 /*!< adi_adrv9001_TxAttenTableRow_t rows */
+} adi_adrv9001_BinaryType_e;
+
+/**
+* \brief Header of a precompiled profile or table binary
+*
+* The header is followed by recordCount records of recordSize bytes each, in the
+* in-memory layout of the API structures. All fields are little endian.
+*/
+typedef struct adi_adrv9001_BinaryHeader
+{
+    uint32_t magic;         /*!< ADI_ADRV9001_BINARY_MAGIC */
+    uint16_t version;       /*!< ADI_ADRV9001_BINARY_VERSION */
+    uint16_t type;          /*!< One of adi_adrv9001_BinaryType_e */
+    uint32_t recordSize;    /*!< Size of one record; rejects binaries built for a different struct layout */
+    uint32_t recordCount;   /*!< Number of records */
+    uint32_t firstIndex;    /*!< Gain or atten index of the first table row, 0 for a profile */
+    uint32_t crc32;         /*!< CRC32 of the records */
+} adi_adrv9001_BinaryHeader_t;
+
 /**
 * \brief Data structure to hold Radio Ctrl Utility Init structures
 */
@@ -260,6 +260,7 @@ int32_t adi_adrv9001_InitAnalog(adi_adrv9001_Device_t *device,
                                 adi_adrv9001_Init_t *init,
                                 adi_adrv9001_DeviceClockDivisor_e deviceClockOutDivisor)
 {
+    int32_t recoveryAction = ADI_COMMON_ACT_NO_ACTION;
     adi_adrv9001_Info_t devStateInfoClear = { 0 };
     static const uint8_t MAX_GAIN_INDEX = 0xFF;
 
@@ -277,7 +278,13 @@ int32_t adi_adrv9001_InitAnalog(adi_adrv9001_Device_t *device,
     device->devStateInfo.gainIndexes.rx1MaxGainIndex = MAX_GAIN_INDEX;
     device->devStateInfo.gainIndexes.rx2MaxGainIndex = MAX_GAIN_INDEX;
 
-    ADI_EXPECT(adrv9001_InitAnalog, device, init, deviceClockOutDivisor);
+    /* Analog init is a plain sequence of register writes; send it as batched HW RMW transactions */
+    ADI_EXPECT(adi_adrv9001_spi_Batch_Begin, device);
+    recoveryAction = adrv9001_InitAnalog(device, init, deviceClockOutDivisor);
+    /* Close the batch also on error, so that later writes are not held back */
+    ADI_EXPECT(adi_adrv9001_spi_Batch_End, device);
+    ADI_ERROR_REPORT(&device->common, ADI_COMMON_ERRSRC_API, device->common.error.errCode, recoveryAction, NULL, device->common.error.errormessage);
+    ADI_ERROR_RETURN(device->common.error.newAction);
 
     /* Disable stream pin mode until after streams are loaded */
     /* Disable Tx pin mode for all Tx and Rx channels, ORx was defaulted with pin mode disabled */
@@ -90,6 +90,79 @@ int32_t adi_adrv9001_spi_DataPack(adi_adrv9001_Device_t *device,
     ADI_API_RETURN(device);
 }
 
+int32_t adi_adrv9001_spi_Batch_Begin(adi_adrv9001_Device_t *device)
+{
+    ADI_NULL_DEVICE_PTR_RETURN(device);
+
+    device->spiBatch.depth++;
+
+    ADI_API_RETURN(device);
+}
+
+int32_t adi_adrv9001_spi_Batch_End(adi_adrv9001_Device_t *device)
+{
+    ADI_NULL_DEVICE_PTR_RETURN(device);
+
+    if (device->spiBatch.depth > 0)
+    {
+        device->spiBatch.depth--;
+    }
+
+    if (device->spiBatch.depth == 0)
+    {
+        ADI_EXPECT(adi_adrv9001_spi_Batch_Flush, device);
+    }
+
+    ADI_API_RETURN(device);
+}
+
+int32_t adi_adrv9001_spi_Batch_Flush(adi_adrv9001_Device_t *device)
+{
+    /* Worst case every write is a 12 byte hardware RMW, keep below the HAL buffer size */
+    static const uint32_t MAX_WRITES_PER_TRANSFER = (HAL_SPIWRITEARRAY_BUFFERSIZE / ADRV9001_HW_RMW_BYTES) - 1;
+    uint32_t count = 0;
+    uint32_t i = 0;
+    uint32_t n = 0;
+
+    ADI_NULL_DEVICE_PTR_RETURN(device);
+
+    /* Clear the batch first, adi_adrv9001_spi_Cache_Write() flushes pending writes on entry */
+    count = device->spiBatch.count;
+    device->spiBatch.count = 0;
+
+    for (i = 0; i < count; i += n)
+    {
+        n = ((count - i) > MAX_WRITES_PER_TRANSFER) ? MAX_WRITES_PER_TRANSFER : (count - i);
+        ADI_EXPECT(adi_adrv9001_spi_Cache_Write, device, &device->spiBatch.wrCache[i], n);
+    }
+
+    ADI_API_RETURN(device);
+}
+
+/* Queue a register write in the open batch, in issue order */
+static int32_t adrv9001_spi_Batch_Add(adi_adrv9001_Device_t *device, uint16_t addr, uint8_t data, uint8_t mask)
+{
+    adi_adrv9001_SpiBatch_t *batch = &device->spiBatch;
+
+    if (batch->count == ADI_ADRV9001_SPI_BATCH_SIZE)
+    {
+        ADI_EXPECT(adi_adrv9001_spi_Batch_Flush, device);
+    }
+
+    batch->wrCache[batch->count++] = ((uint32_t)addr << SPI_ADDR_SIZE) | ((uint32_t)mask << SPI_MASK_SIZE) | (data & mask);
+
+    ADI_API_RETURN(device);
+}
+
+/* Write out the open batch before an access that is not batched, to keep the access order */
+#define ADRV9001_SPI_BATCH_SYNC(device) \
+{ \
+    if ((device)->spiBatch.count > 0) \
+    { \
+        ADI_EXPECT(adi_adrv9001_spi_Batch_Flush, (device)); \
+    } \
+}
+
 int32_t adi_adrv9001_spi_Byte_Write(adi_adrv9001_Device_t *device, uint16_t addr, uint8_t data)
 {
     int32_t halError = 0;
@@ -101,6 +174,11 @@ int32_t adi_adrv9001_spi_Byte_Write(adi_adrv9001_Device_t *device, uint16_t addr
 
     ADI_FUNCTION_ENTRY_VARIABLE_LOG(&device->common, ADI_COMMON_LOG_SPI, "%s(0x%04X, 0x%02X)", addr, data);
 
+    if (device->spiBatch.depth > 0)
+    {
+        return adrv9001_spi_Batch_Add(device, addr, data, 0xFF);
+    }
+
     ADI_EXPECT(adi_adrv9001_spi_DataPack, device, &txData[0], &numTxBytes, addr, 0xFF, data, ADRV9001_SPI_WRITE_POLARITY);
 
     for (i = 0; i < ADI_ADRV9001_NUMBER_SPI_RETRY; i++)
@@ -138,6 +216,8 @@ int32_t adi_adrv9001_spi_Bytes_Write(adi_adrv9001_Device_t *device, const uint16
 
     ADI_NULL_PTR_RETURN(&device->common, data);
 
+    ADRV9001_SPI_BATCH_SYNC(device);
+
     for (i = 0; i < count; i++)
     {
         ADI_EXPECT(adi_adrv9001_spi_DataPack, device, &wrData[0], &numWrBytes, addr[i], 0xFF, data[i], ADRV9001_SPI_WRITE_POLARITY);
@@ -171,6 +251,8 @@ int32_t adi_adrv9001_spi_Byte_Read(adi_adrv9001_Device_t *device, uint16_t addr,
    
     ADI_ENTRY_PTR_EXPECT(device, ADI_COMMON_LOG_HAL, readData);
 
+    ADRV9001_SPI_BATCH_SYNC(device);
+
     ADI_EXPECT(adi_adrv9001_spi_DataPack, device, &wrData[0], &numWrBytes, addr, 0xFF, regVal, ~ADRV9001_SPI_WRITE_POLARITY);
 
     for (i = 0; i < ADI_ADRV9001_NUMBER_SPI_RETRY; i++)
@@ -216,6 +298,8 @@ int32_t adi_adrv9001_spi_Bytes_Read(adi_adrv9001_Device_t *device,
 
     ADI_NULL_PTR_RETURN(&device->common, readData);
 
+    ADRV9001_SPI_BATCH_SYNC(device);
+
     for (i = 0; i < count; i++)
     {
         recoveryAction = adi_adrv9001_spi_DataPack(device, &wrData[0], &numWrBytes, addr[i], 0xFF, regVal, ~ADRV9001_SPI_WRITE_POLARITY);
@@ -269,7 +353,13 @@ int32_t adi_adrv9001_spi_Field_Write(adi_adrv9001_Device_t *device,
     ADI_NULL_DEVICE_PTR_RETURN(device);
 
     ADI_FUNCTION_ENTRY_VARIABLE_LOG(&device->common, ADI_COMMON_LOG_SPI, "%s(0x%04X, 0x%02X)", addr, regVal);
-            
+
+    /* Batched field writes use the write only hardware RMW, no read back is needed */
+    if (device->spiBatch.depth > 0)
+    {
+        return adrv9001_spi_Batch_Add(device, addr, regVal, mask);
+    }
+
     ADI_EXPECT(adi_adrv9001_spi_DataPack, device, &wrData[0], &numWrBytes, addr, 0xFF, regVal, ~ADRV9001_SPI_WRITE_POLARITY);
     for (i = 0; i < ADI_ADRV9001_NUMBER_SPI_RETRY; i++)
     {
@@ -328,6 +418,8 @@ int32_t adi_adrv9001_spi_Field_Read(adi_adrv9001_Device_t *device,
 
     ADI_NULL_PTR_RETURN(&device->common, fieldVal);
 
+    ADRV9001_SPI_BATCH_SYNC(device);
+
     ADI_EXPECT(adi_adrv9001_spi_DataPack, device, &wrData[0], &numWrBytes, addr, 0xFF, regVal, ~ADRV9001_SPI_WRITE_POLARITY);
 
     for (i = 0; i < ADI_ADRV9001_NUMBER_SPI_RETRY; i++)
@@ -372,6 +464,8 @@ int32_t adi_adrv9001_spi_Cache_Write(adi_adrv9001_Device_t *device,
 
     ADI_NULL_DEVICE_PTR_RETURN(device);
 
+    ADRV9001_SPI_BATCH_SYNC(device);
+
 #ifdef ADI_ADRV9001_VERBOSE
     ADI_FUNCTION_ENTRY_LOG(&device->common, ADI_COMMON_LOG_HAL);
 
@@ -431,6 +525,8 @@ int32_t adi_adrv9001_spi_Cache_Read(adi_adrv9001_Device_t *device,
 
     ADI_NULL_PTR_RETURN(&device->common, readData);
 
+    ADRV9001_SPI_BATCH_SYNC(device);
+
     for (i = 0; i < count; i++)
     {
         ADI_EXPECT(adi_adrv9001_spi_DataPack,
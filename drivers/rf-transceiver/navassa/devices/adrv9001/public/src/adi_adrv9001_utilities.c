@@ -28,6 +28,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <limits.h>
 #endif
 
 #include "adi_adrv9001_user.h"
@@ -49,6 +50,7 @@
 #include "adrv9001_arm_macros.h"
 #include "adrv9001_reg_addr_macros.h"
 #include "adrv9001_bf_hal.h"
+#include "adrv9001_binary.h"
 #include "adrv9001_init.h"
 #include "adrv9001_utilities.h"
 #include "adi_adrv9001_gpio.h"
@@ -85,8 +87,8 @@ int32_t adi_adrv9001_Utilities_DeviceProfile_Parse(adi_adrv9001_Device_t *device
         ADI_ERROR_RETURN(device->common.error.newAction);
     }
 
-    /* allocate space for tokens */
-    tokens = (jsmntok_t*)calloc(numTokens, sizeof(jsmntok_t));
+    /* allocate space for tokens, plus a sentinel as the parser macros look one token past the last one */
+    tokens = (jsmntok_t*)calloc(numTokens + 1, sizeof(jsmntok_t));
 
     if (NULL == tokens)
     {
@@ -99,6 +101,8 @@ int32_t adi_adrv9001_Utilities_DeviceProfile_Parse(adi_adrv9001_Device_t *device
         ADI_ERROR_RETURN(device->common.error.newAction);
     }
 
+    tokens[numTokens].start = INT_MAX;
+
     /* initialize the JSMN parser and parse the profile file into the tokens array */
     jsmn_init(&parser);
     numTokens = jsmn_parse(&parser, jsonBuffer, length, tokens, numTokens);
@@ -274,10 +278,34 @@ int32_t adi_adrv9001_Utilities_ArmImage_Load(adi_adrv9001_Device_t *device, cons
     int32_t recoveryAction = ADI_COMMON_ACT_NO_ACTION;
     uint32_t i = 0;
     uint8_t armBinaryImageBuffer[ADI_ADRV9001_ARM_BINARY_IMAGE_LOAD_CHUNK_SIZE_BYTES];
+    const uint8_t *armImage = NULL;
+    uint32_t armImageSize = 0;
 
     /* Check device pointer is not null */
     ADI_API_ENTRY_EXPECT(device);
 
+    /* Memory mapped image: write it straight from where it is stored, with a single DMA setup */
+    if ((adi_hal_ArmImageGet != NULL) &&
+        (adi_hal_ArmImageGet(device->common.devHalInfo, armImagePath, &armImage, &armImageSize) == ADI_COMMON_HAL_OK))
+    {
+        if ((armImageSize == 0) ||
+            (armImageSize > ADI_ADRV9001_ARM_BINARY_IMAGE_FILE_SIZE_BYTES) ||
+            ((armImageSize % 4) != 0))
+        {
+            ADI_ERROR_REPORT(&device->common,
+                             ADI_COMMON_ERRSRC_API,
+                             ADI_COMMON_ERR_INV_PARAM,
+                             ADI_COMMON_ACT_ERR_CHECK_PARAM,
+                             armImageSize,
+                             "Invalid ARM binary image size");
+            ADI_ERROR_RETURN(device->common.error.newAction);
+        }
+
+        ADI_MSG_EXPECT("Fatal error while writing ARM binary file", adi_adrv9001_arm_Image_Write, device, 0, armImage, armImageSize);
+
+        ADI_API_RETURN(device);
+    }
+
     /*Read ARM binary file*/
     for (i = 0; i < (ADI_ADRV9001_ARM_BINARY_IMAGE_FILE_SIZE_BYTES/ADI_ADRV9001_ARM_BINARY_IMAGE_LOAD_CHUNK_SIZE_BYTES); i++)
     {
@@ -1259,6 +1287,136 @@ int32_t adi_adrv9001_Utilities_TxAttenTable_Load(adi_adrv9001_Device_t *device,
 }
 #endif
 
+int32_t adi_adrv9001_Utilities_DeviceProfileBinary_Parse(adi_adrv9001_Device_t *device,
+                                                         adi_adrv9001_Init_t *init,
+                                                         const uint8_t binary[],
+                                                         uint32_t length)
+{
+    const char *errMsg = NULL;
+
+    ADI_API_ENTRY_PTR_EXPECT(device, init);
+
+    if (adrv9001_Binary_Check(binary, length, ADI_ADRV9001_BINARY_TYPE_PROFILE, sizeof(*init), 1, &errMsg) != ADI_COMMON_ERR_OK)
+    {
+        ADI_ERROR_REPORT(&device->common,
+                         ADI_COMMON_ERRSRC_API,
+                         ADI_COMMON_ERR_INV_PARAM,
+                         ADI_COMMON_ACT_ERR_CHECK_PARAM,
+                         binary,
+                         errMsg);
+        ADI_ERROR_RETURN(device->common.error.newAction);
+    }
+
+    memcpy(init, &binary[sizeof(adi_adrv9001_BinaryHeader_t)], sizeof(*init));
+
+    ADI_API_RETURN(device);
+}
+
+int32_t adi_adrv9001_Utilities_RxGainTableBinary_Load(adi_adrv9001_Device_t *device,
+                                                      const uint8_t binary[],
+                                                      uint32_t length,
+                                                      uint32_t rxChannelMask)
+{
+    static const uint32_t MAX_GAIN_INDEX = 0xFF;
+
+    const adi_adrv9001_BinaryHeader_t *header = (const adi_adrv9001_BinaryHeader_t *)binary;
+    const char *errMsg = NULL;
+    uint8_t minGainIndex = 0;
+    uint8_t maxGainIndex = 0;
+
+    /* Don't load the Rx gain tables if the rxChannelMask is 0 */
+    if (rxChannelMask == 0)
+    {
+        return ADI_COMMON_ACT_NO_ACTION;
+    }
+
+    ADI_API_ENTRY_EXPECT(device);
+
+    if (adrv9001_Binary_Check(binary,
+                              length,
+                              ADI_ADRV9001_BINARY_TYPE_RX_GAIN_TABLE,
+                              sizeof(adi_adrv9001_RxGainTableRow_t),
+                              ADI_ADRV9001_RX_GAIN_TABLE_SIZE_ROWS,
+                              &errMsg) != ADI_COMMON_ERR_OK)
+    {
+        ADI_ERROR_REPORT(&device->common,
+                         ADI_COMMON_ERRSRC_API,
+                         ADI_COMMON_ERR_INV_PARAM,
+                         ADI_COMMON_ACT_ERR_CHECK_PARAM,
+                         binary,
+                         errMsg);
+        ADI_ERROR_RETURN(device->common.error.newAction);
+    }
+
+    if ((header->firstIndex + header->recordCount - 1) > MAX_GAIN_INDEX)
+    {
+        ADI_ERROR_REPORT(&device->common,
+                         ADI_COMMON_ERRSRC_API,
+                         ADI_COMMON_ERR_INV_PARAM,
+                         ADI_COMMON_ACT_ERR_CHECK_PARAM,
+                         header->firstIndex,
+                         "Rx gain table binary exceeds the maximum gain index");
+        ADI_ERROR_RETURN(device->common.error.newAction);
+    }
+
+    minGainIndex = (uint8_t)header->firstIndex;
+    maxGainIndex = (uint8_t)(header->firstIndex + header->recordCount - 1);
+
+    /* The rows are written to the device straight from the binary */
+    ADI_EXPECT(adi_adrv9001_Rx_GainTable_Write,
+               device,
+               rxChannelMask,
+               maxGainIndex,
+               (adi_adrv9001_RxGainTableRow_t *)&binary[sizeof(*header)],
+               header->recordCount);
+
+    ADI_EXPECT(adi_adrv9001_Rx_MinMaxGainIndex_Set, device, rxChannelMask, minGainIndex, maxGainIndex);
+
+    ADI_API_RETURN(device);
+}
+
+int32_t adi_adrv9001_Utilities_TxAttenTableBinary_Load(adi_adrv9001_Device_t *device,
+                                                       const uint8_t binary[],
+                                                       uint32_t length,
+                                                       uint32_t txChannelMask)
+{
+    const adi_adrv9001_BinaryHeader_t *header = (const adi_adrv9001_BinaryHeader_t *)binary;
+    const char *errMsg = NULL;
+
+    /* Don't load the Tx atten tables if the txChannelMask is 0 */
+    if (txChannelMask == 0)
+    {
+        return ADI_COMMON_ACT_NO_ACTION;
+    }
+
+    ADI_API_ENTRY_EXPECT(device);
+
+    if (adrv9001_Binary_Check(binary,
+                              length,
+                              ADI_ADRV9001_BINARY_TYPE_TX_ATTEN_TABLE,
+                              sizeof(adi_adrv9001_TxAttenTableRow_t),
+                              ADI_ADRV9001_TX_ATTEN_TABLE_SIZE_ROWS,
+                              &errMsg) != ADI_COMMON_ERR_OK)
+    {
+        ADI_ERROR_REPORT(&device->common,
+                         ADI_COMMON_ERRSRC_API,
+                         ADI_COMMON_ERR_INV_PARAM,
+                         ADI_COMMON_ACT_ERR_CHECK_PARAM,
+                         binary,
+                         errMsg);
+        ADI_ERROR_RETURN(device->common.error.newAction);
+    }
+
+    ADI_EXPECT(adi_adrv9001_Tx_AttenuationTable_Write,
+               device,
+               txChannelMask,
+               header->firstIndex,
+               (adi_adrv9001_TxAttenTableRow_t *)&binary[sizeof(*header)],
+               header->recordCount);
+
+    ADI_API_RETURN(device);
+}
+
 #ifdef ADI_FILESYSTEM_AVAILABLE
 int32_t adi_adrv9001_Utilities_ArmMemory_Dump(adi_adrv9001_Device_t *device, const char *binaryFilename)
 {
@@ -1466,6 +1624,7 @@ int32_t adi_adrv9001_Utilities_InitRadio_Load(adi_adrv9001_Device_t *device,
                                               adi_adrv9001_ResourceCfg_t *initConfig,
                                               uint8_t channelMask)
 {
+    int32_t recoveryAction = ADI_COMMON_ACT_NO_ACTION;
     adi_adrv9001_SsiType_e ssiType = ADI_ADRV9001_SSI_TYPE_DISABLE;
 
     /* Check device pointer is not null */
@@ -1479,7 +1638,11 @@ int32_t adi_adrv9001_Utilities_InitRadio_Load(adi_adrv9001_Device_t *device,
         initConfig->adrv9001Init->tx.txProfile[1].txSsiConfig.ssiType;
 
     /* LVDS forced mode */
-    ADI_MSG_EXPECT("Error programming SSI delay configuration", adi_adrv9001_Ssi_Delay_Configure, device, ssiType, &(initConfig->radioCtrlInit->ssiConfig));
+    ADI_EXPECT(adi_adrv9001_spi_Batch_Begin, device);
+    recoveryAction = adi_adrv9001_Ssi_Delay_Configure(device, ssiType, &(initConfig->radioCtrlInit->ssiConfig));
+    ADI_EXPECT(adi_adrv9001_spi_Batch_End, device);
+    ADI_ERROR_REPORT(&device->common, ADI_COMMON_ERRSRC_API, device->common.error.errCode, recoveryAction, NULL, "Error programming SSI delay configuration");
+    ADI_ERROR_RETURN(device->common.error.newAction);
 
     ADI_EXPECT(adi_adrv9001_gpio_ControlInit_Configure, device, &initConfig->radioCtrlInit->gpioCtrlInitCfg);
 
@@ -41,6 +41,7 @@
 #include "spi.h"
 #include <stdlib.h>
 #include "error.h"
+#include "trace.h"
 
 /**
  * @brief Initialize the SPI communication peripheral.
@@ -83,5 +84,12 @@ int32_t spi_write_and_read(struct spi_desc *desc,
 			   uint8_t *data,
 			   uint16_t bytes_number)
 {
-	return desc->platform_ops->spi_ops_write_and_read(desc, data, bytes_number);
+	int32_t ret;
+
+	TRACE_BEGIN(TRACE_ID_SPI_WRITE_AND_READ);
+	ret = desc->platform_ops->spi_ops_write_and_read(desc, data,
+			bytes_number);
+	TRACE_END(TRACE_ID_SPI_WRITE_AND_READ);
+
+	return ret;
 }
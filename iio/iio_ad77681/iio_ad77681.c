@@ -0,0 +1,223 @@
+/***************************************************************************//**
+ *   @file   iio_ad77681.c
+ *   @brief  Implementation of iio_ad77681.c.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <string.h>
+#include <stdlib.h>
+#include "error.h"
+#include "util.h"
+#include "iio_ad77681.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get the output data rate.
+ * @param device - Instance of the iio_ad77681.
+ * @param buf - Buffer where the value is written.
+ * @param len - Length of buf.
+ * @param channel - Channel info.
+ * @param priv - Unused.
+ * @return Number of bytes written in buf.
+ */
+static ssize_t get_sampling_frequency(void *device, char *buf, size_t len,
+				      const struct iio_ch_info *channel,
+				      intptr_t priv)
+{
+	struct iio_ad77681_desc *desc = device;
+
+	return snprintf(buf, len, "%"PRIu32"", desc->dev->sample_rate);
+}
+
+/**
+ * @brief Get the number of frames received with a bad checksum.
+ * @param device - Instance of the iio_ad77681.
+ * @param buf - Buffer where the value is written.
+ * @param len - Length of buf.
+ * @param channel - Channel info.
+ * @param priv - Unused.
+ * @return Number of bytes written in buf.
+ */
+static ssize_t get_crc_errors(void *device, char *buf, size_t len,
+			      const struct iio_ch_info *channel,
+			      intptr_t priv)
+{
+	struct iio_ad77681_desc *desc = device;
+
+	return snprintf(buf, len, "%"PRIu32"", desc->dev->crc_errors);
+}
+
+static struct iio_attribute iio_ad77681_attributes[] = {
+	{
+		.name = "sampling_frequency",
+		.show = get_sampling_frequency,
+		.store = NULL,
+	},
+	{
+		.name = "crc_errors",
+		.show = get_crc_errors,
+		.store = NULL,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+/**
+ * @brief Enter continuous read mode and start streaming.
+ * @param dev - Instance of the iio_ad77681.
+ * @param mask - Mask of the active channels.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_ad77681_prepare_transfer(void *dev, uint32_t mask)
+{
+	struct iio_ad77681_desc *desc = dev;
+
+	return ad77681_stream_start(desc->dev, &desc->stream_param);
+}
+
+/**
+ * @brief Stop streaming and leave continuous read mode.
+ * @param dev - Instance of the iio_ad77681.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_ad77681_end_transfer(void *dev)
+{
+	struct iio_ad77681_desc *desc = dev;
+
+	return ad77681_stream_stop(desc->dev);
+}
+
+/**
+ * @brief Read a block of samples, checking the frame checksums.
+ * @param dev - Instance of the iio_ad77681.
+ * @param buff - Buffer where to read samples, 32 bits per sample.
+ * @param nb_samples - Number of samples.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_ad77681_read_dev(void *dev, void *buff, uint32_t nb_samples)
+{
+	struct iio_ad77681_desc *desc = dev;
+
+	if (!desc)
+		return FAILURE;
+
+	return ad77681_stream_read_samples(desc->dev, buff, nb_samples);
+}
+
+/**
+ * @brief Get iio device descriptor.
+ * @param desc - Descriptor.
+ * @param dev_descriptor - iio device descriptor.
+ */
+void iio_ad77681_get_dev_descriptor(struct iio_ad77681_desc *desc,
+				    struct iio_device **dev_descriptor)
+{
+	*dev_descriptor = &desc->dev_descriptor;
+}
+
+/**
+ * @brief Init the iio interface of an ad77681 device.
+ * @param desc - Descriptor.
+ * @param param - Configuration structure.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t iio_ad77681_init(struct iio_ad77681_desc **desc,
+			 struct iio_ad77681_init_param *param)
+{
+	struct iio_ad77681_desc *iio_ad77681;
+
+	if (!param || !param->dev)
+		return FAILURE;
+
+	iio_ad77681 = (struct iio_ad77681_desc *)calloc(1, sizeof(*iio_ad77681));
+	if (!iio_ad77681)
+		return FAILURE;
+
+	iio_ad77681->dev = param->dev;
+	iio_ad77681->stream_param = param->stream_param;
+
+	iio_ad77681->scan_type.sign = 's';
+	iio_ad77681->scan_type.realbits =
+		(param->dev->conv_len == AD77681_CONV_24BIT) ? 24 : 16;
+	iio_ad77681->scan_type.storagebits = 32;
+	iio_ad77681->scan_type.shift = 0;
+	iio_ad77681->scan_type.is_big_endian = false;
+
+	iio_ad77681->channel.name = "voltage0";
+	iio_ad77681->channel.ch_type = IIO_VOLTAGE;
+	iio_ad77681->channel.channel = 0;
+	iio_ad77681->channel.scan_index = 0;
+	iio_ad77681->channel.scan_type = &iio_ad77681->scan_type;
+	iio_ad77681->channel.attributes = NULL;
+	iio_ad77681->channel.ch_out = false;
+	iio_ad77681->channel.indexed = true;
+
+	iio_ad77681->dev_descriptor.num_ch = 1;
+	iio_ad77681->dev_descriptor.channels = &iio_ad77681->channel;
+	iio_ad77681->dev_descriptor.attributes = iio_ad77681_attributes;
+	iio_ad77681->dev_descriptor.debug_attributes = NULL;
+	iio_ad77681->dev_descriptor.buffer_attributes = NULL;
+	iio_ad77681->dev_descriptor.prepare_transfer = iio_ad77681_prepare_transfer;
+	iio_ad77681->dev_descriptor.end_transfer = iio_ad77681_end_transfer;
+	iio_ad77681->dev_descriptor.read_dev = iio_ad77681_read_dev;
+	*desc = iio_ad77681;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Release resources.
+ * @param desc - Descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t iio_ad77681_remove(struct iio_ad77681_desc *desc)
+{
+	if (!desc)
+		return FAILURE;
+
+	if (desc->dev->streaming)
+		ad77681_stream_stop(desc->dev);
+
+	free(desc);
+
+	return SUCCESS;
+}
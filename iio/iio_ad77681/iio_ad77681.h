@@ -0,0 +1,94 @@
+/***************************************************************************//**
+*   @file   iio_ad77681.h
+*   @brief  Header file of iio_ad77681
+********************************************************************************
+* Copyright 2020(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+* IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef IIO_AD77681_H_
+#define IIO_AD77681_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include "iio_types.h"
+#include "ad77681.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct iio_ad77681_init_param
+ * @brief iio_ad77681 configuration.
+ */
+struct iio_ad77681_init_param {
+	/** ad77681 device, set up by ad77681_setup() */
+	struct ad77681_dev *dev;
+	/** Continuous read streaming parameters */
+	struct ad77681_stream_param stream_param;
+};
+
+/**
+ * @struct iio_ad77681_desc
+ * @brief iio_ad77681 descriptor.
+ */
+struct iio_ad77681_desc {
+	/** ad77681 device */
+	struct ad77681_dev *dev;
+	/** Continuous read streaming parameters */
+	struct ad77681_stream_param stream_param;
+	/** Sample format, depends on the conversion length */
+	struct scan_type scan_type;
+	/** The single voltage channel */
+	struct iio_channel channel;
+	/** iio device descriptor */
+	struct iio_device dev_descriptor;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Init function. */
+int32_t iio_ad77681_init(struct iio_ad77681_desc **desc,
+			 struct iio_ad77681_init_param *param);
+/* Get desciptor. */
+void iio_ad77681_get_dev_descriptor(struct iio_ad77681_desc *desc,
+				    struct iio_device **dev_descriptor);
+/* Free the resources allocated by iio_ad77681_init(). */
+int32_t iio_ad77681_remove(struct iio_ad77681_desc *desc);
+
+#endif /* IIO_AD77681_H_ */
@@ -42,6 +42,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "adxrs290.h"
+#include "iio_adxrs290.h"
 #include "util.h"
 #include "error.h"
 
@@ -87,10 +88,14 @@ ssize_t get_adxrs290_iio_ch_raw(void *device, char *buf, size_t len,
 				const struct iio_ch_info *channel,
 				intptr_t priv)
 {
+	struct iio_adxrs290_desc *desc = device;
 	int16_t data;
 
-	adxrs290_get_rate_data((struct adxrs290_dev *)device,
-			       channel->ch_num, &data);
+	/* The trigger owns the SPI bus while capturing */
+	if (desc->trig_buf->active)
+		return -EBUSY;
+
+	adxrs290_get_rate_data(desc->dev, channel->ch_num, &data);
 	if (channel->ch_num == ADXRS290_CHANNEL_TEMP)
 		data = (data << 4) >> 4;
 
@@ -114,8 +119,13 @@ ssize_t get_adxrs290_iio_ch_hpf(void *device, char *buf, size_t len,
 				const struct iio_ch_info *channel,
 				intptr_t priv)
 {
-	uint8_t index;
-	adxrs290_get_hpf((struct adxrs290_dev *)device, &index);
+	struct iio_adxrs290_desc *desc = device;
+	enum adxrs290_hpf index;
+
+	if (desc->trig_buf->active)
+		return -EBUSY;
+
+	adxrs290_get_hpf(desc->dev, &index);
 	if (index > 0x0A)
 		index = 0x0A;
 
@@ -128,16 +138,20 @@ ssize_t set_adxrs290_iio_ch_hpf(void *device, char *buf, size_t len,
 				const struct iio_ch_info *channel,
 				intptr_t priv)
 {
+	struct iio_adxrs290_desc *desc = device;
 	float hpf = strtof(buf, NULL);
 	int32_t val = (int32_t)hpf;
 	int32_t val2 = (int32_t)(hpf * 1000000) % 1000000;
 	uint8_t i;
 	uint8_t n = ARRAY_SIZE(adxrs290_hpf_3db_freq_hz_table);
 
+	if (desc->trig_buf->active)
+		return -EBUSY;
+
 	for (i = 0; i < n; i++)
 		if (adxrs290_hpf_3db_freq_hz_table[i][0] == val
 		    && adxrs290_hpf_3db_freq_hz_table[i][1] == val2) {
-			adxrs290_set_hpf(device, (enum adxrs290_hpf) i);
+			adxrs290_set_hpf(desc->dev, (enum adxrs290_hpf) i);
 
 			return len;
 		}
@@ -149,9 +163,13 @@ ssize_t get_adxrs290_iio_ch_lpf(void *device, char *buf, size_t len,
 				const struct iio_ch_info *channel,
 				intptr_t priv)
 {
-	uint8_t index;
+	struct iio_adxrs290_desc *desc = device;
+	enum adxrs290_lpf index;
+
+	if (desc->trig_buf->active)
+		return -EBUSY;
 
-	adxrs290_get_lpf((struct adxrs290_dev *)device, &index);
+	adxrs290_get_lpf(desc->dev, &index);
 	if (index > 0x07)
 		index = 0x07;
 
@@ -163,18 +181,354 @@ ssize_t set_adxrs290_iio_ch_lpf(void *device, char *buf, size_t len,
 				const struct iio_ch_info *channel,
 				intptr_t priv)
 {
+	struct iio_adxrs290_desc *desc = device;
 	float lpf = strtof(buf, NULL);
 	int32_t val = (int32_t)lpf;
 	int32_t val2 = (int32_t)(lpf * 1000000) % 1000000;
 	uint8_t i;
 	uint8_t n = ARRAY_SIZE(adxrs290_lpf_3db_freq_hz_table);
 
+	if (desc->trig_buf->active)
+		return -EBUSY;
+
 	for (i = 0; i < n; i++)
 		if (adxrs290_lpf_3db_freq_hz_table[i][0] == val
 		    && adxrs290_lpf_3db_freq_hz_table[i][1] == val2) {
-			adxrs290_set_lpf(device, (enum adxrs290_lpf) i);
+			adxrs290_set_lpf(desc->dev, (enum adxrs290_lpf) i);
 			return len;
 		}
 
 	return FAILURE;
 }
+
+static struct iio_attribute adxrs290_iio_vel_attrs[] = {
+	{
+		.name = "filter_high_pass_3db_frequency",
+		.show = get_adxrs290_iio_ch_hpf,
+		.store = set_adxrs290_iio_ch_hpf
+	},
+	{
+		.name = "filter_low_pass_3db_frequency",
+		.show = get_adxrs290_iio_ch_lpf,
+		.store = set_adxrs290_iio_ch_lpf
+	},
+	{
+		.name = "raw",
+		.show = get_adxrs290_iio_ch_raw,
+		.store = NULL
+	},
+	{
+		.name = "scale",
+		.show = get_adxrs290_iio_ch_scale,
+		.store = NULL
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+static struct iio_attribute adxrs290_iio_temp_attrs[] = {
+	{
+		.name = "raw",
+		.show = get_adxrs290_iio_ch_raw,
+		.store = NULL
+	},
+	{
+		.name = "scale",
+		.show = get_adxrs290_iio_ch_scale,
+		.store = NULL
+	},
+	END_ATTRIBUTES_ARRAY,
+};
+
+static struct scan_type adxrs290_iio_vel_scan_type = {
+	.sign = 's',
+	.realbits = 16,
+	.storagebits = 16,
+	.shift = 0,
+	.is_big_endian = false
+};
+
+static struct scan_type adxrs290_iio_temp_scan_type = {
+	.sign = 's',
+	.realbits = 12,
+	.storagebits = 16,
+	.shift = 0,
+	.is_big_endian = false
+};
+
+static struct iio_channel adxrs290_iio_channels[] = {
+	{
+		.ch_type = IIO_ANGL_VEL,
+		.modified=1,
+		.channel2=IIO_MOD_X,
+		.scan_index = 0,
+		.scan_type = &adxrs290_iio_vel_scan_type,
+		.attributes = adxrs290_iio_vel_attrs,
+		.ch_out = false,
+	},
+	{
+		.ch_type = IIO_ANGL_VEL,
+		.modified=1,
+		.channel2=IIO_MOD_Y,
+		.scan_index = 1,
+		.scan_type = &adxrs290_iio_vel_scan_type,
+		.attributes = adxrs290_iio_vel_attrs,
+		.ch_out = false,
+	},
+	{
+		.ch_type = IIO_TEMP,
+		.scan_index = 2,
+		.scan_type = &adxrs290_iio_temp_scan_type,
+		.attributes = adxrs290_iio_temp_attrs,
+		.ch_out = false,
+	}
+};
+
+/**
+ * @brief Read one sample of the active channels, in one SPI burst.
+ * @param dev - Instance of the iio_adxrs290.
+ * @param mask - Active channels.
+ * @param sample - Where to pack the active channels, 16 bits each.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_adxrs290_read_sample(void *dev, uint32_t mask,
+					void *sample)
+{
+	struct iio_adxrs290_desc *desc = dev;
+	int16_t data[ADXRS290_CHANNEL_COUNT];
+	int16_t *out = sample;
+	int32_t ret;
+	uint8_t i;
+
+	/* Data ready is cleared by reading the Y data, so always read it */
+	ret = adxrs290_get_burst_data(desc->dev, data,
+				      (mask & BIT(ADXRS290_CHANNEL_TEMP)) ?
+				      ADXRS290_CHANNEL_COUNT :
+				      ADXRS290_CHANNEL_Y + 1);
+	if (ret < 0)
+		return ret;
+
+	for (i = 0; i < ADXRS290_CHANNEL_COUNT; i++)
+		if (mask & BIT(i))
+			*out++ = data[i];
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Start the buffered capture of the active channels.
+ *
+ * Data ready is routed and a pending sample is cleared before the trigger
+ * interrupt is enabled, so the handler never races with these transfers.
+ * @param dev - Instance of the iio_adxrs290.
+ * @param mask - Mask of the active channels.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_adxrs290_prepare_transfer(void *dev, uint32_t mask)
+{
+	struct iio_adxrs290_desc *desc = dev;
+	int16_t data[ADXRS290_CHANNEL_COUNT];
+	uint32_t sample_bytes = 0;
+	int32_t ret;
+	uint8_t i;
+
+	for (i = 0; i < ADXRS290_CHANNEL_COUNT; i++)
+		if (mask & BIT(i))
+			sample_bytes += sizeof(int16_t);
+
+	if (desc->data_ready) {
+		ret = adxrs290_set_data_ready(desc->dev, true);
+		if (ret < 0)
+			goto error;
+
+		/* Clear a pending data ready, so the next one gives an edge */
+		ret = adxrs290_get_burst_data(desc->dev, data,
+					      ADXRS290_CHANNEL_Y + 1);
+		if (ret < 0)
+			goto error;
+	}
+
+	ret = iio_trig_buf_start(desc->trig_buf, mask, sample_bytes);
+	if (ret < 0)
+		goto error;
+
+	return SUCCESS;
+
+error:
+	if (desc->data_ready)
+		adxrs290_set_data_ready(desc->dev, false);
+
+	return ret;
+}
+
+/**
+ * @brief Stop the buffered capture.
+ *
+ * The trigger interrupt is disabled before data ready is turned off.
+ * @param dev - Instance of the iio_adxrs290.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_adxrs290_end_transfer(void *dev)
+{
+	struct iio_adxrs290_desc *desc = dev;
+	int32_t ret;
+
+	ret = iio_trig_buf_stop(desc->trig_buf);
+	if (ret < 0)
+		return ret;
+
+	if (desc->data_ready)
+		return adxrs290_set_data_ready(desc->dev, false);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read a block of captured samples.
+ * @param dev - Instance of the iio_adxrs290.
+ * @param buff - Buffer where to read samples.
+ * @param nb_samples - Number of samples.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_adxrs290_read_dev(void *dev, void *buff,
+				     uint32_t nb_samples)
+{
+	struct iio_adxrs290_desc *desc = dev;
+
+	if (!desc)
+		return FAILURE;
+
+	return iio_trig_buf_read(desc->trig_buf, buff, nb_samples);
+}
+
+/**
+ * @brief Read a device register.
+ * @param dev - Instance of the iio_adxrs290.
+ * @param reg - Register address.
+ * @param readval - Register value.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_adxrs290_reg_read(void *dev, uint32_t reg,
+				     uint32_t *readval)
+{
+	struct iio_adxrs290_desc *desc = dev;
+	uint8_t val;
+	int32_t ret;
+
+	if (desc->trig_buf->active)
+		return -EBUSY;
+
+	ret = adxrs290_reg_read(desc->dev, reg, &val);
+	if (ret < 0)
+		return ret;
+
+	*readval = val;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Write a device register.
+ * @param dev - Instance of the iio_adxrs290.
+ * @param reg - Register address.
+ * @param writeval - Register value.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_adxrs290_reg_write(void *dev, uint32_t reg,
+				      uint32_t writeval)
+{
+	struct iio_adxrs290_desc *desc = dev;
+
+	if (desc->trig_buf->active)
+		return -EBUSY;
+
+	return adxrs290_reg_write(desc->dev, reg, writeval);
+}
+
+/**
+ * @brief Get iio device descriptor.
+ * @param desc - Descriptor.
+ * @param dev_descriptor - iio device descriptor.
+ */
+void iio_adxrs290_get_dev_descriptor(struct iio_adxrs290_desc *desc,
+				     struct iio_device **dev_descriptor)
+{
+	*dev_descriptor = &desc->dev_descriptor;
+}
+
+/**
+ * @brief Init the iio interface of an adxrs290 device.
+ * @param desc - Descriptor.
+ * @param param - Configuration structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_adxrs290_init(struct iio_adxrs290_desc **desc,
+			  struct iio_adxrs290_init_param *param)
+{
+	struct iio_adxrs290_desc *iio_adxrs290;
+	int32_t ret;
+
+	if (!desc || !param || !param->dev)
+		return -EINVAL;
+
+	iio_adxrs290 = (struct iio_adxrs290_desc *)calloc(1,
+			sizeof(*iio_adxrs290));
+	if (!iio_adxrs290)
+		return -ENOMEM;
+
+	iio_adxrs290->dev = param->dev;
+	iio_adxrs290->data_ready = param->data_ready;
+
+	param->trig_buf_param.dev = iio_adxrs290;
+	param->trig_buf_param.read_sample = iio_adxrs290_read_sample;
+	param->trig_buf_param.max_sample_bytes =
+		ADXRS290_CHANNEL_COUNT * sizeof(int16_t);
+	ret = iio_trig_buf_init(&iio_adxrs290->trig_buf,
+				&param->trig_buf_param);
+	if (ret < 0) {
+		free(iio_adxrs290);
+		return ret;
+	}
+
+	iio_adxrs290->dev_descriptor.num_ch = NUM_CHANNELS;
+	iio_adxrs290->dev_descriptor.channels = adxrs290_iio_channels;
+	iio_adxrs290->dev_descriptor.attributes = NULL;
+	iio_adxrs290->dev_descriptor.debug_attributes = NULL;
+	iio_adxrs290->dev_descriptor.buffer_attributes = NULL;
+	iio_adxrs290->dev_descriptor.prepare_transfer =
+		iio_adxrs290_prepare_transfer;
+	iio_adxrs290->dev_descriptor.end_transfer = iio_adxrs290_end_transfer;
+	iio_adxrs290->dev_descriptor.read_dev = iio_adxrs290_read_dev;
+	iio_adxrs290->dev_descriptor.debug_reg_read = iio_adxrs290_reg_read;
+	iio_adxrs290->dev_descriptor.debug_reg_write = iio_adxrs290_reg_write;
+
+	*desc = iio_adxrs290;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Release resources, stopping the capture first.
+ * @param desc - Descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_adxrs290_remove(struct iio_adxrs290_desc *desc)
+{
+	int32_t ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (desc->trig_buf->active) {
+		ret = iio_adxrs290_end_transfer(desc);
+		if (ret < 0)
+			return ret;
+	}
+
+	ret = iio_trig_buf_remove(desc->trig_buf);
+	if (ret < 0)
+		return ret;
+
+	free(desc);
+
+	return SUCCESS;
+}
@@ -40,12 +40,43 @@
 #ifndef IIO_ADXRS290_H
 #define IIO_ADXRS290_H
 
+#include <stdbool.h>
 #include "iio_types.h"
+#include "iio_trig_buf.h"
+#include "adxrs290.h"
+
+/**
+ * @struct iio_adxrs290_init_param
+ * @brief iio_adxrs290 configuration.
+ */
+struct iio_adxrs290_init_param {
+	/** adxrs290 device, set up by adxrs290_init() */
+	struct adxrs290_dev *dev;
+	/**
+	 * Buffered capture settings. The dev, read_sample and max_sample_bytes
+	 * fields are filled in by iio_adxrs290_init().
+	 */
+	struct iio_trig_buf_init_param trig_buf_param;
+	/** Route data ready to the SYNC pin while capturing, set it when the
+	 * trigger is the SYNC pin interrupt */
+	bool data_ready;
+};
+
+/**
+ * @struct iio_adxrs290_desc
+ * @brief iio_adxrs290 descriptor.
+ */
+struct iio_adxrs290_desc {
+	/** adxrs290 device */
+	struct adxrs290_dev *dev;
+	/** Buffered capture */
+	struct iio_trig_buf *trig_buf;
+	/** Route data ready to the SYNC pin while capturing */
+	bool data_ready;
+	/** iio device descriptor */
+	struct iio_device dev_descriptor;
+};
 
-ssize_t get_adxrs290_iio_reg(void *device, char *buf, size_t len,
-			     const struct iio_ch_info *channel, intptr_t priv);
-ssize_t set_adxrs290_iio_reg(void *device, char *buf, size_t len,
-			     const struct iio_ch_info *channel, intptr_t priv);
 ssize_t get_adxrs290_iio_ch_raw(void *device, char *buf, size_t len,
 				const struct iio_ch_info *channel, intptr_t priv);
 ssize_t get_adxrs290_iio_ch_scale(void *device, char *buf, size_t len,
@@ -59,86 +90,13 @@ ssize_t set_adxrs290_iio_ch_lpf(void *device, char *buf, size_t len,
 ssize_t get_adxrs290_iio_ch_lpf(void *device, char *buf, size_t len,
 				const struct iio_ch_info *channel, intptr_t priv);
 
-
-static struct iio_attribute adxrs290_iio_vel_attrs[] = {
-	{
-		.name = "filter_high_pass_3db_frequency",
-		.show = get_adxrs290_iio_ch_hpf,
-		.store = set_adxrs290_iio_ch_hpf
-	},
-	{
-		.name = "filter_low_pass_3db_frequency",
-		.show = get_adxrs290_iio_ch_lpf,
-		.store = set_adxrs290_iio_ch_lpf
-	},
-	{
-		.name = "raw",
-		.show = get_adxrs290_iio_ch_raw,
-		.store = NULL
-	},
-	{
-		.name = "scale",
-		.show = get_adxrs290_iio_ch_scale,
-		.store = NULL
-	},
-	END_ATTRIBUTES_ARRAY
-};
-
-static struct iio_attribute adxrs290_iio_temp_attrs[] = {
-	{
-		.name = "raw",
-		.show = get_adxrs290_iio_ch_raw,
-		.store = NULL
-	},
-	{
-		.name = "scale",
-		.show = get_adxrs290_iio_ch_scale,
-		.store = NULL
-	},
-	END_ATTRIBUTES_ARRAY,
-};
-
-static struct iio_channel adxrs290_iio_channels[] = {
-	{
-		.ch_type = IIO_ANGL_VEL,
-		.modified=1,
-		.channel2=IIO_MOD_X,
-		.scan_index = 0,
-		.scan_type = NULL,
-		.attributes = adxrs290_iio_vel_attrs,
-		.ch_out = false,
-	},
-	{
-		.ch_type = IIO_ANGL_VEL,
-		.modified=1,
-		.channel2=IIO_MOD_Y,
-		.scan_index = 1,
-		.scan_type = NULL,
-		.attributes = adxrs290_iio_vel_attrs,
-		.ch_out = false,
-	},
-	{
-		.ch_type = IIO_TEMP,
-		.scan_index = 2,
-		.scan_type = NULL,
-		.attributes = adxrs290_iio_temp_attrs,
-		.ch_out = false,
-	}
-};
-
-//extern struct iio_device adxrs290_iio_descriptor ;
-struct iio_device adxrs290_iio_descriptor = {
-	.num_ch = 3,
-	.channels = adxrs290_iio_channels,
-	.attributes = NULL,
-	.debug_attributes = NULL,
-	.buffer_attributes = NULL,
-	.transfer_dev_to_mem = NULL,
-	.transfer_mem_to_dev = NULL,
-	.read_data = NULL,
-	.write_data = NULL,
-	.debug_reg_read = (int32_t (*)())adxrs290_reg_read,
-	.debug_reg_write = (int32_t (*)())adxrs290_reg_write,
-};
+/* Init function. */
+int32_t iio_adxrs290_init(struct iio_adxrs290_desc **desc,
+			  struct iio_adxrs290_init_param *param);
+/* Get desciptor. */
+void iio_adxrs290_get_dev_descriptor(struct iio_adxrs290_desc *desc,
+				     struct iio_device **dev_descriptor);
+/* Free the resources allocated by iio_adxrs290_init(). */
+int32_t iio_adxrs290_remove(struct iio_adxrs290_desc *desc);
 
 #endif
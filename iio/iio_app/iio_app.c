@@ -138,6 +138,7 @@ int32_t iio_app_run(struct iio_app_device *devices, int32_t len)
 	wifi_param.uart_irq_conf = uart_desc;
 #endif //ADUCM_PLATFORM
 	wifi_param.uart_irq_id = UART_IRQ_ID;
+	wifi_param.buffered_send = true;
 
 	status = wifi_init(&wifi, &wifi_param);
 	if (status < 0)
@@ -0,0 +1,291 @@
+/***************************************************************************//**
+ *   @file   iio_trig_buf.c
+ *   @brief  Implementation of the iio triggered buffer.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include "iio_trig_buf.h"
+#include "deadline.h"
+#include "error.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Longest sleep between two ring buffer checks in iio_trig_buf_read() */
+#define IIO_TRIG_BUF_MAX_SLEEP_US	1000
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Init a triggered buffer. Nothing is captured until
+ * iio_trig_buf_start() is called.
+ * @param desc - Descriptor.
+ * @param param - Configuration structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_trig_buf_init(struct iio_trig_buf **desc,
+			  const struct iio_trig_buf_init_param *param)
+{
+	struct iio_trig_buf *trig_buf;
+
+	if (!desc || !param || !param->read_sample ||
+	    !param->max_sample_bytes || !param->buf_samples)
+		return -EINVAL;
+
+	trig_buf = (struct iio_trig_buf *)calloc(1, sizeof(*trig_buf));
+	if (!trig_buf)
+		return -ENOMEM;
+
+	trig_buf->sample = (uint8_t *)calloc(1, param->max_sample_bytes);
+	if (!trig_buf->sample) {
+		free(trig_buf);
+		return -ENOMEM;
+	}
+
+	trig_buf->dev = param->dev;
+	trig_buf->read_sample = param->read_sample;
+	trig_buf->max_sample_bytes = param->max_sample_bytes;
+	trig_buf->buf_samples = param->buf_samples;
+	trig_buf->timeout_us = param->timeout_us;
+	trig_buf->irq_ctrl = param->irq_ctrl;
+	trig_buf->irq_id = param->irq_id;
+	trig_buf->irq_config = param->irq_config;
+
+	*desc = trig_buf;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Release resources, stopping the capture first.
+ * @param desc - Descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_trig_buf_remove(struct iio_trig_buf *desc)
+{
+	int32_t ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (desc->active) {
+		ret = iio_trig_buf_stop(desc);
+		if (ret < 0)
+			return ret;
+	}
+
+	free(desc->sample);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Start capturing one sample on every trigger.
+ * @param desc - Descriptor.
+ * @param mask - Active channels.
+ * @param sample_bytes - Size in bytes of a sample with the active channels.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_trig_buf_start(struct iio_trig_buf *desc, uint32_t mask,
+			   uint32_t sample_bytes)
+{
+	struct callback_desc cb;
+	int32_t ret;
+
+	if (!desc || desc->active || !mask || !sample_bytes ||
+	    sample_bytes > desc->max_sample_bytes)
+		return -EINVAL;
+
+	ret = cb_init(&desc->cb, desc->buf_samples * sample_bytes);
+	if (ret < 0)
+		return ret;
+
+	desc->mask = mask;
+	desc->sample_bytes = sample_bytes;
+	desc->overruns = 0;
+	desc->read_errors = 0;
+	desc->active = true;
+
+	if (desc->irq_ctrl) {
+		cb.callback = iio_trig_buf_handler;
+		cb.ctx = desc;
+		cb.config = desc->irq_config;
+		ret = irq_register_callback(desc->irq_ctrl, desc->irq_id, &cb);
+		if (ret < 0)
+			goto error_cb;
+
+		ret = irq_enable(desc->irq_ctrl, desc->irq_id);
+		if (ret < 0) {
+			irq_unregister(desc->irq_ctrl, desc->irq_id);
+			goto error_cb;
+		}
+	}
+
+	return SUCCESS;
+
+error_cb:
+	desc->active = false;
+	cb_remove(desc->cb);
+	desc->cb = NULL;
+
+	return ret;
+}
+
+/**
+ * @brief Stop capturing and drop the samples not read yet.
+ * @param desc - Descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_trig_buf_stop(struct iio_trig_buf *desc)
+{
+	int32_t ret;
+
+	if (!desc || !desc->active)
+		return -EINVAL;
+
+	if (desc->irq_ctrl) {
+		ret = irq_disable(desc->irq_ctrl, desc->irq_id);
+		if (ret < 0)
+			return ret;
+
+		ret = irq_unregister(desc->irq_ctrl, desc->irq_id);
+		if (ret < 0)
+			return ret;
+	}
+
+	desc->active = false;
+	cb_remove(desc->cb);
+	desc->cb = NULL;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Trigger handler. Reads one sample of the active channels and
+ * appends it to the ring buffer. When the buffer is full the oldest samples
+ * are overwritten.
+ * @param ctx - Descriptor.
+ * @param event - Unused.
+ * @param extra - Unused.
+ */
+void iio_trig_buf_handler(void *ctx, uint32_t event, void *extra)
+{
+	struct iio_trig_buf *desc = ctx;
+	uint32_t size;
+
+	if (!desc || !desc->active)
+		return;
+
+	if (desc->read_sample(desc->dev, desc->mask, desc->sample) < 0) {
+		desc->read_errors++;
+		return;
+	}
+
+	cb_write(desc->cb, desc->sample, desc->sample_bytes);
+	if (cb_size(desc->cb, &size) == -EOVERRUN)
+		desc->overruns++;
+}
+
+/**
+ * @brief Check if at least one sample is waiting in the ring buffer.
+ * @param ctx - Descriptor.
+ * @return 1 if a sample is available, 0 if not or negative error code.
+ */
+static int32_t iio_trig_buf_available(void *ctx)
+{
+	struct iio_trig_buf *desc = ctx;
+	uint32_t size;
+	int32_t ret;
+
+	ret = cb_size(desc->cb, &size);
+	if (ret < 0 && ret != -EOVERRUN)
+		return ret;
+
+	return size >= desc->sample_bytes;
+}
+
+/**
+ * @brief Read a block of samples from the ring buffer, in bulk.
+ * The samples already captured are copied at once, then the function waits
+ * for the rest, at most timeout_us between two samples.
+ * @param desc - Descriptor.
+ * @param buff - Destination, nb_samples * sample_bytes bytes.
+ * @param nb_samples - Number of samples.
+ * @return SUCCESS in case of success, -ETIMEDOUT if the trigger stopped or
+ * other negative error code.
+ */
+int32_t iio_trig_buf_read(struct iio_trig_buf *desc, void *buff,
+			  uint32_t nb_samples)
+{
+	uint8_t *dst = buff;
+	uint32_t size, count;
+	int32_t ret;
+
+	if (!desc || !buff || !desc->active)
+		return -EINVAL;
+
+	while (nb_samples) {
+		ret = poll_until(iio_trig_buf_available, desc, desc->timeout_us,
+				 IIO_TRIG_BUF_MAX_SLEEP_US);
+		if (ret < 0)
+			return ret;
+
+		ret = cb_size(desc->cb, &size);
+		if (ret < 0 && ret != -EOVERRUN)
+			return ret;
+
+		count = size / desc->sample_bytes;
+		if (count > nb_samples)
+			count = nb_samples;
+
+		ret = cb_read(desc->cb, dst, count * desc->sample_bytes);
+		if (ret < 0 && ret != -EOVERRUN)
+			return ret;
+
+		dst += count * desc->sample_bytes;
+		nb_samples -= count;
+	}
+
+	return SUCCESS;
+}
@@ -0,0 +1,140 @@
+/***************************************************************************//**
+ *   @file   iio_trig_buf.h
+ *   @brief  Header file of the iio triggered buffer.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef IIO_TRIG_BUF_H_
+#define IIO_TRIG_BUF_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "circular_buffer.h"
+#include "irq.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct iio_trig_buf_init_param
+ * @brief iio_trig_buf configuration.
+ */
+struct iio_trig_buf_init_param {
+	/** Sensor instance, passed to read_sample() */
+	void *dev;
+	/**
+	 * Read one sample of the channels set in mask, in a single bus
+	 * transaction if possible. The channels are packed in scan index order.
+	 * Called from the trigger, usually in interrupt context.
+	 */
+	int32_t (*read_sample)(void *dev, uint32_t mask, void *sample);
+	/** Size in bytes of a sample with all the channels enabled */
+	uint32_t max_sample_bytes;
+	/** Capacity of the ring buffer, in samples */
+	uint32_t buf_samples;
+	/** Longest wait for the next sample in iio_trig_buf_read(), in us */
+	uint32_t timeout_us;
+	/**
+	 * Trigger interrupt, a data ready GPIO or a timer. When irq_ctrl is
+	 * NULL the application calls iio_trig_buf_handler() itself.
+	 */
+	struct irq_ctrl_desc *irq_ctrl;
+	/** Trigger interrupt ID */
+	uint32_t irq_id;
+	/** Platform specific configuration of the trigger interrupt */
+	void *irq_config;
+};
+
+/**
+ * @struct iio_trig_buf
+ * @brief iio_trig_buf descriptor.
+ */
+struct iio_trig_buf {
+	/** Sensor instance */
+	void *dev;
+	/** Sample read callback */
+	int32_t (*read_sample)(void *dev, uint32_t mask, void *sample);
+	/** Capacity of the ring buffer, in samples */
+	uint32_t buf_samples;
+	/** Longest wait for the next sample, in us */
+	uint32_t timeout_us;
+	/** Trigger interrupt */
+	struct irq_ctrl_desc *irq_ctrl;
+	uint32_t irq_id;
+	void *irq_config;
+	/** Scratch sample filled by the trigger */
+	uint8_t *sample;
+	/** Size in bytes of the scratch sample */
+	uint32_t max_sample_bytes;
+	/** Active channels */
+	uint32_t mask;
+	/** Size in bytes of a sample with the active channels */
+	uint32_t sample_bytes;
+	/** Samples waiting to be read by the iio server */
+	struct circular_buffer *cb;
+	/** Set while capturing */
+	volatile bool active;
+	/** Samples lost because the ring buffer was full */
+	uint32_t overruns;
+	/** Samples lost because read_sample() failed */
+	uint32_t read_errors;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Init function. */
+int32_t iio_trig_buf_init(struct iio_trig_buf **desc,
+			  const struct iio_trig_buf_init_param *param);
+/* Free the resources allocated by iio_trig_buf_init(). */
+int32_t iio_trig_buf_remove(struct iio_trig_buf *desc);
+/* Start capturing the channels in mask on every trigger. */
+int32_t iio_trig_buf_start(struct iio_trig_buf *desc, uint32_t mask,
+			   uint32_t sample_bytes);
+/* Stop capturing. */
+int32_t iio_trig_buf_stop(struct iio_trig_buf *desc);
+/* Trigger handler, reads one sample into the ring buffer. */
+void iio_trig_buf_handler(void *ctx, uint32_t event, void *extra);
+/* Read a block of samples from the ring buffer. */
+int32_t iio_trig_buf_read(struct iio_trig_buf *desc, void *buff,
+			  uint32_t nb_samples);
+
+#endif /* IIO_TRIG_BUF_H_ */
@@ -43,10 +43,13 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 
 /******************************************************************************/
 /************************* Structure Declarations *****************************/
 /******************************************************************************/
+struct clk;
+
 struct clk_hw {
 	void	*dev;
 	int32_t (*dev_clk_enable)();
@@ -56,10 +59,26 @@ struct clk_hw {
 	int32_t (*dev_clk_round_rate)();
 };
 
+/* Called after the rate of a clock, or of one of its ancestors, changed. */
+struct clk_notifier {
+	int32_t (*notify)(struct clk *clk, uint64_t old_rate, uint64_t new_rate,
+			  void *ctx);
+	void			*ctx;
+	struct clk_notifier	*next;
+};
+
 struct clk {
 	struct clk_hw	*hw;
 	uint32_t	hw_ch_num;
 	const char	*name;
+	/* Clock tree, set up with clk_set_parent() */
+	struct clk	*parent;
+	struct clk	*children;
+	struct clk	*sibling;
+	struct clk_notifier	*notifiers;
+	/* Last rate read from the hardware */
+	uint64_t	rate;
+	bool		rate_valid;
 };
 
 /******************************************************************************/
@@ -85,4 +104,22 @@ int32_t clk_round_rate(struct clk *clk,
 int32_t clk_set_rate(struct clk *clk,
 		     uint64_t rate);
 
+/* Move the clock under a new parent. */
+int32_t clk_set_parent(struct clk *clk,
+		       struct clk *parent);
+
+/* Get the parent of the clock. */
+struct clk *clk_get_parent(struct clk *clk);
+
+/* Drop the cached rate of the clock and of all its descendants. */
+void clk_invalidate_rate(struct clk *clk);
+
+/* Register a rate change notifier. */
+int32_t clk_notifier_register(struct clk *clk,
+			      struct clk_notifier *nb);
+
+/* Unregister a rate change notifier. */
+int32_t clk_notifier_unregister(struct clk *clk,
+				struct clk_notifier *nb);
+
 #endif // CLK_H_
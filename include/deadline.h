@@ -0,0 +1,101 @@
+/***************************************************************************//**
+ *   @file   deadline.h
+ *   @brief  Header file of the deadline and polling helpers.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef DEADLINE_H_
+#define DEADLINE_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** First sleep between two polls done by poll_until(), in microseconds */
+#define POLL_MIN_SLEEP_US	1
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct deadline
+ * @brief Point in time, measured with get_time_us(), that a wait must not
+ * pass.
+ *
+ * The start time and the length are kept instead of the end time, so the
+ * elapsed time is an unsigned difference that stays correct when the
+ * microsecond clock wraps around. Timeouts up to 2^32 - 1 us are supported.
+ */
+struct deadline {
+	/** get_time_us() value when the deadline was set */
+	uint32_t start_us;
+	/** Length of the wait in microseconds */
+	uint32_t timeout_us;
+};
+
+/**
+ * @brief Condition checked by poll_until().
+ * @param ctx - Context passed to poll_until().
+ * @return Positive value when the condition holds, 0 if it does not hold yet
+ * or a negative error code to stop polling.
+ */
+typedef int32_t (*poll_cond_t)(void *ctx);
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Start a deadline timeout_us microseconds from now. */
+void deadline_set(struct deadline *dl, uint32_t timeout_us);
+
+/* Check if a deadline has passed. */
+bool deadline_expired(struct deadline *dl);
+
+/* Get the number of microseconds left until a deadline. */
+uint32_t deadline_remaining_us(struct deadline *dl);
+
+/* Poll a condition until it holds, backing off between the polls. */
+int32_t poll_until(poll_cond_t cond, void *ctx, uint32_t timeout_us,
+		   uint32_t max_sleep_us);
+
+#endif // DEADLINE_H_
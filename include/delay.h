@@ -56,4 +56,7 @@ void udelay(uint32_t usecs);
 /* Generate miliseconds delay. */
 void mdelay(uint32_t msecs);
 
+/* Get the time of a free running microsecond clock. */
+uint32_t get_time_us(void);
+
 #endif // DELAY_H_
@@ -46,6 +46,13 @@
 
 #include <stdint.h>
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* i2c_xfer_msg flags */
+#define I2C_XFER_READ		(1 << 0)
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -87,6 +94,20 @@ typedef struct i2c_desc {
 	void		*extra;
 } i2c_desc;
 
+/**
+ * @struct i2c_xfer_msg
+ * @brief One message of a combined I2C transaction. Consecutive messages are
+ * separated by a repeated start, the last one ends with a stop condition.
+ */
+struct i2c_xfer_msg {
+	/** Data to write or buffer receiving the data read */
+	uint8_t		*buf;
+	/** Number of bytes */
+	uint8_t		len;
+	/** Message flags, I2C_XFER_READ for a read */
+	uint8_t		flags;
+};
+
 /**
  * @struct i2c_platform_ops
  * @brief Structure holding i2c function pointers that point to the platform
@@ -99,6 +120,12 @@ struct i2c_platform_ops {
 	int32_t (*i2c_ops_write)(struct i2c_desc *, uint8_t *, uint8_t, uint8_t);
 	/** i2c write function pointer */
 	int32_t (*i2c_ops_read)(struct i2c_desc *, uint8_t *, uint8_t, uint8_t);
+	/** i2c write then read with repeated start function pointer, optional */
+	int32_t (*i2c_ops_write_read)(struct i2c_desc *, uint8_t *, uint8_t,
+				      uint8_t *, uint8_t);
+	/** i2c combined transaction function pointer, optional */
+	int32_t (*i2c_ops_transfer)(struct i2c_desc *, struct i2c_xfer_msg *,
+				    uint32_t);
 	/** i2c remove function pointer */
 	int32_t (*i2c_ops_remove)(struct i2c_desc *);
 };
@@ -126,4 +153,16 @@ int32_t i2c_read(struct i2c_desc *desc,
 		 uint8_t bytes_number,
 		 uint8_t stop_bit);
 
+/* Write data to a slave device, then read from it after a repeated start. */
+int32_t i2c_write_read(struct i2c_desc *desc,
+		       uint8_t *tx_data,
+		       uint8_t tx_bytes,
+		       uint8_t *rx_data,
+		       uint8_t rx_bytes);
+
+/* Execute a combined transaction made of several messages. */
+int32_t i2c_transfer(struct i2c_desc *desc,
+		     struct i2c_xfer_msg *msgs,
+		     uint32_t msgs_no);
+
 #endif // I2C_H_
@@ -0,0 +1,166 @@
+/***************************************************************************//**
+ *   @file   trace.h
+ *   @brief  Hot-path tracing into a binary ring buffer.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Number of records kept in the trace ring. Must be a power of 2. */
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE		1024
+#endif
+
+/* Trace dump header magic ("NOTR" in little endian). */
+#define TRACE_DUMP_MAGIC	0x52544f4e
+#define TRACE_DUMP_VERSION	1
+
+/*
+ * Trace points are compiled in only when TRACE_ENABLE is defined, otherwise
+ * they expand to empty statements and their arguments are not evaluated.
+ */
+#ifdef TRACE_ENABLE
+#define TRACE_BEGIN(id)		trace_record((id), TRACE_TYPE_BEGIN, 0)
+#define TRACE_END(id)		trace_record((id), TRACE_TYPE_END, 0)
+#define TRACE_EVENT(id, arg)	trace_record((id), TRACE_TYPE_EVENT, (arg))
+#else
+#define TRACE_BEGIN(id)		do {} while (0)
+#define TRACE_END(id)		do {} while (0)
+#define TRACE_EVENT(id, arg)	do {} while (0)
+#endif
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum trace_id
+ * @brief Trace point identifiers. Application specific trace points start
+ * at TRACE_ID_USER.
+ */
+enum trace_id {
+	TRACE_ID_SPI_WRITE_AND_READ,
+	TRACE_ID_AXI_IO_READ,
+	TRACE_ID_AXI_IO_WRITE,
+	TRACE_ID_AXI_DMAC_TRANSFER,
+	TRACE_ID_IIO_STEP,
+	TRACE_ID_FW_LOAD,
+	TRACE_ID_TLS_HANDSHAKE,
+	TRACE_ID_USER = 0x100
+};
+
+/**
+ * @enum trace_type
+ * @brief Trace record types.
+ */
+enum trace_type {
+	/** Start of a duration */
+	TRACE_TYPE_BEGIN,
+	/** End of a duration */
+	TRACE_TYPE_END,
+	/** Instant event carrying an argument */
+	TRACE_TYPE_EVENT
+};
+
+/**
+ * @struct trace_rec
+ * @brief Trace record, as stored in the ring and in a trace dump.
+ */
+struct trace_rec {
+	/** Timestamp in trace clock ticks */
+	uint64_t ts;
+	/** Event argument */
+	uint32_t arg;
+	/** Sequence number, written last to mark the record as complete */
+	uint32_t seq;
+	/** Trace point identifier */
+	uint16_t id;
+	/** Record type */
+	uint8_t type;
+	uint8_t reserved[5];
+};
+
+/**
+ * @struct trace_dump_header
+ * @brief Header preceding the records in a trace dump.
+ */
+struct trace_dump_header {
+	/** TRACE_DUMP_MAGIC */
+	uint32_t magic;
+	/** TRACE_DUMP_VERSION */
+	uint16_t version;
+	/** Size of a record in bytes */
+	uint16_t rec_size;
+	/** Trace clock frequency in Hz */
+	uint32_t clock_hz;
+	/** Number of records following the header */
+	uint32_t count;
+	/** Number of records lost because the ring wrapped */
+	uint32_t lost;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize the trace clock and clear the trace ring. */
+int32_t trace_init(void);
+/* Add a record to the trace ring. */
+void trace_record(uint16_t id, uint8_t type, uint32_t arg);
+/* Discard all the records in the trace ring. */
+void trace_reset(void);
+/* Write the content of the trace ring through a caller supplied callback. */
+int32_t trace_dump(int32_t (*write)(void *ctx, const uint8_t *buff,
+				    uint32_t len), void *ctx);
+
+/* Platform specific: start the monotonic trace clock. */
+int32_t trace_clock_init(void);
+/* Platform specific: read the monotonic trace clock. */
+uint64_t trace_clock_get(void);
+/* Platform specific: get the trace clock frequency in Hz. */
+uint32_t trace_clock_hz(void);
+
+#endif // TRACE_H_
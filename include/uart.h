@@ -140,11 +140,22 @@ int32_t uart_read(struct uart_desc *desc, uint8_t *data, uint32_t bytes_number);
 int32_t uart_write(struct uart_desc *desc, const uint8_t *data,
 		   uint32_t bytes_number);
 
-/* Read data from UART. Non blocking function */
+/*
+ * Read data from UART. Non blocking function.
+ * The semantics depend on the platform:
+ * - Xilinx copies what the RX ring already holds and returns the number of
+ *   bytes read, possibly 0.
+ * - ADuCM3029 submits the buffer and returns SUCCESS; desc->callback gets
+ *   READ_DONE once bytes_number bytes were received.
+ */
 int32_t uart_read_nonblocking(struct uart_desc *desc, uint8_t *data,
 			      uint32_t bytes_number);
 
-/* Write data to UART. Non blocking function*/
+/*
+ * Write data to UART. Non blocking function.
+ * Xilinx returns the number of bytes queued, ADuCM3029 returns SUCCESS and
+ * signals WRITE_DONE through desc->callback.
+ */
 int32_t uart_write_nonblocking(struct uart_desc *desc, const uint8_t *data,
 			       uint32_t bytes_number);
 
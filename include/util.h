@@ -123,6 +123,9 @@ int32_t log_base_2(uint32_t x);
 /* Find greatest common divisor of the given two numbers. */
 uint32_t greatest_common_divisor(uint32_t a,
 				 uint32_t b);
+/* Find lowest common multiple of the given two numbers. */
+uint64_t lowest_common_multiple(uint32_t a,
+				uint32_t b);
 /* Calculate best rational approximation for a given fraction. */
 void rational_best_approximation(uint32_t given_numerator,
 				 uint32_t given_denominator,
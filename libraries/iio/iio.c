@@ -52,6 +52,7 @@
 #include "list.h"
 #include "delay.h"
 #include "error.h"
+#include "trace.h"
 #include "uart.h"
 #include <inttypes.h>
 
@@ -974,20 +975,26 @@ static ssize_t iio_get_xml(char **outxml)
  */
 ssize_t iio_step(struct iio_desc *desc)
 {
-#ifdef ENABLE_IIO_NETWORK
-	int32_t ret;
+	ssize_t ret;
 
+	TRACE_BEGIN(TRACE_ID_IIO_STEP);
+#ifdef ENABLE_IIO_NETWORK
 	if (desc->phy_type == USE_NETWORK) {
 		if (desc->current_sock != NULL &&
 		    (int32_t)desc->current_sock != -1) {
 			ret = _push_sock(desc, desc->current_sock);
-			if (IS_ERR_VALUE(ret))
+			if (IS_ERR_VALUE(ret)) {
+				TRACE_END(TRACE_ID_IIO_STEP);
 				return ret;
+			}
 		}
 		desc->current_sock = NULL;
 	}
 #endif
-	return tinyiiod_read_command(desc->iiod);
+	ret = tinyiiod_read_command(desc->iiod);
+	TRACE_END(TRACE_ID_IIO_STEP);
+
+	return ret;
 }
 
 /*
@@ -42,18 +42,59 @@
 /******************************************************************************/
 
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include "mqtt_client.h"
 #include "MQTTClient.h"
 #include "error.h"
+#include "util.h"
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+/**
+ * @enum mqtt_tap_state
+ * @brief Position of \ref mqtt_rx_tap in the incoming packet stream
+ */
+enum mqtt_tap_state {
+	/** Waiting for the fixed header byte */
+	MQTT_TAP_HEADER,
+	/** Decoding the remaining length */
+	MQTT_TAP_LENGTH,
+	/** Skipping over the variable header and payload */
+	MQTT_TAP_BODY
+};
+
+/**
+ * @struct mqtt_rx_tap
+ * @brief Follows the packets read by the paho client to catch the PUBACKs of
+ * the messages sent with \ref mqtt_publish_async.
+ */
+struct mqtt_rx_tap {
+	enum mqtt_tap_state	state;
+	/** Control packet type */
+	uint8_t			type;
+	/** Bytes left until the end of the packet */
+	uint32_t		remaining;
+	/** Multiplier of the next remaining length byte */
+	uint32_t		multiplier;
+	/** Packet identifier, only decoded for PUBACK */
+	uint16_t		packet_id;
+	/** Number of body bytes already processed */
+	uint32_t		idx;
+};
+
 struct mqtt_desc {
 	MQTTClient		mqtt_client[1];
 	Network			network;
+	struct mqtt_rx_tap	tap;
+	/** Packet identifiers of the QoS1 messages waiting for a PUBACK */
+	uint16_t		inflight_ids[MQTT_MAX_INFLIGHT];
+	/** Number of valid entries in inflight_ids */
+	uint32_t		nb_inflight;
+	/** Maximum number of entries used in inflight_ids */
+	uint32_t		inflight_window;
 };
 
 /******************************************************************************/
@@ -91,6 +132,93 @@ static void mqtt_default_message_handler(MessageData *msg)
 	free(data.topic);
 }
 
+/* Remove an acknowledged message from the in-flight list */
+static void mqtt_inflight_ack(struct mqtt_desc *desc, uint16_t packet_id)
+{
+	uint32_t i;
+
+	for (i = 0; i < desc->nb_inflight; i++)
+		if (desc->inflight_ids[i] == packet_id) {
+			desc->nb_inflight--;
+			desc->inflight_ids[i] =
+				desc->inflight_ids[desc->nb_inflight];
+			break;
+		}
+}
+
+/* Follow the packet boundaries of the bytes read by the paho client */
+static void mqtt_tap_update(struct mqtt_desc *desc, const uint8_t *buff,
+			    uint32_t len)
+{
+	struct mqtt_rx_tap	*tap = &desc->tap;
+	uint32_t		i;
+	uint32_t		skip;
+
+	i = 0;
+	while (i < len) {
+		switch (tap->state) {
+		case MQTT_TAP_HEADER:
+			tap->type = buff[i++] >> 4;
+			tap->remaining = 0;
+			tap->multiplier = 1;
+			tap->state = MQTT_TAP_LENGTH;
+			break;
+		case MQTT_TAP_LENGTH:
+			tap->remaining += (buff[i] & 0x7F) * tap->multiplier;
+			tap->multiplier <<= 7;
+			if (buff[i++] & 0x80)
+				break;
+			tap->idx = 0;
+			tap->packet_id = 0;
+			tap->state = tap->remaining ? MQTT_TAP_BODY :
+				     MQTT_TAP_HEADER;
+			break;
+		case MQTT_TAP_BODY:
+			if (tap->type == PUBACK && tap->idx < 2) {
+				tap->packet_id = (tap->packet_id << 8) |
+						 buff[i];
+				skip = 1;
+			} else {
+				skip = min(tap->remaining, len - i);
+			}
+			i += skip;
+			tap->idx += skip;
+			tap->remaining -= skip;
+			if (tap->remaining)
+				break;
+			if (tap->type == PUBACK)
+				mqtt_inflight_ack(desc, tap->packet_id);
+			tap->state = MQTT_TAP_HEADER;
+			break;
+		}
+	}
+}
+
+/* Read function given to the paho client. Wraps mqtt_noos_read. */
+static int mqtt_client_read(Network* net, unsigned char* buff, int len,
+			    int timeout)
+{
+	struct mqtt_desc	*desc;
+	int			ret;
+
+	desc = (struct mqtt_desc *)((char *)net -
+				    offsetof(struct mqtt_desc, network));
+
+	/*
+	 * The rest of a packet that already started is on its way. Don't let
+	 * a short timeout from the caller split the packet.
+	 */
+	if (desc->tap.state != MQTT_TAP_HEADER)
+		timeout = max((unsigned int)timeout,
+			      desc->mqtt_client->command_timeout_ms);
+
+	ret = mqtt_noos_read(net, buff, len, timeout);
+	if (ret > 0)
+		mqtt_tap_update(desc, buff, ret);
+
+	return ret;
+}
+
 /**
  * @brief Initialize the MQTT client
  * @param desc - Address where to store the MQTT client reference
@@ -119,11 +247,16 @@ int32_t mqtt_init(struct mqtt_desc **desc,
 	}
 
 	ldesc->network.sock = param->sock;
-	ldesc->network.mqttread = mqtt_noos_read;
+	ldesc->network.mqttread = mqtt_client_read;
 	ldesc->network.mqttwrite = mqtt_noos_write;
 
 	app_handler = param->message_handler;
 
+	ldesc->inflight_window = param->inflight_window;
+	if (!ldesc->inflight_window ||
+	    ldesc->inflight_window > MQTT_MAX_INFLIGHT)
+		ldesc->inflight_window = MQTT_MAX_INFLIGHT;
+
 	MQTTClientInit(ldesc->mqtt_client, &ldesc->network,
 		       (unsigned int)param->command_timeout_ms,
 		       (unsigned char *)param->send_buff,
@@ -181,6 +314,10 @@ int32_t mqtt_connect(struct mqtt_desc *desc,
 	data.password.cstring = (char *)conf->password;
 	data.keepAliveInterval = (unsigned short)conf->keep_alive_ms;
 
+	/* A new session starts from a packet boundary, without pending acks */
+	desc->tap.state = MQTT_TAP_HEADER;
+	desc->nb_inflight = 0;
+
 	ret = MQTTConnectWithResults(desc->mqtt_client, &data, &res);
 	if (result_optional) {
 		result_optional->rc = res.rc;
@@ -207,19 +344,35 @@ int32_t mqtt_disconnect(struct mqtt_desc *desc)
 
 /**
  * @brief Send publish to MQTT broker
+ *
+ * QoS1 and QoS2 messages wait for the acknowledge of the broker. The client
+ * can't tell it apart from the PUBACK of a message sent with
+ * \ref mqtt_publish_async, so the messages still in flight are acknowledged
+ * first.
  * @param desc - Reference to MQTT client
  * @param topic - Topic pattern which can include wildcards
  * @param msg - Message to send
  * @return
  *  - \ref SUCCESS : On success
+ *  - -ETIMEDOUT : If the messages in flight are not acknowledged in the
+ *  command timeout
  *  - \ref FAILURE : Otherwise
  */
 int32_t mqtt_publish(struct mqtt_desc *desc, const int8_t* topic,
 		     const struct mqtt_message* msg)
 {
+	int32_t ret;
+
 	if (!desc || !msg)
 		return FAILURE;
 
+	if (msg->qos != MQTT_QOS0) {
+		ret = mqtt_wait_inflight(desc, 0,
+					 desc->mqtt_client->command_timeout_ms);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
 	MQTTMessage message = { 0 };
 
 	message.payload = (void *)msg->payload;
@@ -230,6 +383,141 @@ int32_t mqtt_publish(struct mqtt_desc *desc, const int8_t* topic,
 	return MQTTPublish(desc->mqtt_client, (char *)topic, &message);
 }
 
+/**
+ * @brief Send publish to MQTT broker without waiting for the acknowledge
+ *
+ * QoS0 messages are done once written to the socket. QoS1 messages stay in
+ * flight until their PUBACK is read by one of the MQTT functions. If
+ * \ref mqtt_init_param.inflight_window messages are already in flight, the
+ * function first waits for one of them to be acknowledged.
+ * @param desc - Reference to MQTT client
+ * @param topic - Topic pattern which can include wildcards
+ * @param msg - Message to send. QoS2 is not supported.
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -ETIMEDOUT : If no slot was released in the command timeout
+ *  - \ref FAILURE : Otherwise
+ */
+int32_t mqtt_publish_async(struct mqtt_desc *desc, const int8_t* topic,
+			   const struct mqtt_message* msg)
+{
+	MQTTClient	*c;
+	MQTTString	topic_str = MQTTString_initializer;
+	Timer		timer;
+	uint16_t	id;
+	int32_t		len;
+	int32_t		sent;
+	int32_t		ret;
+
+	if (!desc || !topic || !msg || msg->qos == MQTT_QOS2)
+		return FAILURE;
+
+	c = desc->mqtt_client;
+	if (!c->isconnected)
+		return FAILURE;
+
+	id = 0;
+	if (msg->qos == MQTT_QOS1) {
+		ret = mqtt_wait_inflight(desc, desc->inflight_window - 1,
+					 c->command_timeout_ms);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+		c->next_packetid = (c->next_packetid == MAX_PACKET_ID) ? 1 :
+				   c->next_packetid + 1;
+		id = c->next_packetid;
+	}
+
+	topic_str.cstring = (char *)topic;
+	len = MQTTSerialize_publish(c->buf, c->buf_size, 0, msg->qos,
+				    msg->retained, id, topic_str,
+				    msg->payload, msg->len);
+	if (len <= 0)
+		return FAILURE;
+
+	TimerInit(&timer);
+	TimerCountdownMS(&timer, c->command_timeout_ms);
+	sent = 0;
+	while (sent < len) {
+		ret = c->ipstack->mqttwrite(c->ipstack, &c->buf[sent],
+					    len - sent, TimerLeftMS(&timer));
+		if (IS_ERR_VALUE(ret))
+			return ret;
+		sent += ret;
+		if (sent < len && TimerIsExpired(&timer))
+			return -ETIMEDOUT;
+	}
+	TimerCountdown(&c->last_sent, c->keepAliveInterval);
+
+	if (msg->qos == MQTT_QOS1)
+		desc->inflight_ids[desc->nb_inflight++] = id;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the size of the send buffer, which bounds the size of a packet
+ * @param desc - Reference to MQTT client
+ * @return Size of the send buffer in bytes
+ */
+uint32_t mqtt_get_send_buff_size(struct mqtt_desc *desc)
+{
+	if (!desc)
+		return 0;
+
+	return (uint32_t)desc->mqtt_client->buf_size;
+}
+
+/**
+ * @brief Get the number of QoS1 messages waiting for a PUBACK
+ * @param desc - Reference to MQTT client
+ * @return Number of messages in flight
+ */
+uint32_t mqtt_get_inflight(struct mqtt_desc *desc)
+{
+	if (!desc)
+		return 0;
+
+	return desc->nb_inflight;
+}
+
+/**
+ * @brief Process incoming packets until at most max_inflight messages are
+ * waiting for a PUBACK
+ *
+ * Unlike \ref mqtt_yield, the function returns as soon as the condition is
+ * met. Incoming messages and keep alive are handled as in \ref mqtt_yield.
+ * @param desc - Reference to MQTT client
+ * @param max_inflight - Number of messages that may remain in flight. Use 0
+ * to wait for all the messages to be acknowledged.
+ * @param timeout_ms - Maximum time to wait
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -ETIMEDOUT : If the messages are not acknowledged in time
+ *  - \ref FAILURE : Otherwise
+ */
+int32_t mqtt_wait_inflight(struct mqtt_desc *desc, uint32_t max_inflight,
+			   uint32_t timeout_ms)
+{
+	Timer	timer;
+	int32_t	ret;
+
+	if (!desc)
+		return FAILURE;
+
+	TimerInit(&timer);
+	TimerCountdownMS(&timer, timeout_ms);
+	while (desc->nb_inflight > max_inflight) {
+		if (TimerIsExpired(&timer))
+			return -ETIMEDOUT;
+		/* Handle at most one packet, without waiting for more */
+		ret = MQTTYield(desc->mqtt_client, 0);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
 /**
  * @brief Send subscribe to MQTT broker
  * @param desc - Reference to MQTT client
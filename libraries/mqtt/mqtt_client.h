@@ -113,6 +113,14 @@
 #include <stdbool.h>
 #include "tcp_socket.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Maximum number of QoS1 messages sent with \ref mqtt_publish_async waiting
+ *  for a PUBACK */
+#define MQTT_MAX_INFLIGHT	8
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -232,6 +240,12 @@ struct mqtt_init_param {
 	 * @param Message received from the broker.
 	 */
 	void			(*message_handler)(struct mqtt_message_data *);
+	/**
+	 * Number of QoS1 messages published with \ref mqtt_publish_async that
+	 * may wait for a PUBACK at the same time. Between 1 and
+	 * \ref MQTT_MAX_INFLIGHT, 0 selects \ref MQTT_MAX_INFLIGHT.
+	 */
+	uint32_t		inflight_window;
 };
 
 /**
@@ -260,6 +274,16 @@ int32_t mqtt_disconnect(struct mqtt_desc *desc);
 /* Send publish to MQTT broker */
 int32_t mqtt_publish(struct mqtt_desc *desc, const int8_t* topic,
 		     const struct mqtt_message* msg);
+/* Send publish to MQTT broker without waiting for the acknowledge */
+int32_t mqtt_publish_async(struct mqtt_desc *desc, const int8_t* topic,
+			   const struct mqtt_message* msg);
+/* Get the size of the send buffer */
+uint32_t mqtt_get_send_buff_size(struct mqtt_desc *desc);
+/* Get the number of QoS1 messages waiting for a PUBACK */
+uint32_t mqtt_get_inflight(struct mqtt_desc *desc);
+/* Process incoming packets until at most max_inflight messages are pending */
+int32_t mqtt_wait_inflight(struct mqtt_desc *desc, uint32_t max_inflight,
+			   uint32_t timeout_ms);
 /* Send subscribe to MQTT broker */
 int32_t mqtt_subscribe(struct mqtt_desc *desc, const int8_t *topic,
 		       enum mqtt_qos qos, enum mqtt_qos *granted_qos_optional);
@@ -46,8 +46,6 @@
 #include "timer.h"
 #include "error.h"
 #include "util.h"
-#include "delay.h"
-#include "error.h"
 
 /******************************************************************************/
 /**************************** Global Variables ********************************/
@@ -147,33 +145,38 @@ char TimerIsExpired(Timer* t)
 	return false;
 }
 
-/* Implementation of mqtt_noos_read used by MQTTClient.c */
+/*
+ * Implementation of mqtt_noos_read used by MQTTClient.c
+ * The socket is polled until len bytes are received or the timeout expires,
+ * so the function returns as soon as the data is available. A timeout of 0
+ * polls the socket once.
+ */
 int mqtt_noos_read(Network* net, unsigned char* buff, int len, int timeout)
 {
-	uint32_t	sent;
+	Timer		t;
+	uint32_t	received;
 	int32_t		rc;
 
 	if (!len)
 		return 0;
 
-	sent = 0;
+	TimerCountdownMS(&t, timeout);
+	received = 0;
 	do {
- 		rc = socket_recv(net->sock, (void *)(buff + sent),
-				(uint32_t)(len - sent));
- 		if (rc != -EAGAIN) { //If data available or error
- 			if (IS_ERR_VALUE(rc))
- 				return rc;
-				 
- 			sent += rc;
- 			if (sent >= len)
- 				return sent;
- 		}
-
-		mdelay(1);
-	} while (--timeout);
-
-	/* 0 bytes have been read */
-	return 0;
+		rc = socket_recv(net->sock, (void *)(buff + received),
+				 (uint32_t)(len - received));
+		if (rc != -EAGAIN) { //If data available or error
+			if (IS_ERR_VALUE(rc))
+				return rc;
+
+			received += rc;
+			if (received >= (uint32_t)len)
+				return received;
+		}
+	} while (!TimerIsExpired(&t));
+
+	/* Number of bytes read before the timeout expired */
+	return received;
 }
 
 /* Implementation of mqtt_noos_write used by MQTTClient.c */
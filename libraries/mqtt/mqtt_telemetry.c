@@ -0,0 +1,378 @@
+/***************************************************************************//**
+ *   @file   mqtt_telemetry.c
+ *   @brief  Batched MQTT telemetry publisher
+********************************************************************************
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "mqtt_telemetry.h"
+#include "error.h"
+#include "util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Maximum size of a varint encoding a 32 bit value */
+#define VARINT_MAX_BYTES	5
+/* Maximum size of an encoded sample: channel, timestamp and value */
+#define SAMPLE_MAX_BYTES	(1 + 2 * VARINT_MAX_BYTES)
+/* Maximum size of the message header: format, count and timestamp */
+#define HEADER_MAX_BYTES	(1 + 2 * VARINT_MAX_BYTES)
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Write val as a base 128 varint. Return the number of bytes written. */
+static uint32_t varint_encode(uint8_t *buff, uint32_t val)
+{
+	uint32_t len = 0;
+
+	while (val >= 0x80) {
+		buff[len++] = (uint8_t)(val | 0x80);
+		val >>= 7;
+	}
+	buff[len++] = (uint8_t)val;
+
+	return len;
+}
+
+/* Map signed values to unsigned ones so small deltas give short varints */
+static inline uint32_t zigzag_encode(int32_t val)
+{
+	return ((uint32_t)val << 1) ^ (uint32_t)(val >> 31);
+}
+
+/* Number of bytes of the remaining length field of an MQTT packet */
+static uint32_t mqtt_remaining_length_bytes(uint32_t len)
+{
+	uint32_t nb = 1;
+
+	while (len >= 0x80) {
+		len >>= 7;
+		nb++;
+	}
+
+	return nb;
+}
+
+/* Size of the PUBLISH packet of a message with the given payload size */
+static uint32_t mqtt_telemetry_packet_size(const int8_t *topic,
+		enum mqtt_qos qos, uint32_t payload_len)
+{
+	uint32_t rem_len;
+
+	/* Topic length, topic, packet identifier and payload */
+	rem_len = 2 + strlen((const char *)topic) +
+		  (qos == MQTT_QOS0 ? 0 : 2) + payload_len;
+
+	return 1 + mqtt_remaining_length_bytes(rem_len) + rem_len;
+}
+
+/**
+ * @brief Initialize the telemetry publisher
+ *
+ * The largest possible message must fit in the send buffer of the MQTT
+ * client, \ref mqtt_init_param.send_buff_size.
+ * @param desc - Address where to store the publisher descriptor
+ * @param param - Initialization parameters
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - \ref FAILURE : Otherwise
+ */
+int32_t mqtt_telemetry_init(struct mqtt_telemetry_desc **desc,
+			    struct mqtt_telemetry_init_param *param)
+{
+	struct mqtt_telemetry_desc *ldesc;
+
+	if (!desc || !param || !param->mqtt || !param->topic ||
+	    param->qos == MQTT_QOS2 || !param->queue_size ||
+	    !param->samples_per_message ||
+	    param->samples_per_message > param->queue_size)
+		return FAILURE;
+
+	if (mqtt_telemetry_packet_size(param->topic, param->qos,
+				       HEADER_MAX_BYTES +
+				       param->samples_per_message *
+				       SAMPLE_MAX_BYTES) >
+	    mqtt_get_send_buff_size(param->mqtt))
+		return FAILURE;
+
+	ldesc = (struct mqtt_telemetry_desc *)calloc(1, sizeof(*ldesc));
+	if (!ldesc)
+		return FAILURE;
+
+	ldesc->queue = (struct mqtt_telemetry_sample *)calloc(param->queue_size,
+			sizeof(*ldesc->queue));
+	if (!ldesc->queue)
+		goto error_desc;
+
+	ldesc->payload = (uint8_t *)malloc(HEADER_MAX_BYTES +
+					   param->samples_per_message *
+					   SAMPLE_MAX_BYTES);
+	if (!ldesc->payload)
+		goto error_queue;
+
+	ldesc->mqtt = param->mqtt;
+	ldesc->topic = param->topic;
+	ldesc->qos = param->qos;
+	ldesc->queue_size = param->queue_size;
+	ldesc->samples_per_message = param->samples_per_message;
+
+	*desc = ldesc;
+
+	return SUCCESS;
+
+error_queue:
+	free(ldesc->queue);
+error_desc:
+	free(ldesc);
+
+	return FAILURE;
+}
+
+/**
+ * @brief Free the resources allocated by mqtt_telemetry_init()
+ *
+ * Samples still in the queue are discarded.
+ * @param desc - Publisher descriptor
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - \ref FAILURE : Otherwise
+ */
+int32_t mqtt_telemetry_remove(struct mqtt_telemetry_desc *desc)
+{
+	if (!desc)
+		return FAILURE;
+
+	free(desc->payload);
+	free(desc->queue);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Add a sample to the publish queue
+ *
+ * The function only stores the sample, it can be called from the acquisition
+ * loop without touching the network.
+ * @param desc - Publisher descriptor
+ * @param channel - Channel of the sample
+ * @param timestamp - Time of the sample
+ * @param value - Sample value
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -ENOBUFS : If the queue is full. The sample is dropped.
+ *  - \ref FAILURE : Otherwise
+ */
+int32_t mqtt_telemetry_push(struct mqtt_telemetry_desc *desc, uint8_t channel,
+			    uint32_t timestamp, int32_t value)
+{
+	struct mqtt_telemetry_sample	*sample;
+	uint32_t			idx;
+
+	if (!desc || channel >= MQTT_TELEMETRY_MAX_CHANNELS)
+		return FAILURE;
+
+	if (desc->queue_count == desc->queue_size) {
+		desc->stats.dropped++;
+		return -ENOBUFS;
+	}
+
+	idx = desc->queue_head + desc->queue_count;
+	if (idx >= desc->queue_size)
+		idx -= desc->queue_size;
+	sample = &desc->queue[idx];
+	sample->channel = channel;
+	sample->timestamp = timestamp;
+	sample->value = value;
+	desc->queue_count++;
+
+	return SUCCESS;
+}
+
+/* Encode nb_samples samples from the head of the queue in desc->payload */
+static uint32_t mqtt_telemetry_encode(struct mqtt_telemetry_desc *desc,
+				      uint32_t nb_samples)
+{
+	int32_t				prev_value[MQTT_TELEMETRY_MAX_CHANNELS];
+	struct mqtt_telemetry_sample	*sample;
+	uint32_t			prev_timestamp;
+	uint32_t			idx;
+	uint32_t			len;
+	uint32_t			i;
+
+	memset(prev_value, 0, sizeof(prev_value));
+	idx = desc->queue_head;
+	prev_timestamp = desc->queue[idx].timestamp;
+
+	len = 0;
+	desc->payload[len++] = MQTT_TELEMETRY_FORMAT;
+	len += varint_encode(&desc->payload[len], nb_samples);
+	len += varint_encode(&desc->payload[len], prev_timestamp);
+	for (i = 0; i < nb_samples; i++) {
+		sample = &desc->queue[idx];
+		desc->payload[len++] = sample->channel;
+		len += varint_encode(&desc->payload[len],
+				     zigzag_encode(sample->timestamp -
+						   prev_timestamp));
+		len += varint_encode(&desc->payload[len],
+				     zigzag_encode((int32_t)((uint32_t)sample->value -
+						   (uint32_t)prev_value[sample->channel])));
+		prev_timestamp = sample->timestamp;
+		prev_value[sample->channel] = sample->value;
+		if (++idx == desc->queue_size)
+			idx = 0;
+	}
+
+	return len;
+}
+
+/* Publish the nb_samples oldest samples in one message */
+static int32_t mqtt_telemetry_send(struct mqtt_telemetry_desc *desc,
+				   uint32_t nb_samples)
+{
+	struct mqtt_message	msg;
+	int32_t			ret;
+
+	msg.qos = desc->qos;
+	msg.retained = false;
+	msg.payload = desc->payload;
+	msg.len = mqtt_telemetry_encode(desc, nb_samples);
+
+	ret = mqtt_publish_async(desc->mqtt, desc->topic, &msg);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	desc->queue_head += nb_samples;
+	if (desc->queue_head >= desc->queue_size)
+		desc->queue_head -= desc->queue_size;
+	desc->queue_count -= nb_samples;
+
+	desc->stats.messages++;
+	desc->stats.samples += nb_samples;
+	desc->stats.payload_bytes += msg.len;
+	desc->stats.wire_bytes += mqtt_telemetry_packet_size(desc->topic,
+				  desc->qos, msg.len);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Publish the full batches and process the incoming packets
+ *
+ * Each group of \ref mqtt_telemetry_init_param.samples_per_message samples is
+ * sent as one message. The call doesn't wait for the broker: it only blocks if
+ * the in-flight window of the MQTT client is full. It must be called
+ * periodically, also to keep the MQTT connection alive.
+ * @param desc - Publisher descriptor
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - negative error code : Otherwise
+ */
+int32_t mqtt_telemetry_process(struct mqtt_telemetry_desc *desc)
+{
+	int32_t ret;
+
+	if (!desc)
+		return FAILURE;
+
+	while (desc->queue_count >= desc->samples_per_message) {
+		ret = mqtt_telemetry_send(desc, desc->samples_per_message);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	/* Collect the acknowledges that already arrived */
+	return mqtt_yield(desc->mqtt, 0);
+}
+
+/**
+ * @brief Publish all the queued samples and wait for them to be acknowledged
+ * @param desc - Publisher descriptor
+ * @param timeout_ms - Maximum time to wait for the acknowledges
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -ETIMEDOUT : If the messages are not acknowledged in time
+ *  - negative error code : Otherwise
+ */
+int32_t mqtt_telemetry_flush(struct mqtt_telemetry_desc *desc,
+			     uint32_t timeout_ms)
+{
+	uint32_t	nb_samples;
+	int32_t		ret;
+
+	if (!desc)
+		return FAILURE;
+
+	while (desc->queue_count) {
+		nb_samples = min(desc->queue_count, desc->samples_per_message);
+		ret = mqtt_telemetry_send(desc, nb_samples);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	return mqtt_wait_inflight(desc->mqtt, 0, timeout_ms);
+}
+
+/**
+ * @brief Get the publisher counters
+ *
+ * The average size of a sample on the wire is
+ * stats.wire_bytes / stats.samples.
+ * @param desc - Publisher descriptor
+ * @param stats - Address where to copy the counters
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - \ref FAILURE : Otherwise
+ */
+int32_t mqtt_telemetry_get_stats(struct mqtt_telemetry_desc *desc,
+				 struct mqtt_telemetry_stats *stats)
+{
+	if (!desc || !stats)
+		return FAILURE;
+
+	*stats = desc->stats;
+
+	return SUCCESS;
+}
@@ -0,0 +1,175 @@
+/***************************************************************************//**
+ *   @file   mqtt_telemetry.h
+ *   @brief  Batched MQTT telemetry publisher
+********************************************************************************
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+********************************************************************************
+ * @section mqtt_telemetry_details Payload format
+ *   Samples are coalesced in one MQTT message with the following encoding:
+ *   - 1 byte: \ref MQTT_TELEMETRY_FORMAT
+ *   - varint: number of samples
+ *   - varint: timestamp of the first sample
+ *   - for each sample:
+ *     - 1 byte: channel
+ *     - zigzag varint: timestamp minus the timestamp of the previous sample
+ *     - zigzag varint: value minus the previous value of the same channel.
+ *       The previous value of a channel is 0 at the start of each message.
+ *
+ *   Varints are little endian base 128, as in protobuf. Each message can be
+ *   decoded on its own.
+*******************************************************************************/
+
+#ifndef MQTT_TELEMETRY_H
+#define MQTT_TELEMETRY_H
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "mqtt_client.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Version of the payload encoding */
+#define MQTT_TELEMETRY_FORMAT		1
+/** Number of channels that can be published */
+#define MQTT_TELEMETRY_MAX_CHANNELS	16
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct mqtt_telemetry_sample
+ * @brief Sample waiting in the publish queue
+ */
+struct mqtt_telemetry_sample {
+	/** Time of the sample, in application defined units */
+	uint32_t	timestamp;
+	/** Sample value */
+	int32_t		value;
+	/** Channel of the sample. Less than \ref MQTT_TELEMETRY_MAX_CHANNELS */
+	uint8_t		channel;
+};
+
+/**
+ * @struct mqtt_telemetry_stats
+ * @brief Counters of the telemetry publisher
+ */
+struct mqtt_telemetry_stats {
+	/** Number of messages published */
+	uint32_t	messages;
+	/** Number of samples published */
+	uint32_t	samples;
+	/** Number of encoded payload bytes */
+	uint32_t	payload_bytes;
+	/** Number of bytes of the PUBLISH packets, including headers */
+	uint32_t	wire_bytes;
+	/** Number of samples dropped because the queue was full */
+	uint32_t	dropped;
+};
+
+/**
+ * @struct mqtt_telemetry_init_param
+ * @brief Parameters used to initialize a telemetry publisher
+ */
+struct mqtt_telemetry_init_param {
+	/** Connected MQTT client */
+	struct mqtt_desc	*mqtt;
+	/** Topic where the samples are published */
+	const int8_t		*topic;
+	/** QoS of the messages. QoS2 is not supported */
+	enum mqtt_qos		qos;
+	/** Number of samples the publish queue can hold */
+	uint32_t		queue_size;
+	/**
+	 * Number of samples coalesced in a message. The message must fit in
+	 * the send buffer of the MQTT client.
+	 */
+	uint32_t		samples_per_message;
+};
+
+/**
+ * @struct mqtt_telemetry_desc
+ * @brief Telemetry publisher descriptor
+ */
+struct mqtt_telemetry_desc {
+	/** Connected MQTT client */
+	struct mqtt_desc		*mqtt;
+	/** Topic where the samples are published */
+	const int8_t			*topic;
+	/** QoS of the messages */
+	enum mqtt_qos			qos;
+	/** Publish queue */
+	struct mqtt_telemetry_sample	*queue;
+	/** Number of samples the publish queue can hold */
+	uint32_t			queue_size;
+	/** Index of the oldest sample in the queue */
+	uint32_t			queue_head;
+	/** Number of samples in the queue */
+	uint32_t			queue_count;
+	/** Number of samples coalesced in a message */
+	uint32_t			samples_per_message;
+	/** Buffer where a message is encoded */
+	uint8_t				*payload;
+	/** Counters */
+	struct mqtt_telemetry_stats	stats;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize the telemetry publisher */
+int32_t mqtt_telemetry_init(struct mqtt_telemetry_desc **desc,
+			    struct mqtt_telemetry_init_param *param);
+/* Free the resources allocated by mqtt_telemetry_init() */
+int32_t mqtt_telemetry_remove(struct mqtt_telemetry_desc *desc);
+/* Add a sample to the publish queue */
+int32_t mqtt_telemetry_push(struct mqtt_telemetry_desc *desc, uint8_t channel,
+			    uint32_t timestamp, int32_t value);
+/* Publish the full batches and process the incoming packets */
+int32_t mqtt_telemetry_process(struct mqtt_telemetry_desc *desc);
+/* Publish all the queued samples and wait for them to be acknowledged */
+int32_t mqtt_telemetry_flush(struct mqtt_telemetry_desc *desc,
+			     uint32_t timeout_ms);
+/* Get the publisher counters */
+int32_t mqtt_telemetry_get_stats(struct mqtt_telemetry_desc *desc,
+				 struct mqtt_telemetry_stats *stats);
+
+#endif
@@ -92,6 +92,23 @@
  */
 #define MAX_CONTENT_LEN 2500
 
+/*
+ * Ask the server to send records no longer than MAX_CONTENT_LEN (rounded down
+ * to 512, 1024, 2048 or 4096 bytes). Without it the server may send records of
+ * up to 16kb, which don't fit in a reduced MAX_CONTENT_LEN buffer. It only
+ * takes effect if the server supports the max_fragment_length extension.
+ */
+#define ENABLE_MAX_FRAGMENT_LENGTH
+
+/*
+ * Resume the previous TLS session on reconnect using session tickets (RFC
+ * 5077). Resumption with session IDs is always attempted. A resumed handshake
+ * skips the certificate verification and the key exchange.
+ * Disabled by default: the ticket is kept in RAM for the whole connection and
+ * a session ID is enough for the servers this was tested with.
+ */
+//#define ENABLE_SESSION_TICKETS
+
 /*
  * ENABLE_MEMORY_OPTIMIZATIONS should be defined in the case memory
  * is not enough. This could happen is using both a secure connection with
@@ -130,6 +147,21 @@
 #define MBEDTLS_SSL_MAX_CONTENT_LEN	MAX_CONTENT_LEN
 #endif
 
+#ifdef ENABLE_MAX_FRAGMENT_LENGTH
+#define MBEDTLS_SSL_MAX_FRAGMENT_LENGTH
+#endif
+
+#ifdef ENABLE_SESSION_TICKETS
+#define MBEDTLS_SSL_SESSION_TICKETS
+#endif
+
+/*
+ * Keep only a digest of the peer certificate after the handshake instead of
+ * the whole parsed chain. The session saved for resumption holds the peer
+ * certificate, so keeping it would cost a few KB of RAM per socket.
+ */
+#undef MBEDTLS_SSL_KEEP_PEER_CERTIFICATE
+
 #ifdef ENABLE_TLS1_2
 
 #define MBEDTLS_SSL_PROTO_TLS1_2
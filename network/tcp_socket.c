@@ -43,8 +43,10 @@
 /******************************************************************************/
 
 #include <stdlib.h>
+#include <stdbool.h>
 #include "error.h"
 #include "tcp_socket.h"
+#include "trace.h"
 #include "util.h"
 
 #ifndef DISABLE_SECURE_SOCKET
@@ -71,6 +73,20 @@
 
 #endif /* DISABLE_SECURE_SOCKET */
 
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH) && \
+	MBEDTLS_SSL_MAX_CONTENT_LEN < 16384
+/* Largest max_fragment_length that fits in the reduced record buffers */
+#if MBEDTLS_SSL_MAX_CONTENT_LEN >= 4096
+#define TLS_MAX_FRAG_LEN	MBEDTLS_SSL_MAX_FRAG_LEN_4096
+#elif MBEDTLS_SSL_MAX_CONTENT_LEN >= 2048
+#define TLS_MAX_FRAG_LEN	MBEDTLS_SSL_MAX_FRAG_LEN_2048
+#elif MBEDTLS_SSL_MAX_CONTENT_LEN >= 1024
+#define TLS_MAX_FRAG_LEN	MBEDTLS_SSL_MAX_FRAG_LEN_1024
+#else
+#define TLS_MAX_FRAG_LEN	MBEDTLS_SSL_MAX_FRAG_LEN_512
+#endif
+#endif /* MBEDTLS_SSL_MAX_FRAGMENT_LENGTH */
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -94,6 +110,12 @@ struct secure_socket_desc {
 	mbedtls_ssl_config	conf;
 	/** Mbedtls tls context */
 	mbedtls_ssl_context	ssl;
+	/** Session of the last successful handshake, offered on reconnect */
+	mbedtls_ssl_session	session;
+	/** Set if session is valid */
+	bool			session_valid;
+	/** Set once a handshake was started on ssl */
+	bool			ssl_used;
 };
 #endif /* DISABLE_SECURE_SOCKET */
 
@@ -137,6 +159,8 @@ static int tls_net_send(struct tcp_socket_desc *sock, unsigned char *buff,
 /* Remove secure descriptor*/
 static void stcp_socket_remove(struct secure_socket_desc *desc)
 {
+	mbedtls_ssl_session_free(&desc->session);
+	mbedtls_ssl_free(&desc->ssl);
 	mbedtls_pk_free(&desc->pkey);
 	mbedtls_x509_crt_free(&desc->clicert);
 	mbedtls_x509_crt_free(&desc->cacert);
@@ -164,6 +188,8 @@ static int32_t stcp_socket_init(struct secure_socket_desc **desc,
 
 	/* Initialize structures */
 	mbedtls_ssl_config_init(&ldesc->conf);
+	mbedtls_ssl_init(&ldesc->ssl);
+	mbedtls_ssl_session_init(&ldesc->session);
 	mbedtls_x509_crt_init(&ldesc->cacert);
 	mbedtls_x509_crt_init(&ldesc->clicert);
 	mbedtls_pk_init(&ldesc->pkey);
@@ -235,6 +261,18 @@ static int32_t stcp_socket_init(struct secure_socket_desc **desc,
 			     trng_fill_buffer,
 			     (void *)ldesc->trng);
 
+#ifdef TLS_MAX_FRAG_LEN
+	/* Keep the server records within the reduced record buffers */
+	ret = mbedtls_ssl_conf_max_frag_len(&ldesc->conf, TLS_MAX_FRAG_LEN);
+	if (IS_ERR_VALUE(ret))
+		goto exit;
+#endif /* TLS_MAX_FRAG_LEN */
+
+#ifdef MBEDTLS_SSL_SESSION_TICKETS
+	mbedtls_ssl_conf_session_tickets(&ldesc->conf,
+					 MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif /* MBEDTLS_SSL_SESSION_TICKETS */
+
 	/* Set the resulting protocol configuration */
 	ret = mbedtls_ssl_setup(&ldesc->ssl, &ldesc->conf);
 	if (IS_ERR_VALUE(ret))
@@ -254,6 +292,55 @@ exit:
 
 	return ret;
 }
+
+/*
+ * Run the TLS handshake over a newly connected socket. The session of the
+ * previous connection is offered to the server, so a reconnect only costs an
+ * abbreviated handshake if the server accepts it.
+ */
+static int32_t stcp_socket_handshake(struct secure_socket_desc *desc)
+{
+	int32_t ret;
+
+	/* Clear the state left by a previous connection */
+	if (desc->ssl_used) {
+		ret = mbedtls_ssl_session_reset(&desc->ssl);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+	desc->ssl_used = true;
+
+	if (desc->session_valid) {
+		ret = mbedtls_ssl_set_session(&desc->ssl, &desc->session);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	/*
+	 * Handshake time, build with TRACE=y to measure it. The event tells if a
+	 * session was offered, a resumed handshake is several times shorter than
+	 * a full one.
+	 */
+	TRACE_EVENT(TRACE_ID_TLS_HANDSHAKE, desc->session_valid);
+	TRACE_BEGIN(TRACE_ID_TLS_HANDSHAKE);
+	do {
+		ret = mbedtls_ssl_handshake(&desc->ssl);
+	} while (ret == MBEDTLS_ERR_SSL_WANT_READ);
+	TRACE_END(TRACE_ID_TLS_HANDSHAKE);
+	if (IS_ERR_VALUE(ret)) {
+		/* Don't offer the session again if it caused the failure */
+		mbedtls_ssl_session_free(&desc->session);
+		desc->session_valid = false;
+		return ret;
+	}
+
+	/* Save the new, or resumed, session for the next connect */
+	mbedtls_ssl_session_free(&desc->session);
+	desc->session_valid = !mbedtls_ssl_get_session(&desc->ssl,
+			      &desc->session);
+
+	return SUCCESS;
+}
 #endif /* DISABLE_SECURE_SOCKET */
 
 /**
@@ -353,9 +440,7 @@ int32_t socket_connect(struct tcp_socket_desc *desc,
 
 #ifndef DISABLE_SECURE_SOCKET
 	if (desc->secure) {
-		do {
-			ret = mbedtls_ssl_handshake(&desc->secure->ssl);
-		} while (ret == MBEDTLS_ERR_SSL_WANT_READ);
+		ret = stcp_socket_handshake(desc->secure);
 		if (IS_ERR_VALUE(ret))
 			return ret;
 	}
@@ -49,7 +49,7 @@
 #include <stdio.h>
 #include "at_parser.h"
 #include "error.h"
-#include "delay.h"
+#include "deadline.h"
 #include "uart.h"
 #include "irq.h"
 #include "util.h"
@@ -60,9 +60,9 @@
 /******************************************************************************/
 
 /* Should be sizeof(async_msgs)/sizeof(*async_msgs) */
-#define NB_ASYNC_MESSAGES	3
+#define NB_ASYNC_MESSAGES	5
 /* Should be sizeof(responses)/sizeof(*responses) */
-#define NB_RESPONSE_MESSAGES	4
+#define NB_RESPONSE_MESSAGES	5
 /* Max command length: at+cwsap=max_ssid_32,max_pass_64,0,0 -> 110 characters */
 #define CMD_BUFF_LEN		120u
 /* Maybe this could be smaller. Here must one response at a time */
@@ -71,6 +71,8 @@
 #define PUI8(X)			((uint8_t *)(X))
 /* Timeout waiting for module response. (20 seconds) */
 #define MODULE_TIMEOUT		20000
+/* Longest sleep between two checks of the UART callback state, in us */
+#define MODULE_POLL_US		1000
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -82,6 +84,17 @@ struct cmd_desc {
 	uint32_t	type;
 };
 
+/* State of wait_for_response() between two polls */
+struct at_response_wait {
+	struct at_desc	*desc;
+	/* Number of response messages accepted */
+	uint32_t	nb_responses;
+	/* Next character of the result to check */
+	uint32_t	i;
+	/* Index of the response message found */
+	uint32_t	j;
+};
+
 /* Structure that links the command string with the command macro by index */
 static const struct cmd_desc g_map[] = {
 	{{PUI8(""), 0}, AT_EXECUTE_OP},
@@ -103,7 +116,8 @@ static const struct cmd_desc g_map[] = {
 	{{PUI8("+CIPSERVER"), 10}, AT_SET_OP},
 	{{PUI8("+CIPMODE"), 8}, AT_QUERY_OP | AT_SET_OP},
 	{{PUI8("+CIPSTO"), 7}, AT_QUERY_OP | AT_SET_OP},
-	{{PUI8("+PING"), 5}, AT_SET_OP}
+	{{PUI8("+PING"), 5}, AT_SET_OP},
+	{{PUI8("+CIPSENDBUF"), 11}, AT_SET_OP}
 };
 
 /* Structure storing a connection status */
@@ -116,6 +130,12 @@ struct connection_desc {
 	bool			active;
 	/* Type of connection */
 	enum socket_type	type;
+	/* Segments queued with AT_SEND_BUF */
+	uint32_t		queued_segments;
+	/* Segments the module reported as sent or failed */
+	volatile uint32_t	done_segments;
+	/* Segments the module failed to send, not reported to the caller yet */
+	volatile uint32_t	failed_segments;
 };
 
 /* Structure storing the status of the parser */
@@ -145,6 +165,10 @@ struct at_desc {
 	} 			buffers;
 	/* Stores data received from the module */
 	volatile struct at_buff	result;
+	/* Characters of the result that answer the last command */
+	uint32_t		cmd_result_len;
+	/* An asynchronous message was removed from the result */
+	volatile bool		async_removed;
 	/* Buffer to build the command */
 	struct at_buff		cmd;
 	/* Buffer to read one char */
@@ -307,10 +331,14 @@ static inline int32_t check_conn_id(struct at_desc *desc, struct at_buff *msg,
 		desc->current_conn = id;
 		desc->conn[id].active = false;
 		desc->conn[id].cbuff = NULL;
+		desc->conn[id].queued_segments = 0;
+		desc->conn[id].done_segments = 0;
+		desc->conn[id].failed_segments = 0;
 		/* Notify that a connection was closed */
 		desc->connection_callback(desc->callback_ctx,
 					  AT_CLOSED_CONNECTION, id, NULL);
 	} else {//Not id
+		desc->result.len += (msg->len - 1);
 		desc->async_idx[msg_idx] = 0;
 		return false;
 	}
@@ -318,13 +346,60 @@ static inline int32_t check_conn_id(struct at_desc *desc, struct at_buff *msg,
 	return true;
 }
 
+/*
+ * Account a "[<link>,]<segment>,SEND OK" or "SEND FAIL" message, reported
+ * asynchronously for every segment queued with AT_SEND_BUF
+ */
+static inline bool check_send_ack(struct at_desc *desc, struct at_buff *msg,
+				  int32_t msg_idx, bool sent)
+{
+	int32_t	id;
+	int32_t	j;
+
+	/* Remove the message, its last char was not added */
+	desc->result.len -= (msg->len - 1);
+	/* Skip the segment id */
+	j = desc->result.len - 1;
+	while (j >= 0 && desc->result.buff[j] >= '0' &&
+	       desc->result.buff[j] <= '9')
+		j--;
+
+	id = 0;
+	if (j == (int32_t)desc->result.len - 1) {
+		id = -1;
+	} else if (desc->multiple_conections) {
+		//Response: 2,15,SEND OK -> id = 2
+		if (j < 1 || desc->result.buff[j] != ',' ||
+		    desc->result.buff[j - 1] < '0' ||
+		    desc->result.buff[j - 1] > '3')
+			id = -1;
+		else
+			id = desc->result.buff[--j] - '0';
+	}
+
+	if (id < 0) {
+		desc->result.len += (msg->len - 1);
+		desc->async_idx[msg_idx] = 0;
+		return false;
+	}
+
+	desc->result.len = desc->multiple_conections ? j : j + 1;
+	desc->conn[id].done_segments++;
+	if (!sent)
+		desc->conn[id].failed_segments++;
+
+	return true;
+}
+
 /* Check if an asynchronous messages was sent by the module and update desc */
 static bool is_async_messages(struct at_desc *desc, uint8_t ch)
 {
 	const static struct at_buff async_msgs[NB_ASYNC_MESSAGES] = {
 		{PUI8("CLOSED\r\n"), 8},
 		{PUI8("WIFI DISCONNECT\r\n"), 17},
-		{PUI8("WIFI GOT IP\r\n"), 13}
+		{PUI8("WIFI GOT IP\r\n"), 13},
+		{PUI8(",SEND OK\r\n"), 10},
+		{PUI8(",SEND FAIL\r\n"), 12}
 	};
 
 	int32_t	i;
@@ -336,7 +411,7 @@ static bool is_async_messages(struct at_desc *desc, uint8_t ch)
 
 	switch (i) {
 	case 0: //Match CLOSED\r\n
-		if (check_conn_id(desc, (struct at_buff *)&async_msgs[i], i))
+		if (!check_conn_id(desc, (struct at_buff *)&async_msgs[i], i))
 			return false;
 		break;
 	case 1: //WIFI DISCONNECT\r\n
@@ -345,12 +420,19 @@ static bool is_async_messages(struct at_desc *desc, uint8_t ch)
 	case 2:
 		desc->is_wifi_connected = true;
 		break;
+	case 3: //[<link>,]<segment>,SEND OK\r\n
+	case 4: //[<link>,]<segment>,SEND FAIL\r\n
+		if (!check_send_ack(desc, (struct at_buff *)&async_msgs[i], i,
+				    i == 3))
+			return false;
+		break;
 	default:
 		return false;
 	}
 
 	/* Clear response indexes */
 	memset(desc->async_idx, 0, sizeof(desc->async_idx));
+	desc->async_removed = true;
 
 	return true;
 }
@@ -371,7 +453,7 @@ static inline void start_conn_read(struct at_desc *desc, bool is_new_message)
 	struct connection_desc	*conn;
 	uint8_t			*buff;
 	uint32_t		available_len;
-	uint32_t		ret;
+	int32_t			ret;
 
 	conn = &desc->conn[desc->current_conn];
 
@@ -476,76 +558,134 @@ static void at_callback(struct at_desc *desc, uint32_t event, uint8_t *data)
 	uart_read_nonblocking(desc->uart_desc, &desc->read_ch, 1);
 }
 
-/* Wait the response for the last command for MODULE_TIMEOUT milliseconds */
-static int32_t wait_for_response(struct at_desc *desc)
+/* Check the characters received since the last poll for a response */
+static int32_t response_received(void *ctx)
 {
 	const static struct at_buff responses[NB_RESPONSE_MESSAGES] = {
 		{PUI8("\r\nERROR\r\n"), 9},
 		{PUI8("\r\nFAIL\r\n"), 8},
 		{PUI8("\r\nOK\r\n"), 6},
-		{PUI8("\r\nSEND OK\r\n"), 11}
+		{PUI8("\r\nSEND OK\r\n"), 11},
+		{PUI8(" bytes\r\n"), 8}
 	};
-	uint32_t	timeout;
-	uint32_t	result;
-	uint32_t	i;
-	uint32_t	j;
+	struct at_response_wait	*wait = ctx;
+	struct at_desc		*desc = wait->desc;
 
-	i = 0;
-	timeout = MODULE_TIMEOUT;
-	result = FAILURE;
-	do {
-		if (i < desc->result.len) {
-			for (j = 0; j < NB_RESPONSE_MESSAGES; j++)
-				if (match_message(&responses[j],
-						  &desc->resp_idx[j],
-						  desc->result.buff[i]))
-					break;
-
-			i++;
-			switch (j) {
-			case 0: // \r\nERROR\r\n
-			case 1: // \r\nFAIL\r\n
-				result = FAILURE;
-				goto end;
-			case 2: // \r\nOK\r\n
-			case 3: // \r\nSEND OK\r\n
-				result = SUCCESS;
-				goto end;
-			default:
+	/*
+	 * The characters after a removed asynchronous message moved down, scan
+	 * the result again
+	 */
+	if (desc->async_removed) {
+		desc->async_removed = false;
+		wait->i = 0;
+		memset(desc->resp_idx, 0, sizeof(desc->resp_idx));
+	}
+	while (wait->i < desc->result.len) {
+		for (wait->j = 0; wait->j < wait->nb_responses; wait->j++)
+			if (match_message(&responses[wait->j],
+					  &desc->resp_idx[wait->j],
+					  desc->result.buff[wait->i]))
 				break;
-			}
+
+		wait->i++;
+		if (wait->j == wait->nb_responses)
+			/* No match, not the Recv <n> bytes when it's excluded */
+			continue;
+		switch (wait->j) {
+		case 0: // \r\nERROR\r\n
+		case 1: // \r\nFAIL\r\n
+			return FAILURE;
+		case 2: // \r\nOK\r\n
+		case 3: // \r\nSEND OK\r\n
+		case 4: // Recv <n> bytes\r\n
+			return 1;
+		default:
+			break;
 		}
-		mdelay(1);
-	} while (--timeout);
+	}
+
+	return 0;
+}
+
+/* Remove len characters from the result, starting at pos */
+static void result_cut(struct at_desc *desc, uint32_t pos, uint32_t len)
+{
+	/* The callback adds characters at the end meanwhile */
+	irq_disable(desc->irq_desc, desc->uart_irq_id);
+	memmove(desc->result.buff + pos, desc->result.buff + pos + len,
+		desc->result.len - pos - len);
+	desc->result.len -= len;
+	irq_enable(desc->irq_desc, desc->uart_irq_id);
+}
+
+/*
+ * Wait the response for the last command for MODULE_TIMEOUT milliseconds.
+ * If recv_ack is set, the "Recv <n> bytes" acknowledge of a buffered send is
+ * also accepted as success.
+ */
+static int32_t wait_for_response(struct at_desc *desc, bool recv_ack)
+{
+	struct at_response_wait	wait = {
+		.desc = desc,
+		.nb_responses = recv_ack ? NB_RESPONSE_MESSAGES :
+				NB_RESPONSE_MESSAGES - 1,
+	};
+	int32_t			ret;
 
-end:
-	if (timeout) //If a response arrived clean the result
-		desc->result.len -= desc->resp_idx[j];
+	ret = poll_until(response_received, &wait, MODULE_TIMEOUT * 1000,
+			 MODULE_POLL_US);
+	if (ret != -ETIMEDOUT) {
+		/*
+		 * Remove the response. What arrived after it is kept, it may be
+		 * the start of an asynchronous message.
+		 */
+		desc->cmd_result_len = wait.i - desc->resp_idx[wait.j];
+		result_cut(desc, desc->cmd_result_len,
+			   desc->resp_idx[wait.j]);
+	}
 
 	memset(desc->resp_idx, 0, sizeof(desc->resp_idx));
 
-	return result;
+	return ret == SUCCESS ? SUCCESS : FAILURE;
+}
+
+/* The '>' prompt of a send command was received */
+static int32_t send_prompt_received(void *ctx)
+{
+	struct at_desc *desc = ctx;
+
+	return desc->callback_operation != WAITING_SEND;
+}
+
+/* The module reported WIFI DISCONNECT */
+static int32_t wifi_disconnected(void *ctx)
+{
+	struct at_desc *desc = ctx;
+
+	return !desc->is_wifi_connected;
+}
+
+/* The module reported ready after a reset */
+static int32_t module_ready(void *ctx)
+{
+	struct at_desc *desc = ctx;
+
+	return desc->callback_operation != RESETTING_MODULE;
 }
 
 /* Send what is in desc->cmd over the UART and handle special case of AT_SEND */
 static int32_t send_cmd(struct at_desc *desc, enum at_cmd cmd,
 			union in_param *in_param)
 {
-	uint32_t timeout = MODULE_TIMEOUT;
-
 	uart_write(desc->uart_desc, desc->cmd.buff, desc->cmd.len);
-	if (cmd == AT_SEND) {
+	if (cmd == AT_SEND || cmd == AT_SEND_BUF) {
 		desc->callback_operation = WAITING_SEND;
 		/* Waiting for ok */
-		if (SUCCESS != wait_for_response(desc))
+		if (SUCCESS != wait_for_response(desc, false))
 			return FAILURE;
 		/* Wait until '>' is received */
-		while (timeout--) {
-			if (WAITING_SEND != desc->callback_operation)
-				break;
-			mdelay(1);
-		}
-		if (timeout == 0)
+		if (SUCCESS != poll_until(send_prompt_received, desc,
+					  MODULE_TIMEOUT * 1000, MODULE_POLL_US))
 			return FAILURE;
 		/* Write payload */
 		uart_write(desc->uart_desc, in_param->send_data.data.buff,
@@ -553,21 +693,19 @@ static int32_t send_cmd(struct at_desc *desc, enum at_cmd cmd,
 	} else if (cmd == AT_DISCONNECT_NETWORK) {
 		if (desc->is_wifi_connected) {
 			/* Wait for WIFI_DISCONNECT */
-			do {
-				if (desc->is_wifi_connected == 0)
-					break;
-				mdelay(1);
-			} while (timeout--);
-
-			if (timeout == 0)
+			if (SUCCESS != poll_until(wifi_disconnected, desc,
+						  MODULE_TIMEOUT * 1000,
+						  MODULE_POLL_US))
 				return FAILURE;
+			desc->cmd_result_len = desc->result.len;
 
 			return SUCCESS;
 		}
 	}
 
-	/* Wait for OK, SEND OK or ERROR */
-	return wait_for_response(desc);
+	/* Wait for OK, SEND OK or ERROR. A buffered send only waits until the
+	 * module received the payload */
+	return wait_for_response(desc, cmd == AT_SEND_BUF);
 }
 
 /*
@@ -711,6 +849,15 @@ static void concat_cmd_param(struct at_desc *desc, enum at_cmd cmd,
 					(int32_t)param->send_data.remote_port);
 		}
 		break;
+	case AT_SEND_BUF:
+		if (desc->multiple_conections)
+			set_params(&desc->cmd, PUI8("dd"),
+				   (int32_t)param->send_data.id,
+				   (int32_t)param->send_data.data.len);
+		else
+			set_params(&desc->cmd, PUI8("d"),
+				   (int32_t)param->send_data.data.len);
+		break;
 	case AT_STOP_CONNECTION:
 		set_params(&desc->cmd, PUI8("d"), param->conn_id);
 		break;
@@ -779,9 +926,9 @@ static int32_t stop_echo(struct at_desc *desc)
 {
 	uart_write(desc->uart_desc, (uint8_t *)"ATE0\r\n", 6);
 
-	if (SUCCESS != wait_for_response(desc))
+	if (SUCCESS != wait_for_response(desc, false))
 		return FAILURE;
-	desc->result.len = 0;
+	result_cut(desc, 0, desc->cmd_result_len);
 
 	return SUCCESS;
 }
@@ -789,20 +936,13 @@ static int32_t stop_echo(struct at_desc *desc)
 /* Handle special cases */
 static int32_t handle_special(struct at_desc *desc, enum at_cmd cmd)
 {
-	uint32_t timeout;
-
 	switch (cmd) {
 	case AT_RESET:
 		desc->callback_operation = RESETTING_MODULE;
 		uart_write(desc->uart_desc, desc->cmd.buff, desc->cmd.len);
-		timeout = MODULE_TIMEOUT;
-		do {
-			/* Wait for "ready" message */
-			if (desc->callback_operation != RESETTING_MODULE)
-				break;
-			mdelay(1);
-		} while (timeout--);
-		if (!timeout)
+		/* Wait for "ready" message */
+		if (SUCCESS != poll_until(module_ready, desc,
+					  MODULE_TIMEOUT * 1000, MODULE_POLL_US))
 			return FAILURE;
 
 		desc->callback_operation = READING_PAYLOAD;
@@ -828,9 +968,9 @@ static int32_t parse_result(struct at_desc *desc, enum at_cmd cmd,
 {
 
 	result->result.buff = desc->buffers.app_result_buff;
-	memcpy(result->result.buff, desc->result.buff, desc->result.len);
-	result->result.len = desc->result.len;
-	desc->result.len = 0;
+	memcpy(result->result.buff, desc->result.buff, desc->cmd_result_len);
+	result->result.len = desc->cmd_result_len;
+	result_cut(desc, 0, desc->cmd_result_len);
 
 	return SUCCESS;
 }
@@ -863,7 +1003,7 @@ int32_t at_run_cmd(struct at_desc *desc, enum at_cmd cmd, enum cmd_operation op,
 	if (cmd == AT_DEEP_SLEEP || cmd == AT_RESET)
 		return handle_special(desc, cmd);
 
-	ret = send_cmd(desc, cmd, &param->in);
+	ret = send_cmd(desc, cmd, param ? &param->in : NULL);
 	if (IS_ERR_VALUE(ret))
 		return ret;
 
@@ -873,6 +1013,13 @@ int32_t at_run_cmd(struct at_desc *desc, enum at_cmd cmd, enum cmd_operation op,
 	if (cmd == AT_START_CONNECTION && op == AT_SET_OP) {
 		id = desc->multiple_conections ? param->in.connection.id : 0;
 		desc->conn[id].type = param->in.connection.soket_type;
+		desc->conn[id].queued_segments = 0;
+		desc->conn[id].done_segments = 0;
+		desc->conn[id].failed_segments = 0;
+	}
+	if (cmd == AT_SEND_BUF) {
+		id = desc->multiple_conections ? param->in.send_data.id : 0;
+		desc->conn[id].queued_segments++;
 	}
 
 	/* Fill the output parameter */
@@ -884,7 +1031,7 @@ int32_t at_run_cmd(struct at_desc *desc, enum at_cmd cmd, enum cmd_operation op,
 			return ret;
 	} else
 		/* Clear the result*/
-		desc->result.len = 0;
+		result_cut(desc, 0, desc->cmd_result_len);
 
 	if (desc->errors) {
 		ret = desc->errors;
@@ -998,6 +1145,39 @@ int32_t at_remove(struct at_desc *desc)
 	return SUCCESS;
 }
 
+/**
+ * @brief Get the number of segments queued with \ref AT_SEND_BUF that the
+ * module did not report as sent yet
+ *
+ * A "SEND FAIL" from the module only affects the connection it was reported
+ * for. It is returned once, by the next call for that connection.
+ * @param desc - AT parser reference
+ * @param conn_id - Connection id
+ * @param pending - Where to store the number of pending segments
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EIO : The module failed to send a segment since the last call. pending
+ *  is still updated
+ *  - \ref FAILURE : Otherwise
+ */
+int32_t at_get_pending_sends(struct at_desc *desc, uint32_t conn_id,
+			     uint32_t *pending)
+{
+	struct connection_desc *conn;
+
+	if (!desc || !pending || conn_id >= MAX_CONNECTIONS)
+		return FAILURE;
+
+	conn = &desc->conn[conn_id];
+	*pending = conn->queued_segments - conn->done_segments;
+	if (conn->failed_segments) {
+		conn->failed_segments = 0;
+		return -EIO;
+	}
+
+	return SUCCESS;
+}
+
 /**
  * @brief Convert null terminated string to at_buff
  * @param dest - Destination buffer
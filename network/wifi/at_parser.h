@@ -216,7 +216,13 @@ enum at_cmd {
 	 *  Ping
 	 *  Use \ref in_param.ping_ip as set parameter
 	 */
-	AT_PING				// "+PING"
+	AT_PING,			// "+PING"
+	/**
+	 * Queue data in the module send buffer, TCP only. Returns once the
+	 * module received the data, the send completes in the background.
+	 * Use \ref in_param.send_data as set parameter
+	 */
+	AT_SEND_BUF			// "+CIPSENDBUF"
 };
 
 /**
@@ -273,7 +279,7 @@ union in_param {
 	struct cwsap_param	ap;
 	/** Param for \ref AT_START_CONNECTION */
 	struct cipstart_param	connection;
-	/** Param for \ref AT_SEND */
+	/** Param for \ref AT_SEND and \ref AT_SEND_BUF */
 	struct cipsend_param	send_data;
 	/** Param for \ref AT_STOP_CONNECTION */
 	uint32_t		conn_id;
@@ -349,6 +355,9 @@ int32_t at_remove(struct at_desc *desc);
 /* Execute an AT command */
 int32_t at_run_cmd(struct at_desc *desc, enum at_cmd cmd, enum cmd_operation op,
 		   union in_out_param *param);
+/* Get the number of buffered sends not yet acknowledged by the module */
+int32_t at_get_pending_sends(struct at_desc *desc, uint32_t conn_id,
+			     uint32_t *pending);
 /* Convert null terminated string to at_buff */
 int32_t str_to_at(struct at_buff *dest, const uint8_t *src);
 /* Convert at_buff to null terminated string */
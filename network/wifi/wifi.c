@@ -48,6 +48,7 @@
 #include "at_parser.h"
 #include "error.h"
 #include "util.h"
+#include "deadline.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -56,11 +57,23 @@
 #define INVALID_ID	0xffffffff
 #define NB_SOCKETS	(MAX_CONNECTIONS + 1)
 #define NB_CLI_SOCKETS	MAX_CONNECTIONS
+/* Buffered segments allowed in flight on a connection */
+#define SEND_WINDOW	4
+/* Timeout waiting for the module to free a send buffer slot (ms) */
+#define SEND_TIMEOUT	20000
+/* Longest sleep between two checks of the send buffer, in us */
+#define SEND_POLL_US	1000
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+/* Connection waited for by _wifi_wait_send_window() */
+struct send_window_wait {
+	struct wifi_desc	*desc;
+	uint32_t		conn_id;
+};
+
 /* Structure storing data used by a socket */
 struct socket_desc {
 	/* Buffer given to at_parser */
@@ -109,6 +122,10 @@ struct wifi_desc {
 	struct network_interface	interface;
 	/* Will be used in callback */
 	int32_t				conn_id_to_sock_id[MAX_CONNECTIONS];
+	/* Send TCP data with AT_SEND_BUF */
+	bool				buffered_send;
+	/* Set once an AT_SEND_BUF succeeded, the firmware supports it */
+	bool				buffered_send_checked;
 };
 
 /******************************************************************************/
@@ -323,6 +340,7 @@ int32_t wifi_init(struct wifi_desc **desc, struct wifi_init_param *param)
 	at_param.uart_irq_id = param->uart_irq_id;
 	at_param.connection_callback = _wifi_connection_callback;
 	at_param.callback_ctx = ldesc;
+	ldesc->buffered_send = param->buffered_send;
 
 	result = at_init(&ldesc->at, &at_param);
 	if (IS_ERR_VALUE(result))
@@ -545,7 +563,7 @@ static int32_t wifi_socket_connect(struct wifi_desc *desc, uint32_t sock_id,
 				   struct socket_address *addr)
 {
 	union in_out_param	param;
-	uint32_t		ret;
+	int32_t			ret;
 	struct socket_desc	*sock;
 
 	if (!desc || !addr || sock_id >= NB_SOCKETS ||
@@ -595,7 +613,7 @@ static void _remove_server_back_log(struct wifi_desc *desc)
 static int32_t wifi_socket_disconnect(struct wifi_desc *desc, uint32_t sock_id)
 {
 	union in_out_param	param;
-	uint32_t		ret;
+	int32_t			ret;
 	struct socket_desc	*sock;
 
 	if (!desc || sock_id >= NB_SOCKETS)
@@ -633,15 +651,42 @@ static int32_t wifi_socket_disconnect(struct wifi_desc *desc, uint32_t sock_id)
 	return SUCCESS;
 }
 
+/* The connection has a free slot in the module send buffer */
+static int32_t _wifi_send_window_free(void *ctx)
+{
+	struct send_window_wait	*wait = ctx;
+	uint32_t		pending;
+	int32_t			ret;
+
+	ret = at_get_pending_sends(wait->desc->at, wait->conn_id, &pending);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	return pending < SEND_WINDOW;
+}
+
+/* Wait until the connection has a free slot in the module send buffer */
+static int32_t _wifi_wait_send_window(struct wifi_desc *desc, uint32_t conn_id)
+{
+	struct send_window_wait wait = {
+		.desc = desc,
+		.conn_id = conn_id,
+	};
+
+	return poll_until(_wifi_send_window_free, &wait, SEND_TIMEOUT * 1000,
+			  SEND_POLL_US);
+}
+
 /** @brief See \ref network_interface.socket_send */
 static int32_t wifi_socket_send(struct wifi_desc *desc, uint32_t sock_id,
 				const void *data, uint32_t size)
 {
 	union in_out_param	param;
-	uint32_t		ret;
+	int32_t			ret;
 	struct socket_desc	*sock;
 	uint32_t		to_send;
 	uint32_t		i;
+	enum at_cmd		cmd;
 
 	if (!desc || sock_id >= NB_SOCKETS || desc->server.id == sock_id)
 		return -EINVAL;
@@ -653,12 +698,32 @@ static int32_t wifi_socket_send(struct wifi_desc *desc, uint32_t sock_id,
 	i = 0;
 	do {
 		to_send = min(size - i, MAX_CIPSEND_DATA);
+		cmd = AT_SEND;
+		if (desc->buffered_send && sock->type == PROTOCOL_TCP) {
+			/*
+			 * Keep up to SEND_WINDOW segments in flight. Fails with
+			 * -EIO if the module failed to send an earlier segment
+			 * of this connection.
+			 */
+			ret = _wifi_wait_send_window(desc, sock->conn_id);
+			if (IS_ERR_VALUE(ret))
+				return ret;
+			cmd = AT_SEND_BUF;
+		}
 		param.in.send_data.id = sock->conn_id;
 		param.in.send_data.data.buff = ((uint8_t *)data) + i;
 		param.in.send_data.data.len = to_send;
-		ret = at_run_cmd(desc->at, AT_SEND, AT_SET_OP, &param);
+		ret = at_run_cmd(desc->at, cmd, AT_SET_OP, &param);
+		if (ret == FAILURE && cmd == AT_SEND_BUF &&
+		    !desc->buffered_send_checked) {
+			/* Firmware without AT+CIPSENDBUF answers ERROR */
+			desc->buffered_send = false;
+			continue;
+		}
 		if (IS_ERR_VALUE(ret))
 			return ret;
+		if (cmd == AT_SEND_BUF)
+			desc->buffered_send_checked = true;
 
 		i += to_send;
 	} while (i < size);
@@ -46,6 +46,7 @@
 /******************************************************************************/
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "network_interface.h"
 #include "uart.h"
 #include "irq.h"
@@ -73,6 +74,12 @@ struct wifi_init_param {
 	uint32_t		uart_irq_id;
 	/** Configuration param for registering uart callback */
 	void			*uart_irq_conf;
+	/**
+	 * Use the module send buffer (AT+CIPSENDBUF) for TCP sockets, keeping
+	 * several segments in flight instead of waiting for each one to be
+	 * acknowledged. Falls back to AT+CIPSEND if the firmware rejects it.
+	 */
+	bool			buffered_send;
 };
 
 /******************************************************************************/
@@ -11,12 +11,19 @@
 
 SRCS += $(PROJECT)/src/ad7124-4sdz.c
 SRCS += $(DRIVERS)/spi/spi.c						\
+	$(DRIVERS)/gpio/gpio.c						\
+	$(DRIVERS)/adc/ad_sigma_delta/ad_sigma_delta.c			\
 	$(DRIVERS)/adc/ad7124/ad7124.c					\
-	$(DRIVERS)/adc/ad7124/ad7124_regs.c				
+	$(DRIVERS)/adc/ad7124/ad7124_regs.c
+SRCS += $(NO-OS)/util/crc8.c						\
+	$(NO-OS)/util/circular_buffer.c
 SRCS +=	$(PLATFORM_DRIVERS)/axi_io.c					\
 	$(PLATFORM_DRIVERS)/xilinx_spi.c				\
+	$(PLATFORM_DRIVERS)/xilinx_gpio.c				\
+	$(PLATFORM_DRIVERS)/irq.c					\
 	$(PLATFORM_DRIVERS)/delay.c
-INCS += $(DRIVERS)/adc/ad7124/ad7124.h					\
+INCS += $(DRIVERS)/adc/ad_sigma_delta/ad_sigma_delta.h			\
+	$(DRIVERS)/adc/ad7124/ad7124.h					\
 	$(DRIVERS)/adc/ad7124/ad7124_regs.h
 
 INCS +=	$(PLATFORM_DRIVERS)/spi_extra.h					\
@@ -30,4 +37,6 @@ INCS +=	$(INCLUDE)/axi_io.h						\
 	$(INCLUDE)/delay.h						\
 	$(INCLUDE)/irq.h						\
 	$(INCLUDE)/uart.h						\
+	$(INCLUDE)/crc8.h						\
+	$(INCLUDE)/circular_buffer.h					\
 	$(INCLUDE)/util.h
@@ -55,6 +55,15 @@
 #include "delay.h"
 #include "error.h"
 
+#ifdef IIO_SUPPORT
+#include "irq.h"
+#include "irq_extra.h"
+#include "uart.h"
+#include "uart_extra.h"
+#include "iio.h"
+#include "iio_ad77681.h"
+#endif // IIO_SUPPORT
+
 uint32_t spi_msg_cmds[6] = {CS_LOW, CS_HIGH, CS_LOW, WRITE_READ(1), CS_HIGH};
 
 struct spi_engine_init_param spi_eng_init_param  = {
@@ -136,6 +145,73 @@ int main()
 
 	ad77681_setup(&adc_dev, ADC_default_init_param, &adc_status);
 
+#ifdef IIO_SUPPORT
+	struct iio_desc *iio_app_desc;
+	struct iio_ad77681_desc *iio_ad77681;
+	struct iio_device *ad77681_dev_desc;
+	struct xil_irq_init_param xil_irq_init_par = {
+		.type = IRQ_PS,
+	};
+	struct irq_init_param irq_init_param = {
+		.irq_ctrl_id = INTC_DEVICE_ID,
+		.extra = &xil_irq_init_par,
+	};
+	struct irq_ctrl_desc *irq_desc;
+	ret = irq_ctrl_init(&irq_desc, &irq_init_param);
+	if (ret < 0)
+		return ret;
+	struct xil_uart_init_param xil_uart_init_par = {
+		.type = UART_PS,
+		.irq_id = UART_IRQ_ID,
+		.irq_desc = irq_desc,
+	};
+	struct uart_init_param uart_init_par = {
+		.baud_rate = 115200,
+		.device_id = UART_DEVICE_ID,
+		.extra = &xil_uart_init_par,
+	};
+	struct iio_init_param iio_init_par = {
+		.phy_type = USE_UART,
+		.uart_init_param = &uart_init_par,
+	};
+	/* Stream through the DRDY triggered SPI Engine offload */
+	struct iio_ad77681_init_param iio_ad77681_init_par = {
+		.dev = adc_dev,
+		.stream_param = {
+			.offload_init = &spi_engine_offload_init_param,
+			.rx_addr = OFFLOAD_RX_BASEADDR,
+			.dcache_invalidate_range =
+			(void (*)(uint32_t, uint32_t))Xil_DCacheInvalidateRange,
+		},
+	};
+	struct iio_data_buffer read_buff = {
+		.buff = (void *)ADC_DDR_BASEADDR,
+		.size = MAX_SIZE_BASE_ADDR
+	};
+
+	ret = irq_global_enable(irq_desc);
+	if (ret < 0)
+		return ret;
+
+	ret = iio_init(&iio_app_desc, &iio_init_par);
+	if (ret < 0)
+		return ret;
+
+	ret = iio_ad77681_init(&iio_ad77681, &iio_ad77681_init_par);
+	if (ret < 0)
+		return ret;
+
+	iio_ad77681_get_dev_descriptor(iio_ad77681, &ad77681_dev_desc);
+	ret = iio_register(iio_app_desc, ad77681_dev_desc, "ad7768-1",
+			   iio_ad77681, &read_buff, NULL);
+	if (ret < 0)
+		return ret;
+
+	do {
+		ret = iio_step(iio_app_desc);
+	} while (true);
+#endif // IIO_SUPPORT
+
 	if (SPI_ENGINE_OFFLOAD_EXAMPLE == 0) {
 		while(1) {
 			ad77681_spi_read_adc_data(adc_dev, adc_data);
@@ -64,4 +64,16 @@
 #define GPIO_0_SYNC_OUT						GPIO_OFFSET + 1 // 33
 #define GPIO_0_RESET						GPIO_OFFSET + 0 // 32
 
+#ifdef IIO_SUPPORT
+#define UART_DEVICE_ID						XPAR_XUARTPS_0_DEVICE_ID
+#define UART_IRQ_ID							XPAR_XUARTPS_1_INTR
+#define INTC_DEVICE_ID						XPAR_SCUGIC_SINGLE_DEVICE_ID
+/* Samples returned to the iio client */
+#define ADC_DDR_BASEADDR					XPAR_DDR_MEM_BASEADDR + 0x800000
+/* Maximum data to be read in a capture over iio */
+#define MAX_SIZE_BASE_ADDR					0x100000 //1MB
+/* Offload DMA destination, one 32-bit word per sample */
+#define OFFLOAD_RX_BASEADDR					ADC_DDR_BASEADDR + MAX_SIZE_BASE_ADDR
+#endif // IIO_SUPPORT
+
 #endif /* PARAMETERS_H_ */
@@ -67,8 +67,8 @@ extern struct axi_jesd204_tx *tx_jesd;
 
 int main(void)
 {
-	struct clk app_clk[MULTIDEVICE_INSTANCE_COUNT];
-	struct clk jesd_clk[2];
+	struct clk app_clk[MULTIDEVICE_INSTANCE_COUNT] = { 0 };
+	struct clk jesd_clk[2] = { 0 };
 	struct xil_gpio_init_param  xil_gpio_param = {
 #ifdef PLATFORM_MB
 		.type = GPIO_PL,
@@ -19,12 +19,16 @@ SRCS += $(DRIVERS)/axi_core/axi_adc_core/axi_adc_core.c			\
 	$(DRIVERS)/axi_core/axi_dmac/axi_dmac.c				\
 	$(DRIVERS)/spi/spi.c						\
 	$(DRIVERS)/gpio/gpio.c						\
+	$(NO-OS)/util/deadline.c					\
 	$(NO-OS)/util/util.c
 SRCS +=	$(PLATFORM_DRIVERS)/axi_io.c
 SRCS +=	$(PLATFORM_DRIVERS)/$(PLATFORM)_spi.c				\
 	$(PLATFORM_DRIVERS)/$(PLATFORM)_gpio.c
 ifeq (linux,$(strip $(PLATFORM)))
 SRCS +=	$(PLATFORM_DRIVERS)/linux_delay.c
+ifeq (y,$(strip $(GPIOCHIP)))
+SRCS +=	$(PLATFORM_DRIVERS)/linux_gpiochip.c
+endif
 else
 SRCS +=	$(PLATFORM_DRIVERS)/delay.c
 endif
@@ -51,6 +55,9 @@ INCS += $(DRIVERS)/axi_core/axi_adc_core/axi_adc_core.h			\
 ifeq (linux,$(strip $(PLATFORM)))
 INCS +=	$(PLATFORM_DRIVERS)/linux_spi.h					\
 	$(PLATFORM_DRIVERS)/linux_gpio.h
+ifeq (y,$(strip $(GPIOCHIP)))
+INCS +=	$(PLATFORM_DRIVERS)/linux_gpiochip.h
+endif
 else
 INCS +=	$(PLATFORM_DRIVERS)/spi_extra.h					\
 	$(PLATFORM_DRIVERS)/gpio_extra.h
@@ -60,6 +67,8 @@ INCS +=	$(INCLUDE)/axi_io.h						\
 	$(INCLUDE)/gpio.h						\
 	$(INCLUDE)/error.h						\
 	$(INCLUDE)/delay.h						\
+	$(INCLUDE)/deadline.h						\
+	$(INCLUDE)/trace.h						\
 	$(INCLUDE)/util.h
 ifeq (y,$(strip $(TINYIIOD)))
 INCS += $(INCLUDE)/xml.h						\
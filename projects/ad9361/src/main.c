@@ -55,12 +55,23 @@
 #endif
 #ifdef LINUX_PLATFORM
 #include "linux_spi.h"
+#ifdef LINUX_GPIOCHIP
+#include "linux_gpiochip.h"
+#define linux_gpio_ops		linux_gpiochip_platform_ops
+#else
 #include "linux_gpio.h"
+#define linux_gpio_ops		linux_gpio_platform_ops
+#endif
+#ifdef TRACE_ENABLE
+#include <stdio.h>
+#define TRACE_FILE		"ad9361_trace.bin"
+#endif
 #endif
 #include "axi_adc_core.h"
 #include "axi_dac_core.h"
 #include "axi_dmac.h"
 #include "error.h"
+#include "trace.h"
 
 #ifdef IIO_SUPPORT
 
@@ -372,7 +383,7 @@ AD9361_InitParam default_init_param = {
 		.extra = &xil_gpio_param
 #endif
 #ifdef LINUX_PLATFORM
-		.platform_ops = &linux_gpio_platform_ops
+		.platform_ops = &linux_gpio_ops
 #endif
 	},		//gpio_resetb *** reset-gpios
 	/* MCS Sync */
@@ -383,7 +394,7 @@ AD9361_InitParam default_init_param = {
 		.extra = &xil_gpio_param
 #endif
 #ifdef LINUX_PLATFORM
-		.platform_ops = &linux_gpio_platform_ops
+		.platform_ops = &linux_gpio_ops
 #endif
 	},		//gpio_sync *** sync-gpios
 
@@ -394,7 +405,7 @@ AD9361_InitParam default_init_param = {
 		.extra = &xil_gpio_param
 #endif
 #ifdef LINUX_PLATFORM
-		.platform_ops = &linux_gpio_platform_ops
+		.platform_ops = &linux_gpio_ops
 #endif
 	},		//gpio_cal_sw1 *** cal-sw1-gpios
 
@@ -405,7 +416,7 @@ AD9361_InitParam default_init_param = {
 		.extra = &xil_gpio_param
 #endif
 #ifdef LINUX_PLATFORM
-		.platform_ops = &linux_gpio_platform_ops
+		.platform_ops = &linux_gpio_ops
 #endif
 	},		//gpio_cal_sw2 *** cal-sw2-gpios
 
@@ -490,6 +501,20 @@ struct ad9361_rf_phy *ad9361_phy;
 struct ad9361_rf_phy *ad9361_phy_b;
 #endif
 
+#if defined TRACE_ENABLE && defined LINUX_PLATFORM
+/***************************************************************************//**
+ * @brief Write a chunk of the trace dump to a file.
+ * @param ctx - The file.
+ * @param buff - The data.
+ * @param len - The data length.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+*******************************************************************************/
+static int32_t trace_write_file(void *ctx, const uint8_t *buff, uint32_t len)
+{
+	return fwrite(buff, 1, len, ctx) == len ? SUCCESS : FAILURE;
+}
+#endif
+
 /***************************************************************************//**
  * @brief main
 *******************************************************************************/
@@ -512,6 +537,14 @@ int main(void)
 	}
 #endif
 
+#ifdef TRACE_ENABLE
+	status = trace_init();
+	if (status != SUCCESS) {
+		printf("trace_init error: %"PRIi32"\n", status);
+		return status;
+	}
+#endif
+
 	// NOTE: The user has to choose the GPIO numbers according to desired
 	// carrier board.
 	default_init_param.gpio_resetb.number = GPIO_RESET_PIN;
@@ -627,6 +660,17 @@ int main(void)
 #endif
 #endif
 
+#if defined TRACE_ENABLE && defined LINUX_PLATFORM
+	/* Boot trace, convert it with tools/scripts/trace2json.py */
+	FILE *trace_file = fopen(TRACE_FILE, "wb");
+	if (trace_file) {
+		status = trace_dump(trace_write_file, trace_file);
+		fclose(trace_file);
+		if (status == SUCCESS)
+			printf("Trace written to %s\n", TRACE_FILE);
+	}
+#endif
+
 #ifdef IIO_SUPPORT
 
 	/**
@@ -21,16 +21,22 @@
 #include "gpio_extra.h"
 #include "gpio.h"
 #include "delay.h"
+#include "deadline.h"
 
 #include "parameters.h"
 
 #ifndef ALTERA_PLATFORM
 #include <xparameters.h>
+#else
+#include <sys/alt_alarm.h>
 #endif
 
+/* Largest number of data bytes sent in one streaming SPI transaction */
+#define CMB_SPI_STREAM_MAX_BYTES	64
+
 ADI_LOGLEVEL CMB_LOGLEVEL = ADIHAL_LOG_NONE;
 
-static uint32_t _desired_time_to_elapse_us = 0;
+static struct deadline _timeout;
 struct spi_desc 	*spi_ad_desc;
 struct gpio_desc	*gpio_ad9371_resetb;
 struct gpio_desc	*gpio_ad9528_resetb;
@@ -123,6 +129,17 @@ int32_t platform_remove(void)
 	return status;
 }
 
+static commonErr_t CMB_SPITransfer(spiSettings_t *spiSettings, uint8_t *buf,
+				   uint32_t len)
+{
+	spi_ad_desc->chip_select = spiSettings->chipSelectIndex - 1;
+
+	if (spi_write_and_read(spi_ad_desc, buf, len) != 0)
+		return(COMMONERR_FAILED);
+
+	return(COMMONERR_OK);
+}
+
 commonErr_t CMB_closeHardware(void)
 {
 	return(COMMONERR_OK);
@@ -173,26 +190,50 @@ commonErr_t CMB_SPIWriteByte(spiSettings_t *spiSettings, uint16_t addr,
 {
 	uint8_t buf[3];
 
-	spi_ad_desc->chip_select = spiSettings->chipSelectIndex - 1;
-
 	buf[0] = (uint8_t) ((addr >> 8) & 0x7f);
 	buf[1] = (uint8_t) (addr & 0xff);
 	buf[2] = (uint8_t) data;
 
-	spi_write_and_read(spi_ad_desc, buf, 3);
-
-	return(COMMONERR_OK);
+	return CMB_SPITransfer(spiSettings, buf, 3);
 }
 
+/*
+ * Runs of consecutive addresses, following the address increment direction
+ * set by MYKONOS_setSpiSettings(), are sent as one streaming transaction:
+ * the instruction word of the first address followed by the data bytes.
+ */
 commonErr_t CMB_SPIWriteBytes(spiSettings_t *spiSettings, uint16_t *addr,
 			      uint8_t *data, uint32_t count)
 {
+	static uint8_t buf[2 + CMB_SPI_STREAM_MAX_BYTES];
+	uint16_t next;
 	uint32_t index;
+	uint32_t len;
+
+	if (!spiSettings->enSpiStreaming) {
+		for (index = 0; index < count; index++)
+			if (CMB_SPIWriteByte(spiSettings, *(addr + index),
+					     *(data + index)) != COMMONERR_OK)
+				return(COMMONERR_FAILED);
 
-	for (index = 0; index < count; index++)
-		if (CMB_SPIWriteByte(spiSettings, *(addr + index),
-				     *(data + index)) != COMMONERR_OK)
+		return(COMMONERR_OK);
+	}
+
+	index = 0;
+	while (index < count) {
+		buf[0] = (uint8_t) ((addr[index] >> 8) & 0x7f);
+		buf[1] = (uint8_t) (addr[index] & 0xff);
+		len = 0;
+		do {
+			next = spiSettings->autoIncAddrUp ? addr[index] + 1 :
+			       addr[index] - 1;
+			buf[2 + len++] = data[index++];
+		} while ((index < count) && (addr[index] == next) &&
+			 (len < CMB_SPI_STREAM_MAX_BYTES));
+
+		if (CMB_SPITransfer(spiSettings, buf, 2 + len) != COMMONERR_OK)
 			return(COMMONERR_FAILED);
+	}
 
 	return(COMMONERR_OK);
 }
@@ -202,13 +243,12 @@ commonErr_t CMB_SPIReadByte(spiSettings_t *spiSettings, uint16_t addr,
 {
 	uint8_t buf[3];
 
-	spi_ad_desc->chip_select = spiSettings->chipSelectIndex - 1;
-
 	buf[0] = (uint8_t) ((addr >> 8) | 0x80);
 	buf[1] = (uint8_t) (addr & 0xff);
 	buf[2] = (uint8_t) 0x00;
 
-	spi_write_and_read(spi_ad_desc, buf, 3);
+	if (CMB_SPITransfer(spiSettings, buf, 3) != COMMONERR_OK)
+		return(COMMONERR_FAILED);
 	*readdata = buf[2];
 
 	return(COMMONERR_OK);
@@ -298,28 +338,32 @@ commonErr_t CMB_wait_us(uint32_t time_us)
 
 commonErr_t CMB_setTimeout_ms(uint32_t timeOut_ms)
 {
-#ifdef _XPARAMETERS_PS_H_
-	_desired_time_to_elapse_us = timeOut_ms * 1000;
-#else
-	_desired_time_to_elapse_us = timeOut_ms * 50;	// FIXME
-#endif
-
-	return(COMMONERR_OK);
+	return CMB_setTimeout_us(timeOut_ms * 1000);
 }
 
 commonErr_t CMB_setTimeout_us(uint32_t timeOut_us)
 {
-	_desired_time_to_elapse_us = timeOut_us;
+#ifdef ALTERA_PLATFORM
+	/* get_time_us() only counts whole ticks, never expire early */
+	timeOut_us += 1000000 / alt_ticks_per_second();
+#endif
+	deadline_set(&_timeout, timeOut_us);
 
 	return(COMMONERR_OK);
 }
 
+/*
+ * On MicroBlaze get_time_us() only advances with udelay() and mdelay(), so
+ * each check delays 1 us. The time spent in the checks and in the SPI
+ * transfers between them is not counted: there a deadline is a lower bound,
+ * it never expires early but may expire late.
+ */
 commonErr_t CMB_hasTimeoutExpired()
 {
+#if !defined(_XPARAMETERS_PS_H_) && !defined(ALTERA_PLATFORM)
 	udelay(1);
-
-	_desired_time_to_elapse_us--;
-	if (_desired_time_to_elapse_us > 0)
+#endif
+	if (!deadline_expired(&_timeout))
 		return(COMMONERR_OK);
 
 	return(COMMONERR_FAILED);
@@ -69,6 +69,7 @@ INCS += $(DRIVERS)/rf-transceiver/navassa/common/adi_error/adi_common_error_type
 SRCS += $(DRIVERS)/rf-transceiver/navassa/devices/adrv9001/private/src/adrv9001_validators.c \
 	$(DRIVERS)/rf-transceiver/navassa/devices/adrv9001/private/src/adrv9001_rx.c \
 	$(DRIVERS)/rf-transceiver/navassa/devices/adrv9001/private/src/adrv9001_crc32.c \
+	$(DRIVERS)/rf-transceiver/navassa/devices/adrv9001/private/src/adrv9001_binary.c \
 	$(DRIVERS)/rf-transceiver/navassa/devices/adrv9001/private/src/adrv9001_utilities.c \
 	$(DRIVERS)/rf-transceiver/navassa/devices/adrv9001/private/src/adrv9001_arm.c \
 	$(DRIVERS)/rf-transceiver/navassa/devices/adrv9001/private/src/adrv9001_bf_hal.c \
@@ -79,6 +80,7 @@ INCS += $(DRIVERS)/rf-transceiver/navassa/devices/adrv9001/private/include/adrv9
 	$(DRIVERS)/rf-transceiver/navassa/devices/adrv9001/private/include/adrv9001_arm.h \
 	$(DRIVERS)/rf-transceiver/navassa/devices/adrv9001/private/include/adrv9001_arm_macros.h \
 	$(DRIVERS)/rf-transceiver/navassa/devices/adrv9001/private/include/adrv9001_crc32.h \
+	$(DRIVERS)/rf-transceiver/navassa/devices/adrv9001/private/include/adrv9001_binary.h \
 	$(DRIVERS)/rf-transceiver/navassa/devices/adrv9001/private/include/adrv9001_gpio.h \
 	$(DRIVERS)/rf-transceiver/navassa/devices/adrv9001/private/include/adrv9001_init.h \
 	$(DRIVERS)/rf-transceiver/navassa/devices/adrv9001/private/include/adrv9001_init_types.h \
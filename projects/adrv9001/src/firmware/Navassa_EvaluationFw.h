@@ -39,7 +39,7 @@
 #ifndef NAVASSA_EVALUATIONFW_H
 #define NAVASSA_EVALUATIONFW_H
 
-unsigned char Navassa_EvaluationFw_bin[] = {
+const unsigned char Navassa_EvaluationFw_bin[] = {
 	0x28, 0x6a, 0x03, 0x20, 0xfd, 0xdd, 0x03, 0x01, 0x75, 0x8e, 0x00, 0x01,
 	0x75, 0x8e, 0x00, 0x01, 0x75, 0x8e, 0x00, 0x01, 0x75, 0x8e, 0x00, 0x01,
 	0x75, 0x8e, 0x00, 0x01, 0x75, 0x8e, 0x00, 0x01, 0x75, 0x8e, 0x00, 0x01,
@@ -119,6 +119,9 @@ extern int32_t(*adi_hal_ArmImagePageGet)(void *devHalCfg,
 extern int32_t(*adi_hal_StreamImagePageGet)(void *devHalCfg,
 		const char *streamImagePath, uint32_t pageIndex, uint32_t pageSize,
 		uint8_t *rdBuff);
+/* Optional, NULL when the ARM image is not memory mapped */
+extern int32_t(*adi_hal_ArmImageGet)(void *devHalCfg,
+				     const char *armImagePath, const uint8_t **image, uint32_t *size);
 extern int32_t(*adi_hal_RxGainTableEntryGet)(void *devHalCfg,
 		const char *rxGainTablePath, uint16_t lineCount, uint8_t *gainIndex,
 		uint8_t *rxFeGain, uint8_t *tiaControl, uint8_t *adcControl,
@@ -523,7 +523,7 @@ int32_t no_os_ssi_Reset(void* devHalCfg)
 int32_t no_os_ImagePageGet(void *devHalCfg, const char *ImagePath,
 			   uint32_t pageIndex, uint32_t pageSize, uint8_t *rdBuff)
 {
-	if ((pageIndex * pageSize) > sizeof(Navassa_EvaluationFw_bin))
+	if (((pageIndex + 1) * pageSize) > sizeof(Navassa_EvaluationFw_bin))
 		return -EINVAL;
 
 	memcpy(rdBuff, &Navassa_EvaluationFw_bin[pageIndex * pageSize], pageSize);
@@ -531,14 +531,52 @@ int32_t no_os_ImagePageGet(void *devHalCfg, const char *ImagePath,
 	return ADI_HAL_OK;
 }
 
+/**
+ * @brief Get the ARM image without copying it.
+ *
+ * The image is linked in as a constant array, so the ARM loader can send it
+ * to the device straight from where it is stored.
+ *
+ * @param devHalCfg Pointer to device instance specific platform settings
+ * @param ImagePath Name of the image (unused, there is a single image)
+ * @param image Returns the address of the image
+ * @param size Returns the size of the image in bytes
+ *
+ * @retval ADI_HAL_OK Function completed successfully
+ * @retval ADI_HAL_NULL_PTR The function has been called with a null pointer
+ */
+int32_t no_os_ArmImageGet(void *devHalCfg, const char *ImagePath,
+			  const uint8_t **image, uint32_t *size)
+{
+	if (!image || !size)
+		return ADI_HAL_NULL_PTR;
+
+	*image = Navassa_EvaluationFw_bin;
+	*size = sizeof(Navassa_EvaluationFw_bin);
+
+	return ADI_HAL_OK;
+}
+
 int32_t no_os_RxGainTableEntryGet(void *devHalCfg, const char *rxGainTablePath,
 				  uint16_t lineCount, uint8_t *gainIndex, uint8_t *rxFeGain,
 				  uint8_t *tiaControl, uint8_t *adcControl, uint8_t *extControl,
 				  uint16_t *phaseOffset, int16_t *digGain)
 {
+	/*
+	 * The loader reads rows until the gain index leaves the table range, so
+	 * past the last row report a zeroed one for it to stop on.
+	 */
+	*gainIndex = 0;
+	*rxFeGain = 0;
+	*tiaControl = 0;
+	*adcControl = 0;
+	*extControl = 0;
+	*phaseOffset = 0;
+	*digGain = 0;
+
 	if (!strcmp(rxGainTablePath, "RxGainTable.csv")) {
-		if (lineCount > sizeof(RxGainTable) / sizeof(struct RxGainTableEntry))
-			return -EINVAL;
+		if (lineCount >= sizeof(RxGainTable) / sizeof(struct RxGainTableEntry))
+			return 7;
 
 		*gainIndex = RxGainTable[lineCount].gainIndex;
 		*rxFeGain = RxGainTable[lineCount].rxFeGain;
@@ -548,8 +586,8 @@ int32_t no_os_RxGainTableEntryGet(void *devHalCfg, const char *rxGainTablePath,
 		*phaseOffset = RxGainTable[lineCount].phaseOffset;
 		*digGain = RxGainTable[lineCount].digGain;
 	} else if (!strcmp(rxGainTablePath, "ORxGainTable.csv")) {
-		if (lineCount > sizeof(ORxGainTable) / sizeof(struct ORxGainTableEntry))
-			return -EINVAL;
+		if (lineCount >= sizeof(ORxGainTable) / sizeof(struct ORxGainTableEntry))
+			return 7;
 
 		*gainIndex = ORxGainTable[lineCount].gainIndex;
 		*rxFeGain = ORxGainTable[lineCount].rxFeGain;
@@ -568,7 +606,7 @@ int32_t no_os_TxAttenTableEntryGet(void *devHalCfg,
 				   const char *txAttenTablePath, uint16_t lineCount, uint16_t *attenIndex,
 				   uint8_t *txAttenHp, uint16_t *txAttenMult)
 {
-	if (lineCount > sizeof(TxAttenTable) / sizeof(struct TxAttenTableEntry))
+	if (lineCount >= sizeof(TxAttenTable) / sizeof(struct TxAttenTableEntry))
 		return -EINVAL;
 
 	*attenIndex = TxAttenTable[lineCount].attenIndex;
@@ -622,6 +660,8 @@ int32_t(*adi_hal_ArmImagePageGet)(void *devHalCfg, const char *ImagePath,
 				  uint32_t pageIndex, uint32_t pageSize, uint8_t *rdBuff) = no_os_ImagePageGet;
 int32_t(*adi_hal_StreamImagePageGet)(void *devHalCfg, const char *ImagePath,
 				     uint32_t pageIndex, uint32_t pageSize, uint8_t *rdBuff) = no_os_ImagePageGet;
+int32_t(*adi_hal_ArmImageGet)(void *devHalCfg, const char *ImagePath,
+			      const uint8_t **image, uint32_t *size) = no_os_ArmImageGet;
 int32_t(*adi_hal_RxGainTableEntryGet)(void *devHalCfg,
 				      const char *rxGainTablePath, uint16_t lineCount, uint8_t *gainIndex,
 				      uint8_t *rxFeGain,
@@ -667,6 +707,7 @@ int32_t adi_hal_PlatformSetup(void *devHalInfo, adi_hal_Platforms_e platform)
 
 	adi_hal_ArmImagePageGet = no_os_ImagePageGet;
 	adi_hal_StreamImagePageGet = no_os_ImagePageGet;
+	adi_hal_ArmImageGet = no_os_ArmImageGet;
 	adi_hal_RxGainTableEntryGet = no_os_RxGainTableEntryGet;
 	adi_hal_TxAttenTableEntryGet = no_os_TxAttenTableEntryGet;
 
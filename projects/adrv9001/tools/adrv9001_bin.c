@@ -0,0 +1,360 @@
+/***************************************************************************//**
+ *   @file   adrv9001_bin.c
+ *   @brief  Host tool converting ADRV9001 profiles and tables to binaries.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/*
+ * Converts a JSON device profile, an Rx gain table csv or a Tx atten table
+ * csv into the binary format loaded by
+ * adi_adrv9001_Utilities_DeviceProfileBinary_Parse(),
+ * adi_adrv9001_Utilities_RxGainTableBinary_Load() and
+ * adi_adrv9001_Utilities_TxAttenTableBinary_Load().
+ *
+ * The text is parsed exactly like the API does it (same JSON parser macros,
+ * same csv row format), and the resulting structures are stored as they are
+ * in memory. The tool must therefore be built for the same ABI as the target
+ * (little endian, same structure alignment); the record size stored in the
+ * header rejects binaries built for a different layout.
+ *
+ * tests/host (adrv9001_table_load, adrv9001_profile_load) checks that loading
+ * the binaries writes the same registers and ARM memory as the text path.
+ *
+ * Build from the no-OS root directory:
+ *
+ * NAVASSA=drivers/rf-transceiver/navassa
+ * gcc -O2 -o adrv9001_bin projects/adrv9001/tools/adrv9001_bin.c \
+ *	$NAVASSA/devices/adrv9001/private/src/adrv9001_binary.c \
+ *	$NAVASSA/devices/adrv9001/private/src/adrv9001_crc32.c \
+ *	$NAVASSA/third_party/jsmn/jsmn.c \
+ *	-I$NAVASSA/common -I$NAVASSA/common/adi_error -I$NAVASSA/common/adi_hal \
+ *	-I$NAVASSA/common/adi_libc -I$NAVASSA/common/adi_logging \
+ *	-I$NAVASSA/devices/adrv9001/public/include \
+ *	-I$NAVASSA/devices/adrv9001/private/include \
+ *	-I$NAVASSA/third_party/jsmn -I$NAVASSA/third_party/adi_pmag_macros \
+ *	-Iprojects/adrv9001/src/hal
+ */
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include "jsmn.h"
+#include "adi_adrv9001_utilities_types.h"
+#include "adi_adrv9001_Init_t_parser.h"
+#include "adrv9001_binary.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define PARSING_BUFFER_SIZE	32
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+struct bin_records {
+	adi_adrv9001_BinaryType_e type;
+	uint32_t first_index;
+	uint32_t record_size;
+	uint32_t record_count;
+	uint32_t max_records;
+	/* Large enough for the profile or any of the tables */
+	union {
+		adi_adrv9001_Init_t init;
+		adi_adrv9001_RxGainTableRow_t rx[ADI_ADRV9001_RX_GAIN_TABLE_SIZE_ROWS];
+		adi_adrv9001_TxAttenTableRow_t tx[ADI_ADRV9001_TX_ATTEN_TABLE_SIZE_ROWS];
+	} data;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static int file_read(const char *path, char **buff, uint32_t *len)
+{
+	FILE *f;
+	long size;
+	int ret = 0;
+
+	f = fopen(path, "rb");
+	if (!f)
+		return -errno;
+
+	if (fseek(f, 0, SEEK_END) || (size = ftell(f)) < 0 ||
+	    fseek(f, 0, SEEK_SET)) {
+		ret = -EIO;
+		goto close;
+	}
+
+	*buff = calloc(1, size + 1);
+	if (!*buff) {
+		ret = -ENOMEM;
+		goto close;
+	}
+
+	if (fread(*buff, 1, size, f) != (size_t)size) {
+		free(*buff);
+		ret = -EIO;
+		goto close;
+	}
+	*len = size;
+close:
+	fclose(f);
+
+	return ret;
+}
+
+/* Same steps as adi_adrv9001_Utilities_DeviceProfile_Parse() */
+static int profile_parse(char *json, uint32_t len, struct bin_records *r)
+{
+	char parsingBuffer[PARSING_BUFFER_SIZE];
+	jsmn_parser parser;
+	jsmntok_t *tokens;
+	int16_t numTokens;
+	uint16_t ii;
+
+	memset(r, 0, sizeof(*r));
+	r->type = ADI_ADRV9001_BINARY_TYPE_PROFILE;
+	r->record_size = sizeof(r->data.init);
+	r->record_count = 1;
+	r->max_records = 1;
+
+	jsmn_init(&parser);
+	numTokens = jsmn_parse(&parser, json, len, NULL, 0);
+	if (numTokens < 1)
+		return -EINVAL;
+
+	/* The parser macros look one token past the last one, keep a sentinel there */
+	tokens = calloc(numTokens + 1, sizeof(*tokens));
+	if (!tokens)
+		return -ENOMEM;
+	tokens[numTokens].start = INT_MAX;
+
+	jsmn_init(&parser);
+	numTokens = jsmn_parse(&parser, json, len, tokens, numTokens);
+	if (numTokens < 1 || tokens[0].type != JSMN_OBJECT) {
+		free(tokens);
+		return -EINVAL;
+	}
+
+	for (ii = 1; ii < numTokens; ii++) {
+		ADRV9001_INIT_T(tokens, ii, json, parsingBuffer, r->data.init);
+	}
+
+	free(tokens);
+
+	return 0;
+}
+
+/* Returns the next line of a nul terminated text and advances past it. */
+static char *line_next(char **text)
+{
+	char *line = *text;
+	char *end;
+
+	if (!*line)
+		return NULL;
+
+	end = strchr(line, '\n');
+	if (end) {
+		*end = '\0';
+		*text = end + 1;
+	} else {
+		*text = line + strlen(line);
+	}
+
+	return line;
+}
+
+/* Same row format and checks as adi_adrv9001_Utilities_RxGainTable_Load() */
+static int rx_gain_parse(char *csv, uint32_t len, struct bin_records *r)
+{
+	uint8_t gain_index, prev_index = 0, tia, adc;
+	adi_adrv9001_RxGainTableRow_t *row;
+	char *text = csv;
+	char *line;
+
+	memset(r, 0, sizeof(*r));
+	r->type = ADI_ADRV9001_BINARY_TYPE_RX_GAIN_TABLE;
+	r->record_size = sizeof(r->data.rx[0]);
+	r->max_records = ADI_ADRV9001_RX_GAIN_TABLE_SIZE_ROWS;
+
+	/* Header line */
+	line = line_next(&text);
+	if (!line || !strstr(line, "Gain Index") || !strstr(line, "Digital Gain"))
+		return -EINVAL;
+
+	while ((line = line_next(&text)) && r->record_count < r->max_records) {
+		row = &r->data.rx[r->record_count];
+		if (sscanf(line, "%hhu,%hhu,%hhu,%hhu,%hhu,%hu,%hd", &gain_index,
+			   &row->rxFeGain, &tia, &adc, &row->extControl,
+			   &row->phaseOffset, &row->digGain) != 7)
+			return -EINVAL;
+
+		row->adcTiaGain = (adc << 1) | tia;
+
+		if (!r->record_count)
+			r->first_index = gain_index;
+		else if (prev_index != (uint8_t)(gain_index - 1))
+			return -EINVAL;
+
+		prev_index = gain_index;
+		r->record_count++;
+	}
+
+	return r->record_count ? 0 : -EINVAL;
+}
+
+/* Same row format and checks as adi_adrv9001_Utilities_TxAttenTable_Load() */
+static int tx_atten_parse(char *csv, uint32_t len, struct bin_records *r)
+{
+	uint16_t atten_index, prev_index = 0;
+	adi_adrv9001_TxAttenTableRow_t *row;
+	char *text = csv;
+	char *line;
+
+	memset(r, 0, sizeof(*r));
+	r->type = ADI_ADRV9001_BINARY_TYPE_TX_ATTEN_TABLE;
+	r->record_size = sizeof(r->data.tx[0]);
+	r->max_records = ADI_ADRV9001_TX_ATTEN_TABLE_SIZE_ROWS;
+
+	line = line_next(&text);
+	if (!line || !strstr(line, "Tx Atten Index") || !strstr(line, "Tx Atten Mult"))
+		return -EINVAL;
+
+	while ((line = line_next(&text)) && r->record_count < r->max_records) {
+		row = &r->data.tx[r->record_count];
+		if (sscanf(line, "%hu,%hhu,%hu", &atten_index, &row->txAttenHp,
+			   &row->txAttenMult) != 3)
+			return -EINVAL;
+
+		if (!r->record_count)
+			r->first_index = atten_index;
+		else if (prev_index != (uint16_t)(atten_index - 1))
+			return -EINVAL;
+
+		prev_index = atten_index;
+		r->record_count++;
+	}
+
+	return r->record_count ? 0 : -EINVAL;
+}
+
+static void usage(const char *name)
+{
+	fprintf(stderr,
+		"usage: %s profile|rxgain|txatten <input> <output>\n",
+		name);
+}
+
+int main(int argc, char **argv)
+{
+	int (*parse)(char *, uint32_t, struct bin_records *);
+	adi_adrv9001_BinaryHeader_t *header;
+	struct bin_records *r;
+	uint32_t text_len = 0, bin_len;
+	uint8_t *bin = NULL;
+	char *text = NULL;
+	FILE *f;
+	int ret;
+
+	if (argc != 4) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (!strcmp(argv[1], "profile"))
+		parse = profile_parse;
+	else if (!strcmp(argv[1], "rxgain"))
+		parse = rx_gain_parse;
+	else if (!strcmp(argv[1], "txatten"))
+		parse = tx_atten_parse;
+	else {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	r = calloc(1, sizeof(*r));
+	if (!r)
+		return EXIT_FAILURE;
+
+	ret = file_read(argv[2], &text, &text_len);
+	if (ret) {
+		fprintf(stderr, "%s: %s\n", argv[2], strerror(-ret));
+		goto free;
+	}
+
+	ret = parse(text, text_len, r);
+	if (ret) {
+		fprintf(stderr, "%s: parsing failed\n", argv[2]);
+		goto free;
+	}
+
+	bin_len = sizeof(*header) + r->record_size * r->record_count;
+	bin = calloc(1, bin_len);
+	if (!bin) {
+		ret = -ENOMEM;
+		goto free;
+	}
+
+	header = (adi_adrv9001_BinaryHeader_t *)bin;
+	memcpy(&bin[sizeof(*header)], &r->data, bin_len - sizeof(*header));
+	adrv9001_Binary_HeaderFill(header, r->type, r->first_index,
+				   &bin[sizeof(*header)], r->record_size,
+				   r->record_count);
+
+	f = fopen(argv[3], "wb");
+	if (!f || fwrite(bin, 1, bin_len, f) != bin_len) {
+		fprintf(stderr, "%s: write failed\n", argv[3]);
+		ret = -EIO;
+		if (f)
+			fclose(f);
+		goto free;
+	}
+	fclose(f);
+
+	printf("%s: %u record(s) of %u bytes, first index %u\n", argv[3],
+	       r->record_count, r->record_size, r->first_index);
+free:
+	free(bin);
+	free(text);
+	free(r);
+
+	return ret ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -3,6 +3,7 @@
 SRC_DIRS += $(PROJECT)/src
 SRC_DIRS += $(DRIVERS)/gyro/adxrs290 
 SRC_DIRS += $(NO-OS)/iio/iio_adxrs290 
+SRC_DIRS += $(NO-OS)/iio/iio_trig_buf
 
 # For the moment there is support only for aducm for iio with network backend
 ifeq (aducm3029,$(strip $(PLATFORM)))
@@ -12,9 +13,6 @@ endif
 ifeq (y,$(strip $(ENABLE_IIO_NETWORK)))
 DISABLE_SECURE_SOCKET ?= y
 SRC_DIRS += $(NO-OS)/network
-SRCS	 += $(NO-OS)/util/circular_buffer.c
-SRCS	 += $(PLATFORM_DRIVERS)/delay.c
-SRCS	 += $(PLATFORM_DRIVERS)/timer.c
 endif
 
 
@@ -27,6 +25,10 @@ SRCS += $(PLATFORM_DRIVERS)/uart.c					\
 	$(NO-OS)/util/list.c						\
 	$(NO-OS)/util/fifo.c						\
 	$(NO-OS)/util/util.c						\
+	$(NO-OS)/util/circular_buffer.c					\
+	$(NO-OS)/util/deadline.c					\
+	$(PLATFORM_DRIVERS)/delay.c					\
+	$(PLATFORM_DRIVERS)/timer.c					\
 
 INCS += $(INCLUDE)/xml.h						\
 	$(INCLUDE)/fifo.h						\
@@ -34,6 +36,10 @@ INCS += $(INCLUDE)/xml.h						\
 	$(INCLUDE)/uart.h						\
 	$(INCLUDE)/list.h						\
 	$(INCLUDE)/util.h						\
+	$(INCLUDE)/circular_buffer.h					\
+	$(INCLUDE)/deadline.h						\
+	$(INCLUDE)/delay.h						\
+	$(INCLUDE)/timer.h						\
 	$(INCLUDE)/error.h						\
 	$(INCLUDE)/spi.h						\
 	$(PLATFORM_DRIVERS)/spi_extra.h					\
@@ -69,6 +69,14 @@
 
 #endif
 
+/* Buffer used by the iio server for the buffered capture. */
+static uint8_t in_buff[MAX_SIZE_BASE_ADDR];
+
+static struct iio_data_buffer read_buff = {
+	.buff = in_buff,
+	.size = MAX_SIZE_BASE_ADDR
+};
+
 int32_t platform_init()
 {
 #ifdef ADUCM_PLATFORM
@@ -94,6 +102,10 @@ int main(void)
 
 	struct adxrs290_dev *adxrs290_device;
 
+	/* iio interface of the adxrs290 */
+	struct iio_adxrs290_desc *iio_adxrs290;
+	struct iio_device *adxrs290_dev_desc;
+
 	/* iio descriptor. */
 	struct iio_desc  *iio_desc;
 
@@ -174,6 +186,7 @@ int main(void)
 	wifi_param.uart_irq_conf = uart_desc;
 #endif //ADUCM_PLATFORM
 	wifi_param.uart_irq_id = UART_IRQ_ID;
+	wifi_param.buffered_send = true;
 
 	status = wifi_init(&wifi, &wifi_param);
 	if (status < 0)
@@ -221,8 +234,27 @@ int main(void)
 	if(status < 0)
 		return status;
 
-	status = iio_register(iio_desc, &adxrs290_iio_descriptor,
-			      "adxrs290", adxrs290_device, NULL, NULL);
+	/* Capture a sample on every data ready pulse of the SYNC pin. */
+	struct iio_adxrs290_init_param iio_adxrs290_param = {
+		.dev = adxrs290_device,
+		.trig_buf_param = {
+			.buf_samples = ADXRS290_BUF_SAMPLES,
+			.timeout_us = ADXRS290_BUF_TIMEOUT_US,
+			.irq_ctrl = irq_desc,
+			.irq_id = ADXRS290_DRDY_IRQ_ID,
+			.irq_config = (void *)IRQ_RISING_EDGE
+		},
+		.data_ready = true
+	};
+
+	status = iio_adxrs290_init(&iio_adxrs290, &iio_adxrs290_param);
+	if (status < 0)
+		return status;
+
+	iio_adxrs290_get_dev_descriptor(iio_adxrs290, &adxrs290_dev_desc);
+
+	status = iio_register(iio_desc, adxrs290_dev_desc,
+			      "adxrs290", iio_adxrs290, &read_buff, NULL);
 	if (status < 0)
 		return status;
 
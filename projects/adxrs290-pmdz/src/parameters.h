@@ -57,9 +57,16 @@
 #define INTC_DEVICE_ID	0
 #define UART_IRQ_ID		ADUCM_UART_INT_ID
 #define UART_BAUDRATE	115200
+/* Data ready output of the ADXRS290 (SYNC pin), wired to XINT0 (GPIO 15) */
+#define ADXRS290_DRDY_IRQ_ID	ADUCM_EXTERNAL_INT0_ID
 
 #endif //ADUCM_PLATFORM
 
+/* Capacity of the sample ring buffer, in samples */
+#define ADXRS290_BUF_SAMPLES	256
+/* Longest wait for the next sample of a buffered capture */
+#define ADXRS290_BUF_TIMEOUT_US	100000
+
 #ifdef USE_TCP_SOCKET
 #define WIFI_SSID	"RouterSSID"
 #define WIFI_PWD	"******"
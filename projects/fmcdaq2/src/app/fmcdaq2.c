@@ -69,6 +69,7 @@
 #include "axi_dmac.h"
 #include "axi_jesd204_tx.h"
 #include "axi_jesd204_rx.h"
+#include "jesd204_topology.h"
 
 #ifdef IIO_SUPPORT
 #include "app_iio.h"
@@ -98,6 +99,8 @@ struct fmcdaq2_dev {
 
 	struct axi_dmac *ad9144_dmac;
 	struct axi_dmac *ad9680_dmac;
+
+	struct jesd204_topo *topo;
 } fmcdaq2;
 
 struct fmcdaq2_init_param {
@@ -401,7 +404,7 @@ static int fmcdaq2_jesd_init(struct fmcdaq2_init_param *dev_init)
 	return SUCCESS;
 }
 
-static int fmcdaq2_altera_pll_setup()
+static int fmcdaq2_altera_pll_setup(struct fmcdaq2_init_param *dev_init)
 {
 #ifdef ALTERA_PLATFORM
 	int status;
@@ -442,7 +445,7 @@ static int fmcdaq2_altera_pll_setup()
 	altera_a10_fpll_enable(ad9680_device_clk_pll);
 	altera_a10_fpll_disable(ad9144_device_clk_pll);
 	status = altera_a10_fpll_set_rate(ad9144_device_clk_pll,
-					  fmcdaq2_init.ad9144_jesd_param.device_clk_khz * 1000);
+					  dev_init->ad9144_jesd_param.device_clk_khz * 1000);
 	if (status != SUCCESS) {
 		printf("error: %s: altera_a10_fpll_set_rate() failed\n",
 		       ad9144_device_clk_pll->name);
@@ -459,17 +462,6 @@ static int fmcdaq2_trasnceiver_setup(struct fmcdaq2_dev *dev,
 {
 	int status;
 
-	status = axi_jesd204_tx_init(&dev->ad9144_jesd, &dev_init->ad9144_jesd_param);
-	if (status != SUCCESS) {
-		printf("error: %s: axi_jesd204_tx_init() failed\n", dev->ad9144_jesd->name);
-	}
-
-	status = axi_jesd204_tx_lane_clk_enable(dev->ad9144_jesd);
-	if (status != SUCCESS) {
-		printf("error: %s: axi_jesd204_tx_lane_clk_enable() failed\n",
-		       dev->ad9144_jesd->name);
-	}
-
 	status = adxcvr_init(&dev->ad9144_xcvr, &dev_init->ad9144_xcvr_param);
 	if (status != SUCCESS) {
 		printf("error: %s: adxcvr_init() failed\n", dev->ad9144_xcvr->name);
@@ -495,35 +487,225 @@ static int fmcdaq2_trasnceiver_setup(struct fmcdaq2_dev *dev,
 		printf("error: %s: axi_jesd204_rx_init() failed\n", dev->ad9680_jesd->name);
 	}
 
-	status = axi_jesd204_rx_lane_clk_enable(dev->ad9680_jesd);
-	if (status != SUCCESS) {
-		printf("error: %s: axi_jesd204_rx_lane_clk_enable() failed\n",
-		       dev->ad9680_jesd->name);
-	}
-
 	return status;
 }
 
+/* Link IDs used by the bring-up topology */
+#define FMCDAQ2_ADC_LINK	1
+#define FMCDAQ2_DAC_LINK	2
+/* Link status reported by the AXI JESD204 cores once the link carries data */
+#define FMCDAQ2_JESD_LINK_DATA	3
 
-static int fmcdaq2_test(struct fmcdaq2_dev *dev,
-			struct fmcdaq2_init_param *dev_init)
+/* Parameter of the stage callbacks, set by fmcdaq2_setup() */
+struct fmcdaq2_topo_ctx {
+	struct fmcdaq2_dev *dev;
+	struct fmcdaq2_init_param *dev_init;
+	bool tx_link_disabled;
+} fmcdaq2_topo_ctx;
+
+static int32_t fmcdaq2_ad9523_clocks(void *ctx)
 {
-	int status;
+	struct fmcdaq2_topo_ctx *c = ctx;
 
-	status = axi_jesd204_rx_status_read(dev->ad9680_jesd);
-	if (status != SUCCESS) {
-		printf("axi_jesd204_rx_status_read() error: %"PRIi32"\n", status);
-	}
+	return ad9523_setup(&c->dev->ad9523_device, &c->dev_init->ad9523_param);
+}
+
+static int32_t fmcdaq2_fpga_clocks(void *ctx)
+{
+	struct fmcdaq2_topo_ctx *c = ctx;
+
+	return fmcdaq2_altera_pll_setup(c->dev_init);
+}
+
+static int32_t fmcdaq2_ad9680_link_setup(void *ctx)
+{
+	struct fmcdaq2_topo_ctx *c = ctx;
 
-	status = axi_jesd204_tx_status_read(dev->ad9144_jesd);
+	return ad9680_setup(&c->dev->ad9680_device, &c->dev_init->ad9680_param);
+}
+
+static int32_t fmcdaq2_tx_link_setup(void *ctx)
+{
+	struct fmcdaq2_topo_ctx *c = ctx;
+	struct fmcdaq2_dev *d = c->dev;
+	int32_t status;
+
+	status = axi_jesd204_tx_init(&d->ad9144_jesd,
+				     &c->dev_init->ad9144_jesd_param);
 	if (status != SUCCESS) {
-		printf("axi_jesd204_tx_status_read() error: %"PRIi32"\n", status);
+		printf("error: %s: axi_jesd204_tx_init() failed\n",
+		       c->dev_init->ad9144_jesd_param.name);
+		return status;
 	}
 
-	status = ad9144_status(dev->ad9144_device);
-	if (status == FAILURE)
-		return status;
+	c->tx_link_disabled = false;
+
+	return axi_jesd204_tx_lane_clk_enable(d->ad9144_jesd);
+}
+
+static int32_t fmcdaq2_xcvr_link_setup(void *ctx)
+{
+	struct fmcdaq2_topo_ctx *c = ctx;
+
+	return fmcdaq2_trasnceiver_setup(c->dev, c->dev_init);
+}
 
+static int32_t fmcdaq2_ad9144_link_setup(void *ctx)
+{
+	struct fmcdaq2_topo_ctx *c = ctx;
+
+	return ad9144_setup(&c->dev->ad9144_device, &c->dev_init->ad9144_param);
+}
+
+/* The lane clocks are only enabled here, retries go through link_disable */
+static int32_t fmcdaq2_rx_link_enable(void *ctx)
+{
+	struct fmcdaq2_topo_ctx *c = ctx;
+
+	return axi_jesd204_rx_lane_clk_enable(c->dev->ad9680_jesd);
+}
+
+static int32_t fmcdaq2_rx_link_disable(void *ctx)
+{
+	struct fmcdaq2_topo_ctx *c = ctx;
+
+	return axi_jesd204_rx_lane_clk_disable(c->dev->ad9680_jesd);
+}
+
+/* The TX link layer is enabled in LINK_SETUP, here only after link_disable */
+static int32_t fmcdaq2_tx_link_enable(void *ctx)
+{
+	struct fmcdaq2_topo_ctx *c = ctx;
+
+	if (!c->tx_link_disabled)
+		return SUCCESS;
+
+	c->tx_link_disabled = false;
+
+	return axi_jesd204_tx_lane_clk_enable(c->dev->ad9144_jesd);
+}
+
+static int32_t fmcdaq2_tx_link_disable(void *ctx)
+{
+	struct fmcdaq2_topo_ctx *c = ctx;
+
+	c->tx_link_disabled = true;
+
+	return axi_jesd204_tx_lane_clk_disable(c->dev->ad9144_jesd);
+}
+
+static int32_t fmcdaq2_rx_link_status(void *ctx)
+{
+	struct fmcdaq2_topo_ctx *c = ctx;
+	struct fmcdaq2_dev *d = c->dev;
+	uint32_t link_status;
+	bool enabled;
+
+	axi_jesd204_rx_link_status_get(d->ad9680_jesd, &enabled, &link_status);
+	if (!enabled || link_status != FMCDAQ2_JESD_LINK_DATA)
+		return JESD204_TOPO_PENDING;
+
+	return axi_jesd204_rx_status_read(d->ad9680_jesd);
+}
+
+static int32_t fmcdaq2_tx_link_status(void *ctx)
+{
+	struct fmcdaq2_topo_ctx *c = ctx;
+	struct fmcdaq2_dev *d = c->dev;
+	uint32_t link_status;
+	bool enabled;
+
+	axi_jesd204_tx_link_status_get(d->ad9144_jesd, &enabled, &link_status);
+	if (!enabled || link_status != FMCDAQ2_JESD_LINK_DATA)
+		return JESD204_TOPO_PENDING;
+
+	return axi_jesd204_tx_status_read(d->ad9144_jesd);
+}
+
+static int32_t fmcdaq2_ad9144_status(void *ctx)
+{
+	struct fmcdaq2_topo_ctx *c = ctx;
+	struct fmcdaq2_dev *d = c->dev;
+	uint32_t link_status;
+	bool enabled;
+
+	/* The DAC sync flags are only meaningful once the link is in DATA */
+	axi_jesd204_tx_link_status_get(d->ad9144_jesd, &enabled, &link_status);
+	if (!enabled || link_status != FMCDAQ2_JESD_LINK_DATA)
+		return JESD204_TOPO_PENDING;
+
+	return ad9144_status(d->ad9144_device);
+}
+
+/*
+ * Recommended DAC JESD204 link startup sequence
+ *   1. FPGA JESD204 Link Layer
+ *   2. FPGA JESD204 PHY Layer
+ *   3. DAC
+ *
+ * Recommended ADC JESD204 link startup sequence
+ *   1. ADC
+ *   2. FPGA JESD204 PHY Layer
+ *   2. FPGA JESD204 Link Layer
+ *
+ * Both sequences are interleaved in the LINK_SETUP stage so that the
+ * transceivers which might be shared between the DAC and ADC link are
+ * enabled at the same time: the ADC and the TX link layer come first, then
+ * the PHY, then the DAC. The RX link layer is enabled in LINK_ENABLE. The
+ * link status of both links is then polled together and only a link that
+ * does not come up is restarted.
+ */
+static struct jesd204_topo_dev fmcdaq2_topo_devs[] = {
+	{
+		.name = "ad9523",
+		.dev = &fmcdaq2_topo_ctx,
+		.stage[JESD204_TOPO_STAGE_CLOCKS] = fmcdaq2_ad9523_clocks,
+	},
+	{
+		.name = "fpga_pll",
+		.dev = &fmcdaq2_topo_ctx,
+		.stage[JESD204_TOPO_STAGE_CLOCKS] = fmcdaq2_fpga_clocks,
+	},
+	{
+		.name = "ad9680",
+		.dev = &fmcdaq2_topo_ctx,
+		.stage[JESD204_TOPO_STAGE_LINK_SETUP] = fmcdaq2_ad9680_link_setup,
+		.link_id = FMCDAQ2_ADC_LINK,
+	},
+	{
+		.name = "ad9144_jesd",
+		.dev = &fmcdaq2_topo_ctx,
+		.stage[JESD204_TOPO_STAGE_LINK_SETUP] = fmcdaq2_tx_link_setup,
+		.stage[JESD204_TOPO_STAGE_LINK_ENABLE] = fmcdaq2_tx_link_enable,
+		.stage[JESD204_TOPO_STAGE_STATUS] = fmcdaq2_tx_link_status,
+		.link_disable = fmcdaq2_tx_link_disable,
+		.link_id = FMCDAQ2_DAC_LINK,
+	},
+	{
+		.name = "fpga_xcvr",
+		.dev = &fmcdaq2_topo_ctx,
+		.stage[JESD204_TOPO_STAGE_LINK_SETUP] = fmcdaq2_xcvr_link_setup,
+	},
+	{
+		.name = "ad9144",
+		.dev = &fmcdaq2_topo_ctx,
+		.stage[JESD204_TOPO_STAGE_LINK_SETUP] = fmcdaq2_ad9144_link_setup,
+		.stage[JESD204_TOPO_STAGE_STATUS] = fmcdaq2_ad9144_status,
+		.link_id = FMCDAQ2_DAC_LINK,
+	},
+	{
+		.name = "ad9680_jesd",
+		.dev = &fmcdaq2_topo_ctx,
+		.stage[JESD204_TOPO_STAGE_LINK_ENABLE] = fmcdaq2_rx_link_enable,
+		.stage[JESD204_TOPO_STAGE_STATUS] = fmcdaq2_rx_link_status,
+		.link_disable = fmcdaq2_rx_link_disable,
+		.link_id = FMCDAQ2_ADC_LINK,
+	},
+};
+
+static int fmcdaq2_test(struct fmcdaq2_dev *dev,
+			struct fmcdaq2_init_param *dev_init)
+{
 	/* transport path testing */
 	dev->ad9144_channels[0].sel = AXI_DAC_DATA_SEL_SED;
 	dev->ad9144_channels[1].sel = AXI_DAC_DATA_SEL_SED;
@@ -674,6 +856,8 @@ static void fmcdaq2_remove(struct fmcdaq2_dev *dev)
 	gpio_remove(dev->gpio_dac_reset);
 	gpio_remove(dev->gpio_dac_txen);
 	gpio_remove(dev->gpio_adc_pd);
+
+	jesd204_topo_remove(dev->topo);
 }
 
 int fmcdaq2_reconfig(struct ad9144_init_param *p_ad9144_param,
@@ -855,6 +1039,14 @@ int fmcdaq2_reconfig(struct ad9144_init_param *p_ad9144_param,
 static int fmcdaq2_setup(struct fmcdaq2_dev *dev,
 			 struct fmcdaq2_init_param *dev_init)
 {
+	struct jesd204_topo_init topo_init = {
+		.devs = fmcdaq2_topo_devs,
+		.num_devs = ARRAY_SIZE(fmcdaq2_topo_devs),
+		.poll_us = 1000,
+		.timeout_us = 100000,
+		.max_retries = 3,
+		.get_time_us = get_time_us,
+	};
 	int status;
 
 	status = fmcdaq2_gpio_init(dev);
@@ -897,7 +1089,7 @@ static int fmcdaq2_setup(struct fmcdaq2_dev *dev,
 			 &dev_init->ad9680_xcvr_param,
 			 dev_init->ad9523_param.pdata);
 
-	status = fmcdaq2_dac_init(&fmcdaq2, &fmcdaq2_init);
+	status = fmcdaq2_dac_init(dev, dev_init);
 	if (status < 0)
 		return status;
 
@@ -907,41 +1099,16 @@ static int fmcdaq2_setup(struct fmcdaq2_dev *dev,
 	dev_init->ad9680_jesd_param.lane_clk_khz =
 		dev_init->ad9680_xcvr_param.lane_rate_khz;
 
-
-	/* setup clocks */
-	status = ad9523_setup(&dev->ad9523_device, &dev_init->ad9523_param);
-	if (status != SUCCESS) {
-		printf("error: ad9523_setup() failed\n");
-	}
-	// Recommended DAC JESD204 link startup sequence
-	//   1. FPGA JESD204 Link Layer
-	//   2. FPGA JESD204 PHY Layer
-	//   3. DAC
-	//
-	// Recommended ADC JESD204 link startup sequence
-	//   1. ADC
-	//   2. FPGA JESD204 PHY Layer
-	//   2. FPGA JESD204 Link Layer
-	//
-	// Both sequences are interleaved here so that the transceivers which might
-	// be shared between the DAC and ADC link are enabled at the same time.
-
-	status = fmcdaq2_altera_pll_setup();
+	fmcdaq2_topo_ctx.dev = dev;
+	fmcdaq2_topo_ctx.dev_init = dev_init;
+	status = jesd204_topo_init(&dev->topo, &topo_init);
 	if (status != SUCCESS)
 		return status;
 
-	status = ad9680_setup(&dev->ad9680_device, &dev_init->ad9680_param);
+	status = jesd204_topo_run(dev->topo);
 	if (status != SUCCESS) {
-		printf("error: ad9680_setup() failed\n");
-	}
-
-	status = fmcdaq2_trasnceiver_setup(&fmcdaq2, &fmcdaq2_init);
-	if (status != SUCCESS)
+		printf("error: jesd204 bring-up failed\n");
 		return status;
-
-	status = ad9144_setup(&dev->ad9144_device, &dev_init->ad9144_param);
-	if (status != SUCCESS) {
-		printf("error: ad9144_setup() failed\n");
 	}
 
 	status = axi_adc_init(&dev->ad9680_core,  &dev_init->ad9680_core_param);
@@ -954,7 +1121,7 @@ static int fmcdaq2_setup(struct fmcdaq2_dev *dev,
 		printf("axi_dac_init() error: %s\n", dev->ad9144_core->name);
 	}
 
-	return fmcdaq2_test(&fmcdaq2, &fmcdaq2_init);
+	return fmcdaq2_test(dev, dev_init);
 }
 
 int main(void)
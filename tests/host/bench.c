@@ -0,0 +1,388 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench.c
+ *   @brief  Host benchmark runner.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_stats
+ * @brief Timing and counters of a finished case.
+ */
+struct bench_stats {
+	/** Case */
+	const struct bench_case *bc;
+	/** 0, BENCH_SKIP or the negative error code of the case */
+	int32_t status;
+	/** Number of iterations run */
+	uint32_t iterations;
+	/** Fastest iteration */
+	uint64_t min_ns;
+	/** Slowest iteration */
+	uint64_t max_ns;
+	/** All the iterations */
+	uint64_t total_ns;
+	/** Counters of the last iteration */
+	struct bench_result res;
+};
+
+/******************************************************************************/
+/************************ Variable Definitions ********************************/
+/******************************************************************************/
+
+extern const struct bench_case bench_ad9361_init;
+extern const struct bench_case bench_iio_ad9361_attr;
+extern const struct bench_case bench_axi_dmac_transfer;
+extern const struct bench_case bench_spi_engine_transfer;
+extern const struct bench_case bench_iio_axi_adc_read;
+extern const struct bench_case bench_ad77681_unpack;
+extern const struct bench_case bench_gpiochip_toggle;
+extern const struct bench_case bench_gpiochip_bulk_toggle;
+extern const struct bench_case bench_gpio_sysfs_toggle;
+extern const struct bench_case bench_uart_pl_polled;
+extern const struct bench_case bench_uart_pl_irq;
+extern const struct bench_case bench_i2c_write_no_stop;
+extern const struct bench_case bench_i2c_write_read;
+extern const struct bench_case bench_adxrs290_capture;
+extern const struct bench_case bench_ad9371_write_bytes;
+extern const struct bench_case bench_ad9371_timeout;
+extern const struct bench_case bench_ad7616_serial_capture;
+extern const struct bench_case bench_ad7616_parallel_capture;
+extern const struct bench_case bench_ad7616_serial_stream;
+extern const struct bench_case bench_ad7616_parallel_stream;
+extern const struct bench_case bench_ad5933_sweep_blocking;
+extern const struct bench_case bench_ad5933_sweep_poll;
+extern const struct bench_case bench_ad9144_bringup;
+extern const struct bench_case bench_ad9144_pll_error;
+extern const struct bench_case bench_adpd410x_fifo_read;
+extern const struct bench_case bench_adrv9001_init_analog;
+extern const struct bench_case bench_adrv9001_ssi_delay;
+extern const struct bench_case bench_adrv9001_table_load;
+extern const struct bench_case bench_adrv9001_profile_load;
+extern const struct bench_case bench_mqtt_telemetry_qos1;
+extern const struct bench_case bench_wifi_sendbuf;
+extern const struct bench_case bench_wifi_send_fallback;
+extern const struct bench_case bench_tls_full_handshake;
+extern const struct bench_case bench_tls_resumed_handshake;
+extern const struct bench_case bench_clk_tree_rates;
+extern const struct bench_case bench_clk_divider_solve;
+
+static const struct bench_case *bench_cases[] = {
+	&bench_ad9361_init,
+	&bench_iio_ad9361_attr,
+	&bench_axi_dmac_transfer,
+	&bench_spi_engine_transfer,
+	&bench_iio_axi_adc_read,
+	&bench_ad77681_unpack,
+	&bench_gpiochip_toggle,
+	&bench_gpiochip_bulk_toggle,
+	&bench_gpio_sysfs_toggle,
+	&bench_uart_pl_polled,
+	&bench_uart_pl_irq,
+	&bench_i2c_write_no_stop,
+	&bench_i2c_write_read,
+	&bench_adxrs290_capture,
+	&bench_ad9371_write_bytes,
+	&bench_ad9371_timeout,
+	&bench_ad7616_serial_capture,
+	&bench_ad7616_parallel_capture,
+	&bench_ad7616_serial_stream,
+	&bench_ad7616_parallel_stream,
+	&bench_ad5933_sweep_blocking,
+	&bench_ad5933_sweep_poll,
+	&bench_ad9144_bringup,
+	&bench_ad9144_pll_error,
+	&bench_adpd410x_fifo_read,
+	&bench_adrv9001_init_analog,
+	&bench_adrv9001_ssi_delay,
+	&bench_adrv9001_table_load,
+	&bench_adrv9001_profile_load,
+	&bench_mqtt_telemetry_qos1,
+	&bench_wifi_sendbuf,
+	&bench_wifi_send_fallback,
+	&bench_tls_full_handshake,
+	&bench_tls_resumed_handshake,
+	&bench_clk_tree_rates,
+	&bench_clk_divider_solve,
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Report a counter. Reporting the same name again replaces its value.
+ * @param res - Results of the current iteration.
+ * @param name - Counter name, must stay valid until the results are written.
+ * @param value - Counter value.
+ */
+void bench_counter(struct bench_result *res, const char *name, uint64_t value)
+{
+	uint32_t i;
+
+	for (i = 0; i < res->nb_counters; i++) {
+		if (!strcmp(res->counters[i].name, name)) {
+			res->counters[i].value = value;
+			return;
+		}
+	}
+
+	if (res->nb_counters == BENCH_MAX_COUNTERS) {
+		fprintf(stderr, "bench: too many counters, %s dropped\n", name);
+		return;
+	}
+
+	res->counters[res->nb_counters].name = name;
+	res->counters[res->nb_counters].value = value;
+	res->nb_counters++;
+}
+
+/**
+ * @brief Monotonic time in nanoseconds.
+ * @return The time.
+ */
+uint64_t bench_time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+ * @brief Run a case.
+ * @param bc - The case.
+ * @param st - Where the timing and the counters are stored.
+ */
+static void bench_run_case(const struct bench_case *bc, struct bench_stats *st)
+{
+	struct bench_result res;
+	void *ctx = NULL;
+	uint64_t start, ns;
+	uint32_t i;
+
+	memset(st, 0, sizeof(*st));
+	st->bc = bc;
+	st->min_ns = UINT64_MAX;
+
+	if (bc->setup) {
+		st->status = bc->setup(&ctx);
+		if (st->status)
+			return;
+	}
+
+	for (i = 0; i < bc->iterations; i++) {
+		memset(&res, 0, sizeof(res));
+		start = bench_time_ns();
+		st->status = bc->run(ctx, &res);
+		ns = bench_time_ns() - start;
+		if (st->status)
+			break;
+
+		st->iterations++;
+		st->total_ns += ns;
+		if (ns < st->min_ns)
+			st->min_ns = ns;
+		if (ns > st->max_ns)
+			st->max_ns = ns;
+		st->res = res;
+	}
+
+	if (bc->teardown)
+		bc->teardown(ctx);
+}
+
+/**
+ * @brief Write the rate of a case in JSON, if it has one.
+ * @param f - Output file.
+ * @param st - Results of the case.
+ */
+static void bench_write_rate(FILE *f, const struct bench_stats *st)
+{
+	uint32_t i;
+
+	if (!st->bc->rate || !st->iterations || !st->total_ns)
+		return;
+
+	for (i = 0; i < st->res.nb_counters; i++) {
+		if (strcmp(st->res.counters[i].name, st->bc->rate))
+			continue;
+		fprintf(f, "\t\t\t\"rate\": {\"%s_per_s\": %.0f},\n",
+			st->bc->rate, st->res.counters[i].value * 1e9 *
+			st->iterations / st->total_ns);
+		return;
+	}
+}
+
+/**
+ * @brief Write the results in JSON.
+ * @param f - Output file.
+ * @param st - Results of the cases that were run.
+ * @param nb - Number of results.
+ */
+static void bench_write_json(FILE *f, const struct bench_stats *st, uint32_t nb)
+{
+	const char *status;
+	uint32_t i, j;
+
+	fprintf(f, "{\n\t\"benchmarks\": [");
+	for (i = 0; i < nb; i++, st++) {
+		if (st->status == BENCH_SKIP)
+			status = "skipped";
+		else if (st->status)
+			status = "failed";
+		else
+			status = "ok";
+
+		fprintf(f, "%s\n\t\t{\n", i ? "," : "");
+		fprintf(f, "\t\t\t\"name\": \"%s\",\n", st->bc->name);
+		fprintf(f, "\t\t\t\"status\": \"%s\",\n", status);
+		fprintf(f, "\t\t\t\"error\": %d,\n",
+			st->status == BENCH_SKIP ? 0 : st->status);
+		fprintf(f, "\t\t\t\"iterations\": %u,\n", st->iterations);
+		fprintf(f, "\t\t\t\"time_ns\": {\"mean\": %llu, \"min\": %llu, \"max\": %llu},\n",
+			st->iterations ?
+			(unsigned long long)(st->total_ns / st->iterations) : 0,
+			st->iterations ? (unsigned long long)st->min_ns : 0,
+			(unsigned long long)st->max_ns);
+		bench_write_rate(f, st);
+		fprintf(f, "\t\t\t\"counters\": {");
+		for (j = 0; j < st->res.nb_counters; j++)
+			fprintf(f, "%s\"%s\": %llu", j ? ", " : "",
+				st->res.counters[j].name,
+				(unsigned long long)st->res.counters[j].value);
+		fprintf(f, "}\n\t\t}");
+	}
+	fprintf(f, "\n\t]\n}\n");
+}
+
+/**
+ * @brief Check if a case was selected on the command line.
+ * @param name - Case name.
+ * @param argc - Number of names.
+ * @param argv - Names, every case is selected if there are none.
+ * @return 1 if selected, 0 otherwise.
+ */
+static int bench_selected(const char *name, int argc, char **argv)
+{
+	int i;
+
+	if (!argc)
+		return 1;
+
+	for (i = 0; i < argc; i++)
+		if (strstr(name, argv[i]))
+			return 1;
+
+	return 0;
+}
+
+static void bench_usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s [-o results.json] [-l] [case...]\n", prog);
+	fprintf(stderr, "  -o  write the results to a file (default bench.json)\n");
+	fprintf(stderr, "  -l  list the cases\n");
+	fprintf(stderr, "Cases whose name contains one of the arguments are run.\n");
+}
+
+int main(int argc, char **argv)
+{
+	const uint32_t nb_cases = sizeof(bench_cases) / sizeof(bench_cases[0]);
+	struct bench_stats stats[sizeof(bench_cases) / sizeof(bench_cases[0])];
+	const char *out = "bench.json";
+	uint32_t i, nb = 0, failed = 0;
+	struct bench_stats *st;
+	FILE *f;
+	int opt;
+
+	for (opt = 1; opt < argc && argv[opt][0] == '-'; opt++) {
+		if (!strcmp(argv[opt], "-o") && opt + 1 < argc) {
+			out = argv[++opt];
+		} else if (!strcmp(argv[opt], "-l")) {
+			for (i = 0; i < nb_cases; i++)
+				printf("%s\n", bench_cases[i]->name);
+			return 0;
+		} else {
+			bench_usage(argv[0]);
+			return 1;
+		}
+	}
+
+	for (i = 0; i < nb_cases; i++) {
+		if (!bench_selected(bench_cases[i]->name, argc - opt, argv + opt))
+			continue;
+
+		st = &stats[nb++];
+		bench_run_case(bench_cases[i], st);
+
+		if (st->status == BENCH_SKIP) {
+			printf("[bench] %-32s skipped\n", st->bc->name);
+		} else if (st->status) {
+			printf("[bench] %-32s FAILED (%d)\n", st->bc->name,
+			       st->status);
+			failed++;
+		} else {
+			printf("[bench] %-32s %12.3f us/iter (%u iterations)\n",
+			       st->bc->name,
+			       st->total_ns / (st->iterations * 1000.0),
+			       st->iterations);
+		}
+		fflush(stdout);
+	}
+
+	f = fopen(out, "w");
+	if (!f) {
+		perror(out);
+		return 1;
+	}
+	bench_write_json(f, stats, nb);
+	fclose(f);
+
+	return failed ? 1 : 0;
+}
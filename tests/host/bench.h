@@ -0,0 +1,116 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench.h
+ *   @brief  Host benchmark runner.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_MAX_COUNTERS	12
+
+/* Returned by bench_case.setup or bench_case.run when the case can't run. */
+#define BENCH_SKIP		1
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_counter
+ * @brief Deterministic figure reported by a case, gated by the CI.
+ */
+struct bench_counter {
+	/** Counter name */
+	const char *name;
+	/** Counter value */
+	uint64_t value;
+};
+
+/**
+ * @struct bench_result
+ * @brief Counters reported by one iteration of a case.
+ */
+struct bench_result {
+	/** Number of counters */
+	uint32_t nb_counters;
+	/** Counters */
+	struct bench_counter counters[BENCH_MAX_COUNTERS];
+};
+
+/**
+ * @struct bench_case
+ * @brief Benchmark case. The runner times every call of run(), the counters
+ * reported by the last call are written to the results.
+ */
+struct bench_case {
+	/** Case name */
+	const char *name;
+	/** Number of timed iterations */
+	uint32_t iterations;
+	/** Called once before the iterations, may be NULL */
+	int32_t (*setup)(void **ctx);
+	/** One iteration, 0 on success, negative error code on failure */
+	int32_t (*run)(void *ctx, struct bench_result *res);
+	/** Called once after the iterations, may be NULL */
+	void (*teardown)(void *ctx);
+	/**
+	 * Counter also reported per second of run(), may be NULL. Like the
+	 * times, the rate depends on the machine and is not gated.
+	 */
+	const char *rate;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Report a counter from bench_case.run(). */
+void bench_counter(struct bench_result *res, const char *name, uint64_t value);
+
+/* Monotonic time in nanoseconds. */
+uint64_t bench_time_ns(void);
+
+#endif // BENCH_H_
@@ -0,0 +1,302 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench_ad5933.c
+ *   @brief  AD5933 frequency sweeps on a simulated I2C device.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <math.h>
+#include "ad5933.h"
+#include "linux_sim_i2c.h"
+#include "error.h"
+#include "bench.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_AD5933_ADDRESS	0x0D
+#define BENCH_AD5933_POINTS	20
+#define BENCH_AD5933_GAIN	1e-6
+/* Status reads before a point becomes valid */
+#define BENCH_AD5933_LATENCY	3
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_ad5933_model
+ * @brief State of the simulated AD5933. Every point returns a known real and
+ * imaginary value, a few status reads after it was started.
+ */
+struct bench_ad5933_model {
+	/** Current frequency point */
+	uint16_t point;
+	/** Status reads left until the point is valid, 0 if none is pending */
+	uint8_t pending;
+};
+
+/**
+ * @struct bench_ad5933_ctx
+ * @brief State of a case.
+ */
+struct bench_ad5933_ctx {
+	/** Simulated device */
+	struct bench_ad5933_model model;
+	/** AD5933 */
+	struct ad5933_dev *dev;
+	/** Raw results of a sweep */
+	struct ad5933_result results[BENCH_AD5933_POINTS];
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Start a measurement when a sweep function is written to the control
+ * register.
+ */
+static void bench_ad5933_write_hook(void *ctx, uint8_t *regs, uint32_t addr)
+{
+	struct bench_ad5933_model *model = ctx;
+	uint8_t function;
+
+	if (addr != AD5933_REG_CONTROL_HB)
+		return;
+
+	function = regs[addr] >> 4;
+	switch (function) {
+	case AD5933_FUNCTION_START_SWEEP:
+		model->point = 0;
+		regs[AD5933_REG_STATUS] &= ~AD5933_STAT_SWEEP_DONE;
+		break;
+	case AD5933_FUNCTION_INC_FREQ:
+		model->point++;
+		break;
+	case AD5933_FUNCTION_REPEAT_FREQ:
+		break;
+	default:
+		return;
+	}
+
+	regs[AD5933_REG_STATUS] &= ~AD5933_STAT_DATA_VALID;
+	model->pending = BENCH_AD5933_LATENCY;
+}
+
+/**
+ * @brief Complete the measurement after a few status reads.
+ */
+static void bench_ad5933_read_hook(void *ctx, uint8_t *regs, uint32_t addr)
+{
+	struct bench_ad5933_model *model = ctx;
+	int16_t real;
+	int16_t imag;
+
+	if (addr != AD5933_REG_STATUS || !model->pending)
+		return;
+	if (--model->pending)
+		return;
+
+	real = 1000 + model->point;
+	imag = -500 - model->point;
+	regs[AD5933_REG_REAL_DATA] = real >> 8;
+	regs[AD5933_REG_REAL_DATA + 1] = real;
+	regs[AD5933_REG_IMAG_DATA] = imag >> 8;
+	regs[AD5933_REG_IMAG_DATA + 1] = imag;
+	regs[addr] |= AD5933_STAT_DATA_VALID;
+	if (model->point == BENCH_AD5933_POINTS - 1)
+		regs[addr] |= AD5933_STAT_SWEEP_DONE;
+}
+
+static int32_t bench_ad5933_setup(void **ctx)
+{
+	struct bench_ad5933_ctx *actx;
+	struct linux_sim_i2c_init_param sim_init = {
+		.proto = &linux_sim_i2c_proto_ad5933,
+		.map_size = 256,
+		.read_hook = bench_ad5933_read_hook,
+		.write_hook = bench_ad5933_write_hook,
+	};
+	struct ad5933_init_param init = {
+		.i2c_init = {
+			.max_speed_hz = 400000,
+			.slave_address = BENCH_AD5933_ADDRESS,
+			.platform_ops = &linux_sim_i2c_platform_ops,
+			.extra = &sim_init,
+		},
+		.current_sys_clk = AD5933_INTERNAL_SYS_CLK,
+		.current_clock_source = AD5933_CONTROL_INT_SYSCLK,
+		.current_gain = AD5933_GAIN_X1,
+		.current_range = AD5933_RANGE_2000mVpp,
+	};
+	int32_t ret;
+
+	actx = calloc(1, sizeof(*actx));
+	if (!actx)
+		return -ENOMEM;
+
+	sim_init.hook_ctx = &actx->model;
+	ret = ad5933_init(&actx->dev, init);
+	if (ret != SUCCESS) {
+		free(actx);
+		return ret;
+	}
+
+	ad5933_config_sweep(actx->dev, 30000, 10, BENCH_AD5933_POINTS - 1);
+	*ctx = actx;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Check that the result of a point is the one the model returned.
+ */
+static bool bench_ad5933_point_ok(const struct ad5933_result *result,
+				  uint16_t point)
+{
+	return result->real == 1000 + point && result->imag == -500 - point;
+}
+
+/**
+ * @brief Sweep with the blocking helpers, one impedance per point.
+ */
+static int32_t bench_ad5933_blocking_run(void *ctx, struct bench_result *res)
+{
+	struct bench_ad5933_ctx *actx = ctx;
+	struct linux_sim_i2c_stats stats;
+	struct ad5933_result last = {
+		.real = 1000 + BENCH_AD5933_POINTS - 1,
+		.imag = -500 - (BENCH_AD5933_POINTS - 1),
+	};
+	double impedance = NAN;
+	double expected;
+	uint16_t point;
+	int32_t ret;
+
+	linux_sim_i2c_reset_stats(actx->dev->i2c_desc);
+
+	ret = ad5933_start_sweep(actx->dev);
+	if (ret != SUCCESS)
+		return ret;
+
+	for (point = 0; point < BENCH_AD5933_POINTS; point++) {
+		impedance = ad5933_calculate_impedance(actx->dev,
+						       BENCH_AD5933_GAIN,
+						       point ? AD5933_FUNCTION_INC_FREQ :
+						       AD5933_FUNCTION_REPEAT_FREQ);
+		if (isnan(impedance))
+			return -ETIMEDOUT;
+	}
+
+	linux_sim_i2c_get_stats(actx->dev->i2c_desc, &stats);
+	bench_counter(res, "transfers", stats.transfers);
+	bench_counter(res, "bytes", stats.bytes);
+
+	expected = 1 / (sqrt((double)last.real * last.real +
+			     (double)last.imag * last.imag) * BENCH_AD5933_GAIN);
+	if (fabs(impedance - expected) > expected * 1e-9)
+		return -EIO;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Sweep with ad5933_sweep_start() and ad5933_sweep_poll().
+ */
+static int32_t bench_ad5933_poll_run(void *ctx, struct bench_result *res)
+{
+	struct bench_ad5933_ctx *actx = ctx;
+	struct linux_sim_i2c_stats stats;
+	uint32_t polls = 0;
+	uint16_t points;
+	int32_t ret;
+
+	linux_sim_i2c_reset_stats(actx->dev->i2c_desc);
+
+	ret = ad5933_sweep_start(actx->dev, actx->results, BENCH_AD5933_POINTS);
+	if (ret != SUCCESS)
+		return ret;
+
+	do {
+		ret = ad5933_sweep_poll(actx->dev, &points);
+		polls++;
+	} while (ret == -EAGAIN);
+	ad5933_sweep_stop(actx->dev);
+	if (ret != SUCCESS)
+		return ret;
+
+	linux_sim_i2c_get_stats(actx->dev->i2c_desc, &stats);
+	bench_counter(res, "transfers", stats.transfers);
+	bench_counter(res, "bytes", stats.bytes);
+	bench_counter(res, "polls", polls);
+
+	if (points != BENCH_AD5933_POINTS)
+		return -EIO;
+	for (points = 0; points < BENCH_AD5933_POINTS; points++)
+		if (!bench_ad5933_point_ok(&actx->results[points], points))
+			return -EIO;
+
+	return SUCCESS;
+}
+
+static void bench_ad5933_teardown(void *ctx)
+{
+	struct bench_ad5933_ctx *actx = ctx;
+
+	ad5933_remove(actx->dev);
+	free(actx);
+}
+
+const struct bench_case bench_ad5933_sweep_blocking = {
+	.name = "ad5933_sweep_blocking",
+	.iterations = 20,
+	.setup = bench_ad5933_setup,
+	.run = bench_ad5933_blocking_run,
+	.teardown = bench_ad5933_teardown,
+};
+
+const struct bench_case bench_ad5933_sweep_poll = {
+	.name = "ad5933_sweep_poll",
+	.iterations = 20,
+	.setup = bench_ad5933_setup,
+	.run = bench_ad5933_poll_run,
+	.teardown = bench_ad5933_teardown,
+};
@@ -0,0 +1,373 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench_ad7616.c
+ *   @brief  AD7616 capture and streaming on the simulated AXI cores.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include "spi.h"
+#include "spi_engine.h"
+#include "axi_io.h"
+#include "ad7616.h"
+#include "linux_sim_axi_io.h"
+#include "error.h"
+#include "bench.h"
+#include "bench_platform.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_AD7616_CORE_BASE		0x50000
+#define BENCH_AD7616_SPI_ENGINE_BASE	0x51000
+#define BENCH_AD7616_DMAC_BASE		0x52000
+#define BENCH_AD7616_REGION_SIZE	0x1000
+#define BENCH_AD7616_SAMPLES		1000
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_ad7616_ctx
+ * @brief State of an AD7616 case.
+ */
+struct bench_ad7616_ctx {
+	/** AD7616 */
+	struct ad7616_dev *dev;
+	/** Parallel interface, serial if false */
+	bool parallel;
+	/** Blocks handed to the stream callback */
+	uint32_t blocks;
+	/** Capture buffers */
+	uint32_t buf[2][BENCH_AD7616_SAMPLES];
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Sum of the register accesses to the three cores.
+ * @return The number of accesses.
+ */
+static uint32_t bench_ad7616_mmio(void)
+{
+	const uint32_t bases[] = {
+		BENCH_AD7616_CORE_BASE,
+		BENCH_AD7616_SPI_ENGINE_BASE,
+		BENCH_AD7616_DMAC_BASE,
+	};
+	struct linux_sim_axi_io_stats stats;
+	uint32_t mmio = 0;
+	uint32_t i;
+
+	for (i = 0; i < 3; i++) {
+		linux_sim_axi_io_get_stats(bases[i], &stats);
+		mmio += stats.reads + stats.writes;
+		linux_sim_axi_io_reset_stats(bases[i]);
+	}
+
+	return mmio;
+}
+
+/**
+ * @brief Map the cores and set the device up.
+ * @param ctx - Where the case state is stored.
+ * @param parallel - Use the parallel interface.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_ad7616_setup(void **ctx, bool parallel)
+{
+	struct linux_sim_axi_io_region regions[] = {
+		{
+			.base = BENCH_AD7616_CORE_BASE,
+			.size = BENCH_AD7616_REGION_SIZE,
+			.model = LINUX_SIM_AXI_IO_RAM,
+		},
+		{
+			.base = BENCH_AD7616_SPI_ENGINE_BASE,
+			.size = BENCH_AD7616_REGION_SIZE,
+			.model = LINUX_SIM_AXI_IO_SPI_ENGINE,
+		},
+		{
+			.base = BENCH_AD7616_DMAC_BASE,
+			.size = BENCH_AD7616_REGION_SIZE,
+			.model = LINUX_SIM_AXI_IO_DMAC,
+		},
+	};
+	struct spi_engine_offload_init_param offload_init = {
+		.offload_config = OFFLOAD_RX_EN,
+		.rx_dma_baseaddr = BENCH_AD7616_DMAC_BASE,
+	};
+	struct spi_engine_init_param engine_init = {
+		.ref_clk_hz = 100000000,
+		.type = SPI_ENGINE,
+		.spi_engine_baseaddr = BENCH_AD7616_SPI_ENGINE_BASE,
+		.cs_delay = 1,
+		.data_width = 8,
+	};
+	struct spi_init_param spi_init = {
+		.max_speed_hz = 50000000,
+		.mode = SPI_MODE_2,
+		.platform_ops = &spi_eng_platform_ops,
+		.extra = &engine_init,
+	};
+	struct ad7616_init_param init = {
+		.spi_param = &spi_init,
+		.offload_init_param = &offload_init,
+		.reg_access_speed = 1000000,
+		.core_baseaddr = BENCH_AD7616_CORE_BASE,
+		.mode = AD7616_SW,
+		.osr = AD7616_OSR_0,
+	};
+	struct bench_ad7616_ctx *actx;
+	uint32_t i;
+	int32_t ret;
+
+	actx = calloc(1, sizeof(*actx));
+	if (!actx)
+		return -ENOMEM;
+
+	for (i = 0; i < ARRAY_SIZE(regions); i++) {
+		ret = linux_sim_axi_io_add(&regions[i]);
+		if (ret < 0)
+			goto error;
+	}
+
+	/* The interface type is a synthesis parameter of the core */
+	axi_io_write(BENCH_AD7616_CORE_BASE, AD7616_REG_UP_IF_TYPE, parallel);
+
+	ret = ad7616_setup(&actx->dev, &init);
+	if (ret < 0)
+		goto error;
+
+	actx->parallel = parallel;
+	*ctx = actx;
+
+	return 0;
+
+error:
+	linux_sim_axi_io_remove_all();
+	free(actx);
+
+	return ret;
+}
+
+static int32_t bench_ad7616_serial_setup(void **ctx)
+{
+	return bench_ad7616_setup(ctx, false);
+}
+
+static int32_t bench_ad7616_parallel_setup(void **ctx)
+{
+	return bench_ad7616_setup(ctx, true);
+}
+
+/**
+ * @brief Report the per block setup cost. Nothing may be allocated once the
+ * device is set up.
+ * @param res - Results of the iteration.
+ * @param allocs - Allocation counter before the block.
+ * @param frees - Free counter before the block.
+ * @return 0 in case of success, -ENOMEM if the block allocated memory.
+ */
+static int32_t bench_ad7616_report(struct bench_result *res, uint32_t allocs,
+				   uint32_t frees)
+{
+	uint32_t allocs_end;
+	uint32_t frees_end;
+
+	bench_alloc_stats(&allocs_end, &frees_end);
+	bench_counter(res, "mmio", bench_ad7616_mmio());
+	bench_counter(res, "allocs", allocs_end - allocs);
+	bench_counter(res, "frees", frees_end - frees);
+
+	if (allocs_end != allocs || frees_end != frees)
+		return -ENOMEM;
+
+	return 0;
+}
+
+/**
+ * @brief One block with ad7616_read_data_serial() or
+ * ad7616_read_data_parallel().
+ */
+static int32_t bench_ad7616_capture_run(void *ctx, struct bench_result *res)
+{
+	struct bench_ad7616_ctx *actx = ctx;
+	uint32_t allocs;
+	uint32_t frees;
+	int32_t ret;
+
+	bench_ad7616_mmio();
+	bench_alloc_stats(&allocs, &frees);
+
+	if (actx->parallel)
+		ret = ad7616_read_data_parallel(actx->dev, actx->buf[0],
+						BENCH_AD7616_SAMPLES);
+	else
+		ret = ad7616_read_data_serial(actx->dev, actx->buf[0],
+					      BENCH_AD7616_SAMPLES);
+	if (ret < 0)
+		return ret;
+
+	return bench_ad7616_report(res, allocs, frees);
+}
+
+static void bench_ad7616_block_ready(void *ctx, uint32_t *buf,
+				     uint32_t samples)
+{
+	struct bench_ad7616_ctx *actx = ctx;
+
+	actx->blocks++;
+}
+
+/**
+ * @brief Start double buffered streaming. Each iteration polls until the
+ * next block is handed to the callback.
+ */
+static int32_t bench_ad7616_stream_setup(void **ctx, bool parallel)
+{
+	struct ad7616_stream_param param = {
+		.block_samples = BENCH_AD7616_SAMPLES,
+		.block_ready = bench_ad7616_block_ready,
+	};
+	struct bench_ad7616_ctx *actx;
+	int32_t ret;
+
+	ret = bench_ad7616_setup(ctx, parallel);
+	if (ret < 0)
+		return ret;
+
+	actx = *ctx;
+	param.buf[0] = actx->buf[0];
+	param.buf[1] = actx->buf[1];
+	param.ctx = actx;
+
+	ret = ad7616_stream_start(actx->dev, &param);
+	if (ret < 0) {
+		ad7616_remove(actx->dev);
+		linux_sim_axi_io_remove_all();
+		free(actx);
+	}
+
+	return ret;
+}
+
+static int32_t bench_ad7616_serial_stream_setup(void **ctx)
+{
+	return bench_ad7616_stream_setup(ctx, false);
+}
+
+static int32_t bench_ad7616_parallel_stream_setup(void **ctx)
+{
+	return bench_ad7616_stream_setup(ctx, true);
+}
+
+static int32_t bench_ad7616_stream_run(void *ctx, struct bench_result *res)
+{
+	struct bench_ad7616_ctx *actx = ctx;
+	uint32_t blocks;
+	uint32_t allocs;
+	uint32_t frees;
+	int32_t ret;
+
+	bench_ad7616_mmio();
+	bench_alloc_stats(&allocs, &frees);
+
+	blocks = actx->blocks;
+	while (actx->blocks == blocks) {
+		ret = ad7616_stream_poll(actx->dev);
+		if (ret < 0)
+			return ret;
+	}
+
+	return bench_ad7616_report(res, allocs, frees);
+}
+
+static void bench_ad7616_teardown(void *ctx)
+{
+	struct bench_ad7616_ctx *actx = ctx;
+
+	ad7616_remove(actx->dev);
+	linux_sim_axi_io_remove_all();
+	free(actx);
+}
+
+static void bench_ad7616_stream_teardown(void *ctx)
+{
+	struct bench_ad7616_ctx *actx = ctx;
+
+	ad7616_stream_stop(actx->dev);
+	bench_ad7616_teardown(ctx);
+}
+
+/* Soak runs: every block is checked for leaks */
+const struct bench_case bench_ad7616_serial_capture = {
+	.name = "ad7616_serial_capture",
+	.iterations = 10000,
+	.setup = bench_ad7616_serial_setup,
+	.run = bench_ad7616_capture_run,
+	.teardown = bench_ad7616_teardown,
+};
+
+const struct bench_case bench_ad7616_parallel_capture = {
+	.name = "ad7616_parallel_capture",
+	.iterations = 10000,
+	.setup = bench_ad7616_parallel_setup,
+	.run = bench_ad7616_capture_run,
+	.teardown = bench_ad7616_teardown,
+};
+
+const struct bench_case bench_ad7616_serial_stream = {
+	.name = "ad7616_serial_stream",
+	.iterations = 10000,
+	.setup = bench_ad7616_serial_stream_setup,
+	.run = bench_ad7616_stream_run,
+	.teardown = bench_ad7616_stream_teardown,
+};
+
+const struct bench_case bench_ad7616_parallel_stream = {
+	.name = "ad7616_parallel_stream",
+	.iterations = 10000,
+	.setup = bench_ad7616_parallel_stream_setup,
+	.run = bench_ad7616_stream_run,
+	.teardown = bench_ad7616_stream_teardown,
+};
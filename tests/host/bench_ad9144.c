@@ -0,0 +1,230 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench_ad9144.c
+ *   @brief  AD9144 bring-up on a simulated register map.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include "ad9144.h"
+#include "linux_sim_spi.h"
+#include "error.h"
+#include "bench.h"
+#include "bench_platform.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_AD9144_MAP_SIZE	0x480
+/* Calibration status reads before the DACs report done */
+#define BENCH_AD9144_CAL_READS	4
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_ad9144_model
+ * @brief State of the simulated AD9144.
+ */
+struct bench_ad9144_model {
+	/** Calibration status reads left, 0 if no calibration is running */
+	uint8_t cal_reads;
+};
+
+/******************************************************************************/
+/************************ Variable Definitions ********************************/
+/******************************************************************************/
+
+static struct bench_ad9144_model bench_ad9144;
+
+static uint8_t bench_ad9144_defaults[BENCH_AD9144_MAP_SIZE] = {
+	[REG_SPI_PRODIDL] = AD9144_CHIP_ID,
+	[REG_DACPLLSTATUS] = 0x22,
+	[REG_PLL_STATUS] = 0x01,
+};
+
+/* Read bit, 15-bit address, descending in a stream. */
+static const struct linux_sim_spi_proto bench_ad9144_proto = {
+	.cmd_bytes = 2,
+	.rd_mask = 0x8000,
+	.rd_value = 0x8000,
+	.addr_mask = 0x7FFF,
+	.addr_dec = true,
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static void bench_ad9144_spi_read_hook(void *ctx, uint8_t *regs, uint32_t addr)
+{
+	if (addr != REG_CAL_CTRL || !bench_ad9144.cal_reads)
+		return;
+
+	if (!--bench_ad9144.cal_reads)
+		regs[addr] = (regs[addr] & ~CAL_ACTIVE) | CAL_FIN;
+}
+
+static void bench_ad9144_spi_write_hook(void *ctx, uint8_t *regs,
+					uint32_t addr)
+{
+	/* Single calibration start */
+	if (addr == REG_CAL_CTRL && regs[addr] == 0x03) {
+		regs[addr] |= CAL_ACTIVE;
+		bench_ad9144.cal_reads = BENCH_AD9144_CAL_READS;
+	}
+}
+
+/**
+ * @brief Run ad9144_setup() on the simulated device.
+ * @param res - Results of the iteration.
+ * @param pll_dac_frequency_khz - DAC PLL output frequency.
+ * @param ret - Where the result of ad9144_setup() is stored.
+ * @return The device, NULL if the setup failed.
+ */
+static struct ad9144_dev *bench_ad9144_setup(struct bench_result *res,
+		uint32_t pll_dac_frequency_khz,
+		int32_t *ret)
+{
+	struct linux_sim_spi_init_param sim_init = {
+		.proto = &bench_ad9144_proto,
+		.map_size = BENCH_AD9144_MAP_SIZE,
+		.defaults = bench_ad9144_defaults,
+		.read_hook = bench_ad9144_spi_read_hook,
+		.write_hook = bench_ad9144_spi_write_hook,
+	};
+	struct ad9144_init_param init = {
+		.spi_init = {
+			.max_speed_hz = 10000000,
+			.mode = SPI_MODE_0,
+			.platform_ops = &linux_sim_spi_platform_ops,
+			.extra = &sim_init,
+		},
+		.interpolation = 1,
+		.lane_rate_kbps = 10000000,
+		.jesd204_mode = 4,
+		.jesd204_subclass = 1,
+		.jesd204_scrambling = 1,
+		.jesd204_lane_xbar = {0, 1, 2, 3, 4, 5, 6, 7},
+		.pll_enable = 1,
+		.pll_ref_frequency_khz = 125000,
+		.pll_dac_frequency_khz = pll_dac_frequency_khz,
+	};
+	struct linux_sim_spi_stats stats;
+	struct ad9144_dev *dev = NULL;
+
+	bench_ad9144.cal_reads = 0;
+
+	*ret = ad9144_setup(&dev, &init);
+	if (*ret != SUCCESS)
+		return NULL;
+
+	linux_sim_spi_get_stats(dev->spi_desc, &stats);
+	bench_counter(res, "transfers", stats.transfers);
+	bench_counter(res, "bytes", stats.bytes);
+	bench_counter(res, "reg_reads", stats.reg_reads);
+	bench_counter(res, "reg_writes", stats.reg_writes);
+
+	return dev;
+}
+
+/**
+ * @brief Complete bring-up with the DAC PLL and the calibration.
+ */
+static int32_t bench_ad9144_setup_run(void *ctx, struct bench_result *res)
+{
+	struct ad9144_dev *dev;
+	uint8_t val;
+	int32_t ret;
+
+	dev = bench_ad9144_setup(res, 1000000, &ret);
+	if (!dev)
+		return ret;
+
+	/* The link is enabled last */
+	ret = linux_sim_spi_reg_get(dev->spi_desc, REG_GENERAL_JRX_CTRL_0, &val);
+	if (ret == SUCCESS && val != 0x01)
+		ret = -EIO;
+
+	ad9144_remove(dev);
+
+	return ret;
+}
+
+/**
+ * @brief A DAC PLL output frequency out of range fails the setup, which must
+ * release everything it allocated.
+ */
+static int32_t bench_ad9144_pll_error_run(void *ctx, struct bench_result *res)
+{
+	struct ad9144_dev *dev;
+	uint32_t allocs;
+	uint32_t frees;
+	uint32_t allocs_end;
+	uint32_t frees_end;
+	int32_t ret;
+
+	bench_alloc_stats(&allocs, &frees);
+	dev = bench_ad9144_setup(res, 100000, &ret);
+	bench_alloc_stats(&allocs_end, &frees_end);
+	if (dev) {
+		ad9144_remove(dev);
+		return -EIO;
+	}
+
+	bench_counter(res, "leaked", (allocs_end - allocs) -
+		      (frees_end - frees));
+	if (allocs_end - allocs != frees_end - frees)
+		return -ENOMEM;
+
+	return ret < 0 ? SUCCESS : -EIO;
+}
+
+const struct bench_case bench_ad9144_bringup = {
+	.name = "ad9144_bringup",
+	.iterations = 10,
+	.run = bench_ad9144_setup_run,
+};
+
+const struct bench_case bench_ad9144_pll_error = {
+	.name = "ad9144_pll_error",
+	.iterations = 10,
+	.run = bench_ad9144_pll_error_run,
+};
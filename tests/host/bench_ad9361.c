@@ -0,0 +1,698 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench_ad9361.c
+ *   @brief  AD9361 init and IIO attribute benchmarks on the simulated SPI and AXI backends.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include "ad9361_api.h"
+#include "ad9361.h"
+#include "axi_adc_core.h"
+#include "axi_dac_core.h"
+#include "iio_ad9361.h"
+#include "linux_sim_spi.h"
+#include "linux_sim_axi_io.h"
+#include "error.h"
+#include "bench.h"
+#include "bench_platform.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_AD9361_ADC_BASE		0x10000
+#define BENCH_AD9361_DAC_BASE		0x14000
+#define BENCH_AD9361_REGION_SIZE	0x4000
+#define BENCH_AD9361_NUM_CHANNELS	4
+
+/*
+ * Window of (clock delay - data delay) in which the simulated interface
+ * passes the PN test, one for RX and one for TX.
+ */
+#define BENCH_AD9361_RX_WIN_MIN		-5
+#define BENCH_AD9361_RX_WIN_MAX		2
+#define BENCH_AD9361_TX_WIN_MIN		3
+#define BENCH_AD9361_TX_WIN_MAX		10
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_ad9361_ctx
+ * @brief State of the IIO attribute case.
+ */
+struct bench_ad9361_ctx {
+	/** Device */
+	struct ad9361_rf_phy *phy;
+	/** IIO descriptor */
+	struct iio_ad9361_desc *iio;
+};
+
+/******************************************************************************/
+/************************ Variable Definitions ********************************/
+/******************************************************************************/
+
+/* Last RX and TX interface delays written to the device. */
+static uint8_t bench_ad9361_delay[2];
+
+static void bench_ad9361_spi_read_hook(void *ctx, uint8_t *regs, uint32_t addr);
+static void bench_ad9361_spi_write_hook(void *ctx, uint8_t *regs,
+					uint32_t addr);
+
+static struct linux_sim_spi_init_param bench_ad9361_spi_param = {
+	.proto = &linux_sim_spi_proto_ad9361,
+	.map_size = 1024,
+	.read_hook = bench_ad9361_spi_read_hook,
+	.write_hook = bench_ad9361_spi_write_hook,
+};
+
+static struct axi_adc_init bench_ad9361_adc_init = {
+	.name = "cf-ad9361-lpc",
+	.base = BENCH_AD9361_ADC_BASE,
+	.num_channels = BENCH_AD9361_NUM_CHANNELS,
+};
+
+static struct axi_dac_init bench_ad9361_dac_init = {
+	.name = "cf-ad9361-dds-core-lpc",
+	.base = BENCH_AD9361_DAC_BASE,
+	.num_channels = BENCH_AD9361_NUM_CHANNELS,
+	.channels = NULL,
+};
+
+/* Same settings as projects/ad9361/src/main.c, LINUX_PLATFORM build. */
+static AD9361_InitParam bench_ad9361_param = {
+	/* Device selection */
+	ID_AD9361,	// dev_sel
+	/* Identification number */
+	0,		//id_no
+	/* Reference Clock */
+	40000000UL,	//reference_clk_rate
+	/* Base Configuration */
+	1,		//two_rx_two_tx_mode_enable *** adi,2rx-2tx-mode-enable
+	1,		//one_rx_one_tx_mode_use_rx_num *** adi,1rx-1tx-mode-use-rx-num
+	1,		//one_rx_one_tx_mode_use_tx_num *** adi,1rx-1tx-mode-use-tx-num
+	1,		//frequency_division_duplex_mode_enable *** adi,frequency-division-duplex-mode-enable
+	0,		//frequency_division_duplex_independent_mode_enable *** adi,frequency-division-duplex-independent-mode-enable
+	0,		//tdd_use_dual_synth_mode_enable *** adi,tdd-use-dual-synth-mode-enable
+	0,		//tdd_skip_vco_cal_enable *** adi,tdd-skip-vco-cal-enable
+	0,		//tx_fastlock_delay_ns *** adi,tx-fastlock-delay-ns
+	0,		//rx_fastlock_delay_ns *** adi,rx-fastlock-delay-ns
+	0,		//rx_fastlock_pincontrol_enable *** adi,rx-fastlock-pincontrol-enable
+	0,		//tx_fastlock_pincontrol_enable *** adi,tx-fastlock-pincontrol-enable
+	0,		//external_rx_lo_enable *** adi,external-rx-lo-enable
+	0,		//external_tx_lo_enable *** adi,external-tx-lo-enable
+	5,		//dc_offset_tracking_update_event_mask *** adi,dc-offset-tracking-update-event-mask
+	6,		//dc_offset_attenuation_high_range *** adi,dc-offset-attenuation-high-range
+	5,		//dc_offset_attenuation_low_range *** adi,dc-offset-attenuation-low-range
+	0x28,	//dc_offset_count_high_range *** adi,dc-offset-count-high-range
+	0x32,	//dc_offset_count_low_range *** adi,dc-offset-count-low-range
+	0,		//split_gain_table_mode_enable *** adi,split-gain-table-mode-enable
+	MAX_SYNTH_FREF,	//trx_synthesizer_target_fref_overwrite_hz *** adi,trx-synthesizer-target-fref-overwrite-hz
+	0,		// qec_tracking_slow_mode_enable *** adi,qec-tracking-slow-mode-enable
+	/* ENSM Control */
+	0,		//ensm_enable_pin_pulse_mode_enable *** adi,ensm-enable-pin-pulse-mode-enable
+	0,		//ensm_enable_txnrx_control_enable *** adi,ensm-enable-txnrx-control-enable
+	/* LO Control */
+	2400000000UL,	//rx_synthesizer_frequency_hz *** adi,rx-synthesizer-frequency-hz
+	2400000000UL,	//tx_synthesizer_frequency_hz *** adi,tx-synthesizer-frequency-hz
+	1,				//tx_lo_powerdown_managed_enable *** adi,tx-lo-powerdown-managed-enable
+	/* Rate & BW Control */
+	{983040000, 245760000, 122880000, 61440000, 30720000, 30720000},// rx_path_clock_frequencies[6] *** adi,rx-path-clock-frequencies
+	{983040000, 122880000, 122880000, 61440000, 30720000, 30720000},// tx_path_clock_frequencies[6] *** adi,tx-path-clock-frequencies
+	18000000,//rf_rx_bandwidth_hz *** adi,rf-rx-bandwidth-hz
+	18000000,//rf_tx_bandwidth_hz *** adi,rf-tx-bandwidth-hz
+	/* RF Port Control */
+	0,		//rx_rf_port_input_select *** adi,rx-rf-port-input-select
+	0,		//tx_rf_port_input_select *** adi,tx-rf-port-input-select
+	/* TX Attenuation Control */
+	10000,	//tx_attenuation_mdB *** adi,tx-attenuation-mdB
+	0,		//update_tx_gain_in_alert_enable *** adi,update-tx-gain-in-alert-enable
+	/* Reference Clock Control */
+	0,		//xo_disable_use_ext_refclk_enable *** adi,xo-disable-use-ext-refclk-enable
+	{8, 5920},	//dcxo_coarse_and_fine_tune[2] *** adi,dcxo-coarse-and-fine-tune
+	CLKOUT_DISABLE,	//clk_output_mode_select *** adi,clk-output-mode-select
+	/* Gain Control */
+	2,		//gc_rx1_mode *** adi,gc-rx1-mode
+	2,		//gc_rx2_mode *** adi,gc-rx2-mode
+	58,		//gc_adc_large_overload_thresh *** adi,gc-adc-large-overload-thresh
+	4,		//gc_adc_ovr_sample_size *** adi,gc-adc-ovr-sample-size
+	47,		//gc_adc_small_overload_thresh *** adi,gc-adc-small-overload-thresh
+	8192,	//gc_dec_pow_measurement_duration *** adi,gc-dec-pow-measurement-duration
+	0,		//gc_dig_gain_enable *** adi,gc-dig-gain-enable
+	800,	//gc_lmt_overload_high_thresh *** adi,gc-lmt-overload-high-thresh
+	704,	//gc_lmt_overload_low_thresh *** adi,gc-lmt-overload-low-thresh
+	24,		//gc_low_power_thresh *** adi,gc-low-power-thresh
+	15,		//gc_max_dig_gain *** adi,gc-max-dig-gain
+	0,		//gc_use_rx_fir_out_for_dec_pwr_meas_enable *** adi,gc-use-rx-fir-out-for-dec-pwr-meas-enable
+	/* Gain MGC Control */
+	2,		//mgc_dec_gain_step *** adi,mgc-dec-gain-step
+	2,		//mgc_inc_gain_step *** adi,mgc-inc-gain-step
+	0,		//mgc_rx1_ctrl_inp_enable *** adi,mgc-rx1-ctrl-inp-enable
+	0,		//mgc_rx2_ctrl_inp_enable *** adi,mgc-rx2-ctrl-inp-enable
+	0,		//mgc_split_table_ctrl_inp_gain_mode *** adi,mgc-split-table-ctrl-inp-gain-mode
+	/* Gain AGC Control */
+	10,		//agc_adc_large_overload_exceed_counter *** adi,agc-adc-large-overload-exceed-counter
+	2,		//agc_adc_large_overload_inc_steps *** adi,agc-adc-large-overload-inc-steps
+	0,		//agc_adc_lmt_small_overload_prevent_gain_inc_enable *** adi,agc-adc-lmt-small-overload-prevent-gain-inc-enable
+	10,		//agc_adc_small_overload_exceed_counter *** adi,agc-adc-small-overload-exceed-counter
+	4,		//agc_dig_gain_step_size *** adi,agc-dig-gain-step-size
+	3,		//agc_dig_saturation_exceed_counter *** adi,agc-dig-saturation-exceed-counter
+	1000,	// agc_gain_update_interval_us *** adi,agc-gain-update-interval-us
+	0,		//agc_immed_gain_change_if_large_adc_overload_enable *** adi,agc-immed-gain-change-if-large-adc-overload-enable
+	0,		//agc_immed_gain_change_if_large_lmt_overload_enable *** adi,agc-immed-gain-change-if-large-lmt-overload-enable
+	10,		//agc_inner_thresh_high *** adi,agc-inner-thresh-high
+	1,		//agc_inner_thresh_high_dec_steps *** adi,agc-inner-thresh-high-dec-steps
+	12,		//agc_inner_thresh_low *** adi,agc-inner-thresh-low
+	1,		//agc_inner_thresh_low_inc_steps *** adi,agc-inner-thresh-low-inc-steps
+	10,		//agc_lmt_overload_large_exceed_counter *** adi,agc-lmt-overload-large-exceed-counter
+	2,		//agc_lmt_overload_large_inc_steps *** adi,agc-lmt-overload-large-inc-steps
+	10,		//agc_lmt_overload_small_exceed_counter *** adi,agc-lmt-overload-small-exceed-counter
+	5,		//agc_outer_thresh_high *** adi,agc-outer-thresh-high
+	2,		//agc_outer_thresh_high_dec_steps *** adi,agc-outer-thresh-high-dec-steps
+	18,		//agc_outer_thresh_low *** adi,agc-outer-thresh-low
+	2,		//agc_outer_thresh_low_inc_steps *** adi,agc-outer-thresh-low-inc-steps
+	1,		//agc_attack_delay_extra_margin_us; *** adi,agc-attack-delay-extra-margin-us
+	0,		//agc_sync_for_gain_counter_enable *** adi,agc-sync-for-gain-counter-enable
+	/* Fast AGC */
+	64,		//fagc_dec_pow_measuremnt_duration ***  adi,fagc-dec-pow-measurement-duration
+	260,	//fagc_state_wait_time_ns ***  adi,fagc-state-wait-time-ns
+	/* Fast AGC - Low Power */
+	0,		//fagc_allow_agc_gain_increase ***  adi,fagc-allow-agc-gain-increase-enable
+	5,		//fagc_lp_thresh_increment_time ***  adi,fagc-lp-thresh-increment-time
+	1,		//fagc_lp_thresh_increment_steps ***  adi,fagc-lp-thresh-increment-steps
+	/* Fast AGC - Lock Level (Lock Level is set via slow AGC inner high threshold) */
+	1,		//fagc_lock_level_lmt_gain_increase_en ***  adi,fagc-lock-level-lmt-gain-increase-enable
+	5,		//fagc_lock_level_gain_increase_upper_limit ***  adi,fagc-lock-level-gain-increase-upper-limit
+	/* Fast AGC - Peak Detectors and Final Settling */
+	1,		//fagc_lpf_final_settling_steps ***  adi,fagc-lpf-final-settling-steps
+	1,		//fagc_lmt_final_settling_steps ***  adi,fagc-lmt-final-settling-steps
+	3,		//fagc_final_overrange_count ***  adi,fagc-final-overrange-count
+	/* Fast AGC - Final Power Test */
+	0,		//fagc_gain_increase_after_gain_lock_en ***  adi,fagc-gain-increase-after-gain-lock-enable
+	/* Fast AGC - Unlocking the Gain */
+	0,		//fagc_gain_index_type_after_exit_rx_mode ***  adi,fagc-gain-index-type-after-exit-rx-mode
+	1,		//fagc_use_last_lock_level_for_set_gain_en ***  adi,fagc-use-last-lock-level-for-set-gain-enable
+	1,		//fagc_rst_gla_stronger_sig_thresh_exceeded_en ***  adi,fagc-rst-gla-stronger-sig-thresh-exceeded-enable
+	5,		//fagc_optimized_gain_offset ***  adi,fagc-optimized-gain-offset
+	10,		//fagc_rst_gla_stronger_sig_thresh_above_ll ***  adi,fagc-rst-gla-stronger-sig-thresh-above-ll
+	1,		//fagc_rst_gla_engergy_lost_sig_thresh_exceeded_en ***  adi,fagc-rst-gla-engergy-lost-sig-thresh-exceeded-enable
+	1,		//fagc_rst_gla_engergy_lost_goto_optim_gain_en ***  adi,fagc-rst-gla-engergy-lost-goto-optim-gain-enable
+	10,		//fagc_rst_gla_engergy_lost_sig_thresh_below_ll ***  adi,fagc-rst-gla-engergy-lost-sig-thresh-below-ll
+	8,		//fagc_energy_lost_stronger_sig_gain_lock_exit_cnt ***  adi,fagc-energy-lost-stronger-sig-gain-lock-exit-cnt
+	1,		//fagc_rst_gla_large_adc_overload_en ***  adi,fagc-rst-gla-large-adc-overload-enable
+	1,		//fagc_rst_gla_large_lmt_overload_en ***  adi,fagc-rst-gla-large-lmt-overload-enable
+	0,		//fagc_rst_gla_en_agc_pulled_high_en ***  adi,fagc-rst-gla-en-agc-pulled-high-enable
+	0,		//fagc_rst_gla_if_en_agc_pulled_high_mode ***  adi,fagc-rst-gla-if-en-agc-pulled-high-mode
+	64,		//fagc_power_measurement_duration_in_state5 ***  adi,fagc-power-measurement-duration-in-state5
+	2,		//fagc_large_overload_inc_steps *** adi,fagc-adc-large-overload-inc-steps
+	/* RSSI Control */
+	1,		//rssi_delay *** adi,rssi-delay
+	1000,	//rssi_duration *** adi,rssi-duration
+	3,		//rssi_restart_mode *** adi,rssi-restart-mode
+	0,		//rssi_unit_is_rx_samples_enable *** adi,rssi-unit-is-rx-samples-enable
+	1,		//rssi_wait *** adi,rssi-wait
+	/* Aux ADC Control */
+	256,	//aux_adc_decimation *** adi,aux-adc-decimation
+	40000000UL,	//aux_adc_rate *** adi,aux-adc-rate
+	/* AuxDAC Control */
+	1,		//aux_dac_manual_mode_enable ***  adi,aux-dac-manual-mode-enable
+	0,		//aux_dac1_default_value_mV ***  adi,aux-dac1-default-value-mV
+	0,		//aux_dac1_active_in_rx_enable ***  adi,aux-dac1-active-in-rx-enable
+	0,		//aux_dac1_active_in_tx_enable ***  adi,aux-dac1-active-in-tx-enable
+	0,		//aux_dac1_active_in_alert_enable ***  adi,aux-dac1-active-in-alert-enable
+	0,		//aux_dac1_rx_delay_us ***  adi,aux-dac1-rx-delay-us
+	0,		//aux_dac1_tx_delay_us ***  adi,aux-dac1-tx-delay-us
+	0,		//aux_dac2_default_value_mV ***  adi,aux-dac2-default-value-mV
+	0,		//aux_dac2_active_in_rx_enable ***  adi,aux-dac2-active-in-rx-enable
+	0,		//aux_dac2_active_in_tx_enable ***  adi,aux-dac2-active-in-tx-enable
+	0,		//aux_dac2_active_in_alert_enable ***  adi,aux-dac2-active-in-alert-enable
+	0,		//aux_dac2_rx_delay_us ***  adi,aux-dac2-rx-delay-us
+	0,		//aux_dac2_tx_delay_us ***  adi,aux-dac2-tx-delay-us
+	/* Temperature Sensor Control */
+	256,	//temp_sense_decimation *** adi,temp-sense-decimation
+	1000,	//temp_sense_measurement_interval_ms *** adi,temp-sense-measurement-interval-ms
+	0xCE,	//temp_sense_offset_signed *** adi,temp-sense-offset-signed
+	1,		//temp_sense_periodic_measurement_enable *** adi,temp-sense-periodic-measurement-enable
+	/* Control Out Setup */
+	0xFF,	//ctrl_outs_enable_mask *** adi,ctrl-outs-enable-mask
+	0,		//ctrl_outs_index *** adi,ctrl-outs-index
+	/* External LNA Control */
+	0,		//elna_settling_delay_ns *** adi,elna-settling-delay-ns
+	0,		//elna_gain_mdB *** adi,elna-gain-mdB
+	0,		//elna_bypass_loss_mdB *** adi,elna-bypass-loss-mdB
+	0,		//elna_rx1_gpo0_control_enable *** adi,elna-rx1-gpo0-control-enable
+	0,		//elna_rx2_gpo1_control_enable *** adi,elna-rx2-gpo1-control-enable
+	0,		//elna_gaintable_all_index_enable *** adi,elna-gaintable-all-index-enable
+	/* Digital Interface Control */
+	0,		//digital_interface_tune_skip_mode *** adi,digital-interface-tune-skip-mode
+	0,		//digital_interface_tune_fir_disable *** adi,digital-interface-tune-fir-disable
+	1,		//pp_tx_swap_enable *** adi,pp-tx-swap-enable
+	1,		//pp_rx_swap_enable *** adi,pp-rx-swap-enable
+	0,		//tx_channel_swap_enable *** adi,tx-channel-swap-enable
+	0,		//rx_channel_swap_enable *** adi,rx-channel-swap-enable
+	1,		//rx_frame_pulse_mode_enable *** adi,rx-frame-pulse-mode-enable
+	0,		//two_t_two_r_timing_enable *** adi,2t2r-timing-enable
+	0,		//invert_data_bus_enable *** adi,invert-data-bus-enable
+	0,		//invert_data_clk_enable *** adi,invert-data-clk-enable
+	0,		//fdd_alt_word_order_enable *** adi,fdd-alt-word-order-enable
+	0,		//invert_rx_frame_enable *** adi,invert-rx-frame-enable
+	0,		//fdd_rx_rate_2tx_enable *** adi,fdd-rx-rate-2tx-enable
+	0,		//swap_ports_enable *** adi,swap-ports-enable
+	0,		//single_data_rate_enable *** adi,single-data-rate-enable
+	1,		//lvds_mode_enable *** adi,lvds-mode-enable
+	0,		//half_duplex_mode_enable *** adi,half-duplex-mode-enable
+	0,		//single_port_mode_enable *** adi,single-port-mode-enable
+	0,		//full_port_enable *** adi,full-port-enable
+	0,		//full_duplex_swap_bits_enable *** adi,full-duplex-swap-bits-enable
+	0,		//delay_rx_data *** adi,delay-rx-data
+	0,		//rx_data_clock_delay *** adi,rx-data-clock-delay
+	4,		//rx_data_delay *** adi,rx-data-delay
+	7,		//tx_fb_clock_delay *** adi,tx-fb-clock-delay
+	0,		//tx_data_delay *** adi,tx-data-delay
+	150,	//lvds_bias_mV *** adi,lvds-bias-mV
+	1,		//lvds_rx_onchip_termination_enable *** adi,lvds-rx-onchip-termination-enable
+	0,		//rx1rx2_phase_inversion_en *** adi,rx1-rx2-phase-inversion-enable
+	0xFF,	//lvds_invert1_control *** adi,lvds-invert1-control
+	0x0F,	//lvds_invert2_control *** adi,lvds-invert2-control
+	/* GPO Control */
+	0,		//gpo_manual_mode_enable *** adi,gpo-manual-mode-enable
+	0,		//gpo_manual_mode_enable_mask *** adi,gpo-manual-mode-enable-mask
+	0,		//gpo0_inactive_state_high_enable *** adi,gpo0-inactive-state-high-enable
+	0,		//gpo1_inactive_state_high_enable *** adi,gpo1-inactive-state-high-enable
+	0,		//gpo2_inactive_state_high_enable *** adi,gpo2-inactive-state-high-enable
+	0,		//gpo3_inactive_state_high_enable *** adi,gpo3-inactive-state-high-enable
+	0,		//gpo0_slave_rx_enable *** adi,gpo0-slave-rx-enable
+	0,		//gpo0_slave_tx_enable *** adi,gpo0-slave-tx-enable
+	0,		//gpo1_slave_rx_enable *** adi,gpo1-slave-rx-enable
+	0,		//gpo1_slave_tx_enable *** adi,gpo1-slave-tx-enable
+	0,		//gpo2_slave_rx_enable *** adi,gpo2-slave-rx-enable
+	0,		//gpo2_slave_tx_enable *** adi,gpo2-slave-tx-enable
+	0,		//gpo3_slave_rx_enable *** adi,gpo3-slave-rx-enable
+	0,		//gpo3_slave_tx_enable *** adi,gpo3-slave-tx-enable
+	0,		//gpo0_rx_delay_us *** adi,gpo0-rx-delay-us
+	0,		//gpo0_tx_delay_us *** adi,gpo0-tx-delay-us
+	0,		//gpo1_rx_delay_us *** adi,gpo1-rx-delay-us
+	0,		//gpo1_tx_delay_us *** adi,gpo1-tx-delay-us
+	0,		//gpo2_rx_delay_us *** adi,gpo2-rx-delay-us
+	0,		//gpo2_tx_delay_us *** adi,gpo2-tx-delay-us
+	0,		//gpo3_rx_delay_us *** adi,gpo3-rx-delay-us
+	0,		//gpo3_tx_delay_us *** adi,gpo3-tx-delay-us
+	/* Tx Monitor Control */
+	37000,	//low_high_gain_threshold_mdB *** adi,txmon-low-high-thresh
+	0,		//low_gain_dB *** adi,txmon-low-gain
+	24,		//high_gain_dB *** adi,txmon-high-gain
+	0,		//tx_mon_track_en *** adi,txmon-dc-tracking-enable
+	0,		//one_shot_mode_en *** adi,txmon-one-shot-mode-enable
+	511,	//tx_mon_delay *** adi,txmon-delay
+	8192,	//tx_mon_duration *** adi,txmon-duration
+	2,		//tx1_mon_front_end_gain *** adi,txmon-1-front-end-gain
+	2,		//tx2_mon_front_end_gain *** adi,txmon-2-front-end-gain
+	48,		//tx1_mon_lo_cm *** adi,txmon-1-lo-cm
+	48,		//tx2_mon_lo_cm *** adi,txmon-2-lo-cm
+	/* GPIO definitions */
+	{
+		.number = -1,
+		.platform_ops = &bench_gpio_ops
+	},		//gpio_resetb *** reset-gpios
+	/* MCS Sync */
+	{
+		.number = -1,
+		.platform_ops = &bench_gpio_ops
+	},		//gpio_sync *** sync-gpios
+
+	{
+		.number = -1,
+		.platform_ops = &bench_gpio_ops
+	},		//gpio_cal_sw1 *** cal-sw1-gpios
+
+	{
+		.number = -1,
+		.platform_ops = &bench_gpio_ops
+	},		//gpio_cal_sw2 *** cal-sw2-gpios
+
+	{
+		.mode = SPI_MODE_1,
+		.chip_select = 0,
+		.extra = &bench_ad9361_spi_param,
+		.platform_ops = &linux_sim_spi_platform_ops
+	},
+
+	/* External LO clocks */
+	NULL,	//(*ad9361_rfpll_ext_recalc_rate)()
+	NULL,	//(*ad9361_rfpll_ext_round_rate)()
+	NULL,	//(*ad9361_rfpll_ext_set_rate)()
+	&bench_ad9361_adc_init,	// *rx_adc_init
+	&bench_ad9361_dac_init,   // *tx_dac_init
+};
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Make the status registers polled by the driver report success.
+ * @param ctx - Not used.
+ * @param regs - Register map.
+ * @param addr - Register being read.
+ */
+static void bench_ad9361_spi_read_hook(void *ctx, uint8_t *regs, uint32_t addr)
+{
+	switch (addr) {
+	case REG_PRODUCT_ID:
+		regs[addr] = PRODUCT_ID_9361 | 0x2;
+		break;
+	case REG_CH_1_OVERFLOW:
+		regs[addr] |= BBPLL_LOCK;
+		break;
+	case REG_RX_CAL_STATUS:
+	case REG_TX_CAL_STATUS:
+		regs[addr] |= CP_CAL_VALID;
+		break;
+	case REG_RX_CP_OVERRANGE_VCO_LOCK:
+	case REG_TX_CP_OVERRANGE_VCO_LOCK:
+		regs[addr] |= VCO_LOCK;
+		break;
+	case REG_CALIBRATION_CTRL:
+		/* Every calibration completes at once */
+		regs[addr] = 0;
+		break;
+	case REG_RX_BBF_R2346:
+	case REG_RX_BBF_C3_MSB:
+	case REG_RX_BBF_C3_LSB:
+		/* Read back by the ADC setup as divisors */
+		if (!regs[addr])
+			regs[addr] = 0x10;
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * @brief Track the interface delays and emulate the ENSM.
+ * @param ctx - Not used.
+ * @param regs - Register map.
+ * @param addr - Register that was written.
+ */
+static void bench_ad9361_spi_write_hook(void *ctx, uint8_t *regs,
+					uint32_t addr)
+{
+	uint8_t val = regs[addr];
+
+	switch (addr) {
+	case REG_RX_CLOCK_DATA_DELAY:
+		bench_ad9361_delay[0] = val;
+		break;
+	case REG_TX_CLOCK_DATA_DELAY:
+		bench_ad9361_delay[1] = val;
+		break;
+	case REG_ENSM_CONFIG_1:
+		if (val & FORCE_TX_ON)
+			regs[REG_STATE] = (regs[REG_ENSM_MODE] & FDD_MODE) ?
+					  ENSM_STATE_FDD : ENSM_STATE_TX;
+		else if (val & FORCE_RX_ON)
+			regs[REG_STATE] = ENSM_STATE_RX;
+		else if (val & (TO_ALERT | FORCE_ALERT_STATE))
+			regs[REG_STATE] = ENSM_STATE_ALERT;
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * @brief Check a clock/data delay pair against a passing window.
+ * @param val - Delay register value.
+ * @param min - Lowest passing (clock delay - data delay).
+ * @param max - Highest passing (clock delay - data delay).
+ * @return true if the interface passes.
+ */
+static bool bench_ad9361_delay_ok(uint8_t val, int32_t min, int32_t max)
+{
+	int32_t diff = (int32_t)(val >> 4) - (int32_t)(val & 0xF);
+
+	return diff >= min && diff <= max;
+}
+
+/**
+ * @brief Report PN errors on the ADC channels while a delay is out of its
+ * window.
+ * @param ctx - Not used.
+ * @param regs - Register map of the ADC core.
+ * @param offset - Register being read.
+ */
+static void bench_ad9361_adc_read_hook(void *ctx, uint32_t *regs,
+				       uint32_t offset)
+{
+	uint32_t ch;
+
+	for (ch = 0; ch < BENCH_AD9361_NUM_CHANNELS; ch++) {
+		if (offset != AXI_ADC_REG_CHAN_STATUS(ch))
+			continue;
+
+		if (bench_ad9361_delay_ok(bench_ad9361_delay[0],
+					  BENCH_AD9361_RX_WIN_MIN,
+					  BENCH_AD9361_RX_WIN_MAX) &&
+		    bench_ad9361_delay_ok(bench_ad9361_delay[1],
+					  BENCH_AD9361_TX_WIN_MIN,
+					  BENCH_AD9361_TX_WIN_MAX))
+			regs[offset / 4] = 0;
+		else
+			regs[offset / 4] = AXI_ADC_PN_ERR | AXI_ADC_PN_OOS;
+	}
+}
+
+/**
+ * @brief Map the ADC and DAC cores.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_ad9361_add_regions(void)
+{
+	struct linux_sim_axi_io_region adc = {
+		.base = BENCH_AD9361_ADC_BASE,
+		.size = BENCH_AD9361_REGION_SIZE,
+		.model = LINUX_SIM_AXI_IO_RAM,
+		.read_hook = bench_ad9361_adc_read_hook,
+	};
+	struct linux_sim_axi_io_region dac = {
+		.base = BENCH_AD9361_DAC_BASE,
+		.size = BENCH_AD9361_REGION_SIZE,
+		.model = LINUX_SIM_AXI_IO_RAM,
+	};
+	int32_t ret;
+
+	ret = linux_sim_axi_io_add(&adc);
+	if (ret < 0)
+		return ret;
+
+	ret = linux_sim_axi_io_add(&dac);
+	if (ret < 0)
+		return ret;
+
+	/* The ADC core reports its status once out of reset */
+	return axi_io_write(BENCH_AD9361_ADC_BASE, AXI_ADC_REG_STATUS, 1);
+}
+
+static int32_t bench_ad9361_init_setup(void **ctx)
+{
+	return bench_ad9361_add_regions();
+}
+
+/**
+ * @brief Initialize the device, digital interface tuning included, and free
+ * it again.
+ */
+static int32_t bench_ad9361_init_run(void *ctx, struct bench_result *res)
+{
+	struct linux_sim_axi_io_stats adc_stats;
+	struct linux_sim_spi_stats spi_stats;
+	struct ad9361_rf_phy *phy;
+	int32_t ret;
+
+	linux_sim_axi_io_reset_stats(BENCH_AD9361_ADC_BASE);
+
+	ret = ad9361_init(&phy, &bench_ad9361_param);
+	if (ret < 0)
+		return ret;
+
+	linux_sim_spi_get_stats(phy->spi, &spi_stats);
+	linux_sim_axi_io_get_stats(BENCH_AD9361_ADC_BASE, &adc_stats);
+
+	bench_counter(res, "spi_transfers", spi_stats.transfers);
+	bench_counter(res, "spi_bytes", spi_stats.bytes);
+	bench_counter(res, "reg_reads", spi_stats.reg_reads);
+	bench_counter(res, "reg_writes", spi_stats.reg_writes);
+	bench_counter(res, "adc_mmio", adc_stats.reads + adc_stats.writes);
+	bench_counter(res, "dig_tune_pn_checks", phy->dig_tune_pn_checks);
+
+	axi_adc_remove(phy->rx_adc);
+
+	return ad9361_remove(phy);
+}
+
+static void bench_ad9361_teardown(void *ctx)
+{
+	linux_sim_axi_io_remove_all();
+}
+
+static int32_t bench_ad9361_attr_setup(void **ctx)
+{
+	struct iio_ad9361_init_param iio_init;
+	struct bench_ad9361_ctx *bctx;
+	int32_t ret;
+
+	bctx = calloc(1, sizeof(*bctx));
+	if (!bctx)
+		return -ENOMEM;
+
+	ret = bench_ad9361_add_regions();
+	if (ret < 0)
+		goto error_free;
+
+	ret = ad9361_init(&bctx->phy, &bench_ad9361_param);
+	if (ret < 0)
+		goto error_free;
+
+	iio_init.ad9361_phy = bctx->phy;
+	ret = iio_ad9361_init(&bctx->iio, &iio_init);
+	if (ret < 0)
+		goto error_phy;
+
+	*ctx = bctx;
+
+	return 0;
+
+error_phy:
+	axi_adc_remove(bctx->phy->rx_adc);
+	ad9361_remove(bctx->phy);
+error_free:
+	free(bctx);
+
+	return ret;
+}
+
+/**
+ * @brief Read a list of attributes.
+ * @param dev - Device instance passed to the show callbacks.
+ * @param attr - Attributes, terminated by one without a name.
+ * @param ch - Channel, NULL for the device attributes.
+ * @param errors - Incremented for every failed read.
+ * @return Number of attributes read.
+ */
+static uint32_t bench_ad9361_show_all(void *dev, struct iio_attribute *attr,
+				      const struct iio_ch_info *ch,
+				      uint32_t *errors)
+{
+	struct iio_ch_info no_ch = { .ch_num = 0, .ch_out = false };
+	char buf[128];
+	uint32_t nb = 0;
+
+	for (; attr && attr->name; attr++) {
+		if (!attr->show)
+			continue;
+
+		if (attr->show(dev, buf, sizeof(buf), ch ? ch : &no_ch,
+			       attr->priv) < 0)
+			(*errors)++;
+		nb++;
+	}
+
+	return nb;
+}
+
+/**
+ * @brief Read every device and channel attribute once, as an IIO client
+ * listing the device does.
+ */
+static int32_t bench_ad9361_attr_run(void *ctx, struct bench_result *res)
+{
+	struct bench_ad9361_ctx *bctx = ctx;
+	struct linux_sim_spi_stats spi_stats;
+	struct iio_device *dev;
+	struct iio_ch_info ch;
+	uint32_t i, nb, errors = 0;
+
+	iio_ad9361_get_dev_descriptor(bctx->iio, &dev);
+	linux_sim_spi_reset_stats(bctx->phy->spi);
+
+	nb = bench_ad9361_show_all(bctx->phy, dev->attributes, NULL, &errors);
+	for (i = 0; i < dev->num_ch; i++) {
+		ch.ch_num = dev->channels[i].scan_index;
+		ch.ch_out = dev->channels[i].ch_out;
+		nb += bench_ad9361_show_all(bctx->phy,
+					    dev->channels[i].attributes, &ch,
+					    &errors);
+	}
+
+	linux_sim_spi_get_stats(bctx->phy->spi, &spi_stats);
+
+	bench_counter(res, "attributes", nb);
+	bench_counter(res, "errors", errors);
+	bench_counter(res, "spi_transfers", spi_stats.transfers);
+	bench_counter(res, "reg_reads", spi_stats.reg_reads);
+
+	return 0;
+}
+
+static void bench_ad9361_attr_teardown(void *ctx)
+{
+	struct bench_ad9361_ctx *bctx = ctx;
+
+	iio_ad9361_remove(bctx->iio);
+	axi_adc_remove(bctx->phy->rx_adc);
+	ad9361_remove(bctx->phy);
+	free(bctx);
+	bench_ad9361_teardown(NULL);
+}
+
+const struct bench_case bench_ad9361_init = {
+	.name = "ad9361_init",
+	.iterations = 3,
+	.setup = bench_ad9361_init_setup,
+	.run = bench_ad9361_init_run,
+	.teardown = bench_ad9361_teardown,
+};
+
+const struct bench_case bench_iio_ad9361_attr = {
+	.name = "iio_ad9361_attr",
+	.iterations = 20,
+	.setup = bench_ad9361_attr_setup,
+	.run = bench_ad9361_attr_run,
+	.teardown = bench_ad9361_attr_teardown,
+};
@@ -0,0 +1,194 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench_ad9371.c
+ *   @brief  AD9371 HAL SPI streaming and timeouts on a simulated SPI device.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include "adi_hal/common.h"
+#include "spi.h"
+#include "gpio.h"
+#include "spi_extra.h"
+#include "gpio_extra.h"
+#include "linux_sim_spi.h"
+#include "error.h"
+#include "bench.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_AD9371_MAP_SIZE		0x1000
+#define BENCH_AD9371_WRITES		340
+#define BENCH_AD9371_FIRST_ADDR		0x100
+#define BENCH_AD9371_TIMEOUT_US		2000
+
+/******************************************************************************/
+/************************ Variable Definitions ********************************/
+/******************************************************************************/
+
+/* Set up by common.c in platform_init(), which the runner does not call */
+extern struct spi_desc *spi_ad_desc;
+const struct spi_platform_ops xil_platform_ops;
+const struct gpio_platform_ops xil_gpio_platform_ops;
+
+/* Mykonos instruction word: read bit, 15-bit address, address increments */
+static struct linux_sim_spi_init_param bench_ad9371_spi_param = {
+	.proto = &linux_sim_spi_proto_ad9081,
+	.map_size = BENCH_AD9371_MAP_SIZE,
+};
+
+/* Settings of the profiles, see myk.c */
+static spiSettings_t bench_ad9371_spi_settings = {
+	.chipSelectIndex = 2,
+	.writeBitPolarity = 0,
+	.longInstructionWord = 1,
+	.MSBFirst = 1,
+	.enSpiStreaming = 1,
+	.autoIncAddrUp = 1,
+	.fourWireMode = 1,
+	.spiClkFreq_Hz = 25000000,
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static int32_t bench_ad9371_setup(void **ctx)
+{
+	struct spi_init_param init = {
+		.max_speed_hz = 2000000,
+		.mode = SPI_MODE_0,
+		.platform_ops = &linux_sim_spi_platform_ops,
+		.extra = &bench_ad9371_spi_param,
+	};
+
+	return spi_init(&spi_ad_desc, &init);
+}
+
+/**
+ * @brief Write a block of consecutive registers with and without streaming.
+ */
+static int32_t bench_ad9371_write_bytes_run(void *ctx,
+		struct bench_result *res)
+{
+	uint16_t addr[BENCH_AD9371_WRITES];
+	uint8_t data[BENCH_AD9371_WRITES];
+	struct linux_sim_spi_stats stats;
+	uint8_t val;
+	uint32_t i;
+
+	for (i = 0; i < BENCH_AD9371_WRITES; i++) {
+		addr[i] = BENCH_AD9371_FIRST_ADDR + i;
+		data[i] = i;
+	}
+
+	bench_ad9371_spi_settings.enSpiStreaming = 0;
+	linux_sim_spi_reset_stats(spi_ad_desc);
+	if (CMB_SPIWriteBytes(&bench_ad9371_spi_settings, addr, data,
+			      BENCH_AD9371_WRITES) != COMMONERR_OK)
+		return -EIO;
+	linux_sim_spi_get_stats(spi_ad_desc, &stats);
+	bench_counter(res, "single_transfers", stats.transfers);
+	bench_counter(res, "single_bytes", stats.bytes);
+
+	for (i = 0; i < BENCH_AD9371_WRITES; i++)
+		data[i] = ~i;
+
+	bench_ad9371_spi_settings.enSpiStreaming = 1;
+	linux_sim_spi_reset_stats(spi_ad_desc);
+	if (CMB_SPIWriteBytes(&bench_ad9371_spi_settings, addr, data,
+			      BENCH_AD9371_WRITES) != COMMONERR_OK)
+		return -EIO;
+	linux_sim_spi_get_stats(spi_ad_desc, &stats);
+	bench_counter(res, "stream_transfers", stats.transfers);
+	bench_counter(res, "stream_bytes", stats.bytes);
+
+	for (i = 0; i < BENCH_AD9371_WRITES; i++) {
+		linux_sim_spi_reg_get(spi_ad_desc, addr[i], &val);
+		if (val != data[i])
+			return -EIO;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Poll a register until a timeout expires, as the calibration waits
+ * of the Mykonos API do. The timeout must not expire early.
+ */
+static int32_t bench_ad9371_timeout_run(void *ctx, struct bench_result *res)
+{
+	uint64_t start;
+	uint8_t val;
+
+	start = bench_time_ns();
+	CMB_setTimeout_us(BENCH_AD9371_TIMEOUT_US);
+	while (CMB_hasTimeoutExpired() == COMMONERR_OK)
+		if (CMB_SPIReadByte(&bench_ad9371_spi_settings,
+				    BENCH_AD9371_FIRST_ADDR, &val) != COMMONERR_OK)
+			return -EIO;
+
+	if (bench_time_ns() - start < BENCH_AD9371_TIMEOUT_US * 1000ull)
+		return -ETIMEDOUT;
+
+	return 0;
+}
+
+static void bench_ad9371_teardown(void *ctx)
+{
+	spi_remove(spi_ad_desc);
+	spi_ad_desc = NULL;
+}
+
+const struct bench_case bench_ad9371_write_bytes = {
+	.name = "ad9371_spi_write_bytes",
+	.iterations = 100,
+	.setup = bench_ad9371_setup,
+	.run = bench_ad9371_write_bytes_run,
+	.teardown = bench_ad9371_teardown,
+};
+
+const struct bench_case bench_ad9371_timeout = {
+	.name = "ad9371_hal_timeout",
+	.iterations = 5,
+	.setup = bench_ad9371_setup,
+	.run = bench_ad9371_timeout_run,
+	.teardown = bench_ad9371_teardown,
+};
@@ -0,0 +1,369 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench_adpd410x.c
+ *   @brief  ADPD4101 FIFO reads on a simulated I2C device.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "adpd410x.h"
+#include "error.h"
+#include "util.h"
+#include "bench.h"
+#include "bench_platform.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_ADPD410X_ADDRESS		0x24
+/* Registers up to the last time slot */
+#define BENCH_ADPD410X_REGS		ADPD410X_REG_TS_CTRL(ADPD410X_MAX_SLOT_NUMBER)
+/* Slot A: two channels of 4 bytes, slot B: one channel of 3 bytes */
+#define BENCH_ADPD410X_SAMPLES		3
+#define BENCH_ADPD410X_PACKET_BYTES	11
+#define BENCH_ADPD410X_PACKETS		(ADPD410X_FIFO_SIZE / \
+					 BENCH_ADPD410X_PACKET_BYTES)
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_adpd410x_model
+ * @brief State of the simulated ADPD4101. Registers are 16 bits wide, read
+ * with auto increment after a two byte address. Reads of the FIFO data
+ * register pop the FIFO.
+ */
+struct bench_adpd410x_model {
+	/** Register map */
+	uint16_t regs[BENCH_ADPD410X_REGS];
+	/** Register addressed by the last write */
+	uint16_t addr;
+	/** Byte of the addressed register returned next */
+	uint8_t lsb;
+	/** FIFO contents */
+	uint8_t fifo[ADPD410X_FIFO_SIZE];
+	/** Bytes in the FIFO */
+	uint16_t fifo_level;
+	/** Next byte popped from the FIFO */
+	uint16_t fifo_pos;
+	/** I2C transfers */
+	uint32_t transfers;
+	/** Bytes on the bus, address bytes included */
+	uint32_t bytes;
+	/** Longest read */
+	uint32_t max_read;
+};
+
+/**
+ * @struct bench_adpd410x_ctx
+ * @brief State of a case.
+ */
+struct bench_adpd410x_ctx {
+	/** Simulated device */
+	struct bench_adpd410x_model model;
+	/** ADPD4101 */
+	struct adpd410x_dev *dev;
+	/** Samples written to the FIFO */
+	uint32_t expected[BENCH_ADPD410X_PACKETS * BENCH_ADPD410X_SAMPLES];
+	/** Samples read back */
+	uint32_t data[BENCH_ADPD410X_PACKETS * BENCH_ADPD410X_SAMPLES];
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static int32_t bench_adpd410x_i2c_init(struct i2c_desc **desc,
+				       const struct i2c_init_param *param)
+{
+	struct i2c_desc *descriptor;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	descriptor->slave_address = param->slave_address;
+	descriptor->extra = param->extra;
+	*desc = descriptor;
+
+	return SUCCESS;
+}
+
+static int32_t bench_adpd410x_i2c_remove(struct i2c_desc *desc)
+{
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Address a register, or write it when the data follows the address.
+ */
+static int32_t bench_adpd410x_i2c_write(struct i2c_desc *desc, uint8_t *data,
+					uint8_t bytes_number, uint8_t stop_bit)
+{
+	struct bench_adpd410x_model *model = desc->extra;
+	uint16_t addr;
+
+	model->transfers++;
+	model->bytes += bytes_number;
+	if (bytes_number != 2 && bytes_number != 4)
+		return -EINVAL;
+
+	addr = ((uint16_t)(data[0] & 0x7f) << 8) | data[1];
+	if (addr >= BENCH_ADPD410X_REGS)
+		return -EINVAL;
+
+	model->addr = addr;
+	model->lsb = 0;
+	if (bytes_number == 4)
+		model->regs[addr] = ((uint16_t)data[2] << 8) | data[3];
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read from the addressed register, popping the FIFO when it is the
+ * FIFO data register.
+ */
+static int32_t bench_adpd410x_i2c_read(struct i2c_desc *desc, uint8_t *data,
+				       uint8_t bytes_number, uint8_t stop_bit)
+{
+	struct bench_adpd410x_model *model = desc->extra;
+	uint16_t val;
+	uint8_t i;
+
+	model->transfers++;
+	model->bytes += bytes_number;
+	model->max_read = max(model->max_read, (uint32_t)bytes_number);
+
+	model->regs[ADPD410X_REG_FIFO_STATUS] = model->fifo_level -
+						model->fifo_pos;
+	for (i = 0; i < bytes_number; i++) {
+		if (model->addr == ADPD410X_REG_FIFO_DATA) {
+			data[i] = model->fifo_pos < model->fifo_level ?
+				  model->fifo[model->fifo_pos++] : 0;
+			continue;
+		}
+
+		if (model->addr >= BENCH_ADPD410X_REGS)
+			return -EINVAL;
+		val = model->regs[model->addr];
+		data[i] = model->lsb ? val : val >> 8;
+		model->lsb ^= 1;
+		if (!model->lsb)
+			model->addr++;
+	}
+
+	return SUCCESS;
+}
+
+static int32_t bench_adpd410x_i2c_write_read(struct i2c_desc *desc,
+		uint8_t *tx_data, uint8_t tx_bytes, uint8_t *rx_data,
+		uint8_t rx_bytes)
+{
+	struct bench_adpd410x_model *model = desc->extra;
+	int32_t ret;
+
+	ret = bench_adpd410x_i2c_write(desc, tx_data, tx_bytes, 0);
+	if (ret != SUCCESS)
+		return ret;
+	ret = bench_adpd410x_i2c_read(desc, rx_data, rx_bytes, 1);
+	/* One transaction with a repeated start */
+	model->transfers--;
+
+	return ret;
+}
+
+static const struct i2c_platform_ops bench_adpd410x_i2c_ops = {
+	.i2c_ops_init = &bench_adpd410x_i2c_init,
+	.i2c_ops_write = &bench_adpd410x_i2c_write,
+	.i2c_ops_read = &bench_adpd410x_i2c_read,
+	.i2c_ops_write_read = &bench_adpd410x_i2c_write_read,
+	.i2c_ops_remove = &bench_adpd410x_i2c_remove,
+};
+
+/**
+ * @brief Fill the FIFO with full packets of known samples, in the byte order
+ * of the device.
+ */
+static void bench_adpd410x_fill_fifo(struct bench_adpd410x_ctx *actx,
+				     uint32_t seed)
+{
+	static const uint8_t sizes[BENCH_ADPD410X_SAMPLES] = {4, 4, 3};
+	static const uint8_t shift[][ADPD410X_MAX_SAMPLE_BYTES] = {
+		[3] = {8, 0, 16},
+		[4] = {8, 0, 24, 16},
+	};
+	struct bench_adpd410x_model *model = &actx->model;
+	uint32_t *sample = actx->expected;
+	uint8_t *byte = model->fifo;
+	uint16_t i;
+	uint8_t j, k;
+
+	for (i = 0; i < BENCH_ADPD410X_PACKETS; i++) {
+		for (j = 0; j < BENCH_ADPD410X_SAMPLES; j++) {
+			*sample = (seed + i * 0x01030507u + j * 0x10204080u) &
+				  (0xffffffffu >> (8 * (4 - sizes[j])));
+			for (k = 0; k < sizes[j]; k++)
+				*byte++ = *sample >> shift[sizes[j]][k];
+			sample++;
+		}
+	}
+
+	model->fifo_level = byte - model->fifo;
+	model->fifo_pos = 0;
+}
+
+static int32_t bench_adpd410x_setup(void **ctx)
+{
+	struct bench_adpd410x_ctx *actx;
+	struct adpd410x_init_param init = {
+		.dev_ops_init = {
+			.i2c_phy_init = {
+				.max_speed_hz = 400000,
+				.slave_address = BENCH_ADPD410X_ADDRESS,
+				.platform_ops = &bench_adpd410x_i2c_ops,
+			},
+		},
+		.dev_type = ADPD4101,
+		.clk_opt = ADPD410X_INTLFO_INTHFO,
+		.gpio0 = {.number = 0, .platform_ops = &bench_gpio_ops},
+		.gpio1 = {.number = 1, .platform_ops = &bench_gpio_ops},
+		.gpio2 = {.number = 2, .platform_ops = &bench_gpio_ops},
+		.gpio3 = {.number = 3, .platform_ops = &bench_gpio_ops},
+	};
+	int32_t ret;
+
+	actx = calloc(1, sizeof(*actx));
+	if (!actx)
+		return -ENOMEM;
+
+	actx->model.regs[ADPD410X_REG_CHIP_ID] = ADPD410X_CHIP_ID;
+	init.dev_ops_init.i2c_phy_init.extra = &actx->model;
+	ret = adpd410x_setup(&actx->dev, &init);
+	if (ret != SUCCESS)
+		goto error;
+
+	ret = adpd410x_set_last_timeslot(actx->dev, ADPD410X_TS_B);
+	if (ret != SUCCESS)
+		goto error_dev;
+	ret = adpd410x_reg_write(actx->dev, ADPD410X_REG_DATA1(0), 4);
+	if (ret != SUCCESS)
+		goto error_dev;
+	ret = adpd410x_reg_write(actx->dev, ADPD410X_REG_TS_CTRL(0),
+				 BITM_TS_CTRL_A_CH2_EN);
+	if (ret != SUCCESS)
+		goto error_dev;
+	ret = adpd410x_reg_write(actx->dev, ADPD410X_REG_DATA1(1), 3);
+	if (ret != SUCCESS)
+		goto error_dev;
+
+	*ctx = actx;
+
+	return SUCCESS;
+
+error_dev:
+	adpd410x_remove(actx->dev);
+error:
+	free(actx);
+
+	return ret;
+}
+
+/**
+ * @brief Read a full FIFO, 506 bytes, in one adpd410x_get_data_packets() call.
+ */
+static int32_t bench_adpd410x_fifo_run(void *ctx, struct bench_result *res)
+{
+	struct bench_adpd410x_ctx *actx = ctx;
+	struct bench_adpd410x_model *model = &actx->model;
+	uint16_t packets;
+	uint16_t bytes;
+	uint8_t samples;
+	int32_t ret;
+
+	ret = adpd410x_get_packet_layout(actx->dev, &samples, &bytes);
+	if (ret != SUCCESS)
+		return ret;
+	if (samples != BENCH_ADPD410X_SAMPLES ||
+	    bytes != BENCH_ADPD410X_PACKET_BYTES)
+		return -EIO;
+
+	bench_adpd410x_fill_fifo(actx, 0x00a5c3e1);
+	memset(actx->data, 0, sizeof(actx->data));
+	model->transfers = 0;
+	model->bytes = 0;
+	model->max_read = 0;
+
+	ret = adpd410x_get_data_packets(actx->dev, actx->data,
+					BENCH_ADPD410X_PACKETS, &packets);
+	if (ret != SUCCESS)
+		return ret;
+
+	bench_counter(res, "transfers", model->transfers);
+	bench_counter(res, "bytes", model->bytes);
+	bench_counter(res, "max_read", model->max_read);
+
+	if (packets != BENCH_ADPD410X_PACKETS ||
+	    model->fifo_pos != model->fifo_level)
+		return -EIO;
+	if (memcmp(actx->data, actx->expected, sizeof(actx->data)))
+		return -EIO;
+
+	return SUCCESS;
+}
+
+static void bench_adpd410x_teardown(void *ctx)
+{
+	struct bench_adpd410x_ctx *actx = ctx;
+
+	adpd410x_remove(actx->dev);
+	free(actx);
+}
+
+const struct bench_case bench_adpd410x_fifo_read = {
+	.name = "adpd410x_fifo_read",
+	.iterations = 100,
+	.setup = bench_adpd410x_setup,
+	.run = bench_adpd410x_fifo_run,
+	.teardown = bench_adpd410x_teardown,
+};
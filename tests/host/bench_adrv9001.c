@@ -0,0 +1,766 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench_adrv9001.c
+ *   @brief  ADRV9001 init register sequences on a simulated SPI device.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include "spi.h"
+#include "linux_sim_spi.h"
+#include "adi_platform.h"
+#include "adi_adrv9001.h"
+#include "adi_adrv9001_spi.h"
+#include "adi_adrv9001_ssi.h"
+#include "adi_adrv9001_arm.h"
+#include "adi_adrv9001_utilities.h"
+#include "adrv9001_arm_macros.h"
+#include "adrv9001_binary.h"
+#include "adrv9001_init.h"
+#include "adrv9002.h"
+#include "error.h"
+#include "util.h"
+#include "bench.h"
+#include "RxGainTable.h"
+#include "TxAttenTable.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* 15-bit register address space */
+#define BENCH_ADRV9001_MAP_SIZE		0x8000
+/* Longest SPI transfer of the no-OS HAL */
+#define BENCH_ADRV9001_SPI_MAX		4096
+/* Tables loaded on both channels */
+#define BENCH_ADRV9001_CHANNELS		(ADI_CHANNEL_1 | ADI_CHANNEL_2)
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_adrv9001_run
+ * @brief One run of a register sequence on its own simulated device.
+ */
+struct bench_adrv9001_run {
+	/** Simulated device */
+	struct spi_desc *spi;
+	/** API device */
+	adi_adrv9001_Device_t device;
+	/** Number of registers written */
+	uint32_t writes;
+	/** FNV-1a hash of the written addresses and values, in order */
+	uint32_t writes_hash;
+};
+
+/**
+ * @struct bench_adrv9001_ctx
+ * @brief State of a case: the same sequence with and without a write batch.
+ */
+struct bench_adrv9001_ctx {
+	/** Writes sent as they are issued */
+	struct bench_adrv9001_run plain;
+	/** Writes held back in an adi_adrv9001_spi_Batch_Begin() batch */
+	struct bench_adrv9001_run batched;
+};
+
+/**
+ * @struct bench_adrv9001_load_ctx
+ * @brief State of a load case: the same content loaded from the C structures
+ * of the adrv9001 project and from its binary form.
+ */
+struct bench_adrv9001_load_ctx {
+	/** Loaded from the C structures */
+	struct bench_adrv9001_run text;
+	/** Loaded from the binaries */
+	struct bench_adrv9001_run binary;
+	/** Binary of RxGainTable */
+	uint8_t *rx_gain;
+	uint32_t rx_gain_len;
+	/** Binary of TxAttenTable */
+	uint8_t *tx_atten;
+	uint32_t tx_atten_len;
+	/** Binary of adrv9002_init_lvds */
+	uint8_t *profile;
+	uint32_t profile_len;
+	/** Profile parsed from the binary */
+	adi_adrv9001_Init_t init;
+};
+
+/******************************************************************************/
+/************************ Variable Definitions ********************************/
+/******************************************************************************/
+
+/* Defined in adrv9002_init_data.c, the profile loaded by the adrv9001 project */
+extern struct adi_adrv9001_Init adrv9002_init_lvds;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Record a register write, and complete a hardware read-modify-write
+ * when its data register is written.
+ */
+static void bench_adrv9001_write_hook(void *ctx, uint8_t *regs, uint32_t addr)
+{
+	struct bench_adrv9001_run *run = ctx;
+	uint8_t bytes[3] = {addr >> 8, addr, regs[addr]};
+	uint16_t target;
+	uint8_t mask;
+	uint32_t i;
+
+	run->writes++;
+	for (i = 0; i < ARRAY_SIZE(bytes); i++)
+		run->writes_hash = (run->writes_hash ^ bytes[i]) * 16777619u;
+
+	if (addr != ADRV9001_HW_RMW_DATA)
+		return;
+
+	target = ((uint16_t)regs[ADRV9001_HW_RMW_HI_ADDR] << 8) |
+		 regs[ADRV9001_HW_RMW_LO_ADDR];
+	mask = regs[ADRV9001_HW_RMW_MASK];
+	if (target < BENCH_ADRV9001_MAP_SIZE)
+		regs[target] = (regs[target] & ~mask) | (regs[addr] & mask);
+}
+
+/**
+ * @brief HAL SPI write, split in transfers like the no-OS platform HAL.
+ */
+static int32_t bench_adrv9001_spi_write(void *devHalCfg, const uint8_t txData[],
+					uint32_t numTxBytes)
+{
+	uint8_t buf[BENCH_ADRV9001_SPI_MAX];
+	uint32_t offset;
+	uint32_t len;
+	int32_t ret;
+
+	for (offset = 0; offset < numTxBytes; offset += len) {
+		len = min_t(uint32_t, numTxBytes - offset, sizeof(buf));
+		memcpy(buf, &txData[offset], len);
+		ret = spi_write_and_read(devHalCfg, buf, len);
+		if (ret != SUCCESS)
+			return ADI_COMMON_HAL_SPI_FAIL;
+	}
+
+	return ADI_COMMON_HAL_OK;
+}
+
+/**
+ * @brief HAL SPI read, split in transfers like the no-OS platform HAL.
+ */
+static int32_t bench_adrv9001_spi_read(void *devHalCfg, const uint8_t txData[],
+				       uint8_t rxData[], uint32_t numRxBytes)
+{
+	uint32_t offset;
+	uint32_t len;
+	int32_t ret;
+
+	memcpy(rxData, txData, numRxBytes);
+	for (offset = 0; offset < numRxBytes; offset += len) {
+		len = min_t(uint32_t, numRxBytes - offset, BENCH_ADRV9001_SPI_MAX);
+		ret = spi_write_and_read(devHalCfg, &rxData[offset], len);
+		if (ret != SUCCESS)
+			return ADI_COMMON_HAL_SPI_FAIL;
+	}
+
+	return ADI_COMMON_HAL_OK;
+}
+
+static int32_t bench_adrv9001_log_write(void *devHalCfg, int32_t logLevel,
+					const char *comment, va_list argp)
+{
+	return ADI_COMMON_HAL_OK;
+}
+
+static int32_t bench_adrv9001_wait_us(void *devHalCfg, uint32_t time_us)
+{
+	return ADI_COMMON_HAL_OK;
+}
+
+static int32_t bench_adrv9001_wait_ms(void *devHalCfg, uint32_t time_ms)
+{
+	return ADI_COMMON_HAL_OK;
+}
+
+/**
+ * @brief HAL Rx gain table row, from the C structure like the no-OS platform
+ * HAL. A row of zeros past the end stops the loader.
+ */
+static int32_t bench_adrv9001_rx_gain_entry_get(void *devHalCfg,
+		const char *rxGainTablePath, uint16_t lineCount, uint8_t *gainIndex,
+		uint8_t *rxFeGain, uint8_t *tiaControl, uint8_t *adcControl,
+		uint8_t *extControl, uint16_t *phaseOffset, int16_t *digGain)
+{
+	struct RxGainTableEntry end = {0};
+	struct RxGainTableEntry *row = &end;
+
+	if (strcmp(rxGainTablePath, "RxGainTable.csv"))
+		return -EINVAL;
+
+	if (lineCount < ARRAY_SIZE(RxGainTable))
+		row = &RxGainTable[lineCount];
+
+	*gainIndex = row->gainIndex;
+	*rxFeGain = row->rxFeGain;
+	*tiaControl = row->tiaControl;
+	*adcControl = row->adcControl;
+	*extControl = row->extControl;
+	*phaseOffset = row->phaseOffset;
+	*digGain = row->digGain;
+
+	return 7;
+}
+
+/**
+ * @brief HAL Tx atten table row, from the C structure like the no-OS platform
+ * HAL.
+ */
+static int32_t bench_adrv9001_tx_atten_entry_get(void *devHalCfg,
+		const char *txAttenTablePath, uint16_t lineCount,
+		uint16_t *attenIndex, uint8_t *txAttenHp, uint16_t *txAttenMult)
+{
+	if (lineCount >= ARRAY_SIZE(TxAttenTable))
+		return -EINVAL;
+
+	*attenIndex = TxAttenTable[lineCount].attenIndex;
+	*txAttenHp = TxAttenTable[lineCount].txAttenHp;
+	*txAttenMult = TxAttenTable[lineCount].txAttenMult;
+
+	return 3;
+}
+
+/*
+ * HAL of the ADRV9001 API, no_os_platform.c on the target. Only SPI, logging,
+ * waits and the table rows are used by the sequences under test.
+ */
+int32_t (*adi_hal_HwOpen)(void *devHalCfg);
+int32_t (*adi_hal_HwClose)(void *devHalCfg);
+int32_t (*adi_hal_HwReset)(void *devHalCfg, uint8_t pinLevel);
+int32_t (*adi_hal_SpiWrite)(void *devHalCfg, const uint8_t txData[],
+			    uint32_t numTxBytes) = bench_adrv9001_spi_write;
+int32_t (*adi_hal_SpiRead)(void *devHalCfg, const uint8_t txData[],
+			   uint8_t rxData[], uint32_t numRxBytes) = bench_adrv9001_spi_read;
+int32_t (*adi_hal_LogFileOpen)(void *devHalCfg, const char *filename);
+int32_t (*adi_hal_LogFileClose)(void *devHalCfg);
+int32_t (*adi_hal_LogLevelSet)(void *devHalCfg, int32_t logLevel);
+int32_t (*adi_hal_LogLevelGet)(void *devHalCfg, int32_t *logLevel);
+int32_t (*adi_hal_LogWrite)(void *devHalCfg, int32_t logLevel,
+			    const char *comment, va_list argp) = bench_adrv9001_log_write;
+int32_t (*adi_hal_Wait_us)(void *devHalCfg,
+			   uint32_t time_us) = bench_adrv9001_wait_us;
+int32_t (*adi_hal_Wait_ms)(void *devHalCfg,
+			   uint32_t time_ms) = bench_adrv9001_wait_ms;
+int32_t (*adi_hal_Mcs_Pulse)(void *devHalCfg, uint8_t numberOfPulses);
+int32_t (*adi_hal_ssi_Reset)(void *devHalCfg);
+int32_t (*adi_hal_ArmImagePageGet)(void *devHalCfg, const char *armImagePath,
+				   uint32_t pageIndex, uint32_t pageSize,
+				   uint8_t *rdBuff);
+int32_t (*adi_hal_StreamImagePageGet)(void *devHalCfg,
+				      const char *streamImagePath,
+				      uint32_t pageIndex, uint32_t pageSize,
+				      uint8_t *rdBuff);
+int32_t (*adi_hal_ArmImageGet)(void *devHalCfg, const char *armImagePath,
+			       const uint8_t **image, uint32_t *size);
+int32_t (*adi_hal_RxGainTableEntryGet)(void *devHalCfg,
+				       const char *rxGainTablePath,
+				       uint16_t lineCount, uint8_t *gainIndex,
+				       uint8_t *rxFeGain, uint8_t *tiaControl,
+				       uint8_t *adcControl, uint8_t *extControl,
+				       uint16_t *phaseOffset, int16_t *digGain) =
+	bench_adrv9001_rx_gain_entry_get;
+int32_t (*adi_hal_TxAttenTableEntryGet)(void *devHalCfg,
+					const char *txAttenTablePath,
+					uint16_t lineCount,
+					uint16_t *attenIndex,
+					uint8_t *txAttenHp,
+					uint16_t *txAttenMult) =
+	bench_adrv9001_tx_atten_entry_get;
+
+/**
+ * @brief Create a simulated device and an API device using it.
+ */
+static int32_t bench_adrv9001_run_init(struct bench_adrv9001_run *run)
+{
+	struct linux_sim_spi_init_param sim_init = {
+		.proto = &linux_sim_spi_proto_adrv9001,
+		.map_size = BENCH_ADRV9001_MAP_SIZE,
+		.write_hook = bench_adrv9001_write_hook,
+		.hook_ctx = run,
+	};
+	struct spi_init_param init = {
+		.max_speed_hz = 20000000,
+		.mode = SPI_MODE_0,
+		.platform_ops = &linux_sim_spi_platform_ops,
+		.extra = &sim_init,
+	};
+	int32_t ret;
+
+	ret = spi_init(&run->spi, &init);
+	if (ret != SUCCESS)
+		return ret;
+
+	memset(&run->device, 0, sizeof(run->device));
+	run->device.common.devHalInfo = run->spi;
+
+	return SUCCESS;
+}
+
+static int32_t bench_adrv9001_setup(void **ctx)
+{
+	struct bench_adrv9001_ctx *actx;
+	int32_t ret;
+
+	actx = calloc(1, sizeof(*actx));
+	if (!actx)
+		return -ENOMEM;
+
+	ret = bench_adrv9001_run_init(&actx->plain);
+	if (ret != SUCCESS)
+		goto error;
+	ret = bench_adrv9001_run_init(&actx->batched);
+	if (ret != SUCCESS)
+		goto error_plain;
+
+	*ctx = actx;
+
+	return SUCCESS;
+
+error_plain:
+	spi_remove(actx->plain.spi);
+error:
+	free(actx);
+
+	return ret;
+}
+
+static void bench_adrv9001_teardown(void *ctx)
+{
+	struct bench_adrv9001_ctx *actx = ctx;
+
+	spi_remove(actx->batched.spi);
+	spi_remove(actx->plain.spi);
+	free(actx);
+}
+
+/**
+ * @brief Report the counters of both runs and check that they left the same
+ * registers behind. The hardware read-modify-write registers only take part
+ * in the batched run.
+ */
+static int32_t bench_adrv9001_compare(struct bench_adrv9001_ctx *actx,
+				      struct bench_result *res)
+{
+	struct linux_sim_spi_stats plain;
+	struct linux_sim_spi_stats batched;
+	uint8_t plain_val;
+	uint8_t batched_val;
+	uint32_t addr;
+
+	linux_sim_spi_get_stats(actx->plain.spi, &plain);
+	linux_sim_spi_get_stats(actx->batched.spi, &batched);
+	bench_counter(res, "transfers", batched.transfers);
+	bench_counter(res, "bytes", batched.bytes);
+	bench_counter(res, "reg_reads", batched.reg_reads);
+	bench_counter(res, "unbatched_transfers", plain.transfers);
+	bench_counter(res, "unbatched_bytes", plain.bytes);
+	bench_counter(res, "unbatched_reg_reads", plain.reg_reads);
+
+	for (addr = 0; addr < BENCH_ADRV9001_MAP_SIZE; addr++) {
+		if (addr >= ADRV9001_HW_RMW_LO_ADDR &&
+		    addr <= ADRV9001_HW_RMW_DATA)
+			continue;
+		linux_sim_spi_reg_get(actx->plain.spi, addr, &plain_val);
+		linux_sim_spi_reg_get(actx->batched.spi, addr, &batched_val);
+		if (plain_val != batched_val)
+			return -EIO;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Clear the registers and the counters of a run.
+ */
+static void bench_adrv9001_run_reset(struct bench_adrv9001_run *run)
+{
+	uint32_t addr;
+
+	for (addr = 0; addr < BENCH_ADRV9001_MAP_SIZE; addr++)
+		linux_sim_spi_reg_set(run->spi, addr, 0);
+	linux_sim_spi_reset_stats(run->spi);
+	run->writes = 0;
+	run->writes_hash = 2166136261u;
+}
+
+/**
+ * @brief The analog init sequence of adi_adrv9001_InitAnalog(), with the
+ * profile and clock output divisor of the adrv9001 project.
+ */
+static int32_t bench_adrv9001_analog_seq(struct bench_adrv9001_run *run,
+					 bool batch)
+{
+	adi_adrv9001_DeviceClockDivisor_e divisor;
+	int32_t ret;
+
+	bench_adrv9001_run_reset(run);
+	divisor = adrv9002_radio_ctrl_init_get()->adrv9001DeviceClockOutputDivisor;
+
+	if (batch)
+		adi_adrv9001_spi_Batch_Begin(&run->device);
+	ret = adrv9001_InitAnalog(&run->device, &adrv9002_init_lvds, divisor);
+	if (batch)
+		adi_adrv9001_spi_Batch_End(&run->device);
+
+	return ret ? -EIO : SUCCESS;
+}
+
+static int32_t bench_adrv9001_init_analog_run(void *ctx,
+		struct bench_result *res)
+{
+	struct bench_adrv9001_ctx *actx = ctx;
+	int32_t ret;
+
+	ret = bench_adrv9001_analog_seq(&actx->plain, false);
+	if (ret != SUCCESS)
+		return ret;
+	ret = bench_adrv9001_analog_seq(&actx->batched, true);
+	if (ret != SUCCESS)
+		return ret;
+
+	return bench_adrv9001_compare(actx, res);
+}
+
+/**
+ * @brief The SSI delay setup of adi_adrv9001_Utilities_InitRadio_Load(), with
+ * the LVDS delays of the adrv9001 project.
+ */
+static int32_t bench_adrv9001_ssi_seq(struct bench_adrv9001_run *run,
+				      bool batch)
+{
+	struct adi_adrv9001_RadioCtrlInit *radio = adrv9002_radio_ctrl_init_get();
+	int32_t ret;
+
+	bench_adrv9001_run_reset(run);
+
+	if (batch)
+		adi_adrv9001_spi_Batch_Begin(&run->device);
+	ret = adi_adrv9001_Ssi_Delay_Configure(&run->device,
+					       ADI_ADRV9001_SSI_TYPE_LVDS,
+					       &radio->ssiConfig);
+	if (batch)
+		adi_adrv9001_spi_Batch_End(&run->device);
+
+	return ret ? -EIO : SUCCESS;
+}
+
+static int32_t bench_adrv9001_ssi_delay_run(void *ctx, struct bench_result *res)
+{
+	struct bench_adrv9001_ctx *actx = ctx;
+	int32_t ret;
+
+	ret = bench_adrv9001_ssi_seq(&actx->plain, false);
+	if (ret != SUCCESS)
+		return ret;
+	ret = bench_adrv9001_ssi_seq(&actx->batched, true);
+	if (ret != SUCCESS)
+		return ret;
+
+	return bench_adrv9001_compare(actx, res);
+}
+
+/**
+ * @brief Build the binary of count records, as projects/adrv9001/tools does.
+ */
+static int32_t bench_adrv9001_binary_make(adi_adrv9001_BinaryType_e type,
+		uint32_t first_index, const void *records, uint32_t record_size,
+		uint32_t count, uint8_t **bin, uint32_t *len)
+{
+	adi_adrv9001_BinaryHeader_t *header;
+
+	*len = sizeof(*header) + record_size * count;
+	*bin = calloc(1, *len);
+	if (!*bin)
+		return -ENOMEM;
+
+	header = (adi_adrv9001_BinaryHeader_t *)*bin;
+	memcpy(&(*bin)[sizeof(*header)], records, record_size * count);
+	adrv9001_Binary_HeaderFill(header, type, first_index,
+				   &(*bin)[sizeof(*header)], record_size, count);
+
+	return SUCCESS;
+}
+
+static void bench_adrv9001_load_teardown(void *ctx)
+{
+	struct bench_adrv9001_load_ctx *lctx = ctx;
+
+	spi_remove(lctx->binary.spi);
+	spi_remove(lctx->text.spi);
+	free(lctx->profile);
+	free(lctx->tx_atten);
+	free(lctx->rx_gain);
+	free(lctx);
+}
+
+static int32_t bench_adrv9001_load_setup(void **ctx)
+{
+	adi_adrv9001_RxGainTableRow_t rx[ARRAY_SIZE(RxGainTable)];
+	adi_adrv9001_TxAttenTableRow_t tx[ARRAY_SIZE(TxAttenTable)];
+	struct bench_adrv9001_load_ctx *lctx;
+	uint32_t i;
+	int32_t ret;
+
+	lctx = calloc(1, sizeof(*lctx));
+	if (!lctx)
+		return -ENOMEM;
+
+	ret = bench_adrv9001_run_init(&lctx->text);
+	if (ret != SUCCESS) {
+		free(lctx);
+		return ret;
+	}
+	ret = bench_adrv9001_run_init(&lctx->binary);
+	if (ret != SUCCESS) {
+		spi_remove(lctx->text.spi);
+		free(lctx);
+		return ret;
+	}
+
+	memset(rx, 0, sizeof(rx));
+	for (i = 0; i < ARRAY_SIZE(RxGainTable); i++) {
+		rx[i].rxFeGain = RxGainTable[i].rxFeGain;
+		rx[i].extControl = RxGainTable[i].extControl;
+		rx[i].adcTiaGain = (RxGainTable[i].adcControl << 1) |
+				   RxGainTable[i].tiaControl;
+		rx[i].phaseOffset = RxGainTable[i].phaseOffset;
+		rx[i].digGain = RxGainTable[i].digGain;
+	}
+
+	memset(tx, 0, sizeof(tx));
+	for (i = 0; i < ARRAY_SIZE(TxAttenTable); i++) {
+		tx[i].txAttenHp = TxAttenTable[i].txAttenHp;
+		tx[i].txAttenMult = TxAttenTable[i].txAttenMult;
+	}
+
+	ret = bench_adrv9001_binary_make(ADI_ADRV9001_BINARY_TYPE_RX_GAIN_TABLE,
+					 RxGainTable[0].gainIndex, rx,
+					 sizeof(rx[0]), ARRAY_SIZE(rx),
+					 &lctx->rx_gain, &lctx->rx_gain_len);
+	if (ret == SUCCESS)
+		ret = bench_adrv9001_binary_make(ADI_ADRV9001_BINARY_TYPE_TX_ATTEN_TABLE,
+						 TxAttenTable[0].attenIndex, tx,
+						 sizeof(tx[0]), ARRAY_SIZE(tx),
+						 &lctx->tx_atten,
+						 &lctx->tx_atten_len);
+	if (ret == SUCCESS)
+		ret = bench_adrv9001_binary_make(ADI_ADRV9001_BINARY_TYPE_PROFILE, 0,
+						 &adrv9002_init_lvds,
+						 sizeof(adrv9002_init_lvds), 1,
+						 &lctx->profile,
+						 &lctx->profile_len);
+	if (ret != SUCCESS) {
+		bench_adrv9001_load_teardown(lctx);
+		return ret;
+	}
+
+	*ctx = lctx;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Report the counters of the binary run and check that both runs
+ * wrote the same registers with the same values in the same order, ARM
+ * memory writes through the DMA registers included.
+ */
+static int32_t bench_adrv9001_load_compare(struct bench_adrv9001_load_ctx *lctx,
+		struct bench_result *res)
+{
+	struct linux_sim_spi_stats stats;
+	uint8_t text_val;
+	uint8_t binary_val;
+	uint32_t addr;
+
+	linux_sim_spi_get_stats(lctx->binary.spi, &stats);
+	bench_counter(res, "transfers", stats.transfers);
+	bench_counter(res, "bytes", stats.bytes);
+	bench_counter(res, "reg_reads", stats.reg_reads);
+	bench_counter(res, "reg_writes", lctx->binary.writes);
+
+	if (lctx->text.writes != lctx->binary.writes ||
+	    lctx->text.writes_hash != lctx->binary.writes_hash)
+		return -EIO;
+
+	for (addr = 0; addr < BENCH_ADRV9001_MAP_SIZE; addr++) {
+		linux_sim_spi_reg_get(lctx->text.spi, addr, &text_val);
+		linux_sim_spi_reg_get(lctx->binary.spi, addr, &binary_val);
+		if (text_val != binary_val)
+			return -EIO;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Load the Rx gain and Tx atten tables of the adrv9001 project through
+ * the HAL rows and from their binaries.
+ */
+static int32_t bench_adrv9001_table_load_run(void *ctx,
+		struct bench_result *res)
+{
+	struct bench_adrv9001_load_ctx *lctx = ctx;
+	adi_adrv9001_Device_t *text = &lctx->text.device;
+	adi_adrv9001_Device_t *binary = &lctx->binary.device;
+	int32_t ret;
+
+	bench_adrv9001_run_reset(&lctx->text);
+	bench_adrv9001_run_reset(&lctx->binary);
+
+	ret = adi_adrv9001_Utilities_RxGainTable_Load(text, "RxGainTable.csv",
+			BENCH_ADRV9001_CHANNELS);
+	if (!ret)
+		ret = adi_adrv9001_Utilities_TxAttenTable_Load(text,
+				"TxAttenTable.csv", BENCH_ADRV9001_CHANNELS);
+	if (!ret)
+		ret = adi_adrv9001_Utilities_RxGainTableBinary_Load(binary,
+				lctx->rx_gain, lctx->rx_gain_len,
+				BENCH_ADRV9001_CHANNELS);
+	if (!ret)
+		ret = adi_adrv9001_Utilities_TxAttenTableBinary_Load(binary,
+				lctx->tx_atten, lctx->tx_atten_len,
+				BENCH_ADRV9001_CHANNELS);
+	if (ret)
+		return -EIO;
+
+	return bench_adrv9001_load_compare(lctx, res);
+}
+
+/**
+ * @brief The profile writes of adi_adrv9001_InitAnalog(): the analog init
+ * sequence and the profile and PFIR coefficients in ARM memory.
+ */
+static int32_t bench_adrv9001_profile_seq(struct bench_adrv9001_run *run,
+		adi_adrv9001_Init_t *init)
+{
+	adi_adrv9001_DeviceClockDivisor_e divisor;
+	int32_t ret;
+
+	divisor = adrv9002_radio_ctrl_init_get()->adrv9001DeviceClockOutputDivisor;
+
+	/*
+	 * The ARM image load reads these two buffer addresses from the image;
+	 * give both runs the same ones, inside the ARM data memory.
+	 */
+	run->device.devStateInfo.profileAddr = ADRV9001_ADDR_ARM_START_DATA;
+	run->device.devStateInfo.pfirProfileAddr = ADRV9001_ADDR_ARM_START_DATA +
+			0x4000;
+
+	ret = adrv9001_InitAnalog(&run->device, init, divisor);
+	if (!ret)
+		ret = adi_adrv9001_arm_Profile_Write(&run->device, init);
+	if (!ret)
+		ret = adi_adrv9001_arm_PfirProfiles_Write(&run->device, init);
+
+	return ret ? -EIO : SUCCESS;
+}
+
+/**
+ * @brief Write the profile of the adrv9001 project from its C structure and
+ * from its binary.
+ */
+static int32_t bench_adrv9001_profile_load_run(void *ctx,
+		struct bench_result *res)
+{
+	struct bench_adrv9001_load_ctx *lctx = ctx;
+	int32_t ret;
+
+	bench_adrv9001_run_reset(&lctx->text);
+	bench_adrv9001_run_reset(&lctx->binary);
+
+	ret = bench_adrv9001_profile_seq(&lctx->text, &adrv9002_init_lvds);
+	if (ret != SUCCESS)
+		return ret;
+
+	memset(&lctx->init, 0, sizeof(lctx->init));
+	ret = adi_adrv9001_Utilities_DeviceProfileBinary_Parse(&lctx->binary.device,
+			&lctx->init, lctx->profile, lctx->profile_len);
+	if (ret)
+		return -EIO;
+
+	ret = bench_adrv9001_profile_seq(&lctx->binary, &lctx->init);
+	if (ret != SUCCESS)
+		return ret;
+
+	return bench_adrv9001_load_compare(lctx, res);
+}
+
+const struct bench_case bench_adrv9001_init_analog = {
+	.name = "adrv9001_init_analog",
+	.iterations = 20,
+	.setup = bench_adrv9001_setup,
+	.run = bench_adrv9001_init_analog_run,
+	.teardown = bench_adrv9001_teardown,
+};
+
+const struct bench_case bench_adrv9001_ssi_delay = {
+	.name = "adrv9001_ssi_delay",
+	.iterations = 20,
+	.setup = bench_adrv9001_setup,
+	.run = bench_adrv9001_ssi_delay_run,
+	.teardown = bench_adrv9001_teardown,
+};
+
+const struct bench_case bench_adrv9001_table_load = {
+	.name = "adrv9001_table_load",
+	.iterations = 20,
+	.setup = bench_adrv9001_load_setup,
+	.run = bench_adrv9001_table_load_run,
+	.teardown = bench_adrv9001_load_teardown,
+};
+
+const struct bench_case bench_adrv9001_profile_load = {
+	.name = "adrv9001_profile_load",
+	.iterations = 20,
+	.setup = bench_adrv9001_load_setup,
+	.run = bench_adrv9001_profile_load_run,
+	.teardown = bench_adrv9001_load_teardown,
+};
@@ -0,0 +1,383 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench_adxrs290.c
+ *   @brief  Buffered capture of iio_adxrs290 on a simulated ADXRS290.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "spi.h"
+#include "irq.h"
+#include "adxrs290.h"
+#include "iio_adxrs290.h"
+#include "linux_sim_spi.h"
+#include "error.h"
+#include "bench.h"
+#include "bench_platform.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_ADXRS290_IRQ	2
+#define BENCH_ADXRS290_SAMPLES	64
+#define BENCH_ADXRS290_MASK	(BIT(ADXRS290_CHANNEL_COUNT) - 1)
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_adxrs290_model
+ * @brief State of the simulated ADXRS290 and of its SYNC pin, wired to an
+ * edge triggered interrupt.
+ */
+struct bench_adxrs290_model {
+	/** Sample sequence number, written to the X data */
+	int16_t seq;
+	/** New data not read yet */
+	bool data_new;
+	/** Level of the SYNC pin */
+	bool sync;
+	/** SPI transfers issued outside the handler with the interrupt on */
+	uint32_t unmasked_xfers;
+};
+
+/**
+ * @struct bench_adxrs290_ctx
+ * @brief State of the case.
+ */
+struct bench_adxrs290_ctx {
+	/** Interrupt controller */
+	struct irq_ctrl_desc *irq;
+	/** ADXRS290 */
+	struct adxrs290_dev *dev;
+	/** IIO instance */
+	struct iio_adxrs290_desc *iio;
+	/** IIO device, with the buffer callbacks */
+	struct iio_device *iio_dev;
+	/** Captured samples */
+	int16_t buf[BENCH_ADXRS290_SAMPLES * ADXRS290_CHANNEL_COUNT];
+};
+
+/******************************************************************************/
+/************************ Variable Definitions ********************************/
+/******************************************************************************/
+
+static struct bench_adxrs290_model bench_adxrs290;
+
+static const uint8_t bench_adxrs290_defaults[0x20] = {
+	[ADXRS290_REG_ADI_ID] = ADXRS290_ADI_ID,
+	[ADXRS290_REG_MEMS_ID] = ADXRS290_MEMS_ID,
+	[ADXRS290_REG_DEV_ID] = ADXRS290_DEV_ID,
+};
+
+/* Read bit, 7-bit address, auto-increment in a burst. */
+static const struct linux_sim_spi_proto bench_adxrs290_proto = {
+	.cmd_bytes = 1,
+	.rd_mask = ADXRS290_READ,
+	.rd_value = ADXRS290_READ,
+	.addr_mask = 0x7F,
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Update the SYNC pin. It follows the new data flag while data ready
+ * is routed to it, a rising edge raises the interrupt.
+ * @param regs - Register map.
+ */
+static void bench_adxrs290_sync_update(uint8_t *regs)
+{
+	bool sync;
+
+	sync = bench_adxrs290.data_new &&
+	       (regs[ADXRS290_REG_DATA_READY] & ADXRS290_SYNC_MASK) ==
+	       ADXRS290_DATA_RDY_OUT;
+	if (sync == bench_adxrs290.sync)
+		return;
+
+	bench_adxrs290.sync = sync;
+	if (sync)
+		bench_irq_raise(BENCH_ADXRS290_IRQ);
+}
+
+static void bench_adxrs290_spi_read_hook(void *ctx, uint8_t *regs,
+		uint32_t addr)
+{
+	if (bench_irq_can_preempt(BENCH_ADXRS290_IRQ))
+		bench_adxrs290.unmasked_xfers++;
+
+	/* Reading the Y data clears data ready */
+	if (addr == ADXRS290_REG_DATAY1) {
+		bench_adxrs290.data_new = false;
+		bench_adxrs290_sync_update(regs);
+	}
+}
+
+static void bench_adxrs290_spi_write_hook(void *ctx, uint8_t *regs,
+		uint32_t addr)
+{
+	if (bench_irq_can_preempt(BENCH_ADXRS290_IRQ))
+		bench_adxrs290.unmasked_xfers++;
+
+	if (addr == ADXRS290_REG_DATA_READY)
+		bench_adxrs290_sync_update(regs);
+}
+
+static struct linux_sim_spi_init_param bench_adxrs290_spi_param = {
+	.proto = &bench_adxrs290_proto,
+	.map_size = sizeof(bench_adxrs290_defaults),
+	.defaults = bench_adxrs290_defaults,
+	.read_hook = bench_adxrs290_spi_read_hook,
+	.write_hook = bench_adxrs290_spi_write_hook,
+};
+
+/**
+ * @brief A new sample: X is the sequence number, Y its opposite, temperature
+ * is -1.
+ * @param dev - ADXRS290.
+ */
+static void bench_adxrs290_sample(struct adxrs290_dev *dev)
+{
+	uint8_t regs[ADXRS290_REG_DATA_READY + 1];
+	int16_t seq;
+
+	seq = ++bench_adxrs290.seq;
+	linux_sim_spi_reg_set(dev->spi_desc, ADXRS290_REG_DATAX0, seq & 0xFF);
+	linux_sim_spi_reg_set(dev->spi_desc, ADXRS290_REG_DATAX1, seq >> 8);
+	linux_sim_spi_reg_set(dev->spi_desc, ADXRS290_REG_DATAY0, -seq & 0xFF);
+	linux_sim_spi_reg_set(dev->spi_desc, ADXRS290_REG_DATAY1,
+			      (-seq >> 8) & 0xFF);
+	linux_sim_spi_reg_set(dev->spi_desc, ADXRS290_REG_TEMP0, 0xFF);
+	linux_sim_spi_reg_set(dev->spi_desc, ADXRS290_REG_TEMP1, 0x0F);
+
+	bench_adxrs290.data_new = true;
+	linux_sim_spi_reg_get(dev->spi_desc, ADXRS290_REG_DATA_READY,
+			      &regs[ADXRS290_REG_DATA_READY]);
+	bench_adxrs290_sync_update(regs);
+}
+
+static int32_t bench_adxrs290_setup(void **ctx)
+{
+	struct irq_init_param irq_init = { .irq_ctrl_id = 0 };
+	struct adxrs290_init_param dev_init = {
+		.spi_init = {
+			.max_speed_hz = 5000000,
+			.chip_select = 0,
+			.mode = SPI_MODE_3,
+			.platform_ops = &linux_sim_spi_platform_ops,
+			.extra = &bench_adxrs290_spi_param,
+		},
+		.mode = ADXRS290_MODE_MEASUREMENT,
+		.lpf = ADXRS290_LPF_480HZ,
+		.hpf = ADXRS290_HPF_ALL_PASS,
+	};
+	struct iio_adxrs290_init_param iio_init = {
+		.trig_buf_param = {
+			.buf_samples = 2 * BENCH_ADXRS290_SAMPLES,
+			.timeout_us = 1000,
+			.irq_id = BENCH_ADXRS290_IRQ,
+		},
+		.data_ready = true,
+	};
+	struct bench_adxrs290_ctx *actx;
+	int32_t ret;
+
+	memset(&bench_adxrs290, 0, sizeof(bench_adxrs290));
+
+	actx = calloc(1, sizeof(*actx));
+	if (!actx)
+		return -ENOMEM;
+
+	ret = irq_ctrl_init(&actx->irq, &irq_init);
+	if (ret < 0)
+		goto error_free;
+
+	ret = adxrs290_init(&actx->dev, &dev_init);
+	if (ret < 0)
+		goto error_irq;
+
+	iio_init.dev = actx->dev;
+	iio_init.trig_buf_param.irq_ctrl = actx->irq;
+	ret = iio_adxrs290_init(&actx->iio, &iio_init);
+	if (ret < 0)
+		goto error_dev;
+
+	iio_adxrs290_get_dev_descriptor(actx->iio, &actx->iio_dev);
+	*ctx = actx;
+
+	return 0;
+
+error_dev:
+	adxrs290_remove(actx->dev);
+error_irq:
+	irq_ctrl_remove(actx->irq);
+error_free:
+	free(actx);
+
+	return ret;
+}
+
+/**
+ * @brief Access the device through the attributes and the debug registers.
+ * @param actx - Case state.
+ * @return Number of accesses rejected with -EBUSY.
+ */
+static uint32_t bench_adxrs290_busy_accesses(struct bench_adxrs290_ctx *actx)
+{
+	struct iio_ch_info channel = { .ch_num = ADXRS290_CHANNEL_X };
+	char buf[16] = "0.0";
+	uint32_t busy = 0;
+	uint32_t val;
+
+	busy += get_adxrs290_iio_ch_raw(actx->iio, buf, sizeof(buf), &channel,
+					0) == -EBUSY;
+	busy += get_adxrs290_iio_ch_hpf(actx->iio, buf, sizeof(buf), &channel,
+					0) == -EBUSY;
+	busy += set_adxrs290_iio_ch_hpf(actx->iio, buf, sizeof(buf), &channel,
+					0) == -EBUSY;
+	busy += get_adxrs290_iio_ch_lpf(actx->iio, buf, sizeof(buf), &channel,
+					0) == -EBUSY;
+	busy += set_adxrs290_iio_ch_lpf(actx->iio, buf, sizeof(buf), &channel,
+					0) == -EBUSY;
+	busy += actx->iio_dev->debug_reg_read(actx->iio,
+					      ADXRS290_REG_FILTER,
+					      &val) == -EBUSY;
+	busy += actx->iio_dev->debug_reg_write(actx->iio,
+					       ADXRS290_REG_FILTER,
+					       0) == -EBUSY;
+
+	return busy;
+}
+
+/**
+ * @brief Start a capture with a sample already pending, capture a block and
+ * stop. The pending sample must be dropped, the handler must be the only one
+ * talking to the device while the interrupt is enabled: attribute and debug
+ * register accesses are rejected during the capture.
+ */
+static int32_t bench_adxrs290_capture_run(void *ctx, struct bench_result *res)
+{
+	struct bench_adxrs290_ctx *actx = ctx;
+	struct linux_sim_spi_stats stats;
+	int16_t *sample;
+	int16_t first;
+	uint32_t busy = 0;
+	uint32_t i;
+	int32_t ret;
+
+	bench_adxrs290.unmasked_xfers = 0;
+	linux_sim_spi_reset_stats(actx->dev->spi_desc);
+
+	bench_adxrs290_sample(actx->dev);
+	first = bench_adxrs290.seq + 1;
+
+	/* A sample larger than the scratch sample is refused */
+	ret = iio_trig_buf_start(actx->iio->trig_buf, BENCH_ADXRS290_MASK,
+				 actx->iio->trig_buf->max_sample_bytes + 1);
+	if (ret != -EINVAL)
+		return -EIO;
+
+	ret = actx->iio_dev->prepare_transfer(actx->iio, BENCH_ADXRS290_MASK);
+	if (ret < 0)
+		return ret;
+
+	for (i = 0; i < BENCH_ADXRS290_SAMPLES; i++) {
+		bench_adxrs290_sample(actx->dev);
+		if (i == BENCH_ADXRS290_SAMPLES / 2)
+			busy = bench_adxrs290_busy_accesses(actx);
+	}
+
+	ret = actx->iio_dev->read_dev(actx->iio, actx->buf,
+				      BENCH_ADXRS290_SAMPLES);
+	if (ret < 0)
+		goto end;
+
+	ret = actx->iio_dev->end_transfer(actx->iio);
+	if (ret < 0)
+		return ret;
+
+	/* Not captured, the SYNC pin is off again */
+	bench_adxrs290_sample(actx->dev);
+
+	linux_sim_spi_get_stats(actx->dev->spi_desc, &stats);
+	bench_counter(res, "spi_transfers", stats.transfers);
+	bench_counter(res, "unmasked_xfers", bench_adxrs290.unmasked_xfers);
+	bench_counter(res, "overruns", actx->iio->trig_buf->overruns);
+	bench_counter(res, "busy_rejects", busy);
+
+	if (bench_adxrs290.unmasked_xfers || bench_adxrs290.sync ||
+	    busy != 7)
+		return -EIO;
+
+	for (i = 0; i < BENCH_ADXRS290_SAMPLES; i++) {
+		sample = &actx->buf[i * ADXRS290_CHANNEL_COUNT];
+		if (sample[0] != (int16_t)(first + i) || sample[1] != -sample[0] ||
+		    sample[2] != -1)
+			return -EIO;
+	}
+
+	return 0;
+
+end:
+	actx->iio_dev->end_transfer(actx->iio);
+
+	return ret;
+}
+
+static void bench_adxrs290_teardown(void *ctx)
+{
+	struct bench_adxrs290_ctx *actx = ctx;
+
+	iio_adxrs290_remove(actx->iio);
+	adxrs290_remove(actx->dev);
+	irq_ctrl_remove(actx->irq);
+	free(actx);
+}
+
+const struct bench_case bench_adxrs290_capture = {
+	.name = "adxrs290_capture",
+	.iterations = 100,
+	.setup = bench_adxrs290_setup,
+	.run = bench_adxrs290_capture_run,
+	.teardown = bench_adxrs290_teardown,
+};
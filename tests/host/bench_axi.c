@@ -0,0 +1,381 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench_axi.c
+ *   @brief  AXI DMAC, SPI Engine and IIO ADC buffer benchmarks on the simulated AXI backend.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "axi_adc_core.h"
+#include "axi_dmac.h"
+#include "spi_engine.h"
+#include "iio_axi_adc.h"
+#include "linux_sim_axi_io.h"
+#include "error.h"
+#include "bench.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_AXI_DMAC_BASE		0x20000
+#define BENCH_AXI_SPI_ENGINE_BASE	0x30000
+#define BENCH_AXI_ADC_BASE		0x40000
+#define BENCH_AXI_ADC_DMAC_BASE		0x44000
+#define BENCH_AXI_REGION_SIZE		0x1000
+
+#define BENCH_AXI_DMAC_TRANSFERS	64
+#define BENCH_AXI_DMAC_BYTES		4096
+#define BENCH_AXI_SPI_TRANSFERS		64
+#define BENCH_AXI_SPI_BYTES		4
+#define BENCH_AXI_ADC_CHANNELS		4
+#define BENCH_AXI_ADC_SAMPLES		4096
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_axi_adc_ctx
+ * @brief State of the IIO ADC buffer case.
+ */
+struct bench_axi_adc_ctx {
+	/** ADC core */
+	struct axi_adc *adc;
+	/** Receive DMA */
+	struct axi_dmac *dmac;
+	/** IIO descriptor */
+	struct iio_axi_adc_desc *iio;
+	/** Sample buffer */
+	uint16_t buf[BENCH_AXI_ADC_SAMPLES * BENCH_AXI_ADC_CHANNELS];
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Map one register region.
+ * @param base - Base address.
+ * @param model - Register behaviour.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_axi_add_region(uint32_t base,
+				    enum linux_sim_axi_io_model model)
+{
+	struct linux_sim_axi_io_region region = {
+		.base = base,
+		.size = BENCH_AXI_REGION_SIZE,
+		.model = model,
+	};
+
+	return linux_sim_axi_io_add(&region);
+}
+
+/**
+ * @brief Sum of the register accesses in a region.
+ * @param base - Base address.
+ * @return The number of accesses.
+ */
+static uint32_t bench_axi_mmio(uint32_t base)
+{
+	struct linux_sim_axi_io_stats stats;
+
+	if (linux_sim_axi_io_get_stats(base, &stats) < 0)
+		return 0;
+
+	return stats.reads + stats.writes;
+}
+
+static void bench_axi_teardown(void *ctx)
+{
+	linux_sim_axi_io_remove_all();
+}
+
+static int32_t bench_axi_dmac_setup(void **ctx)
+{
+	struct axi_dmac_init init = {
+		.name = "bench-dmac",
+		.base = BENCH_AXI_DMAC_BASE,
+		.direction = DMA_DEV_TO_MEM,
+		.flags = 0,
+	};
+	struct axi_dmac *dmac;
+	int32_t ret;
+
+	ret = bench_axi_add_region(BENCH_AXI_DMAC_BASE, LINUX_SIM_AXI_IO_DMAC);
+	if (ret < 0)
+		return ret;
+
+	ret = axi_dmac_init(&dmac, &init);
+	if (ret < 0)
+		return ret;
+
+	*ctx = dmac;
+
+	return 0;
+}
+
+/**
+ * @brief Blocking DMA transfers, the register traffic per transfer is gated.
+ */
+static int32_t bench_axi_dmac_run(void *ctx, struct bench_result *res)
+{
+	struct axi_dmac *dmac = ctx;
+	uint32_t i;
+	int32_t ret;
+
+	linux_sim_axi_io_reset_stats(BENCH_AXI_DMAC_BASE);
+
+	for (i = 0; i < BENCH_AXI_DMAC_TRANSFERS; i++) {
+		/* The simulated DMAC does not touch the memory */
+		ret = axi_dmac_transfer(dmac, 0x80000000, BENCH_AXI_DMAC_BYTES);
+		if (ret < 0)
+			return ret;
+	}
+
+	bench_counter(res, "transfers", BENCH_AXI_DMAC_TRANSFERS);
+	bench_counter(res, "mmio", bench_axi_mmio(BENCH_AXI_DMAC_BASE));
+
+	return 0;
+}
+
+static void bench_axi_dmac_teardown(void *ctx)
+{
+	axi_dmac_remove(ctx);
+	bench_axi_teardown(NULL);
+}
+
+static int32_t bench_axi_spi_engine_setup(void **ctx)
+{
+	struct spi_engine_init_param engine_init = {
+		.ref_clk_hz = 100000000,
+		.type = SPI_ENGINE,
+		.spi_engine_baseaddr = BENCH_AXI_SPI_ENGINE_BASE,
+		.cs_delay = 0,
+		.data_width = 8,
+	};
+	struct spi_init_param init = {
+		.max_speed_hz = 10000000,
+		.chip_select = 0,
+		.mode = SPI_MODE_0,
+		.platform_ops = &spi_eng_platform_ops,
+		.extra = &engine_init,
+	};
+	struct spi_desc *desc;
+	int32_t ret;
+
+	ret = bench_axi_add_region(BENCH_AXI_SPI_ENGINE_BASE,
+				   LINUX_SIM_AXI_IO_SPI_ENGINE);
+	if (ret < 0)
+		return ret;
+
+	ret = spi_init(&desc, &init);
+	if (ret < 0)
+		return ret;
+
+	*ctx = desc;
+
+	return 0;
+}
+
+/**
+ * @brief Short register-sized FIFO mode transfers, looped back by the
+ * simulated engine.
+ */
+static int32_t bench_axi_spi_engine_run(void *ctx, struct bench_result *res)
+{
+	uint8_t data[BENCH_AXI_SPI_BYTES], expected[BENCH_AXI_SPI_BYTES];
+	struct spi_desc *desc = ctx;
+	uint32_t i, j;
+	int32_t ret;
+
+	linux_sim_axi_io_reset_stats(BENCH_AXI_SPI_ENGINE_BASE);
+
+	for (i = 0; i < BENCH_AXI_SPI_TRANSFERS; i++) {
+		for (j = 0; j < BENCH_AXI_SPI_BYTES; j++)
+			expected[j] = data[j] = i + j;
+
+		ret = spi_write_and_read(desc, data, BENCH_AXI_SPI_BYTES);
+		if (ret < 0)
+			return ret;
+
+		if (memcmp(data, expected, BENCH_AXI_SPI_BYTES))
+			return -EIO;
+	}
+
+	bench_counter(res, "transfers", BENCH_AXI_SPI_TRANSFERS);
+	bench_counter(res, "mmio", bench_axi_mmio(BENCH_AXI_SPI_ENGINE_BASE));
+
+	return 0;
+}
+
+static void bench_axi_spi_engine_teardown(void *ctx)
+{
+	spi_remove(ctx);
+	bench_axi_teardown(NULL);
+}
+
+static int32_t bench_axi_adc_setup(void **ctx)
+{
+	struct axi_adc_init adc_init = {
+		.name = "bench-adc",
+		.base = BENCH_AXI_ADC_BASE,
+		.num_channels = BENCH_AXI_ADC_CHANNELS,
+	};
+	struct axi_dmac_init dmac_init = {
+		.name = "bench-adc-dmac",
+		.base = BENCH_AXI_ADC_DMAC_BASE,
+		.direction = DMA_DEV_TO_MEM,
+		.flags = 0,
+	};
+	struct iio_axi_adc_init_param iio_init = { 0 };
+	struct bench_axi_adc_ctx *actx;
+	int32_t ret;
+
+	ret = bench_axi_add_region(BENCH_AXI_ADC_BASE, LINUX_SIM_AXI_IO_RAM);
+	if (ret < 0)
+		return ret;
+
+	ret = bench_axi_add_region(BENCH_AXI_ADC_DMAC_BASE,
+				   LINUX_SIM_AXI_IO_DMAC);
+	if (ret < 0)
+		return ret;
+
+	/* The ADC core reports its status once out of reset */
+	ret = axi_io_write(BENCH_AXI_ADC_BASE, AXI_ADC_REG_STATUS, 1);
+	if (ret < 0)
+		return ret;
+
+	actx = calloc(1, sizeof(*actx));
+	if (!actx)
+		return -ENOMEM;
+
+	ret = axi_adc_init(&actx->adc, &adc_init);
+	if (ret < 0)
+		goto error_free;
+
+	ret = axi_dmac_init(&actx->dmac, &dmac_init);
+	if (ret < 0)
+		goto error_adc;
+
+	iio_init.rx_adc = actx->adc;
+	iio_init.rx_dmac = actx->dmac;
+	ret = iio_axi_adc_init(&actx->iio, &iio_init);
+	if (ret < 0)
+		goto error_dmac;
+
+	*ctx = actx;
+
+	return 0;
+
+error_dmac:
+	axi_dmac_remove(actx->dmac);
+error_adc:
+	axi_adc_remove(actx->adc);
+error_free:
+	free(actx);
+
+	return ret;
+}
+
+/**
+ * @brief One IIO buffer refill: activate the channels and read a block
+ * through the device callbacks used by the IIO server.
+ */
+static int32_t bench_axi_adc_run(void *ctx, struct bench_result *res)
+{
+	struct bench_axi_adc_ctx *actx = ctx;
+	struct iio_device *dev;
+	int32_t ret;
+
+	iio_axi_adc_get_dev_descriptor(actx->iio, &dev);
+	linux_sim_axi_io_reset_stats(BENCH_AXI_ADC_BASE);
+	linux_sim_axi_io_reset_stats(BENCH_AXI_ADC_DMAC_BASE);
+
+	ret = dev->prepare_transfer(actx->iio,
+				    (1 << BENCH_AXI_ADC_CHANNELS) - 1);
+	if (ret < 0)
+		return ret;
+
+	ret = dev->read_dev(actx->iio, actx->buf, BENCH_AXI_ADC_SAMPLES);
+	if (ret < 0)
+		return ret;
+
+	bench_counter(res, "adc_mmio", bench_axi_mmio(BENCH_AXI_ADC_BASE));
+	bench_counter(res, "dmac_mmio",
+		      bench_axi_mmio(BENCH_AXI_ADC_DMAC_BASE));
+
+	return 0;
+}
+
+static void bench_axi_adc_teardown(void *ctx)
+{
+	struct bench_axi_adc_ctx *actx = ctx;
+
+	iio_axi_adc_remove(actx->iio);
+	axi_dmac_remove(actx->dmac);
+	axi_adc_remove(actx->adc);
+	free(actx);
+	bench_axi_teardown(NULL);
+}
+
+const struct bench_case bench_axi_dmac_transfer = {
+	.name = "axi_dmac_transfer",
+	.iterations = 100,
+	.setup = bench_axi_dmac_setup,
+	.run = bench_axi_dmac_run,
+	.teardown = bench_axi_dmac_teardown,
+};
+
+const struct bench_case bench_spi_engine_transfer = {
+	.name = "spi_engine_transfer",
+	.iterations = 100,
+	.setup = bench_axi_spi_engine_setup,
+	.run = bench_axi_spi_engine_run,
+	.teardown = bench_axi_spi_engine_teardown,
+};
+
+const struct bench_case bench_iio_axi_adc_read = {
+	.name = "iio_axi_adc_read",
+	.iterations = 100,
+	.setup = bench_axi_adc_setup,
+	.run = bench_axi_adc_run,
+	.teardown = bench_axi_adc_teardown,
+};
@@ -0,0 +1,403 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench_clk.c
+ *   @brief  Clock tree and divider solver benchmarks.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include "adf4371.h"
+#include "clk.h"
+#include "linux_sim_spi.h"
+#include "util.h"
+#include "error.h"
+#include "bench.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_CLK_MAP_SIZE	0x80
+#define BENCH_CLK_REFIN		100000000
+#define BENCH_CLK_RATES		64
+/* VCO rate whose FRAC2 remainder rounds to 1/1 with a 100 MHz PFD */
+#define BENCH_CLK_FRAC2_CARRY	4000206092ULL
+/* Cached reads of each leaf clock after a rate change */
+#define BENCH_CLK_READS		16
+
+#define BENCH_SOLVE_RATIOS	512
+#define BENCH_SOLVE_BITS	14
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_clk_ctx
+ * @brief State of the clock tree case: an ADF4371 RF8 output feeding two
+ * clocks without hardware of their own.
+ */
+struct bench_clk_ctx {
+	/** Synthesizer on the simulated SPI */
+	struct adf4371_dev *adf4371;
+	/** Clock operations of the synthesizer */
+	struct clk_hw hw;
+	/** Synthesizer output, root of the tree */
+	struct clk rf8;
+	/** Leaf clocks */
+	struct clk adc_clk;
+	struct clk dac_clk;
+	/** Notifier of dac_clk */
+	struct clk_notifier nb;
+	/** Rates set by one iteration */
+	uint64_t rates[BENCH_CLK_RATES];
+	/** Number of reads of the synthesizer rate */
+	uint32_t hw_recalcs;
+	/** Number of notifications */
+	uint32_t notifications;
+};
+
+/**
+ * @struct bench_solve_ratio
+ * @brief One ratio to approximate and the error of the best approximation.
+ */
+struct bench_solve_ratio {
+	uint32_t num;
+	uint32_t den;
+	uint32_t max_num;
+	uint32_t max_den;
+	/** |n * den - num * d| of the best n / d found by exhaustive search */
+	uint64_t best_err;
+	uint32_t best_d;
+};
+
+/******************************************************************************/
+/************************ Variable Definitions ********************************/
+/******************************************************************************/
+
+/* Read bit, 15-bit address, ascending in a stream. */
+static const struct linux_sim_spi_proto bench_clk_proto = {
+	.cmd_bytes = 2,
+	.rd_mask = 0x8000,
+	.rd_value = 0x8000,
+	.addr_mask = 0x7FFF,
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static uint32_t bench_clk_rand(uint32_t *state)
+{
+	/* xorshift32 */
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+
+	return *state;
+}
+
+static int32_t bench_clk_recalc_rate(struct bench_clk_ctx *cctx, uint32_t chan,
+				     uint64_t *rate)
+{
+	cctx->hw_recalcs++;
+
+	return adf4371_clk_recalc_rate(cctx->adf4371, chan, rate);
+}
+
+static int32_t bench_clk_set_rate(struct bench_clk_ctx *cctx, uint32_t chan,
+				  uint64_t rate)
+{
+	return adf4371_clk_set_rate(cctx->adf4371, chan, rate);
+}
+
+static int32_t bench_clk_notify(struct clk *clk, uint64_t old_rate,
+				uint64_t new_rate, void *ctx)
+{
+	struct bench_clk_ctx *cctx = ctx;
+
+	cctx->notifications++;
+
+	return SUCCESS;
+}
+
+static int32_t bench_clk_tree_setup(void **ctx)
+{
+	struct linux_sim_spi_init_param sim_init = {
+		.proto = &bench_clk_proto,
+		.map_size = BENCH_CLK_MAP_SIZE,
+	};
+	struct spi_init_param spi_init = {
+		.max_speed_hz = 10000000,
+		.mode = SPI_MODE_0,
+		.platform_ops = &linux_sim_spi_platform_ops,
+		.extra = &sim_init,
+	};
+	struct adf4371_init_param init = {
+		.spi_init = &spi_init,
+		.clkin_frequency = BENCH_CLK_REFIN,
+	};
+	struct bench_clk_ctx *cctx;
+	uint32_t seed = 0x4371;
+	uint32_t i;
+	int32_t ret;
+
+	cctx = calloc(1, sizeof(*cctx));
+	if (!cctx)
+		return -ENOMEM;
+
+	ret = adf4371_init(&cctx->adf4371, &init);
+	if (ret != SUCCESS) {
+		free(cctx);
+		return ret;
+	}
+
+	cctx->hw.dev = cctx;
+	cctx->hw.dev_clk_recalc_rate = bench_clk_recalc_rate;
+	cctx->hw.dev_clk_set_rate = bench_clk_set_rate;
+	cctx->rf8.name = "rf8";
+	cctx->rf8.hw = &cctx->hw;
+	cctx->rf8.hw_ch_num = 0;
+	cctx->adc_clk.name = "adc_clk";
+	cctx->dac_clk.name = "dac_clk";
+	clk_set_parent(&cctx->adc_clk, &cctx->rf8);
+	clk_set_parent(&cctx->dac_clk, &cctx->rf8);
+
+	cctx->nb.notify = bench_clk_notify;
+	cctx->nb.ctx = cctx;
+	clk_notifier_register(&cctx->dac_clk, &cctx->nb);
+
+	/* RF8 without the output divider, FRAC2 carry corner first */
+	cctx->rates[0] = BENCH_CLK_FRAC2_CARRY;
+	for (i = 1; i < BENCH_CLK_RATES; i++)
+		cctx->rates[i] = 4000000000ULL +
+				 bench_clk_rand(&seed) % 4000000000ULL;
+
+	*ctx = cctx;
+
+	return 0;
+}
+
+/**
+ * @brief Check the FRAC2 and MOD2 words last written to the synthesizer.
+ */
+static int32_t bench_clk_check_frac2(struct bench_clk_ctx *cctx)
+{
+	uint8_t regs[4];
+	uint32_t fract2, mod2;
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < ARRAY_SIZE(regs); i++) {
+		ret = linux_sim_spi_reg_get(cctx->adf4371->spi_desc, 0x17 + i,
+					    &regs[i]);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	fract2 = (regs[0] >> 1) | ((regs[1] & 0x7F) << 7);
+	mod2 = regs[2] | ((regs[3] & 0x3F) << 8);
+	if (!mod2 || fract2 >= mod2)
+		return -EIO;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set each rate on the root of the tree and read the leaves back, as a
+ * clock planner does. Only the rate changes may reach the synthesizer.
+ */
+static int32_t bench_clk_tree_run(void *ctx, struct bench_result *res)
+{
+	struct bench_clk_ctx *cctx = ctx;
+	struct linux_sim_spi_stats stats;
+	uint64_t rate;
+	uint32_t i, j;
+	int32_t ret;
+
+	clk_invalidate_rate(&cctx->rf8);
+	linux_sim_spi_reset_stats(cctx->adf4371->spi_desc);
+	cctx->hw_recalcs = 0;
+	cctx->notifications = 0;
+
+	for (i = 0; i < BENCH_CLK_RATES; i++) {
+		ret = clk_set_rate(&cctx->rf8, cctx->rates[i]);
+		if (ret != SUCCESS)
+			return ret;
+
+		ret = bench_clk_check_frac2(cctx);
+		if (ret != SUCCESS)
+			return ret;
+
+		for (j = 0; j < BENCH_CLK_READS; j++) {
+			ret = clk_recalc_rate(j & 1 ? &cctx->dac_clk :
+					      &cctx->adc_clk, &rate);
+			if (ret != SUCCESS)
+				return ret;
+			/* FRAC2 / MOD2 keeps the output within 1 Hz */
+			if (rate + 1 < cctx->rates[i] ||
+			    rate > cctx->rates[i] + 1)
+				return -EIO;
+		}
+	}
+
+	linux_sim_spi_get_stats(cctx->adf4371->spi_desc, &stats);
+	bench_counter(res, "rate_changes", BENCH_CLK_RATES);
+	bench_counter(res, "hw_recalcs", cctx->hw_recalcs);
+	bench_counter(res, "notifications", cctx->notifications);
+	bench_counter(res, "transfers", stats.transfers);
+	bench_counter(res, "reg_reads", stats.reg_reads);
+	bench_counter(res, "reg_writes", stats.reg_writes);
+
+	return 0;
+}
+
+static void bench_clk_tree_teardown(void *ctx)
+{
+	struct bench_clk_ctx *cctx = ctx;
+
+	adf4371_remove(cctx->adf4371);
+	free(cctx);
+}
+
+/**
+ * @brief Error of n / d against num / den, scaled by den.
+ */
+static uint64_t bench_solve_err(const struct bench_solve_ratio *r, uint64_t n,
+				uint64_t d)
+{
+	uint64_t a = n * r->den;
+	uint64_t b = (uint64_t)r->num * d;
+
+	return a > b ? a - b : b - a;
+}
+
+static int32_t bench_solve_setup(void **ctx)
+{
+	struct bench_solve_ratio *ratios, *r;
+	uint32_t seed = 0x9044;
+	uint64_t n, err;
+	uint32_t i, d;
+
+	ratios = calloc(BENCH_SOLVE_RATIOS, sizeof(*ratios));
+	if (!ratios)
+		return -ENOMEM;
+
+	for (i = 0; i < BENCH_SOLVE_RATIOS; i++) {
+		r = &ratios[i];
+		/* Fractional remainders (FRAC2 / MOD2) and N / R divider pairs */
+		r->den = 1000000 + bench_clk_rand(&seed) % 0x7F000000;
+		if (i & 1) {
+			r->num = 1 + bench_clk_rand(&seed) % r->den;
+			r->max_num = BIT(BENCH_SOLVE_BITS) - 1;
+			r->max_den = BIT(BENCH_SOLVE_BITS) - 1;
+		} else {
+			r->num = 1 + bench_clk_rand(&seed) % 0x7FFFFFFF;
+			r->max_num = 0xFFFF;
+			r->max_den = 0xFFF;
+		}
+
+		/* Exhaustive search for the reference error */
+		r->best_err = UINT64_MAX;
+		for (d = 1; d <= r->max_den; d++) {
+			n = ((uint64_t)r->num * d + r->den / 2) / r->den;
+			n = min(n, (uint64_t)r->max_num);
+			err = bench_solve_err(r, n, d);
+			if ((unsigned __int128)err * r->best_d <
+			    (unsigned __int128)r->best_err * d) {
+				r->best_err = err;
+				r->best_d = d;
+			}
+		}
+	}
+
+	*ctx = ratios;
+
+	return 0;
+}
+
+/**
+ * @brief Approximate each ratio within its limits, the result must be as
+ * close as the best fraction found by exhaustive search.
+ */
+static int32_t bench_solve_run(void *ctx, struct bench_result *res)
+{
+	struct bench_solve_ratio *ratios = ctx, *r;
+	uint32_t n, d;
+	uint64_t err;
+	uint32_t i;
+
+	for (i = 0; i < BENCH_SOLVE_RATIOS; i++) {
+		r = &ratios[i];
+		rational_best_approximation(r->num, r->den, r->max_num,
+					    r->max_den, &n, &d);
+		if (!d || n > r->max_num || d > r->max_den)
+			return -EINVAL;
+
+		err = bench_solve_err(r, n, d);
+		if ((unsigned __int128)err * r->best_d >
+		    (unsigned __int128)r->best_err * d)
+			return -EIO;
+	}
+
+	bench_counter(res, "ratios", BENCH_SOLVE_RATIOS);
+
+	return 0;
+}
+
+static void bench_solve_teardown(void *ctx)
+{
+	free(ctx);
+}
+
+const struct bench_case bench_clk_tree_rates = {
+	.name = "clk_tree_rates",
+	.iterations = 100,
+	.setup = bench_clk_tree_setup,
+	.run = bench_clk_tree_run,
+	.teardown = bench_clk_tree_teardown,
+};
+
+const struct bench_case bench_clk_divider_solve = {
+	.name = "clk_divider_solve",
+	.iterations = 1000,
+	.setup = bench_solve_setup,
+	.run = bench_solve_run,
+	.teardown = bench_solve_teardown,
+};
@@ -0,0 +1,270 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench_gpio.c
+ *   @brief  GPIO toggle rate of the Linux character device and sysfs backends.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include "gpio.h"
+#include "linux_gpio.h"
+#include "linux_gpiochip.h"
+#include "error.h"
+#include "bench.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_GPIO_TOGGLES	1000
+
+/*
+ * The cases drive a real output line, so they only run on a line chosen in
+ * the environment:
+ * BENCH_GPIOCHIP	- GPIO chip device, LINUX_GPIOCHIP_DEFAULT if not set
+ * BENCH_GPIOCHIP_LINE	- line offset in the chip
+ * BENCH_GPIO_SYSFS	- global number of the same line, for the sysfs case
+ */
+#define BENCH_GPIO_ENV_CHIP	"BENCH_GPIOCHIP"
+#define BENCH_GPIO_ENV_LINE	"BENCH_GPIOCHIP_LINE"
+#define BENCH_GPIO_ENV_SYSFS	"BENCH_GPIO_SYSFS"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_gpio_bulk_ctx
+ * @brief State of the bulk toggle case.
+ */
+struct bench_gpio_bulk_ctx {
+	/** Line request */
+	struct linux_gpiochip_bulk_desc *desc;
+	/** Line offset */
+	uint32_t offset;
+};
+
+/******************************************************************************/
+/************************ Variable Definitions ********************************/
+/******************************************************************************/
+
+static struct linux_gpiochip_init_param bench_gpio_chip_param;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get a line number from the environment.
+ * @param name - Variable name.
+ * @param number - Where the number is stored.
+ * @return 0 if the variable is set, BENCH_SKIP otherwise.
+ */
+static int32_t bench_gpio_env(const char *name, int32_t *number)
+{
+	const char *val = getenv(name);
+
+	if (!val || !*val)
+		return BENCH_SKIP;
+
+	*number = strtol(val, NULL, 0);
+
+	return 0;
+}
+
+/**
+ * @brief Request a line as output through the given backend.
+ * @param ops - Backend.
+ * @param extra - Backend specific parameters.
+ * @param env - Variable holding the line number.
+ * @param ctx - Where the GPIO descriptor is stored.
+ * @return 0 in case of success, BENCH_SKIP if no line was chosen, negative
+ * error code otherwise.
+ */
+static int32_t bench_gpio_setup(const struct gpio_platform_ops *ops,
+				void *extra, const char *env, void **ctx)
+{
+	struct gpio_init_param param = {
+		.platform_ops = ops,
+		.extra = extra,
+	};
+	struct gpio_desc *desc;
+	int32_t ret;
+
+	ret = bench_gpio_env(env, &param.number);
+	if (ret)
+		return ret;
+
+	ret = gpio_get(&desc, &param);
+	if (ret < 0)
+		return ret;
+
+	ret = gpio_direction_output(desc, GPIO_LOW);
+	if (ret < 0) {
+		gpio_remove(desc);
+		return ret;
+	}
+
+	*ctx = desc;
+
+	return 0;
+}
+
+static int32_t bench_gpiochip_setup(void **ctx)
+{
+	bench_gpio_chip_param.chip = getenv(BENCH_GPIO_ENV_CHIP);
+
+	return bench_gpio_setup(&linux_gpiochip_platform_ops,
+				&bench_gpio_chip_param, BENCH_GPIO_ENV_LINE,
+				ctx);
+}
+
+static int32_t bench_gpio_sysfs_setup(void **ctx)
+{
+	return bench_gpio_setup(&linux_gpio_platform_ops, NULL,
+				BENCH_GPIO_ENV_SYSFS, ctx);
+}
+
+/**
+ * @brief Toggle the line through gpio_set_value().
+ */
+static int32_t bench_gpio_run(void *ctx, struct bench_result *res)
+{
+	struct gpio_desc *desc = ctx;
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < BENCH_GPIO_TOGGLES; i++) {
+		ret = gpio_set_value(desc, (i & 1) ? GPIO_LOW : GPIO_HIGH);
+		if (ret < 0)
+			return ret;
+	}
+
+	bench_counter(res, "toggles", BENCH_GPIO_TOGGLES);
+
+	return 0;
+}
+
+static void bench_gpio_teardown(void *ctx)
+{
+	gpio_remove(ctx);
+}
+
+static int32_t bench_gpiochip_bulk_setup(void **ctx)
+{
+	struct linux_gpiochip_bulk_init_param param = {
+		.num_lines = 1,
+		.output_mask = 1,
+		.output_values = 0,
+	};
+	struct bench_gpio_bulk_ctx *bctx;
+	int32_t line, ret;
+
+	ret = bench_gpio_env(BENCH_GPIO_ENV_LINE, &line);
+	if (ret)
+		return ret;
+
+	bctx = calloc(1, sizeof(*bctx));
+	if (!bctx)
+		return -ENOMEM;
+
+	bctx->offset = line;
+	param.chip = getenv(BENCH_GPIO_ENV_CHIP);
+	param.offsets = &bctx->offset;
+	ret = linux_gpiochip_bulk_get(&bctx->desc, &param);
+	if (ret < 0) {
+		free(bctx);
+		return ret;
+	}
+
+	*ctx = bctx;
+
+	return 0;
+}
+
+/**
+ * @brief Toggle the line through linux_gpiochip_bulk_set_values().
+ */
+static int32_t bench_gpiochip_bulk_run(void *ctx, struct bench_result *res)
+{
+	struct bench_gpio_bulk_ctx *bctx = ctx;
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < BENCH_GPIO_TOGGLES; i++) {
+		ret = linux_gpiochip_bulk_set_values(bctx->desc, 1, ~i & 1);
+		if (ret < 0)
+			return ret;
+	}
+
+	bench_counter(res, "toggles", BENCH_GPIO_TOGGLES);
+
+	return 0;
+}
+
+static void bench_gpiochip_bulk_teardown(void *ctx)
+{
+	struct bench_gpio_bulk_ctx *bctx = ctx;
+
+	linux_gpiochip_bulk_remove(bctx->desc);
+	free(bctx);
+}
+
+const struct bench_case bench_gpiochip_toggle = {
+	.name = "gpiochip_toggle",
+	.iterations = 10,
+	.setup = bench_gpiochip_setup,
+	.run = bench_gpio_run,
+	.teardown = bench_gpio_teardown,
+};
+
+const struct bench_case bench_gpiochip_bulk_toggle = {
+	.name = "gpiochip_bulk_toggle",
+	.iterations = 10,
+	.setup = bench_gpiochip_bulk_setup,
+	.run = bench_gpiochip_bulk_run,
+	.teardown = bench_gpiochip_bulk_teardown,
+};
+
+const struct bench_case bench_gpio_sysfs_toggle = {
+	.name = "gpio_sysfs_toggle",
+	.iterations = 10,
+	.setup = bench_gpio_sysfs_setup,
+	.run = bench_gpio_run,
+	.teardown = bench_gpio_teardown,
+};
@@ -0,0 +1,372 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench_i2c.c
+ *   @brief  Linux I2C driver against a fake /dev/i2c adapter.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include "i2c.h"
+#include "linux_i2c.h"
+#include "util.h"
+#include "error.h"
+#include "bench.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_I2C_DEVICE	"/dev/i2c-"
+#define BENCH_I2C_ADDRESS	0x48
+#define BENCH_I2C_ID_REG	0x0b
+#define BENCH_I2C_ID		0xcb
+#define BENCH_I2C_RESET_CMD	0x2f
+#define BENCH_I2C_READS		256
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_i2c_adapter
+ * @brief State of the fake adapter and of the slave behind it, a device with
+ * an 8-bit register pointer set by the first byte of every write.
+ */
+struct bench_i2c_adapter {
+	/** File descriptor handed out for /dev/i2c-*, -1 if not open */
+	int fd;
+	/** Address selected with I2C_SLAVE */
+	int slave_address;
+	/** Register pointer of the slave */
+	uint8_t ptr;
+	/** Registers of the slave */
+	uint8_t regs[256];
+	/** Reset commands received */
+	uint32_t resets;
+	/** Transactions on the bus, each one ending with a stop condition */
+	uint32_t transactions;
+	/** read(), write() and ioctl() calls on the adapter */
+	uint32_t syscalls;
+};
+
+/******************************************************************************/
+/************************ Variable Definitions ********************************/
+/******************************************************************************/
+
+static struct bench_i2c_adapter bench_i2c = {
+	.fd = -1,
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/*
+ * The runner is linked with --wrap for open, close, read, write and ioctl.
+ * Calls on /dev/i2c-* go to the fake adapter, anything else to the C library.
+ */
+int __real_open(const char *path, int flags, ...);
+int __real_close(int fd);
+ssize_t __real_read(int fd, void *buf, size_t count);
+ssize_t __real_write(int fd, const void *buf, size_t count);
+int __real_ioctl(int fd, unsigned long request, ...);
+
+/**
+ * @brief Write message received by the slave.
+ * @param buf - Register address followed by the data.
+ * @param len - Number of bytes.
+ */
+static void bench_i2c_slave_write(const uint8_t *buf, uint32_t len)
+{
+	uint32_t i;
+
+	if (!len)
+		return;
+
+	if (len == 1 && buf[0] == BENCH_I2C_RESET_CMD) {
+		bench_i2c.resets++;
+		memset(bench_i2c.regs, 0, sizeof(bench_i2c.regs));
+		bench_i2c.regs[BENCH_I2C_ID_REG] = BENCH_I2C_ID;
+		return;
+	}
+
+	bench_i2c.ptr = buf[0];
+	for (i = 1; i < len; i++)
+		bench_i2c.regs[bench_i2c.ptr++] = buf[i];
+}
+
+/**
+ * @brief Read message received by the slave.
+ * @param buf - Buffer receiving the data.
+ * @param len - Number of bytes.
+ */
+static void bench_i2c_slave_read(uint8_t *buf, uint32_t len)
+{
+	uint32_t i;
+
+	for (i = 0; i < len; i++)
+		buf[i] = bench_i2c.regs[bench_i2c.ptr++];
+}
+
+int __wrap_open(const char *path, int flags, ...)
+{
+	va_list args;
+	mode_t mode;
+
+	if (!strncmp(path, BENCH_I2C_DEVICE, strlen(BENCH_I2C_DEVICE))) {
+		if (bench_i2c.fd >= 0)
+			return -1;
+		/* Hold a real descriptor so the number isn't reused meanwhile */
+		bench_i2c.fd = __real_open("/dev/null", O_RDWR);
+		bench_i2c.slave_address = -1;
+
+		return bench_i2c.fd;
+	}
+
+	va_start(args, flags);
+	mode = (flags & O_CREAT) ? va_arg(args, mode_t) : 0;
+	va_end(args);
+
+	return __real_open(path, flags, mode);
+}
+
+int __wrap_close(int fd)
+{
+	if (fd >= 0 && fd == bench_i2c.fd)
+		bench_i2c.fd = -1;
+
+	return __real_close(fd);
+}
+
+ssize_t __wrap_write(int fd, const void *buf, size_t count)
+{
+	if (fd < 0 || fd != bench_i2c.fd)
+		return __real_write(fd, buf, count);
+
+	bench_i2c.syscalls++;
+	if (bench_i2c.slave_address != BENCH_I2C_ADDRESS)
+		return -1;
+
+	bench_i2c.transactions++;
+	bench_i2c_slave_write(buf, count);
+
+	return count;
+}
+
+ssize_t __wrap_read(int fd, void *buf, size_t count)
+{
+	if (fd < 0 || fd != bench_i2c.fd)
+		return __real_read(fd, buf, count);
+
+	bench_i2c.syscalls++;
+	if (bench_i2c.slave_address != BENCH_I2C_ADDRESS)
+		return -1;
+
+	bench_i2c.transactions++;
+	bench_i2c_slave_read(buf, count);
+
+	return count;
+}
+
+int __wrap_ioctl(int fd, unsigned long request, ...)
+{
+	struct i2c_rdwr_ioctl_data *rdwr;
+	struct i2c_msg *msg;
+	va_list args;
+	void *arg;
+	uint32_t i;
+
+	va_start(args, request);
+	arg = va_arg(args, void *);
+	va_end(args);
+
+	if (fd < 0 || fd != bench_i2c.fd)
+		return __real_ioctl(fd, request, arg);
+
+	bench_i2c.syscalls++;
+	switch (request) {
+	case I2C_SLAVE:
+		bench_i2c.slave_address = (uintptr_t)arg;
+		return 0;
+	case I2C_RDWR:
+		rdwr = arg;
+		bench_i2c.transactions++;
+		for (i = 0; i < rdwr->nmsgs; i++) {
+			msg = &rdwr->msgs[i];
+			if (msg->addr != BENCH_I2C_ADDRESS)
+				return -1;
+			if (msg->flags & I2C_M_RD)
+				bench_i2c_slave_read(msg->buf, msg->len);
+			else
+				bench_i2c_slave_write(msg->buf, msg->len);
+		}
+		return rdwr->nmsgs;
+	default:
+		return -1;
+	}
+}
+
+/**
+ * @brief Open the adapter and set the slave in a known state.
+ * @param ctx - Where the I2C descriptor is stored.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_i2c_setup(void **ctx)
+{
+	struct linux_i2c_init_param linux_init = {
+		.device_id = 0,
+	};
+	struct i2c_init_param init = {
+		.max_speed_hz = 400000,
+		.slave_address = BENCH_I2C_ADDRESS,
+		.platform_ops = &linux_i2c_platform_ops,
+		.extra = &linux_init,
+	};
+	struct i2c_desc *desc;
+	int32_t ret;
+
+	memset(bench_i2c.regs, 0, sizeof(bench_i2c.regs));
+	bench_i2c.regs[BENCH_I2C_ID_REG] = BENCH_I2C_ID;
+
+	ret = i2c_init(&desc, &init);
+	if (ret != SUCCESS)
+		return ret;
+
+	*ctx = desc;
+
+	return 0;
+}
+
+static void bench_i2c_reset_counters(void)
+{
+	bench_i2c.resets = 0;
+	bench_i2c.transactions = 0;
+	bench_i2c.syscalls = 0;
+}
+
+static void bench_i2c_report(struct bench_result *res)
+{
+	bench_counter(res, "transactions", bench_i2c.transactions);
+	bench_counter(res, "syscalls", bench_i2c.syscalls);
+}
+
+/**
+ * @brief A command written without stop condition, as in a reset followed by
+ * a delay, must reach the slave before i2c_write() returns.
+ */
+static int32_t bench_i2c_write_no_stop_run(void *ctx, struct bench_result *res)
+{
+	uint8_t cmd = BENCH_I2C_RESET_CMD;
+	int32_t ret;
+
+	bench_i2c_reset_counters();
+
+	ret = i2c_write(ctx, &cmd, 1, 0);
+	if (ret != SUCCESS)
+		return ret;
+
+	bench_i2c_report(res);
+	if (bench_i2c.resets != 1)
+		return -EIO;
+
+	return 0;
+}
+
+/**
+ * @brief Register reads with a repeated start, through i2c_write_read() and
+ * i2c_transfer(). Each one must be a single transaction.
+ */
+static int32_t bench_i2c_write_read_run(void *ctx, struct bench_result *res)
+{
+	uint8_t reg = BENCH_I2C_ID_REG;
+	uint8_t val;
+	struct i2c_xfer_msg msgs[] = {
+		{ .buf = &reg, .len = 1 },
+		{ .buf = &val, .len = 1, .flags = I2C_XFER_READ },
+	};
+	uint32_t i;
+	int32_t ret;
+
+	bench_i2c_reset_counters();
+
+	for (i = 0; i < BENCH_I2C_READS; i++) {
+		val = 0;
+		if (i & 1)
+			ret = i2c_transfer(ctx, msgs, ARRAY_SIZE(msgs));
+		else
+			ret = i2c_write_read(ctx, &reg, 1, &val, 1);
+		if (ret != SUCCESS)
+			return ret;
+		if (val != BENCH_I2C_ID)
+			return -EIO;
+	}
+
+	bench_i2c_report(res);
+	if (bench_i2c.transactions != BENCH_I2C_READS)
+		return -EIO;
+
+	return 0;
+}
+
+static void bench_i2c_teardown(void *ctx)
+{
+	i2c_remove(ctx);
+}
+
+const struct bench_case bench_i2c_write_no_stop = {
+	.name = "i2c_write_no_stop",
+	.iterations = 1000,
+	.setup = bench_i2c_setup,
+	.run = bench_i2c_write_no_stop_run,
+	.teardown = bench_i2c_teardown,
+};
+
+const struct bench_case bench_i2c_write_read = {
+	.name = "i2c_write_read",
+	.iterations = 100,
+	.setup = bench_i2c_setup,
+	.run = bench_i2c_write_read_run,
+	.teardown = bench_i2c_teardown,
+};
@@ -0,0 +1,657 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench_mqtt.c
+ *   @brief  Telemetry publishing to a fake MQTT broker that acknowledges QoS1.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mqtt_client.h"
+#include "mqtt_telemetry.h"
+#include "tcp_socket.h"
+#include "timer.h"
+#include "error.h"
+#include "util.h"
+#include "bench.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_MQTT_TOPIC		"noos/telemetry"
+/* Synchronous QoS1 publish sent while telemetry is in flight */
+#define BENCH_MQTT_STATUS_TOPIC		"noos/status"
+#define BENCH_MQTT_BUFF_SIZE		512
+#define BENCH_MQTT_CHANNELS		3
+#define BENCH_MQTT_SAMPLES		1536
+#define BENCH_MQTT_SAMPLES_PER_MESSAGE	32
+#define BENCH_MQTT_QUEUE_SIZE		256
+/* Samples pushed between two calls of mqtt_telemetry_process(): 6 messages,
+ * more than the window */
+#define BENCH_MQTT_PROCESS_EVERY	192
+#define BENCH_MQTT_WINDOW		4
+/* The broker sends a PUBACK this many socket reads after the PUBLISH */
+#define BENCH_MQTT_ACK_DELAY		8
+#define BENCH_MQTT_TIMEOUT_MS		1000
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum bench_mqtt_packet
+ * @brief MQTT control packet types handled by the broker.
+ */
+enum bench_mqtt_packet {
+	BENCH_MQTT_CONNECT = 1,
+	BENCH_MQTT_CONNACK = 2,
+	BENCH_MQTT_PUBLISH = 3,
+	BENCH_MQTT_PUBACK = 4,
+	BENCH_MQTT_PINGREQ = 12,
+	BENCH_MQTT_PINGRESP = 13,
+	BENCH_MQTT_DISCONNECT = 14
+};
+
+/**
+ * @struct bench_mqtt_ack
+ * @brief PUBACK held back by the broker.
+ */
+struct bench_mqtt_ack {
+	/** Packet identifier */
+	uint16_t id;
+	/** Socket read from which the PUBACK is sent */
+	uint32_t due;
+};
+
+/**
+ * @struct bench_mqtt_broker
+ * @brief Broker at the other end of the socket. It decodes the telemetry
+ * messages and acknowledges the QoS1 publishes.
+ */
+struct bench_mqtt_broker {
+	/** Bytes of the client packet being received */
+	uint8_t in[BENCH_MQTT_BUFF_SIZE];
+	uint32_t in_len;
+	/** Bytes waiting to be read by the client */
+	uint8_t out[64];
+	uint32_t out_len;
+	/** PUBACKs not sent yet, oldest first */
+	struct bench_mqtt_ack acks[MQTT_MAX_INFLIGHT + 1];
+	uint32_t nb_acks;
+	/** QoS1 publishes whose PUBACK wasn't sent */
+	uint32_t inflight;
+	uint32_t max_inflight;
+	/** Index of the next expected sample */
+	uint32_t next_sample;
+	/** Counters, wire_bytes and payload_bytes of the telemetry only */
+	uint32_t reads;
+	uint32_t writes;
+	uint32_t messages;
+	uint32_t payload_bytes;
+	uint32_t wire_bytes;
+	uint32_t status_messages;
+	/** First protocol or content error */
+	int32_t error;
+};
+
+/**
+ * @struct bench_mqtt_ctx
+ * @brief Client side of the case.
+ */
+struct bench_mqtt_ctx {
+	struct bench_mqtt_broker broker;
+	struct network_interface net;
+	struct tcp_socket_desc *sock;
+	struct mqtt_desc *mqtt;
+	uint8_t send_buff[BENCH_MQTT_BUFF_SIZE];
+	uint8_t read_buff[BENCH_MQTT_BUFF_SIZE];
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/*
+ * Millisecond timer of mqtt_noos_support.c. No platform timer is built for
+ * the host, the monotonic clock is used.
+ */
+int32_t timer_init(struct timer_desc **desc, struct timer_init_param *param)
+{
+	struct timer_desc *ldesc;
+
+	ldesc = calloc(1, sizeof(*ldesc));
+	if (!ldesc)
+		return -ENOMEM;
+
+	ldesc->id = param->id;
+	ldesc->freq_hz = param->freq_hz;
+	ldesc->load_value = param->load_value;
+	ldesc->extra = param->extra;
+	*desc = ldesc;
+
+	return SUCCESS;
+}
+
+int32_t timer_remove(struct timer_desc *desc)
+{
+	free(desc);
+
+	return SUCCESS;
+}
+
+int32_t timer_start(struct timer_desc *desc)
+{
+	return SUCCESS;
+}
+
+int32_t timer_counter_get(struct timer_desc *desc, uint32_t *counter)
+{
+	*counter = (uint32_t)(bench_time_ns() / (1000000000ull / desc->freq_hz));
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Sample i of the acquisition: channels in turn, values with positive
+ * and negative steps.
+ */
+static void bench_mqtt_sample(uint32_t i, struct mqtt_telemetry_sample *s)
+{
+	s->channel = i % BENCH_MQTT_CHANNELS;
+	s->timestamp = 100000 + i * 5;
+	s->value = s->channel * 10000 + (int32_t)((i * 37) % 201) - 100;
+}
+
+static int32_t bench_mqtt_varint(const uint8_t **p, const uint8_t *end,
+				 uint32_t *val)
+{
+	uint32_t shift;
+
+	*val = 0;
+	for (shift = 0; shift < 35; shift += 7) {
+		if (*p == end)
+			return -EBADMSG;
+		*val |= (uint32_t)(**p & 0x7F) << shift;
+		if (!(*(*p)++ & 0x80))
+			return SUCCESS;
+	}
+
+	return -EBADMSG;
+}
+
+static int32_t bench_mqtt_zigzag(const uint8_t **p, const uint8_t *end,
+				 int32_t *val)
+{
+	uint32_t raw;
+	int32_t ret;
+
+	ret = bench_mqtt_varint(p, end, &raw);
+	*val = (int32_t)(raw >> 1) ^ -(int32_t)(raw & 1);
+
+	return ret;
+}
+
+/**
+ * @brief Decode a telemetry payload and check it against the samples pushed
+ * by the client.
+ */
+static int32_t bench_mqtt_decode(struct bench_mqtt_broker *b,
+				 const uint8_t *p, uint32_t len)
+{
+	int32_t prev_value[MQTT_TELEMETRY_MAX_CHANNELS] = { 0 };
+	struct mqtt_telemetry_sample expected;
+	const uint8_t *end = p + len;
+	uint32_t timestamp;
+	uint32_t count;
+	int32_t delta;
+	uint8_t channel;
+	uint32_t i;
+
+	if (!len || *p++ != MQTT_TELEMETRY_FORMAT)
+		return -EBADMSG;
+	if (bench_mqtt_varint(&p, end, &count) ||
+	    bench_mqtt_varint(&p, end, &timestamp))
+		return -EBADMSG;
+	if (!count || count > BENCH_MQTT_SAMPLES_PER_MESSAGE)
+		return -EBADMSG;
+
+	for (i = 0; i < count; i++) {
+		if (p == end)
+			return -EBADMSG;
+		channel = *p++;
+		if (channel >= MQTT_TELEMETRY_MAX_CHANNELS)
+			return -EBADMSG;
+		if (bench_mqtt_zigzag(&p, end, &delta))
+			return -EBADMSG;
+		timestamp += delta;
+		if (bench_mqtt_zigzag(&p, end, &delta))
+			return -EBADMSG;
+		prev_value[channel] += delta;
+
+		bench_mqtt_sample(b->next_sample++, &expected);
+		if (channel != expected.channel ||
+		    timestamp != expected.timestamp ||
+		    prev_value[channel] != expected.value)
+			return -EBADMSG;
+	}
+
+	return p == end ? SUCCESS : -EBADMSG;
+}
+
+static void bench_mqtt_reply(struct bench_mqtt_broker *b, const uint8_t *data,
+			     uint32_t len)
+{
+	if (b->out_len + len > sizeof(b->out)) {
+		b->error = -ENOBUFS;
+		return;
+	}
+
+	memcpy(&b->out[b->out_len], data, len);
+	b->out_len += len;
+}
+
+/**
+ * @brief Handle a PUBLISH packet.
+ * @param b - Broker.
+ * @param p - Variable header and payload.
+ * @param len - Remaining length of the packet.
+ * @param qos - QoS of the packet.
+ * @param wire_len - Size of the whole packet.
+ */
+static int32_t bench_mqtt_publish(struct bench_mqtt_broker *b, const uint8_t *p,
+				  uint32_t len, uint8_t qos, uint32_t wire_len)
+{
+	uint32_t topic_len;
+	uint32_t hdr_len;
+	uint16_t id = 0;
+	int32_t ret;
+
+	if (len < 2)
+		return -EBADMSG;
+	topic_len = (p[0] << 8) | p[1];
+	hdr_len = 2 + topic_len + (qos ? 2 : 0);
+	if (qos > 1 || hdr_len > len)
+		return -EBADMSG;
+	if (qos)
+		id = (p[2 + topic_len] << 8) | p[3 + topic_len];
+
+	if (topic_len == strlen(BENCH_MQTT_TOPIC) &&
+	    !memcmp(&p[2], BENCH_MQTT_TOPIC, topic_len)) {
+		ret = bench_mqtt_decode(b, &p[hdr_len], len - hdr_len);
+		if (ret != SUCCESS)
+			return ret;
+		b->messages++;
+		b->payload_bytes += len - hdr_len;
+		b->wire_bytes += wire_len;
+	} else if (topic_len == strlen(BENCH_MQTT_STATUS_TOPIC) &&
+		   !memcmp(&p[2], BENCH_MQTT_STATUS_TOPIC, topic_len)) {
+		/* mqtt_publish() must not overtake the telemetry in flight */
+		if (b->inflight)
+			return -EBUSY;
+		b->status_messages++;
+	} else {
+		return -EBADMSG;
+	}
+
+	if (!qos)
+		return SUCCESS;
+
+	if (b->nb_acks == ARRAY_SIZE(b->acks))
+		return -ENOBUFS;
+	b->acks[b->nb_acks].id = id;
+	b->acks[b->nb_acks].due = b->reads + BENCH_MQTT_ACK_DELAY;
+	b->nb_acks++;
+	b->inflight++;
+	b->max_inflight = max(b->max_inflight, b->inflight);
+	/* The client must keep within its window */
+	if (b->inflight > BENCH_MQTT_WINDOW)
+		return -EBUSY;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Handle the client packets received so far.
+ */
+static void bench_mqtt_broker_rx(struct bench_mqtt_broker *b)
+{
+	static const uint8_t connack[] = { BENCH_MQTT_CONNACK << 4, 2, 0, 0 };
+	static const uint8_t pingresp[] = { BENCH_MQTT_PINGRESP << 4, 0 };
+	uint32_t rem_len;
+	uint32_t hdr_len;
+	uint32_t shift;
+	int32_t ret;
+	uint8_t type;
+
+	while (!b->error && b->in_len >= 2) {
+		rem_len = 0;
+		shift = 0;
+		hdr_len = 1;
+		do {
+			if (hdr_len == b->in_len)
+				return;
+			rem_len |= (b->in[hdr_len] & 0x7F) << shift;
+			shift += 7;
+		} while (b->in[hdr_len++] & 0x80);
+		if (b->in_len < hdr_len + rem_len)
+			return;
+
+		type = b->in[0] >> 4;
+		switch (type) {
+		case BENCH_MQTT_CONNECT:
+			bench_mqtt_reply(b, connack, sizeof(connack));
+			break;
+		case BENCH_MQTT_PUBLISH:
+			ret = bench_mqtt_publish(b, &b->in[hdr_len], rem_len,
+						 (b->in[0] >> 1) & 0x03,
+						 hdr_len + rem_len);
+			if (ret != SUCCESS)
+				b->error = ret;
+			break;
+		case BENCH_MQTT_PINGREQ:
+			bench_mqtt_reply(b, pingresp, sizeof(pingresp));
+			break;
+		case BENCH_MQTT_DISCONNECT:
+			break;
+		default:
+			b->error = -EBADMSG;
+			break;
+		}
+
+		b->in_len -= hdr_len + rem_len;
+		memmove(b->in, &b->in[hdr_len + rem_len], b->in_len);
+	}
+}
+
+static int32_t bench_mqtt_socket_open(void *net, uint32_t *sock_id,
+				      enum socket_protocol proto,
+				      uint32_t buff_size)
+{
+	*sock_id = 0;
+
+	return SUCCESS;
+}
+
+static int32_t bench_mqtt_socket_close(void *net, uint32_t sock_id)
+{
+	return SUCCESS;
+}
+
+static int32_t bench_mqtt_socket_connect(void *net, uint32_t sock_id,
+		struct socket_address *addr)
+{
+	return SUCCESS;
+}
+
+static int32_t bench_mqtt_socket_disconnect(void *net, uint32_t sock_id)
+{
+	return SUCCESS;
+}
+
+static int32_t bench_mqtt_socket_send(void *net, uint32_t sock_id,
+				      const void *data, uint32_t size)
+{
+	struct bench_mqtt_broker *b = net;
+
+	b->writes++;
+	size = min(size, (uint32_t)(sizeof(b->in) - b->in_len));
+	if (!size)
+		return -ENOBUFS;
+
+	memcpy(&b->in[b->in_len], data, size);
+	b->in_len += size;
+	bench_mqtt_broker_rx(b);
+
+	return size;
+}
+
+static int32_t bench_mqtt_socket_recv(void *net, uint32_t sock_id, void *data,
+				      uint32_t size)
+{
+	struct bench_mqtt_broker *b = net;
+	uint8_t puback[4] = { BENCH_MQTT_PUBACK << 4, 2 };
+	uint32_t i;
+
+	b->reads++;
+	while (b->nb_acks && b->acks[0].due <= b->reads) {
+		puback[2] = b->acks[0].id >> 8;
+		puback[3] = b->acks[0].id & 0xFF;
+		bench_mqtt_reply(b, puback, sizeof(puback));
+		b->inflight--;
+		b->nb_acks--;
+		for (i = 0; i < b->nb_acks; i++)
+			b->acks[i] = b->acks[i + 1];
+	}
+
+	if (b->error)
+		return b->error;
+	if (!b->out_len)
+		return -EAGAIN;
+
+	size = min(size, b->out_len);
+	memcpy(data, b->out, size);
+	b->out_len -= size;
+	memmove(b->out, &b->out[size], b->out_len);
+
+	return size;
+}
+
+static int32_t bench_mqtt_setup(void **ctx)
+{
+	struct bench_mqtt_ctx *mctx;
+	struct tcp_socket_init_param sock_init = { 0 };
+	struct socket_address addr = { .addr = "broker", .port = 1883 };
+	struct mqtt_init_param mqtt_init_param = { 0 };
+	struct mqtt_connect_config conn = {
+		.version = MQTT_VERSION_3_1_1,
+		.keep_alive_ms = 60,
+		.client_name = (int8_t *)"noos-bench",
+	};
+	int32_t ret;
+
+	mctx = calloc(1, sizeof(*mctx));
+	if (!mctx)
+		return -ENOMEM;
+
+	mctx->net.net = &mctx->broker;
+	mctx->net.socket_open = bench_mqtt_socket_open;
+	mctx->net.socket_close = bench_mqtt_socket_close;
+	mctx->net.socket_connect = bench_mqtt_socket_connect;
+	mctx->net.socket_disconnect = bench_mqtt_socket_disconnect;
+	mctx->net.socket_send = bench_mqtt_socket_send;
+	mctx->net.socket_recv = bench_mqtt_socket_recv;
+
+	sock_init.net = &mctx->net;
+	ret = socket_init(&mctx->sock, &sock_init);
+	if (ret != SUCCESS)
+		goto error;
+	ret = socket_connect(mctx->sock, &addr);
+	if (ret != SUCCESS)
+		goto error_sock;
+
+	mqtt_init_param.sock = mctx->sock;
+	mqtt_init_param.command_timeout_ms = BENCH_MQTT_TIMEOUT_MS;
+	mqtt_init_param.send_buff = mctx->send_buff;
+	mqtt_init_param.read_buff = mctx->read_buff;
+	mqtt_init_param.send_buff_size = sizeof(mctx->send_buff);
+	mqtt_init_param.read_buff_size = sizeof(mctx->read_buff);
+	mqtt_init_param.inflight_window = BENCH_MQTT_WINDOW;
+	ret = mqtt_init(&mctx->mqtt, &mqtt_init_param);
+	if (ret != SUCCESS)
+		goto error_sock;
+
+	ret = mqtt_connect(mctx->mqtt, &conn, NULL);
+	if (ret != SUCCESS || mctx->broker.error) {
+		ret = -ECONNREFUSED;
+		goto error_mqtt;
+	}
+
+	*ctx = mctx;
+
+	return SUCCESS;
+
+error_mqtt:
+	mqtt_remove(mctx->mqtt);
+error_sock:
+	socket_remove(mctx->sock);
+error:
+	free(mctx);
+
+	return ret;
+}
+
+static void bench_mqtt_teardown(void *ctx)
+{
+	struct bench_mqtt_ctx *mctx = ctx;
+
+	mqtt_disconnect(mctx->mqtt);
+	mqtt_remove(mctx->mqtt);
+	socket_remove(mctx->sock);
+	free(mctx);
+}
+
+/**
+ * @brief Publish the acquisition through the telemetry publisher, with a
+ * synchronous status message in the middle.
+ */
+static int32_t bench_mqtt_publish_samples(struct bench_mqtt_ctx *mctx,
+		struct mqtt_telemetry_desc *tele)
+{
+	struct mqtt_telemetry_sample s;
+	struct mqtt_message status = {
+		.qos = MQTT_QOS1,
+		.payload = (uint8_t *)"busy",
+		.len = 4,
+	};
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < BENCH_MQTT_SAMPLES; i++) {
+		bench_mqtt_sample(i, &s);
+		ret = mqtt_telemetry_push(tele, s.channel, s.timestamp,
+					  s.value);
+		if (ret != SUCCESS)
+			return ret;
+
+		if (i == BENCH_MQTT_SAMPLES / 2) {
+			ret = mqtt_publish(mctx->mqtt,
+					   (int8_t *)BENCH_MQTT_STATUS_TOPIC,
+					   &status);
+			if (ret != SUCCESS)
+				return ret;
+		}
+
+		if ((i + 1) % BENCH_MQTT_PROCESS_EVERY)
+			continue;
+		ret = mqtt_telemetry_process(tele);
+		if (ret != SUCCESS)
+			return ret;
+		if (mqtt_get_inflight(mctx->mqtt) > BENCH_MQTT_WINDOW)
+			return -EBUSY;
+	}
+
+	return mqtt_telemetry_flush(tele, BENCH_MQTT_TIMEOUT_MS);
+}
+
+static int32_t bench_mqtt_telemetry_run(void *ctx, struct bench_result *res)
+{
+	struct bench_mqtt_ctx *mctx = ctx;
+	struct bench_mqtt_broker *b = &mctx->broker;
+	struct mqtt_telemetry_init_param tele_init = {
+		.mqtt = mctx->mqtt,
+		.topic = (const int8_t *)BENCH_MQTT_TOPIC,
+		.qos = MQTT_QOS1,
+		.queue_size = BENCH_MQTT_QUEUE_SIZE,
+		.samples_per_message = BENCH_MQTT_SAMPLES_PER_MESSAGE,
+	};
+	struct mqtt_telemetry_desc *tele;
+	struct mqtt_telemetry_stats stats;
+	int32_t ret;
+
+	b->next_sample = 0;
+	b->max_inflight = 0;
+	b->reads = 0;
+	b->writes = 0;
+	b->messages = 0;
+	b->payload_bytes = 0;
+	b->wire_bytes = 0;
+	b->status_messages = 0;
+
+	ret = mqtt_telemetry_init(&tele, &tele_init);
+	if (ret != SUCCESS)
+		return ret;
+
+	ret = bench_mqtt_publish_samples(mctx, tele);
+	mqtt_telemetry_get_stats(tele, &stats);
+	mqtt_telemetry_remove(tele);
+	if (ret != SUCCESS)
+		return ret;
+	if (b->error)
+		return b->error;
+
+	/* Everything decoded and acknowledged, and the same view on both ends */
+	if (b->next_sample != BENCH_MQTT_SAMPLES || b->inflight ||
+	    mqtt_get_inflight(mctx->mqtt) || b->status_messages != 1 ||
+	    stats.messages != b->messages ||
+	    stats.samples != BENCH_MQTT_SAMPLES ||
+	    stats.payload_bytes != b->payload_bytes ||
+	    stats.wire_bytes != b->wire_bytes)
+		return -EIO;
+
+	bench_counter(res, "messages", b->messages);
+	bench_counter(res, "samples", stats.samples);
+	bench_counter(res, "payload_bytes", b->payload_bytes);
+	bench_counter(res, "wire_bytes", b->wire_bytes);
+	bench_counter(res, "dropped", stats.dropped);
+	bench_counter(res, "max_inflight", b->max_inflight);
+	bench_counter(res, "socket_reads", b->reads);
+	bench_counter(res, "socket_writes", b->writes);
+
+	return SUCCESS;
+}
+
+const struct bench_case bench_mqtt_telemetry_qos1 = {
+	.name = "mqtt_telemetry_qos1",
+	.iterations = 20,
+	.setup = bench_mqtt_setup,
+	.run = bench_mqtt_telemetry_run,
+	.teardown = bench_mqtt_teardown,
+	.rate = "messages",
+};
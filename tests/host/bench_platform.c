@@ -0,0 +1,364 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench_platform.c
+ *   @brief  Platform stand-ins for the host benchmarks.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "error.h"
+#include "bench_platform.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_irq
+ * @brief State of one simulated interrupt.
+ */
+struct bench_irq {
+	/** Handler */
+	struct callback_desc cb;
+	/** Set once a handler is registered */
+	bool registered;
+	/** Set while the interrupt is enabled */
+	bool enabled;
+	/** Set while the handler runs */
+	bool active;
+	/** Raised and not handled yet */
+	bool pending;
+	/** Event passed to the handler */
+	uint32_t event;
+};
+
+/******************************************************************************/
+/************************ Variable Definitions ********************************/
+/******************************************************************************/
+
+static struct bench_irq bench_irqs[BENCH_IRQ_MAX];
+
+static uint32_t bench_allocs;
+static uint32_t bench_frees;
+
+static void (*bench_idle_hook)(void *ctx, uint32_t usecs);
+static void *bench_idle_ctx;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static int32_t bench_gpio_get(struct gpio_desc **desc,
+			      const struct gpio_init_param *param)
+{
+	struct gpio_desc *descriptor;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return FAILURE;
+
+	descriptor->number = param->number;
+	descriptor->platform_ops = param->platform_ops;
+	*desc = descriptor;
+
+	return SUCCESS;
+}
+
+static int32_t bench_gpio_remove(struct gpio_desc *desc)
+{
+	free(desc);
+
+	return SUCCESS;
+}
+
+static int32_t bench_gpio_direction_input(struct gpio_desc *desc)
+{
+	return SUCCESS;
+}
+
+static int32_t bench_gpio_direction_output(struct gpio_desc *desc,
+		uint8_t value)
+{
+	return SUCCESS;
+}
+
+static int32_t bench_gpio_get_direction(struct gpio_desc *desc,
+					uint8_t *direction)
+{
+	*direction = GPIO_OUT;
+
+	return SUCCESS;
+}
+
+static int32_t bench_gpio_set_value(struct gpio_desc *desc, uint8_t value)
+{
+	return SUCCESS;
+}
+
+static int32_t bench_gpio_get_value(struct gpio_desc *desc, uint8_t *value)
+{
+	*value = GPIO_LOW;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Initialize the simulated interrupt controller.
+ * @param desc - The controller descriptor.
+ * @param param - Controller parameters.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t irq_ctrl_init(struct irq_ctrl_desc **desc,
+		      const struct irq_init_param *param)
+{
+	struct irq_ctrl_desc *descriptor;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return FAILURE;
+
+	descriptor->irq_ctrl_id = param->irq_ctrl_id;
+	*desc = descriptor;
+
+	return SUCCESS;
+}
+
+int32_t irq_ctrl_remove(struct irq_ctrl_desc *desc)
+{
+	memset(bench_irqs, 0, sizeof(bench_irqs));
+	free(desc);
+
+	return SUCCESS;
+}
+
+int32_t irq_register_callback(struct irq_ctrl_desc *desc, uint32_t irq_id,
+			      struct callback_desc *callback_desc)
+{
+	if (irq_id >= BENCH_IRQ_MAX)
+		return -EINVAL;
+
+	bench_irqs[irq_id].cb = *callback_desc;
+	bench_irqs[irq_id].registered = true;
+
+	return SUCCESS;
+}
+
+int32_t irq_unregister(struct irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	if (irq_id >= BENCH_IRQ_MAX)
+		return -EINVAL;
+
+	memset(&bench_irqs[irq_id], 0, sizeof(bench_irqs[irq_id]));
+
+	return SUCCESS;
+}
+
+int32_t irq_global_enable(struct irq_ctrl_desc *desc)
+{
+	return SUCCESS;
+}
+
+int32_t irq_global_disable(struct irq_ctrl_desc *desc)
+{
+	return SUCCESS;
+}
+
+/**
+ * @brief Call the handler of an interrupt until it stops being raised.
+ * @param irq - The interrupt.
+ * @param irq_id - Its number.
+ */
+static void bench_irq_deliver(struct bench_irq *irq, uint32_t irq_id)
+{
+	irq->active = true;
+	while (irq->pending && irq->enabled) {
+		irq->pending = false;
+		irq->cb.callback(irq->cb.ctx, irq->event, NULL);
+	}
+	irq->active = false;
+}
+
+int32_t irq_enable(struct irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	if (irq_id >= BENCH_IRQ_MAX)
+		return -EINVAL;
+
+	bench_irqs[irq_id].enabled = true;
+	/* An interrupt raised while masked is delivered now */
+	if (bench_irqs[irq_id].registered && !bench_irqs[irq_id].active)
+		bench_irq_deliver(&bench_irqs[irq_id], irq_id);
+
+	return SUCCESS;
+}
+
+int32_t irq_disable(struct irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	if (irq_id >= BENCH_IRQ_MAX)
+		return -EINVAL;
+
+	bench_irqs[irq_id].enabled = false;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Raise an interrupt. The handler is called at once, unless the
+ * interrupt is disabled or its handler is already running: it is then
+ * called once that is no longer the case. As on a GPIO controller, whose
+ * edge detection is configured with the handler, an interrupt raised before
+ * irq_register_callback() is not seen.
+ * @param irq_id - Interrupt number.
+ */
+void bench_irq_raise(uint32_t irq_id)
+{
+	bench_irq_raise_event(irq_id, irq_id);
+}
+
+/**
+ * @brief Raise an interrupt whose handler gets an event instead of the
+ * interrupt number, as the ADuCM3029 UART callbacks do.
+ * @param irq_id - Interrupt number.
+ * @param event - Event passed to the handler.
+ */
+void bench_irq_raise_event(uint32_t irq_id, uint32_t event)
+{
+	struct bench_irq *irq;
+
+	if (irq_id >= BENCH_IRQ_MAX)
+		return;
+
+	irq = &bench_irqs[irq_id];
+	if (!irq->registered)
+		return;
+
+	irq->pending = true;
+	irq->event = event;
+	if (irq->enabled && !irq->active)
+		bench_irq_deliver(irq, irq_id);
+}
+
+/**
+ * @brief Check if the handler of an interrupt could preempt the caller.
+ * @param irq_id - Interrupt number.
+ * @return true if the interrupt is enabled and its handler isn't running.
+ */
+bool bench_irq_can_preempt(uint32_t irq_id)
+{
+	if (irq_id >= BENCH_IRQ_MAX)
+		return false;
+
+	return bench_irqs[irq_id].enabled && !bench_irqs[irq_id].active;
+}
+
+void __real_udelay(uint32_t usecs);
+
+/**
+ * @brief Set the peripheral model that runs while the CPU waits in udelay().
+ * @param hook - Called with the wait instead of sleeping, NULL to sleep again.
+ * @param ctx - Passed to the hook.
+ */
+void bench_set_idle_hook(void (*hook)(void *ctx, uint32_t usecs), void *ctx)
+{
+	bench_idle_hook = hook;
+	bench_idle_ctx = ctx;
+}
+
+void __wrap_udelay(uint32_t usecs)
+{
+	if (bench_idle_hook) {
+		bench_idle_hook(bench_idle_ctx, usecs);
+		return;
+	}
+
+	__real_udelay(usecs);
+}
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void __real_free(void *ptr);
+
+void *__wrap_malloc(size_t size)
+{
+	bench_allocs++;
+
+	return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+	bench_allocs++;
+
+	return __real_calloc(nmemb, size);
+}
+
+void __wrap_free(void *ptr)
+{
+	if (ptr)
+		bench_frees++;
+
+	__real_free(ptr);
+}
+
+/**
+ * @brief Get the allocation counters.
+ * @param allocs - Number of malloc() and calloc() calls.
+ * @param frees - Number of free() calls with a non NULL pointer.
+ */
+void bench_alloc_stats(uint32_t *allocs, uint32_t *frees)
+{
+	*allocs = bench_allocs;
+	*frees = bench_frees;
+}
+
+/******************************************************************************/
+/************************ Variable Definitions ********************************/
+/******************************************************************************/
+
+const struct gpio_platform_ops bench_gpio_ops = {
+	.gpio_ops_get = &bench_gpio_get,
+	.gpio_ops_get_optional = &bench_gpio_get,
+	.gpio_ops_remove = &bench_gpio_remove,
+	.gpio_ops_direction_input = &bench_gpio_direction_input,
+	.gpio_ops_direction_output = &bench_gpio_direction_output,
+	.gpio_ops_get_direction = &bench_gpio_get_direction,
+	.gpio_ops_set_value = &bench_gpio_set_value,
+	.gpio_ops_get_value = &bench_gpio_get_value,
+};
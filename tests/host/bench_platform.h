@@ -0,0 +1,91 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench_platform.h
+ *   @brief  Platform stand-ins for the host benchmarks.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BENCH_PLATFORM_H_
+#define BENCH_PLATFORM_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdbool.h>
+#include "gpio.h"
+#include "irq.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_IRQ_MAX		8
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* GPIO platform ops: every line reads 0, writes are dropped. */
+extern const struct gpio_platform_ops bench_gpio_ops;
+
+/*
+ * bench_platform.c also provides the irq.h functions, on top of a software
+ * interrupt controller with BENCH_IRQ_MAX interrupts raised by the simulated
+ * peripherals.
+ */
+
+/* Raise a simulated interrupt. */
+void bench_irq_raise(uint32_t irq_id);
+
+/* Raise a simulated interrupt whose handler gets an event. */
+void bench_irq_raise_event(uint32_t irq_id, uint32_t event);
+
+/* Check if a handler could preempt the caller: enabled and not running. */
+bool bench_irq_can_preempt(uint32_t irq_id);
+
+/*
+ * udelay() is wrapped at link time. While a hook is set, a wait runs the
+ * hook, which advances a simulated peripheral by the waited time, instead of
+ * sleeping.
+ */
+void bench_set_idle_hook(void (*hook)(void *ctx, uint32_t usecs), void *ctx);
+
+/*
+ * malloc(), calloc() and free() are wrapped at link time. Get the number of
+ * allocations and of frees of a non NULL pointer so far.
+ */
+void bench_alloc_stats(uint32_t *allocs, uint32_t *frees);
+
+#endif // BENCH_PLATFORM_H_
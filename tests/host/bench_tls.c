@@ -0,0 +1,625 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench_tls.c
+ *   @brief  Full and resumed TLS handshakes of tcp_socket against an mbedtls server.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "tcp_socket.h"
+#include "error.h"
+#include "bench.h"
+#include "bench_platform.h"
+
+#ifndef DISABLE_SECURE_SOCKET
+#include "mbedtls/ssl.h"
+#include "mbedtls/ssl_cache.h"
+#include "mbedtls/certs.h"
+#include "mbedtls/x509_crt.h"
+#include "mbedtls/pk.h"
+#include "trng.h"
+#endif /* DISABLE_SECURE_SOCKET */
+
+#ifndef DISABLE_SECURE_SOCKET
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Application data sent by the client and echoed by the server */
+#define BENCH_TLS_MESSAGE_SIZE		256
+/* Polls of the echo before giving up */
+#define BENCH_TLS_POLLS			64
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* Host stand-in for the platform trng: a deterministic generator */
+struct trng_desc {
+	uint32_t state;
+};
+
+/**
+ * @struct bench_tls_server
+ * @brief mbedtls server at the other end of the socket pair. It runs while
+ * the client waits for data, accepts the sessions it cached and echoes the
+ * application data.
+ */
+struct bench_tls_server {
+	/** Server end of the socket pair */
+	int fd;
+	mbedtls_x509_crt crt;
+	mbedtls_pk_context key;
+	mbedtls_ssl_cache_context cache;
+	mbedtls_ssl_config conf;
+	mbedtls_ssl_context ssl;
+	struct trng_desc rng;
+	bool handshake_done;
+	/** Counters */
+	uint32_t handshakes;
+	uint32_t resumed;
+	/** First error */
+	int32_t error;
+};
+
+/**
+ * @struct bench_tls_ctx
+ * @brief Client side of the case: a tcp_socket over TLS whose network
+ * interface is the client end of the socket pair.
+ */
+struct bench_tls_ctx {
+	struct bench_tls_server server;
+	int fd;
+	struct network_interface net;
+	struct trng_init_param trng;
+	struct secure_init_param secure;
+	struct tcp_socket_desc *sock;
+	/** Bytes on the wire, seen from the client */
+	uint32_t tx_bytes;
+	uint32_t rx_bytes;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+int32_t trng_init(struct trng_desc **desc, struct trng_init_param *param)
+{
+	struct trng_desc *ldesc;
+
+	ldesc = calloc(1, sizeof(*ldesc));
+	if (!ldesc)
+		return -ENOMEM;
+
+	ldesc->state = 0x6e6f4f53 + param->dev_id;
+	*desc = ldesc;
+
+	return SUCCESS;
+}
+
+void trng_remove(struct trng_desc *desc)
+{
+	free(desc);
+}
+
+int32_t trng_fill_buffer(struct trng_desc *desc, uint8_t *buff, uint32_t len)
+{
+	uint32_t i;
+
+	/* xorshift32 */
+	for (i = 0; i < len; i++) {
+		desc->state ^= desc->state << 13;
+		desc->state ^= desc->state >> 17;
+		desc->state ^= desc->state << 5;
+		buff[i] = desc->state;
+	}
+
+	return SUCCESS;
+}
+
+static int bench_tls_rng(void *ctx, unsigned char *buff, size_t len)
+{
+	return trng_fill_buffer(ctx, buff, len);
+}
+
+static int bench_tls_server_send(void *ctx, const unsigned char *buff,
+				 size_t len)
+{
+	struct bench_tls_server *s = ctx;
+	ssize_t ret;
+
+	ret = send(s->fd, buff, len, MSG_DONTWAIT);
+	if (ret < 0)
+		return errno == EAGAIN ? MBEDTLS_ERR_SSL_WANT_WRITE : -errno;
+
+	return ret;
+}
+
+static int bench_tls_server_recv(void *ctx, unsigned char *buff, size_t len)
+{
+	struct bench_tls_server *s = ctx;
+	ssize_t ret;
+
+	ret = recv(s->fd, buff, len, MSG_DONTWAIT);
+	if (ret < 0)
+		return errno == EAGAIN ? MBEDTLS_ERR_SSL_WANT_READ : -errno;
+
+	return ret;
+}
+
+/* Session cache lookup, a hit means the handshake is resumed */
+static int bench_tls_cache_get(void *ctx, mbedtls_ssl_session *session)
+{
+	struct bench_tls_server *s = ctx;
+	int ret;
+
+	ret = mbedtls_ssl_cache_get(&s->cache, session);
+	if (!ret)
+		s->resumed++;
+
+	return ret;
+}
+
+static int bench_tls_cache_set(void *ctx, const mbedtls_ssl_session *session)
+{
+	struct bench_tls_server *s = ctx;
+
+	return mbedtls_ssl_cache_set(&s->cache, session);
+}
+
+/**
+ * @brief Run the server until it waits for the client: go on with the
+ * handshake, then echo what was received.
+ */
+static void bench_tls_server_step(struct bench_tls_server *s)
+{
+	uint8_t buff[BENCH_TLS_MESSAGE_SIZE];
+	int32_t len;
+	int32_t ret;
+
+	if (s->error)
+		return;
+
+	if (!s->handshake_done) {
+		ret = mbedtls_ssl_handshake(&s->ssl);
+		if (ret == MBEDTLS_ERR_SSL_WANT_READ ||
+		    ret == MBEDTLS_ERR_SSL_WANT_WRITE)
+			return;
+		if (ret) {
+			s->error = ret;
+			return;
+		}
+		s->handshake_done = true;
+		s->handshakes++;
+	}
+
+	len = mbedtls_ssl_read(&s->ssl, buff, sizeof(buff));
+	if (len == MBEDTLS_ERR_SSL_WANT_READ ||
+	    len == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY)
+		return;
+	if (len < 0) {
+		s->error = len;
+		return;
+	}
+
+	ret = mbedtls_ssl_write(&s->ssl, buff, len);
+	if (ret != len)
+		s->error = ret < 0 ? ret : -EIO;
+}
+
+/* A new connection: forget the previous one, keep the session cache */
+static int32_t bench_tls_server_accept(struct bench_tls_server *s)
+{
+	uint8_t buff[64];
+
+	while (recv(s->fd, buff, sizeof(buff), MSG_DONTWAIT) > 0)
+		;
+	s->handshake_done = false;
+
+	return mbedtls_ssl_session_reset(&s->ssl);
+}
+
+static void bench_tls_server_remove(struct bench_tls_server *s)
+{
+	mbedtls_ssl_free(&s->ssl);
+	mbedtls_ssl_config_free(&s->conf);
+	mbedtls_ssl_cache_free(&s->cache);
+	mbedtls_pk_free(&s->key);
+	mbedtls_x509_crt_free(&s->crt);
+}
+
+/**
+ * @brief Server with the RSA test certificate of mbedtls and a session
+ * cache.
+ */
+static int32_t bench_tls_server_init(struct bench_tls_server *s)
+{
+	int32_t ret;
+
+	mbedtls_x509_crt_init(&s->crt);
+	mbedtls_pk_init(&s->key);
+	mbedtls_ssl_cache_init(&s->cache);
+	mbedtls_ssl_config_init(&s->conf);
+	mbedtls_ssl_init(&s->ssl);
+	s->rng.state = 0x53525652;
+
+	ret = mbedtls_x509_crt_parse(&s->crt,
+				     (const unsigned char *)mbedtls_test_srv_crt_rsa,
+				     mbedtls_test_srv_crt_rsa_len);
+	if (ret)
+		return ret;
+	ret = mbedtls_pk_parse_key(&s->key,
+				   (const unsigned char *)mbedtls_test_srv_key_rsa,
+				   mbedtls_test_srv_key_rsa_len, NULL, 0);
+	if (ret)
+		return ret;
+
+	ret = mbedtls_ssl_config_defaults(&s->conf, MBEDTLS_SSL_IS_SERVER,
+					  MBEDTLS_SSL_TRANSPORT_STREAM,
+					  MBEDTLS_SSL_PRESET_DEFAULT);
+	if (ret)
+		return ret;
+	mbedtls_ssl_conf_rng(&s->conf, bench_tls_rng, &s->rng);
+	mbedtls_ssl_conf_session_cache(&s->conf, s, bench_tls_cache_get,
+				       bench_tls_cache_set);
+	ret = mbedtls_ssl_conf_own_cert(&s->conf, &s->crt, &s->key);
+	if (ret)
+		return ret;
+
+	ret = mbedtls_ssl_setup(&s->ssl, &s->conf);
+	if (ret)
+		return ret;
+	mbedtls_ssl_set_bio(&s->ssl, s, bench_tls_server_send,
+			    bench_tls_server_recv, NULL);
+
+	return SUCCESS;
+}
+
+static int32_t bench_tls_socket_open(void *net, uint32_t *sock_id,
+				     enum socket_protocol proto,
+				     uint32_t buff_size)
+{
+	*sock_id = 0;
+
+	return SUCCESS;
+}
+
+static int32_t bench_tls_socket_close(void *net, uint32_t sock_id)
+{
+	return SUCCESS;
+}
+
+static int32_t bench_tls_socket_connect(void *net, uint32_t sock_id,
+					struct socket_address *addr)
+{
+	struct bench_tls_ctx *tctx = net;
+	uint8_t buff[64];
+
+	/* Drop what is left of the previous connection */
+	while (recv(tctx->fd, buff, sizeof(buff), MSG_DONTWAIT) > 0)
+		;
+
+	return bench_tls_server_accept(&tctx->server);
+}
+
+static int32_t bench_tls_socket_disconnect(void *net, uint32_t sock_id)
+{
+	return SUCCESS;
+}
+
+static int32_t bench_tls_socket_send(void *net, uint32_t sock_id,
+				     const void *data, uint32_t size)
+{
+	struct bench_tls_ctx *tctx = net;
+	ssize_t ret;
+
+	ret = send(tctx->fd, data, size, MSG_DONTWAIT);
+	if (ret < 0)
+		return -errno;
+	tctx->tx_bytes += ret;
+
+	return ret;
+}
+
+/* The server runs when the client would wait for it */
+static int32_t bench_tls_socket_recv(void *net, uint32_t sock_id, void *data,
+				     uint32_t size)
+{
+	struct bench_tls_ctx *tctx = net;
+	ssize_t ret;
+
+	ret = recv(tctx->fd, data, size, MSG_DONTWAIT);
+	if (ret < 0 && errno == EAGAIN) {
+		bench_tls_server_step(&tctx->server);
+		if (tctx->server.error)
+			return tctx->server.error;
+		ret = recv(tctx->fd, data, size, MSG_DONTWAIT);
+	}
+	if (ret < 0)
+		return -errno;
+	tctx->rx_bytes += ret;
+
+	return ret;
+}
+
+/**
+ * @brief Send a message over the TLS socket and wait for its echo.
+ */
+static int32_t bench_tls_echo(struct bench_tls_ctx *tctx)
+{
+	uint8_t msg[BENCH_TLS_MESSAGE_SIZE];
+	uint8_t echo[BENCH_TLS_MESSAGE_SIZE];
+	uint32_t len = 0;
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < sizeof(msg); i++)
+		msg[i] = i * 7;
+
+	ret = socket_send(tctx->sock, msg, sizeof(msg));
+	if (ret != sizeof(msg))
+		return ret < 0 ? ret : -EIO;
+
+	for (i = 0; i < BENCH_TLS_POLLS && len < sizeof(echo); i++) {
+		ret = socket_recv(tctx->sock, &echo[len], sizeof(echo) - len);
+		if (ret == -EAGAIN)
+			continue;
+		if (ret <= 0)
+			return ret < 0 ? ret : -ECONNRESET;
+		len += ret;
+	}
+	if (len != sizeof(echo))
+		return -ETIMEDOUT;
+
+	return memcmp(msg, echo, sizeof(msg)) ? -EIO : SUCCESS;
+}
+
+/**
+ * @brief Connect, with a full or a resumed handshake depending on what the
+ * socket kept from its previous connection, echo a message and disconnect.
+ */
+static int32_t bench_tls_connect(struct bench_tls_ctx *tctx,
+				 struct bench_result *res)
+{
+	struct socket_address addr = { .addr = "server", .port = 8883 };
+	struct bench_tls_server *s = &tctx->server;
+	uint32_t allocs;
+	uint32_t allocs_end;
+	uint32_t frees;
+	uint32_t handshakes = s->handshakes;
+	uint32_t resumed = s->resumed;
+	int32_t ret;
+
+	tctx->tx_bytes = 0;
+	tctx->rx_bytes = 0;
+	bench_alloc_stats(&allocs, &frees);
+
+	ret = socket_connect(tctx->sock, &addr);
+	if (ret != SUCCESS)
+		return s->error ? s->error : ret;
+	bench_alloc_stats(&allocs_end, &frees);
+	if (res) {
+		bench_counter(res, "handshake_tx_bytes", tctx->tx_bytes);
+		bench_counter(res, "handshake_rx_bytes", tctx->rx_bytes);
+		bench_counter(res, "handshake_allocs", allocs_end - allocs);
+	}
+
+	ret = bench_tls_echo(tctx);
+	if (ret != SUCCESS)
+		return s->error ? s->error : ret;
+
+#ifdef MBEDTLS_SSL_MAX_FRAGMENT_LENGTH
+	if (res)
+		bench_counter(res, "max_frag_len",
+			      mbedtls_ssl_get_output_max_frag_len(&s->ssl));
+#endif /* MBEDTLS_SSL_MAX_FRAGMENT_LENGTH */
+
+	ret = socket_disconnect(tctx->sock);
+	if (ret != SUCCESS)
+		return ret;
+
+	if (s->handshakes != handshakes + 1)
+		return -EIO;
+	if (res)
+		bench_counter(res, "resumed", s->resumed - resumed);
+
+	return SUCCESS;
+}
+
+static int32_t bench_tls_socket_init(struct bench_tls_ctx *tctx)
+{
+	struct tcp_socket_init_param sock_init = {
+		.net = &tctx->net,
+		.secure_init_param = &tctx->secure,
+	};
+
+	/* No CA: the client does not verify the test certificate */
+	tctx->secure.trng_init_param = &tctx->trng;
+
+	return socket_init(&tctx->sock, &sock_init);
+}
+
+static void bench_tls_teardown(void *ctx)
+{
+	struct bench_tls_ctx *tctx = ctx;
+
+	if (tctx->sock)
+		socket_remove(tctx->sock);
+	bench_tls_server_remove(&tctx->server);
+	close(tctx->server.fd);
+	close(tctx->fd);
+	free(tctx);
+}
+
+static int32_t bench_tls_setup(void **ctx, bool connect)
+{
+	struct bench_tls_ctx *tctx;
+	int fds[2];
+	int32_t ret;
+
+	tctx = calloc(1, sizeof(*tctx));
+	if (!tctx)
+		return -ENOMEM;
+
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds)) {
+		free(tctx);
+		return -errno;
+	}
+	tctx->fd = fds[0];
+	tctx->server.fd = fds[1];
+
+	tctx->net.net = tctx;
+	tctx->net.socket_open = bench_tls_socket_open;
+	tctx->net.socket_close = bench_tls_socket_close;
+	tctx->net.socket_connect = bench_tls_socket_connect;
+	tctx->net.socket_disconnect = bench_tls_socket_disconnect;
+	tctx->net.socket_send = bench_tls_socket_send;
+	tctx->net.socket_recv = bench_tls_socket_recv;
+
+	ret = bench_tls_server_init(&tctx->server);
+	if (ret != SUCCESS)
+		goto error;
+
+	/* The resumed case starts with a session to offer */
+	if (connect) {
+		ret = bench_tls_socket_init(tctx);
+		if (ret != SUCCESS)
+			goto error;
+		ret = bench_tls_connect(tctx, NULL);
+		if (ret != SUCCESS)
+			goto error;
+	}
+
+	*ctx = tctx;
+
+	return SUCCESS;
+
+error:
+	bench_tls_teardown(tctx);
+
+	return ret;
+}
+
+static int32_t bench_tls_full_setup(void **ctx)
+{
+	return bench_tls_setup(ctx, false);
+}
+
+static int32_t bench_tls_resumed_setup(void **ctx)
+{
+	return bench_tls_setup(ctx, true);
+}
+
+/**
+ * @brief First connection of a new socket: full handshake.
+ */
+static int32_t bench_tls_full_run(void *ctx, struct bench_result *res)
+{
+	struct bench_tls_ctx *tctx = ctx;
+	uint32_t resumed = tctx->server.resumed;
+	int32_t ret;
+
+	ret = bench_tls_socket_init(tctx);
+	if (ret != SUCCESS)
+		return ret;
+
+	ret = bench_tls_connect(tctx, res);
+	socket_remove(tctx->sock);
+	tctx->sock = NULL;
+	if (ret != SUCCESS)
+		return ret;
+
+	return tctx->server.resumed != resumed ? -EIO : SUCCESS;
+}
+
+/**
+ * @brief Reconnection: the socket offers the session of its previous
+ * connection and the server resumes it.
+ */
+static int32_t bench_tls_resumed_run(void *ctx, struct bench_result *res)
+{
+	struct bench_tls_ctx *tctx = ctx;
+	uint32_t resumed = tctx->server.resumed;
+	int32_t ret;
+
+	ret = bench_tls_connect(tctx, res);
+	if (ret != SUCCESS)
+		return ret;
+
+	return tctx->server.resumed != resumed + 1 ? -EIO : SUCCESS;
+}
+
+#else
+
+/* The sockets are built without TLS when mbedtls is not checked out */
+static int32_t bench_tls_full_setup(void **ctx)
+{
+	return BENCH_SKIP;
+}
+
+static int32_t bench_tls_resumed_setup(void **ctx)
+{
+	return BENCH_SKIP;
+}
+
+#endif /* DISABLE_SECURE_SOCKET */
+
+const struct bench_case bench_tls_full_handshake = {
+	.name = "tls_full_handshake",
+	.iterations = 10,
+	.setup = bench_tls_full_setup,
+#ifndef DISABLE_SECURE_SOCKET
+	.run = bench_tls_full_run,
+	.teardown = bench_tls_teardown,
+#endif /* DISABLE_SECURE_SOCKET */
+};
+
+const struct bench_case bench_tls_resumed_handshake = {
+	.name = "tls_resumed_handshake",
+	.iterations = 10,
+	.setup = bench_tls_resumed_setup,
+#ifndef DISABLE_SECURE_SOCKET
+	.run = bench_tls_resumed_run,
+	.teardown = bench_tls_teardown,
+#endif /* DISABLE_SECURE_SOCKET */
+};
@@ -0,0 +1,380 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench_uart.c
+ *   @brief  Xilinx UART_PL (AXI UART Lite) throughput and CPU cost, polled and interrupt driven.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "uart.h"
+#include "uart_extra.h"
+#include "irq.h"
+#include "xuartlite.h"
+#include "error.h"
+#include "bench.h"
+#include "bench_platform.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_UART_BASE			0x40600000
+#define BENCH_UART_IRQ			1
+#define BENCH_UART_FIFO_SIZE		16
+#define BENCH_UART_BYTES		4096
+
+/*
+ * The model has no clock. When polled, a character time elapses every
+ * BENCH_UART_POLLS_PER_CHAR status reads. When interrupt driven, it elapses
+ * once per bench_uart_tick() called by an application doing something else
+ * meanwhile, and the handler is assumed to take less than a character time.
+ */
+#define BENCH_UART_POLLS_PER_CHAR	8
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_uart_model
+ * @brief State of the simulated AXI UART Lite.
+ */
+struct bench_uart_model {
+	/** Bytes in the TX FIFO */
+	uint32_t tx_level;
+	/** Interrupt enabled in the control register */
+	bool intr_enabled;
+	/** Status reads since the last character time */
+	uint32_t polls;
+	/** TX ring of the driver, to tell when the FIFO starves */
+	const struct xil_uart_ring *tx_ring;
+	/** Character times elapsed */
+	uint32_t char_times;
+	/** Bytes shifted out */
+	uint32_t wire_bytes;
+	/** Character times lost with an empty FIFO and bytes in the TX ring */
+	uint32_t starved;
+	/** Bytes written to a full TX FIFO */
+	uint32_t lost;
+	/** Register accesses */
+	uint32_t mmio;
+};
+
+/**
+ * @struct bench_uart_ctx
+ * @brief State of a UART case.
+ */
+struct bench_uart_ctx {
+	/** UART */
+	struct uart_desc *uart;
+	/** Interrupt controller, NULL when polled */
+	struct irq_ctrl_desc *irq;
+	/** Data to send */
+	uint8_t data[BENCH_UART_BYTES];
+};
+
+/******************************************************************************/
+/************************ Variable Definitions ********************************/
+/******************************************************************************/
+
+static struct bench_uart_model bench_uart;
+
+static XUartLite_Config bench_uart_config = {
+	.DeviceId = 0,
+	.RegBaseAddr = BENCH_UART_BASE,
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief One character time: shift a byte out of the TX FIFO.
+ */
+static void bench_uart_tick(void)
+{
+	bench_uart.char_times++;
+
+	if (!bench_uart.tx_level) {
+		if (bench_uart.tx_ring &&
+		    bench_uart.tx_ring->head != bench_uart.tx_ring->tail)
+			bench_uart.starved++;
+		return;
+	}
+
+	bench_uart.tx_level--;
+	bench_uart.wire_bytes++;
+	if (!bench_uart.tx_level && bench_uart.intr_enabled)
+		bench_irq_raise(BENCH_UART_IRQ);
+}
+
+uint32_t XUartLite_ReadReg(uintptr_t BaseAddress, uint32_t RegOffset)
+{
+	uint32_t status = 0;
+
+	bench_uart.mmio++;
+	if (RegOffset != XUL_STATUS_REG_OFFSET)
+		return 0;
+
+	if (!bench_uart.intr_enabled &&
+	    ++bench_uart.polls == BENCH_UART_POLLS_PER_CHAR) {
+		bench_uart.polls = 0;
+		bench_uart_tick();
+	}
+
+	if (!bench_uart.tx_level)
+		status |= XUL_SR_TX_FIFO_EMPTY;
+	if (bench_uart.tx_level == BENCH_UART_FIFO_SIZE)
+		status |= XUL_SR_TX_FIFO_FULL;
+	if (bench_uart.intr_enabled)
+		status |= XUL_SR_INTR_ENABLED;
+
+	return status;
+}
+
+void XUartLite_WriteReg(uintptr_t BaseAddress, uint32_t RegOffset,
+			uint32_t Data)
+{
+	bench_uart.mmio++;
+	if (RegOffset != XUL_TX_FIFO_OFFSET)
+		return;
+
+	if (bench_uart.tx_level == BENCH_UART_FIFO_SIZE)
+		bench_uart.lost++;
+	else
+		bench_uart.tx_level++;
+}
+
+XUartLite_Config *XUartLite_LookupConfig(uint16_t DeviceId)
+{
+	return DeviceId ? NULL : &bench_uart_config;
+}
+
+int XUartLite_CfgInitialize(XUartLite *InstancePtr, XUartLite_Config *Config,
+			    uintptr_t EffectiveAddr)
+{
+	InstancePtr->RegBaseAddress = EffectiveAddr;
+	InstancePtr->IsReady = 1;
+
+	return XST_SUCCESS;
+}
+
+unsigned int XUartLite_Recv(XUartLite *InstancePtr, uint8_t *DataBufferPtr,
+			    unsigned int NumBytes)
+{
+	return 0;
+}
+
+void XUartLite_EnableInterrupt(XUartLite *InstancePtr)
+{
+	bench_uart.intr_enabled = true;
+}
+
+void XUartLite_DisableInterrupt(XUartLite *InstancePtr)
+{
+	bench_uart.intr_enabled = false;
+}
+
+/**
+ * @brief Initialize the UART, polled or interrupt driven.
+ * @param ctx - Where the case state is stored.
+ * @param with_irq - Use an interrupt.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_uart_setup(void **ctx, bool with_irq)
+{
+	struct irq_init_param irq_init = { .irq_ctrl_id = 0 };
+	struct xil_uart_init_param xil_init = {
+		.type = UART_PL,
+		.irq_id = BENCH_UART_IRQ,
+	};
+	struct uart_init_param init = {
+		.device_id = 0,
+		.baud_rate = 115200,
+		.size = UART_CS_8,
+		.parity = UART_PAR_NO,
+		.stop = UART_STOP_1,
+		.extra = &xil_init,
+	};
+	struct bench_uart_ctx *uctx;
+	struct xil_uart_desc *xil_desc;
+	uint32_t i;
+	int32_t ret;
+
+	memset(&bench_uart, 0, sizeof(bench_uart));
+
+	uctx = calloc(1, sizeof(*uctx));
+	if (!uctx)
+		return -ENOMEM;
+
+	for (i = 0; i < BENCH_UART_BYTES; i++)
+		uctx->data[i] = i;
+
+	if (with_irq) {
+		ret = irq_ctrl_init(&uctx->irq, &irq_init);
+		if (ret < 0)
+			goto error_free;
+		xil_init.irq_desc = uctx->irq;
+	}
+
+	ret = uart_init(&uctx->uart, &init);
+	if (ret < 0)
+		goto error_irq;
+
+	xil_desc = uctx->uart->extra;
+	bench_uart.tx_ring = &xil_desc->tx_ring;
+	*ctx = uctx;
+
+	return 0;
+
+error_irq:
+	if (uctx->irq)
+		irq_ctrl_remove(uctx->irq);
+error_free:
+	free(uctx);
+
+	return ret;
+}
+
+static int32_t bench_uart_polled_setup(void **ctx)
+{
+	return bench_uart_setup(ctx, false);
+}
+
+static int32_t bench_uart_irq_setup(void **ctx)
+{
+	return bench_uart_setup(ctx, true);
+}
+
+/**
+ * @brief Report the counters of the model, check that every byte went out.
+ * @param res - Results of the iteration.
+ * @return 0 if all the data was sent, -EIO otherwise.
+ */
+static int32_t bench_uart_report(struct bench_result *res)
+{
+	bench_counter(res, "wire_bytes", bench_uart.wire_bytes);
+	bench_counter(res, "char_times", bench_uart.char_times);
+	bench_counter(res, "starved", bench_uart.starved);
+	bench_counter(res, "lost", bench_uart.lost);
+	bench_counter(res, "mmio", bench_uart.mmio);
+
+	if (bench_uart.wire_bytes != BENCH_UART_BYTES || bench_uart.tx_level ||
+	    bench_uart.lost)
+		return -EIO;
+
+	return 0;
+}
+
+/**
+ * @brief Polled: uart_write() must return with everything sent, the CPU is
+ * busy for all of the char_times.
+ */
+static int32_t bench_uart_polled_run(void *ctx, struct bench_result *res)
+{
+	struct bench_uart_ctx *uctx = ctx;
+	int32_t ret;
+
+	bench_uart.char_times = 0;
+	bench_uart.wire_bytes = 0;
+	bench_uart.mmio = 0;
+
+	ret = uart_write(uctx->uart, uctx->data, BENCH_UART_BYTES);
+	if (ret < 0)
+		return ret;
+
+	return bench_uart_report(res);
+}
+
+/**
+ * @brief Interrupt driven: the application queues what fits in the TX ring
+ * and does other work meanwhile. The CPU is only busy in the mmio accesses.
+ */
+static int32_t bench_uart_irq_run(void *ctx, struct bench_result *res)
+{
+	struct bench_uart_ctx *uctx = ctx;
+	uint32_t offset = 0;
+	int32_t ret;
+
+	bench_uart.char_times = 0;
+	bench_uart.wire_bytes = 0;
+	bench_uart.mmio = 0;
+
+	while (bench_uart.wire_bytes < BENCH_UART_BYTES) {
+		if (offset < BENCH_UART_BYTES) {
+			ret = uart_write_nonblocking(uctx->uart,
+						     uctx->data + offset,
+						     BENCH_UART_BYTES - offset);
+			if (ret < 0)
+				return ret;
+			offset += ret;
+		}
+		bench_uart_tick();
+		if (bench_uart.char_times > 2 * BENCH_UART_BYTES)
+			break;
+	}
+
+	return bench_uart_report(res);
+}
+
+static void bench_uart_teardown(void *ctx)
+{
+	struct bench_uart_ctx *uctx = ctx;
+
+	uart_remove(uctx->uart);
+	if (uctx->irq)
+		irq_ctrl_remove(uctx->irq);
+	free(uctx);
+}
+
+const struct bench_case bench_uart_pl_polled = {
+	.name = "uart_pl_polled_write",
+	.iterations = 20,
+	.setup = bench_uart_polled_setup,
+	.run = bench_uart_polled_run,
+	.teardown = bench_uart_teardown,
+};
+
+const struct bench_case bench_uart_pl_irq = {
+	.name = "uart_pl_irq_write",
+	.iterations = 20,
+	.setup = bench_uart_irq_setup,
+	.run = bench_uart_irq_run,
+	.teardown = bench_uart_teardown,
+};
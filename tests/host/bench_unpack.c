@@ -0,0 +1,147 @@
+/***************************************************************************//**
+ *   @file   tests/host/bench_unpack.c
+ *   @brief  AD7768-1 stream block unpacking benchmark.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "ad77681.h"
+#include "error.h"
+#include "bench.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_UNPACK_FRAMES		4096
+/* 24-bit conversion result followed by its CRC8 */
+#define BENCH_UNPACK_FRAME_BYTES	4
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_unpack_ctx
+ * @brief State of the unpacking case.
+ */
+struct bench_unpack_ctx {
+	/** Device, only the frame format is used */
+	struct ad77681_dev dev;
+	/** Raw frames */
+	uint8_t frames[BENCH_UNPACK_FRAMES * BENCH_UNPACK_FRAME_BYTES];
+	/** Conversion results */
+	int32_t samples[BENCH_UNPACK_FRAMES];
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static int32_t bench_unpack_setup(void **ctx)
+{
+	struct bench_unpack_ctx *uctx;
+	uint32_t i, code;
+	uint8_t *frame;
+
+	uctx = calloc(1, sizeof(*uctx));
+	if (!uctx)
+		return -ENOMEM;
+
+	uctx->dev.conv_len = AD77681_CONV_24BIT;
+	uctx->dev.crc_sel = AD77681_CRC;
+	uctx->dev.frame_bytes = BENCH_UNPACK_FRAME_BYTES;
+
+	/* A ramp crossing zero, with valid checksums */
+	frame = uctx->frames;
+	for (i = 0; i < BENCH_UNPACK_FRAMES; i++) {
+		code = (i * (0x1000000 / BENCH_UNPACK_FRAMES)) ^ 0x800000;
+		frame[0] = code >> 16;
+		frame[1] = code >> 8;
+		frame[2] = code;
+		frame[3] = ad77681_compute_crc8(frame, 3, INITIAL_CRC_CRC8);
+		frame += BENCH_UNPACK_FRAME_BYTES;
+	}
+
+	*ctx = uctx;
+
+	return 0;
+}
+
+/**
+ * @brief Check and unpack one block, as ad77681_stream_read_samples() does.
+ */
+static int32_t bench_unpack_run(void *ctx, struct bench_result *res)
+{
+	struct bench_unpack_ctx *uctx = ctx;
+	uint32_t errors;
+	int32_t ret;
+
+	ret = ad77681_block_crc_check(&uctx->dev, uctx->frames,
+				      BENCH_UNPACK_FRAMES, &errors);
+	if (ret < 0)
+		return ret;
+
+	ad77681_frames_to_samples(&uctx->dev, uctx->frames, uctx->samples,
+				  BENCH_UNPACK_FRAMES);
+
+	/* Spot check the sign extension on both ends of the ramp */
+	if (uctx->samples[0] != -0x800000 ||
+	    uctx->samples[BENCH_UNPACK_FRAMES - 1] <= 0)
+		return -EIO;
+
+	bench_counter(res, "frames", BENCH_UNPACK_FRAMES);
+	bench_counter(res, "crc_errors", errors);
+
+	return 0;
+}
+
+static void bench_unpack_teardown(void *ctx)
+{
+	free(ctx);
+}
+
+const struct bench_case bench_ad77681_unpack = {
+	.name = "ad77681_unpack",
+	.iterations = 1000,
+	.setup = bench_unpack_setup,
+	.run = bench_unpack_run,
+	.teardown = bench_unpack_teardown,
+};
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+#
+# Compare the results written by no-os-bench against a baseline.
+#
+# Usage: check_bench.py <baseline.json> <results.json>
+#
+# The counters (register accesses, SPI transfers, ...) are deterministic and
+# gated: the check fails if a case of the baseline is missing or failed, or
+# if one of its counters went up. Counters that went down are reported so
+# the baseline can be refreshed with "make baseline". Times and rates depend
+# on the machine and are only printed.
+
+import json
+import sys
+
+
+def load(path):
+	with open(path) as f:
+		return {b["name"]: b for b in json.load(f)["benchmarks"]}
+
+
+def main():
+	if len(sys.argv) != 3:
+		sys.exit("Usage: %s <baseline.json> <results.json>" % sys.argv[0])
+
+	baseline = load(sys.argv[1])
+	results = load(sys.argv[2])
+	failed = 0
+
+	for name, base in baseline.items():
+		res = results.get(name)
+		if res is None:
+			print("FAIL %s: not run" % name)
+			failed += 1
+			continue
+
+		if res["status"] == "skipped":
+			print("SKIP %s" % name)
+			continue
+
+		if res["status"] != "ok":
+			print("FAIL %s: error %d" % (name, res["error"]))
+			failed += 1
+			continue
+
+		status = "ok"
+		for counter, old in base["counters"].items():
+			new = res["counters"].get(counter)
+			if new is None:
+				print("FAIL %s: counter %s missing" % (name, counter))
+				status = "FAIL"
+			elif new > old:
+				print("FAIL %s: %s %d -> %d" % (name, counter, old, new))
+				status = "FAIL"
+			elif new < old:
+				print("note %s: %s %d -> %d, update the baseline" %
+				      (name, counter, old, new))
+		if status != "ok":
+			failed += 1
+
+		print("%-4s %-32s %12.3f us/iter" %
+		      (status, name, res["time_ns"]["mean"] / 1000.0))
+		for rate, value in res.get("rate", {}).items():
+			print("%-4s %-32s %12.0f %s" % ("", "", value, rate))
+
+	for name in results:
+		if name not in baseline:
+			print("note %s: not in the baseline" % name)
+
+	if failed:
+		sys.exit("%d case(s) failed" % failed)
+
+
+if __name__ == "__main__":
+	main()
@@ -0,0 +1,65 @@
+/***************************************************************************//**
+ *   @file   tests/host/compat/xuartlite_l.h
+ *   @brief  AXI UART Lite registers, implemented by the model in bench_uart.c.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef XUARTLITE_L_H /* prevent circular inclusions */
+#define XUARTLITE_L_H
+
+#include <stdint.h>
+
+#define XUL_RX_FIFO_OFFSET		0
+#define XUL_TX_FIFO_OFFSET		4
+#define XUL_STATUS_REG_OFFSET		8
+#define XUL_CONTROL_REG_OFFSET		12
+
+#define XUL_SR_PARITY_ERROR		0x80
+#define XUL_SR_FRAMING_ERROR		0x40
+#define XUL_SR_OVERRUN_ERROR		0x20
+#define XUL_SR_INTR_ENABLED		0x10
+#define XUL_SR_TX_FIFO_FULL		0x08
+#define XUL_SR_TX_FIFO_EMPTY		0x04
+#define XUL_SR_RX_FIFO_FULL		0x02
+#define XUL_SR_RX_FIFO_VALID_DATA	0x01
+
+uint32_t XUartLite_ReadReg(uintptr_t BaseAddress, uint32_t RegOffset);
+void XUartLite_WriteReg(uintptr_t BaseAddress, uint32_t RegOffset,
+			uint32_t Data);
+
+#define XUartLite_GetStatusReg(BaseAddress) \
+	XUartLite_ReadReg((BaseAddress), XUL_STATUS_REG_OFFSET)
+
+#endif // XUARTLITE_L_H
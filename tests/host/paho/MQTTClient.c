@@ -0,0 +1,440 @@
+/***************************************************************************//**
+ *   @file   tests/host/paho/MQTTClient.c
+ *   @brief  Stand-in for the paho embedded MQTT client used by libraries/mqtt.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <string.h>
+#include "MQTTClient.h"
+#include "error.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Write the remaining length field. Return its size. */
+static int mqtt_encode_length(unsigned char *buf, int len)
+{
+	int n = 0;
+
+	do {
+		buf[n] = len & 0x7F;
+		len >>= 7;
+		if (len)
+			buf[n] |= 0x80;
+		n++;
+	} while (len);
+
+	return n;
+}
+
+static int mqtt_length_size(int len)
+{
+	unsigned char buf[4];
+
+	return mqtt_encode_length(buf, len);
+}
+
+static int mqtt_string_len(MQTTString *str)
+{
+	return str->cstring ? (int)strlen(str->cstring) : str->lenstring.len;
+}
+
+/* Write a length prefixed string. Return its size. */
+static int mqtt_write_string(unsigned char *buf, MQTTString *str)
+{
+	const char *data = str->cstring ? str->cstring : str->lenstring.data;
+	int len = mqtt_string_len(str);
+
+	buf[0] = len >> 8;
+	buf[1] = len & 0xFF;
+	memcpy(&buf[2], data, len);
+
+	return 2 + len;
+}
+
+/* Write the fixed header. Return its size or FAILURE if the packet is too big. */
+static int mqtt_write_header(unsigned char *buf, int buflen, unsigned char byte,
+			     int rem_len)
+{
+	if (1 + mqtt_length_size(rem_len) + rem_len > buflen)
+		return FAILURE;
+
+	buf[0] = byte;
+
+	return 1 + mqtt_encode_length(&buf[1], rem_len);
+}
+
+int MQTTSerialize_publish(unsigned char *buf, int buflen, unsigned char dup,
+			  int qos, unsigned char retained,
+			  unsigned short packetid, MQTTString topicName,
+			  unsigned char *payload, int payloadlen)
+{
+	int rem_len;
+	int len;
+
+	rem_len = 2 + mqtt_string_len(&topicName) + (qos ? 2 : 0) + payloadlen;
+	len = mqtt_write_header(buf, buflen, (PUBLISH << 4) | (dup << 3) |
+				(qos << 1) | retained, rem_len);
+	if (len < 0)
+		return len;
+
+	len += mqtt_write_string(&buf[len], &topicName);
+	if (qos) {
+		buf[len++] = packetid >> 8;
+		buf[len++] = packetid & 0xFF;
+	}
+	memcpy(&buf[len], payload, payloadlen);
+
+	return len + payloadlen;
+}
+
+/* Write a packet from the send buffer */
+static int mqtt_send_packet(MQTTClient *c, int len, Timer *timer)
+{
+	int sent = 0;
+	int rc;
+
+	while (sent < len && !TimerIsExpired(timer)) {
+		rc = c->ipstack->mqttwrite(c->ipstack, &c->buf[sent], len - sent,
+					   TimerLeftMS(timer));
+		if (rc < 0)
+			return FAILURE;
+		sent += rc;
+	}
+	if (sent != len)
+		return FAILURE;
+
+	TimerCountdown(&c->last_sent, c->keepAliveInterval);
+
+	return SUCCESS;
+}
+
+/* Write a packet made of a fixed header and an optional packet identifier */
+static int mqtt_send_ack(MQTTClient *c, unsigned char byte, int has_id,
+			 unsigned short id, Timer *timer)
+{
+	int len;
+
+	len = mqtt_write_header(c->buf, c->buf_size, byte, has_id ? 2 : 0);
+	if (has_id) {
+		c->buf[len++] = id >> 8;
+		c->buf[len++] = id & 0xFF;
+	}
+
+	return mqtt_send_packet(c, len, timer);
+}
+
+/* Read a packet in the read buffer. Return its type, 0 if none arrived. */
+static int mqtt_read_packet(MQTTClient *c, Timer *timer)
+{
+	unsigned char byte;
+	int multiplier = 1;
+	int rem_len = 0;
+	int len;
+	int rc;
+
+	rc = c->ipstack->mqttread(c->ipstack, c->readbuf, 1, TimerLeftMS(timer));
+	if (rc != 1)
+		return rc < 0 ? rc : 0;
+
+	do {
+		rc = c->ipstack->mqttread(c->ipstack, &byte, 1,
+					  TimerLeftMS(timer));
+		if (rc != 1)
+			return FAILURE;
+		rem_len += (byte & 0x7F) * multiplier;
+		multiplier <<= 7;
+	} while (byte & 0x80);
+
+	len = 1 + mqtt_encode_length(&c->readbuf[1], rem_len);
+	if (rem_len > (int)c->readbuf_size - len)
+		return FAILURE;
+
+	if (rem_len > 0 &&
+	    c->ipstack->mqttread(c->ipstack, &c->readbuf[len], rem_len,
+				 TimerLeftMS(timer)) != rem_len)
+		return 0;
+
+	if (c->keepAliveInterval)
+		TimerCountdown(&c->last_received, c->keepAliveInterval);
+
+	return c->readbuf[0] >> 4;
+}
+
+/* Send a PINGREQ when nothing was sent or received for the keep alive time */
+static int mqtt_keepalive(MQTTClient *c)
+{
+	Timer timer;
+
+	if (!c->keepAliveInterval)
+		return SUCCESS;
+
+	if (!TimerIsExpired(&c->last_sent) && !TimerIsExpired(&c->last_received))
+		return SUCCESS;
+
+	if (c->ping_outstanding)
+		return FAILURE;
+
+	TimerInit(&timer);
+	TimerCountdownMS(&timer, 1000);
+	if (mqtt_send_ack(c, PINGREQ << 4, 0, 0, &timer) != SUCCESS)
+		return FAILURE;
+	c->ping_outstanding = 1;
+
+	return SUCCESS;
+}
+
+/* Handle one incoming packet. Return its type, 0 if none arrived. */
+static int mqtt_cycle(MQTTClient *c, Timer *timer)
+{
+	unsigned short id;
+	int type;
+	int qos;
+	int idx;
+
+	type = mqtt_read_packet(c, timer);
+	if (type < 0)
+		return type;
+
+	switch (type) {
+	case PUBLISH:
+		/* No subscriptions, acknowledge and drop the message */
+		qos = (c->readbuf[0] >> 1) & 0x03;
+		if (qos == QOS0)
+			break;
+		if (qos == QOS2)
+			return FAILURE;
+		idx = 1;
+		while (c->readbuf[idx++] & 0x80)
+			;
+		idx += 2 + ((c->readbuf[idx] << 8) | c->readbuf[idx + 1]);
+		id = (c->readbuf[idx] << 8) | c->readbuf[idx + 1];
+		if (mqtt_send_ack(c, PUBACK << 4, 1, id, timer) != SUCCESS)
+			return FAILURE;
+		break;
+	case PINGRESP:
+		c->ping_outstanding = 0;
+		break;
+	default:
+		break;
+	}
+
+	if (mqtt_keepalive(c) != SUCCESS)
+		return FAILURE;
+
+	return type;
+}
+
+/* Handle incoming packets until one of the given type arrives */
+static int mqtt_waitfor(MQTTClient *c, int type, Timer *timer)
+{
+	int rc;
+
+	do {
+		if (TimerIsExpired(timer))
+			return FAILURE;
+		rc = mqtt_cycle(c, timer);
+		if (rc < 0)
+			return rc;
+	} while (rc != type);
+
+	return rc;
+}
+
+void MQTTClientInit(MQTTClient *client, Network *network,
+		    unsigned int command_timeout_ms, unsigned char *sendbuf,
+		    size_t sendbuf_size, unsigned char *readbuf,
+		    size_t readbuf_size)
+{
+	memset(client, 0, sizeof(*client));
+	client->ipstack = network;
+	client->command_timeout_ms = command_timeout_ms;
+	client->buf = sendbuf;
+	client->buf_size = sendbuf_size;
+	client->readbuf = readbuf;
+	client->readbuf_size = readbuf_size;
+	client->next_packetid = 1;
+	TimerInit(&client->last_sent);
+	TimerInit(&client->last_received);
+}
+
+int MQTTConnectWithResults(MQTTClient *client,
+			   MQTTPacket_connectData *options,
+			   MQTTConnackData *data)
+{
+	unsigned char flags = 0;
+	Timer timer;
+	int rem_len;
+	int len;
+
+	if (client->isconnected)
+		return FAILURE;
+
+	rem_len = (options->MQTTVersion == 4 ? 6 : 8) + 4 +
+		  2 + mqtt_string_len(&options->clientID);
+	if (mqtt_string_len(&options->username)) {
+		flags |= 0x80;
+		rem_len += 2 + mqtt_string_len(&options->username);
+	}
+	if (mqtt_string_len(&options->password)) {
+		flags |= 0x40;
+		rem_len += 2 + mqtt_string_len(&options->password);
+	}
+	if (options->cleansession)
+		flags |= 0x02;
+
+	len = mqtt_write_header(client->buf, client->buf_size, CONNECT << 4,
+				rem_len);
+	if (len < 0)
+		return FAILURE;
+	if (options->MQTTVersion == 4) {
+		memcpy(&client->buf[len], "\0\4MQTT\4", 7);
+		len += 7;
+	} else {
+		memcpy(&client->buf[len], "\0\6MQIsdp\3", 9);
+		len += 9;
+	}
+	client->buf[len++] = flags;
+	client->buf[len++] = options->keepAliveInterval >> 8;
+	client->buf[len++] = options->keepAliveInterval & 0xFF;
+	len += mqtt_write_string(&client->buf[len], &options->clientID);
+	if (flags & 0x80)
+		len += mqtt_write_string(&client->buf[len], &options->username);
+	if (flags & 0x40)
+		len += mqtt_write_string(&client->buf[len], &options->password);
+
+	client->keepAliveInterval = options->keepAliveInterval;
+	client->cleansession = options->cleansession;
+	TimerCountdown(&client->last_received, client->keepAliveInterval);
+
+	TimerInit(&timer);
+	TimerCountdownMS(&timer, client->command_timeout_ms);
+	if (mqtt_send_packet(client, len, &timer) != SUCCESS)
+		return FAILURE;
+	if (mqtt_waitfor(client, CONNACK, &timer) != CONNACK)
+		return FAILURE;
+
+	data->sessionPresent = client->readbuf[2] & 0x01;
+	data->rc = client->readbuf[3];
+	if (data->rc)
+		return data->rc;
+
+	client->isconnected = 1;
+	client->ping_outstanding = 0;
+
+	return SUCCESS;
+}
+
+int MQTTPublish(MQTTClient *client, const char *topicName,
+		MQTTMessage *message)
+{
+	MQTTString topic = MQTTString_initializer;
+	Timer timer;
+	int len;
+
+	if (!client->isconnected || message->qos == QOS2)
+		return FAILURE;
+
+	if (message->qos == QOS1) {
+		client->next_packetid = (client->next_packetid == MAX_PACKET_ID) ?
+					1 : client->next_packetid + 1;
+		message->id = client->next_packetid;
+	}
+
+	topic.cstring = (char *)topicName;
+	len = MQTTSerialize_publish(client->buf, client->buf_size, 0,
+				    message->qos, message->retained,
+				    message->id, topic, message->payload,
+				    message->payloadlen);
+	if (len <= 0)
+		return FAILURE;
+
+	TimerInit(&timer);
+	TimerCountdownMS(&timer, client->command_timeout_ms);
+	if (mqtt_send_packet(client, len, &timer) != SUCCESS)
+		return FAILURE;
+
+	if (message->qos == QOS1 &&
+	    mqtt_waitfor(client, PUBACK, &timer) != PUBACK)
+		return FAILURE;
+
+	return SUCCESS;
+}
+
+int MQTTSubscribeWithResults(MQTTClient *client, const char *topicFilter,
+			     enum QoS qos, messageHandler messageHandler,
+			     MQTTSubackData *data)
+{
+	data->grantedQoS = SUBFAIL;
+
+	return FAILURE;
+}
+
+int MQTTUnsubscribe(MQTTClient *client, const char *topicFilter)
+{
+	return FAILURE;
+}
+
+int MQTTDisconnect(MQTTClient *client)
+{
+	Timer timer;
+	int rc;
+
+	TimerInit(&timer);
+	TimerCountdownMS(&timer, client->command_timeout_ms);
+	rc = mqtt_send_ack(client, DISCONNECT << 4, 0, 0, &timer);
+	client->isconnected = 0;
+
+	return rc;
+}
+
+int MQTTYield(MQTTClient *client, int timeout_ms)
+{
+	Timer timer;
+
+	TimerInit(&timer);
+	TimerCountdownMS(&timer, timeout_ms);
+	do {
+		if (mqtt_cycle(client, &timer) < 0)
+			return FAILURE;
+	} while (!TimerIsExpired(&timer));
+
+	return SUCCESS;
+}
@@ -0,0 +1,151 @@
+/***************************************************************************//**
+ *   @file   tests/host/paho/MQTTClient.h
+ *   @brief  Stand-in for the paho embedded MQTT client used by libraries/mqtt.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/*
+ * Used when the paho.mqtt.embedded-c submodule is not checked out. Only the
+ * calls made by mqtt_client.c are provided, with the paho behaviour: a packet
+ * is read as its header byte, the remaining length one byte at a time, then
+ * the body. Subscriptions and incoming QoS2 messages are not supported.
+ */
+
+#ifndef MQTTCLIENT_H
+#define MQTTCLIENT_H
+
+#include <stddef.h>
+#include "mqtt_noos_support.h"
+
+#define MAX_PACKET_ID 65535
+
+enum QoS { QOS0, QOS1, QOS2, SUBFAIL = 0x80 };
+
+enum msgTypes {
+	CONNECT = 1, CONNACK, PUBLISH, PUBACK, PUBREC, PUBREL, PUBCOMP,
+	SUBSCRIBE, SUBACK, UNSUBSCRIBE, UNSUBACK, PINGREQ, PINGRESP, DISCONNECT
+};
+
+typedef struct {
+	int len;
+	char *data;
+} MQTTLenString;
+
+typedef struct {
+	char *cstring;
+	MQTTLenString lenstring;
+} MQTTString;
+
+#define MQTTString_initializer {NULL, {0, NULL}}
+
+typedef struct MQTTMessage {
+	enum QoS qos;
+	unsigned char retained;
+	unsigned char dup;
+	unsigned short id;
+	void *payload;
+	size_t payloadlen;
+} MQTTMessage;
+
+typedef struct MessageData {
+	MQTTMessage *message;
+	MQTTString *topicName;
+} MessageData;
+
+typedef struct MQTTConnackData {
+	unsigned char rc;
+	unsigned char sessionPresent;
+} MQTTConnackData;
+
+typedef struct MQTTSubackData {
+	enum QoS grantedQoS;
+} MQTTSubackData;
+
+typedef struct {
+	unsigned char MQTTVersion;
+	MQTTString clientID;
+	unsigned short keepAliveInterval;
+	unsigned char cleansession;
+	MQTTString username;
+	MQTTString password;
+} MQTTPacket_connectData;
+
+#define MQTTPacket_connectData_initializer \
+	{4, MQTTString_initializer, 60, 1, MQTTString_initializer, \
+	 MQTTString_initializer}
+
+typedef void (*messageHandler)(MessageData *);
+
+typedef struct MQTTClient {
+	unsigned int next_packetid, command_timeout_ms;
+	size_t buf_size, readbuf_size;
+	unsigned char *buf, *readbuf;
+	unsigned int keepAliveInterval;
+	char ping_outstanding;
+	int isconnected;
+	int cleansession;
+	Network *ipstack;
+	Timer last_sent, last_received;
+} MQTTClient;
+
+int MQTTSerialize_publish(unsigned char *buf, int buflen, unsigned char dup,
+			  int qos, unsigned char retained,
+			  unsigned short packetid, MQTTString topicName,
+			  unsigned char *payload, int payloadlen);
+
+void MQTTClientInit(MQTTClient *client, Network *network,
+		    unsigned int command_timeout_ms, unsigned char *sendbuf,
+		    size_t sendbuf_size, unsigned char *readbuf,
+		    size_t readbuf_size);
+int MQTTConnectWithResults(MQTTClient *client,
+			   MQTTPacket_connectData *options,
+			   MQTTConnackData *data);
+int MQTTPublish(MQTTClient *client, const char *topicName,
+		MQTTMessage *message);
+int MQTTSubscribeWithResults(MQTTClient *client, const char *topicFilter,
+			     enum QoS qos, messageHandler messageHandler,
+			     MQTTSubackData *data);
+int MQTTUnsubscribe(MQTTClient *client, const char *topicFilter);
+int MQTTDisconnect(MQTTClient *client);
+int MQTTYield(MQTTClient *client, int time);
+
+/* Implemented by mqtt_noos_support.c */
+void TimerInit(Timer *timer);
+char TimerIsExpired(Timer *timer);
+void TimerCountdownMS(Timer *timer, unsigned int ms);
+void TimerCountdown(Timer *timer, unsigned int seconds);
+int TimerLeftMS(Timer *timer);
+
+#endif // MQTTCLIENT_H
@@ -232,6 +232,15 @@ ifeq (y,$(strip $(DISABLE_SECURE_SOCKET)))
 CFLAGS += -DDISABLE_SECURE_SOCKET
 endif
 
+# Hot-path tracing, see include/trace.h. The trace points compile to nothing
+# without TRACE=y, but the header is always needed.
+INCS += $(INCLUDE)/trace.h
+ifeq (y,$(strip $(TRACE)))
+CFLAGS += -DTRACE_ENABLE
+SRCS += $(NO-OS)/util/trace.c \
+	$(wildcard $(PLATFORM_DRIVERS)/*trace_clock.c)
+endif
+
 include $(NO-OS)/tools/scripts/libraries.mk
 
 # Get all .c and .h files from SRC_DIRS
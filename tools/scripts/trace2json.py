@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+#
+# Convert a trace dump written by trace_dump() (include/trace.h) into the
+# Chrome trace event JSON format, which can be opened with chrome://tracing
+# or https://ui.perfetto.dev.
+#
+# Usage: trace2json.py <trace.bin> [-o trace.json] [-n names.txt]
+#
+# The optional names file maps application trace ids (TRACE_ID_USER and up)
+# to names, one "<id> <name>" pair per line.
+
+import argparse
+import json
+import struct
+import sys
+
+TRACE_DUMP_MAGIC = 0x52544f4e
+TRACE_DUMP_VERSION = 1
+TRACE_ID_USER = 0x100
+
+HEADER_FMT = "IHHIII"
+RECORD_FMT = "QIIHB5x"
+
+# Must match enum trace_id
+TRACE_NAMES = {
+	0: "spi_write_and_read",
+	1: "axi_io_read",
+	2: "axi_io_write",
+	3: "axi_dmac_transfer",
+	4: "iio_step",
+	5: "fw_load",
+	6: "tls_handshake",
+}
+
+# Must match enum trace_type
+TRACE_PHASES = {
+	0: "B",
+	1: "E",
+	2: "i",
+}
+
+def load_names(path):
+	names = dict(TRACE_NAMES)
+	with open(path) as f:
+		for line in f:
+			line = line.split("#")[0].split()
+			if len(line) >= 2:
+				names[int(line[0], 0)] = line[1]
+	return names
+
+def parse(data):
+	for order in ("<", ">"):
+		magic, = struct.unpack_from(order + "I", data)
+		if magic == TRACE_DUMP_MAGIC:
+			break
+	else:
+		sys.exit("not a trace dump")
+
+	hdr = struct.unpack_from(order + HEADER_FMT, data)
+	_, version, rec_size, clock_hz, count, lost = hdr
+	if version != TRACE_DUMP_VERSION:
+		sys.exit("unsupported trace dump version %d" % version)
+	if rec_size != struct.calcsize(order + RECORD_FMT):
+		sys.exit("unexpected record size %d" % rec_size)
+
+	offset = struct.calcsize(order + HEADER_FMT)
+	records = []
+	for i in range(count):
+		if offset + rec_size > len(data):
+			break
+		rec = struct.unpack_from(order + RECORD_FMT, data, offset)
+		offset += rec_size
+		ts, arg, seq, rid, rtype = rec
+		# Overwritten while the dump was taken
+		if seq == 0:
+			lost += 1
+			continue
+		records.append((ts, seq, rid, rtype, arg))
+
+	records.sort()
+	return clock_hz, lost, records
+
+def convert(clock_hz, records, names):
+	events = []
+	if not records:
+		return events
+
+	t0 = records[0][0]
+	for ts, seq, rid, rtype, arg in records:
+		# Without a clock frequency the timestamps are only event numbers,
+		# show them 1 us apart.
+		if clock_hz:
+			us = (ts - t0) * 1e6 / clock_hz
+		else:
+			us = float(ts - t0)
+		ev = {
+			"name": names.get(rid, "user_%d" % (rid - TRACE_ID_USER)),
+			"ph": TRACE_PHASES.get(rtype, "i"),
+			"ts": us,
+			"pid": 0,
+			"tid": 0,
+		}
+		if ev["ph"] == "i":
+			ev["s"] = "t"
+			ev["args"] = {"arg": "0x%x" % arg}
+		events.append(ev)
+
+	return events
+
+def main():
+	parser = argparse.ArgumentParser(description=
+			"Convert a no-OS trace dump to Chrome trace JSON.")
+	parser.add_argument("input", help="binary trace dump")
+	parser.add_argument("-o", "--output", help="output file (default stdout)")
+	parser.add_argument("-n", "--names", help="names of the user trace ids")
+	args = parser.parse_args()
+
+	with open(args.input, "rb") as f:
+		data = f.read()
+
+	names = load_names(args.names) if args.names else TRACE_NAMES
+	clock_hz, lost, records = parse(data)
+	trace = {
+		"traceEvents": convert(clock_hz, records, names),
+		"displayTimeUnit": "ns",
+		"otherData": {
+			"clock_hz": clock_hz,
+			"lost_records": lost,
+		},
+	}
+
+	if args.output:
+		with open(args.output, "w") as f:
+			json.dump(trace, f)
+	else:
+		json.dump(trace, sys.stdout)
+
+	if lost:
+		sys.stderr.write("%d records were lost\n" % lost)
+
+if __name__ == "__main__":
+	main()
@@ -40,6 +40,7 @@
 /******************************************************************************/
 /***************************** Include Files **********************************/
 /******************************************************************************/
+#include <stddef.h>
 #include "error.h"
 #include "clk.h"
 
@@ -54,7 +55,7 @@
  */
 int32_t clk_enable(struct clk * clk)
 {
-	if (clk->hw->dev_clk_enable)
+	if (clk->hw && clk->hw->dev_clk_enable)
 		return clk->hw->dev_clk_enable(clk->hw->dev);
 	else
 		return FAILURE;
@@ -67,7 +68,7 @@ int32_t clk_enable(struct clk * clk)
  */
 int32_t clk_disable(struct clk * clk)
 {
-	if (clk->hw->dev_clk_disable)
+	if (clk->hw && clk->hw->dev_clk_disable)
 		return clk->hw->dev_clk_disable(clk->hw->dev);
 	else
 		return FAILURE;
@@ -75,6 +76,9 @@ int32_t clk_disable(struct clk * clk)
 
 /**
  * Get the current frequency of the clock.
+ * The rate is read from the hardware once and cached until the clock or one
+ * of its ancestors changes rate. A clock without a recalc_rate operation
+ * runs at the rate of its parent.
  * @param clk - The clock structure.
  * @param rate - The current frequency.
  * @return SUCCESS in case of success, negative error code otherwise.
@@ -82,12 +86,29 @@ int32_t clk_disable(struct clk * clk)
 int32_t clk_recalc_rate(struct clk *clk,
 			uint64_t *rate)
 {
-	if (clk->hw->dev_clk_recalc_rate)
-		return clk->hw->dev_clk_recalc_rate(clk->hw->dev,
-						    clk->hw_ch_num,
-						    rate);
+	int32_t ret;
+
+	if (clk->rate_valid) {
+		*rate = clk->rate;
+		return SUCCESS;
+	}
+
+	if (clk->hw && clk->hw->dev_clk_recalc_rate)
+		ret = clk->hw->dev_clk_recalc_rate(clk->hw->dev,
+						   clk->hw_ch_num,
+						   rate);
+	else if (clk->parent)
+		ret = clk_recalc_rate(clk->parent, rate);
 	else
 		return FAILURE;
+
+	if (ret < 0)
+		return ret;
+
+	clk->rate = *rate;
+	clk->rate_valid = true;
+
+	return ret;
 }
 
 /**
@@ -101,7 +122,7 @@ int32_t clk_round_rate(struct clk *clk,
 		       uint64_t rate,
 		       uint64_t *rounded_rate)
 {
-	if (clk->hw->dev_clk_round_rate)
+	if (clk->hw && clk->hw->dev_clk_round_rate)
 		return clk->hw->dev_clk_round_rate(clk->hw->dev,
 						   clk->hw_ch_num,
 						   rate,
@@ -110,8 +131,49 @@ int32_t clk_round_rate(struct clk *clk,
 		return FAILURE;
 }
 
+/**
+ * Refresh the cached rate of a clock after a change and, if it moved, run its
+ * notifiers and carry on with its children.
+ * @param clk - The clock structure.
+ * @param old_rate - The rate before the change, 0 if unknown.
+ * @return SUCCESS in case of success, the first error otherwise.
+ */
+static int32_t clk_propagate_rate(struct clk *clk,
+				  uint64_t old_rate)
+{
+	struct clk_notifier *nb;
+	struct clk *child;
+	uint64_t new_rate, child_old_rate;
+	int32_t ret, err = SUCCESS;
+
+	clk->rate_valid = false;
+	ret = clk_recalc_rate(clk, &new_rate);
+	if (ret < 0)
+		return ret;
+
+	if (old_rate && old_rate == new_rate)
+		return SUCCESS;
+
+	for (nb = clk->notifiers; nb; nb = nb->next) {
+		ret = nb->notify(clk, old_rate, new_rate, nb->ctx);
+		if (ret < 0 && !err)
+			err = ret;
+	}
+
+	for (child = clk->children; child; child = child->sibling) {
+		child_old_rate = child->rate_valid ? child->rate : 0;
+		ret = clk_propagate_rate(child, child_old_rate);
+		if (ret < 0 && !err)
+			err = ret;
+	}
+
+	return err;
+}
+
 /**
  * Change the frequency of the clock.
+ * The new rate is propagated down the tree and the notifiers of every clock
+ * whose rate changed are called.
  * @param clk - The clock structure.
  * @param rate - The desired frequency.
  * @return SUCCESS in case of success, negative error code otherwise.
@@ -119,10 +181,126 @@ int32_t clk_round_rate(struct clk *clk,
 int32_t clk_set_rate(struct clk *clk,
 		     uint64_t rate)
 {
-	if (clk->hw->dev_clk_set_rate)
-		return clk->hw->dev_clk_set_rate(clk->hw->dev,
-						 clk->hw_ch_num,
-						 rate);
-	else
+	uint64_t old_rate;
+	int32_t ret;
+
+	if (!clk->hw || !clk->hw->dev_clk_set_rate)
 		return FAILURE;
+
+	old_rate = clk->rate_valid ? clk->rate : 0;
+
+	ret = clk->hw->dev_clk_set_rate(clk->hw->dev,
+					clk->hw_ch_num,
+					rate);
+	if (ret < 0) {
+		clk_invalidate_rate(clk);
+		return ret;
+	}
+
+	return clk_propagate_rate(clk, old_rate);
+}
+
+/**
+ * Move the clock under a new parent.
+ * @param clk - The clock structure.
+ * @param parent - The new parent, NULL to make the clock a root.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t clk_set_parent(struct clk *clk,
+		       struct clk *parent)
+{
+	struct clk **link;
+	struct clk *p;
+
+	if (!clk)
+		return -EINVAL;
+
+	/* Refuse loops */
+	for (p = parent; p; p = p->parent)
+		if (p == clk)
+			return -EINVAL;
+
+	if (clk->parent) {
+		for (link = &clk->parent->children; *link; link = &(*link)->sibling)
+			if (*link == clk) {
+				*link = clk->sibling;
+				break;
+			}
+	}
+
+	clk->sibling = NULL;
+	clk->parent = parent;
+	if (parent) {
+		clk->sibling = parent->children;
+		parent->children = clk;
+	}
+
+	clk_invalidate_rate(clk);
+
+	return SUCCESS;
+}
+
+/**
+ * Get the parent of the clock.
+ * @param clk - The clock structure.
+ * @return The parent clock, NULL for a root clock.
+ */
+struct clk *clk_get_parent(struct clk *clk)
+{
+	return clk ? clk->parent : NULL;
+}
+
+/**
+ * Drop the cached rate of the clock and of all its descendants, so the next
+ * clk_recalc_rate() reads the hardware again.
+ * @param clk - The clock structure.
+ */
+void clk_invalidate_rate(struct clk *clk)
+{
+	struct clk *child;
+
+	clk->rate_valid = false;
+	for (child = clk->children; child; child = child->sibling)
+		clk_invalidate_rate(child);
+}
+
+/**
+ * Register a rate change notifier.
+ * @param clk - The clock structure.
+ * @param nb - The notifier, owned by the caller until unregistered.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t clk_notifier_register(struct clk *clk,
+			      struct clk_notifier *nb)
+{
+	if (!clk || !nb || !nb->notify)
+		return -EINVAL;
+
+	nb->next = clk->notifiers;
+	clk->notifiers = nb;
+
+	return SUCCESS;
+}
+
+/**
+ * Unregister a rate change notifier.
+ * @param clk - The clock structure.
+ * @param nb - The notifier.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t clk_notifier_unregister(struct clk *clk,
+				struct clk_notifier *nb)
+{
+	struct clk_notifier **link;
+
+	if (!clk || !nb)
+		return -EINVAL;
+
+	for (link = &clk->notifiers; *link; link = &(*link)->next)
+		if (*link == nb) {
+			*link = nb->next;
+			return SUCCESS;
+		}
+
+	return -EINVAL;
 }
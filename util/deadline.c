@@ -0,0 +1,128 @@
+/***************************************************************************//**
+ *   @file   deadline.c
+ *   @brief  Implementation of the deadline and polling helpers.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "deadline.h"
+#include "delay.h"
+#include "error.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Start a deadline.
+ * @param dl - The deadline.
+ * @param timeout_us - Microseconds from now until the deadline passes.
+ * @return None.
+ */
+void deadline_set(struct deadline *dl, uint32_t timeout_us)
+{
+	dl->start_us = get_time_us();
+	dl->timeout_us = timeout_us;
+}
+
+/**
+ * @brief Check if a deadline has passed.
+ * @param dl - The deadline.
+ * @return true if the deadline has passed, false otherwise.
+ */
+bool deadline_expired(struct deadline *dl)
+{
+	return (uint32_t)(get_time_us() - dl->start_us) >= dl->timeout_us;
+}
+
+/**
+ * @brief Get the time left until a deadline.
+ * @param dl - The deadline.
+ * @return Microseconds left, 0 if the deadline has passed.
+ */
+uint32_t deadline_remaining_us(struct deadline *dl)
+{
+	uint32_t elapsed = get_time_us() - dl->start_us;
+
+	if (elapsed >= dl->timeout_us)
+		return 0;
+
+	return dl->timeout_us - elapsed;
+}
+
+/**
+ * @brief Poll a condition until it holds or the timeout passes.
+ *
+ * The condition is checked right away, then with a sleep between the checks
+ * that starts at POLL_MIN_SLEEP_US and doubles up to max_sleep_us. Short
+ * waits end a few microseconds after the condition holds, long waits do not
+ * keep the bus busy. The sleep never goes past the deadline and the condition
+ * is checked once more after it, so a late wake up is not reported as a
+ * timeout.
+ * @param cond - Condition to check.
+ * @param ctx - Context passed to the condition.
+ * @param timeout_us - Maximum time to wait, in microseconds.
+ * @param max_sleep_us - Maximum sleep between two checks, in microseconds.
+ * @return SUCCESS when the condition holds, -ETIMEDOUT if it did not hold
+ * before the timeout or the negative error code returned by the condition.
+ */
+int32_t poll_until(poll_cond_t cond, void *ctx, uint32_t timeout_us,
+		   uint32_t max_sleep_us)
+{
+	struct deadline dl;
+	uint32_t sleep_us = POLL_MIN_SLEEP_US;
+	uint32_t left;
+	int32_t ret;
+
+	deadline_set(&dl, timeout_us);
+	while (true) {
+		ret = cond(ctx);
+		if (ret)
+			return ret < 0 ? ret : SUCCESS;
+
+		left = deadline_remaining_us(&dl);
+		if (!left)
+			return -ETIMEDOUT;
+
+		udelay(sleep_us < left ? sleep_us : left);
+
+		if (sleep_us < max_sleep_us)
+			sleep_us = (sleep_us * 2 < max_sleep_us) ?
+				   sleep_us * 2 : max_sleep_us;
+	}
+}
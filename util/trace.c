@@ -0,0 +1,205 @@
+/***************************************************************************//**
+ *   @file   trace.c
+ *   @brief  Hot-path tracing into a binary ring buffer.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <string.h>
+#include "trace.h"
+#include "error.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define TRACE_RING_MASK		(TRACE_RING_SIZE - 1)
+/* Number of records copied out of the ring per write callback call. */
+#define TRACE_DUMP_CHUNK	16
+
+#if (TRACE_RING_SIZE & TRACE_RING_MASK) != 0
+#error "TRACE_RING_SIZE must be a power of 2"
+#endif
+
+/******************************************************************************/
+/****************************** Global Variables*******************************/
+/******************************************************************************/
+
+static struct trace_rec trace_ring[TRACE_RING_SIZE];
+
+/** Number of slots reserved since the last reset */
+static uint32_t trace_head;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Initialize the trace clock and clear the trace ring.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t trace_init(void)
+{
+	int32_t ret;
+
+	ret = trace_clock_init();
+	if (ret != SUCCESS)
+		return ret;
+
+	trace_reset();
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Add a record to the trace ring.
+ *
+ * Safe to call from interrupt context and concurrently with other producers:
+ * a slot is reserved with an atomic increment and the record is published
+ * by writing its sequence number last. When the ring is full the oldest
+ * records are overwritten.
+ * @param id - Trace point identifier.
+ * @param type - Record type.
+ * @param arg - Event argument.
+ */
+void trace_record(uint16_t id, uint8_t type, uint32_t arg)
+{
+	struct trace_rec *rec;
+	uint64_t ts;
+	uint32_t seq;
+
+	ts = trace_clock_get();
+	seq = __atomic_fetch_add(&trace_head, 1, __ATOMIC_RELAXED);
+	rec = &trace_ring[seq & TRACE_RING_MASK];
+
+	/* Invalidate the slot while it is being rewritten. */
+	__atomic_store_n(&rec->seq, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	rec->ts = ts;
+	rec->arg = arg;
+	rec->id = id;
+	rec->type = type;
+
+	__atomic_store_n(&rec->seq, seq + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Discard all the records in the trace ring.
+ *
+ * Must not race with trace_record().
+ */
+void trace_reset(void)
+{
+	memset(trace_ring, 0, sizeof(trace_ring));
+	__atomic_store_n(&trace_head, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Copy one record out of the ring.
+ * @param pos - Position of the record since the last reset.
+ * @param rec - Where the copy is stored. Its sequence number is cleared if the
+ * record was overwritten or incomplete.
+ */
+static void trace_copy(uint32_t pos, struct trace_rec *rec)
+{
+	struct trace_rec *src = &trace_ring[pos & TRACE_RING_MASK];
+	uint32_t seq;
+
+	seq = __atomic_load_n(&src->seq, __ATOMIC_ACQUIRE);
+	memcpy(rec, src, sizeof(*rec));
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	if (seq != pos + 1 ||
+	    __atomic_load_n(&src->seq, __ATOMIC_RELAXED) != seq)
+		rec->seq = 0;
+	else
+		rec->seq = seq;
+}
+
+/**
+ * @brief Write the content of the trace ring through a caller supplied
+ * callback.
+ *
+ * The output is a struct trace_dump_header followed by header.count records,
+ * oldest first, in the native byte order. Records overwritten while the dump
+ * is in progress are written with a sequence number of 0 and must be ignored
+ * by the reader. Tracing may continue while dumping.
+ * @param write - Output callback, returns a negative value on error.
+ * @param ctx - Callback context.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t trace_dump(int32_t (*write)(void *ctx, const uint8_t *buff,
+				    uint32_t len), void *ctx)
+{
+	struct trace_rec chunk[TRACE_DUMP_CHUNK];
+	struct trace_dump_header hdr;
+	uint32_t start;
+	uint32_t head;
+	uint32_t pos;
+	uint32_t n;
+	int32_t ret;
+
+	if (!write)
+		return -EINVAL;
+
+	head = __atomic_load_n(&trace_head, __ATOMIC_ACQUIRE);
+	start = head > TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0;
+
+	hdr.magic = TRACE_DUMP_MAGIC;
+	hdr.version = TRACE_DUMP_VERSION;
+	hdr.rec_size = sizeof(struct trace_rec);
+	hdr.clock_hz = trace_clock_hz();
+	hdr.count = head - start;
+	hdr.lost = start;
+
+	ret = write(ctx, (const uint8_t *)&hdr, sizeof(hdr));
+	if (ret < 0)
+		return ret;
+
+	for (pos = start; pos != head; pos += n) {
+		for (n = 0; n < TRACE_DUMP_CHUNK && pos + n != head; n++)
+			trace_copy(pos + n, &chunk[n]);
+
+		ret = write(ctx, (const uint8_t *)chunk, n * sizeof(chunk[0]));
+		if (ret < 0)
+			return ret;
+	}
+
+	return SUCCESS;
+}
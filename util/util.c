@@ -129,26 +129,41 @@ int32_t log_base_2(uint32_t x)
 }
 
 /**
- * Find greatest common divisor of the given two numbers.
+ * Find greatest common divisor of the given two numbers (Euclid).
  */
 uint32_t greatest_common_divisor(uint32_t a,
 				 uint32_t b)
 {
-	uint32_t div;
-	uint32_t common_div = 1;
+	uint32_t r;
 
 	if ((a == 0) || (b == 0))
 		return max(a, b);
 
-	for (div = 1; (div <= a) && (div <= b); div++)
-		if (!(a % div) && !(b % div))
-			common_div = div;
+	while (b) {
+		r = a % b;
+		a = b;
+		b = r;
+	}
+
+	return a;
+}
+
+/**
+ * Find lowest common multiple of the given two numbers.
+ */
+uint64_t lowest_common_multiple(uint32_t a,
+				uint32_t b)
+{
+	if ((a == 0) || (b == 0))
+		return 0;
 
-	return common_div;
+	return (uint64_t)(a / greatest_common_divisor(a, b)) * b;
 }
 
 /**
  * Calculate best rational approximation for a given fraction.
+ * Walks the continued fraction expansion of the given fraction and stops at
+ * the last convergent within the limits, or at the closer semi-convergent.
  */
 void rational_best_approximation(uint32_t given_numerator,
 				 uint32_t given_denominator,
@@ -157,18 +172,48 @@ void rational_best_approximation(uint32_t given_numerator,
 				 uint32_t *best_numerator,
 				 uint32_t *best_denominator)
 {
-	uint32_t gcd;
-
-	gcd = greatest_common_divisor(given_numerator, given_denominator);
-
-	*best_numerator = given_numerator / gcd;
-	*best_denominator = given_denominator / gcd;
+	uint64_t n, d, n0, d0, n1, d1, n2, d2;
+	uint64_t a, dp, t;
+
+	n = given_numerator;
+	d = given_denominator;
+	n0 = d1 = 0;
+	n1 = d0 = 1;
+
+	while (d) {
+		/* Next term of the continued fraction */
+		dp = d;
+		a = n / d;
+		d = n % d;
+		n = dp;
+
+		/* Next convergent */
+		n2 = n0 + a * n1;
+		d2 = d0 + a * d1;
+
+		if ((n2 > max_numerator) || (d2 > max_denominator)) {
+			/* Largest semi-convergent within the limits */
+			t = UINT64_MAX;
+			if (d1)
+				t = (max_denominator - d0) / d1;
+			if (n1)
+				t = min(t, (max_numerator - n0) / n1);
+
+			if (!d1 || 2 * t > a || (2 * t == a && d0 * dp > d1 * d)) {
+				n1 = n0 + t * n1;
+				d1 = d0 + t * d1;
+			}
+			break;
+		}
 
-	if ((*best_numerator > max_numerator) ||
-	    (*best_denominator > max_denominator)) {
-		*best_numerator = 0;
-		*best_denominator = 0;
+		n0 = n1;
+		n1 = n2;
+		d0 = d1;
+		d1 = d2;
 	}
+
+	*best_numerator = n1;
+	*best_denominator = d1;
 }
 
 /**